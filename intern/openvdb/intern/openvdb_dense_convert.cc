@@ -29,6 +29,8 @@
 
 #include <openvdb/tools/ValueTransformer.h>  /* for tools::foreach */
 
+#include <algorithm>
+
 namespace internal {
 
 openvdb::Mat4R convertMatrix(const float mat[4][4])
@@ -40,7 +42,6 @@ openvdb::Mat4R convertMatrix(const float mat[4][4])
 	        mat[3][0], mat[3][1], mat[3][2], mat[3][3]);
 }
 
-
 class MergeScalarGrids {
 	typedef openvdb::FloatTree ScalarTree;
 
@@ -72,6 +73,51 @@ public:
 	}
 };
 
+/* Writes the active voxels and tiles of a vector grid to three dense arrays,
+ * the arrays are expected to be filled with the background value already. */
+class SplitVectorGrid {
+	float *m_data_x, *m_data_y, *m_data_z;
+	openvdb::math::CoordBBox m_bbox;
+
+public:
+	SplitVectorGrid(float *data_x, float *data_y, float *data_z, const openvdb::math::CoordBBox &bbox)
+	    : m_data_x(data_x)
+	    , m_data_y(data_y)
+	    , m_data_z(data_z)
+	    , m_bbox(bbox)
+	{}
+
+	void operator()(const openvdb::Vec3STree::ValueOnCIter &it) const
+	{
+		using namespace openvdb;
+
+		math::CoordBBox bbox;
+		it.getBoundingBox(bbox);
+		bbox.intersect(m_bbox);
+
+		if (bbox.empty()) {
+			return;
+		}
+
+		const math::Vec3s value = it.getValue();
+		const math::Coord &min = bbox.min(), &max = bbox.max();
+		const size_t stride_y = m_bbox.dim().x();
+		const size_t stride_z = stride_y * m_bbox.dim().y();
+
+		for (int z = min.z(); z <= max.z(); ++z) {
+			for (int y = min.y(); y <= max.y(); ++y) {
+				size_t index = z * stride_z + y * stride_y + min.x();
+
+				for (int x = min.x(); x <= max.x(); ++x, ++index) {
+					m_data_x[index] = value.x();
+					m_data_y[index] = value.y();
+					m_data_z[index] = value.z();
+				}
+			}
+		}
+	}
+};
+
 openvdb::GridBase *OpenVDB_export_vector_grid(
         OpenVDBWriter *writer,
         const openvdb::Name &name,
@@ -148,21 +194,18 @@ void OpenVDB_import_grid_vector(
 	}
 
 	Vec3SGrid::Ptr vgrid = gridPtrCast<Vec3SGrid>(reader->getGrid(name));
-	Vec3SGrid::ConstAccessor acc = vgrid->getConstAccessor();
-	math::Coord xyz;
-	int &x = xyz[0], &y = xyz[1], &z = xyz[2];
-
-	size_t index = 0;
-	for (z = 0; z < res[2]; ++z) {
-		for (y = 0; y < res[1]; ++y) {
-			for (x = 0; x < res[0]; ++x, ++index) {
-				math::Vec3s value = acc.getValue(xyz);
-				(*data_x)[index] = value.x();
-				(*data_y)[index] = value.y();
-				(*data_z)[index] = value.z();
-			}
-		}
-	}
+
+	const size_t size = static_cast<size_t>(res[0]) * res[1] * res[2];
+	const math::Vec3s background = vgrid->background();
+
+	std::fill(*data_x, *data_x + size, background.x());
+	std::fill(*data_y, *data_y + size, background.y());
+	std::fill(*data_z, *data_z + size, background.z());
+
+	/* Only visit active values, tiles are filled as a whole. */
+	math::CoordBBox bbox(Coord(0), Coord(res[0] - 1, res[1] - 1, res[2] - 1));
+	SplitVectorGrid op(*data_x, *data_y, *data_z, bbox);
+	tools::foreach(vgrid->cbeginValueOn(), op, true, true);
 }
 
 }  /* namespace internal */
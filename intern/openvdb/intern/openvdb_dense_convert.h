@@ -29,6 +29,7 @@
 #define __OPENVDB_DENSE_CONVERT_H__
 
 #include "openvdb_reader.h"
+#include "openvdb_util.h"
 #include "openvdb_writer.h"
 
 #include <openvdb/tools/Clip.h>
@@ -78,6 +79,10 @@ GridType *OpenVDB_export_grid(
 	return grid.get();
 }
 
+/* Importing converts the grids to the dense arrays of the smoke domain, which the simulation,
+ * the renderer and viewport drawing use. The conversion visits the nodes of the tree instead
+ * of every voxel. Consumers that only sample the grid keep it sparse instead, see
+ * OpenVDB_import_sparse_grid. */
 template <typename GridType, typename T>
 void OpenVDB_import_grid(
         OpenVDBReader *reader,
@@ -94,19 +99,12 @@ void OpenVDB_import_grid(
 	}
 
 	typename GridType::Ptr grid = gridPtrCast<GridType>(reader->getGrid(name));
-	typename GridType::ConstAccessor acc = grid->getConstAccessor();
-
-	math::Coord xyz;
-	int &x = xyz[0], &y = xyz[1], &z = xyz[2];
-
-	size_t index = 0;
-	for (z = 0; z < res[2]; ++z) {
-		for (y = 0; y < res[1]; ++y) {
-			for (x = 0; x < res[0]; ++x, ++index) {
-				(*data)[index] = acc.getValue(xyz);
-			}
-		}
-	}
+
+	/* Walk the tree per node instead of looking up every voxel, so empty
+	 * regions of the domain only cost filling them with the background. */
+	math::CoordBBox bbox(Coord(0), Coord(res[0] - 1, res[1] - 1, res[2] - 1));
+	tools::Dense<T, tools::LayoutXYZ> dense_grid(bbox, *data);
+	tools::copyToDense(*grid, dense_grid);
 }
 
 openvdb::GridBase *OpenVDB_export_vector_grid(
@@ -58,6 +58,11 @@ void OpenVDBReader::open(const openvdb::Name &filename)
 	}
 }
 
+bool OpenVDBReader::isOpen() const
+{
+	return m_file != NULL;
+}
+
 void OpenVDBReader::floatMeta(const openvdb::Name &name, float &value) const
 {
 	try {
@@ -132,5 +137,6 @@ void OpenVDBReader::cleanupFile()
 	if (m_file) {
 		m_file->close();
 		delete m_file;
+		m_file = NULL;
 	}
 }
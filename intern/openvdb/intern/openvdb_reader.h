@@ -40,6 +40,7 @@ public:
 	~OpenVDBReader();
 
 	void open(const openvdb::Name &filename);
+	bool isOpen() const;
 
 	void floatMeta(const openvdb::Name &name, float &value) const;
 	void intMeta(const openvdb::Name &name, int &value) const;
@@ -0,0 +1,75 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2015 Blender Foundation.
+ * All rights reserved.
+ *
+ * Contributor(s): Kevin Dietrich
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+#include "openvdb_sparse_grid.h"
+
+#include <openvdb/tools/Interpolation.h>
+
+#include <cstdio>
+
+namespace internal {
+
+OpenVDBSparseGrid *OpenVDB_import_sparse_grid(OpenVDBReader *reader, const openvdb::Name &name)
+{
+	using namespace openvdb;
+
+	if (!reader->isOpen() || !reader->hasGrid(name)) {
+		std::fprintf(stderr, "OpenVDB grid %s not found in file!\n", name.c_str());
+		return NULL;
+	}
+
+	FloatGrid::Ptr grid = gridPtrCast<FloatGrid>(reader->getGrid(name));
+
+	if (!grid) {
+		std::fprintf(stderr, "OpenVDB grid %s is not a float grid!\n", name.c_str());
+		return NULL;
+	}
+
+	OpenVDBSparseGrid *sparse_grid = new OpenVDBSparseGrid;
+	sparse_grid->grid = grid;
+
+	return sparse_grid;
+}
+
+float OpenVDB_sample_sparse_grid(const OpenVDBSparseGrid *sparse_grid, const float ijk[3], const int order)
+{
+	using namespace openvdb;
+
+	/* The static samplers look up the tree without a cached accessor, so
+	 * render threads can share the grid. */
+	const FloatTree &tree = sparse_grid->grid->tree();
+	const Vec3R xyz(ijk[0], ijk[1], ijk[2]);
+
+	switch (order) {
+		case 0:
+			return tools::PointSampler::sample(tree, xyz);
+		case 1:
+			return tools::BoxSampler::sample(tree, xyz);
+		default:
+			return tools::QuadraticSampler::sample(tree, xyz);
+	}
+}
+
+}  /* namespace internal */
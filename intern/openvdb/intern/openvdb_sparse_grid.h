@@ -0,0 +1,47 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2015 Blender Foundation.
+ * All rights reserved.
+ *
+ * Contributor(s): Kevin Dietrich
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+#ifndef __OPENVDB_SPARSE_GRID_H__
+#define __OPENVDB_SPARSE_GRID_H__
+
+#include "openvdb_reader.h"
+
+/* A grid imported as it is stored in the file, without converting it to a dense array:
+ * empty regions cost nothing and only the active voxels and tiles are kept in memory. */
+struct OpenVDBSparseGrid {
+	openvdb::FloatGrid::Ptr grid;
+};
+
+namespace internal {
+
+OpenVDBSparseGrid *OpenVDB_import_sparse_grid(OpenVDBReader *reader, const openvdb::Name &name);
+
+/* Sample the grid at a position in index space, with nearest (0), trilinear (1)
+ * or triquadratic (2) interpolation. Safe to call from several threads. */
+float OpenVDB_sample_sparse_grid(const OpenVDBSparseGrid *sparse_grid, const float ijk[3], const int order);
+
+}  /* namespace internal */
+
+#endif /* __OPENVDB_SPARSE_GRID_H__ */
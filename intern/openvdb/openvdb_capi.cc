@@ -25,6 +25,7 @@
 
 #include "openvdb_capi.h"
 #include "openvdb_dense_convert.h"
+#include "openvdb_sparse_grid.h"
 #include "openvdb_util.h"
 
 struct OpenVDBFloatGrid { int unused; };
@@ -125,6 +126,8 @@ void OpenVDB_import_grid_ch(
         const char *name, unsigned char **data,
         const int res[3])
 {
+	Timer(__func__);
+
 	internal::OpenVDB_import_grid<openvdb::Int32Grid>(reader, name, data, res);
 }
 
@@ -139,6 +142,36 @@ void OpenVDB_import_grid_vec(
 	internal::OpenVDB_import_grid_vector(reader, name, data_x, data_y, data_z, res);
 }
 
+OpenVDBSparseGrid *OpenVDB_import_sparse_grid_fl(
+        OpenVDBReader *reader,
+        const char *name)
+{
+	Timer(__func__);
+
+	return internal::OpenVDB_import_sparse_grid(reader, name);
+}
+
+float OpenVDB_sparse_grid_sample(
+        OpenVDBSparseGrid *grid,
+        const float ijk[3], const int order)
+{
+	return internal::OpenVDB_sample_sparse_grid(grid, ijk, order);
+}
+
+size_t OpenVDB_sparse_grid_memory(OpenVDBSparseGrid *grid, size_t *r_active_voxels)
+{
+	if (r_active_voxels) {
+		*r_active_voxels = grid->grid->activeVoxelCount();
+	}
+
+	return grid->grid->memUsage();
+}
+
+void OpenVDB_sparse_grid_free(OpenVDBSparseGrid *grid)
+{
+	delete grid;
+}
+
 OpenVDBWriter *OpenVDBWriter_create()
 {
 	return new OpenVDBWriter();
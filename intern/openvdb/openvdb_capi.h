@@ -35,6 +35,7 @@ struct OpenVDBWriter;
 struct OpenVDBFloatGrid;
 struct OpenVDBIntGrid;
 struct OpenVDBVectorGrid;
+struct OpenVDBSparseGrid;
 
 int OpenVDB_getVersionHex(void);
 
@@ -82,6 +83,21 @@ void OpenVDB_import_grid_vec(
         float **data_x, float **data_y, float **data_z,
         const int res[3]);
 
+/* Import a float grid without converting it to a dense array, see OpenVDB_sparse_grid_sample.
+ * Returns NULL when the file has no float grid of that name. */
+struct OpenVDBSparseGrid *OpenVDB_import_sparse_grid_fl(
+        struct OpenVDBReader *reader,
+        const char *name);
+
+float OpenVDB_sparse_grid_sample(
+        struct OpenVDBSparseGrid *grid,
+        const float ijk[3], const int order);
+
+/* Bytes used by the tree of the grid, and its number of active voxels. */
+size_t OpenVDB_sparse_grid_memory(struct OpenVDBSparseGrid *grid, size_t *r_active_voxels);
+
+void OpenVDB_sparse_grid_free(struct OpenVDBSparseGrid *grid);
+
 struct OpenVDBWriter *OpenVDBWriter_create(void);
 void OpenVDBWriter_free(struct OpenVDBWriter *writer);
 void OpenVDBWriter_set_flags(struct OpenVDBWriter *writer, const int flag, const bool half);
@@ -164,6 +164,7 @@ def point_cache_ui(self, context, cache, enabled, cachetype):
             col = split.column()
             col.active = cache.use_disk_cache
             col.prop(cache, "use_library_path", "Use Lib Path")
+            col.prop(cache, "use_single_file")
 
             row = layout.row()
             row.enabled = enabled and bpy.data.is_saved
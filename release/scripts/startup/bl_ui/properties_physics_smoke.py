@@ -323,6 +323,7 @@ class PHYSICS_PT_smoke_cache(PhysicButtonsPanel, Panel):
         if cache_file_format == 'POINTCACHE':
             layout.label(text="Compression:")
             layout.prop(domain, "point_cache_compress_type", expand=True)
+            layout.prop(domain.point_cache, "use_single_file")
         elif cache_file_format == 'OPENVDB':
             if not bpy.app.build_options.openvdb:
                 layout.label("Built without OpenVDB support")
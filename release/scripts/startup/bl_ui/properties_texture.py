@@ -764,10 +764,12 @@ class TEXTURE_PT_voxeldata(TextureButtonsPanel, Panel):
         vd = tex.voxel_data
 
         layout.prop(vd, "file_format")
-        if vd.file_format in {'BLENDER_VOXEL', 'RAW_8BIT'}:
+        if vd.file_format in {'BLENDER_VOXEL', 'RAW_8BIT', 'OPENVDB'}:
             layout.prop(vd, "filepath")
-        if vd.file_format == 'RAW_8BIT':
+        if vd.file_format in {'RAW_8BIT', 'OPENVDB'}:
             layout.prop(vd, "resolution")
+        if vd.file_format == 'OPENVDB':
+            layout.prop(vd, "grid_name")
         elif vd.file_format == 'SMOKE':
             layout.prop(vd, "domain_object")
             layout.prop(vd, "smoke_data_type")
@@ -779,7 +781,7 @@ class TEXTURE_PT_voxeldata(TextureButtonsPanel, Panel):
             layout.template_image(tex, "image", tex.image_user, compact=True)
             # layout.prop(vd, "frame_duration")
 
-        if vd.file_format in {'BLENDER_VOXEL', 'RAW_8BIT'}:
+        if vd.file_format in {'BLENDER_VOXEL', 'RAW_8BIT', 'OPENVDB'}:
             layout.prop(vd, "use_still_frame")
             row = layout.row()
             row.active = vd.use_still_frame
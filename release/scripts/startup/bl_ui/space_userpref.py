@@ -489,10 +489,25 @@ class USERPREF_PT_system(Panel):
         col.separator()
 
         col.label(text="Sequencer/Clip Editor:")
-        # currently disabled in the code
-        # col.prop(system, "prefetch_frames")
+        col.prop(system, "prefetch_frames")
         col.prop(system, "memory_cache_limit")
 
+        col.separator()
+
+        col.label(text="Point Cache:")
+        col.prop(system, "point_cache_prefetch_limit", text="Prefetch Limit")
+
+        col.separator()
+
+        col.label(text="Image Tiles:")
+        col.prop(system, "image_tile_cache_limit", text="Memory Limit")
+
+        col.separator()
+
+        col.label(text="Compositor:")
+        col.prop(system, "compositor_cache_limit", text="Cache Limit")
+        col.prop(system, "compositor_memory_limit", text="Memory Limit")
+
         # 3. Column
         column = split.column()
 
@@ -997,6 +1012,7 @@ class USERPREF_PT_file(Panel):
         col.prop(paths, "save_version")
         col.prop(paths, "recent_files")
         col.prop(paths, "use_save_preview_images")
+        col.prop(paths, "use_blendfile_index")
 
         col.separator()
 
@@ -70,19 +70,32 @@ static IArchive open_archive(const std::string &filename,
 	return IArchive();
 }
 
-ArchiveReader::ArchiveReader(const char *filename)
+static void open_input_stream(std::ifstream &stream, const char *filename)
 {
 #ifdef WIN32
 	UTF16_ENCODE(filename);
 	std::wstring wstr(filename_16);
-	m_infile.open(wstr.c_str(), std::ios::in | std::ios::binary);
+	stream.open(wstr.c_str(), std::ios::in | std::ios::binary);
 	UTF16_UN_ENCODE(filename);
 #else
-	m_infile.open(filename, std::ios::in | std::ios::binary);
+	stream.open(filename, std::ios::in | std::ios::binary);
 #endif
+}
+
+ArchiveReader::ArchiveReader(const char *filename, int num_streams)
+{
+	open_input_stream(m_infile, filename);
 
 	m_streams.push_back(&m_infile);
 
+	for (int i = 1; i < num_streams; ++i) {
+		std::ifstream *infile = new std::ifstream();
+		open_input_stream(*infile, filename);
+
+		m_extra_infiles.push_back(infile);
+		m_streams.push_back(infile);
+	}
+
 	bool is_hdf5;
 	m_archive = open_archive(filename, m_streams, is_hdf5);
 
@@ -90,6 +103,20 @@ ArchiveReader::ArchiveReader(const char *filename)
 	if (is_hdf5) {
 		m_infile.close();
 		m_streams.clear();
+
+		for (size_t i = 0; i < m_extra_infiles.size(); ++i) {
+			m_extra_infiles[i]->close();
+		}
+	}
+}
+
+ArchiveReader::~ArchiveReader()
+{
+	/* Close the archive before the streams it reads from. */
+	m_archive.reset();
+
+	for (size_t i = 0; i < m_extra_infiles.size(); ++i) {
+		delete m_extra_infiles[i];
 	}
 }
 
@@ -45,8 +45,12 @@ class ArchiveReader {
 	std::ifstream m_infile;
 	std::vector<std::istream *> m_streams;
 
+	/* Additional streams, Ogawa archives can be read from one thread per stream. */
+	std::vector<std::ifstream *> m_extra_infiles;
+
 public:
-	explicit ArchiveReader(const char *filename);
+	explicit ArchiveReader(const char *filename, int num_streams = 1);
+	~ArchiveReader();
 
 	bool valid() const;
 
@@ -191,14 +191,30 @@ AbcCurveReader::AbcCurveReader(const Alembic::Abc::IObject &object, ImportSettin
 	ICurves abc_curves(object, kWrapExisting);
 	m_curves_schema = abc_curves.getSchema();
 
+	BLI_listbase_clear(&m_prefetched_nurbs);
+
 	get_min_max_time(m_iobject, m_curves_schema, m_min_time, m_max_time);
 }
 
+AbcCurveReader::~AbcCurveReader()
+{
+	BKE_nurbList_free(&m_prefetched_nurbs);
+}
+
 bool AbcCurveReader::valid() const
 {
 	return m_curves_schema.valid();
 }
 
+static void read_curve_nurbs(ListBase *nurbs, const short resolu, const short resolv,
+                             const ICurvesSchema &schema, const float time);
+
+void AbcCurveReader::prefetchObjectData(float time)
+{
+	/* The resolution is set once the curve is created. */
+	read_curve_nurbs(&m_prefetched_nurbs, 0, 0, m_curves_schema, time);
+}
+
 void AbcCurveReader::readObjectData(Main *bmain, float time)
 {
 	Curve *cu = BKE_curve_add(bmain, m_data_name.c_str(), OB_CURVE);
@@ -209,7 +225,17 @@ void AbcCurveReader::readObjectData(Main *bmain, float time)
 	m_object = BKE_object_add_only_object(bmain, OB_CURVE, m_object_name.c_str());
 	m_object->data = cu;
 
-	read_curve_sample(cu, m_curves_schema, time);
+	if (BLI_listbase_is_empty(&m_prefetched_nurbs)) {
+		read_curve_sample(cu, m_curves_schema, time);
+	}
+	else {
+		for (Nurb *nu = static_cast<Nurb *>(m_prefetched_nurbs.first); nu; nu = nu->next) {
+			nu->resolu = cu->resolu;
+			nu->resolv = cu->resolv;
+		}
+
+		BLI_movelisttolist(BKE_curve_nurbs_get(cu), &m_prefetched_nurbs);
+	}
 
 	if (has_animations(m_curves_schema, m_settings)) {
 		addCacheModifier();
@@ -219,6 +245,13 @@ void AbcCurveReader::readObjectData(Main *bmain, float time)
 /* ************************************************************************** */
 
 void read_curve_sample(Curve *cu, const ICurvesSchema &schema, const float time)
+{
+	read_curve_nurbs(BKE_curve_nurbs_get(cu), cu->resolu, cu->resolv, schema, time);
+}
+
+/* Doesn't access the Curve, so it can run in a worker thread. */
+static void read_curve_nurbs(ListBase *nurbs, const short resolu, const short resolv,
+                             const ICurvesSchema &schema, const float time)
 {
 	const ISampleSelector sample_sel(time);
 	ICurvesSchema::Sample smp = schema.getValue(sample_sel);
@@ -244,8 +277,8 @@ void read_curve_sample(Curve *cu, const ICurvesSchema &schema, const float time)
 		const int num_verts = (*num_vertices)[i];
 
 		Nurb *nu = static_cast<Nurb *>(MEM_callocN(sizeof(Nurb), "abc_getnurb"));
-		nu->resolu = cu->resolu;
-		nu->resolv = cu->resolv;
+		nu->resolu = resolu;
+		nu->resolv = resolv;
 		nu->pntsu = num_verts;
 		nu->pntsv = 1;
 		nu->flag |= CU_SMOOTH;
@@ -351,7 +384,7 @@ void read_curve_sample(Curve *cu, const ICurvesSchema &schema, const float time)
 			BKE_nurb_knot_calc_u(nu);
 		}
 
-		BLI_addtail(BKE_curve_nurbs_get(cu), nu);
+		BLI_addtail(nurbs, nu);
 	}
 }
 
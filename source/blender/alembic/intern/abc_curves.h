@@ -50,11 +50,16 @@ public:
 class AbcCurveReader : public AbcObjectReader {
 	Alembic::AbcGeom::ICurvesSchema m_curves_schema;
 
+	/* Nurbs read by prefetchObjectData(). */
+	ListBase m_prefetched_nurbs;
+
 public:
 	AbcCurveReader(const Alembic::Abc::IObject &object, ImportSettings &settings);
+	~AbcCurveReader();
 
 	bool valid() const;
 
+	void prefetchObjectData(float time);
 	void readObjectData(Main *bmain, float time);
 	DerivedMesh *read_derivedmesh(DerivedMesh *, const float time, int read_flag, const char **err_str);
 };
@@ -22,6 +22,7 @@
 
 #include "abc_exporter.h"
 
+#include <algorithm>
 #include <cmath>
 
 #include "abc_archive.h"
@@ -44,6 +45,8 @@ extern "C" {
 #include "DNA_space_types.h"  /* for FILE_MAX */
 
 #include "BLI_string.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
 
 #ifdef WIN32
 /* needed for MSCV because of snprintf from BLI_string */
@@ -57,6 +60,8 @@ extern "C" {
 #include "BKE_modifier.h"
 #include "BKE_particle.h"
 #include "BKE_scene.h"
+
+#include "PIL_time.h"
 }
 
 using Alembic::Abc::TimeSamplingPtr;
@@ -149,6 +154,8 @@ AbcExporter::AbcExporter(Scene *scene, const char *filename, ExportSettings &set
     , m_shape_sampling_index(0)
     , m_scene(scene)
     , m_writer(NULL)
+    , m_exported_frames(0)
+    , m_export_time(0.0)
 {}
 
 AbcExporter::~AbcExporter()
@@ -277,6 +284,7 @@ void AbcExporter::operator()(Main *bmain, float &progress, bool &was_canceled)
 	}
 
 	createShapeWriters(bmain->eval_ctx);
+	groupShapeWriters();
 
 	/* Make a list of frames to export. */
 
@@ -299,6 +307,8 @@ void AbcExporter::operator()(Main *bmain, float &progress, bool &was_canceled)
 	const float size = static_cast<float>(frames.size());
 	size_t i = 0;
 
+	const double time_start = PIL_check_seconds_timer();
+
 	for (; begin != end; ++begin) {
 		progress = (++i / size);
 
@@ -313,11 +323,11 @@ void AbcExporter::operator()(Main *bmain, float &progress, bool &was_canceled)
 		setCurrentFrame(bmain, frame - m_settings.frame_start);
 
 		if (shape_frames.count(frame) != 0) {
-			for (int i = 0, e = m_shapes.size(); i != e; ++i) {
-				m_shapes[i]->write();
-			}
+			writeShapes();
 		}
 
+		m_exported_frames++;
+
 		if (xform_frames.count(frame) == 0) {
 			continue;
 		}
@@ -337,6 +347,130 @@ void AbcExporter::operator()(Main *bmain, float &progress, bool &was_canceled)
 
 		archive_bounds_prop.set(bounds);
 	}
+
+	m_export_time = PIL_check_seconds_timer() - time_start;
+}
+
+int AbcExporter::exportedFrames() const
+{
+	return m_exported_frames;
+}
+
+double AbcExporter::exportTime() const
+{
+	return m_export_time;
+}
+
+static void object_links_cb(void *userData, Object * /*ob*/, Object **obpoin, int /*cd_flag*/)
+{
+	if (*obpoin) {
+		*static_cast<bool *>(userData) = true;
+	}
+}
+
+/* Like the threaded object update of the dependency graph, evaluating the modifier
+ * stack of an object only runs in a task when it doesn't read other objects,
+ * which may be evaluated at the same time, or point caches. */
+static bool object_evaluates_threaded(Scene *scene, Object *ob)
+{
+	for (ModifierData *md = static_cast<ModifierData *>(ob->modifiers.first); md; md = md->next) {
+		const ModifierTypeInfo *mti = modifierType_getInfo(static_cast<ModifierType>(md->type));
+		bool has_links = false;
+
+		if (!modifier_isEnabled(scene, md, eModifierMode_Render)) {
+			continue;
+		}
+
+		if (mti->flags & eModifierTypeFlag_UsesPointCache) {
+			return false;
+		}
+
+		if (mti->foreachObjectLink) {
+			mti->foreachObjectLink(md, ob, object_links_cb, &has_links);
+
+			if (has_links) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+/* Writers of objects sharing their data are evaluated by the same task, dupli
+ * writers share (and temporarily modify) the object and objects sharing a mesh
+ * share its data. */
+void AbcExporter::groupShapeWriters()
+{
+	std::map<void *, size_t> group_index;
+
+	m_shape_groups.clear();
+
+	for (int i = 0, e = m_shapes.size(); i != e; ++i) {
+		Object *ob = m_shapes[i]->object();
+		void *key = (ob->data) ? ob->data : ob;
+		const bool threaded = object_evaluates_threaded(m_scene, ob);
+		std::map<void *, size_t>::iterator it = group_index.find(key);
+
+		if (it == group_index.end()) {
+			group_index[key] = m_shape_groups.size();
+			m_shape_groups.push_back(AbcShapeGroup());
+			m_shape_groups.back().writers.push_back(m_shapes[i]);
+			m_shape_groups.back().threaded = threaded;
+		}
+		else {
+			AbcShapeGroup &group = m_shape_groups[it->second];
+			group.writers.push_back(m_shapes[i]);
+			group.threaded = group.threaded && threaded;
+		}
+	}
+}
+
+struct ShapePrepareData {
+	std::vector<AbcShapeGroup> *groups;
+	size_t start;
+};
+
+static void shape_prepare_cb(void *userdata, const int iter)
+{
+	ShapePrepareData *data = static_cast<ShapePrepareData *>(userdata);
+	AbcShapeGroup &group = (*data->groups)[data->start + iter];
+
+	if (!group.threaded) {
+		return;
+	}
+
+	for (int i = 0, e = group.writers.size(); i != e; ++i) {
+		group.writers[i]->prepare();
+	}
+}
+
+/* Evaluating the objects and extracting their sample data happens in parallel, each
+ * writer evaluates its own derived mesh. Groups that can't be evaluated in a task are
+ * prepared by write() on the main thread. Writing to the archive isn't thread safe and
+ * is done in order afterwards. Objects are handled in batches to limit the memory used
+ * by prepared samples. */
+void AbcExporter::writeShapes()
+{
+	const size_t batch_size = 4 * BLI_system_thread_count();
+
+	for (size_t start = 0; start < m_shape_groups.size(); start += batch_size) {
+		const size_t end = std::min(start + batch_size, m_shape_groups.size());
+
+		ShapePrepareData data;
+		data.groups = &m_shape_groups;
+		data.start = start;
+
+		BLI_task_parallel_range(0, static_cast<int>(end - start), &data, shape_prepare_cb, (end - start) > 1);
+
+		for (size_t i = start; i != end; ++i) {
+			AbcShapeGroup &group = m_shape_groups[i];
+
+			for (int j = 0, e = group.writers.size(); j != e; ++j) {
+				group.writers[j]->write();
+			}
+		}
+	}
 }
 
 void AbcExporter::createTransformWritersHierarchy(EvaluationContext *eval_ctx)
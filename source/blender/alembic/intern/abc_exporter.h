@@ -75,6 +75,15 @@ struct ExportSettings {
 	float convert_matrix[3][3];
 };
 
+/* Shape writers that are prepared by the same task. */
+struct AbcShapeGroup {
+	std::vector<AbcObjectWriter *> writers;
+
+	/* False when evaluating the objects reads other objects or point caches,
+	 * then the group is prepared on the main thread. */
+	bool threaded;
+};
+
 class AbcExporter {
 	ExportSettings &m_settings;
 
@@ -89,12 +98,22 @@ class AbcExporter {
 	std::map<std::string, AbcTransformWriter *> m_xforms;
 	std::vector<AbcObjectWriter *> m_shapes;
 
+	/* Shape writers grouped by object data, see writeShapes(). */
+	std::vector<AbcShapeGroup> m_shape_groups;
+
+	/* Statistics for the export report. */
+	int m_exported_frames;
+	double m_export_time;
+
 public:
 	AbcExporter(Scene *scene, const char *filename, ExportSettings &settings);
 	~AbcExporter();
 
 	void operator()(Main *bmain, float &progress, bool &was_canceled);
 
+	int exportedFrames() const;
+	double exportTime() const;
+
 private:
 	void getShutterSamples(double step, bool time_relative, std::vector<double> &samples);
 
@@ -109,6 +128,9 @@ private:
 	void exploreObject(EvaluationContext *eval_ctx, Object *ob, Object *dupliObParent);
 	void createShapeWriters(EvaluationContext *eval_ctx);
 	void createShapeWriter(Object *ob, Object *dupliObParent);
+	void groupShapeWriters();
+
+	void writeShapes();
 
 	AbcTransformWriter *getXForm(const std::string &name);
 
@@ -28,6 +28,8 @@
 #include "abc_util.h"
 
 extern "C" {
+#include "MEM_guardedalloc.h"
+
 #include "DNA_material_types.h"
 #include "DNA_mesh_types.h"
 #include "DNA_modifier_types.h"
@@ -297,6 +299,8 @@ AbcMeshWriter::AbcMeshWriter(Scene *scene,
 	m_is_animated = isAnimated();
 	m_subsurf_mod = NULL;
 	m_is_subd = false;
+	m_prepared_dm = NULL;
+	m_smooth_normal = false;
 
 	/* If the object is static, use the default static time sampling. */
 	if (!m_is_animated) {
@@ -330,6 +334,10 @@ AbcMeshWriter::AbcMeshWriter(Scene *scene,
 
 AbcMeshWriter::~AbcMeshWriter()
 {
+	if (m_prepared_dm) {
+		freeMesh(m_prepared_dm);
+	}
+
 	if (m_subsurf_mod) {
 		m_subsurf_mod->mode &= ~eModifierMode_DisableTemporary;
 	}
@@ -358,13 +366,31 @@ bool AbcMeshWriter::isAnimated() const
 	return false;
 }
 
-void AbcMeshWriter::do_write()
+void AbcMeshWriter::do_prepare()
 {
 	/* We have already stored a sample for this object. */
 	if (!m_first_frame && !m_is_animated)
 		return;
 
 	DerivedMesh *dm = getFinalMesh();
+	getSampleData(dm);
+
+	m_prepared_dm = dm;
+}
+
+void AbcMeshWriter::do_write()
+{
+	/* We have already stored a sample for this object. */
+	if (!m_first_frame && !m_is_animated)
+		return;
+
+	DerivedMesh *dm = m_prepared_dm;
+	m_prepared_dm = NULL;
+
+	if (dm == NULL) {
+		dm = getFinalMesh();
+		getSampleData(dm);
+	}
 
 	try {
 		if (m_settings.use_subdiv_schema && m_subdiv_schema.valid()) {
@@ -375,30 +401,63 @@ void AbcMeshWriter::do_write()
 		}
 
 		freeMesh(dm);
+		freeSampleData();
 	}
 	catch (...) {
 		freeMesh(dm);
+		freeSampleData();
 		throw;
 	}
 }
 
-void AbcMeshWriter::writeMesh(DerivedMesh *dm)
+/* Copy the mesh data into the vectors used by the Alembic samples, this
+ * doesn't touch the archive so it can run in a worker thread. */
+void AbcMeshWriter::getSampleData(DerivedMesh *dm)
 {
-	std::vector<Imath::V3f> points, normals;
-	std::vector<int32_t> poly_verts, loop_counts;
+	get_vertices(dm, m_points);
+	get_topology(dm, m_poly_verts, m_loop_counts, m_smooth_normal);
+
+	if (m_settings.use_subdiv_schema && m_subdiv_schema.valid()) {
+		get_creases(dm, m_crease_indices, m_crease_lengths, m_crease_sharpness);
+	}
+	else {
+		if (m_settings.export_normals) {
+			if (m_smooth_normal) {
+				get_loop_normals(dm, m_normals);
+			}
+			else {
+				get_vertex_normals(dm, m_normals);
+			}
+		}
 
-	bool smooth_normal = false;
+		if (m_is_liquid) {
+			getVelocities(dm, m_velocities);
+		}
+	}
+}
 
-	get_vertices(dm, points);
-	get_topology(dm, poly_verts, loop_counts, smooth_normal);
+void AbcMeshWriter::freeSampleData()
+{
+	/* Release the memory, with many objects keeping it around for the next frame adds up. */
+	std::vector<Imath::V3f>().swap(m_points);
+	std::vector<Imath::V3f>().swap(m_normals);
+	std::vector<Imath::V3f>().swap(m_velocities);
+	std::vector<int32_t>().swap(m_poly_verts);
+	std::vector<int32_t>().swap(m_loop_counts);
+	std::vector<int32_t>().swap(m_crease_indices);
+	std::vector<int32_t>().swap(m_crease_lengths);
+	std::vector<float>().swap(m_crease_sharpness);
+}
 
+void AbcMeshWriter::writeMesh(DerivedMesh *dm)
+{
 	if (m_first_frame && m_settings.export_face_sets) {
 		writeFaceSets(dm, m_mesh_schema);
 	}
 
-	m_mesh_sample = OPolyMeshSchema::Sample(V3fArraySample(points),
-	                                        Int32ArraySample(poly_verts),
-	                                        Int32ArraySample(loop_counts));
+	m_mesh_sample = OPolyMeshSchema::Sample(V3fArraySample(m_points),
+	                                        Int32ArraySample(m_poly_verts),
+	                                        Int32ArraySample(m_loop_counts));
 
 	UVSample sample;
 	if (m_first_frame && m_settings.export_uvs) {
@@ -418,27 +477,17 @@ void AbcMeshWriter::writeMesh(DerivedMesh *dm)
 	}
 
 	if (m_settings.export_normals) {
-		if (smooth_normal) {
-			get_loop_normals(dm, normals);
-		}
-		else {
-			get_vertex_normals(dm, normals);
-		}
-
 		ON3fGeomParam::Sample normals_sample;
-		if (!normals.empty()) {
-			normals_sample.setScope((smooth_normal) ? kFacevaryingScope : kVertexScope);
-			normals_sample.setVals(V3fArraySample(normals));
+		if (!m_normals.empty()) {
+			normals_sample.setScope((m_smooth_normal) ? kFacevaryingScope : kVertexScope);
+			normals_sample.setVals(V3fArraySample(m_normals));
 		}
 
 		m_mesh_sample.setNormals(normals_sample);
 	}
 
 	if (m_is_liquid) {
-		std::vector<Imath::V3f> velocities;
-		getVelocities(dm, velocities);
-
-		m_mesh_sample.setVelocities(V3fArraySample(velocities));
+		m_mesh_sample.setVelocities(V3fArraySample(m_velocities));
 	}
 
 	m_mesh_sample.setSelfBounds(bounds());
@@ -450,24 +499,13 @@ void AbcMeshWriter::writeMesh(DerivedMesh *dm)
 
 void AbcMeshWriter::writeSubD(DerivedMesh *dm)
 {
-	std::vector<float> crease_sharpness;
-	std::vector<Imath::V3f> points;
-	std::vector<int32_t> poly_verts, loop_counts;
-	std::vector<int32_t> crease_indices, crease_lengths;
-
-	bool smooth_normal = false;
-
-	get_vertices(dm, points);
-	get_topology(dm, poly_verts, loop_counts, smooth_normal);
-	get_creases(dm, crease_indices, crease_lengths, crease_sharpness);
-
 	if (m_first_frame && m_settings.export_face_sets) {
 		writeFaceSets(dm, m_subdiv_schema);
 	}
 
-	m_subdiv_sample = OSubDSchema::Sample(V3fArraySample(points),
-	                                      Int32ArraySample(poly_verts),
-	                                      Int32ArraySample(loop_counts));
+	m_subdiv_sample = OSubDSchema::Sample(V3fArraySample(m_points),
+	                                      Int32ArraySample(m_poly_verts),
+	                                      Int32ArraySample(m_loop_counts));
 
 	UVSample sample;
 	if (m_first_frame && m_settings.export_uvs) {
@@ -486,10 +524,10 @@ void AbcMeshWriter::writeSubD(DerivedMesh *dm)
 		write_custom_data(m_subdiv_schema.getArbGeomParams(), m_custom_data_config, &dm->loopData, CD_MLOOPUV);
 	}
 
-	if (!crease_indices.empty()) {
-		m_subdiv_sample.setCreaseIndices(Int32ArraySample(crease_indices));
-		m_subdiv_sample.setCreaseLengths(Int32ArraySample(crease_lengths));
-		m_subdiv_sample.setCreaseSharpnesses(FloatArraySample(crease_sharpness));
+	if (!m_crease_indices.empty()) {
+		m_subdiv_sample.setCreaseIndices(Int32ArraySample(m_crease_indices));
+		m_subdiv_sample.setCreaseLengths(Int32ArraySample(m_crease_lengths));
+		m_subdiv_sample.setCreaseSharpnesses(FloatArraySample(m_crease_sharpness));
 	}
 
 	m_subdiv_sample.setSelfBounds(bounds());
@@ -513,6 +551,8 @@ void AbcMeshWriter::writeFaceSets(DerivedMesh *dm, Schema &schema)
 	}
 }
 
+/* Called from a task for objects that only depend on their own data, see
+ * #AbcExporter::groupShapeWriters, the derived mesh belongs to this writer. */
 DerivedMesh *AbcMeshWriter::getFinalMesh()
 {
 	/* We don't want subdivided mesh data */
@@ -816,6 +856,34 @@ static void read_mpolys(CDStreamConfig &config, const AbcMeshData &mesh_data)
 	}
 }
 
+/* Same as the UV part of read_mpolys(), using the polygons already in 'config'. */
+static void read_loop_uvs(CDStreamConfig &config, const AbcMeshData &mesh_data)
+{
+	MLoopUV *mloopuvs = config.mloopuv;
+	const V2fArraySamplePtr &uvs = mesh_data.uvs;
+	const UInt32ArraySamplePtr &uvs_indices = mesh_data.uvs_indices;
+
+	if (!(mloopuvs && uvs && uvs_indices) || (uvs_indices->size() != config.totloop)) {
+		return;
+	}
+
+	for (int i = 0; i < config.totpoly; ++i) {
+		const MPoly &poly = config.mpoly[i];
+		unsigned int loop_index = poly.loopstart;
+
+		/* NOTE: Alembic data is stored in the reverse order. */
+		unsigned int rev_loop_index = loop_index + (poly.totloop - 1);
+
+		for (int f = 0; f < poly.totloop; ++f, ++loop_index, --rev_loop_index) {
+			MLoopUV &loopuv = mloopuvs[rev_loop_index];
+			const unsigned int uv_index = (*uvs_indices)[loop_index];
+
+			loopuv.uv[0] = (*uvs)[uv_index][0];
+			loopuv.uv[1] = (*uvs)[uv_index][1];
+		}
+	}
+}
+
 ABC_INLINE void read_uvs_params(CDStreamConfig &config,
                                 AbcMeshData &abc_data,
                                 const IV2fGeomParam &uv,
@@ -995,6 +1063,12 @@ CDStreamConfig get_config(DerivedMesh *dm)
 
 AbcMeshReader::AbcMeshReader(const IObject &object, ImportSettings &settings)
     : AbcObjectReader(object, settings)
+    , m_topology_mpolys(NULL)
+    , m_topology_mloops(NULL)
+    , m_topology_totvert(0)
+    , m_topology_totpoly(0)
+    , m_topology_totloop(0)
+    , m_prefetched_dm(NULL)
 {
 	m_settings->read_flag |= MOD_MESHSEQ_READ_ALL;
 
@@ -1004,11 +1078,40 @@ AbcMeshReader::AbcMeshReader(const IObject &object, ImportSettings &settings)
 	get_min_max_time(m_iobject, m_schema, m_min_time, m_max_time);
 }
 
+AbcMeshReader::~AbcMeshReader()
+{
+	if (m_prefetched_dm) {
+		m_prefetched_dm->release(m_prefetched_dm);
+	}
+
+	freeTopology();
+}
+
 bool AbcMeshReader::valid() const
 {
 	return m_schema.valid();
 }
 
+/* Decodes the sample into a DerivedMesh without touching Main, so it can run
+ * in a worker thread before the object is created. */
+static DerivedMesh *read_new_derivedmesh(AbcObjectReader *reader, DerivedMesh *dm, const float time)
+{
+	DerivedMesh *ndm = reader->read_derivedmesh(dm, time, MOD_MESHSEQ_READ_ALL, NULL);
+
+	if (ndm != dm) {
+		dm->release(dm);
+	}
+
+	return ndm;
+}
+
+void AbcMeshReader::prefetchObjectData(float time)
+{
+	if (m_prefetched_dm == NULL) {
+		m_prefetched_dm = read_new_derivedmesh(this, CDDM_new(0, 0, 0, 0, 0), time);
+	}
+}
+
 void AbcMeshReader::readObjectData(Main *bmain, float time)
 {
 	Mesh *mesh = BKE_mesh_add(bmain, m_data_name.c_str());
@@ -1018,11 +1121,11 @@ void AbcMeshReader::readObjectData(Main *bmain, float time)
 
 	const ISampleSelector sample_sel(time);
 
-	DerivedMesh *dm = CDDM_from_mesh(mesh);
-	DerivedMesh *ndm = this->read_derivedmesh(dm, time, MOD_MESHSEQ_READ_ALL, NULL);
+	DerivedMesh *ndm = m_prefetched_dm;
+	m_prefetched_dm = NULL;
 
-	if (ndm != dm) {
-		dm->release(dm);
+	if (ndm == NULL) {
+		ndm = read_new_derivedmesh(this, CDDM_from_mesh(mesh), time);
 	}
 
 	DM_to_mesh(ndm, mesh, m_object, CD_MASK_MESH, true);
@@ -1040,6 +1143,14 @@ void AbcMeshReader::readObjectData(Main *bmain, float time)
 
 DerivedMesh *AbcMeshReader::read_derivedmesh(DerivedMesh *dm, const float time, int read_flag, const char **err_str)
 {
+	if (m_topology_mpolys && (read_flag & MOD_MESHSEQ_READ_POLY) != 0) {
+		DerivedMesh *result = readConstantTopology(dm, time, read_flag);
+
+		if (result) {
+			return result;
+		}
+	}
+
 	ISampleSelector sample_sel(time);
 	const IPolyMeshSchema::Sample sample = m_schema.getValue(sample_sel);
 
@@ -1093,6 +1204,125 @@ DerivedMesh *AbcMeshReader::read_derivedmesh(DerivedMesh *dm, const float time,
 
 		CDDM_calc_normals(new_dm);
 		CDDM_calc_edges(new_dm);
+	}
+	else if (do_normals) {
+		CDDM_calc_normals(dm);
+	}
+
+	if ((settings.read_flag & MOD_MESHSEQ_READ_POLY) != 0 && topologyIsConstant()) {
+		storeTopology(new_dm ? new_dm : dm);
+	}
+
+	return new_dm ? new_dm : dm;
+}
+
+bool AbcMeshReader::topologyIsConstant() const
+{
+	/* Every file of a sequence has its own topology. */
+	if (m_settings->is_sequence) {
+		return false;
+	}
+
+	return m_schema.getTopologyVariance() != Alembic::AbcGeom::kHeterogenousTopology;
+}
+
+void AbcMeshReader::storeTopology(DerivedMesh *dm)
+{
+	const int totpoly = dm->getNumPolys(dm);
+	const int totloop = dm->getNumLoops(dm);
+
+	if (totpoly != m_topology_totpoly || totloop != m_topology_totloop) {
+		freeTopology();
+
+		m_topology_mpolys = static_cast<MPoly *>(MEM_mallocN(sizeof(MPoly) * totpoly, "AbcMeshReader mpolys"));
+		m_topology_mloops = static_cast<MLoop *>(MEM_mallocN(sizeof(MLoop) * totloop, "AbcMeshReader mloops"));
+		m_topology_totpoly = totpoly;
+		m_topology_totloop = totloop;
+	}
+
+	m_topology_totvert = dm->getNumVerts(dm);
+
+	memcpy(m_topology_mpolys, dm->getPolyArray(dm), sizeof(MPoly) * totpoly);
+	memcpy(m_topology_mloops, dm->getLoopArray(dm), sizeof(MLoop) * totloop);
+}
+
+void AbcMeshReader::freeTopology()
+{
+	if (m_topology_mpolys) {
+		MEM_freeN(m_topology_mpolys);
+		m_topology_mpolys = NULL;
+	}
+
+	if (m_topology_mloops) {
+		MEM_freeN(m_topology_mloops);
+		m_topology_mloops = NULL;
+	}
+
+	m_topology_totvert = m_topology_totpoly = m_topology_totloop = 0;
+}
+
+/* Only read the positions (and UVs and colors if requested), copying the
+ * polygons and loops stored by the previous full read. Returns NULL when the
+ * sample doesn't match the stored topology. */
+DerivedMesh *AbcMeshReader::readConstantTopology(DerivedMesh *dm, const float time, int read_flag)
+{
+	const ISampleSelector sample_sel(time);
+
+	AbcMeshData abc_mesh_data;
+	abc_mesh_data.positions = m_schema.getPositionsProperty().getValue(sample_sel);
+
+	if (abc_mesh_data.positions->size() != m_topology_totvert) {
+		return NULL;
+	}
+
+	DerivedMesh *new_dm = NULL;
+
+	if (dm->getNumVerts(dm) != m_topology_totvert ||
+	    dm->getNumPolys(dm) != m_topology_totpoly ||
+	    dm->getNumLoops(dm) != m_topology_totloop)
+	{
+		new_dm = CDDM_from_template(dm,
+		                            m_topology_totvert,
+		                            0,
+		                            0,
+		                            m_topology_totloop,
+		                            m_topology_totpoly);
+	}
+
+	CDStreamConfig config = get_config(new_dm ? new_dm : dm);
+	config.time = time;
+
+	get_weight_and_index(config, m_schema.getTimeSampling(), m_schema.getNumSamples());
+
+	if (config.weight != 0.0f) {
+		const ISampleSelector ceil_sel(config.ceil_index);
+		abc_mesh_data.ceil_positions = m_schema.getPositionsProperty().getValue(ceil_sel);
+	}
+
+	if (new_dm || (read_flag & MOD_MESHSEQ_READ_VERT) != 0) {
+		read_mverts(config, abc_mesh_data);
+	}
+
+	memcpy(config.mpoly, m_topology_mpolys, sizeof(MPoly) * m_topology_totpoly);
+	memcpy(config.mloop, m_topology_mloops, sizeof(MLoop) * m_topology_totloop);
+
+	if ((read_flag & MOD_MESHSEQ_READ_UV) != 0) {
+		read_uvs_params(config, abc_mesh_data, m_schema.getUVsParam(), sample_sel);
+		read_loop_uvs(config, abc_mesh_data);
+	}
+
+	if ((read_flag & (MOD_MESHSEQ_READ_UV | MOD_MESHSEQ_READ_COLOR)) != 0) {
+		read_custom_data(m_schema.getArbGeomParams(), config, sample_sel);
+	}
+
+	/* Normals aren't read from the file (see read_normals_params), only whether
+	 * there are any, the smooth flags are part of the stored polygons. */
+	const IN3fGeomParam normals = m_schema.getNormalsParam();
+	const bool do_normals = normals.valid() && (normals.getScope() == kFacevaryingScope);
+
+	if (new_dm) {
+		CDDM_calc_normals(new_dm);
+		CDDM_calc_edges(new_dm);
 
 		return new_dm;
 	}
@@ -1213,6 +1443,7 @@ static void read_subd_sample(ImportSettings *settings,
 
 AbcSubDReader::AbcSubDReader(const IObject &object, ImportSettings &settings)
     : AbcObjectReader(object, settings)
+    , m_prefetched_dm(NULL)
 {
 	m_settings->read_flag |= MOD_MESHSEQ_READ_ALL;
 
@@ -1222,11 +1453,32 @@ AbcSubDReader::AbcSubDReader(const IObject &object, ImportSettings &settings)
 	get_min_max_time(m_iobject, m_schema, m_min_time, m_max_time);
 }
 
+AbcSubDReader::~AbcSubDReader()
+{
+	if (m_prefetched_dm) {
+		m_prefetched_dm->release(m_prefetched_dm);
+	}
+}
+
 bool AbcSubDReader::valid() const
 {
 	return m_schema.valid();
 }
 
+void AbcSubDReader::prefetchObjectData(float time)
+{
+	if (m_prefetched_dm != NULL) {
+		return;
+	}
+
+	m_prefetched_dm = read_new_derivedmesh(this, CDDM_new(0, 0, 0, 0, 0), time);
+
+	const ISampleSelector sample_sel(time);
+	const ISubDSchema::Sample sample = m_schema.getValue(sample_sel);
+	m_prefetched_crease_indices = sample.getCreaseIndices();
+	m_prefetched_crease_sharpnesses = sample.getCreaseSharpnesses();
+}
+
 void AbcSubDReader::readObjectData(Main *bmain, float time)
 {
 	Mesh *mesh = BKE_mesh_add(bmain, m_data_name.c_str());
@@ -1234,20 +1486,25 @@ void AbcSubDReader::readObjectData(Main *bmain, float time)
 	m_object = BKE_object_add_only_object(bmain, OB_MESH, m_object_name.c_str());
 	m_object->data = mesh;
 
-	DerivedMesh *dm = CDDM_from_mesh(mesh);
-	DerivedMesh *ndm = this->read_derivedmesh(dm, time, MOD_MESHSEQ_READ_ALL, NULL);
+	DerivedMesh *ndm = m_prefetched_dm;
+	Int32ArraySamplePtr indices = m_prefetched_crease_indices;
+	Alembic::Abc::FloatArraySamplePtr sharpnesses = m_prefetched_crease_sharpnesses;
 
-	if (ndm != dm) {
-		dm->release(dm);
+	m_prefetched_dm = NULL;
+	m_prefetched_crease_indices.reset();
+	m_prefetched_crease_sharpnesses.reset();
+
+	if (ndm == NULL) {
+		ndm = read_new_derivedmesh(this, CDDM_from_mesh(mesh), time);
+
+		const ISampleSelector sample_sel(time);
+		const ISubDSchema::Sample sample = m_schema.getValue(sample_sel);
+		indices = sample.getCreaseIndices();
+		sharpnesses = sample.getCreaseSharpnesses();
 	}
 
 	DM_to_mesh(ndm, mesh, m_object, CD_MASK_MESH, true);
 
-	const ISampleSelector sample_sel(time);
-	const ISubDSchema::Sample sample = m_schema.getValue(sample_sel);
-	Int32ArraySamplePtr indices = sample.getCreaseIndices();
-	Alembic::Abc::FloatArraySamplePtr sharpnesses = sample.getCreaseSharpnesses();
-
 	MEdge *edges = mesh->medge;
 
 	if (indices && sharpnesses) {
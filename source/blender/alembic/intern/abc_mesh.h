@@ -28,6 +28,8 @@
 
 struct DerivedMesh;
 struct Mesh;
+struct MLoop;
+struct MPoly;
 struct ModifierData;
 
 /* ************************************************************************** */
@@ -49,6 +51,14 @@ class AbcMeshWriter : public AbcObjectWriter {
 	bool m_is_liquid;
 	bool m_is_subd;
 
+	/* Sample data extracted in do_prepare(), possibly in a worker thread. */
+	DerivedMesh *m_prepared_dm;
+	std::vector<Imath::V3f> m_points, m_normals, m_velocities;
+	std::vector<int32_t> m_poly_verts, m_loop_counts;
+	std::vector<int32_t> m_crease_indices, m_crease_lengths;
+	std::vector<float> m_crease_sharpness;
+	bool m_smooth_normal;
+
 public:
 	AbcMeshWriter(Scene *scene,
 	              Object *ob,
@@ -59,10 +69,14 @@ public:
 	~AbcMeshWriter();
 
 private:
+	virtual void do_prepare();
 	virtual void do_write();
 
 	bool isAnimated() const;
 
+	void getSampleData(DerivedMesh *dm);
+	void freeSampleData();
+
 	void writeMesh(DerivedMesh *dm);
 	void writeSubD(DerivedMesh *dm);
 
@@ -95,11 +109,24 @@ class AbcMeshReader : public AbcObjectReader {
 
 	CDStreamConfig m_mesh_data;
 
+	/* Polygons and loops of the last full read. When the topology of the
+	 * schema is constant these are reused, so only positions are streamed. */
+	MPoly *m_topology_mpolys;
+	MLoop *m_topology_mloops;
+	int m_topology_totvert;
+	int m_topology_totpoly;
+	int m_topology_totloop;
+
+	/* Mesh decoded by prefetchObjectData(), consumed by readObjectData(). */
+	DerivedMesh *m_prefetched_dm;
+
 public:
 	AbcMeshReader(const Alembic::Abc::IObject &object, ImportSettings &settings);
+	~AbcMeshReader();
 
 	bool valid() const;
 
+	void prefetchObjectData(float time);
 	void readObjectData(Main *bmain, float time);
 
 	DerivedMesh *read_derivedmesh(DerivedMesh *dm, const float time, int read_flag, const char **err_str);
@@ -107,6 +134,11 @@ public:
 private:
 	void readFaceSetsSample(Main *bmain, Mesh *mesh, size_t poly_start,
 	                        const Alembic::AbcGeom::ISampleSelector &sample_sel);
+
+	bool topologyIsConstant() const;
+	void storeTopology(DerivedMesh *dm);
+	void freeTopology();
+	DerivedMesh *readConstantTopology(DerivedMesh *dm, const float time, int read_flag);
 };
 
 /* ************************************************************************** */
@@ -116,11 +148,18 @@ class AbcSubDReader : public AbcObjectReader {
 
 	CDStreamConfig m_mesh_data;
 
+	/* Mesh and creases decoded by prefetchObjectData(), consumed by readObjectData(). */
+	DerivedMesh *m_prefetched_dm;
+	Alembic::Abc::Int32ArraySamplePtr m_prefetched_crease_indices;
+	Alembic::Abc::FloatArraySamplePtr m_prefetched_crease_sharpnesses;
+
 public:
 	AbcSubDReader(const Alembic::Abc::IObject &object, ImportSettings &settings);
+	~AbcSubDReader();
 
 	bool valid() const;
 
+	void prefetchObjectData(float time);
 	void readObjectData(Main *bmain, float time);
 	DerivedMesh *read_derivedmesh(DerivedMesh *dm, const float time, int read_flag, const char **err_str);
 };
@@ -109,6 +109,16 @@ Imath::Box3d AbcObjectWriter::bounds()
 	return this->m_bounds;
 }
 
+Object *AbcObjectWriter::object() const
+{
+	return m_object;
+}
+
+void AbcObjectWriter::prepare()
+{
+	do_prepare();
+}
+
 void AbcObjectWriter::write()
 {
 	do_write();
@@ -68,9 +68,17 @@ public:
 
 	virtual Imath::Box3d bounds();
 
+	Object *object() const;
+
+	/* Evaluate the object and extract the sample data for the current frame.
+	 * Called from worker threads before write(), never for two writers sharing
+	 * object data at once. Writers that aren't prepared do all work in write(). */
+	void prepare();
+
 	void write();
 
 private:
+	virtual void do_prepare() {}
 	virtual void do_write() = 0;
 };
 
@@ -163,6 +171,13 @@ public:
 
 	virtual bool valid() const = 0;
 
+	/* Read and decode the first sample ahead of readObjectData(). This doesn't
+	 * touch the main database, so it is called from worker threads on import. */
+	virtual void prefetchObjectData(float time)
+	{
+		(void)time;
+	}
+
 	virtual void readObjectData(Main *bmain, float time) = 0;
 
 	virtual DerivedMesh *read_derivedmesh(DerivedMesh *dm, const float time, int read_flag, const char **err_str)
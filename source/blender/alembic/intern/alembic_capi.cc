@@ -65,6 +65,8 @@ extern "C" {
 #include "BLI_math.h"
 #include "BLI_path_util.h"
 #include "BLI_string.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
 
 #include "WM_api.h"
 #include "WM_types.h"
@@ -266,6 +268,9 @@ struct ExportJobData {
 	float *progress;
 
 	bool was_canceled;
+
+	int exported_frames;
+	double export_time;
 };
 
 static void export_startjob(void *customdata, short *stop, short *do_update, float *progress)
@@ -293,6 +298,9 @@ static void export_startjob(void *customdata, short *stop, short *do_update, flo
 		data->was_canceled = false;
 		exporter(data->bmain, *data->progress, data->was_canceled);
 
+		data->exported_frames = exporter.exportedFrames();
+		data->export_time = exporter.exportTime();
+
 		if (CFRA != orig_frame) {
 			CFRA = orig_frame;
 
@@ -315,6 +323,11 @@ static void export_endjob(void *customdata)
 	if (data->was_canceled && BLI_exists(data->filename)) {
 		BLI_delete(data->filename, false, false);
 	}
+	else if (data->exported_frames > 0) {
+		WM_reportf(RPT_INFO, "Alembic export: %d frame(s) in %.2f s (%.2f fps)",
+		           data->exported_frames, data->export_time,
+		           (data->export_time > 0.0) ? data->exported_frames / data->export_time : 0.0);
+	}
 
 	G.is_rendering = false;
 	BKE_spacedata_draw_locks(false);
@@ -328,6 +341,8 @@ void ABC_export(
 {
 	ExportJobData *job = static_cast<ExportJobData *>(MEM_mallocN(sizeof(ExportJobData), "ExportJobData"));
 	job->scene = scene;
+	job->exported_frames = 0;
+	job->export_time = 0.0;
 	job->bmain = CTX_data_main(C);
 	BLI_strncpy(job->filename, filepath, 1024);
 
@@ -540,6 +555,24 @@ ABC_INLINE bool is_mesh_and_strands(const IObject &object)
 	return has_mesh && has_curve;
 }
 
+/* Number of readers decoded per parallel batch, between two progress updates. */
+#define IMPORT_PREFETCH_BATCH_SIZE 256
+
+struct ImportPrefetchData {
+	AbcObjectReader **readers;
+	int offset;
+};
+
+static void import_prefetch_cb(void *userdata, const int index)
+{
+	ImportPrefetchData *data = static_cast<ImportPrefetchData *>(userdata);
+	AbcObjectReader *reader = data->readers[data->offset + index];
+
+	if (!G.is_break && reader->valid()) {
+		reader->prefetchObjectData(0.0f);
+	}
+}
+
 static void import_startjob(void *user_data, short *stop, short *do_update, float *progress)
 {
 	ImportJobData *data = static_cast<ImportJobData *>(user_data);
@@ -548,7 +581,8 @@ static void import_startjob(void *user_data, short *stop, short *do_update, floa
 	data->do_update = do_update;
 	data->progress = progress;
 
-	ArchiveReader *archive = new ArchiveReader(data->filename);
+	/* One stream per thread, so Ogawa archives are read concurrently. */
+	ArchiveReader *archive = new ArchiveReader(data->filename, BLI_system_thread_count());
 
 	if (!archive->valid()) {
 		delete archive;
@@ -587,27 +621,20 @@ static void import_startjob(void *user_data, short *stop, short *do_update, floa
 	*data->do_update = true;
 	*data->progress = 0.1f;
 
-	/* Create objects and set scene frame range. */
+	/* Decode the first samples in parallel, objects are created in the end job. */
 
-	const float size = static_cast<float>(data->readers.size());
-	size_t i = 0;
+	const int tot_readers = static_cast<int>(data->readers.size());
 
-	chrono_t min_time = std::numeric_limits<chrono_t>::max();
-	chrono_t max_time = std::numeric_limits<chrono_t>::min();
-
-	std::vector<AbcObjectReader *>::iterator iter;
-	for (iter = data->readers.begin(); iter != data->readers.end(); ++iter) {
-		AbcObjectReader *reader = *iter;
+	ImportPrefetchData prefetch_data;
+	prefetch_data.readers = tot_readers ? &data->readers[0] : NULL;
 
-		if (reader->valid()) {
-			reader->readObjectData(data->bmain, 0.0f);
-			reader->readObjectMatrix(0.0f);
+	for (int offset = 0; offset < tot_readers; offset += IMPORT_PREFETCH_BATCH_SIZE) {
+		const int count = std::min(IMPORT_PREFETCH_BATCH_SIZE, tot_readers - offset);
 
-			min_time = std::min(min_time, reader->minTime());
-			max_time = std::max(max_time, reader->maxTime());
-		}
+		prefetch_data.offset = offset;
+		BLI_task_parallel_range(0, count, &prefetch_data, import_prefetch_cb, count > 1);
 
-		*data->progress = 0.1f + 0.6f * (++i / size);
+		*data->progress = 0.1f + 0.8f * (static_cast<float>(offset + count) / tot_readers);
 		*data->do_update = true;
 
 		if (G.is_break) {
@@ -616,7 +643,22 @@ static void import_startjob(void *user_data, short *stop, short *do_update, floa
 		}
 	}
 
+	/* Set scene frame range. */
+
 	if (data->settings.set_frame_range) {
+		chrono_t min_time = std::numeric_limits<chrono_t>::max();
+		chrono_t max_time = std::numeric_limits<chrono_t>::min();
+
+		std::vector<AbcObjectReader *>::iterator iter;
+		for (iter = data->readers.begin(); iter != data->readers.end(); ++iter) {
+			AbcObjectReader *reader = *iter;
+
+			if (reader->valid()) {
+				min_time = std::min(min_time, reader->minTime());
+				max_time = std::max(max_time, reader->maxTime());
+			}
+		}
+
 		Scene *scene = data->scene;
 
 		if (data->settings.is_sequence) {
@@ -631,14 +673,36 @@ static void import_startjob(void *user_data, short *stop, short *do_update, floa
 		}
 	}
 
+	*data->do_update = true;
+	*data->progress = 0.9f;
+}
+
+/* Creates the objects from the prefetched samples. This adds to the main
+ * database, so it runs on the main thread, in a single pass. */
+static void import_create_objects(ImportJobData *data)
+{
+	std::vector<AbcObjectReader *>::iterator iter;
+
+	for (iter = data->readers.begin(); iter != data->readers.end(); ++iter) {
+		AbcObjectReader *reader = *iter;
+
+		if (reader->valid()) {
+			reader->readObjectData(data->bmain, 0.0f);
+			reader->readObjectMatrix(0.0f);
+		}
+	}
+
 	/* Setup parentship. */
 
-	i = 0;
 	for (iter = data->readers.begin(); iter != data->readers.end(); ++iter) {
 		const AbcObjectReader *reader = *iter;
 		const AbcObjectReader *parent_reader = NULL;
 		const IObject &iobject = reader->iobject();
 
+		if (reader->object() == NULL) {
+			continue;
+		}
+
 		IObject parent = iobject.getParent();
 
 		if (!IXform::matches(iobject.getHeader())) {
@@ -664,15 +728,27 @@ static void import_startjob(void *user_data, short *stop, short *do_update, floa
 				ob->parent = parent;
 			}
 		}
+	}
 
-		*data->progress = 0.7f + 0.3f * (++i / size);
-		*data->do_update = true;
+	/* Add object to scene. */
+	BKE_scene_base_deselect_all(data->scene);
 
-		if (G.is_break) {
-			data->was_cancelled = true;
-			return;
+	for (iter = data->readers.begin(); iter != data->readers.end(); ++iter) {
+		Object *ob = (*iter)->object();
+
+		if (ob == NULL) {
+			continue;
 		}
+
+		ob->lay = data->scene->lay;
+
+		BKE_scene_base_add(data->scene, ob);
+
+		DAG_id_tag_update_ex(data->bmain, &ob->id, OB_RECALC_OB | OB_RECALC_DATA | OB_RECALC_TIME);
 	}
+
+	/* One relations update for the whole import. */
+	DAG_relations_tag_update(data->bmain);
 }
 
 static void import_endjob(void *user_data)
@@ -681,33 +757,10 @@ static void import_endjob(void *user_data)
 
 	std::vector<AbcObjectReader *>::iterator iter;
 
-	/* Delete objects on cancelation. */
-	if (data->was_cancelled) {
-		for (iter = data->readers.begin(); iter != data->readers.end(); ++iter) {
-			Object *ob = (*iter)->object();
-
-			if (ob->data) {
-				BKE_libblock_free_us(data->bmain, ob->data);
-				ob->data = NULL;
-			}
-
-			BKE_libblock_free_us(data->bmain, ob);
-		}
-	}
-	else {
-		/* Add object to scene. */
-		BKE_scene_base_deselect_all(data->scene);
-
-		for (iter = data->readers.begin(); iter != data->readers.end(); ++iter) {
-			Object *ob = (*iter)->object();
-			ob->lay = data->scene->lay;
-
-			BKE_scene_base_add(data->scene, ob);
-
-			DAG_id_tag_update_ex(data->bmain, &ob->id, OB_RECALC_OB | OB_RECALC_DATA | OB_RECALC_TIME);
-		}
-
-		DAG_relations_tag_update(data->bmain);
+	/* Objects are only created once the job finished, so there is nothing to
+	 * delete on cancelation. */
+	if (!data->was_cancelled && data->error_code == ABC_NO_ERROR) {
+		import_create_objects(data);
 	}
 
 	for (iter = data->readers.begin(); iter != data->readers.end(); ++iter) {
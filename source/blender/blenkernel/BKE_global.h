@@ -130,6 +130,7 @@ enum {
 	G_DEBUG_DEPSGRAPH_NO_THREADS = (1 << 11),  /* single threaded depsgraph */
 	G_DEBUG_GPU =        (1 << 12), /* gpu debug */
 	G_DEBUG_IO = (1 << 13),   /* IO Debugging (for Collada, ...)*/
+	G_DEBUG_COMPOSITOR = (1 << 14), /* compositor time profiling */
 };
 
 #define G_DEBUG_ALL  (G_DEBUG | G_DEBUG_FFMPEG | G_DEBUG_PYTHON | G_DEBUG_EVENTS | G_DEBUG_WM | G_DEBUG_JOBS | \
@@ -53,6 +53,8 @@
 
 /* Add the blendfile name after blendcache_ */
 #define PTCACHE_EXT ".bphys"
+/* all frames in one file, see PTCACHE_DISK_SINGLE_FILE */
+#define PTCACHE_CONTAINER_EXT ".bpcache"
 #define PTCACHE_PATH "blendcache_"
 
 /* File open options, for BKE_ptcache_file_open */
@@ -112,6 +114,17 @@ typedef struct PTCacheData {
 typedef struct PTCacheFile {
 	FILE *fp;
 
+	/* frame in a single file container: read from memory instead of 'fp' (mem_len bytes),
+	 * 'map' is the memory mapping of the file or NULL when 'mem' was allocated */
+	const unsigned char *mem;
+	size_t mem_len, mem_pos;
+	void *map;
+	size_t map_len;
+
+	/* frame written to a single file container, added to its index on close */
+	struct PTCacheContainer *container;
+	size_t offset, size;
+
 	int frame, old_format;
 	unsigned int totpoint, type;
 	unsigned int data_types, flag;
@@ -333,6 +346,10 @@ void BKE_ptcache_mem_to_disk(struct PTCacheID *pid);
 /* Convert disk cache to memory cache and vice versa. Clears the cache that was converted. */
 void BKE_ptcache_toggle_disk_cache(struct PTCacheID *pid);
 
+/* Move the disk cache files into a single file container or back to a file per frame,
+ * after PTCACHE_DISK_SINGLE_FILE was toggled. */
+void BKE_ptcache_toggle_single_file(struct PTCacheID *pid);
+
 /* Rename all disk cache files with a new name. Doesn't touch the actual content of the files. */
 void BKE_ptcache_disk_cache_rename(struct PTCacheID *pid, const char *name_src, const char *name_dst);
 
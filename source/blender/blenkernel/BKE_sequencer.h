@@ -102,6 +102,7 @@ typedef struct SeqRenderData {
 	float motion_blur_shutter;
 	bool skip_cache;
 	bool is_proxy_render;
+	bool is_prefetch_render;
 	int view_id;
 
 	/* special case for OpenGL render */
@@ -190,7 +191,9 @@ struct ImBuf *BKE_sequencer_give_ibuf(const SeqRenderData *context, float cfra,
 struct ImBuf *BKE_sequencer_give_ibuf_threaded(const SeqRenderData *context, float cfra, int chanshown);
 struct ImBuf *BKE_sequencer_give_ibuf_direct(const SeqRenderData *context, float cfra, struct Sequence *seq);
 struct ImBuf *BKE_sequencer_give_ibuf_seqbase(const SeqRenderData *context, float cfra, int chan_shown, struct ListBase *seqbasep);
-void BKE_sequencer_give_ibuf_prefetch_request(const SeqRenderData *context, float cfra, int chan_shown);
+void BKE_sequencer_prefetch_stop(void);
+struct Sequence *BKE_sequencer_prefetch_original_get(struct Sequence *seq);
+void BKE_sequencer_prefetch_free(void);
 
 /* **********************************************************************
  * sequencer.c
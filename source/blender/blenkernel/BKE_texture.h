@@ -125,6 +125,7 @@ void              BKE_texture_voxeldata_free_data(struct VoxelData *vd);
 void              BKE_texture_voxeldata_free(struct VoxelData *vd);
 struct VoxelData *BKE_texture_voxeldata_add(void);
 struct VoxelData *BKE_texture_voxeldata_copy(struct VoxelData *vd);
+size_t            BKE_texture_voxeldata_memory(const struct VoxelData *vd);
 
 void             BKE_texture_ocean_free(struct OceanTex *ot);
 struct OceanTex *BKE_texture_ocean_add(void);
@@ -334,8 +334,7 @@ const char *BKE_undo_get_name_last(void)
 bool BKE_undo_save_file(const char *filename)
 {
 	UndoElem *uel;
-	MemFileChunk *chunk;
-	int file, oflags;
+	char err_msg[FILE_MAX + 256];
 
 	if ((U.uiflag & USER_GLOBALUNDO) == 0) {
 		return false;
@@ -347,41 +346,24 @@ bool BKE_undo_save_file(const char *filename)
 		return false;
 	}
 
-	/* note: This is currently used for autosave and 'quit.blend', where _not_ following symlinks is OK,
-	 * however if this is ever executed explicitly by the user, we may want to allow writing to symlinks.
-	 */
-
-	oflags = O_BINARY | O_WRONLY | O_CREAT | O_TRUNC;
-#ifdef O_NOFOLLOW
-	/* use O_NOFOLLOW to avoid writing to a symlink - use 'O_EXCL' (CVE-2008-1103) */
-	oflags |= O_NOFOLLOW;
-#else
-	/* TODO(sergey): How to deal with symlinks on windows? */
-#  ifndef _MSC_VER
-#    warning "Symbolic links will be followed on undo save, possibly causing CVE-2008-1103"
-#  endif
-#endif
-	file = BLI_open(filename,  oflags, 0666);
-
-	if (file == -1) {
-		fprintf(stderr, "Unable to save '%s': %s\n",
-		        filename, errno ? strerror(errno) : "Unknown error opening file");
+	if (!BLO_memfile_write_file(&uel->memfile, filename, false, NULL, NULL, err_msg, sizeof(err_msg))) {
+		fprintf(stderr, "Unable to save '%s': %s\n", filename, err_msg);
 		return false;
 	}
+	return true;
+}
 
-	for (chunk = uel->memfile.chunks.first; chunk; chunk = chunk->next) {
-		if (write(file, chunk->buf, chunk->size) != chunk->size) {
-			break;
-		}
-	}
-
-	close(file);
-
-	if (chunk) {
-		fprintf(stderr, "Unable to save '%s': %s\n",
-		        filename, errno ? strerror(errno) : "Unknown error writing file");
+/**
+ * Copy the current undo state into \a r_memfile (which the caller frees),
+ * the copy doesn't depend on the undo stack so it can be written from a thread.
+ */
+bool BKE_undo_copy_memfile(MemFile *r_memfile)
+{
+	if ((U.uiflag & USER_GLOBALUNDO) == 0 || curundo == NULL) {
 		return false;
 	}
+
+	BLO_memfile_copy(r_memfile, &curundo->memfile);
 	return true;
 }
 
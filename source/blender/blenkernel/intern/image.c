@@ -504,6 +504,7 @@ bool BKE_image_scale(Image *image, int width, int height)
 
 	if (ibuf) {
 		IMB_scaleImBuf(ibuf, width, height);
+		IMB_tag_changed(ibuf);
 		ibuf->userflags |= IB_BITMAPDIRTY;
 	}
 
@@ -3469,6 +3470,15 @@ static ImBuf *load_image_single(
 		flag = IB_rect | IB_multilayer | IB_metadata;
 		flag |= imbuf_alpha_flags_for_image(ima);
 
+		/* tiled and mipmapped files only load the tiles that are used, see
+		 * image_ibuf_ensure_full. Tiles aren't converted to scene linear. */
+		if (ima->source == IMA_SRC_FILE && !BKE_image_is_multiview(ima) && !(ima->flag & IMA_FIELDS) &&
+		    (ima->colorspace_settings.name[0] == '\0' ||
+		     STREQ(ima->colorspace_settings.name, IMB_colormanagement_role_colorspace_name_get(COLOR_ROLE_SCENE_LINEAR))))
+		{
+			flag |= IB_tilecache;
+		}
+
 		/* get the correct filepath */
 		BKE_image_user_frame_calc(iuser, cfra, 0);
 
@@ -3960,11 +3970,34 @@ BLI_INLINE bool image_quick_test(Image *ima, ImageUser *iuser)
 	return true;
 }
 
+/* Tile cached images only load the tiles the image editor draws, other
+ * users need all pixels, so the cached buffer is replaced by one with the
+ * full resolution pixels. */
+static ImBuf *image_ibuf_ensure_full(Image *ima, ImBuf *ibuf, int index)
+{
+	ImBuf *ibuf_full;
+
+	if (ibuf == NULL || ibuf->rect || ibuf->rect_float || !(ibuf->tiles || ibuf->tiles_float))
+		return ibuf;
+
+	ibuf_full = IMB_tiles_load_full(ibuf);
+	if (ibuf_full == NULL)
+		return ibuf;
+
+	ibuf_full->userflags |= IB_PERSISTENT;
+	image_assign_ibuf(ima, ibuf_full, index, 0);
+
+	/* the cache now references the full buffer, release the acquired tiled one */
+	IMB_freeImBuf(ibuf);
+
+	return ibuf_full;
+}
+
 /* Checks optional ImageUser and verifies/creates ImBuf.
  *
  * not thread-safe, so callee should worry about thread locks
  */
-static ImBuf *image_acquire_ibuf(Image *ima, ImageUser *iuser, void **r_lock)
+static ImBuf *image_acquire_ibuf_ex(Image *ima, ImageUser *iuser, void **r_lock, const bool use_tiles)
 {
 	ImBuf *ibuf = NULL;
 	int frame = 0, index = 0;
@@ -4048,11 +4081,20 @@ static ImBuf *image_acquire_ibuf(Image *ima, ImageUser *iuser, void **r_lock)
 		}
 	}
 
+	/* only float tiles can be drawn */
+	if (!use_tiles || (ibuf && !ibuf->tiles_float))
+		ibuf = image_ibuf_ensure_full(ima, ibuf, index);
+
 	BKE_image_tag_time(ima);
 
 	return ibuf;
 }
 
+static ImBuf *image_acquire_ibuf(Image *ima, ImageUser *iuser, void **r_lock)
+{
+	return image_acquire_ibuf_ex(ima, iuser, r_lock, false);
+}
+
 /* return image buffer for given image and user
  *
  * - will lock render result if image type is render result and lock is not NULL
@@ -4073,6 +4115,21 @@ ImBuf *BKE_image_acquire_ibuf(Image *ima, ImageUser *iuser, void **r_lock)
 	return ibuf;
 }
 
+/* same as BKE_image_acquire_ibuf, but images read from tiled files may only
+ * have their tiles loaded (ImBuf.tiles_float, without rect_float), for drawing */
+ImBuf *BKE_image_acquire_ibuf_tiled(Image *ima, ImageUser *iuser, void **r_lock)
+{
+	ImBuf *ibuf;
+
+	BLI_spin_lock(&image_spin);
+
+	ibuf = image_acquire_ibuf_ex(ima, iuser, r_lock, true);
+
+	BLI_spin_unlock(&image_spin);
+
+	return ibuf;
+}
+
 void BKE_image_release_ibuf(Image *ima, ImBuf *ibuf, void *lock)
 {
 	if (lock) {
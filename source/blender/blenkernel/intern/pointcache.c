@@ -45,10 +45,12 @@
 #include "DNA_rigidbody_types.h"
 #include "DNA_scene_types.h"
 #include "DNA_smoke_types.h"
+#include "DNA_userdef_types.h"
 
 #include "BLI_blenlib.h"
 #include "BLI_threads.h"
 #include "BLI_math.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #include "BLT_translation.h"
@@ -71,6 +73,8 @@
 
 #include "BIK_api.h"
 
+#include "atomic_ops.h"
+
 #ifdef WITH_BULLET
 #  include "RBI_api.h"
 #endif
@@ -107,6 +111,13 @@
 #  include "BLI_winstuff.h"
 #endif
 
+/* needed for memory mapping single file containers */
+#ifndef WIN32
+#  include <fcntl.h>
+#  include <unistd.h>
+#  include <sys/mman.h>
+#endif
+
 #define PTCACHE_DATA_FROM(data, type, from)  \
 	if (data[type]) { \
 		memcpy(data[type], from, ptcache_data_size[type]); \
@@ -141,6 +152,38 @@ static int ptcache_file_compressed_read(PTCacheFile *pf, unsigned char *result,
 static int ptcache_file_compressed_write(PTCacheFile *pf, unsigned char *in, unsigned int in_len, unsigned char *out, int mode);
 static int ptcache_file_write(PTCacheFile *pf, const void *f, unsigned int tot, unsigned int size);
 static int ptcache_file_read(PTCacheFile *pf, void *f, unsigned int tot, unsigned int size);
+static void ptcache_file_seek(PTCacheFile *pf, long offset, int whence);
+static const unsigned char *ptcache_file_read_mem(PTCacheFile *pf, size_t len);
+
+/* compressed data blocks, see "Compressed Blocks" below */
+typedef struct PTCacheCompressedBlock {
+	/* uncompressed data */
+	unsigned char *data;
+	unsigned int len;
+
+	/* as stored in the file */
+	unsigned char compressed;  /* 0: not compressed, 1: LZO, 2: LZMA */
+	unsigned char *in;
+	size_t in_len;
+	bool in_shared;  /* 'in' points into the frame in memory, isn't freed */
+	unsigned char props[16];  /* LZMA properties */
+	size_t props_len;
+} PTCacheCompressedBlock;
+
+#define PTCACHE_COMPRESSED_BATCH_MAX 32
+/* below this amount of data per batch threading isn't worth it */
+#define PTCACHE_COMPRESSED_BATCH_THREADED_MIN (256 * 1024)
+
+typedef struct PTCacheCompressedBatch {
+	PTCacheCompressedBlock blocks[PTCACHE_COMPRESSED_BATCH_MAX];
+	int tot;
+	size_t tot_len;
+	int mode;  /* compression mode, for writing */
+} PTCacheCompressedBatch;
+
+static void ptcache_file_compressed_read_batch(
+        PTCacheFile *pf, PTCacheCompressedBatch *batch, unsigned char *result, unsigned int len);
+static void ptcache_compressed_batch_decode(PTCacheCompressedBatch *batch);
 
 /* Common functions */
 static int ptcache_basic_header_read(PTCacheFile *pf)
@@ -148,10 +191,10 @@ static int ptcache_basic_header_read(PTCacheFile *pf)
 	int error=0;
 
 	/* Custom functions should read these basic elements too! */
-	if (!error && !fread(&pf->totpoint, sizeof(unsigned int), 1, pf->fp))
+	if (!error && !ptcache_file_read(pf, &pf->totpoint, 1, sizeof(unsigned int)))
 		error = 1;
 	
-	if (!error && !fread(&pf->data_types, sizeof(unsigned int), 1, pf->fp))
+	if (!error && !ptcache_file_read(pf, &pf->data_types, 1, sizeof(unsigned int)))
 		error = 1;
 
 	return !error;
@@ -159,10 +202,10 @@ static int ptcache_basic_header_read(PTCacheFile *pf)
 static int ptcache_basic_header_write(PTCacheFile *pf)
 {
 	/* Custom functions should write these basic elements too! */
-	if (!fwrite(&pf->totpoint, sizeof(unsigned int), 1, pf->fp))
+	if (!ptcache_file_write(pf, &pf->totpoint, 1, sizeof(unsigned int)))
 		return 0;
 	
-	if (!fwrite(&pf->data_types, sizeof(unsigned int), 1, pf->fp))
+	if (!ptcache_file_write(pf, &pf->data_types, 1, sizeof(unsigned int)))
 		return 0;
 
 	return 1;
@@ -777,7 +820,7 @@ static int ptcache_smoke_read(PTCacheFile *pf, void *smoke_v)
 	if (!STREQLEN(version, SMOKE_CACHE_VERSION, 4))
 	{
 		/* reset file pointer */
-		fseek(pf->fp, -4, SEEK_CUR);
+		ptcache_file_seek(pf, -4, SEEK_CUR);
 		return ptcache_smoke_read_old(pf, smoke_v);
 	}
 
@@ -818,29 +861,31 @@ static int ptcache_smoke_read(PTCacheFile *pf, void *smoke_v)
 		float dt, dx, *dens, *react, *fuel, *flame, *heat, *heatold, *vx, *vy, *vz, *r, *g, *b;
 		unsigned char *obstacles;
 		unsigned int out_len = (unsigned int)res * sizeof(float);
+		PTCacheCompressedBatch batch = {{{NULL}}};
 		
 		smoke_export(sds->fluid, &dt, &dx, &dens, &react, &flame, &fuel, &heat, &heatold, &vx, &vy, &vz, &r, &g, &b, &obstacles);
 
-		ptcache_file_compressed_read(pf, (unsigned char *)sds->shadow, out_len);
-		ptcache_file_compressed_read(pf, (unsigned char *)dens, out_len);
+		ptcache_file_compressed_read_batch(pf, &batch, (unsigned char *)sds->shadow, out_len);
+		ptcache_file_compressed_read_batch(pf, &batch, (unsigned char *)dens, out_len);
 		if (cache_fields & SM_ACTIVE_HEAT) {
-			ptcache_file_compressed_read(pf, (unsigned char *)heat, out_len);
-			ptcache_file_compressed_read(pf, (unsigned char *)heatold, out_len);
+			ptcache_file_compressed_read_batch(pf, &batch, (unsigned char *)heat, out_len);
+			ptcache_file_compressed_read_batch(pf, &batch, (unsigned char *)heatold, out_len);
 		}
 		if (cache_fields & SM_ACTIVE_FIRE) {
-			ptcache_file_compressed_read(pf, (unsigned char *)flame, out_len);
-			ptcache_file_compressed_read(pf, (unsigned char *)fuel, out_len);
-			ptcache_file_compressed_read(pf, (unsigned char *)react, out_len);
+			ptcache_file_compressed_read_batch(pf, &batch, (unsigned char *)flame, out_len);
+			ptcache_file_compressed_read_batch(pf, &batch, (unsigned char *)fuel, out_len);
+			ptcache_file_compressed_read_batch(pf, &batch, (unsigned char *)react, out_len);
 		}
 		if (cache_fields & SM_ACTIVE_COLORS) {
-			ptcache_file_compressed_read(pf, (unsigned char *)r, out_len);
-			ptcache_file_compressed_read(pf, (unsigned char *)g, out_len);
-			ptcache_file_compressed_read(pf, (unsigned char *)b, out_len);
-		}
-		ptcache_file_compressed_read(pf, (unsigned char *)vx, out_len);
-		ptcache_file_compressed_read(pf, (unsigned char *)vy, out_len);
-		ptcache_file_compressed_read(pf, (unsigned char *)vz, out_len);
-		ptcache_file_compressed_read(pf, (unsigned char *)obstacles, (unsigned int)res);
+			ptcache_file_compressed_read_batch(pf, &batch, (unsigned char *)r, out_len);
+			ptcache_file_compressed_read_batch(pf, &batch, (unsigned char *)g, out_len);
+			ptcache_file_compressed_read_batch(pf, &batch, (unsigned char *)b, out_len);
+		}
+		ptcache_file_compressed_read_batch(pf, &batch, (unsigned char *)vx, out_len);
+		ptcache_file_compressed_read_batch(pf, &batch, (unsigned char *)vy, out_len);
+		ptcache_file_compressed_read_batch(pf, &batch, (unsigned char *)vz, out_len);
+		ptcache_file_compressed_read_batch(pf, &batch, (unsigned char *)obstacles, (unsigned int)res);
+		ptcache_compressed_batch_decode(&batch);
 		ptcache_file_read(pf, &dt, 1, sizeof(float));
 		ptcache_file_read(pf, &dx, 1, sizeof(float));
 		ptcache_file_read(pf, &sds->p0, 3, sizeof(float));
@@ -861,6 +906,7 @@ static int ptcache_smoke_read(PTCacheFile *pf, void *smoke_v)
 			float *dens, *react, *fuel, *flame, *tcu, *tcv, *tcw, *r, *g, *b;
 			unsigned int out_len = sizeof(float)*(unsigned int)res;
 			unsigned int out_len_big;
+			PTCacheCompressedBatch batch = {{{NULL}}};
 
 			smoke_turbulence_get_res(sds->wt, res_big_array);
 			res_big = res_big_array[0]*res_big_array[1]*res_big_array[2];
@@ -868,21 +914,22 @@ static int ptcache_smoke_read(PTCacheFile *pf, void *smoke_v)
 
 			smoke_turbulence_export(sds->wt, &dens, &react, &flame, &fuel, &r, &g, &b, &tcu, &tcv, &tcw);
 
-			ptcache_file_compressed_read(pf, (unsigned char *)dens, out_len_big);
+			ptcache_file_compressed_read_batch(pf, &batch, (unsigned char *)dens, out_len_big);
 			if (cache_fields & SM_ACTIVE_FIRE) {
-				ptcache_file_compressed_read(pf, (unsigned char *)flame, out_len_big);
-				ptcache_file_compressed_read(pf, (unsigned char *)fuel, out_len_big);
-				ptcache_file_compressed_read(pf, (unsigned char *)react, out_len_big);
+				ptcache_file_compressed_read_batch(pf, &batch, (unsigned char *)flame, out_len_big);
+				ptcache_file_compressed_read_batch(pf, &batch, (unsigned char *)fuel, out_len_big);
+				ptcache_file_compressed_read_batch(pf, &batch, (unsigned char *)react, out_len_big);
 			}
 			if (cache_fields & SM_ACTIVE_COLORS) {
-				ptcache_file_compressed_read(pf, (unsigned char *)r, out_len_big);
-				ptcache_file_compressed_read(pf, (unsigned char *)g, out_len_big);
-				ptcache_file_compressed_read(pf, (unsigned char *)b, out_len_big);
+				ptcache_file_compressed_read_batch(pf, &batch, (unsigned char *)r, out_len_big);
+				ptcache_file_compressed_read_batch(pf, &batch, (unsigned char *)g, out_len_big);
+				ptcache_file_compressed_read_batch(pf, &batch, (unsigned char *)b, out_len_big);
 			}
 
-			ptcache_file_compressed_read(pf, (unsigned char *)tcu, out_len);
-			ptcache_file_compressed_read(pf, (unsigned char *)tcv, out_len);
-			ptcache_file_compressed_read(pf, (unsigned char *)tcw, out_len);
+			ptcache_file_compressed_read_batch(pf, &batch, (unsigned char *)tcu, out_len);
+			ptcache_file_compressed_read_batch(pf, &batch, (unsigned char *)tcv, out_len);
+			ptcache_file_compressed_read_batch(pf, &batch, (unsigned char *)tcw, out_len);
+			ptcache_compressed_batch_decode(&batch);
 		}
 
 	return 1;
@@ -1866,6 +1913,432 @@ static int ptcache_filename(PTCacheID *pid, char *filename, int cfra, short do_p
 	return len; /* make sure the above string is always 16 chars */
 }
 
+/* -------------------------------------------------------------------- */
+/* Single File Container
+ *
+ * With #PTCACHE_DISK_SINGLE_FILE all frames of a disk cache are stored in one file,
+ * "NAME_SS.bpcache" next to where the frame files would be, followed by an index of the frames:
+ *
+ *   PTCacheContainerHeader
+ *   frame data, every frame stored exactly as its own .bphys file
+ *   PTCacheContainerFrame[totframe], at 'index_offset' and sorted by frame
+ *
+ * A new frame is written where the index was, the index after it and the header is updated last.
+ * Cleared frames are only removed from the index, space at the end of the frame data is reused by
+ * the next frame (clearing the frames after the current one is the common case).
+ *
+ * Frames are read from a memory mapping of their part of the file, compressed blocks are
+ * decompressed straight from the mapping. Windows reads the frame into memory instead.
+ * External caches and OpenVDB caches always use a file per frame. */
+
+#define PTCACHE_CONTAINER_ID "BPHYSCNT"
+#define PTCACHE_CONTAINER_VERSION 1
+
+/* frame files are copied in parts of this size when converting to or from a container */
+#define PTCACHE_FILE_COPY_BUFFER (1024 * 1024)
+
+typedef struct PTCacheContainerHeader {
+	char id[8];
+	unsigned int version;
+	unsigned int totframe;  /* frames in the index */
+	uint64_t index_offset;
+} PTCacheContainerHeader;
+
+typedef struct PTCacheContainerFrame {
+	int frame;
+	unsigned int pad;
+	uint64_t offset, size;  /* frame data in the file */
+} PTCacheContainerFrame;
+
+/* runtime frame index, #PointCache.container */
+typedef struct PTCacheContainer {
+	char filename[MAX_PTCACHE_FILE];
+	/* file the index was read from, -1 when it doesn't exist, to notice changes by other instances */
+	int64_t file_size, file_mtime;
+
+	PTCacheContainerFrame *frames;
+	int totframe, maxframe;
+} PTCacheContainer;
+
+static bool ptcache_use_container(PTCacheID *pid)
+{
+	return ((pid->cache->flag & PTCACHE_DISK_SINGLE_FILE) &&
+	        (pid->cache->flag & PTCACHE_EXTERNAL) == 0 &&
+	        pid->file_type == PTCACHE_FILE_PTCACHE);
+}
+
+static bool ptcache_container_filename(PTCacheID *pid, char *filename)
+{
+	const int len = ptcache_filename(pid, filename, 0, 1, 0);
+
+	if (len == 0)
+		return false;
+
+	if (pid->cache->index < 0)
+		pid->cache->index = pid->stack_index = BKE_object_insert_ptcache(pid->ob);
+
+	BLI_snprintf(filename + len, MAX_PTCACHE_FILE - len, "_%02u%s", pid->stack_index, PTCACHE_CONTAINER_EXT);
+
+	return true;
+}
+
+static void ptcache_container_free(PointCache *cache)
+{
+	PTCacheContainer *container = cache->container;
+
+	if (container) {
+		if (container->frames)
+			MEM_freeN(container->frames);
+		MEM_freeN(container);
+		cache->container = NULL;
+	}
+}
+
+static void ptcache_container_file_state(PTCacheContainer *container)
+{
+	BLI_stat_t st;
+
+	if (BLI_stat(container->filename, &st) == 0) {
+		container->file_size = (int64_t)st.st_size;
+		container->file_mtime = (int64_t)st.st_mtime;
+	}
+	else {
+		container->file_size = container->file_mtime = -1;
+	}
+}
+
+static void ptcache_container_reserve(PTCacheContainer *container, int totframe)
+{
+	if (totframe > container->maxframe) {
+		container->maxframe = max_iii(totframe, container->maxframe * 2, 64);
+		container->frames = MEM_reallocN(container->frames, sizeof(PTCacheContainerFrame) * container->maxframe);
+	}
+}
+
+static void ptcache_container_index_read(PTCacheContainer *container)
+{
+	PTCacheContainerHeader header;
+	FILE *fp = BLI_fopen(container->filename, "rb");
+
+	container->totframe = 0;
+
+	if (fp == NULL)
+		return;
+
+	if (fread(&header, sizeof(header), 1, fp) == 1 &&
+	    STREQLEN(header.id, PTCACHE_CONTAINER_ID, 8) &&
+	    header.version == PTCACHE_CONTAINER_VERSION &&
+	    header.totframe <= 2 * MAXFRAME + 1 &&
+	    BLI_fseek(fp, (int64_t)header.index_offset, SEEK_SET) == 0)
+	{
+		ptcache_container_reserve(container, (int)header.totframe);
+
+		if (fread(container->frames, sizeof(PTCacheContainerFrame), header.totframe, fp) == header.totframe)
+			container->totframe = (int)header.totframe;
+	}
+
+	fclose(fp);
+
+	if (container->totframe == 0 && G.debug & G_DEBUG)
+		printf("Point cache container %s has no valid frame index\n", container->filename);
+}
+
+/* end of the frame data, where the next frame and the index are written */
+static uint64_t ptcache_container_data_end(const PTCacheContainer *container)
+{
+	uint64_t end = sizeof(PTCacheContainerHeader);
+	int i;
+
+	for (i = 0; i < container->totframe; i++)
+		end = MAX2(end, container->frames[i].offset + container->frames[i].size);
+
+	return end;
+}
+
+/* write the index after the frame data and update the header */
+static bool ptcache_container_index_write(PTCacheContainer *container, FILE *fp)
+{
+	PTCacheContainerHeader header;
+
+	memcpy(header.id, PTCACHE_CONTAINER_ID, sizeof(header.id));
+	header.version = PTCACHE_CONTAINER_VERSION;
+	header.totframe = (unsigned int)container->totframe;
+	header.index_offset = ptcache_container_data_end(container);
+
+	/* the index has to be complete before the header points to it */
+	return (BLI_fseek(fp, (int64_t)header.index_offset, SEEK_SET) == 0 &&
+	        fwrite(container->frames, sizeof(PTCacheContainerFrame), header.totframe, fp) == header.totframe &&
+	        fflush(fp) == 0 &&
+	        BLI_fseek(fp, 0, SEEK_SET) == 0 &&
+	        fwrite(&header, sizeof(header), 1, fp) == 1);
+}
+
+/* index of 'frame' in the sorted frames, or where it would be inserted */
+static int ptcache_container_frame_index(const PTCacheContainer *container, int frame)
+{
+	int low = 0, high = container->totframe;
+
+	while (low < high) {
+		const int mid = (low + high) / 2;
+
+		if (container->frames[mid].frame < frame)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+	return low;
+}
+
+static PTCacheContainerFrame *ptcache_container_frame_find(PTCacheContainer *container, int frame)
+{
+	const int i = ptcache_container_frame_index(container, frame);
+
+	if (i < container->totframe && container->frames[i].frame == frame)
+		return &container->frames[i];
+
+	return NULL;
+}
+
+static void ptcache_container_frame_add(PTCacheContainer *container, int frame, uint64_t offset, uint64_t size)
+{
+	const int i = ptcache_container_frame_index(container, frame);
+	PTCacheContainerFrame *entry;
+
+	if (i == container->totframe || container->frames[i].frame != frame) {
+		ptcache_container_reserve(container, container->totframe + 1);
+		memmove(&container->frames[i + 1], &container->frames[i],
+		        sizeof(PTCacheContainerFrame) * (container->totframe - i));
+		container->totframe++;
+	}
+
+	entry = &container->frames[i];
+	entry->frame = frame;
+	entry->pad = 0;
+	entry->offset = offset;
+	entry->size = size;
+}
+
+/* the index of the container of the cache, read again when the file was changed */
+static PTCacheContainer *ptcache_container_get(PTCacheID *pid)
+{
+	PointCache *cache = pid->cache;
+	PTCacheContainer *container = cache->container;
+	char filename[MAX_PTCACHE_FILE];
+	int64_t file_size, file_mtime;
+
+	if (!ptcache_container_filename(pid, filename))
+		return NULL;
+
+	if (container && !STREQ(container->filename, filename)) {
+		ptcache_container_free(cache);
+		container = NULL;
+	}
+
+	if (container == NULL) {
+		container = cache->container = MEM_callocN(sizeof(PTCacheContainer), "PTCacheContainer");
+		BLI_strncpy(container->filename, filename, sizeof(container->filename));
+		container->file_size = container->file_mtime = -1;
+	}
+
+	file_size = container->file_size;
+	file_mtime = container->file_mtime;
+	ptcache_container_file_state(container);
+
+	if (container->file_size != file_size || container->file_mtime != file_mtime) {
+		if (container->file_size == -1)
+			container->totframe = 0;
+		else
+			ptcache_container_index_read(container);
+	}
+
+	return container;
+}
+
+/* the frame in the container of the cache, or NULL */
+static PTCacheContainerFrame *ptcache_container_frame_get(PTCacheID *pid, int cfra, PTCacheContainer **r_container)
+{
+	PTCacheContainer *container = ptcache_container_get(pid);
+
+	*r_container = container;
+
+	return container ? ptcache_container_frame_find(container, cfra) : NULL;
+}
+
+/* same as #BKE_ptcache_id_clear deleting frame files */
+static void ptcache_container_clear(PTCacheID *pid, int mode, int cfra)
+{
+	PointCache *cache = pid->cache;
+	PTCacheContainer *container = ptcache_container_get(pid);
+	int i, totframe = 0;
+	FILE *fp;
+
+	if (container == NULL || container->file_size == -1)
+		return;
+
+	if (mode == PTCACHE_CLEAR_ALL) {
+		cache->last_exact = MIN2(cache->startframe, 0);
+		totframe = 0;
+	}
+	else {
+		for (i = 0; i < container->totframe; i++) {
+			const int frame = container->frames[i].frame;
+
+			if ((mode == PTCACHE_CLEAR_FRAME && frame == cfra) ||
+			    (mode == PTCACHE_CLEAR_BEFORE && frame < cfra) ||
+			    (mode == PTCACHE_CLEAR_AFTER && frame > cfra))
+			{
+				if (cache->cached_frames && frame >= cache->startframe && frame <= cache->endframe)
+					cache->cached_frames[frame - cache->startframe] = 0;
+			}
+			else {
+				container->frames[totframe++] = container->frames[i];
+			}
+		}
+
+		if (totframe == container->totframe)
+			return;
+	}
+
+	container->totframe = totframe;
+
+	if (totframe == 0) {
+		BLI_delete(container->filename, false, false);
+	}
+	else if ((fp = BLI_fopen(container->filename, "rb+"))) {
+		if (!ptcache_container_index_write(container, fp) && G.debug & G_DEBUG)
+			printf("Error writing point cache container index\n");
+		fclose(fp);
+	}
+
+	ptcache_container_file_state(container);
+}
+
+static PTCacheFile *ptcache_file_new(FILE *fp, int cfra)
+{
+	PTCacheFile *pf = MEM_callocN(sizeof(PTCacheFile), "PTCacheFile");
+
+	pf->fp = fp;
+	pf->old_format = 0;
+	pf->frame = cfra;
+
+	return pf;
+}
+
+/* opens a frame of a container for reading, doesn't access the index so it can run in a thread */
+static PTCacheFile *ptcache_container_frame_open(const char *filename, int cfra, uint64_t offset, uint64_t size)
+{
+	PTCacheFile *pf;
+	unsigned char *mem;
+	FILE *fp;
+
+#ifndef WIN32
+	int file = BLI_open(filename, O_BINARY | O_RDONLY, 0);
+	const uint64_t page_size = (uint64_t)sysconf(_SC_PAGESIZE);
+	const uint64_t map_offset = offset - offset % page_size;
+	const size_t map_len = (size_t)(offset + size - map_offset);
+	void *map = MAP_FAILED;
+
+	if (file == -1)
+		return NULL;
+
+	/* the file may have been truncated by another instance, accessing the mapping would crash */
+	if ((uint64_t)BLI_file_descriptor_size(file) >= offset + size)
+		map = mmap(NULL, map_len, PROT_READ, MAP_SHARED, file, (off_t)map_offset);
+
+	close(file);
+
+	if (map != MAP_FAILED) {
+		pf = ptcache_file_new(NULL, cfra);
+		pf->map = map;
+		pf->map_len = map_len;
+		pf->mem = (const unsigned char *)map + (offset - map_offset);
+		pf->mem_len = (size_t)size;
+
+		return pf;
+	}
+#endif
+
+	/* read the frame when it can't be mapped, mappings of large files are limited on Windows */
+	fp = BLI_fopen(filename, "rb");
+
+	if (fp == NULL)
+		return NULL;
+
+	mem = MEM_mallocN((size_t)size, "pointcache_container_frame");
+
+	if (BLI_fseek(fp, (int64_t)offset, SEEK_SET) != 0 || fread(mem, 1, (size_t)size, fp) != size) {
+		MEM_freeN(mem);
+		fclose(fp);
+		return NULL;
+	}
+
+	fclose(fp);
+
+	pf = ptcache_file_new(NULL, cfra);
+	pf->mem = mem;
+	pf->mem_len = (size_t)size;
+
+	return pf;
+}
+
+static PTCacheFile *ptcache_container_file_open(PTCacheID *pid, int mode, int cfra)
+{
+	PTCacheContainer *container;
+	PTCacheContainerFrame *entry = ptcache_container_frame_get(pid, cfra, &container);
+	PTCacheFile *pf;
+	FILE *fp;
+	uint64_t offset;
+
+	if (mode == PTCACHE_FILE_READ) {
+		if (entry == NULL)
+			return NULL;
+
+		return ptcache_container_frame_open(container->filename, cfra, entry->offset, entry->size);
+	}
+	else if (mode != PTCACHE_FILE_WRITE || container == NULL) {
+		return NULL;
+	}
+
+	/* the frame is written after the frame data, where the index is */
+	BLI_make_existing_file(container->filename);
+	fp = BLI_fopen(container->filename, (container->file_size == -1) ? "wb" : "rb+");
+
+	if (fp == NULL)
+		return NULL;
+
+	offset = ptcache_container_data_end(container);
+
+	if (BLI_fseek(fp, (int64_t)offset, SEEK_SET) != 0) {
+		fclose(fp);
+		return NULL;
+	}
+
+	pf = ptcache_file_new(fp, cfra);
+	pf->container = container;
+	pf->offset = (size_t)offset;
+
+	return pf;
+}
+
+/* adds the written frame to the index, an incomplete frame is left out */
+static void ptcache_container_file_close(PTCacheFile *pf)
+{
+	PTCacheContainer *container = pf->container;
+
+	if (ferror(pf->fp) == 0)
+		ptcache_container_frame_add(container, pf->frame, pf->offset, pf->size);
+
+	/* the frame data replaced the index, it's always written again */
+	clearerr(pf->fp);
+	if (!ptcache_container_index_write(container, pf->fp) && G.debug & G_DEBUG)
+		printf("Error writing point cache container index\n");
+
+	fclose(pf->fp);
+
+	ptcache_container_file_state(container);
+}
+
 /* youll need to close yourself after! */
 static PTCacheFile *ptcache_file_open(PTCacheID *pid, int mode, int cfra)
 {
@@ -1879,6 +2352,9 @@ static PTCacheFile *ptcache_file_open(PTCacheID *pid, int mode, int cfra)
 		return NULL;
 #endif
 	if (!G.relbase_valid && (pid->cache->flag & PTCACHE_EXTERNAL)==0) return NULL; /* save blend file before using disk pointcache */
+
+	if (ptcache_use_container(pid))
+		return ptcache_container_file_open(pid, mode, cfra);
 	
 	ptcache_filename(pid, filename, cfra, 1, 1);
 
@@ -1897,141 +2373,323 @@ static PTCacheFile *ptcache_file_open(PTCacheID *pid, int mode, int cfra)
 	if (!fp)
 		return NULL;
 
-	pf= MEM_mallocN(sizeof(PTCacheFile), "PTCacheFile");
-	pf->fp= fp;
-	pf->old_format = 0;
-	pf->frame = cfra;
+	pf = ptcache_file_new(fp, cfra);
 
 	return pf;
 }
 static void ptcache_file_close(PTCacheFile *pf)
 {
 	if (pf) {
-		fclose(pf->fp);
+		if (pf->container)
+			ptcache_container_file_close(pf);
+		else if (pf->fp)
+			fclose(pf->fp);
+
+#ifndef WIN32
+		if (pf->map)
+			munmap(pf->map, pf->map_len);
+		else
+#endif
+		if (pf->mem)
+			MEM_freeN((void *)pf->mem);
+
 		MEM_freeN(pf);
 	}
 }
 
-static int ptcache_file_compressed_read(PTCacheFile *pf, unsigned char *result, unsigned int len)
-{
-	int r = 0;
-	unsigned char compressed = 0;
-	size_t in_len;
-#ifdef WITH_LZO
-	size_t out_len = len;
-#endif
-	unsigned char *in;
-	unsigned char *props = MEM_callocN(16 * sizeof(char), "tmp");
+/* -------------------------------------------------------------------- */
+/* Compressed Blocks
+ *
+ * Compressed data is stored as blocks one after the other, a batch reads all blocks of a frame first
+ * (or compresses them before writing), so (de)compression of large frames runs in parallel.
+ * Blocks of frames read from a single file container are decompressed from its memory mapping. */
 
-	ptcache_file_read(pf, &compressed, 1, sizeof(unsigned char));
-	if (compressed) {
+static void ptcache_file_compressed_block_read(PTCacheFile *pf, PTCacheCompressedBlock *block)
+{
+	block->compressed = 0;
+	block->in = NULL;
+	block->in_len = 0;
+	block->in_shared = false;
+	block->props_len = 0;
+
+	ptcache_file_read(pf, &block->compressed, 1, sizeof(unsigned char));
+	if (block->compressed) {
 		unsigned int size;
 		ptcache_file_read(pf, &size, 1, sizeof(unsigned int));
-		in_len = (size_t)size;
-		if (in_len==0) {
+		block->in_len = (size_t)size;
+		if (block->in_len == 0) {
 			/* do nothing */
 		}
 		else {
-			in = (unsigned char *)MEM_callocN(sizeof(unsigned char)*in_len, "pointcache_compressed_buffer");
-			ptcache_file_read(pf, in, in_len, sizeof(unsigned char));
-#ifdef WITH_LZO
-			if (compressed == 1)
-				r = lzo1x_decompress_safe(in, (lzo_uint)in_len, result, (lzo_uint *)&out_len, NULL);
-#endif
+			if (pf->mem) {
+				/* decompress straight from the frame in memory, the decompressors don't write to it */
+				block->in = (unsigned char *)ptcache_file_read_mem(pf, block->in_len);
+				block->in_shared = true;
+			}
+			else {
+				block->in = (unsigned char *)MEM_callocN(sizeof(unsigned char) * block->in_len, "pointcache_compressed_buffer");
+				ptcache_file_read(pf, block->in, block->in_len, sizeof(unsigned char));
+			}
 #ifdef WITH_LZMA
-			if (compressed == 2) {
-				size_t sizeOfIt;
-				size_t leni = in_len, leno = len;
+			if (block->compressed == 2) {
 				ptcache_file_read(pf, &size, 1, sizeof(unsigned int));
-				sizeOfIt = (size_t)size;
-				ptcache_file_read(pf, props, sizeOfIt, sizeof(unsigned char));
-				r = LzmaUncompress(result, &leno, in, &leni, props, sizeOfIt);
+				block->props_len = MIN2((size_t)size, sizeof(block->props));
+				ptcache_file_read(pf, block->props, block->props_len, sizeof(unsigned char));
 			}
 #endif
-			MEM_freeN(in);
 		}
 	}
 	else {
-		ptcache_file_read(pf, result, len, sizeof(unsigned char));
+		ptcache_file_read(pf, block->data, block->len, sizeof(unsigned char));
 	}
+}
+
+/* thread safe, frees the compressed data */
+static int ptcache_compressed_block_decode(PTCacheCompressedBlock *block)
+{
+	int r = 0;
 
-	MEM_freeN(props);
+	if (block->in) {
+#ifdef WITH_LZO
+		if (block->compressed == 1) {
+			size_t out_len = block->len;
+			r = lzo1x_decompress_safe(block->in, (lzo_uint)block->in_len, block->data, (lzo_uint *)&out_len, NULL);
+		}
+#endif
+#ifdef WITH_LZMA
+		if (block->compressed == 2) {
+			size_t leni = block->in_len, leno = block->len;
+			r = LzmaUncompress(block->data, &leno, block->in, &leni, block->props, block->props_len);
+		}
+#endif
+		if (!block->in_shared)
+			MEM_freeN(block->in);
+		block->in = NULL;
+	}
 
 	return r;
 }
-static int ptcache_file_compressed_write(PTCacheFile *pf, unsigned char *in, unsigned int in_len, unsigned char *out, int mode)
+
+/* thread safe, compresses into 'block->in' which must hold LZO_OUT_LEN(block->len) bytes */
+static int ptcache_compressed_block_encode(PTCacheCompressedBlock *block, int mode)
 {
 	int r = 0;
-	unsigned char compressed = 0;
-	size_t out_len= 0;
-	unsigned char *props = MEM_callocN(16 * sizeof(char), "tmp");
+	size_t out_len = 0;
 	size_t sizeOfIt = 5;
 
 	(void)mode; /* unused when building w/o compression */
+	(void)sizeOfIt;
+
+	block->compressed = 0;
+	block->props_len = 0;
 
 #ifdef WITH_LZO
-	out_len= LZO_OUT_LEN(in_len);
+	out_len = LZO_OUT_LEN(block->len);
 	if (mode == 1) {
 		LZO_HEAP_ALLOC(wrkmem, LZO1X_MEM_COMPRESS);
 		
-		r = lzo1x_1_compress(in, (lzo_uint)in_len, out, (lzo_uint *)&out_len, wrkmem);
-		if (!(r == LZO_E_OK) || (out_len >= in_len))
-			compressed = 0;
+		r = lzo1x_1_compress(block->data, (lzo_uint)block->len, block->in, (lzo_uint *)&out_len, wrkmem);
+		if (!(r == LZO_E_OK) || (out_len >= block->len))
+			block->compressed = 0;
 		else
-			compressed = 1;
+			block->compressed = 1;
 	}
 #endif
 #ifdef WITH_LZMA
 	if (mode == 2) {
 		
-		r = LzmaCompress(out, &out_len, in, in_len, //assume sizeof(char)==1....
-		                 props, &sizeOfIt, 5, 1 << 24, 3, 0, 2, 32, 2);
+		r = LzmaCompress(block->in, &out_len, block->data, block->len, //assume sizeof(char)==1....
+		                 block->props, &sizeOfIt, 5, 1 << 24, 3, 0, 2, 32, 2);
 
-		if (!(r == SZ_OK) || (out_len >= in_len))
-			compressed = 0;
+		if (!(r == SZ_OK) || (out_len >= block->len))
+			block->compressed = 0;
 		else
-			compressed = 2;
+			block->compressed = 2;
+		block->props_len = sizeOfIt;
 	}
 #endif
-	
-	ptcache_file_write(pf, &compressed, 1, sizeof(unsigned char));
-	if (compressed) {
-		unsigned int size = out_len;
+
+	block->in_len = out_len;
+
+	return r;
+}
+
+static void ptcache_file_compressed_block_write(PTCacheFile *pf, const PTCacheCompressedBlock *block)
+{
+	ptcache_file_write(pf, &block->compressed, 1, sizeof(unsigned char));
+	if (block->compressed) {
+		unsigned int size = block->in_len;
 		ptcache_file_write(pf, &size, 1, sizeof(unsigned int));
-		ptcache_file_write(pf, out, out_len, sizeof(unsigned char));
+		ptcache_file_write(pf, block->in, block->in_len, sizeof(unsigned char));
 	}
 	else
-		ptcache_file_write(pf, in, in_len, sizeof(unsigned char));
+		ptcache_file_write(pf, block->data, block->len, sizeof(unsigned char));
 
-	if (compressed == 2) {
-		unsigned int size = sizeOfIt;
-		ptcache_file_write(pf, &sizeOfIt, 1, sizeof(unsigned int));
-		ptcache_file_write(pf, props, size, sizeof(unsigned char));
+	if (block->compressed == 2) {
+		unsigned int size = block->props_len;
+		ptcache_file_write(pf, &size, 1, sizeof(unsigned int));
+		ptcache_file_write(pf, block->props, size, sizeof(unsigned char));
 	}
+}
+
+static int ptcache_file_compressed_read(PTCacheFile *pf, unsigned char *result, unsigned int len)
+{
+	PTCacheCompressedBlock block;
+
+	block.data = result;
+	block.len = len;
+
+	ptcache_file_compressed_block_read(pf, &block);
+	return ptcache_compressed_block_decode(&block);
+}
+static int ptcache_file_compressed_write(PTCacheFile *pf, unsigned char *in, unsigned int in_len, unsigned char *out, int mode)
+{
+	PTCacheCompressedBlock block;
+	int r;
 
-	MEM_freeN(props);
+	block.data = in;
+	block.len = in_len;
+	block.in = out;
+
+	r = ptcache_compressed_block_encode(&block, mode);
+	ptcache_file_compressed_block_write(pf, &block);
 
 	return r;
 }
-static int ptcache_file_read(PTCacheFile *pf, void *f, unsigned int tot, unsigned int size)
+
+static void ptcache_compressed_batch_decode_cb(void *userdata, const int iter)
 {
-	return (fread(f, size, tot, pf->fp) == tot);
+	PTCacheCompressedBatch *batch = userdata;
+	ptcache_compressed_block_decode(&batch->blocks[iter]);
 }
-static int ptcache_file_write(PTCacheFile *pf, const void *f, unsigned int tot, unsigned int size)
+
+/* decompress all blocks read with #ptcache_file_compressed_read_batch */
+static void ptcache_compressed_batch_decode(PTCacheCompressedBatch *batch)
 {
-	return (fwrite(f, size, tot, pf->fp) == tot);
+	BLI_task_parallel_range(
+	        0, batch->tot, batch, ptcache_compressed_batch_decode_cb,
+	        batch->tot > 1 && batch->tot_len >= PTCACHE_COMPRESSED_BATCH_THREADED_MIN);
+	batch->tot = 0;
+	batch->tot_len = 0;
 }
-static int ptcache_file_data_read(PTCacheFile *pf)
+
+/* same as #ptcache_file_compressed_read, 'result' is only valid after #ptcache_compressed_batch_decode */
+static void ptcache_file_compressed_read_batch(
+        PTCacheFile *pf, PTCacheCompressedBatch *batch, unsigned char *result, unsigned int len)
 {
-	int i;
+	PTCacheCompressedBlock *block;
 
-	for (i=0; i<BPHYS_TOT_DATA; i++) {
-		if ((pf->data_types & (1<<i)) && !ptcache_file_read(pf, pf->cur[i], 1, ptcache_data_size[i]))
-			return 0;
+	if (batch->tot == PTCACHE_COMPRESSED_BATCH_MAX) {
+		ptcache_compressed_batch_decode(batch);
 	}
-	
-	return 1;
-}
+
+	block = &batch->blocks[batch->tot++];
+	block->data = result;
+	block->len = len;
+	batch->tot_len += len;
+
+	ptcache_file_compressed_block_read(pf, block);
+}
+
+static void ptcache_compressed_batch_encode_cb(void *userdata, const int iter)
+{
+	PTCacheCompressedBatch *batch = userdata;
+	ptcache_compressed_block_encode(&batch->blocks[iter], batch->mode);
+}
+
+/* compress and write all blocks added with #ptcache_file_compressed_write_batch, in order */
+static void ptcache_file_compressed_batch_write(PTCacheFile *pf, PTCacheCompressedBatch *batch)
+{
+	int i;
+
+	/* LZMA needs a lot of memory per compression (dictionary), only run LZO in parallel */
+	BLI_task_parallel_range(
+	        0, batch->tot, batch, ptcache_compressed_batch_encode_cb,
+	        batch->mode == 1 && batch->tot > 1 && batch->tot_len >= PTCACHE_COMPRESSED_BATCH_THREADED_MIN);
+
+	for (i = 0; i < batch->tot; i++) {
+		ptcache_file_compressed_block_write(pf, &batch->blocks[i]);
+		MEM_freeN(batch->blocks[i].in);
+	}
+
+	batch->tot = 0;
+	batch->tot_len = 0;
+}
+
+/* same as #ptcache_file_compressed_write, 'in' must stay valid until #ptcache_file_compressed_batch_write */
+static void ptcache_file_compressed_write_batch(
+        PTCacheFile *pf, PTCacheCompressedBatch *batch, unsigned char *in, unsigned int in_len)
+{
+	PTCacheCompressedBlock *block;
+
+	if (batch->tot == PTCACHE_COMPRESSED_BATCH_MAX) {
+		ptcache_file_compressed_batch_write(pf, batch);
+	}
+
+	block = &batch->blocks[batch->tot++];
+	block->data = in;
+	block->len = in_len;
+	block->in = (unsigned char *)MEM_callocN(LZO_OUT_LEN(in_len) * 4, "pointcache_lzo_buffer");
+	batch->tot_len += in_len;
+}
+
+/* the next 'len' bytes of a frame read from memory, without copying them */
+static const unsigned char *ptcache_file_read_mem(PTCacheFile *pf, size_t len)
+{
+	const unsigned char *mem;
+
+	if (pf->mem_len - pf->mem_pos < len) {
+		pf->mem_pos = pf->mem_len;
+		return NULL;
+	}
+
+	mem = pf->mem + pf->mem_pos;
+	pf->mem_pos += len;
+
+	return mem;
+}
+static int ptcache_file_read(PTCacheFile *pf, void *f, unsigned int tot, unsigned int size)
+{
+	if (pf->mem) {
+		const size_t len = (size_t)tot * size;
+		const unsigned char *mem = ptcache_file_read_mem(pf, len);
+
+		if (mem == NULL)
+			return 0;
+
+		memcpy(f, mem, len);
+		return 1;
+	}
+
+	return (fread(f, size, tot, pf->fp) == tot);
+}
+static int ptcache_file_write(PTCacheFile *pf, const void *f, unsigned int tot, unsigned int size)
+{
+	pf->size += (size_t)tot * size;
+	return (fwrite(f, size, tot, pf->fp) == tot);
+}
+/* only used for reading, relative to the start of the frame or to the current position */
+static void ptcache_file_seek(PTCacheFile *pf, long offset, int whence)
+{
+	if (pf->mem) {
+		const long pos = (whence == SEEK_SET) ? offset : (long)pf->mem_pos + offset;
+		pf->mem_pos = (size_t)CLAMPIS(pos, 0, (long)pf->mem_len);
+	}
+	else {
+		fseek(pf->fp, offset, whence);
+	}
+}
+static int ptcache_file_data_read(PTCacheFile *pf)
+{
+	int i;
+
+	for (i=0; i<BPHYS_TOT_DATA; i++) {
+		if ((pf->data_types & (1<<i)) && !ptcache_file_read(pf, pf->cur[i], 1, ptcache_data_size[i]))
+			return 0;
+	}
+	
+	return 1;
+}
 static int ptcache_file_data_write(PTCacheFile *pf)
 {		
 	int i;
@@ -2051,13 +2709,13 @@ static int ptcache_file_header_begin_read(PTCacheFile *pf)
 	
 	pf->data_types = 0;
 	
-	if (fread(bphysics, sizeof(char), 8, pf->fp) != 8)
+	if (!ptcache_file_read(pf, bphysics, 8, sizeof(char)))
 		error = 1;
 	
 	if (!error && !STREQLEN(bphysics, "BPHYSICS", 8))
 		error = 1;
 
-	if (!error && !fread(&typeflag, sizeof(unsigned int), 1, pf->fp))
+	if (!error && !ptcache_file_read(pf, &typeflag, 1, sizeof(unsigned int)))
 		error = 1;
 
 	pf->type = (typeflag & PTCACHE_TYPEFLAG_TYPEMASK);
@@ -2065,7 +2723,7 @@ static int ptcache_file_header_begin_read(PTCacheFile *pf)
 	
 	/* if there was an error set file as it was */
 	if (error)
-		fseek(pf->fp, 0, SEEK_SET);
+		ptcache_file_seek(pf, 0, SEEK_SET);
 
 	return !error;
 }
@@ -2074,10 +2732,10 @@ static int ptcache_file_header_begin_write(PTCacheFile *pf)
 	const char *bphysics = "BPHYSICS";
 	unsigned int typeflag = pf->type + pf->flag;
 	
-	if (fwrite(bphysics, sizeof(char), 8, pf->fp) != 8)
+	if (!ptcache_file_write(pf, bphysics, 8, sizeof(char)))
 		return 0;
 
-	if (!fwrite(&typeflag, sizeof(unsigned int), 1, pf->fp))
+	if (!ptcache_file_write(pf, &typeflag, 1, sizeof(unsigned int)))
 		return 0;
 	
 	return 1;
@@ -2282,19 +2940,104 @@ static void ptcache_find_frames_around(PTCacheID *pid, unsigned int frame, int *
 	}
 }
 
-static PTCacheMem *ptcache_disk_frame_to_mem(PTCacheID *pid, int cfra)
+/* Uncompressed point data is stored interleaved per point,
+ * read all points at once and sort them into the data arrays of the frame. */
+static int ptcache_file_points_read(PTCacheFile *pf, PTCacheMem *pm)
+{
+	const unsigned char *buf;
+	unsigned char *buf_alloc = NULL;
+	size_t point_size = 0, offset = 0;
+	unsigned int i, p;
+
+	for (i = 0; i < BPHYS_TOT_DATA; i++) {
+		if (pm->data_types & (1 << i))
+			point_size += ptcache_data_size[i];
+	}
+
+	if (pm->totpoint == 0 || point_size == 0)
+		return 1;
+
+	if (pf->mem) {
+		/* sort straight from the frame in memory */
+		buf = ptcache_file_read_mem(pf, point_size * pm->totpoint);
+		if (buf == NULL)
+			return 0;
+	}
+	else {
+		buf = buf_alloc = MEM_mallocN(point_size * pm->totpoint, "pointcache_points_buffer");
+
+		if (!ptcache_file_read(pf, buf_alloc, pm->totpoint, point_size)) {
+			MEM_freeN(buf_alloc);
+			return 0;
+		}
+	}
+
+	for (i = 0; i < BPHYS_TOT_DATA; i++) {
+		if (pm->data_types & (1 << i)) {
+			const size_t size = ptcache_data_size[i];
+			const unsigned char *src = buf + offset;
+			unsigned char *dst = pm->data[i];
+
+			for (p = 0; p < pm->totpoint; p++, src += point_size, dst += size)
+				memcpy(dst, src, size);
+
+			offset += size;
+		}
+	}
+
+	if (buf_alloc)
+		MEM_freeN(buf_alloc);
+
+	return 1;
+}
+
+static int ptcache_file_points_write(PTCacheFile *pf, PTCacheMem *pm)
+{
+	unsigned char *buf;
+	size_t point_size = 0, offset = 0;
+	unsigned int i, p;
+	int ok;
+
+	for (i = 0; i < BPHYS_TOT_DATA; i++) {
+		if (pm->data_types & (1 << i))
+			point_size += ptcache_data_size[i];
+	}
+
+	if (pm->totpoint == 0 || point_size == 0)
+		return 1;
+
+	buf = MEM_mallocN(point_size * pm->totpoint, "pointcache_points_buffer");
+
+	for (i = 0; i < BPHYS_TOT_DATA; i++) {
+		if (pm->data_types & (1 << i)) {
+			const size_t size = ptcache_data_size[i];
+			const unsigned char *src = pm->data[i];
+			unsigned char *dst = buf + offset;
+
+			for (p = 0; p < pm->totpoint; p++, src += size, dst += point_size)
+				memcpy(dst, src, size);
+
+			offset += size;
+		}
+	}
+
+	ok = ptcache_file_write(pf, buf, pm->totpoint, point_size);
+
+	MEM_freeN(buf);
+
+	return ok;
+}
+
+/* reads a frame and closes the file, doesn't access the PTCacheID so it can run in a thread */
+static PTCacheMem *ptcache_file_frame_to_mem(PTCacheFile *pf, unsigned int type, int (*read_header)(PTCacheFile *pf))
 {
-	PTCacheFile *pf = ptcache_file_open(pid, PTCACHE_FILE_READ, cfra);
 	PTCacheMem *pm = NULL;
 	unsigned int i, error = 0;
 
-	if (pf == NULL)
-		return NULL;
-
 	if (!ptcache_file_header_begin_read(pf))
 		error = 1;
 
-	if (!error && (pf->type != pid->type || !pid->read_header(pf)))
+	if (!error && (pf->type != type || !read_header(pf)))
 		error = 1;
 
 	if (!error) {
@@ -2307,24 +3050,19 @@ static PTCacheMem *ptcache_disk_frame_to_mem(PTCacheID *pid, int cfra)
 		ptcache_data_alloc(pm);
 
 		if (pf->flag & PTCACHE_TYPEFLAG_COMPRESS) {
+			PTCacheCompressedBatch batch = {{{NULL}}};
+
 			for (i=0; i<BPHYS_TOT_DATA; i++) {
 				unsigned int out_len = pm->totpoint*ptcache_data_size[i];
 				if (pf->data_types & (1<<i))
-					ptcache_file_compressed_read(pf, (unsigned char *)(pm->data[i]), out_len);
+					ptcache_file_compressed_read_batch(pf, &batch, (unsigned char *)(pm->data[i]), out_len);
 			}
+
+			ptcache_compressed_batch_decode(&batch);
 		}
 		else {
-			BKE_ptcache_mem_pointers_init(pm);
-			ptcache_file_pointers_init(pf);
-
-			for (i=0; i<pm->totpoint; i++) {
-				if (!ptcache_file_data_read(pf)) {
-					error = 1;
-					break;
-				}
-				ptcache_data_copy(pf->cur, pm->cur);
-				BKE_ptcache_mem_pointers_incr(pm);
-			}
+			if (!ptcache_file_points_read(pf, pm))
+				error = 1;
 		}
 	}
 
@@ -2363,6 +3101,15 @@ static PTCacheMem *ptcache_disk_frame_to_mem(PTCacheID *pid, int cfra)
 	
 	return pm;
 }
+static PTCacheMem *ptcache_disk_frame_to_mem(PTCacheID *pid, int cfra)
+{
+	PTCacheFile *pf = ptcache_file_open(pid, PTCACHE_FILE_READ, cfra);
+
+	if (pf == NULL)
+		return NULL;
+
+	return ptcache_file_frame_to_mem(pf, pid->type, pid->read_header);
+}
 static int ptcache_mem_frame_to_disk(PTCacheID *pid, PTCacheMem *pm)
 {
 	PTCacheFile *pf = NULL;
@@ -2394,27 +3141,22 @@ static int ptcache_mem_frame_to_disk(PTCacheID *pid, PTCacheMem *pm)
 
 	if (!error) {
 		if (pid->cache->compression) {
+			PTCacheCompressedBatch batch = {{{NULL}}};
+
+			batch.mode = pid->cache->compression;
+
 			for (i=0; i<BPHYS_TOT_DATA; i++) {
 				if (pm->data[i]) {
 					unsigned int in_len = pm->totpoint*ptcache_data_size[i];
-					unsigned char *out = (unsigned char *)MEM_callocN(LZO_OUT_LEN(in_len) * 4, "pointcache_lzo_buffer");
-					ptcache_file_compressed_write(pf, (unsigned char *)(pm->data[i]), in_len, out, pid->cache->compression);
-					MEM_freeN(out);
+					ptcache_file_compressed_write_batch(pf, &batch, (unsigned char *)(pm->data[i]), in_len);
 				}
 			}
+
+			ptcache_file_compressed_batch_write(pf, &batch);
 		}
 		else {
-			BKE_ptcache_mem_pointers_init(pm);
-			ptcache_file_pointers_init(pf);
-
-			for (i=0; i<pm->totpoint; i++) {
-				ptcache_data_copy(pm->cur, pf->cur);
-				if (!ptcache_file_data_write(pf)) {
-					error = 1;
-					break;
-				}
-				BKE_ptcache_mem_pointers_incr(pm);
-			}
+			if (!ptcache_file_points_write(pf, pm))
+				error = 1;
 		}
 	}
 
@@ -2448,6 +3190,338 @@ static int ptcache_mem_frame_to_disk(PTCacheID *pid, PTCacheMem *pm)
 	return error==0;
 }
 
+/* -------------------------------------------------------------------- */
+/* Prefetch
+ *
+ * During playback of a disk cache the frames following the current one (in playback direction)
+ * are read and decompressed by worker threads, so the simulation only has to copy the data.
+ * All caches share one memory budget, the user preference #UserDef.ptcache_prefetch_limit. */
+
+/* maximum number of frames read ahead */
+#define PTCACHE_PREFETCH_FRAMES_MAX 32
+
+/* memory of the frames read by all caches */
+static size_t ptcache_prefetch_mem_used = 0;
+
+static size_t ptcache_prefetch_mem_limit(void)
+{
+	return (size_t)max_ii(U.ptcache_prefetch_limit, 0) * 1024 * 1024;
+}
+
+typedef struct PTCachePrefetchFrame {
+	struct PTCachePrefetchFrame *next, *prev;
+
+	int frame;
+	bool done;  /* set by the worker thread once 'pm' is read, protected by the mutex */
+	PTCacheMem *pm;
+	size_t mem_size;
+
+	/* worker thread input, the PTCacheID isn't accessed from threads */
+	char filename[FILE_MAX * 2];
+	uint64_t offset, size;  /* frame in a single file container, size is 0 for a file per frame */
+	unsigned int type;
+	int (*read_header)(PTCacheFile *pf);
+} PTCachePrefetchFrame;
+
+typedef struct PTCachePrefetch {
+	TaskPool *pool;
+	ThreadMutex mutex;
+
+	ListBase frames;  /* PTCachePrefetchFrame, read or being read */
+	size_t mem_used;  /* memory of the frames read so far */
+	size_t mem_frame;  /* memory of the last read frame, to estimate pending frames */
+
+	int last_frame;  /* last scene frame read by the simulation */
+	int direction;  /* playback direction, 1, -1 or 0 when unknown */
+} PTCachePrefetch;
+
+static size_t ptcache_mem_size(PTCacheMem *pm)
+{
+	PTCacheExtra *extra;
+	size_t size = sizeof(PTCacheMem);
+	int i;
+
+	for (i = 0; i < BPHYS_TOT_DATA; i++) {
+		if (pm->data[i])
+			size += MEM_allocN_len(pm->data[i]);
+	}
+
+	for (extra = pm->extradata.first; extra; extra = extra->next) {
+		size += sizeof(PTCacheExtra);
+		if (extra->data)
+			size += MEM_allocN_len(extra->data);
+	}
+
+	return size;
+}
+
+static void ptcache_mem_free(PTCacheMem *pm)
+{
+	ptcache_data_free(pm);
+	ptcache_extra_free(pm);
+	MEM_freeN(pm);
+}
+
+static bool ptcache_prefetch_supported(PTCacheID *pid)
+{
+	return ((pid->cache->flag & PTCACHE_DISK_CACHE) &&
+	        (pid->cache->flag & PTCACHE_BAKING) == 0 &&
+	        pid->read_point && pid->read_stream == NULL &&
+	        pid->file_type != PTCACHE_FILE_OPENVDB);
+}
+
+static void ptcache_prefetch_frame_free(PTCachePrefetchFrame *pf_frame)
+{
+	if (pf_frame->pm)
+		ptcache_mem_free(pf_frame->pm);
+	MEM_freeN(pf_frame);
+}
+
+static void ptcache_prefetch_free(PointCache *cache)
+{
+	PTCachePrefetch *prefetch = cache->prefetch;
+	PTCachePrefetchFrame *pf_frame, *pf_frame_next;
+
+	if (prefetch == NULL)
+		return;
+
+	/* waits for frames being read */
+	BLI_task_pool_cancel(prefetch->pool);
+	BLI_task_pool_free(prefetch->pool);
+
+	for (pf_frame = prefetch->frames.first; pf_frame; pf_frame = pf_frame_next) {
+		pf_frame_next = pf_frame->next;
+		ptcache_prefetch_frame_free(pf_frame);
+	}
+	atomic_sub_and_fetch_z(&ptcache_prefetch_mem_used, prefetch->mem_used);
+
+	BLI_mutex_end(&prefetch->mutex);
+	MEM_freeN(prefetch);
+	cache->prefetch = NULL;
+}
+
+static void ptcache_prefetch_read_task(TaskPool *__restrict pool, void *taskdata, int UNUSED(threadid))
+{
+	PTCachePrefetch *prefetch = BLI_task_pool_userdata(pool);
+	PTCachePrefetchFrame *pf_frame = taskdata;
+	PTCacheMem *pm = NULL;
+	PTCacheFile *pf = NULL;
+	FILE *fp;
+
+	if (BLI_task_pool_canceled(pool))
+		return;
+
+	if (pf_frame->size) {
+		pf = ptcache_container_frame_open(pf_frame->filename, pf_frame->frame, pf_frame->offset, pf_frame->size);
+	}
+	else if ((fp = BLI_fopen(pf_frame->filename, "rb"))) {
+		pf = ptcache_file_new(fp, pf_frame->frame);
+	}
+
+	if (pf)
+		pm = ptcache_file_frame_to_mem(pf, pf_frame->type, pf_frame->read_header);
+
+	BLI_mutex_lock(&prefetch->mutex);
+	pf_frame->done = true;
+	pf_frame->pm = pm;
+	if (pm) {
+		pf_frame->mem_size = ptcache_mem_size(pm);
+		prefetch->mem_used += pf_frame->mem_size;
+		atomic_add_and_fetch_z(&ptcache_prefetch_mem_used, pf_frame->mem_size);
+		prefetch->mem_frame = pf_frame->mem_size;
+	}
+	BLI_mutex_unlock(&prefetch->mutex);
+}
+
+/* call with the mutex locked */
+static PTCachePrefetchFrame *ptcache_prefetch_frame_find(PTCachePrefetch *prefetch, int frame)
+{
+	PTCachePrefetchFrame *pf_frame;
+
+	for (pf_frame = prefetch->frames.first; pf_frame; pf_frame = pf_frame->next) {
+		if (pf_frame->frame == frame)
+			return pf_frame;
+	}
+
+	return NULL;
+}
+
+/* get a frame for reading, either read ahead or read now,
+ * release with #ptcache_disk_frame_release */
+static PTCacheMem *ptcache_disk_frame_acquire(PTCacheID *pid, int cfra)
+{
+	PTCachePrefetch *prefetch = pid->cache->prefetch;
+	PTCachePrefetchFrame *pf_frame;
+	PTCacheMem *pm = NULL;
+	bool is_pending = false;
+
+	if (prefetch == NULL || !ptcache_prefetch_supported(pid))
+		return ptcache_disk_frame_to_mem(pid, cfra);
+
+	BLI_mutex_lock(&prefetch->mutex);
+	pf_frame = ptcache_prefetch_frame_find(prefetch, cfra);
+	if (pf_frame) {
+		if (pf_frame->done)
+			pm = pf_frame->pm;
+		else
+			is_pending = true;
+	}
+	BLI_mutex_unlock(&prefetch->mutex);
+
+	if (pf_frame && !is_pending)
+		return pm;
+
+	pm = ptcache_disk_frame_to_mem(pid, cfra);
+
+	/* keep the frame around for interpolation in the following frames */
+	if (pm && !is_pending) {
+		pf_frame = MEM_callocN(sizeof(PTCachePrefetchFrame), "PTCachePrefetchFrame");
+		pf_frame->frame = cfra;
+		pf_frame->done = true;
+		pf_frame->pm = pm;
+		pf_frame->mem_size = ptcache_mem_size(pm);
+
+		BLI_mutex_lock(&prefetch->mutex);
+		BLI_addtail(&prefetch->frames, pf_frame);
+		prefetch->mem_used += pf_frame->mem_size;
+		atomic_add_and_fetch_z(&ptcache_prefetch_mem_used, pf_frame->mem_size);
+		prefetch->mem_frame = pf_frame->mem_size;
+		BLI_mutex_unlock(&prefetch->mutex);
+	}
+
+	return pm;
+}
+
+static void ptcache_disk_frame_release(PTCacheID *pid, PTCacheMem *pm)
+{
+	PTCachePrefetch *prefetch = pid->cache->prefetch;
+	PTCachePrefetchFrame *pf_frame;
+
+	if (prefetch) {
+		BLI_mutex_lock(&prefetch->mutex);
+		for (pf_frame = prefetch->frames.first; pf_frame; pf_frame = pf_frame->next) {
+			if (pf_frame->pm == pm)
+				break;
+		}
+		BLI_mutex_unlock(&prefetch->mutex);
+
+		/* owned by the prefetch, freed once it's behind the playback */
+		if (pf_frame)
+			return;
+	}
+
+	ptcache_mem_free(pm);
+}
+
+/* Called after the simulation read frame 'cfra', frees the frames that were shown
+ * and starts reading the following frames in playback direction. */
+static void ptcache_prefetch_update(PTCacheID *pid, int cfra)
+{
+	PointCache *cache = pid->cache;
+	PTCachePrefetch *prefetch;
+	PTCachePrefetchFrame *pf_frame, *pf_frame_next;
+	const int step = MAX2(cache->step, 1);
+	const size_t mem_limit = ptcache_prefetch_mem_limit();
+	size_t mem_pending = 0;
+	int tot_pending = 0;
+	int i, delta;
+
+	if (!ptcache_prefetch_supported(pid)) {
+		ptcache_prefetch_free(cache);
+		return;
+	}
+
+	if (cache->prefetch == NULL) {
+		prefetch = cache->prefetch = MEM_callocN(sizeof(PTCachePrefetch), "PTCachePrefetch");
+		prefetch->pool = BLI_task_pool_create_background(BLI_task_scheduler_get(), prefetch);
+		BLI_mutex_init(&prefetch->mutex);
+		prefetch->last_frame = cfra;
+		return;
+	}
+
+	prefetch = cache->prefetch;
+
+	/* follow the playback direction, jumps (scrubbing) stop reading ahead until playback continues */
+	delta = cfra - prefetch->last_frame;
+	if (delta != 0) {
+		if (abs(delta) <= PTCACHE_PREFETCH_FRAMES_MAX)
+			prefetch->direction = (delta > 0) ? 1 : -1;
+		else
+			prefetch->direction = 0;
+		prefetch->last_frame = cfra;
+	}
+
+	BLI_mutex_lock(&prefetch->mutex);
+
+	/* free frames that were shown, keeping the ones interpolation may still need */
+	for (pf_frame = prefetch->frames.first; pf_frame; pf_frame = pf_frame_next) {
+		const int offset = (pf_frame->frame - cfra) * (prefetch->direction ? prefetch->direction : 1);
+		bool is_behind;
+
+		pf_frame_next = pf_frame->next;
+
+		if (prefetch->direction == 0)
+			is_behind = abs(offset) > step;
+		else
+			is_behind = offset < -step || offset > PTCACHE_PREFETCH_FRAMES_MAX * step;
+
+		if (!pf_frame->done) {
+			tot_pending++;
+			mem_pending += prefetch->mem_frame;
+		}
+		else if (is_behind || pf_frame->pm == NULL) {
+			prefetch->mem_used -= pf_frame->mem_size;
+			atomic_sub_and_fetch_z(&ptcache_prefetch_mem_used, pf_frame->mem_size);
+			BLI_remlink(&prefetch->frames, pf_frame);
+			ptcache_prefetch_frame_free(pf_frame);
+		}
+	}
+
+	/* start reading the following frames, within the memory budget */
+	if (prefetch->direction != 0) {
+		for (i = 1; i <= PTCACHE_PREFETCH_FRAMES_MAX && tot_pending < PTCACHE_PREFETCH_FRAMES_MAX; i++) {
+			const int frame = cfra + i * prefetch->direction;
+
+			if (frame < cache->startframe || frame > cache->endframe)
+				break;
+
+			if (atomic_add_and_fetch_z(&ptcache_prefetch_mem_used, 0) + mem_pending + prefetch->mem_frame >
+			    mem_limit)
+			{
+				break;
+			}
+
+			if (ptcache_prefetch_frame_find(prefetch, frame) || !BKE_ptcache_id_exist(pid, frame))
+				continue;
+
+			pf_frame = MEM_callocN(sizeof(PTCachePrefetchFrame), "PTCachePrefetchFrame");
+			pf_frame->frame = frame;
+			pf_frame->type = pid->type;
+			pf_frame->read_header = pid->read_header;
+
+			if (ptcache_use_container(pid)) {
+				PTCacheContainer *container;
+				PTCacheContainerFrame *entry = ptcache_container_frame_get(pid, frame, &container);
+
+				BLI_strncpy(pf_frame->filename, container->filename, sizeof(pf_frame->filename));
+				pf_frame->offset = entry->offset;
+				pf_frame->size = entry->size;
+			}
+			else {
+				ptcache_filename(pid, pf_frame->filename, frame, 1, 1);
+			}
+
+			BLI_addtail(&prefetch->frames, pf_frame);
+			tot_pending++;
+			mem_pending += prefetch->mem_frame;
+
+			BLI_task_pool_push(prefetch->pool, ptcache_prefetch_read_task, pf_frame, false, TASK_PRIORITY_LOW);
+		}
+	}
+
+	BLI_mutex_unlock(&prefetch->mutex);
+}
+
 static int ptcache_read_stream(PTCacheID *pid, int cfra)
 {
 	PTCacheFile *pf = ptcache_file_open(pid, PTCACHE_FILE_READ, cfra);
@@ -2531,7 +3605,7 @@ static int ptcache_read(PTCacheID *pid, int cfra)
 
 	/* get a memory cache to read from */
 	if (pid->cache->flag & PTCACHE_DISK_CACHE) {
-		pm = ptcache_disk_frame_to_mem(pid, cfra);
+		pm = ptcache_disk_frame_acquire(pid, cfra);
 	}
 	else {
 		pm = pid->cache->mem_cache.first;
@@ -2569,9 +3643,7 @@ static int ptcache_read(PTCacheID *pid, int cfra)
 
 		/* clean up temporary memory cache */
 		if (pid->cache->flag & PTCACHE_DISK_CACHE) {
-			ptcache_data_free(pm);
-			ptcache_extra_free(pm);
-			MEM_freeN(pm);
+			ptcache_disk_frame_release(pid, pm);
 		}
 	}
 
@@ -2585,7 +3657,7 @@ static int ptcache_interpolate(PTCacheID *pid, float cfra, int cfra1, int cfra2)
 
 	/* get a memory cache to read from */
 	if (pid->cache->flag & PTCACHE_DISK_CACHE) {
-		pm = ptcache_disk_frame_to_mem(pid, cfra2);
+		pm = ptcache_disk_frame_acquire(pid, cfra2);
 	}
 	else {
 		pm = pid->cache->mem_cache.first;
@@ -2622,9 +3694,7 @@ static int ptcache_interpolate(PTCacheID *pid, float cfra, int cfra1, int cfra2)
 
 		/* clean up temporary memory cache */
 		if (pid->cache->flag & PTCACHE_DISK_CACHE) {
-			ptcache_data_free(pm);
-			ptcache_extra_free(pm);
-			MEM_freeN(pm);
+			ptcache_disk_frame_release(pid, pm);
 		}
 	}
 
@@ -2702,6 +3772,9 @@ int BKE_ptcache_read(PTCacheID *pid, float cfra, bool no_extrapolate_old)
 		}
 	}
 
+	if (pid->read_point && (pid->cache->flag & PTCACHE_DISK_CACHE))
+		ptcache_prefetch_update(pid, cfrai);
+
 	if (cfra1)
 		ret = (cfra2 ? PTCACHE_READ_INTERPOLATED : PTCACHE_READ_EXACT);
 	else if (cfra2) {
@@ -2960,6 +4033,9 @@ void BKE_ptcache_id_clear(PTCacheID *pid, int mode, unsigned int cfra)
 	if (pid->cache->flag & PTCACHE_IGNORE_CLEAR)
 		return;
 
+	/* frames read ahead may be outdated */
+	ptcache_prefetch_free(pid->cache);
+
 	sta = pid->cache->startframe;
 	end = pid->cache->endframe;
 
@@ -2978,7 +4054,13 @@ void BKE_ptcache_id_clear(PTCacheID *pid, int mode, unsigned int cfra)
 	case PTCACHE_CLEAR_ALL:
 	case PTCACHE_CLEAR_BEFORE:
 	case PTCACHE_CLEAR_AFTER:
-		if (pid->cache->flag & PTCACHE_DISK_CACHE) {
+		if ((pid->cache->flag & PTCACHE_DISK_CACHE) && ptcache_use_container(pid)) {
+			ptcache_container_clear(pid, mode, cfra);
+
+			if (mode == PTCACHE_CLEAR_ALL && pid->cache->cached_frames)
+				memset(pid->cache->cached_frames, 0, MEM_allocN_len(pid->cache->cached_frames));
+		}
+		else if (pid->cache->flag & PTCACHE_DISK_CACHE) {
 			ptcache_path(pid, path);
 			
 			dir = opendir(path);
@@ -3066,7 +4148,10 @@ void BKE_ptcache_id_clear(PTCacheID *pid, int mode, unsigned int cfra)
 		
 	case PTCACHE_CLEAR_FRAME:
 		if (pid->cache->flag & PTCACHE_DISK_CACHE) {
-			if (BKE_ptcache_id_exist(pid, cfra)) {
+			if (ptcache_use_container(pid)) {
+				ptcache_container_clear(pid, mode, cfra);
+			}
+			else if (BKE_ptcache_id_exist(pid, cfra)) {
 				ptcache_filename(pid, filename, cfra, 1, 1); /* no path */
 				BLI_delete(filename, false, false);
 			}
@@ -3103,6 +4188,11 @@ int  BKE_ptcache_id_exist(PTCacheID *pid, int cfra)
 	
 	if (pid->cache->flag & PTCACHE_DISK_CACHE) {
 		char filename[MAX_PTCACHE_FILE];
+
+		if (ptcache_use_container(pid)) {
+			PTCacheContainer *container;
+			return ptcache_container_frame_get(pid, cfra, &container) != NULL;
+		}
 		
 		ptcache_filename(pid, filename, cfra, 1, 1);
 
@@ -3381,7 +4471,7 @@ void BKE_ptcache_remove(void)
 			if (FILENAME_IS_CURRPAR(de->d_name)) {
 				/* do nothing */
 			}
-			else if (strstr(de->d_name, PTCACHE_EXT)) { /* do we have the right extension?*/
+			else if (strstr(de->d_name, PTCACHE_EXT) || strstr(de->d_name, PTCACHE_CONTAINER_EXT)) { /* do we have the right extension?*/
 				BLI_join_dirfile(path_full, sizeof(path_full), path, de->d_name);
 				BLI_delete(path_full, false, false);
 			}
@@ -3433,6 +4523,8 @@ void BKE_ptcache_free_mem(ListBase *mem_cache)
 }
 void BKE_ptcache_free(PointCache *cache)
 {
+	ptcache_prefetch_free(cache);
+	ptcache_container_free(cache);
 	BKE_ptcache_free_mem(&cache->mem_cache);
 	if (cache->edit && cache->free_edit)
 		cache->free_edit(cache->edit);
@@ -3461,7 +4553,7 @@ static PointCache *ptcache_copy(PointCache *cache, bool copy_data)
 		ncache->cached_frames = NULL;
 
 		/* flag is a mix of user settings and simulator/baking state */
-		ncache->flag= ncache->flag & (PTCACHE_DISK_CACHE|PTCACHE_EXTERNAL|PTCACHE_IGNORE_LIBPATH);
+		ncache->flag= ncache->flag & (PTCACHE_DISK_CACHE|PTCACHE_EXTERNAL|PTCACHE_IGNORE_LIBPATH|PTCACHE_DISK_SINGLE_FILE);
 		ncache->simframe= 0;
 	}
 	else {
@@ -3487,6 +4579,8 @@ static PointCache *ptcache_copy(PointCache *cache, bool copy_data)
 
 	/* hmm, should these be copied over instead? */
 	ncache->edit = NULL;
+	ncache->prefetch = NULL;
+	ncache->container = NULL;
 
 	return ncache;
 }
@@ -3835,6 +4929,79 @@ void BKE_ptcache_toggle_disk_cache(PTCacheID *pid)
 	}
 }
 
+/* copies the frame as it's stored, 'pf_dst' is opened for writing */
+static bool ptcache_file_copy(PTCacheFile *pf_src, PTCacheFile *pf_dst)
+{
+	unsigned char *buf;
+	size_t len;
+	bool ok = true;
+
+	if (pf_src->mem)
+		return ptcache_file_write(pf_dst, pf_src->mem, (unsigned int)pf_src->mem_len, sizeof(unsigned char));
+
+	buf = MEM_mallocN(PTCACHE_FILE_COPY_BUFFER, "pointcache_copy_buffer");
+
+	while (ok && (len = fread(buf, sizeof(unsigned char), PTCACHE_FILE_COPY_BUFFER, pf_src->fp)) > 0)
+		ok = ptcache_file_write(pf_dst, buf, (unsigned int)len, sizeof(unsigned char));
+
+	MEM_freeN(buf);
+
+	return ok && !ferror(pf_src->fp);
+}
+
+void BKE_ptcache_toggle_single_file(PTCacheID *pid)
+{
+	PointCache *cache = pid->cache;
+	const int flag = cache->flag;
+	const int last_exact = cache->last_exact;
+	int cfra;
+
+	ptcache_prefetch_free(cache);
+	ptcache_container_free(cache);
+
+	if ((cache->flag & PTCACHE_DISK_CACHE) == 0 || (cache->flag & PTCACHE_EXTERNAL) ||
+	    pid->file_type != PTCACHE_FILE_PTCACHE)
+	{
+		return;
+	}
+
+	if (cache->cached_frames) {
+		MEM_freeN(cache->cached_frames);
+		cache->cached_frames = NULL;
+	}
+
+	/* the container stores frames exactly like the frame files */
+	for (cfra = cache->startframe; cfra <= cache->endframe; cfra++) {
+		PTCacheFile *pf_src, *pf_dst;
+
+		cache->flag = flag ^ PTCACHE_DISK_SINGLE_FILE;
+		pf_src = ptcache_file_open(pid, PTCACHE_FILE_READ, cfra);
+		cache->flag = flag;
+
+		if (pf_src == NULL)
+			continue;
+
+		pf_dst = ptcache_file_open(pid, PTCACHE_FILE_WRITE, cfra);
+
+		if (pf_dst && !ptcache_file_copy(pf_src, pf_dst) && G.debug & G_DEBUG)
+			printf("Error copying point cache frame %d\n", cfra);
+
+		ptcache_file_close(pf_dst);
+		ptcache_file_close(pf_src);
+	}
+
+	/* remove the frames stored the other way, baked or not */
+	cache->flag = (flag ^ PTCACHE_DISK_SINGLE_FILE) & ~(PTCACHE_BAKED | PTCACHE_IGNORE_CLEAR);
+	BKE_ptcache_id_clear(pid, PTCACHE_CLEAR_ALL, 0);
+	cache->flag = flag;
+
+	ptcache_container_free(cache);
+	cache->last_exact = last_exact;
+
+	BKE_ptcache_id_time(pid, NULL, 0.0f, NULL, NULL, NULL);
+	BKE_ptcache_update_info(pid);
+}
+
 void BKE_ptcache_disk_cache_rename(PTCacheID *pid, const char *name_src, const char *name_dst)
 {
 	char old_name[80];
@@ -3854,6 +5021,18 @@ void BKE_ptcache_disk_cache_rename(PTCacheID *pid, const char *name_src, const c
 	/* get "from" filename */
 	BLI_strncpy(pid->cache->name, name_src, sizeof(pid->cache->name));
 
+	if (ptcache_use_container(pid)) {
+		/* one file to rename */
+		if (ptcache_container_filename(pid, old_path_full) && BLI_exists(old_path_full)) {
+			BLI_strncpy(pid->cache->name, name_dst, sizeof(pid->cache->name));
+			ptcache_container_filename(pid, new_path_full);
+			BLI_rename(old_path_full, new_path_full);
+		}
+
+		BLI_strncpy(pid->cache->name, old_name, sizeof(pid->cache->name));
+		return;
+	}
+
 	len = ptcache_filename(pid, old_filename, 0, 0, 0); /* no path */
 
 	ptcache_path(pid, path);
@@ -40,6 +40,7 @@
 #include "IMB_imbuf_types.h"
 
 #include "BLI_listbase.h"
+#include "BLI_threads.h"
 
 #include "BKE_sequencer.h"
 #include "BKE_scene.h"
@@ -69,6 +70,9 @@ typedef struct SeqPreprocessCache {
 static struct MovieCache *moviecache = NULL;
 static struct SeqPreprocessCache *preprocess_cache = NULL;
 
+/* frames are also rendered ahead into the cache from a background thread */
+static ThreadMutex cache_lock = BLI_MUTEX_INITIALIZER;
+
 static void preprocessed_cache_destruct(void);
 
 static bool seq_cmp_render_data(const SeqRenderData *a, const SeqRenderData *b)
@@ -123,6 +127,8 @@ static bool seqcache_hashcmp(const void *a_, const void *b_)
 
 void BKE_sequencer_cache_destruct(void)
 {
+	BKE_sequencer_prefetch_free();
+
 	if (moviecache)
 		IMB_moviecache_free(moviecache);
 
@@ -131,6 +137,8 @@ void BKE_sequencer_cache_destruct(void)
 
 void BKE_sequencer_cache_cleanup(void)
 {
+	BKE_sequencer_prefetch_stop();
+
 	if (moviecache) {
 		IMB_moviecache_free(moviecache);
 		moviecache = IMB_moviecache_create("seqcache", sizeof(SeqCacheKey), seqcache_hashhash, seqcache_hashcmp);
@@ -149,24 +157,31 @@ static bool seqcache_key_check_seq(ImBuf *UNUSED(ibuf), void *userkey, void *use
 
 void BKE_sequencer_cache_cleanup_sequence(Sequence *seq)
 {
+	BKE_sequencer_prefetch_stop();
+
 	if (moviecache)
 		IMB_moviecache_cleanup(moviecache, seqcache_key_check_seq, seq);
 }
 
 struct ImBuf *BKE_sequencer_cache_get(const SeqRenderData *context, Sequence *seq, float cfra, eSeqStripElemIBuf type)
 {
+	ImBuf *ibuf = NULL;
+
 	if (moviecache && seq) {
 		SeqCacheKey key;
 
-		key.seq = seq;
+		/* frames rendered ahead are cached under the original strips */
+		key.seq = context->is_prefetch_render ? BKE_sequencer_prefetch_original_get(seq) : seq;
 		key.context = *context;
 		key.cfra = cfra - seq->start;
 		key.type = type;
 
-		return IMB_moviecache_get(moviecache, &key);
+		BLI_mutex_lock(&cache_lock);
+		ibuf = IMB_moviecache_get(moviecache, &key);
+		BLI_mutex_unlock(&cache_lock);
 	}
 
-	return NULL;
+	return ibuf;
 }
 
 void BKE_sequencer_cache_put(const SeqRenderData *context, Sequence *seq, float cfra, eSeqStripElemIBuf type, ImBuf *i)
@@ -177,16 +192,20 @@ void BKE_sequencer_cache_put(const SeqRenderData *context, Sequence *seq, float
 		return;
 	}
 
-	if (!moviecache) {
-		moviecache = IMB_moviecache_create("seqcache", sizeof(SeqCacheKey), seqcache_hashhash, seqcache_hashcmp);
-	}
-
-	key.seq = seq;
+	key.seq = context->is_prefetch_render ? BKE_sequencer_prefetch_original_get(seq) : seq;
 	key.context = *context;
 	key.cfra = cfra - seq->start;
 	key.type = type;
 
+	BLI_mutex_lock(&cache_lock);
+
+	if (!moviecache) {
+		moviecache = IMB_moviecache_create("seqcache", sizeof(SeqCacheKey), seqcache_hashhash, seqcache_hashcmp);
+	}
+
 	IMB_moviecache_put(moviecache, &key, i);
+
+	BLI_mutex_unlock(&cache_lock);
 }
 
 void BKE_sequencer_preprocessed_cache_cleanup(void)
@@ -219,7 +238,8 @@ ImBuf *BKE_sequencer_preprocessed_cache_get(const SeqRenderData *context, Sequen
 {
 	SeqPreprocessCacheElem *elem;
 
-	if (!preprocess_cache)
+	/* only holds a single frame, it's left to the main thread */
+	if (!preprocess_cache || context->is_prefetch_render)
 		return NULL;
 
 	if (preprocess_cache->cfra != cfra)
@@ -246,6 +266,9 @@ void BKE_sequencer_preprocessed_cache_put(const SeqRenderData *context, Sequence
 {
 	SeqPreprocessCacheElem *elem;
 
+	if (context->is_prefetch_render)
+		return;
+
 	if (!preprocess_cache) {
 		preprocess_cache = MEM_callocN(sizeof(SeqPreprocessCache), "sequencer preprocessed cache");
 	}
@@ -40,6 +40,7 @@
 #include "BLI_utildefines.h"
 #include "BLI_rect.h"
 #include "BLI_string.h"
+#include "BLI_task.h"
 
 #include "DNA_scene_types.h"
 #include "DNA_sequence_types.h"
@@ -59,6 +60,10 @@
 
 #include "BLF_api.h"
 
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+
 static void slice_get_byte_buffers(const SeqRenderData *context, const ImBuf *ibuf1, const ImBuf *ibuf2,
                                    const ImBuf *ibuf3, const ImBuf *out, int start_line, unsigned char **rect1,
                                    unsigned char **rect2, unsigned char **rect3, unsigned char **rect_out)
@@ -160,6 +165,106 @@ static ImBuf *prepare_effect_imbufs(const SeqRenderData *context, ImBuf *ibuf1,
 	return out;
 }
 
+/*********************** Row kernels *************************/
+
+/* Blend effects are evaluated one row at a time, odd rows of a slice use facf1
+ * instead of facf0 (field rendering). The row kernels only deal with a single
+ * factor, which keeps the SSE2 paths simple. */
+
+typedef void (*EffectRowFloatFunc)(float fac, int x, const float *rt1, const float *rt2, float *rt);
+typedef void (*EffectRowByteFunc)(float fac, int x, const unsigned char *rt1, const unsigned char *rt2,
+                                  unsigned char *rt);
+
+static void effect_apply_rows_float(EffectRowFloatFunc row_func, float facf0, float facf1, int x, int y,
+                                    const float *rect1, const float *rect2, float *out)
+{
+	const size_t stride = (size_t)x * 4;
+	int i;
+
+	for (i = 0; i < y; i++) {
+		row_func((i & 1) ? facf1 : facf0, x, rect1, rect2, out);
+
+		rect1 += stride;
+		rect2 += stride;
+		out += stride;
+	}
+}
+
+static void effect_apply_rows_byte(EffectRowByteFunc row_func, float facf0, float facf1, int x, int y,
+                                   const unsigned char *rect1, const unsigned char *rect2, unsigned char *out)
+{
+	const size_t stride = (size_t)x * 4;
+	int i;
+
+	for (i = 0; i < y; i++) {
+		row_func((i & 1) ? facf1 : facf0, x, rect1, rect2, out);
+
+		rect1 += stride;
+		rect2 += stride;
+		out += stride;
+	}
+}
+
+#ifdef __SSE2__
+/* Per-lane select, returns a where mask is set and b elsewhere. */
+BLI_INLINE __m128 effect_select_ps(const __m128 mask, const __m128 a, const __m128 b)
+{
+	return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+BLI_INLINE __m128 effect_alpha_mask_ps(void)
+{
+	return _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+}
+
+BLI_INLINE __m128 effect_broadcast_alpha_ps(const __m128 col)
+{
+	return _mm_shuffle_ps(col, col, _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+/* Same as straight_uchar_to_premul_float(). */
+BLI_INLINE __m128 effect_straight_uchar_to_premul_ps(const unsigned char color[4])
+{
+	const __m128i col_i = _mm_unpacklo_epi16(
+	        _mm_unpacklo_epi8(_mm_cvtsi32_si128(*(const int *)color), _mm_setzero_si128()),
+	        _mm_setzero_si128());
+	const __m128 col = _mm_cvtepi32_ps(col_i);
+	const __m128 alpha = _mm_mul_ps(effect_broadcast_alpha_ps(col), _mm_set1_ps(1.0f / 255.0f));
+	const __m128 fac = _mm_mul_ps(alpha, _mm_set1_ps(1.0f / 255.0f));
+
+	return effect_select_ps(effect_alpha_mask_ps(), alpha, _mm_mul_ps(col, fac));
+}
+
+/* Same as premul_float_to_straight_uchar(). */
+BLI_INLINE void effect_premul_ps_to_straight_uchar(unsigned char result[4], __m128 col)
+{
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 alpha = effect_broadcast_alpha_ps(col);
+	const __m128 keep = _mm_or_ps(_mm_cmpeq_ps(alpha, _mm_setzero_ps()), _mm_cmpeq_ps(alpha, one));
+	const __m128 alpha_inv = effect_select_ps(_mm_or_ps(keep, effect_alpha_mask_ps()), one, _mm_div_ps(one, alpha));
+	__m128i col_i;
+
+	/* FTOCHAR, truncation of the clamped value matches the scalar rounding. */
+	col = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(col, alpha_inv), _mm_set1_ps(255.0f)), _mm_set1_ps(0.5f));
+	col = _mm_min_ps(_mm_max_ps(col, _mm_setzero_ps()), _mm_set1_ps(255.0f));
+	col_i = _mm_cvttps_epi32(col);
+	col_i = _mm_packus_epi16(_mm_packs_epi32(col_i, col_i), col_i);
+
+	*(int *)result = _mm_cvtsi128_si32(col_i);
+}
+
+/* (fac * alpha2 * col2) >> 16 for 2 pixels stored as 16 bit lanes, alpha lanes are cleared.
+ * fac has to be in the 0..256 range so the intermediate product fits into 16 bits. */
+BLI_INLINE __m128i effect_alpha_weighted_epi16(const __m128i fac, const __m128i col2)
+{
+	const __m128i rgb_mask = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+	const __m128i alpha2 = _mm_shufflehi_epi16(_mm_shufflelo_epi16(col2, _MM_SHUFFLE(3, 3, 3, 3)),
+	                                           _MM_SHUFFLE(3, 3, 3, 3));
+
+	return _mm_and_si128(_mm_mulhi_epu16(_mm_mullo_epi16(fac, alpha2), col2), rgb_mask);
+}
+#endif  /* __SSE2__ */
+
 /*********************** Alpha Over *************************/
 
 static void init_alpha_over_or_under(Sequence *seq)
@@ -171,132 +276,96 @@ static void init_alpha_over_or_under(Sequence *seq)
 	seq->seq1 = seq2;
 }
 
-static void do_alphaover_effect_byte(float facf0, float facf1, int x, int y,  unsigned char *rect1, unsigned char *rect2, unsigned char *out)
+static void alphaover_row_byte(float fac, int x, const unsigned char *cp1, const unsigned char *cp2,
+                               unsigned char *rt)
 {
-	float fac2, mfac, fac, fac4;
-	int xo;
-	unsigned char *cp1, *cp2, *rt;
-	float tempc[4], rt1[4], rt2[4];
-
-	xo = x;
-	cp1 = rect1;
-	cp2 = rect2;
-	rt = out;
-
-	fac2 = facf0;
-	fac4 = facf1;
-
-	while (y--) {
-		x = xo;
-		while (x--) {
-			/* rt = rt1 over rt2  (alpha from rt1) */
-
-			straight_uchar_to_premul_float(rt1, cp1);
-			straight_uchar_to_premul_float(rt2, cp2);
-
-			fac = fac2;
-			mfac = 1.0f - fac2 * rt1[3];
+	if (fac <= 0.0f) {
+		memcpy(rt, cp2, sizeof(*rt) * 4 * x);
+		return;
+	}
 
-			if      (fac  <= 0.0f) *((unsigned int *) rt) = *((unsigned int *) cp2);
-			else if (mfac <= 0.0f) *((unsigned int *) rt) = *((unsigned int *) cp1);
-			else {
-				tempc[0] = fac * rt1[0] + mfac * rt2[0];
-				tempc[1] = fac * rt1[1] + mfac * rt2[1];
-				tempc[2] = fac * rt1[2] + mfac * rt2[2];
-				tempc[3] = fac * rt1[3] + mfac * rt2[3];
+	while (x--) {
+		/* rt = rt1 over rt2  (alpha from rt1) */
+		const float mfac = 1.0f - fac * (cp1[3] * (1.0f / 255.0f));
 
-				premul_float_to_straight_uchar(rt, tempc);
-			}
-			cp1 += 4; cp2 += 4; rt += 4;
+		if (mfac <= 0.0f) {
+			*((unsigned int *) rt) = *((unsigned int *) cp1);
 		}
+		else {
+#ifdef __SSE2__
+			const __m128 rt1 = effect_straight_uchar_to_premul_ps(cp1);
+			const __m128 rt2 = effect_straight_uchar_to_premul_ps(cp2);
 
-		if (y == 0) break;
-		y--;
+			effect_premul_ps_to_straight_uchar(
+			        rt, _mm_add_ps(_mm_mul_ps(_mm_set1_ps(fac), rt1), _mm_mul_ps(_mm_set1_ps(mfac), rt2)));
+#else
+			float tempc[4], rt1[4], rt2[4];
 
-		x = xo;
-		while (x--) {
 			straight_uchar_to_premul_float(rt1, cp1);
 			straight_uchar_to_premul_float(rt2, cp2);
 
-			fac = fac4;
-			mfac = 1.0f - (fac4 * rt1[3]);
-
-			if      (fac  <= 0.0f) *((unsigned int *) rt) = *((unsigned int *) cp2);
-			else if (mfac <= 0.0f) *((unsigned int *) rt) = *((unsigned int *) cp1);
-			else {
-				tempc[0] = fac * rt1[0] + mfac * rt2[0];
-				tempc[1] = fac * rt1[1] + mfac * rt2[1];
-				tempc[2] = fac * rt1[2] + mfac * rt2[2];
-				tempc[3] = fac * rt1[3] + mfac * rt2[3];
+			tempc[0] = fac * rt1[0] + mfac * rt2[0];
+			tempc[1] = fac * rt1[1] + mfac * rt2[1];
+			tempc[2] = fac * rt1[2] + mfac * rt2[2];
+			tempc[3] = fac * rt1[3] + mfac * rt2[3];
 
-				premul_float_to_straight_uchar(rt, tempc);
-			}
-			cp1 += 4; cp2 += 4; rt += 4;
+			premul_float_to_straight_uchar(rt, tempc);
+#endif
 		}
+		cp1 += 4; cp2 += 4; rt += 4;
 	}
 }
 
-static void do_alphaover_effect_float(float facf0, float facf1, int x, int y,  float *rect1, float *rect2, float *out)
+static void do_alphaover_effect_byte(float facf0, float facf1, int x, int y,  unsigned char *rect1, unsigned char *rect2, unsigned char *out)
 {
-	float fac2, mfac, fac, fac4;
-	int xo;
-	float *rt1, *rt2, *rt;
+	effect_apply_rows_byte(alphaover_row_byte, facf0, facf1, x, y, rect1, rect2, out);
+}
 
-	xo = x;
-	rt1 = rect1;
-	rt2 = rect2;
-	rt = out;
+static void alphaover_row_float(float fac, int x, const float *rt1, const float *rt2, float *rt)
+{
+	if (fac <= 0.0f) {
+		memcpy(rt, rt2, sizeof(*rt) * 4 * x);
+		return;
+	}
 
-	fac2 = facf0;
-	fac4 = facf1;
+#ifdef __SSE2__
+	{
+		const __m128 fac_r = _mm_set1_ps(fac);
 
-	while (y--) {
-		x = xo;
 		while (x--) {
 			/* rt = rt1 over rt2  (alpha from rt1) */
+			const __m128 col1 = _mm_loadu_ps(rt1);
+			const __m128 col2 = _mm_loadu_ps(rt2);
+			const __m128 mfac = _mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(fac_r, effect_broadcast_alpha_ps(col1)));
+			const __m128 col = _mm_add_ps(_mm_mul_ps(fac_r, col1), _mm_mul_ps(mfac, col2));
 
-			fac = fac2;
-			mfac = 1.0f - (fac2 * rt1[3]);
+			_mm_storeu_ps(rt, effect_select_ps(_mm_cmple_ps(mfac, _mm_setzero_ps()), col1, col));
 
-			if (fac <= 0.0f) {
-				memcpy(rt, rt2, 4 * sizeof(float));
-			}
-			else if (mfac <= 0) {
-				memcpy(rt, rt1, 4 * sizeof(float));
-			}
-			else {
-				rt[0] = fac * rt1[0] + mfac * rt2[0];
-				rt[1] = fac * rt1[1] + mfac * rt2[1];
-				rt[2] = fac * rt1[2] + mfac * rt2[2];
-				rt[3] = fac * rt1[3] + mfac * rt2[3];
-			}
 			rt1 += 4; rt2 += 4; rt += 4;
 		}
+	}
+#else
+	while (x--) {
+		/* rt = rt1 over rt2  (alpha from rt1) */
+		const float mfac = 1.0f - (fac * rt1[3]);
 
-		if (y == 0)
-			break;
-		y--;
-
-		x = xo;
-		while (x--) {
-			fac = fac4;
-			mfac = 1.0f - (fac4 * rt1[3]);
-
-			if (fac <= 0.0f) {
-				memcpy(rt, rt2, 4 * sizeof(float));
-			}
-			else if (mfac <= 0.0f) {
-				memcpy(rt, rt1, 4 * sizeof(float));
-			}
-			else {
-				rt[0] = fac * rt1[0] + mfac * rt2[0];
-				rt[1] = fac * rt1[1] + mfac * rt2[1];
-				rt[2] = fac * rt1[2] + mfac * rt2[2];
-				rt[3] = fac * rt1[3] + mfac * rt2[3];
-			}
-			rt1 += 4; rt2 += 4; rt += 4;
+		if (mfac <= 0.0f) {
+			memcpy(rt, rt1, 4 * sizeof(float));
+		}
+		else {
+			rt[0] = fac * rt1[0] + mfac * rt2[0];
+			rt[1] = fac * rt1[1] + mfac * rt2[1];
+			rt[2] = fac * rt1[2] + mfac * rt2[2];
+			rt[3] = fac * rt1[3] + mfac * rt2[3];
 		}
+		rt1 += 4; rt2 += 4; rt += 4;
 	}
+#endif
+}
+
+static void do_alphaover_effect_float(float facf0, float facf1, int x, int y,  float *rect1, float *rect2, float *out)
+{
+	effect_apply_rows_float(alphaover_row_float, facf0, facf1, x, y, rect1, rect2, out);
 }
 
 static void do_alphaover_effect(const SeqRenderData *context, Sequence *UNUSED(seq), float UNUSED(cfra), float facf0,
@@ -321,150 +390,115 @@ static void do_alphaover_effect(const SeqRenderData *context, Sequence *UNUSED(s
 
 /*********************** Alpha Under *************************/
 
-static void do_alphaunder_effect_byte(float facf0, float facf1, int x, int y, unsigned char *rect1, unsigned char *rect2, unsigned char *out)
+static void alphaunder_row_byte(float fac, int x, const unsigned char *cp1, const unsigned char *cp2,
+                                unsigned char *rt)
 {
-	float fac2, fac, fac4;
-	int xo;
-	unsigned char *cp1, *cp2, *rt;
-	float tempc[4], rt1[4], rt2[4];
-
-	xo = x;
-	cp1 = rect1;
-	cp2 = rect2;
-	rt = out;
-
-	fac2 = facf0;
-	fac4 = facf1;
+	while (x--) {
+		/* rt = rt1 under rt2  (alpha from rt2) */
+		const float alpha2 = cp2[3] * (1.0f / 255.0f);
 
-	while (y--) {
-		x = xo;
-		while (x--) {
-			/* rt = rt1 under rt2  (alpha from rt2) */
-			straight_uchar_to_premul_float(rt1, cp1);
-			straight_uchar_to_premul_float(rt2, cp2);
+		/* this complex optimization is because the
+		 * 'skybuf' can be crossed in
+		 */
+		if      (alpha2 <= 0.0f && fac >= 1.0f) *((unsigned int *) rt) = *((unsigned int *) cp1);
+		else if (alpha2 >= 1.0f)                *((unsigned int *) rt) = *((unsigned int *) cp2);
+		else {
+			const float mfac = fac * (1.0f - alpha2);
 
-			/* this complex optimization is because the
-			 * 'skybuf' can be crossed in
-			 */
-			if      (rt2[3] <= 0.0f && fac2 >= 1.0f) *((unsigned int *) rt) = *((unsigned int *) cp1);
-			else if (rt2[3] >= 1.0f)                 *((unsigned int *) rt) = *((unsigned int *) cp2);
+			if (mfac <= 0) *((unsigned int *) rt) = *((unsigned int *) cp2);
 			else {
-				fac = (fac2 * (1.0f - rt2[3]));
+#ifdef __SSE2__
+				const __m128 rt1 = effect_straight_uchar_to_premul_ps(cp1);
+				const __m128 rt2 = effect_straight_uchar_to_premul_ps(cp2);
 
-				if (fac <= 0) *((unsigned int *) rt) = *((unsigned int *) cp2);
-				else {
-					tempc[0] = (fac * rt1[0] + rt2[0]);
-					tempc[1] = (fac * rt1[1] + rt2[1]);
-					tempc[2] = (fac * rt1[2] + rt2[2]);
-					tempc[3] = (fac * rt1[3] + rt2[3]);
-					
-					premul_float_to_straight_uchar(rt, tempc);
-				}
-			}
-			cp1 += 4; cp2 += 4; rt += 4;
-		}
+				effect_premul_ps_to_straight_uchar(rt, _mm_add_ps(_mm_mul_ps(_mm_set1_ps(mfac), rt1), rt2));
+#else
+				float tempc[4], rt1[4], rt2[4];
 
-		if (y == 0)
-			break;
-		y--;
+				straight_uchar_to_premul_float(rt1, cp1);
+				straight_uchar_to_premul_float(rt2, cp2);
 
-		x = xo;
-		while (x--) {
-			straight_uchar_to_premul_float(rt1, cp1);
-			straight_uchar_to_premul_float(rt2, cp2);
-			
-			if      (rt2[3] <= 0.0f && fac4 >= 1.0f) *((unsigned int *) rt) = *((unsigned int *) cp1);
-			else if (rt2[3] >= 1.0f)                 *((unsigned int *) rt) = *((unsigned int *) cp2);
-			else {				
-				fac = (fac4 * (1.0f - rt2[3]));
+				tempc[0] = (mfac * rt1[0] + rt2[0]);
+				tempc[1] = (mfac * rt1[1] + rt2[1]);
+				tempc[2] = (mfac * rt1[2] + rt2[2]);
+				tempc[3] = (mfac * rt1[3] + rt2[3]);
 
-				if (fac <= 0) *((unsigned int *)rt) = *((unsigned int *)cp2);
-				else {
-					tempc[0] = (fac * rt1[0] + rt2[0]);
-					tempc[1] = (fac * rt1[1] + rt2[1]);
-					tempc[2] = (fac * rt1[2] + rt2[2]);
-					tempc[3] = (fac * rt1[3] + rt2[3]);
-					
-					premul_float_to_straight_uchar(rt, tempc);
-				}
+				premul_float_to_straight_uchar(rt, tempc);
+#endif
 			}
-			cp1 += 4; cp2 += 4; rt += 4;
 		}
+		cp1 += 4; cp2 += 4; rt += 4;
 	}
 }
 
-static void do_alphaunder_effect_float(float facf0, float facf1, int x, int y,  float *rect1, float *rect2, float *out)
+static void do_alphaunder_effect_byte(float facf0, float facf1, int x, int y, unsigned char *rect1, unsigned char *rect2, unsigned char *out)
 {
-	float fac2, fac, fac4;
-	int xo;
-	float *rt1, *rt2, *rt;
-
-	xo = x;
-	rt1 = rect1;
-	rt2 = rect2;
-	rt = out;
+	effect_apply_rows_byte(alphaunder_row_byte, facf0, facf1, x, y, rect1, rect2, out);
+}
 
-	fac2 = facf0;
-	fac4 = facf1;
+static void alphaunder_row_float(float fac, int x, const float *rt1, const float *rt2, float *rt)
+{
+#ifdef __SSE2__
+	const __m128 fac_r = _mm_set1_ps(fac);
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 zero = _mm_setzero_ps();
+	const bool use_sky = (fac >= 1.0f);
 
-	while (y--) {
-		x = xo;
-		while (x--) {
-			/* rt = rt1 under rt2  (alpha from rt2) */
+	while (x--) {
+		/* rt = rt1 under rt2  (alpha from rt2) */
+		const __m128 col1 = _mm_loadu_ps(rt1);
+		const __m128 col2 = _mm_loadu_ps(rt2);
+		const __m128 alpha2 = effect_broadcast_alpha_ps(col2);
+		const __m128 mfac = _mm_mul_ps(fac_r, _mm_sub_ps(one, alpha2));
+		__m128 col = _mm_add_ps(_mm_mul_ps(mfac, col1), col2);
 
+		col = effect_select_ps(_mm_or_ps(_mm_cmpge_ps(alpha2, one), _mm_cmpeq_ps(mfac, zero)), col2, col);
+		if (use_sky) {
 			/* this complex optimization is because the
 			 * 'skybuf' can be crossed in
 			 */
-			if (rt2[3] <= 0 && fac2 >= 1.0f) {
-				memcpy(rt, rt1, 4 * sizeof(float));
-			}
-			else if (rt2[3] >= 1.0f) {
-				memcpy(rt, rt2, 4 * sizeof(float));
-			}
-			else {
-				fac = fac2 * (1.0f - rt2[3]);
-
-				if (fac == 0) {
-					memcpy(rt, rt2, 4 * sizeof(float));
-				}
-				else {
-					rt[0] = fac * rt1[0] + rt2[0];
-					rt[1] = fac * rt1[1] + rt2[1];
-					rt[2] = fac * rt1[2] + rt2[2];
-					rt[3] = fac * rt1[3] + rt2[3];
-				}
-			}
-			rt1 += 4; rt2 += 4; rt += 4;
+			col = effect_select_ps(_mm_cmple_ps(alpha2, zero), col1, col);
 		}
+		_mm_storeu_ps(rt, col);
 
-		if (y == 0)
-			break;
-		y--;
+		rt1 += 4; rt2 += 4; rt += 4;
+	}
+#else
+	float mfac;
 
-		x = xo;
-		while (x--) {
-			if (rt2[3] <= 0 && fac4 >= 1.0f) {
-				memcpy(rt, rt1, 4 * sizeof(float));
-			}
-			else if (rt2[3] >= 1.0f) {
+	while (x--) {
+		/* rt = rt1 under rt2  (alpha from rt2) */
+
+		/* this complex optimization is because the
+		 * 'skybuf' can be crossed in
+		 */
+		if (rt2[3] <= 0 && fac >= 1.0f) {
+			memcpy(rt, rt1, 4 * sizeof(float));
+		}
+		else if (rt2[3] >= 1.0f) {
+			memcpy(rt, rt2, 4 * sizeof(float));
+		}
+		else {
+			mfac = fac * (1.0f - rt2[3]);
+
+			if (mfac == 0) {
 				memcpy(rt, rt2, 4 * sizeof(float));
 			}
 			else {
-				fac = fac4 * (1.0f - rt2[3]);
-
-				if (fac == 0) {
-					memcpy(rt, rt2, 4 * sizeof(float));
-				}
-				else {
-					rt[0] = fac * rt1[0] + rt2[0];
-					rt[1] = fac * rt1[1] + rt2[1];
-					rt[2] = fac * rt1[2] + rt2[2];
-					rt[3] = fac * rt1[3] + rt2[3];
-				}
+				rt[0] = mfac * rt1[0] + rt2[0];
+				rt[1] = mfac * rt1[1] + rt2[1];
+				rt[2] = mfac * rt1[2] + rt2[2];
+				rt[3] = mfac * rt1[3] + rt2[3];
 			}
-			rt1 += 4; rt2 += 4; rt += 4;
 		}
+		rt1 += 4; rt2 += 4; rt += 4;
 	}
+#endif
+}
+
+static void do_alphaunder_effect_float(float facf0, float facf1, int x, int y,  float *rect1, float *rect2, float *out)
+{
+	effect_apply_rows_float(alphaunder_row_float, facf0, facf1, x, y, rect1, rect2, out);
 }
 
 static void do_alphaunder_effect(const SeqRenderData *context, Sequence *UNUSED(seq), float UNUSED(cfra),
@@ -489,92 +523,79 @@ static void do_alphaunder_effect(const SeqRenderData *context, Sequence *UNUSED(
 
 /*********************** Cross *************************/
 
-static void do_cross_effect_byte(float facf0, float facf1, int x, int y, unsigned char *rect1, unsigned char *rect2, unsigned char *out)
+static void cross_row_byte(float fac, int x, const unsigned char *rt1, const unsigned char *rt2, unsigned char *rt)
 {
-	int fac1, fac2, fac3, fac4;
-	int xo;
-	unsigned char *rt1, *rt2, *rt;
+	const int fac2 = (int) (256.0f * fac);
+	const int fac1 = 256 - fac2;
 
-	xo = x;
-	rt1 = rect1;
-	rt2 = rect2;
-	rt = out;
+#ifdef __SSE2__
+	if (fac2 >= 0 && fac2 <= 256) {
+		/* Four pixels at a time, weighted sum never exceeds 16 bits. */
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i fac1_r = _mm_set1_epi16((short)fac1);
+		const __m128i fac2_r = _mm_set1_epi16((short)fac2);
 
-	fac2 = (int) (256.0f * facf0);
-	fac1 = 256 - fac2;
-	fac4 = (int) (256.0f * facf1);
-	fac3 = 256 - fac4;
+		for (; x >= 4; x -= 4) {
+			const __m128i col1 = _mm_loadu_si128((const __m128i *)rt1);
+			const __m128i col2 = _mm_loadu_si128((const __m128i *)rt2);
+			__m128i lo = _mm_add_epi16(_mm_mullo_epi16(fac1_r, _mm_unpacklo_epi8(col1, zero)),
+			                           _mm_mullo_epi16(fac2_r, _mm_unpacklo_epi8(col2, zero)));
+			__m128i hi = _mm_add_epi16(_mm_mullo_epi16(fac1_r, _mm_unpackhi_epi8(col1, zero)),
+			                           _mm_mullo_epi16(fac2_r, _mm_unpackhi_epi8(col2, zero)));
 
-	while (y--) {
-		x = xo;
-		while (x--) {
-			rt[0] = (fac1 * rt1[0] + fac2 * rt2[0]) >> 8;
-			rt[1] = (fac1 * rt1[1] + fac2 * rt2[1]) >> 8;
-			rt[2] = (fac1 * rt1[2] + fac2 * rt2[2]) >> 8;
-			rt[3] = (fac1 * rt1[3] + fac2 * rt2[3]) >> 8;
+			lo = _mm_srli_epi16(lo, 8);
+			hi = _mm_srli_epi16(hi, 8);
+			_mm_storeu_si128((__m128i *)rt, _mm_packus_epi16(lo, hi));
 
-			rt1 += 4; rt2 += 4; rt += 4;
+			rt1 += 16; rt2 += 16; rt += 16;
 		}
+	}
+#endif
 
-		if (y == 0)
-			break;
-		y--;
-
-		x = xo;
-		while (x--) {
-			rt[0] = (fac3 * rt1[0] + fac4 * rt2[0]) >> 8;
-			rt[1] = (fac3 * rt1[1] + fac4 * rt2[1]) >> 8;
-			rt[2] = (fac3 * rt1[2] + fac4 * rt2[2]) >> 8;
-			rt[3] = (fac3 * rt1[3] + fac4 * rt2[3]) >> 8;
-
-			rt1 += 4; rt2 += 4; rt += 4;
-		}
+	while (x--) {
+		rt[0] = (fac1 * rt1[0] + fac2 * rt2[0]) >> 8;
+		rt[1] = (fac1 * rt1[1] + fac2 * rt2[1]) >> 8;
+		rt[2] = (fac1 * rt1[2] + fac2 * rt2[2]) >> 8;
+		rt[3] = (fac1 * rt1[3] + fac2 * rt2[3]) >> 8;
 
+		rt1 += 4; rt2 += 4; rt += 4;
 	}
 }
 
-static void do_cross_effect_float(float facf0, float facf1, int x, int y, float *rect1, float *rect2, float *out)
+static void do_cross_effect_byte(float facf0, float facf1, int x, int y, unsigned char *rect1, unsigned char *rect2, unsigned char *out)
 {
-	float fac1, fac2, fac3, fac4;
-	int xo;
-	float *rt1, *rt2, *rt;
-
-	xo = x;
-	rt1 = rect1;
-	rt2 = rect2;
-	rt = out;
-
-	fac2 = facf0;
-	fac1 = 1.0f - fac2;
-	fac4 = facf1;
-	fac3 = 1.0f - fac4;
-
-	while (y--) {
-		x = xo;
-		while (x--) {
-			rt[0] = fac1 * rt1[0] + fac2 * rt2[0];
-			rt[1] = fac1 * rt1[1] + fac2 * rt2[1];
-			rt[2] = fac1 * rt1[2] + fac2 * rt2[2];
-			rt[3] = fac1 * rt1[3] + fac2 * rt2[3];
+	effect_apply_rows_byte(cross_row_byte, facf0, facf1, x, y, rect1, rect2, out);
+}
 
-			rt1 += 4; rt2 += 4; rt += 4;
-		}
+static void cross_row_float(float fac, int x, const float *rt1, const float *rt2, float *rt)
+{
+	const float fac2 = fac;
+	const float fac1 = 1.0f - fac2;
 
-		if (y == 0)
-			break;
-		y--;
+#ifdef __SSE2__
+	const __m128 fac1_r = _mm_set1_ps(fac1);
+	const __m128 fac2_r = _mm_set1_ps(fac2);
 
-		x = xo;
-		while (x--) {
-			rt[0] = fac3 * rt1[0] + fac4 * rt2[0];
-			rt[1] = fac3 * rt1[1] + fac4 * rt2[1];
-			rt[2] = fac3 * rt1[2] + fac4 * rt2[2];
-			rt[3] = fac3 * rt1[3] + fac4 * rt2[3];
+	while (x--) {
+		_mm_storeu_ps(rt, _mm_add_ps(_mm_mul_ps(fac1_r, _mm_loadu_ps(rt1)), _mm_mul_ps(fac2_r, _mm_loadu_ps(rt2))));
 
-			rt1 += 4; rt2 += 4; rt += 4;
-		}
+		rt1 += 4; rt2 += 4; rt += 4;
+	}
+#else
+	while (x--) {
+		rt[0] = fac1 * rt1[0] + fac2 * rt2[0];
+		rt[1] = fac1 * rt1[1] + fac2 * rt2[1];
+		rt[2] = fac1 * rt1[2] + fac2 * rt2[2];
+		rt[3] = fac1 * rt1[3] + fac2 * rt2[3];
 
+		rt1 += 4; rt2 += 4; rt += 4;
 	}
+#endif
+}
+
+static void do_cross_effect_float(float facf0, float facf1, int x, int y, float *rect1, float *rect2, float *out)
+{
+	effect_apply_rows_float(cross_row_float, facf0, facf1, x, y, rect1, rect2, out);
 }
 
 static void do_cross_effect(const SeqRenderData *context, Sequence *UNUSED(seq), float UNUSED(cfra),
@@ -853,91 +874,81 @@ static void do_gammacross_effect(const SeqRenderData *context, Sequence *UNUSED(
 
 /*********************** Add *************************/
 
-static void do_add_effect_byte(float facf0, float facf1, int x, int y, unsigned char *rect1, unsigned char *rect2,
-                               unsigned char *out)
+static void add_row_byte(float fac, int x, const unsigned char *cp1, const unsigned char *cp2, unsigned char *rt)
 {
-	int xo, fac1, fac3;
-	unsigned char *cp1, *cp2, *rt;
+	const int fac1 = (int)(256.0f * fac);
 
-	xo = x;
-	cp1 = rect1;
-	cp2 = rect2;
-	rt = out;
+#ifdef __SSE2__
+	if (fac1 >= 0 && fac1 <= 256) {
+		/* Four pixels at a time, packing saturates to 255. */
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i fac_r = _mm_set1_epi16((short)fac1);
 
-	fac1 = (int)(256.0f * facf0);
-	fac3 = (int)(256.0f * facf1);
+		for (; x >= 4; x -= 4) {
+			const __m128i col1 = _mm_loadu_si128((const __m128i *)cp1);
+			const __m128i col2 = _mm_loadu_si128((const __m128i *)cp2);
+			const __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(col1, zero),
+			                                 effect_alpha_weighted_epi16(fac_r, _mm_unpacklo_epi8(col2, zero)));
+			const __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(col1, zero),
+			                                 effect_alpha_weighted_epi16(fac_r, _mm_unpackhi_epi8(col2, zero)));
 
-	while (y--) {
-		x = xo;
+			_mm_storeu_si128((__m128i *)rt, _mm_packus_epi16(lo, hi));
 
-		while (x--) {
-			const int m = fac1 * (int)cp2[3];
-			rt[0] = min_ii(cp1[0] + ((m * cp2[0]) >> 16), 255);
-			rt[1] = min_ii(cp1[1] + ((m * cp2[1]) >> 16), 255);
-			rt[2] = min_ii(cp1[2] + ((m * cp2[2]) >> 16), 255);
-			rt[3] = cp1[3];
-
-			cp1 += 4; cp2 += 4; rt += 4;
+			cp1 += 16; cp2 += 16; rt += 16;
 		}
+	}
+#endif
 
-		if (y == 0)
-			break;
-		y--;
+	while (x--) {
+		const int m = fac1 * (int)cp2[3];
+		rt[0] = min_ii(cp1[0] + ((m * cp2[0]) >> 16), 255);
+		rt[1] = min_ii(cp1[1] + ((m * cp2[1]) >> 16), 255);
+		rt[2] = min_ii(cp1[2] + ((m * cp2[2]) >> 16), 255);
+		rt[3] = cp1[3];
 
-		x = xo;
-		while (x--) {
-			const int m = fac3 * (int)cp2[3];
-			rt[0] = min_ii(cp1[0] + ((m * cp2[0]) >> 16), 255);
-			rt[1] = min_ii(cp1[1] + ((m * cp2[1]) >> 16), 255);
-			rt[2] = min_ii(cp1[2] + ((m * cp2[2]) >> 16), 255);
-			rt[3] = cp1[3];
-
-			cp1 += 4; cp2 += 4; rt += 4;
-		}
+		cp1 += 4; cp2 += 4; rt += 4;
 	}
 }
 
-static void do_add_effect_float(float facf0, float facf1, int x, int y, float *rect1, float *rect2, float *out)
+static void do_add_effect_byte(float facf0, float facf1, int x, int y, unsigned char *rect1, unsigned char *rect2,
+                               unsigned char *out)
 {
-	int xo;
-	float fac1, fac3;
-	float *rt1, *rt2, *rt;
-
-	xo = x;
-	rt1 = rect1;
-	rt2 = rect2;
-	rt = out;
+	effect_apply_rows_byte(add_row_byte, facf0, facf1, x, y, rect1, rect2, out);
+}
 
-	fac1 = facf0;
-	fac3 = facf1;
+static void add_row_float(float fac, int x, const float *rt1, const float *rt2, float *rt)
+{
+#ifdef __SSE2__
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 mfac = _mm_set1_ps(1.0f - fac);
+	const __m128 alpha_mask = effect_alpha_mask_ps();
 
-	while (y--) {
-		x = xo;
-		while (x--) {
-			const float m = (1.0f - (rt1[3] * (1.0f - fac1))) * rt2[3];
-			rt[0] = rt1[0] + m * rt2[0];
-			rt[1] = rt1[1] + m * rt2[1];
-			rt[2] = rt1[2] + m * rt2[2];
-			rt[3] = rt1[3];
+	while (x--) {
+		const __m128 col1 = _mm_loadu_ps(rt1);
+		const __m128 col2 = _mm_loadu_ps(rt2);
+		const __m128 m = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(effect_broadcast_alpha_ps(col1), mfac)),
+		                            effect_broadcast_alpha_ps(col2));
 
-			rt1 += 4; rt2 += 4; rt += 4;
-		}
+		_mm_storeu_ps(rt, effect_select_ps(alpha_mask, col1, _mm_add_ps(col1, _mm_mul_ps(m, col2))));
 
-		if (y == 0)
-			break;
-		y--;
-
-		x = xo;
-		while (x--) {
-			const float m = (1.0f - (rt1[3] * (1.0f - fac3))) * rt2[3];
-			rt[0] = rt1[0] + m * rt2[0];
-			rt[1] = rt1[1] + m * rt2[1];
-			rt[2] = rt1[2] + m * rt2[2];
-			rt[3] = rt1[3];
+		rt1 += 4; rt2 += 4; rt += 4;
+	}
+#else
+	while (x--) {
+		const float m = (1.0f - (rt1[3] * (1.0f - fac))) * rt2[3];
+		rt[0] = rt1[0] + m * rt2[0];
+		rt[1] = rt1[1] + m * rt2[1];
+		rt[2] = rt1[2] + m * rt2[2];
+		rt[3] = rt1[3];
 
-			rt1 += 4; rt2 += 4; rt += 4;
-		}
+		rt1 += 4; rt2 += 4; rt += 4;
 	}
+#endif
+}
+
+static void do_add_effect_float(float facf0, float facf1, int x, int y, float *rect1, float *rect2, float *out)
+{
+	effect_apply_rows_float(add_row_float, facf0, facf1, x, y, rect1, rect2, out);
 }
 
 static void do_add_effect(const SeqRenderData *context, Sequence *UNUSED(seq), float UNUSED(cfra), float facf0, float facf1,
@@ -961,90 +972,84 @@ static void do_add_effect(const SeqRenderData *context, Sequence *UNUSED(seq), f
 
 /*********************** Sub *************************/
 
-static void do_sub_effect_byte(float facf0, float facf1, int x, int y, unsigned char *rect1, unsigned char *rect2, unsigned char *out)
+static void sub_row_byte(float fac, int x, const unsigned char *cp1, const unsigned char *cp2, unsigned char *rt)
 {
-	int xo, fac1, fac3;
-	unsigned char *cp1, *cp2, *rt;
+	const int fac1 = (int) (256.0f * fac);
 
-	xo = x;
-	cp1 = rect1;
-	cp2 = rect2;
-	rt = out;
+#ifdef __SSE2__
+	if (fac1 >= 0 && fac1 <= 256) {
+		/* Four pixels at a time, unsigned saturation clamps to 0. */
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i fac_r = _mm_set1_epi16((short)fac1);
 
-	fac1 = (int) (256.0f * facf0);
-	fac3 = (int) (256.0f * facf1);
+		for (; x >= 4; x -= 4) {
+			const __m128i col1 = _mm_loadu_si128((const __m128i *)cp1);
+			const __m128i col2 = _mm_loadu_si128((const __m128i *)cp2);
+			const __m128i lo = _mm_subs_epu16(_mm_unpacklo_epi8(col1, zero),
+			                                  effect_alpha_weighted_epi16(fac_r, _mm_unpacklo_epi8(col2, zero)));
+			const __m128i hi = _mm_subs_epu16(_mm_unpackhi_epi8(col1, zero),
+			                                  effect_alpha_weighted_epi16(fac_r, _mm_unpackhi_epi8(col2, zero)));
 
-	while (y--) {
-		x = xo;
-		while (x--) {
-			const int m = fac1 * (int)cp2[3];
-			rt[0] = max_ii(cp1[0] - ((m * cp2[0]) >> 16), 0);
-			rt[1] = max_ii(cp1[1] - ((m * cp2[1]) >> 16), 0);
-			rt[2] = max_ii(cp1[2] - ((m * cp2[2]) >> 16), 0);
-			rt[3] = cp1[3];
+			_mm_storeu_si128((__m128i *)rt, _mm_packus_epi16(lo, hi));
 
-			cp1 += 4; cp2 += 4; rt += 4;
+			cp1 += 16; cp2 += 16; rt += 16;
 		}
+	}
+#endif
 
-		if (y == 0)
-			break;
-		y--;
-
-		x = xo;
-		while (x--) {
-			const int m = fac3 * (int)cp2[3];
-			rt[0] = max_ii(cp1[0] - ((m * cp2[0]) >> 16), 0);
-			rt[1] = max_ii(cp1[1] - ((m * cp2[1]) >> 16), 0);
-			rt[2] = max_ii(cp1[2] - ((m * cp2[2]) >> 16), 0);
-			rt[3] = cp1[3];
+	while (x--) {
+		const int m = fac1 * (int)cp2[3];
+		rt[0] = max_ii(cp1[0] - ((m * cp2[0]) >> 16), 0);
+		rt[1] = max_ii(cp1[1] - ((m * cp2[1]) >> 16), 0);
+		rt[2] = max_ii(cp1[2] - ((m * cp2[2]) >> 16), 0);
+		rt[3] = cp1[3];
 
-			cp1 += 4; cp2 += 4; rt += 4;
-		}
+		cp1 += 4; cp2 += 4; rt += 4;
 	}
 }
 
-static void do_sub_effect_float(float UNUSED(facf0), float facf1, int x, int y, float *rect1, float *rect2, float *out)
+static void do_sub_effect_byte(float facf0, float facf1, int x, int y, unsigned char *rect1, unsigned char *rect2, unsigned char *out)
 {
-	int xo;
-	float /* fac1, */ fac3_inv;
-	float *rt1, *rt2, *rt;
-
-	xo = x;
-	rt1 = rect1;
-	rt2 = rect2;
-	rt = out;
+	effect_apply_rows_byte(sub_row_byte, facf0, facf1, x, y, rect1, rect2, out);
+}
 
-	/* UNUSED */
-	// fac1 = facf0;
-	fac3_inv = 1.0f - facf1;
+static void sub_row_float(float fac, int x, const float *rt1, const float *rt2, float *rt)
+{
+	const float fac_inv = 1.0f - fac;
 
-	while (y--) {
-		x = xo;
-		while (x--) {
-			const float m = (1.0f - (rt1[3] * fac3_inv)) * rt2[3];
-			rt[0] = max_ff(rt1[0] - m * rt2[0], 0.0f);
-			rt[1] = max_ff(rt1[1] - m * rt2[1], 0.0f);
-			rt[2] = max_ff(rt1[2] - m * rt2[2], 0.0f);
-			rt[3] = rt1[3];
+#ifdef __SSE2__
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 fac_inv_r = _mm_set1_ps(fac_inv);
+	const __m128 alpha_mask = effect_alpha_mask_ps();
 
-			rt1 += 4; rt2 += 4; rt += 4;
-		}
+	while (x--) {
+		const __m128 col1 = _mm_loadu_ps(rt1);
+		const __m128 col2 = _mm_loadu_ps(rt2);
+		const __m128 m = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(effect_broadcast_alpha_ps(col1), fac_inv_r)),
+		                            effect_broadcast_alpha_ps(col2));
+		const __m128 col = _mm_max_ps(_mm_sub_ps(col1, _mm_mul_ps(m, col2)), _mm_setzero_ps());
 
-		if (y == 0)
-			break;
-		y--;
+		_mm_storeu_ps(rt, effect_select_ps(alpha_mask, col1, col));
 
-		x = xo;
-		while (x--) {
-			const float m = (1.0f - (rt1[3] * fac3_inv)) * rt2[3];
-			rt[0] = max_ff(rt1[0] - m * rt2[0], 0.0f);
-			rt[1] = max_ff(rt1[1] - m * rt2[1], 0.0f);
-			rt[2] = max_ff(rt1[2] - m * rt2[2], 0.0f);
-			rt[3] = rt1[3];
+		rt1 += 4; rt2 += 4; rt += 4;
+	}
+#else
+	while (x--) {
+		const float m = (1.0f - (rt1[3] * fac_inv)) * rt2[3];
+		rt[0] = max_ff(rt1[0] - m * rt2[0], 0.0f);
+		rt[1] = max_ff(rt1[1] - m * rt2[1], 0.0f);
+		rt[2] = max_ff(rt1[2] - m * rt2[2], 0.0f);
+		rt[3] = rt1[3];
 
-			rt1 += 4; rt2 += 4; rt += 4;
-		}
+		rt1 += 4; rt2 += 4; rt += 4;
 	}
+#endif
+}
+
+static void do_sub_effect_float(float UNUSED(facf0), float facf1, int x, int y, float *rect1, float *rect2, float *out)
+{
+	/* facf1 is used for both fields, matching previous behavior. */
+	effect_apply_rows_float(sub_row_float, facf1, facf1, x, y, rect1, rect2, out);
 }
 
 static void do_sub_effect(const SeqRenderData *context, Sequence *UNUSED(seq), float UNUSED(cfra), float facf0, float facf1,
@@ -1202,49 +1207,39 @@ static void do_mul_effect_byte(float facf0, float facf1, int x, int y, unsigned
 	}
 }
 
-static void do_mul_effect_float(float facf0, float facf1, int x, int y, float *rect1, float *rect2, float *out)
+static void mul_row_float(float fac, int x, const float *rt1, const float *rt2, float *rt)
 {
-	int xo;
-	float fac1, fac3;
-	float *rt1, *rt2, *rt;
-
-	xo = x;
-	rt1 = rect1;
-	rt2 = rect2;
-	rt = out;
-
-	fac1 = facf0;
-	fac3 = facf1;
-
 	/* formula:
 	 * fac * (a * b) + (1 - fac) * a  =>  fac * a * (b - 1) + a
 	 */
 
-	while (y--) {
-		x = xo;
-		while (x--) {
-			rt[0] = rt1[0] + fac1 * rt1[0] * (rt2[0] - 1.0f);
-			rt[1] = rt1[1] + fac1 * rt1[1] * (rt2[1] - 1.0f);
-			rt[2] = rt1[2] + fac1 * rt1[2] * (rt2[2] - 1.0f);
-			rt[3] = rt1[3] + fac1 * rt1[3] * (rt2[3] - 1.0f);
+#ifdef __SSE2__
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 fac_r = _mm_set1_ps(fac);
 
-			rt1 += 4; rt2 += 4; rt += 4;
-		}
+	while (x--) {
+		const __m128 col1 = _mm_loadu_ps(rt1);
+		const __m128 col2 = _mm_loadu_ps(rt2);
 
-		if (y == 0)
-			break;
-		y--;
+		_mm_storeu_ps(rt, _mm_add_ps(col1, _mm_mul_ps(_mm_mul_ps(fac_r, col1), _mm_sub_ps(col2, one))));
 
-		x = xo;
-		while (x--) {
-			rt[0] = rt1[0] + fac3 * rt1[0] * (rt2[0] - 1.0f);
-			rt[1] = rt1[1] + fac3 * rt1[1] * (rt2[1] - 1.0f);
-			rt[2] = rt1[2] + fac3 * rt1[2] * (rt2[2] - 1.0f);
-			rt[3] = rt1[3] + fac3 * rt1[3] * (rt2[3] - 1.0f);
+		rt1 += 4; rt2 += 4; rt += 4;
+	}
+#else
+	while (x--) {
+		rt[0] = rt1[0] + fac * rt1[0] * (rt2[0] - 1.0f);
+		rt[1] = rt1[1] + fac * rt1[1] * (rt2[1] - 1.0f);
+		rt[2] = rt1[2] + fac * rt1[2] * (rt2[2] - 1.0f);
+		rt[3] = rt1[3] + fac * rt1[3] * (rt2[3] - 1.0f);
 
-			rt1 += 4; rt2 += 4; rt += 4;
-		}
+		rt1 += 4; rt2 += 4; rt += 4;
 	}
+#endif
+}
+
+static void do_mul_effect_float(float facf0, float facf1, int x, int y, float *rect1, float *rect2, float *out)
+{
+	effect_apply_rows_float(mul_row_float, facf0, facf1, x, y, rect1, rect2, out);
 }
 
 static void do_mul_effect(const SeqRenderData *context, Sequence *UNUSED(seq), float UNUSED(cfra), float facf0, float facf1,
@@ -1570,23 +1565,25 @@ static void copy_wipe_effect(Sequence *dst, Sequence *src)
 	dst->effectdata = MEM_dupallocN(src->effectdata);
 }
 
-static void do_wipe_effect_byte(Sequence *seq, float facf0, float UNUSED(facf1),  int x, int y, unsigned char *rect1,
-                                unsigned char *rect2, unsigned char *out)
+static void do_wipe_effect_byte(Sequence *seq, float facf0, float UNUSED(facf1), int x, int y, int start_line,
+                                int total_lines, unsigned char *rect1, unsigned char *rect2, unsigned char *out)
 {
 	WipeZone wipezone;
 	WipeVars *wipe = (WipeVars *)seq->effectdata;
+	const size_t offset = (size_t)start_line * x * 4;
 	int xo, yo;
 	unsigned char *cp1, *cp2, *rt;
 
+	/* The wipe zone is defined over the whole frame, only the slice rows are evaluated. */
 	precalc_wipe_zone(&wipezone, wipe, x, y);
 
-	cp1 = rect1;
-	cp2 = rect2;
-	rt = out;
+	cp1 = rect1 ? rect1 + offset : NULL;
+	cp2 = rect2 ? rect2 + offset : NULL;
+	rt = out + offset;
 
 	xo = x;
-	yo = y;
-	for (y = 0; y < yo; y++) {
+	yo = start_line + total_lines;
+	for (y = start_line; y < yo; y++) {
 		for (x = 0; x < xo; x++) {
 			float check = check_zone(&wipezone, x, y, seq, facf0);
 			if (check) {
@@ -1636,23 +1633,25 @@ static void do_wipe_effect_byte(Sequence *seq, float facf0, float UNUSED(facf1),
 	}
 }
 
-static void do_wipe_effect_float(Sequence *seq, float facf0, float UNUSED(facf1), int x, int y, float *rect1,
-                                 float *rect2, float *out)
+static void do_wipe_effect_float(Sequence *seq, float facf0, float UNUSED(facf1), int x, int y, int start_line,
+                                 int total_lines, float *rect1, float *rect2, float *out)
 {
 	WipeZone wipezone;
 	WipeVars *wipe = (WipeVars *)seq->effectdata;
+	const size_t offset = (size_t)start_line * x * 4;
 	int xo, yo;
 	float *rt1, *rt2, *rt;
 
+	/* The wipe zone is defined over the whole frame, only the slice rows are evaluated. */
 	precalc_wipe_zone(&wipezone, wipe, x, y);
 
-	rt1 = rect1;
-	rt2 = rect2;
-	rt = out;
+	rt1 = rect1 ? rect1 + offset : NULL;
+	rt2 = rect2 ? rect2 + offset : NULL;
+	rt = out + offset;
 
 	xo = x;
-	yo = y;
-	for (y = 0; y < yo; y++) {
+	yo = start_line + total_lines;
+	for (y = start_line; y < yo; y++) {
 		for (x = 0; x < xo; x++) {
 			float check = check_zone(&wipezone, x, y, seq, facf0);
 			if (check) {
@@ -1695,21 +1694,18 @@ static void do_wipe_effect_float(Sequence *seq, float facf0, float UNUSED(facf1)
 	}
 }
 
-static ImBuf *do_wipe_effect(const SeqRenderData *context, Sequence *seq, float UNUSED(cfra), float facf0, float facf1,
-                             ImBuf *ibuf1, ImBuf *ibuf2, ImBuf *ibuf3)
+static void do_wipe_effect(const SeqRenderData *context, Sequence *seq, float UNUSED(cfra), float facf0, float facf1,
+                           ImBuf *ibuf1, ImBuf *ibuf2, ImBuf *UNUSED(ibuf3), int start_line, int total_lines,
+                           ImBuf *out)
 {
-	ImBuf *out = prepare_effect_imbufs(context, ibuf1, ibuf2, ibuf3);
-
 	if (out->rect_float) {
-		do_wipe_effect_float(seq, facf0, facf1, context->rectx, context->recty, ibuf1->rect_float,
-		                     ibuf2->rect_float, out->rect_float);
+		do_wipe_effect_float(seq, facf0, facf1, context->rectx, context->recty, start_line, total_lines,
+		                     ibuf1->rect_float, ibuf2->rect_float, out->rect_float);
 	}
 	else {
-		do_wipe_effect_byte(seq, facf0, facf1, context->rectx, context->recty, (unsigned char *) ibuf1->rect,
-		                    (unsigned char *) ibuf2->rect, (unsigned char *) out->rect);
+		do_wipe_effect_byte(seq, facf0, facf1, context->rectx, context->recty, start_line, total_lines,
+		                    (unsigned char *) ibuf1->rect, (unsigned char *) ibuf2->rect, (unsigned char *) out->rect);
 	}
-
-	return out;
 }
 
 /*********************** Transform *************************/
@@ -1847,6 +1843,131 @@ static ImBuf *do_transform_effect(const SeqRenderData *context, Sequence *seq, f
 
 /*********************** Glow *************************/
 
+/* Glow passes are split per row (or column) and run through BLI_task_parallel_range. */
+#define GLOW_THREADED_MIN_PIXELS 10000
+
+typedef struct GlowBlurData {
+	const float *map;
+	float *temp;
+	const float *filter;
+	int width, height;
+	int halfWidth;
+} GlowBlurData;
+
+static void glow_blur_rows_cb(void *userdata, const int y)
+{
+	GlowBlurData *data = userdata;
+	const float *map = data->map;
+	float *temp = data->temp;
+	const float *filter = data->filter;
+	const int width = data->width;
+	const int halfWidth = data->halfWidth;
+	int x, i, fx, index;
+	float curColor[3], curColor2[3];
+
+	/* Do the left & right strips */
+	for (x = 0; x < halfWidth; x++) {
+		index = (x + y * width) * 4;
+		fx = 0;
+		curColor[0] = curColor[1] = curColor[2] = 0.0f;
+		curColor2[0] = curColor2[1] = curColor2[2] = 0.0f;
+
+		for (i = x - halfWidth; i < x + halfWidth; i++) {
+			if ((i >= 0) && (i < width)) {
+				curColor[0] += map[(i + y * width) * 4 + GlowR] * filter[fx];
+				curColor[1] += map[(i + y * width) * 4 + GlowG] * filter[fx];
+				curColor[2] += map[(i + y * width) * 4 + GlowB] * filter[fx];
+
+				curColor2[0] += map[(width - 1 - i + y * width) * 4 + GlowR] * filter[fx];
+				curColor2[1] += map[(width - 1 - i + y * width) * 4 + GlowG] * filter[fx];
+				curColor2[2] += map[(width - 1 - i + y * width) * 4 + GlowB] * filter[fx];
+			}
+			fx++;
+		}
+		temp[index + GlowR] = curColor[0];
+		temp[index + GlowG] = curColor[1];
+		temp[index + GlowB] = curColor[2];
+
+		temp[((width - 1 - x + y * width) * 4) + GlowR] = curColor2[0];
+		temp[((width - 1 - x + y * width) * 4) + GlowG] = curColor2[1];
+		temp[((width - 1 - x + y * width) * 4) + GlowB] = curColor2[2];
+
+	}
+
+	/* Do the main body */
+	for (x = halfWidth; x < width - halfWidth; x++) {
+		index = (x + y * width) * 4;
+		fx = 0;
+		zero_v3(curColor);
+		for (i = x - halfWidth; i < x + halfWidth; i++) {
+			curColor[0] += map[(i + y * width) * 4 + GlowR] * filter[fx];
+			curColor[1] += map[(i + y * width) * 4 + GlowG] * filter[fx];
+			curColor[2] += map[(i + y * width) * 4 + GlowB] * filter[fx];
+			fx++;
+		}
+		temp[index + GlowR] = curColor[0];
+		temp[index + GlowG] = curColor[1];
+		temp[index + GlowB] = curColor[2];
+	}
+}
+
+static void glow_blur_columns_cb(void *userdata, const int x)
+{
+	GlowBlurData *data = userdata;
+	const float *map = data->map;
+	float *temp = data->temp;
+	const float *filter = data->filter;
+	const int width = data->width;
+	const int height = data->height;
+	const int halfWidth = data->halfWidth;
+	int y, i, fy, index;
+	float curColor[3], curColor2[3];
+
+	/* Do the top & bottom strips */
+	for (y = 0; y < halfWidth; y++) {
+		index = (x + y * width) * 4;
+		fy = 0;
+		zero_v3(curColor);
+		zero_v3(curColor2);
+		for (i = y - halfWidth; i < y + halfWidth; i++) {
+			if ((i >= 0) && (i < height)) {
+				/* Bottom */
+				curColor[0] += map[(x + i * width) * 4 + GlowR] * filter[fy];
+				curColor[1] += map[(x + i * width) * 4 + GlowG] * filter[fy];
+				curColor[2] += map[(x + i * width) * 4 + GlowB] * filter[fy];
+
+				/* Top */
+				curColor2[0] += map[(x + (height - 1 - i) * width) * 4 + GlowR] * filter[fy];
+				curColor2[1] += map[(x + (height - 1 - i) * width) * 4 + GlowG] * filter[fy];
+				curColor2[2] += map[(x + (height - 1 - i) * width) * 4 + GlowB] * filter[fy];
+			}
+			fy++;
+		}
+		temp[index + GlowR] = curColor[0];
+		temp[index + GlowG] = curColor[1];
+		temp[index + GlowB] = curColor[2];
+		temp[((x + (height - 1 - y) * width) * 4) + GlowR] = curColor2[0];
+		temp[((x + (height - 1 - y) * width) * 4) + GlowG] = curColor2[1];
+		temp[((x + (height - 1 - y) * width) * 4) + GlowB] = curColor2[2];
+	}
+
+	/* Do the main body */
+	for (y = halfWidth; y < height - halfWidth; y++) {
+		index = (x + y * width) * 4;
+		fy = 0;
+		zero_v3(curColor);
+		for (i = y - halfWidth; i < y + halfWidth; i++) {
+			curColor[0] += map[(x + i * width) * 4 + GlowR] * filter[fy];
+			curColor[1] += map[(x + i * width) * 4 + GlowG] * filter[fy];
+			curColor[2] += map[(x + i * width) * 4 + GlowB] * filter[fy];
+			fy++;
+		}
+		temp[index + GlowR] = curColor[0];
+		temp[index + GlowG] = curColor[1];
+		temp[index + GlowB] = curColor[2];
+	}
+}
+
 static void RVBlurBitmap2_float(float *map, int width, int height, float blur, int quality)
 /*	MUUUCCH better than the previous blur. */
 /*	We do the blurring in two passes which is a whole lot faster. */
@@ -1857,11 +1978,12 @@ static void RVBlurBitmap2_float(float *map, int width, int height, float blur, i
 /*	a small bitmap.  Avoid avoid avoid. */
 /*=============================== */
 {
-	float *temp = NULL, *swap;
+	GlowBlurData data;
+	float *temp = NULL;
 	float *filter = NULL;
-	int x, y, i, fx, fy;
-	int index, ix, halfWidth;
-	float fval, k, curColor[3], curColor2[3], weight = 0;
+	int ix, halfWidth;
+	float fval, k, weight = 0;
+	const bool use_threading = (width * height > GLOW_THREADED_MIN_PIXELS);
 
 	/* If we're not really blurring, bail out */
 	if (blur <= 0)
@@ -1902,152 +2024,117 @@ static void RVBlurBitmap2_float(float *map, int width, int height, float blur, i
 	for (ix = 0; ix < halfWidth * 2; ix++)
 		filter[ix] /= fval;
 
-	/* Blur the rows */
-	for (y = 0; y < height; y++) {
-		/* Do the left & right strips */
-		for (x = 0; x < halfWidth; x++) {
-			index = (x + y * width) * 4;
-			fx = 0;
-			curColor[0] = curColor[1] = curColor[2] = 0.0f;
-			curColor2[0] = curColor2[1] = curColor2[2] = 0.0f;
-
-			for (i = x - halfWidth; i < x + halfWidth; i++) {
-				if ((i >= 0) && (i < width)) {
-					curColor[0] += map[(i + y * width) * 4 + GlowR] * filter[fx];
-					curColor[1] += map[(i + y * width) * 4 + GlowG] * filter[fx];
-					curColor[2] += map[(i + y * width) * 4 + GlowB] * filter[fx];
-
-					curColor2[0] += map[(width - 1 - i + y * width) * 4 + GlowR] * filter[fx];
-					curColor2[1] += map[(width - 1 - i + y * width) * 4 + GlowG] * filter[fx];
-					curColor2[2] += map[(width - 1 - i + y * width) * 4 + GlowB] * filter[fx];
-				}
-				fx++;
-			}
-			temp[index + GlowR] = curColor[0];
-			temp[index + GlowG] = curColor[1];
-			temp[index + GlowB] = curColor[2];
+	data.filter = filter;
+	data.width = width;
+	data.height = height;
+	data.halfWidth = halfWidth;
 
-			temp[((width - 1 - x + y * width) * 4) + GlowR] = curColor2[0];
-			temp[((width - 1 - x + y * width) * 4) + GlowG] = curColor2[1];
-			temp[((width - 1 - x + y * width) * 4) + GlowB] = curColor2[2];
+	/* Blur the rows, map -> temp */
+	data.map = map;
+	data.temp = temp;
+	BLI_task_parallel_range(0, height, &data, glow_blur_rows_cb, use_threading);
 
-		}
+	/* Blur the columns, temp -> map */
+	data.map = temp;
+	data.temp = map;
+	BLI_task_parallel_range(0, width, &data, glow_blur_columns_cb, use_threading);
 
-		/* Do the main body */
-		for (x = halfWidth; x < width - halfWidth; x++) {
-			index = (x + y * width) * 4;
-			fx = 0;
-			zero_v3(curColor);
-			for (i = x - halfWidth; i < x + halfWidth; i++) {
-				curColor[0] += map[(i + y * width) * 4 + GlowR] * filter[fx];
-				curColor[1] += map[(i + y * width) * 4 + GlowG] * filter[fx];
-				curColor[2] += map[(i + y * width) * 4 + GlowB] * filter[fx];
-				fx++;
-			}
-			temp[index + GlowR] = curColor[0];
-			temp[index + GlowG] = curColor[1];
-			temp[index + GlowB] = curColor[2];
-		}
-	}
+	/* Tidy up	 */
+	MEM_freeN(filter);
+	MEM_freeN(temp);
+}
 
-	/* Swap buffers */
-	swap = temp; temp = map; map = swap;
+typedef struct GlowPixelsData {
+	const float *a;
+	const float *b;
+	float *c;
+	int width;
+	float threshold, boost, clamp;
+} GlowPixelsData;
+
+static void glow_add_bitmaps_cb(void *userdata, const int y)
+{
+	GlowPixelsData *data = userdata;
+	const float *a = data->a;
+	const float *b = data->b;
+	float *c = data->c;
+	const int width = data->width;
+	int x, index;
 
-	/* Blur the columns */
 	for (x = 0; x < width; x++) {
-		/* Do the top & bottom strips */
-		for (y = 0; y < halfWidth; y++) {
-			index = (x + y * width) * 4;
-			fy = 0;
-			zero_v3(curColor);
-			zero_v3(curColor2);
-			for (i = y - halfWidth; i < y + halfWidth; i++) {
-				if ((i >= 0) && (i < height)) {
-					/* Bottom */
-					curColor[0] += map[(x + i * width) * 4 + GlowR] * filter[fy];
-					curColor[1] += map[(x + i * width) * 4 + GlowG] * filter[fy];
-					curColor[2] += map[(x + i * width) * 4 + GlowB] * filter[fy];
-
-					/* Top */
-					curColor2[0] += map[(x + (height - 1 - i) * width) * 4 + GlowR] * filter[fy];
-					curColor2[1] += map[(x + (height - 1 - i) * width) * 4 + GlowG] * filter[fy];
-					curColor2[2] += map[(x + (height - 1 - i) * width) * 4 + GlowB] * filter[fy];
-				}
-				fy++;
-			}
-			temp[index + GlowR] = curColor[0];
-			temp[index + GlowG] = curColor[1];
-			temp[index + GlowB] = curColor[2];
-			temp[((x + (height - 1 - y) * width) * 4) + GlowR] = curColor2[0];
-			temp[((x + (height - 1 - y) * width) * 4) + GlowG] = curColor2[1];
-			temp[((x + (height - 1 - y) * width) * 4) + GlowB] = curColor2[2];
-		}
-	
-		/* Do the main body */
-		for (y = halfWidth; y < height - halfWidth; y++) {
-			index = (x + y * width) * 4;
-			fy = 0;
-			zero_v3(curColor);
-			for (i = y - halfWidth; i < y + halfWidth; i++) {
-				curColor[0] += map[(x + i * width) * 4 + GlowR] * filter[fy];
-				curColor[1] += map[(x + i * width) * 4 + GlowG] * filter[fy];
-				curColor[2] += map[(x + i * width) * 4 + GlowB] * filter[fy];
-				fy++;
-			}
-			temp[index + GlowR] = curColor[0];
-			temp[index + GlowG] = curColor[1];
-			temp[index + GlowB] = curColor[2];
-		}
+		index = (x + y * width) * 4;
+#ifdef __SSE2__
+		_mm_storeu_ps(&c[index], _mm_min_ps(_mm_set1_ps(1.0f), _mm_add_ps(_mm_loadu_ps(&a[index]),
+		                                                                  _mm_loadu_ps(&b[index]))));
+#else
+		c[index + GlowR] = MIN2(1.0f, a[index + GlowR] + b[index + GlowR]);
+		c[index + GlowG] = MIN2(1.0f, a[index + GlowG] + b[index + GlowG]);
+		c[index + GlowB] = MIN2(1.0f, a[index + GlowB] + b[index + GlowB]);
+		c[index + GlowA] = MIN2(1.0f, a[index + GlowA] + b[index + GlowA]);
+#endif
 	}
+}
 
-	/* Swap buffers */
-	swap = temp; temp = map; /* map = swap; */ /* UNUSED */
+static void RVAddBitmaps_float(float *a, float *b, float *c, int width, int height)
+{
+	GlowPixelsData data = {NULL};
 
-	/* Tidy up	 */
-	MEM_freeN(filter);
-	MEM_freeN(temp);
+	data.a = a;
+	data.b = b;
+	data.c = c;
+	data.width = width;
+
+	BLI_task_parallel_range(0, height, &data, glow_add_bitmaps_cb, width * height > GLOW_THREADED_MIN_PIXELS);
 }
 
-static void RVAddBitmaps_float(float *a, float *b, float *c, int width, int height)
+static void glow_isolate_highlights_cb(void *userdata, const int y)
 {
-	int x, y, index;
+	GlowPixelsData *data = userdata;
+	const float *in = data->a;
+	float *out = data->c;
+	const int width = data->width;
+	const float threshold = data->threshold, boost = data->boost, clamp = data->clamp;
+	int x, index;
+	float intensity;
 
-	for (y = 0; y < height; y++) {
-		for (x = 0; x < width; x++) {
-			index = (x + y * width) * 4;
-			c[index + GlowR] = MIN2(1.0f, a[index + GlowR] + b[index + GlowR]);
-			c[index + GlowG] = MIN2(1.0f, a[index + GlowG] + b[index + GlowG]);
-			c[index + GlowB] = MIN2(1.0f, a[index + GlowB] + b[index + GlowB]);
-			c[index + GlowA] = MIN2(1.0f, a[index + GlowA] + b[index + GlowA]);
+	for (x = 0; x < width; x++) {
+		index = (x + y * width) * 4;
+
+		/* Isolate the intensity */
+		intensity = (in[index + GlowR] + in[index + GlowG] + in[index + GlowB] - threshold);
+		if (intensity > 0) {
+#ifdef __SSE2__
+			_mm_storeu_ps(&out[index], _mm_min_ps(_mm_set1_ps(clamp),
+			                                      _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(&in[index]), _mm_set1_ps(boost)),
+			                                                 _mm_set1_ps(intensity))));
+#else
+			out[index + GlowR] = MIN2(clamp, (in[index + GlowR] * boost * intensity));
+			out[index + GlowG] = MIN2(clamp, (in[index + GlowG] * boost * intensity));
+			out[index + GlowB] = MIN2(clamp, (in[index + GlowB] * boost * intensity));
+			out[index + GlowA] = MIN2(clamp, (in[index + GlowA] * boost * intensity));
+#endif
+		}
+		else {
+			out[index + GlowR] = 0;
+			out[index + GlowG] = 0;
+			out[index + GlowB] = 0;
+			out[index + GlowA] = 0;
 		}
 	}
 }
 
 static void RVIsolateHighlights_float(float *in, float *out, int width, int height, float threshold, float boost, float clamp)
 {
-	int x, y, index;
-	float intensity;
+	GlowPixelsData data = {NULL};
 
-	for (y = 0; y < height; y++) {
-		for (x = 0; x < width; x++) {
-			index = (x + y * width) * 4;
-
-			/* Isolate the intensity */
-			intensity = (in[index + GlowR] + in[index + GlowG] + in[index + GlowB] - threshold);
-			if (intensity > 0) {
-				out[index + GlowR] = MIN2(clamp, (in[index + GlowR] * boost * intensity));
-				out[index + GlowG] = MIN2(clamp, (in[index + GlowG] * boost * intensity));
-				out[index + GlowB] = MIN2(clamp, (in[index + GlowB] * boost * intensity));
-				out[index + GlowA] = MIN2(clamp, (in[index + GlowA] * boost * intensity));
-			}
-			else {
-				out[index + GlowR] = 0;
-				out[index + GlowG] = 0;
-				out[index + GlowB] = 0;
-				out[index + GlowA] = 0;
-			}
-		}
-	}
+	data.a = in;
+	data.c = out;
+	data.width = width;
+	data.threshold = threshold;
+	data.boost = boost;
+	data.clamp = clamp;
+
+	BLI_task_parallel_range(0, height, &data, glow_isolate_highlights_cb, width * height > GLOW_THREADED_MIN_PIXELS);
 }
 
 static void init_glow_effect(Sequence *seq)
@@ -3367,13 +3454,14 @@ static struct SeqEffectHandle get_sequence_effect_impl(int seq_type)
 			rval.execute_slice = do_alphaunder_effect;
 			break;
 		case SEQ_TYPE_WIPE:
+			rval.multithreaded = true;
 			rval.init = init_wipe_effect;
 			rval.num_inputs = num_inputs_wipe;
 			rval.free = free_wipe_effect;
 			rval.copy = copy_wipe_effect;
 			rval.early_out = early_out_fade;
 			rval.get_default_fac = get_default_fac_fade;
-			rval.execute = do_wipe_effect;
+			rval.execute_slice = do_wipe_effect;
 			break;
 		case SEQ_TYPE_GLOW:
 			rval.init = init_glow_effect;
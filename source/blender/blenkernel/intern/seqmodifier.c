@@ -38,6 +38,7 @@
 #include "BLI_string.h"
 #include "BLI_utildefines.h"
 #include "BLI_math.h"
+#include "BLI_task.h"
 
 #include "BLT_translation.h"
 
@@ -783,25 +784,30 @@ static void tonemapmodifier_apply_threaded_photoreceptor(int width,
 	}
 }
 
-static void tonemapmodifier_apply(struct SequenceModifierData *smd,
-                                  ImBuf *ibuf,
-                                  ImBuf *mask)
+/* Luminance statistics of the whole frame, gathered per row in parallel. */
+typedef struct TonemapStats {
+	float lsum;
+	float lav;
+	float cav[3];
+	float maxl, minl;
+} TonemapStats;
+
+typedef struct TonemapStatsData {
+	const ImBuf *ibuf;
+	struct ColorSpace *colorspace;
+	TonemapStats *stats;
+} TonemapStatsData;
+
+static void tonemapmodifier_stats_cb_ex(void *userdata, void *userdata_chunk, const int y, const int UNUSED(threadid))
 {
-	SequencerTonemapModifierData *tmmd = (SequencerTonemapModifierData *) smd;
-	AvgLogLum data;
-	data.tmmd = tmmd;
-	data.colorspace = (ibuf->rect_float != NULL)
-	                      ? ibuf->float_colorspace
-	                      : ibuf->rect_colorspace;
-	float lsum = 0.0f;
-	int p = ibuf->x * ibuf->y;
-	float *fp = ibuf->rect_float;
-	unsigned char *cp = (unsigned char *)ibuf->rect;
-	float avl, maxl = -FLT_MAX, minl = FLT_MAX;
-	const float sc = 1.0f / p;
-	float Lav = 0.f;
-	float cav[4] = {0.0f, 0.0f, 0.0f, 0.0f};
-	while (p--) {
+	TonemapStatsData *data = userdata;
+	TonemapStats *stats = userdata_chunk;
+	const ImBuf *ibuf = data->ibuf;
+	const size_t offset = (size_t)y * ibuf->x * 4;
+	const float *fp = (ibuf->rect_float != NULL) ? ibuf->rect_float + offset : NULL;
+	const unsigned char *cp = (unsigned char *)ibuf->rect + offset;
+
+	for (int x = 0; x < ibuf->x; x++) {
 		float pixel[4];
 		if (fp != NULL) {
 			copy_v4_v4(pixel, fp);
@@ -809,13 +815,13 @@ static void tonemapmodifier_apply(struct SequenceModifierData *smd,
 		else {
 			straight_uchar_to_premul_float(pixel, cp);
 		}
-		IMB_colormanagement_colorspace_to_scene_linear_v3(pixel, data.colorspace);
+		IMB_colormanagement_colorspace_to_scene_linear_v3(pixel, data->colorspace);
 		float L = IMB_colormanagement_get_luminance(pixel);
-		Lav += L;
-		add_v3_v3(cav, pixel);
-		lsum += logf(max_ff(L, 0.0f) + 1e-5f);
-		maxl = (L > maxl) ? L : maxl;
-		minl = (L < minl) ? L : minl;
+		stats->lav += L;
+		add_v3_v3(stats->cav, pixel);
+		stats->lsum += logf(max_ff(L, 0.0f) + 1e-5f);
+		stats->maxl = (L > stats->maxl) ? L : stats->maxl;
+		stats->minl = (L < stats->minl) ? L : stats->minl;
 		if (fp != NULL) {
 			fp += 4;
 		}
@@ -823,11 +829,46 @@ static void tonemapmodifier_apply(struct SequenceModifierData *smd,
 			cp += 4;
 		}
 	}
-	data.lav = Lav * sc;
-	mul_v3_v3fl(data.cav, cav, sc);
-	maxl = logf(maxl + 1e-5f);
-	minl = logf(minl + 1e-5f);
-	avl = lsum * sc;
+}
+
+static void tonemapmodifier_stats_finalize(void *userdata, void *userdata_chunk)
+{
+	TonemapStatsData *data = userdata;
+	TonemapStats *stats = data->stats;
+	const TonemapStats *chunk_stats = userdata_chunk;
+
+	stats->lsum += chunk_stats->lsum;
+	stats->lav += chunk_stats->lav;
+	add_v3_v3(stats->cav, chunk_stats->cav);
+	stats->maxl = max_ff(stats->maxl, chunk_stats->maxl);
+	stats->minl = min_ff(stats->minl, chunk_stats->minl);
+}
+
+static void tonemapmodifier_apply(struct SequenceModifierData *smd,
+                                  ImBuf *ibuf,
+                                  ImBuf *mask)
+{
+	SequencerTonemapModifierData *tmmd = (SequencerTonemapModifierData *) smd;
+	AvgLogLum data;
+	data.tmmd = tmmd;
+	data.colorspace = (ibuf->rect_float != NULL)
+	                      ? ibuf->float_colorspace
+	                      : ibuf->rect_colorspace;
+	const int p = ibuf->x * ibuf->y;
+	float avl, maxl, minl;
+	const float sc = 1.0f / p;
+	TonemapStats stats = {0.0f, 0.0f, {0.0f, 0.0f, 0.0f}, -FLT_MAX, FLT_MAX};
+	TonemapStats chunk_stats = stats;
+	TonemapStatsData stats_data = {ibuf, data.colorspace, &stats};
+	BLI_task_parallel_range_finalize(0, ibuf->y, &stats_data, &chunk_stats, sizeof(chunk_stats),
+	                                 tonemapmodifier_stats_cb_ex, tonemapmodifier_stats_finalize,
+	                                 ibuf->y >= 64, false);
+	data.lav = stats.lav * sc;
+	mul_v3_v3fl(data.cav, stats.cav, sc);
+	data.cav[3] = 0.0f;
+	maxl = logf(stats.maxl + 1e-5f);
+	minl = logf(stats.minl + 1e-5f);
+	avl = stats.lsum * sc;
 	data.auto_key = (maxl > minl) ? ((maxl - avl) / (maxl - minl)) : 1.0f;
 	float al = expf(avl);
 	data.al = (al == 0.0f) ? 0.0f : (tmmd->key / al);
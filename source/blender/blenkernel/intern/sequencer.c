@@ -41,16 +41,20 @@
 #include "DNA_mask_types.h"
 #include "DNA_scene_types.h"
 #include "DNA_anim_types.h"
+#include "DNA_action_types.h"
 #include "DNA_object_types.h"
 #include "DNA_sound_types.h"
+#include "DNA_userdef_types.h"
 
 #include "BLI_math.h"
 #include "BLI_fileops.h"
+#include "BLI_ghash.h"
 #include "BLI_listbase.h"
 #include "BLI_linklist.h"
 #include "BLI_path_util.h"
 #include "BLI_string.h"
 #include "BLI_string_utf8.h"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 #include "BLI_utildefines.h"
 
@@ -79,12 +83,12 @@
 
 #include "RE_pipeline.h"
 
-#include <pthread.h>
-
 #include "IMB_imbuf.h"
 #include "IMB_imbuf_types.h"
 #include "IMB_colormanagement.h"
 
+#include "MEM_CacheLimiterC-Api.h"
+
 #include "BKE_context.h"
 #include "BKE_sound.h"
 
@@ -267,6 +271,9 @@ void BKE_sequence_free(Scene *scene, Sequence *seq)
 /* Function to free imbuf and anim data on changes */
 void BKE_sequence_free_anim(Sequence *seq)
 {
+	/* the render-ahead task may be reading from the movies */
+	BKE_sequencer_prefetch_stop();
+
 	while (seq->anims.last) {
 		StripAnim *sanim = seq->anims.last;
 
@@ -499,20 +506,28 @@ void BKE_sequencer_imbuf_to_sequencer_space(Scene *scene, ImBuf *ibuf, bool make
 				 * this is to to prevent data loss.
 				 */
 
-				/* when converting byte buffer to float in sequencer we need to make float
-				 * buffer be in sequencer's working space, which is currently only doable
-				 * from linear space.
+				/* Transform straight from the byte space into the sequencer's working space,
+				 * going through scene linear would transform every pixel twice. Data is
+				 * not transformed at all.
 				 */
+				if (!imb_addrectfloatImBuf(ibuf)) {
+					return;
+				}
 
-				/*
-				 * OCIO_TODO: would be nice to support direct single transform from byte to sequencer's
-				 */
+				IMB_buffer_float_from_byte(ibuf->rect_float, (unsigned char *)ibuf->rect, IB_PROFILE_SRGB, IB_PROFILE_SRGB,
+				                           false, ibuf->x, ibuf->y, ibuf->x, ibuf->x);
 
-				IMB_float_from_rect(ibuf);
-			}
-			else {
-				return;
+				if (!(ibuf->colormanage_flag & IMB_COLORMANAGE_IS_DATA) && !STREQ(byte_colorspace, to_colorspace)) {
+					IMB_colormanagement_transform_threaded(ibuf->rect_float, ibuf->x, ibuf->y, ibuf->channels,
+					                                       byte_colorspace, to_colorspace, false);
+				}
+
+				/* byte buffer is straight alpha, float should always be premul */
+				imb_freerectImBuf(ibuf);
+				IMB_premultiply_alpha(ibuf);
+				sequencer_imbuf_assign_spaces(scene, ibuf);
 			}
+			return;
 		}
 		else {
 			return;
@@ -578,6 +593,7 @@ void BKE_sequencer_new_render_data(
 	r_context->motion_blur_shutter = 0;
 	r_context->skip_cache = false;
 	r_context->is_proxy_render = false;
+	r_context->is_prefetch_render = false;
 	r_context->view_id = 0;
 	r_context->gpu_offscreen = NULL;
 	r_context->gpu_samples = (scene->r.mode & R_OSA) ? scene->r.osa : 0;
@@ -2140,21 +2156,38 @@ static void make_cb_table_float(float lift, float gain, float gamma,
 
 static void color_balance_byte_byte(StripColorBalance *cb_, unsigned char *rect, unsigned char *mask_rect, int width, int height, float mul)
 {
-	//unsigned char cb_tab[3][256];
 	unsigned char *cp = rect;
 	unsigned char *e = cp + width * 4 * height;
 	unsigned char *m = mask_rect;
 
 	StripColorBalance cb = calc_cb(cb_);
+	float cb_tab[3][256];
+	int i;
+
+	/* Opaque pixels are the common case, their premultiplied value only depends
+	 * on the channel byte so the per channel powf() can be looked up. */
+	for (i = 0; i < 256; i++) {
+		const unsigned char opaque[4] = {i, i, i, 255};
+		float p[4];
+		int c;
+
+		straight_uchar_to_premul_float(p, opaque);
+
+		for (c = 0; c < 3; c++) {
+			cb_tab[c][i] = color_balance_fl(p[c], cb.lift[c], cb.gain[c], cb.gamma[c], mul);
+		}
+	}
 
 	while (cp < e) {
 		float p[4];
 		int c;
+		const bool is_opaque = (cp[3] == 255);
 
 		straight_uchar_to_premul_float(p, cp);
 
 		for (c = 0; c < 3; c++) {
-			float t = color_balance_fl(p[c], cb.lift[c], cb.gain[c], cb.gamma[c], mul);
+			float t = is_opaque ? cb_tab[c][cp[c]] :
+			                      color_balance_fl(p[c], cb.lift[c], cb.gain[c], cb.gamma[c], mul);
 
 			if (m) {
 				float m_normal = (float) m[c] / 255.0f;
@@ -3827,6 +3860,18 @@ static ImBuf *seq_render_strip_stack(
 	return out;
 }
 
+/* the strips shown for 'chanshown', same as #BKE_sequencer_give_ibuf renders */
+static ListBase *seq_render_seqbase_get(Editing *ed, int chanshown)
+{
+	if ((chanshown < 0) && !BLI_listbase_is_empty(&ed->metastack)) {
+		int count = BLI_listbase_count(&ed->metastack);
+		count = max_ii(count + chanshown, 0);
+		return ((MetaStack *)BLI_findlink(&ed->metastack, count))->oldbasep;
+	}
+
+	return ed->seqbasep;
+}
+
 /*
  * returned ImBuf is refed!
  * you have to free after usage!
@@ -3839,14 +3884,7 @@ ImBuf *BKE_sequencer_give_ibuf(const SeqRenderData *context, float cfra, int cha
 	
 	if (ed == NULL) return NULL;
 
-	if ((chanshown < 0) && !BLI_listbase_is_empty(&ed->metastack)) {
-		int count = BLI_listbase_count(&ed->metastack);
-		count = max_ii(count + chanshown, 0);
-		seqbasep = ((MetaStack *)BLI_findlink(&ed->metastack, count))->oldbasep;
-	}
-	else {
-		seqbasep = ed->seqbasep;
-	}
+	seqbasep = seq_render_seqbase_get(ed, chanshown);
 
 	SeqRenderState state;
 	sequencer_state_init(&state);
@@ -3873,154 +3911,421 @@ ImBuf *BKE_sequencer_give_ibuf_direct(const SeqRenderData *context, float cfra,
 
 /* *********************** threading api ******************* */
 
-static ListBase running_threads;
-static ListBase prefetch_wait;
-static ListBase prefetch_done;
+/* Render-ahead: while frames are shown in the preview, the frames following
+ * them are rendered into the cache by background workers, so playback only has
+ * to fetch them.
+ *
+ * The main thread keeps editing the strips meanwhile, so every worker renders
+ * from its own copy of the shown strips, made on the main thread. Copies open
+ * their own movie handles, so workers render frames of the window in parallel.
+ * Frames are cached under the original strips, so the preview finds them.
+ * Edits stop the workers and outdate the copies (#BKE_sequencer_prefetch_stop),
+ * they're copied again when playback continues. */
+
+/* Part of the cache memory limit frames rendered ahead may use. */
+#define SEQ_PREFETCH_MEM_FRACTION 2
+/* Effects already split each frame over threads, a few workers are enough. */
+#define SEQ_PREFETCH_WORKERS_MAX 4
+
+typedef struct SeqPrefetchWorker {
+	ListBase seqbase;  /* copy of the shown strips */
+} SeqPrefetchWorker;
+
+typedef struct SeqPrefetch {
+	TaskPool *pool;
+	ThreadMutex mutex;
+
+	/* settings of the frames rendered ahead, copied from the preview */
+	SeqRenderData context;
+	int chanshown;
 
-static pthread_mutex_t queue_lock          = PTHREAD_MUTEX_INITIALIZER;
-static pthread_mutex_t wakeup_lock         = PTHREAD_MUTEX_INITIALIZER;
-static pthread_cond_t wakeup_cond          = PTHREAD_COND_INITIALIZER;
+	/* copies of the strips, only changed on the main thread while no worker runs */
+	SeqPrefetchWorker workers[SEQ_PREFETCH_WORKERS_MAX];
+	int tot_workers;
+	ListBase *seqbasep;  /* original strips that were copied */
+	GHash *seq_orig;     /* copied strip -> original strip, for cache keys */
+	bool copy_outdated;  /* strips were edited since copying */
 
-//static pthread_mutex_t prefetch_ready_lock = PTHREAD_MUTEX_INITIALIZER;
-//static pthread_cond_t  prefetch_ready_cond = PTHREAD_COND_INITIALIZER;
+	float cfra;       /* frame shown in the preview */
+	float next_cfra;  /* next frame to render ahead */
+	size_t mem_frame; /* size of the last frame rendered ahead */
+	int tot_running;  /* workers pushed to the pool */
+} SeqPrefetch;
 
-static pthread_mutex_t frame_done_lock     = PTHREAD_MUTEX_INITIALIZER;
-static pthread_cond_t frame_done_cond      = PTHREAD_COND_INITIALIZER;
+static SeqPrefetch *seq_prefetch = NULL;
 
-static volatile bool seq_thread_shutdown = true; 
-static volatile int seq_last_given_monoton_cfra = 0;
-static int monoton_cfra = 0;
+static bool seq_prefetch_context_equals(const SeqRenderData *a, const SeqRenderData *b)
+{
+	return ((a->bmain == b->bmain) &&
+	        (a->scene == b->scene) &&
+	        (a->rectx == b->rectx) &&
+	        (a->recty == b->recty) &&
+	        (a->preview_render_size == b->preview_render_size) &&
+	        (a->view_id == b->view_id));
+}
 
-typedef struct PrefetchThread {
-	struct PrefetchThread *next, *prev;
-	
-	Scene *scene;
-	struct PrefetchQueueElem *current;
-	pthread_t pthread;
-	int running;
-	
-} PrefetchThread;
+/* Scene strips need the main thread to render, movie clip and mask strips use
+ * data-blocks the main thread edits, and animated strip properties are only
+ * evaluated for the current frame, none of them can be rendered ahead. */
+static bool seq_prefetch_is_supported(Scene *scene)
+{
+	Editing *ed = BKE_sequencer_editing_get(scene, false);
+	Sequence *seq;
+	bool supported = true;
 
-typedef struct PrefetchQueueElem {
-	struct PrefetchQueueElem *next, *prev;
-	
-	int rectx;
-	int recty;
-	float cfra;
-	int chanshown;
-	int preview_render_size;
+	if (ed == NULL || G.is_rendering) {
+		return false;
+	}
 
-	int monoton_cfra;
+	SEQ_BEGIN (ed, seq)
+	{
+		if (ELEM(seq->type, SEQ_TYPE_SCENE, SEQ_TYPE_MOVIECLIP, SEQ_TYPE_MASK)) {
+			supported = false;
+		}
+	}
+	SEQ_END
 
-	ImBuf *ibuf;
-} PrefetchQueueElem;
+	if (supported && scene->adt) {
+		FCurve *fcu;
+
+		if (scene->adt->action) {
+			for (fcu = scene->adt->action->curves.first; fcu; fcu = fcu->next) {
+				if (fcu->rna_path && STRPREFIX(fcu->rna_path, "sequence_editor")) {
+					return false;
+				}
+			}
+		}
+
+		for (fcu = scene->adt->drivers.first; fcu; fcu = fcu->next) {
+			if (fcu->rna_path && STRPREFIX(fcu->rna_path, "sequence_editor")) {
+				return false;
+			}
+		}
+	}
+
+	return supported;
+}
+
+static void seq_prefetch_tmp_backup(ListBase *seqbase, GHash *backup)
+{
+	Sequence *seq;
+
+	for (seq = seqbase->first; seq; seq = seq->next) {
+		BLI_ghash_insert(backup, seq, seq->tmp);
+		if (seq->type == SEQ_TYPE_META) {
+			seq_prefetch_tmp_backup(&seq->seqbase, backup);
+		}
+	}
+}
+
+/* after duplicating, 'tmp' of the original strips points to their copy */
+static void seq_prefetch_copy_map(Scene *scene, ListBase *seqbase, GHash *seq_orig)
+{
+	Sequence *seq;
+
+	for (seq = seqbase->first; seq; seq = seq->next) {
+		Sequence *seq_copy = seq->tmp;
 
-void BKE_sequencer_give_ibuf_prefetch_request(const SeqRenderData *context, float cfra, int chanshown)
+		BLI_ghash_insert(seq_orig, seq_copy, seq);
+
+		/* copies aren't played back */
+		if (seq_copy->scene_sound && ELEM(seq_copy->type, SEQ_TYPE_SOUND_RAM, SEQ_TYPE_SCENE)) {
+			BKE_sound_remove_scene_sound(scene, seq_copy->scene_sound);
+		}
+		seq_copy->scene_sound = NULL;
+		if (seq_copy->sound) {
+			id_us_min(&seq_copy->sound->id);
+			seq_copy->sound = NULL;
+		}
+
+		if (seq->type == SEQ_TYPE_META) {
+			seq_prefetch_copy_map(scene, &seq->seqbase, seq_orig);
+		}
+	}
+}
+
+/* call with no worker running */
+static void seq_prefetch_copy_free(SeqPrefetch *prefetch)
 {
-	PrefetchQueueElem *e;
-	if (seq_thread_shutdown) {
+	int i;
+
+	for (i = 0; i < prefetch->tot_workers; i++) {
+		SeqPrefetchWorker *worker = &prefetch->workers[i];
+		Sequence *seq, *seq_next;
+
+		for (seq = worker->seqbase.first; seq; seq = seq_next) {
+			seq_next = seq->next;
+			seq_free_sequence_recurse(NULL, seq);
+		}
+		BLI_listbase_clear(&worker->seqbase);
+	}
+
+	if (prefetch->seq_orig) {
+		BLI_ghash_free(prefetch->seq_orig, NULL, NULL);
+		prefetch->seq_orig = NULL;
+	}
+
+	prefetch->tot_workers = 0;
+	prefetch->seqbasep = NULL;
+}
+
+/* call on the main thread with no worker running */
+static void seq_prefetch_copy_ensure(SeqPrefetch *prefetch, Scene *scene, ListBase *seqbasep)
+{
+	GHash *tmp_backup;
+	GHashIterator gh_iter;
+	int i;
+
+	if (!prefetch->copy_outdated && prefetch->seqbasep == seqbasep) {
 		return;
 	}
 
-	e = MEM_callocN(sizeof(PrefetchQueueElem), "prefetch_queue_elem");
-	e->rectx = context->rectx;
-	e->recty = context->recty;
-	e->cfra = cfra;
-	e->chanshown = chanshown;
-	e->preview_render_size = context->preview_render_size;
-	e->monoton_cfra = monoton_cfra++;
+	/* frees the copies' movies, which stops the (already stopped) workers again */
+	seq_prefetch_copy_free(prefetch);
 
-	pthread_mutex_lock(&queue_lock);
-	BLI_addtail(&prefetch_wait, e);
-	pthread_mutex_unlock(&queue_lock);
-	
-	pthread_mutex_lock(&wakeup_lock);
-	pthread_cond_signal(&wakeup_cond);
-	pthread_mutex_unlock(&wakeup_lock);
+	prefetch->tot_workers = min_iii(max_ii(BLI_system_thread_count() / 2, 1),
+	                                U.prefetchframes,
+	                                SEQ_PREFETCH_WORKERS_MAX);
+	prefetch->seqbasep = seqbasep;
+	prefetch->seq_orig = BLI_ghash_ptr_new(__func__);
+
+	/* duplicating uses 'tmp' of the original strips, which transform uses too */
+	tmp_backup = BLI_ghash_ptr_new(__func__);
+	seq_prefetch_tmp_backup(seqbasep, tmp_backup);
+
+	for (i = 0; i < prefetch->tot_workers; i++) {
+		BKE_sequence_base_dupli_recursive(scene, scene, &prefetch->workers[i].seqbase, seqbasep, SEQ_DUPE_ALL);
+		seq_prefetch_copy_map(scene, seqbasep, prefetch->seq_orig);
+	}
+
+	GHASH_ITER (gh_iter, tmp_backup) {
+		Sequence *seq = BLI_ghashIterator_getKey(&gh_iter);
+		seq->tmp = BLI_ghashIterator_getValue(&gh_iter);
+	}
+	BLI_ghash_free(tmp_backup, NULL, NULL);
+
+	prefetch->copy_outdated = false;
 }
 
-ImBuf *BKE_sequencer_give_ibuf_threaded(const SeqRenderData *context, float cfra, int chanshown)
+/**
+ * Frames rendered ahead are cached under the original strips, get the original of a copied strip.
+ * Only called while rendering ahead, when the copies don't change.
+ */
+Sequence *BKE_sequencer_prefetch_original_get(Sequence *seq)
 {
-	PrefetchQueueElem *e = NULL;
-	bool found_something = false;
+	SeqPrefetch *prefetch = seq_prefetch;
+	Sequence *seq_orig = NULL;
 
-	if (seq_thread_shutdown) {
-		return BKE_sequencer_give_ibuf(context, cfra, chanshown);
+	if (prefetch && prefetch->seq_orig) {
+		seq_orig = BLI_ghash_lookup(prefetch->seq_orig, seq);
 	}
 
-	while (!e) {
-		bool success = false;
-		pthread_mutex_lock(&queue_lock);
+	return seq_orig ? seq_orig : seq;
+}
 
-		for (e = prefetch_done.first; e; e = e->next) {
-			if (cfra == e->cfra &&
-			    chanshown == e->chanshown &&
-			    context->rectx == e->rectx &&
-			    context->recty == e->recty &&
-			    context->preview_render_size == e->preview_render_size)
-			{
-				success = true;
-				found_something = true;
-				break;
-			}
-		}
+static size_t seq_prefetch_imbuf_size(const ImBuf *ibuf)
+{
+	const size_t tot_pixels = (size_t)ibuf->x * (size_t)ibuf->y;
+	size_t size = 0;
 
-		if (!e) {
-			for (e = prefetch_wait.first; e; e = e->next) {
-				if (cfra == e->cfra &&
-				    chanshown == e->chanshown &&
-				    context->rectx == e->rectx &&
-				    context->recty == e->recty &&
-				    context->preview_render_size == e->preview_render_size)
-				{
-					found_something = true;
-					break;
-				}
-			}
-		}
+	if (ibuf->rect)
+		size += tot_pixels * sizeof(unsigned int);
+	if (ibuf->rect_float)
+		size += tot_pixels * ibuf->channels * sizeof(float);
 
-		if (!e) {
-			PrefetchThread *tslot;
+	return size;
+}
 
-			for (tslot = running_threads.first;
-			     tslot;
-			     tslot = tslot->next)
-			{
-				if (tslot->current &&
-				    cfra == tslot->current->cfra &&
-				    chanshown == tslot->current->chanshown &&
-				    context->rectx == tslot->current->rectx &&
-				    context->recty == tslot->current->recty &&
-				    context->preview_render_size == tslot->current->preview_render_size)
-				{
-					found_something = true;
-					break;
-				}
-			}
+static void seq_prefetch_render_task(TaskPool *__restrict pool, void *taskdata, int UNUSED(threadid))
+{
+	SeqPrefetch *prefetch = BLI_task_pool_userdata(pool);
+	SeqPrefetchWorker *worker = taskdata;
+	const size_t mem_limit = MEM_CacheLimiter_get_maximum() / SEQ_PREFETCH_MEM_FRACTION;
+
+	while (true) {
+		SeqRenderData context;
+		SeqRenderState state;
+		ImBuf *ibuf;
+		float cfra;
+		int chanshown, tot_ahead;
+
+		BLI_mutex_lock(&prefetch->mutex);
+
+		tot_ahead = (int)(prefetch->next_cfra - prefetch->cfra);
+
+		if (BLI_task_pool_canceled(pool) ||
+		    tot_ahead > U.prefetchframes ||
+		    (size_t)tot_ahead * prefetch->mem_frame > mem_limit)
+		{
+			prefetch->tot_running--;
+			BLI_mutex_unlock(&prefetch->mutex);
+			break;
 		}
 
-		/* e->ibuf is unrefed by render thread on next round. */
+		context = prefetch->context;
+		chanshown = prefetch->chanshown;
+		cfra = prefetch->next_cfra;
+		prefetch->next_cfra += 1.0f;
+
+		BLI_mutex_unlock(&prefetch->mutex);
 
-		if (e) {
-			seq_last_given_monoton_cfra = e->monoton_cfra;
+		/* frames which are already cached are only looked up */
+		sequencer_state_init(&state);
+		ibuf = seq_render_strip_stack(&context, &state, &worker->seqbase, cfra, chanshown);
+
+		if (ibuf) {
+			BLI_mutex_lock(&prefetch->mutex);
+			prefetch->mem_frame = seq_prefetch_imbuf_size(ibuf);
+			BLI_mutex_unlock(&prefetch->mutex);
+
+			IMB_freeImBuf(ibuf);
 		}
+	}
+}
 
-		pthread_mutex_unlock(&queue_lock);
+/* Look up a frame in the cache, without rendering anything. */
+static ImBuf *seq_prefetch_cache_get(const SeqRenderData *context, float cfra, int chanshown)
+{
+	Editing *ed = BKE_sequencer_editing_get(context->scene, false);
+	Sequence *seq_arr[MAXSEQ + 1];
+	int count;
 
-		if (!success) {
-			e = NULL;
+	if (ed == NULL) {
+		return NULL;
+	}
 
-			if (!found_something) {
-				fprintf(stderr, "SEQ-THREAD: Requested frame not in queue ???\n");
-				break;
-			}
-			pthread_mutex_lock(&frame_done_lock);
-			pthread_cond_wait(&frame_done_cond, &frame_done_lock);
-			pthread_mutex_unlock(&frame_done_lock);
+	count = get_shown_sequences(seq_render_seqbase_get(ed, chanshown), cfra, chanshown, seq_arr);
+
+	if (count == 0) {
+		return NULL;
+	}
+
+	return BKE_sequencer_cache_get(context, seq_arr[count - 1], cfra, SEQ_STRIPELEM_IBUF_COMP);
+}
+
+/* waits for the workers, keeping the copies of the strips */
+static void seq_prefetch_cancel(SeqPrefetch *prefetch)
+{
+	BLI_task_pool_cancel(prefetch->pool);
+	/* workers which didn't start yet are removed from the pool */
+	prefetch->tot_running = 0;
+}
+
+static void seq_prefetch_update(const SeqRenderData *context, float cfra, int chanshown)
+{
+	SeqPrefetch *prefetch = seq_prefetch;
+	ListBase *seqbasep;
+	bool restart;
+	int i;
+
+	if (!seq_prefetch_is_supported(context->scene)) {
+		BKE_sequencer_prefetch_stop();
+		return;
+	}
+
+	seqbasep = seq_render_seqbase_get(context->scene->ed, chanshown);
+
+	if (prefetch == NULL) {
+		prefetch = seq_prefetch = MEM_callocN(sizeof(SeqPrefetch), "SeqPrefetch");
+		prefetch->pool = BLI_task_pool_create_background(BLI_task_scheduler_get(), prefetch);
+		BLI_mutex_init(&prefetch->mutex);
+		prefetch->cfra = cfra;
+		prefetch->next_cfra = cfra + 1.0f;
+		prefetch->context = *context;
+		prefetch->context.is_prefetch_render = true;
+		prefetch->chanshown = chanshown;
+		prefetch->copy_outdated = true;
+	}
+
+	/* restart from the shown frame when the settings or strips changed, or the frame jumped */
+	BLI_mutex_lock(&prefetch->mutex);
+	restart = (!seq_prefetch_context_equals(&prefetch->context, context) ||
+	           prefetch->chanshown != chanshown ||
+	           prefetch->seqbasep != seqbasep ||
+	           prefetch->copy_outdated ||
+	           cfra < prefetch->cfra ||
+	           cfra > prefetch->next_cfra);
+	BLI_mutex_unlock(&prefetch->mutex);
+
+	if (restart) {
+		seq_prefetch_cancel(prefetch);
+		seq_prefetch_copy_ensure(prefetch, context->scene, seqbasep);
+
+		prefetch->next_cfra = cfra + 1.0f;
+		prefetch->context = *context;
+		prefetch->context.is_prefetch_render = true;
+		prefetch->chanshown = chanshown;
+	}
+
+	BLI_mutex_lock(&prefetch->mutex);
+
+	prefetch->cfra = cfra;
+
+	if (prefetch->next_cfra <= cfra) {
+		prefetch->next_cfra = cfra + 1.0f;
+	}
+
+	if (prefetch->tot_running == 0) {
+		prefetch->tot_running = prefetch->tot_workers;
+		for (i = 0; i < prefetch->tot_workers; i++) {
+			BLI_task_pool_push(prefetch->pool, seq_prefetch_render_task, &prefetch->workers[i],
+			                   false, TASK_PRIORITY_LOW);
 		}
 	}
-	
-	return e ? e->ibuf : NULL;
+
+	BLI_mutex_unlock(&prefetch->mutex);
+}
+
+/**
+ * Stop rendering ahead, before the strips change. The workers' copies of the strips
+ * are outdated and copied again when rendering ahead continues.
+ */
+void BKE_sequencer_prefetch_stop(void)
+{
+	SeqPrefetch *prefetch = seq_prefetch;
+
+	if (prefetch) {
+		/* waits for the frames being rendered */
+		seq_prefetch_cancel(prefetch);
+		prefetch->copy_outdated = true;
+	}
+}
+
+void BKE_sequencer_prefetch_free(void)
+{
+	SeqPrefetch *prefetch = seq_prefetch;
+
+	if (prefetch) {
+		seq_prefetch_cancel(prefetch);
+		seq_prefetch_copy_free(prefetch);
+		BLI_task_pool_free(prefetch->pool);
+		BLI_mutex_end(&prefetch->mutex);
+		MEM_freeN(prefetch);
+
+		seq_prefetch = NULL;
+	}
+}
+
+ImBuf *BKE_sequencer_give_ibuf_threaded(const SeqRenderData *context, float cfra, int chanshown)
+{
+	ImBuf *ibuf;
+
+	BLI_assert(BLI_thread_is_main());
+
+	if (U.prefetchframes <= 0) {
+		return BKE_sequencer_give_ibuf(context, cfra, chanshown);
+	}
+
+	ibuf = seq_prefetch_cache_get(context, cfra, chanshown);
+
+	if (ibuf == NULL) {
+		/* the workers render from their own copies, they keep running meanwhile */
+		ibuf = BKE_sequencer_give_ibuf(context, cfra, chanshown);
+	}
+
+	seq_prefetch_update(context, cfra, chanshown);
+
+	return ibuf;
 }
 
 /* check whether sequence cur depends on seq */
@@ -4072,6 +4377,9 @@ static void sequence_invalidate_cache(Scene *scene, Sequence *seq, bool invalida
 {
 	Editing *ed = scene->ed;
 
+	/* frames rendered ahead with the old settings are being invalidated */
+	BKE_sequencer_prefetch_stop();
+
 	/* invalidate cache for current sequence */
 	if (invalidate_self) {
 		/* Animation structure holds some buffers inside,
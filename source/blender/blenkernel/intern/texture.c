@@ -41,6 +41,7 @@
 #include "BLI_kdopbvh.h"
 #include "BLI_utildefines.h"
 #include "BLI_math_color.h"
+#include "BLI_string.h"
 
 #include "DNA_key_types.h"
 #include "DNA_object_types.h"
@@ -73,6 +74,10 @@
 
 #include "RE_shader_ext.h"
 
+#ifdef WITH_OPENVDB
+#  include "openvdb_capi.h"
+#endif
+
 /* ****************** Mapping ******************* */
 
 TexMapping *BKE_texture_mapping_add(int type)
@@ -1381,6 +1386,12 @@ void BKE_texture_voxeldata_free_data(VoxelData *vd)
 		vd->dataset = NULL;
 	}
 
+#ifdef WITH_OPENVDB
+	if (vd->grid) {
+		OpenVDB_sparse_grid_free(vd->grid);
+		vd->grid = NULL;
+	}
+#endif
 }
  
 void BKE_texture_voxeldata_free(VoxelData *vd)
@@ -1403,6 +1414,7 @@ VoxelData *BKE_texture_voxeldata_add(void)
 	vd->object = NULL;
 	vd->cachedframe = -1;
 	vd->ok = 0;
+	BLI_strncpy(vd->grid_name, "density", sizeof(vd->grid_name));
 	
 	return vd;
 }
@@ -1413,10 +1425,29 @@ VoxelData *BKE_texture_voxeldata_copy(VoxelData *vd)
 
 	vdn = MEM_dupallocN(vd);
 	vdn->dataset = NULL;
+	vdn->grid = NULL;
 
 	return vdn;
 }
 
+/* Memory used by the loaded data set, sparse grids only keep their active voxels and tiles. */
+size_t BKE_texture_voxeldata_memory(const VoxelData *vd)
+{
+	size_t memory = 0;
+
+	if (vd->dataset) {
+		memory += MEM_allocN_len(vd->dataset);
+	}
+
+#ifdef WITH_OPENVDB
+	if (vd->grid) {
+		memory += OpenVDB_sparse_grid_memory(vd->grid, NULL);
+	}
+#endif
+
+	return memory;
+}
+
 /* ------------------------------------------------------------------------- */
 
 OceanTex *BKE_texture_ocean_add(void)
@@ -114,6 +114,8 @@ void  *BLI_gzopen(const char *filename, const char *mode) ATTR_WARN_UNUSED_RESUL
 int    BLI_open(const char *filename, int oflag, int pmode) ATTR_WARN_UNUSED_RESULT ATTR_NONNULL();
 int    BLI_access(const char *filename, int mode) ATTR_WARN_UNUSED_RESULT ATTR_NONNULL();
 
+int    BLI_fseek(FILE *stream, int64_t offset, int whence) ATTR_NONNULL();
+
 bool   BLI_file_is_writable(const char *file) ATTR_WARN_UNUSED_RESULT ATTR_NONNULL();
 bool   BLI_file_touch(const char *file) ATTR_NONNULL();
 
@@ -159,6 +159,20 @@ char *BLI_file_ungzip_to_mem(const char *from_file, int *r_size)
 	return mem;
 }
 
+/**
+ * fseek with a 64 bit offset, long is 32 bit on Windows.
+ *
+ * \return zero on success (matching 'fseek' behavior).
+ */
+int BLI_fseek(FILE *stream, int64_t offset, int whence)
+{
+#ifdef WIN32
+	return _fseeki64(stream, offset, whence);
+#else
+	return fseeko(stream, (off_t)offset, whence);
+#endif
+}
+
 /**
  * Returns true if the file with the specified name can be written.
  * This implementation uses access(2), which makes the check according
@@ -88,6 +88,17 @@ struct LinkNode *BLO_blendhandle_get_linkable_groups(BlendHandle *bh);
 
 void BLO_blendhandle_close(BlendHandle *bh);
 
+typedef struct BlendFileIndex BlendFileIndex;
+
+BlendFileIndex *BLO_blendfile_index_get(const char *filepath, struct ReportList *reports);
+
+struct LinkNode *BLO_blendfile_index_get_datablock_names(BlendFileIndex *index, int ofblocktype, int *tot_names);
+struct LinkNode *BLO_blendfile_index_get_previews(BlendFileIndex *index, int ofblocktype, int *tot_prev);
+struct LinkNode *BLO_blendfile_index_get_linkable_groups(BlendFileIndex *index);
+
+void BLO_blendfile_index_release(BlendFileIndex *index);
+void BLO_blendfile_index_cache_free(void);
+
 /***/
 
 #define BLO_GROUP_MAX 32
@@ -52,6 +52,10 @@ extern void memfile_chunk_add(MemFile *compare, MemFile *current, const char *bu
 /* exports */
 extern void BLO_memfile_free(MemFile *memfile);
 extern void BLO_memfile_merge(MemFile *first, MemFile *second);
+extern void BLO_memfile_copy(MemFile *dst, const MemFile *src);
+extern bool BLO_memfile_write_file(
+        MemFile *memfile, const char *filename, const bool use_compress,
+        const short *stop, float *progress, char *r_error, const size_t error_maxncpy);
 
 #endif
 
@@ -41,17 +41,21 @@
 #include "MEM_guardedalloc.h"
 
 #include "BLI_utildefines.h"
+#include "BLI_fileops.h"
 #include "BLI_path_util.h"
 #include "BLI_ghash.h"
 #include "BLI_linklist.h"
 #include "BLI_listbase.h"
 #include "BLI_string.h"
+#include "BLI_threads.h"
 
 #include "DNA_genfile.h"
 #include "DNA_sdna_types.h"
+#include "DNA_userdef_types.h"
 
 
 #include "BKE_main.h"
+#include "BKE_icons.h"
 #include "BKE_library.h" // for BKE_main_free
 #include "BKE_idcode.h"
 
@@ -83,7 +87,7 @@ BlendHandle *BLO_blendhandle_from_file(const char *filepath, ReportList *reports
 {
 	BlendHandle *bh;
 
-	bh = (BlendHandle *)blo_openblenderfile(filepath, reports);
+	bh = (BlendHandle *)blo_openblenderfile_library(filepath, reports);
 
 	return bh;
 }
@@ -210,13 +214,13 @@ LinkNode *BLO_blendhandle_get_previews(BlendHandle *bh, int ofblocktype, int *to
 					if (prv) {
 						memcpy(new_prv, prv, sizeof(PreviewImage));
 						if (prv->rect[0] && prv->w[0] && prv->h[0]) {
-							unsigned int *rect = NULL;
 							size_t len = new_prv->w[0] * new_prv->h[0] * sizeof(unsigned int);
 							new_prv->rect[0] = MEM_callocN(len, __func__);
 							bhead = blo_nextbhead(fd, bhead);
-							rect = (unsigned int *)(bhead + 1);
 							BLI_assert(len == bhead->len);
-							memcpy(new_prv->rect[0], rect, len);
+							if (len == bhead->len) {
+								blo_bhead_read_data(fd, bhead, new_prv->rect[0]);
+							}
 						}
 						else {
 							/* This should not be needed, but can happen in 'broken' .blend files,
@@ -227,13 +231,13 @@ LinkNode *BLO_blendhandle_get_previews(BlendHandle *bh, int ofblocktype, int *to
 						}
 						
 						if (prv->rect[1] && prv->w[1] && prv->h[1]) {
-							unsigned int *rect = NULL;
 							size_t len = new_prv->w[1] * new_prv->h[1] * sizeof(unsigned int);
 							new_prv->rect[1] = MEM_callocN(len, __func__);
 							bhead = blo_nextbhead(fd, bhead);
-							rect = (unsigned int *)(bhead + 1);
 							BLI_assert(len == bhead->len);
-							memcpy(new_prv->rect[1], rect, len);
+							if (len == bhead->len) {
+								blo_bhead_read_data(fd, bhead, new_prv->rect[1]);
+							}
 						}
 						else {
 							/* This should not be needed, but can happen in 'broken' .blend files,
@@ -307,6 +311,622 @@ void BLO_blendhandle_close(BlendHandle *bh)
 	blo_freefiledata(fd);
 }
 
+/* -------------------------------------------------------------------- */
+
+/** \name Blend File Index
+ *
+ * Listing the ID's of a file (names, types and previews) with a #BlendHandle means scanning
+ * the whole file, which is slow for big libraries browsed over and over.
+ *
+ * The indices of the last listed files are kept in memory, so the thumbnail threads that request
+ * the previews of a library ID by ID only scan it once. When enabled in the user preferences
+ * (#USER_BLENDFILE_INDEX) the index is also stored in a hidden sidecar file next to the blend file,
+ * reused as long as the blend file's modification time and size are unchanged. The sidecar also
+ * stores the file offset and the dependencies of every ID.
+ *
+ * \{ */
+
+#define BLENDFILE_INDEX_MAGIC "BLENDIDX"
+#define BLENDFILE_INDEX_VERSION 2
+/* sanity check on preview sizes read from the sidecar */
+#define BLENDFILE_INDEX_PREVIEW_SIZE_MAX 4096
+/* number of indices kept in memory */
+#define BLENDFILE_INDEX_CACHE_SIZE 4
+
+typedef struct BlendFileIndexEntry {
+	int idcode;
+	char name[MAX_ID_NAME - 2];
+	PreviewImage *preview;  /* NULL for types without previews */
+	/* offset of the ID block's data in the blend file, -1 when unknown (compressed files) */
+	int64_t file_offset;
+	/* indices of the entries of the ID's this ID uses, deps_num is -1 when they're unknown */
+	int *deps;
+	int deps_num;
+} BlendFileIndexEntry;
+
+struct BlendFileIndex {
+	BlendFileIndexEntry *entries;
+	int entries_num;
+
+	/* of the indexed blend file, to validate the in memory cache */
+	char filepath[FILE_MAX];
+	int64_t mtime;
+	int64_t size;
+	/* the cache and every BLO_blendfile_index_get caller own a user */
+	int users;
+};
+
+typedef struct BlendFileIndexHeader {
+	char magic[8];
+	int version;
+	int entries_num;
+	/* of the indexed blend file */
+	int64_t mtime;
+	int64_t size;
+} BlendFileIndexHeader;
+
+static BlendFileIndex *blendfile_index_cache[BLENDFILE_INDEX_CACHE_SIZE] = {NULL};
+static ThreadMutex blendfile_index_cache_lock = BLI_MUTEX_INITIALIZER;
+
+static void blendfile_index_sidecar_path(const char *filepath, char *r_path)
+{
+	char dir[FILE_MAX], file[FILE_MAXFILE];
+
+	/* hidden, so it doesn't clutter the file browser */
+	BLI_split_dirfile(filepath, dir, file, sizeof(dir), sizeof(file));
+	BLI_snprintf(file, sizeof(file), ".%s.blidx", BLI_path_basename(filepath));
+	BLI_join_dirfile(r_path, FILE_MAX, dir, file);
+}
+
+static void blendfile_index_entry_key(int idcode, const char *name, char r_key[MAX_ID_NAME])
+{
+	/* same layout as ID.name, so bhead_id_name() can be used as key */
+	*((short *)r_key) = (short)idcode;
+	BLI_strncpy(r_key + 2, name, MAX_ID_NAME - 2);
+}
+
+static void blendfile_index_entry_add_dependency(BlendFileIndexEntry *entry, int dep, int *r_deps_len)
+{
+	int i;
+
+	for (i = 0; i < entry->deps_num; i++) {
+		if (entry->deps[i] == dep) {
+			return;
+		}
+	}
+
+	if (entry->deps_num == *r_deps_len) {
+		*r_deps_len = (*r_deps_len) ? *r_deps_len * 2 : 4;
+		entry->deps = MEM_reallocN(entry->deps, sizeof(*entry->deps) * (size_t)*r_deps_len);
+	}
+	entry->deps[entry->deps_num++] = dep;
+}
+
+/**
+ * Find the file offsets of the indexed ID's, and optionally their dependencies.
+ *
+ * Dependencies are found without reconstructing the data: every pointer sized word in the blocks of
+ * an ID that equals the old address of another ID is a reference to it. Old addresses are only
+ * comparable when the file has the pointer size and endianness of this platform.
+ */
+static void blendfile_index_scan_blocks(FileData *fd, BlendFileIndex *index, const bool find_dependencies)
+{
+	GHash *entry_by_name = BLI_ghash_str_new(__func__);
+	GHash *entry_by_old = BLI_ghash_ptr_new(__func__);
+	const bool use_old_addresses = find_dependencies &&
+	                               !(fd->flags & (FD_FLAGS_SWITCH_ENDIAN | FD_FLAGS_POINTSIZE_DIFFERS));
+	BlendFileIndexEntry *current = NULL;
+	int current_deps_len = 0;
+	void *buf = NULL;
+	size_t buf_len = 0;
+	BHead *bhead;
+	int i;
+
+	for (i = 0; i < index->entries_num; i++) {
+		BlendFileIndexEntry *entry = &index->entries[i];
+		char *key = MEM_mallocN(MAX_ID_NAME, __func__);
+
+		blendfile_index_entry_key(entry->idcode, entry->name, key);
+		BLI_ghash_reinsert(entry_by_name, key, entry, MEM_freeN, NULL);
+		entry->file_offset = -1;
+		entry->deps_num = use_old_addresses ? 0 : -1;
+	}
+
+	for (bhead = blo_firstbhead(fd); bhead; bhead = blo_nextbhead(fd, bhead)) {
+		if (bhead->code == ENDB) {
+			break;
+		}
+		if (BKE_idcode_is_valid(bhead->code)) {
+			BlendFileIndexEntry *entry = BLI_ghash_lookup(entry_by_name, bhead_id_name(fd, bhead));
+
+			if (entry) {
+#ifdef USE_BHEAD_READ_ON_DEMAND
+				if (fd->seek_fn) {
+					entry->file_offset = BHEADN_FROM_BHEAD(bhead)->file_offset;
+				}
+#endif
+				BLI_ghash_insert(entry_by_old, (void *)bhead->old, entry);
+			}
+		}
+	}
+
+	if (use_old_addresses) {
+		for (bhead = blo_firstbhead(fd); bhead; bhead = blo_nextbhead(fd, bhead)) {
+			if (bhead->code == ENDB) {
+				break;
+			}
+			if (BKE_idcode_is_valid(bhead->code)) {
+				/* the DATA blocks that follow an ID block belong to it */
+				current = BLI_ghash_lookup(entry_by_old, (void *)bhead->old);
+				current_deps_len = 0;
+			}
+			else if (!ELEM(bhead->code, DATA)) {
+				current = NULL;
+			}
+
+			if (current && bhead->len >= (int)sizeof(void *)) {
+				const size_t words_num = (size_t)bhead->len / sizeof(void *);
+				size_t w;
+
+				if ((size_t)bhead->len > buf_len) {
+					buf_len = (size_t)bhead->len;
+					MEM_SAFE_FREE(buf);
+					buf = MEM_mallocN(buf_len, __func__);
+				}
+				if (!blo_bhead_read_data(fd, bhead, buf)) {
+					break;
+				}
+
+				for (w = 0; w < words_num; w++) {
+					void *old = ((void **)buf)[w];
+					BlendFileIndexEntry *dep = old ? BLI_ghash_lookup(entry_by_old, old) : NULL;
+
+					if (dep && dep != current) {
+						blendfile_index_entry_add_dependency(current, (int)(dep - index->entries), &current_deps_len);
+					}
+				}
+			}
+		}
+	}
+
+	MEM_SAFE_FREE(buf);
+	BLI_ghash_free(entry_by_old, NULL, NULL);
+	BLI_ghash_free(entry_by_name, MEM_freeN, NULL);
+}
+
+static BlendFileIndex *blendfile_index_from_handle(BlendHandle *bh, const bool find_dependencies)
+{
+	BlendFileIndex *index = MEM_callocN(sizeof(*index), __func__);
+	LinkNode *groups, *group_link;
+	int entries_len = 0;
+
+	groups = BLO_blendhandle_get_linkable_groups(bh);
+
+	for (group_link = groups; group_link; group_link = group_link->next) {
+		const int idcode = BKE_idcode_from_name(group_link->link);
+		LinkNode *names, *previews, *ln, *lp;
+		int names_num, previews_num;
+
+		names = BLO_blendhandle_get_datablock_names(bh, idcode, &names_num);
+		previews = BLO_blendhandle_get_previews(bh, idcode, &previews_num);
+
+		if (names_num) {
+			if (index->entries_num + names_num > entries_len) {
+				entries_len = (index->entries_num + names_num) * 2;
+				index->entries = MEM_reallocN(index->entries, sizeof(*index->entries) * entries_len);
+			}
+
+			/* lists are in reverse file order, keep it so results match the blend handle */
+			for (ln = names, lp = (previews_num == names_num) ? previews : NULL; ln; ln = ln->next) {
+				BlendFileIndexEntry *entry = &index->entries[index->entries_num++];
+				memset(entry, 0, sizeof(*entry));
+				entry->idcode = idcode;
+				BLI_strncpy(entry->name, ln->link, sizeof(entry->name));
+				if (lp) {
+					entry->preview = lp->link;
+					lp->link = NULL;
+					lp = lp->next;
+				}
+			}
+		}
+
+		BLI_linklist_free(previews, BKE_previewimg_freefunc);
+		BLI_linklist_free(names, free);
+	}
+
+	BLI_linklist_free(groups, free);
+
+	blendfile_index_scan_blocks((FileData *)bh, index, find_dependencies);
+
+	return index;
+}
+
+static BlendFileIndex *blendfile_index_read(const char *index_path, const BLI_stat_t *blend_stat)
+{
+	BlendFileIndexHeader header;
+	BlendFileIndex *index = NULL;
+	FILE *fp;
+	int i;
+	bool ok = true;
+
+	fp = BLI_fopen(index_path, "rb");
+	if (fp == NULL) {
+		return NULL;
+	}
+
+	if ((fread(&header, sizeof(header), 1, fp) != 1) ||
+	    !STREQLEN(header.magic, BLENDFILE_INDEX_MAGIC, sizeof(header.magic)) ||
+	    (header.version != BLENDFILE_INDEX_VERSION) ||
+	    (header.mtime != (int64_t)blend_stat->st_mtime) ||
+	    (header.size != (int64_t)blend_stat->st_size) ||
+	    (header.entries_num < 0))
+	{
+		/* outdated, or written by another version or platform */
+		fclose(fp);
+		return NULL;
+	}
+
+	index = MEM_callocN(sizeof(*index), __func__);
+	if (header.entries_num) {
+		index->entries = MEM_callocN(sizeof(*index->entries) * (size_t)header.entries_num, __func__);
+	}
+
+	for (i = 0; ok && (i < header.entries_num); i++) {
+		BlendFileIndexEntry *entry = &index->entries[i];
+		int has_preview;
+
+		index->entries_num++;
+
+		ok = ((fread(&entry->idcode, sizeof(entry->idcode), 1, fp) == 1) &&
+		      (fread(entry->name, sizeof(entry->name), 1, fp) == 1) &&
+		      (fread(&entry->file_offset, sizeof(entry->file_offset), 1, fp) == 1) &&
+		      (fread(&entry->deps_num, sizeof(entry->deps_num), 1, fp) == 1) &&
+		      (entry->deps_num >= -1) && (entry->deps_num <= header.entries_num));
+
+		if (ok) {
+			entry->name[sizeof(entry->name) - 1] = '\0';
+		}
+
+		if (ok && entry->deps_num > 0) {
+			int dep;
+
+			entry->deps = MEM_mallocN(sizeof(*entry->deps) * (size_t)entry->deps_num, __func__);
+			ok = (fread(entry->deps, sizeof(*entry->deps), (size_t)entry->deps_num, fp) == (size_t)entry->deps_num);
+			for (dep = 0; ok && (dep < entry->deps_num); dep++) {
+				ok = (entry->deps[dep] >= 0) && (entry->deps[dep] < header.entries_num);
+			}
+		}
+
+		if (ok) {
+			ok = (fread(&has_preview, sizeof(has_preview), 1, fp) == 1);
+		}
+
+		if (ok && has_preview) {
+			int size;
+
+			entry->preview = MEM_callocN(sizeof(PreviewImage), "newpreview");
+
+			for (size = 0; ok && (size < NUM_ICON_SIZES); size++) {
+				PreviewImage *prv = entry->preview;
+
+				ok = ((fread(&prv->w[size], sizeof(prv->w[size]), 1, fp) == 1) &&
+				      (fread(&prv->h[size], sizeof(prv->h[size]), 1, fp) == 1) &&
+				      (prv->w[size] <= BLENDFILE_INDEX_PREVIEW_SIZE_MAX) &&
+				      (prv->h[size] <= BLENDFILE_INDEX_PREVIEW_SIZE_MAX));
+
+				if (ok && prv->w[size] && prv->h[size]) {
+					const size_t len = prv->w[size] * prv->h[size];
+					prv->rect[size] = MEM_mallocN(len * sizeof(unsigned int), __func__);
+					ok = (fread(prv->rect[size], sizeof(unsigned int), len, fp) == len);
+				}
+				else {
+					prv->w[size] = prv->h[size] = 0;
+				}
+			}
+		}
+	}
+
+	fclose(fp);
+
+	if (!ok) {
+		index->users = 1;
+		BLO_blendfile_index_release(index);
+		return NULL;
+	}
+
+	return index;
+}
+
+static bool blendfile_index_write(const BlendFileIndex *index, const char *index_path, const BLI_stat_t *blend_stat)
+{
+	BlendFileIndexHeader header = {{0}};
+	char tempname[FILE_MAX + 1];
+	FILE *fp;
+	int i;
+	bool ok;
+
+	/* never leave a partially written index behind,
+	 * thumbnail threads may index the same file at once so the temp name must be unique */
+	BLI_snprintf(tempname, sizeof(tempname), "%s@%p", index_path, (const void *)index);
+
+	fp = BLI_fopen(tempname, "wb");
+	if (fp == NULL) {
+		return false;
+	}
+
+	memcpy(header.magic, BLENDFILE_INDEX_MAGIC, sizeof(header.magic));
+	header.version = BLENDFILE_INDEX_VERSION;
+	header.entries_num = index->entries_num;
+	header.mtime = (int64_t)blend_stat->st_mtime;
+	header.size = (int64_t)blend_stat->st_size;
+
+	ok = (fwrite(&header, sizeof(header), 1, fp) == 1);
+
+	for (i = 0; ok && (i < index->entries_num); i++) {
+		const BlendFileIndexEntry *entry = &index->entries[i];
+		const int has_preview = (entry->preview != NULL);
+
+		ok = ((fwrite(&entry->idcode, sizeof(entry->idcode), 1, fp) == 1) &&
+		      (fwrite(entry->name, sizeof(entry->name), 1, fp) == 1) &&
+		      (fwrite(&entry->file_offset, sizeof(entry->file_offset), 1, fp) == 1) &&
+		      (fwrite(&entry->deps_num, sizeof(entry->deps_num), 1, fp) == 1));
+
+		if (ok && entry->deps_num > 0) {
+			ok = (fwrite(entry->deps, sizeof(*entry->deps), (size_t)entry->deps_num, fp) == (size_t)entry->deps_num);
+		}
+
+		if (ok) {
+			ok = (fwrite(&has_preview, sizeof(has_preview), 1, fp) == 1);
+		}
+
+		if (ok && has_preview) {
+			const PreviewImage *prv = entry->preview;
+			int size;
+
+			for (size = 0; ok && (size < NUM_ICON_SIZES); size++) {
+				const bool has_rect = (prv->rect[size] && prv->w[size] && prv->h[size]);
+				const unsigned int w = has_rect ? prv->w[size] : 0;
+				const unsigned int h = has_rect ? prv->h[size] : 0;
+
+				ok = ((fwrite(&w, sizeof(w), 1, fp) == 1) &&
+				      (fwrite(&h, sizeof(h), 1, fp) == 1));
+
+				if (ok && has_rect) {
+					ok = (fwrite(prv->rect[size], sizeof(unsigned int), w * h, fp) == w * h);
+				}
+			}
+		}
+	}
+
+	if (fclose(fp) != 0) {
+		ok = false;
+	}
+
+	if (!ok || (BLI_rename(tempname, index_path) != 0)) {
+		BLI_delete(tempname, false, false);
+		return false;
+	}
+
+	return true;
+}
+
+static void blendfile_index_free(BlendFileIndex *index)
+{
+	int i;
+
+	for (i = 0; i < index->entries_num; i++) {
+		if (index->entries[i].preview) {
+			BKE_previewimg_freefunc(index->entries[i].preview);
+		}
+		MEM_SAFE_FREE(index->entries[i].deps);
+	}
+
+	MEM_SAFE_FREE(index->entries);
+	MEM_freeN(index);
+}
+
+/* find an up to date index in the memory cache and add a user, call with the cache locked */
+static BlendFileIndex *blendfile_index_cache_find(const char *filepath, const BLI_stat_t *blend_stat)
+{
+	int i;
+
+	for (i = 0; i < BLENDFILE_INDEX_CACHE_SIZE; i++) {
+		BlendFileIndex *index = blendfile_index_cache[i];
+
+		if (index && STREQ(index->filepath, filepath) &&
+		    (index->mtime == (int64_t)blend_stat->st_mtime) &&
+		    (index->size == (int64_t)blend_stat->st_size))
+		{
+			/* most recently used first */
+			memmove(&blendfile_index_cache[1], &blendfile_index_cache[0], sizeof(*blendfile_index_cache) * i);
+			blendfile_index_cache[0] = index;
+			index->users++;
+			return index;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * Get the index of the ID's in a blend file.
+ *
+ * The index is reused from memory, or from the sidecar file when #USER_BLENDFILE_INDEX is enabled,
+ * as long as the blend file is unchanged. Failing to write the sidecar (read-only library directories)
+ * is not an error.
+ *
+ * \param filepath The blend file to index.
+ * \param reports Report errors in opening the blend file (can be NULL).
+ * \return The index, or NULL when the blend file can't be read. Release it with #BLO_blendfile_index_release.
+ */
+BlendFileIndex *BLO_blendfile_index_get(const char *filepath, ReportList *reports)
+{
+	BlendFileIndex *index = NULL, *cached;
+	BlendHandle *bh;
+	BLI_stat_t blend_stat;
+	char index_path[FILE_MAX];
+	const bool is_file = (BLI_stat(filepath, &blend_stat) == 0);
+	const bool use_sidecar = is_file && (U.flag & USER_BLENDFILE_INDEX);
+
+	if (is_file) {
+		BLI_mutex_lock(&blendfile_index_cache_lock);
+		index = blendfile_index_cache_find(filepath, &blend_stat);
+		BLI_mutex_unlock(&blendfile_index_cache_lock);
+
+		if (index) {
+			return index;
+		}
+	}
+
+	if (use_sidecar) {
+		blendfile_index_sidecar_path(filepath, index_path);
+		index = blendfile_index_read(index_path, &blend_stat);
+	}
+
+	if (index == NULL) {
+		bh = BLO_blendhandle_from_file(filepath, reports);
+		if (bh == NULL) {
+			return NULL;
+		}
+
+		/* dependencies mean reading all data, only worth it when they're stored */
+		index = blendfile_index_from_handle(bh, use_sidecar);
+		BLO_blendhandle_close(bh);
+
+		if (use_sidecar) {
+			blendfile_index_write(index, index_path, &blend_stat);
+		}
+	}
+
+	index->users = 1;
+
+	if (!is_file) {
+		return index;
+	}
+
+	BLI_strncpy(index->filepath, filepath, sizeof(index->filepath));
+	index->mtime = (int64_t)blend_stat.st_mtime;
+	index->size = (int64_t)blend_stat.st_size;
+
+	BLI_mutex_lock(&blendfile_index_cache_lock);
+	/* another thread may have indexed the same file meanwhile */
+	cached = blendfile_index_cache_find(filepath, &blend_stat);
+	if (cached == NULL) {
+		BlendFileIndex *last = blendfile_index_cache[BLENDFILE_INDEX_CACHE_SIZE - 1];
+
+		if (last && (--last->users == 0)) {
+			blendfile_index_free(last);
+		}
+		memmove(&blendfile_index_cache[1], &blendfile_index_cache[0],
+		        sizeof(*blendfile_index_cache) * (BLENDFILE_INDEX_CACHE_SIZE - 1));
+		blendfile_index_cache[0] = index;
+		/* the user of the cache */
+		index->users++;
+	}
+	BLI_mutex_unlock(&blendfile_index_cache_lock);
+
+	if (cached) {
+		blendfile_index_free(index);
+		index = cached;
+	}
+
+	return index;
+}
+
+/**
+ * Same as #BLO_blendhandle_get_datablock_names, from the index.
+ */
+LinkNode *BLO_blendfile_index_get_datablock_names(BlendFileIndex *index, int ofblocktype, int *tot_names)
+{
+	LinkNode *names = NULL;
+	int i, tot = 0;
+
+	/* entries are in reverse file order */
+	for (i = index->entries_num - 1; i >= 0; i--) {
+		if (index->entries[i].idcode == ofblocktype) {
+			BLI_linklist_prepend(&names, strdup(index->entries[i].name));
+			tot++;
+		}
+	}
+
+	*tot_names = tot;
+	return names;
+}
+
+/**
+ * Same as #BLO_blendhandle_get_previews, from the index.
+ */
+LinkNode *BLO_blendfile_index_get_previews(BlendFileIndex *index, int ofblocktype, int *tot_prev)
+{
+	LinkNode *previews = NULL;
+	int i, tot = 0;
+
+	for (i = index->entries_num - 1; i >= 0; i--) {
+		if ((index->entries[i].idcode == ofblocktype) && index->entries[i].preview) {
+			BLI_linklist_prepend(&previews, BKE_previewimg_copy(index->entries[i].preview));
+			tot++;
+		}
+	}
+
+	*tot_prev = tot;
+	return previews;
+}
+
+/**
+ * Same as #BLO_blendhandle_get_linkable_groups, from the index.
+ */
+LinkNode *BLO_blendfile_index_get_linkable_groups(BlendFileIndex *index)
+{
+	GSet *gathered = BLI_gset_ptr_new("linkable_groups gh");
+	LinkNode *names = NULL;
+	int i;
+
+	for (i = index->entries_num - 1; i >= 0; i--) {
+		const char *str = BKE_idcode_to_name(index->entries[i].idcode);
+
+		if (BLI_gset_add(gathered, (void *)str)) {
+			BLI_linklist_prepend(&names, strdup(str));
+		}
+	}
+
+	BLI_gset_free(gathered, NULL);
+
+	return names;
+}
+
+/**
+ * Release an index got with #BLO_blendfile_index_get.
+ */
+void BLO_blendfile_index_release(BlendFileIndex *index)
+{
+	bool do_free;
+
+	BLI_mutex_lock(&blendfile_index_cache_lock);
+	do_free = (--index->users == 0);
+	BLI_mutex_unlock(&blendfile_index_cache_lock);
+
+	if (do_free) {
+		blendfile_index_free(index);
+	}
+}
+
+/**
+ * Free the indices kept in memory, on exit.
+ */
+void BLO_blendfile_index_cache_free(void)
+{
+	int i;
+
+	for (i = 0; i < BLENDFILE_INDEX_CACHE_SIZE; i++) {
+		if (blendfile_index_cache[i]) {
+			BLO_blendfile_index_release(blendfile_index_cache[i]);
+			blendfile_index_cache[i] = NULL;
+		}
+	}
+}
+
+/** \} */
+
 /**********/
 
 /**
@@ -786,10 +786,34 @@ static BHeadN *get_bhead(FileData *fd)
 			/* bhead now contains the (converted) bhead structure. Now read
 			 * the associated data and put everything in a BHeadN (creative naming !)
 			 */
+#ifdef USE_BHEAD_READ_ON_DEMAND
+			if (!fd->eof && fd->seek_fn && (bhead.code == DATA)) {
+				/* only remember where the data is, it's read when needed */
+				new_bhead = MEM_mallocN(sizeof(BHeadN), "new_bhead");
+				new_bhead->next = new_bhead->prev = NULL;
+				new_bhead->file_offset = fd->file_offset;
+				new_bhead->has_data = false;
+				new_bhead->bhead = bhead;
+
+				/* seeking past the end succeeds, so check truncated files like a short read would */
+				if ((fd->file_offset + bhead.len > fd->file_size) ||
+				    (fd->seek_fn(fd, bhead.len, SEEK_CUR) == -1))
+				{
+					fd->eof = 1;
+					MEM_freeN(new_bhead);
+					new_bhead = NULL;
+				}
+			}
+			else
+#endif
 			if (!fd->eof) {
 				new_bhead = MEM_mallocN(sizeof(BHeadN) + bhead.len, "new_bhead");
 				if (new_bhead) {
 					new_bhead->next = new_bhead->prev = NULL;
+#ifdef USE_BHEAD_READ_ON_DEMAND
+					new_bhead->file_offset = fd->file_offset;
+					new_bhead->has_data = true;
+#endif
 					new_bhead->bhead = bhead;
 					
 					readsize = fd->read(fd, new_bhead + 1, bhead.len);
@@ -839,7 +863,7 @@ BHead *blo_firstbhead(FileData *fd)
 
 BHead *blo_prevbhead(FileData *UNUSED(fd), BHead *thisblock)
 {
-	BHeadN *bheadn = (BHeadN *)POINTER_OFFSET(thisblock, -offsetof(BHeadN, bhead));
+	BHeadN *bheadn = BHEADN_FROM_BHEAD(thisblock);
 	BHeadN *prev = bheadn->prev;
 	
 	return (prev) ? &prev->bhead : NULL;
@@ -853,7 +877,7 @@ BHead *blo_nextbhead(FileData *fd, BHead *thisblock)
 	if (thisblock) {
 		/* bhead is actually a sub part of BHeadN
 		 * We calculate the BHeadN pointer from the BHead pointer below */
-		new_bhead = (BHeadN *)POINTER_OFFSET(thisblock, -offsetof(BHeadN, bhead));
+		new_bhead = BHEADN_FROM_BHEAD(thisblock);
 		
 		/* get the next BHeadN. If it doesn't exist we read in the next one */
 		new_bhead = new_bhead->next;
@@ -871,6 +895,64 @@ BHead *blo_nextbhead(FileData *fd, BHead *thisblock)
 	return(bhead);
 }
 
+/**
+ * Copy the data of \a thisblock (#BHead.len bytes) into \a buf,
+ * reading it from the file when it isn't in memory (see: USE_BHEAD_READ_ON_DEMAND).
+ */
+bool blo_bhead_read_data(FileData *fd, BHead *thisblock, void *buf)
+{
+#ifdef USE_BHEAD_READ_ON_DEMAND
+	BHeadN *new_bhead = BHEADN_FROM_BHEAD(thisblock);
+
+	if (!new_bhead->has_data) {
+		/* continue reading bheads from the current position afterwards */
+		const int64_t offset_backup = fd->file_offset;
+		bool success = true;
+
+		if ((fd->seek_fn(fd, new_bhead->file_offset, SEEK_SET) == -1) ||
+		    (fd->read(fd, buf, thisblock->len) != thisblock->len))
+		{
+			success = false;
+		}
+
+		if (fd->seek_fn(fd, offset_backup, SEEK_SET) == -1) {
+			fd->eof = 1;
+			success = false;
+		}
+
+		return success;
+	}
+#else
+	UNUSED_VARS(fd);
+#endif
+
+	memcpy(buf, thisblock + 1, thisblock->len);
+	return true;
+}
+
+#ifdef USE_BHEAD_READ_ON_DEMAND
+/**
+ * Return a copy of \a thisblock with its data in memory (free with #MEM_freeN on #BHEADN_FROM_BHEAD),
+ * for code that needs to modify or reconstruct the data.
+ */
+static BHead *blo_bhead_read_full(FileData *fd, BHead *thisblock)
+{
+	BHeadN *new_bhead = MEM_mallocN(sizeof(BHeadN) + thisblock->len, "new_bhead");
+
+	new_bhead->next = new_bhead->prev = NULL;
+	new_bhead->file_offset = BHEADN_FROM_BHEAD(thisblock)->file_offset;
+	new_bhead->has_data = true;
+	new_bhead->bhead = *thisblock;
+
+	if (!blo_bhead_read_data(fd, thisblock, new_bhead + 1)) {
+		MEM_freeN(new_bhead);
+		return NULL;
+	}
+
+	return &new_bhead->bhead;
+}
+#endif  /* USE_BHEAD_READ_ON_DEMAND */
+
 /* Warning! Caller's responsability to ensure given bhead **is** and ID one! */
 const char *bhead_id_name(const FileData *fd, const BHead *bhead)
 {
@@ -993,11 +1075,25 @@ static int fd_read_from_file(FileData *filedata, void *buffer, unsigned int size
 	}
 	else {
 		filedata->seek += readsize;
+		filedata->file_offset += readsize;
 	}
 	
 	return readsize;
 }
 
+#ifdef USE_BHEAD_READ_ON_DEMAND
+static int64_t fd_seek_from_file(FileData *filedata, int64_t offset, int whence)
+{
+	const int64_t new_offset = (int64_t)lseek(filedata->filedes, offset, whence);
+
+	if (new_offset != -1) {
+		filedata->file_offset = new_offset;
+	}
+
+	return new_offset;
+}
+#endif
+
 static int fd_read_gzip_from_file(FileData *filedata, void *buffer, unsigned int size)
 {
 	int readsize = gzread(filedata->gzfiledes, buffer, size);
@@ -1121,12 +1217,44 @@ static FileData *blo_decode_and_check(FileData *fd, ReportList *reports)
 	return fd;
 }
 
-/* cannot be called with relative paths anymore! */
-/* on each new library added, it now checks for the current FileData and expands relativeness */
-FileData *blo_openblenderfile(const char *filepath, ReportList *reports)
+static FileData *blo_openblenderfile_ex(const char *filepath, ReportList *reports, const bool read_on_demand)
 {
 	gzFile gzfile;
 	errno = 0;
+
+#ifdef USE_BHEAD_READ_ON_DEMAND
+	/* Uncompressed files are read directly so data can be skipped and read on demand,
+	 * only compressed files go through zlib (where seeking means decompressing).
+	 * Opening a file reads all of its data anyway, a seek per block would only slow it down. */
+	if (read_on_demand) {
+		const int file = BLI_open(filepath, O_BINARY | O_RDONLY, 0);
+
+		if (file != -1) {
+			unsigned char magic[2];
+			const bool is_gzip = ((read(file, magic, sizeof(magic)) == sizeof(magic)) &&
+			                      (magic[0] == 0x1f) && (magic[1] == 0x8b));
+
+			if (!is_gzip && (lseek(file, 0, SEEK_SET) == 0)) {
+				FileData *fd = filedata_new();
+				fd->filedes = file;
+				fd->read = fd_read_from_file;
+				fd->seek_fn = fd_seek_from_file;
+				fd->file_size = (int64_t)BLI_file_descriptor_size(file);
+
+				/* needed for library_append and read_libraries */
+				BLI_strncpy(fd->relabase, filepath, sizeof(fd->relabase));
+
+				return blo_decode_and_check(fd, reports);
+			}
+
+			close(file);
+			errno = 0;
+		}
+	}
+#else
+	UNUSED_VARS(read_on_demand);
+#endif
+
 	gzfile = BLI_gzopen(filepath, "rb");
 	
 	if (gzfile == (gzFile)Z_NULL) {
@@ -1146,6 +1274,22 @@ FileData *blo_openblenderfile(const char *filepath, ReportList *reports)
 	}
 }
 
+/* cannot be called with relative paths anymore! */
+/* on each new library added, it now checks for the current FileData and expands relativeness */
+FileData *blo_openblenderfile(const char *filepath, ReportList *reports)
+{
+	return blo_openblenderfile_ex(filepath, reports, false);
+}
+
+/**
+ * Same as blo_openblenderfile(), but the data of DATA blocks is only read when it's needed,
+ * for libraries that ID's are linked or appended from (see: USE_BHEAD_READ_ON_DEMAND).
+ */
+FileData *blo_openblenderfile_library(const char *filepath, ReportList *reports)
+{
+	return blo_openblenderfile_ex(filepath, reports, true);
+}
+
 /**
  * Same as blo_openblenderfile(), but does not reads DNA data, only header. Use it for light access
  * (e.g. thumbnail reading).
@@ -1878,6 +2022,22 @@ static void *read_struct(FileData *fd, BHead *bh, const char *blockname)
 	void *temp = NULL;
 	
 	if (bh->len) {
+#ifdef USE_BHEAD_READ_ON_DEMAND
+		BHead *bh_orig = bh;
+
+		/* endian switching and reconstruction work on the data in memory */
+		if ((BHEADN_FROM_BHEAD(bh)->has_data == false) &&
+		    (fd->compflags[bh->SDNAnr] != SDNA_CMP_REMOVED) &&
+		    ((bh->SDNAnr && (fd->flags & FD_FLAGS_SWITCH_ENDIAN)) ||
+		     (fd->compflags[bh->SDNAnr] == SDNA_CMP_NOT_EQUAL)))
+		{
+			bh = blo_bhead_read_full(fd, bh);
+			if (UNLIKELY(bh == NULL)) {
+				return NULL;
+			}
+		}
+#endif
+
 		/* switch is based on file dna */
 		if (bh->SDNAnr && (fd->flags & FD_FLAGS_SWITCH_ENDIAN))
 			switch_endian_structs(fd->filesdna, bh);
@@ -1887,11 +2047,20 @@ static void *read_struct(FileData *fd, BHead *bh, const char *blockname)
 				temp = DNA_struct_reconstruct(fd->memsdna, fd->filesdna, fd->compflags, bh->SDNAnr, bh->nr, (bh+1));
 			}
 			else {
-				/* SDNA_CMP_EQUAL */
+				/* SDNA_CMP_EQUAL, read directly into the new memory when not loaded yet */
 				temp = MEM_mallocN(bh->len, blockname);
-				memcpy(temp, (bh+1), bh->len);
+				if (!blo_bhead_read_data(fd, bh, temp)) {
+					MEM_freeN(temp);
+					temp = NULL;
+				}
 			}
 		}
+
+#ifdef USE_BHEAD_READ_ON_DEMAND
+		if (bh != bh_orig) {
+			MEM_freeN(BHEADN_FROM_BHEAD(bh));
+		}
+#endif
 	}
 
 	return temp;
@@ -3040,6 +3209,8 @@ static void direct_link_nodetree(FileData *fd, bNodeTree *ntree)
 	ntree->progress = NULL;
 	ntree->execdata = NULL;
 	ntree->duplilock = NULL;
+	memset(&ntree->viewer_region, 0, sizeof(ntree->viewer_region));
+	ntree->viewer_zoom = 0.0f;
 
 	ntree->adt = newdataadr(fd, ntree->adt);
 	direct_link_animdata(fd, ntree->adt);
@@ -3900,6 +4071,7 @@ static void direct_link_texture(FileData *fd, Tex *tex)
 	tex->vd = newdataadr(fd, tex->vd);
 	if (tex->vd) {
 		tex->vd->dataset = NULL;
+		tex->vd->grid = NULL;
 		tex->vd->ok = 0;
 	}
 	else {
@@ -4033,6 +4205,8 @@ static void direct_link_pointcache(FileData *fd, PointCache *cache)
 	cache->edit = NULL;
 	cache->free_edit = NULL;
 	cache->cached_frames = NULL;
+	cache->prefetch = NULL;
+	cache->container = NULL;
 }
 
 static void direct_link_pointcache_list(FileData *fd, ListBase *ptcaches, PointCache **ocache, int force_disk)
@@ -5311,6 +5485,7 @@ static void direct_link_modifiers(FileData *fd, ListBase *lb)
 		else if (md->type == eModifierType_MeshSequenceCache) {
 			MeshSeqCacheModifierData *msmcd = (MeshSeqCacheModifierData *)md;
 			msmcd->reader = NULL;
+			msmcd->samples = NULL;
 		}
 	}
 }
@@ -10328,7 +10503,7 @@ static void read_libraries(FileData *basefd, ListBase *mainlist)
 						        mainptr->curlib->filepath,
 						        mainptr->curlib->name,
 						        library_parent_filepath(mainptr->curlib));
-						fd = blo_openblenderfile(mainptr->curlib->filepath, basefd->reports);
+						fd = blo_openblenderfile_library(mainptr->curlib->filepath, basefd->reports);
 					}
 					/* allow typing in a new lib path */
 					if (G.debug_value == -666) {
@@ -10345,7 +10520,7 @@ static void read_libraries(FileData *basefd, ListBase *mainlist)
 								BLI_strncpy(mainptr->curlib->filepath, newlib_path, sizeof(mainptr->curlib->filepath));
 								BLI_cleanup_path(G.main->name, mainptr->curlib->filepath);
 								
-								fd = blo_openblenderfile(mainptr->curlib->filepath, basefd->reports);
+								fd = blo_openblenderfile_library(mainptr->curlib->filepath, basefd->reports);
 
 								if (fd) {
 									fd->mainlist = mainlist;
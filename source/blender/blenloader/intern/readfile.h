@@ -44,6 +44,10 @@ struct PartEff;
 struct View3D;
 struct Key;
 
+/* Only read the data of DATA blocks from uncompressed files when it's requested,
+ * linking from large libraries then only reads the blocks of the linked ID's. */
+#define USE_BHEAD_READ_ON_DEMAND
+
 typedef struct FileData {
 	// linked list of BHeadN's
 	ListBase listbase;
@@ -62,6 +66,11 @@ typedef struct FileData {
 	int filedes;
 	gzFile gzfiledes;
 
+	// only set for seekable files (uncompressed), see: USE_BHEAD_READ_ON_DEMAND
+	int64_t (*seek_fn)(struct FileData *filedata, int64_t offset, int whence);
+	int64_t file_offset;
+	int64_t file_size;
+
 	// now only in use for library appending
 	char relabase[FILE_MAX];
 	
@@ -107,9 +116,17 @@ typedef struct FileData {
 
 typedef struct BHeadN {
 	struct BHeadN *next, *prev;
+#ifdef USE_BHEAD_READ_ON_DEMAND
+	/* Offset of the data in the file, when 'has_data' is false the data isn't in memory
+	 * and has to be read with #blo_bhead_read_data. */
+	int64_t file_offset;
+	bool has_data;
+#endif
 	struct BHead bhead;
 } BHeadN;
 
+#define BHEADN_FROM_BHEAD(bh) ((BHeadN *)POINTER_OFFSET(bh, -offsetof(BHeadN, bhead)))
+
 /* FileData->flags */
 enum {
 	FD_FLAGS_SWITCH_ENDIAN         = 1 << 0,
@@ -130,6 +147,7 @@ void blo_split_main(ListBase *mainlist, struct Main *main);
 BlendFileData *blo_read_file_internal(FileData *fd, const char *filepath);
 
 FileData *blo_openblenderfile(const char *filepath, struct ReportList *reports);
+FileData *blo_openblenderfile_library(const char *filepath, struct ReportList *reports);
 FileData *blo_openblendermemory(const void *buffer, int buffersize, struct ReportList *reports);
 FileData *blo_openblendermemfile(struct MemFile *memfile, struct ReportList *reports);
 
@@ -148,6 +166,7 @@ void blo_freefiledata(FileData *fd);
 
 BHead *blo_firstbhead(FileData *fd);
 BHead *blo_nextbhead(FileData *fd, BHead *thisblock);
+bool blo_bhead_read_data(FileData *fd, BHead *thisblock, void *buf);
 BHead *blo_prevbhead(FileData *fd, BHead *thisblock);
 
 const char *bhead_id_name(const FileData *fd, const BHead *bhead);
@@ -30,16 +30,27 @@
  *  \ingroup blenloader
  */
 
+#ifndef _WIN32
+#  include <unistd.h> // for read close
+#else
+#  include <io.h> // for open close read
+#endif
+
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 #include <math.h>
+#include <fcntl.h>  /* for open */
+#include <errno.h>
+
+#include "zlib.h"
 
 #include "MEM_guardedalloc.h"
 
 #include "DNA_listBase.h"
 
 #include "BLI_blenlib.h"
+#include "BLI_utildefines.h"
 
 #include "BLO_undofile.h"
 
@@ -120,3 +131,152 @@ void memfile_chunk_add(MemFile *compare, MemFile *current, const char *buf, unsi
 	}
 }
 
+
+/**
+ * Copy all chunks of \a src into \a dst, which must be empty.
+ *
+ * Unlike undo memfiles, the copy owns all its buffers (no chunk is marked as identical),
+ * so it stays valid when the undo steps it was copied from are freed.
+ * Used to hand a snapshot of the undo state over to a thread (auto-save).
+ */
+void BLO_memfile_copy(MemFile *dst, const MemFile *src)
+{
+	const MemFileChunk *chunk;
+
+	BLI_assert(BLI_listbase_is_empty(&dst->chunks));
+
+	dst->size = 0;
+	for (chunk = src->chunks.first; chunk; chunk = chunk->next) {
+		MemFileChunk *chunk_copy = MEM_mallocN(sizeof(MemFileChunk), "MemFileChunk");
+		chunk_copy->buf = MEM_mallocN(chunk->size, "Chunk buffer");
+		memcpy(chunk_copy->buf, chunk->buf, chunk->size);
+		chunk_copy->size = chunk->size;
+		chunk_copy->ident = 0;
+		BLI_addtail(&dst->chunks, chunk_copy);
+		dst->size += chunk->size;
+	}
+}
+
+/**
+ * Write the memfile as a regular blend file.
+ *
+ * Data is written to a temporary file first and only renamed into place when writing succeeded,
+ * so a failed or cancelled write never destroys an existing file.
+ *
+ * \param use_compress: Write a gzip compressed blend file.
+ * \param stop: Optional, cancel writing when set (may be modified from another thread).
+ * \param progress: Optional, set to the written fraction of the file.
+ * \param r_error: Optional, filled with a description of the error on failure.
+ */
+bool BLO_memfile_write_file(
+        MemFile *memfile, const char *filename, const bool use_compress,
+        const short *stop, float *progress, char *r_error, const size_t error_maxncpy)
+{
+	char tempname[FILE_MAX + 1];
+	MemFileChunk *chunk;
+	gzFile gzfile = Z_NULL;
+	size_t size_total = 0, size_done = 0;
+	int file, oflags;
+	bool ok = true;
+
+	for (chunk = memfile->chunks.first; chunk; chunk = chunk->next) {
+		size_total += chunk->size;
+	}
+
+	/* note: This is currently used for autosave and 'quit.blend', where _not_ following symlinks is OK,
+	 * however if this is ever executed explicitly by the user, we may want to allow writing to symlinks.
+	 */
+
+	oflags = O_BINARY | O_WRONLY | O_CREAT | O_TRUNC;
+#ifdef O_NOFOLLOW
+	/* use O_NOFOLLOW to avoid writing to a symlink - use 'O_EXCL' (CVE-2008-1103) */
+	oflags |= O_NOFOLLOW;
+#else
+	/* TODO(sergey): How to deal with symlinks on windows? */
+#  ifndef _MSC_VER
+#    warning "Symbolic links will be followed on undo save, possibly causing CVE-2008-1103"
+#  endif
+#endif
+
+	BLI_snprintf(tempname, sizeof(tempname), "%s@", filename);
+
+	file = BLI_open(tempname, oflags, 0666);
+
+	if (file == -1) {
+		if (r_error) {
+			BLI_snprintf(r_error, error_maxncpy, "Cannot open file %s for writing: %s",
+			             tempname, errno ? strerror(errno) : "Unknown error opening file");
+		}
+		return false;
+	}
+
+	if (use_compress) {
+		/* same compression level as regular compressed file saving */
+		gzfile = gzdopen(file, "wb1");
+		if (gzfile == Z_NULL) {
+			close(file);
+			BLI_delete(tempname, false, false);
+			if (r_error) {
+				BLI_snprintf(r_error, error_maxncpy, "Cannot open file %s for compressed writing", tempname);
+			}
+			return false;
+		}
+	}
+
+	for (chunk = memfile->chunks.first; chunk; chunk = chunk->next) {
+		if (stop && *stop) {
+			ok = false;
+			if (r_error) {
+				BLI_strncpy(r_error, "Cancelled", error_maxncpy);
+			}
+			break;
+		}
+
+		if (gzfile != Z_NULL) {
+			ok = (gzwrite(gzfile, chunk->buf, chunk->size) == (int)chunk->size);
+		}
+		else {
+			ok = (write(file, chunk->buf, chunk->size) == chunk->size);
+		}
+
+		if (!ok) {
+			if (r_error) {
+				BLI_snprintf(r_error, error_maxncpy, "Cannot write file %s: %s",
+				             tempname, errno ? strerror(errno) : "Unknown error writing file");
+			}
+			break;
+		}
+
+		size_done += chunk->size;
+		if (progress && size_total) {
+			*progress = (float)((double)size_done / (double)size_total);
+		}
+	}
+
+	if (gzfile != Z_NULL) {
+		if (gzclose(gzfile) != Z_OK && ok) {
+			ok = false;
+			if (r_error) {
+				BLI_snprintf(r_error, error_maxncpy, "Cannot write file %s: compression failed", tempname);
+			}
+		}
+	}
+	else {
+		close(file);
+	}
+
+	if (!ok) {
+		BLI_delete(tempname, false, false);
+		return false;
+	}
+
+	/* file is complete, move it into place */
+	if (BLI_rename(tempname, filename) != 0) {
+		if (r_error) {
+			BLI_snprintf(r_error, error_maxncpy, "Cannot change old file (file saved with @)");
+		}
+		return false;
+	}
+
+	return true;
+}
@@ -103,9 +103,10 @@ extern "C" {
  *  - [@ref OrderOfChunks.COM_TO_TOP_DOWN]: Start calculation from the bottom to the top of the image
  *  - [@ref OrderOfChunks.COM_TO_RULE_OF_THIRDS]: Experimental order based on 9 hot-spots in the image
  *
- * When the chunk-order is determined, the first few chunks will be checked if they can be scheduled.
- * Chunks can have three states:
- *  - [@ref ChunkExecutionState.COM_ES_NOT_SCHEDULED]: Chunk is not yet scheduled, or dependencies are not met
+ * When the chunk-order is determined, all chunks are requested in that order.
+ * Chunks can have four states:
+ *  - [@ref ChunkExecutionState.COM_ES_NOT_SCHEDULED]: Chunk is not yet requested
+ *  - [@ref ChunkExecutionState.COM_ES_WAITING]: Chunk is requested, but dependencies are not met
  *  - [@ref ChunkExecutionState.COM_ES_SCHEDULED]: All dependencies are met, chunk is scheduled, but not finished
  *  - [@ref ChunkExecutionState.COM_ES_EXECUTED]: Chunk is finished
  *
@@ -144,8 +145,10 @@ extern "C" {
  * but not all input chunks are available. The relevant ExecutionGroup (that can calculate the missing chunks;
  * ExecutionGroup A) is asked to calculate the area ExecutionGroup B is missing.
  * [@ref ExecutionGroup.scheduleAreaWhenPossible]
- * ExecutionGroup B checks what chunks the area spans, and tries to schedule these chunks.
- * If all input data is available these chunks are scheduled [@ref ExecutionGroup.scheduleChunk]
+ * ExecutionGroup A checks what chunks the area spans, and requests these chunks. The chunk of ExecutionGroup B
+ * counts the chunks it waits for and every chunk of ExecutionGroup A keeps a list of the chunks waiting for it.
+ * When a chunk is executed it releases the waiting chunks, a chunk whose inputs are all available
+ * is scheduled [@ref ExecutionGroup.scheduleChunk] right away, without waiting for the rest of its ExecutionGroup.
  *
  * <pre>
  *
@@ -207,9 +210,9 @@ extern "C" {
  * </pre>
  *
  * @see ExecutionGroup.execute Execute a complete ExecutionGroup. Halts until finished or breaked by user
- * @see ExecutionGroup.scheduleChunkWhenPossible Tries to schedule a single chunk,
- * checks if all input data is available. Can trigger dependent chunks to be calculated
- * @see ExecutionGroup.scheduleAreaWhenPossible Tries to schedule an area. This can be multiple chunks
+ * @see ExecutionGroup.scheduleChunkWhenPossible Requests a single chunk,
+ * requests its input data the first time. Can trigger dependent chunks to be calculated
+ * @see ExecutionGroup.scheduleAreaWhenPossible Requests an area. This can be multiple chunks
  * (is called from [@ref ExecutionGroup.scheduleChunkWhenPossible])
  * @see ExecutionGroup.scheduleChunk Schedule a chunk on the WorkScheduler
  * @see NodeOperation.determineDependingAreaOfInterest Influence the area of interest of a chunk.
@@ -329,7 +332,7 @@ void COM_deinitialize(void);
  * @brief Clear all compositor caches. (Compositor system will still remain available). 
  * To deinitialize the compositor use the COM_deinitialize method.
  */
-// void COM_clearCaches(void); // NOT YET WRITTEN
+void COM_clearCaches(void);
 
 /**
  * @brief Return a list of highlighted bnodes pointers.
@@ -109,6 +109,68 @@ typedef enum OrderOfChunks {
 #define COM_NUM_CHANNELS_VECTOR 3
 #define COM_NUM_CHANNELS_COLOR 4
 
+/**
+ * @brief maximum number of pixels requested by a single SocketReader::readRowSampled call
+ * Operations keep their input rows on the stack, so this is kept small enough
+ * for long chains of operations.
+ */
+#define COM_ROW_CHUNK_SIZE 64
+
+/**
+ * @brief fuse chains of pointwise operations into a single FusedOperation
+ * @see NodeOperationBuilder.fuse_pointwise_operations
+ */
+#define COM_FUSE_OPERATIONS
+
+/**
+ * @brief G.debug_value (bpy.app.debug_value) that disables fusing,
+ * for comparing fused and unfused results (tests/python/compositor_fusion_test.py)
+ */
+#define COM_DEBUG_VALUE_NO_FUSE 4242
+
+/**
+ * @brief maximum number of rows (fused operations plus external inputs) evaluated by a FusedOperation
+ * every row takes COM_ROW_CHUNK_SIZE pixels of scratch memory per thread.
+ */
+#define COM_FUSED_MAX_ROWS 32
+
+/**
+ * @brief maximum number of input sockets of an operation that can be fused
+ */
+#define COM_FUSED_MAX_INPUTS 8
+
+/**
+ * @brief memory budget in bytes of the buffers kept by the CompositorCache between executions
+ * used until the user preferences are read, they set the budget after that.
+ */
+#define COM_CACHE_MEMORY_LIMIT (1024 * 1024 * 1024)
+
+/**
+ * @brief stream buffers through a MemoryTileStore when the full buffers don't fit in the memory budget
+ * @see ExecutionSystem.useStreaming
+ */
+#define COM_STREAMING
+
+/**
+ * @brief memory budget in bytes of the intermediate buffers of an execution,
+ * when exceeded the buffers are kept in tiles and spilled to a scratch file.
+ * used until the user preferences are read, they set the budget after that.
+ */
+#define COM_STREAMING_MEMORY_LIMIT ((size_t)2048 * 1024 * 1024)
+
+/**
+ * @brief rows read below the area of interest of a chunk from a streamed buffer
+ * @see ReadBufferOperation.executePixelSampled
+ */
+#define COM_STREAMING_BAND_MARGIN 1
+
 #define COM_BLUR_BOKEH_PIXELS 512
 
+/**
+ * @brief largest number of pixels in x and y that share a single sample in the display resolution
+ * preview of a zoomed out viewer
+ * @see ExecutionSystem.ExecutionSystem
+ */
+#define COM_VIEWER_PROXY_MAX_STEP 8
+
 #endif  /* __COM_DEFINES_H__ */
@@ -21,10 +21,16 @@
  */
 
 #include "COM_CPUDevice.h"
+#include "COM_Profiler.h"
+#include "COM_ExecutionGroup.h"
+#include "COM_ReadBufferOperation.h"
 
 CPUDevice::CPUDevice(int thread_id)
   : Device(),
-    m_thread_id(thread_id)
+    m_thread_id(thread_id),
+    m_inputBuffers(NULL),
+    m_executionGroup(NULL),
+    m_chunkNumber(0)
 {
 }
 
@@ -35,9 +41,35 @@ void CPUDevice::execute(WorkPackage *work)
 	rcti rect;
 
 	executionGroup->determineChunkRect(&rect, chunkNumber);
+	ProfileScope scope(COM_PROFILE_CHUNK, NULL, executionGroup, &rect);
 
-	executionGroup->getOutputOperation()->executeRegion(&rect, chunkNumber);
+	this->m_inputBuffers = executionGroup->getInputBuffersStreaming();
+	this->m_executionGroup = executionGroup;
+	this->m_chunkNumber = chunkNumber;
+	/* all requested chunks are scheduled, so skip them once the user breaks,
+	 * the chunk is still finalized to release the chunks waiting for it */
+	if (!executionGroup->getOutputOperation()->isBreaked()) {
+		executionGroup->getOutputOperation()->executeRegion(&rect, chunkNumber);
+	}
 
-	executionGroup->finalizeChunkExecution(chunkNumber, NULL);
+	/* finalizing frees the temporarily input buffers */
+	MemoryBuffer **inputBuffers = this->m_inputBuffers;
+	this->m_inputBuffers = NULL;
+	this->m_executionGroup = NULL;
+	executionGroup->finalizeChunkExecution(chunkNumber, inputBuffers);
 }
 
+
+MemoryBuffer *CPUDevice::getInputBuffer(ReadBufferOperation *readOperation)
+{
+	if (this->m_inputBuffers == NULL) {
+		return NULL;
+	}
+
+	/* only this thread reads the input buffers of its chunk, no locking needed */
+	MemoryBuffer **buffer = &this->m_inputBuffers[readOperation->getOffset()];
+	if (*buffer == NULL) {
+		*buffer = this->m_executionGroup->readInputBufferStreaming(this->m_chunkNumber, readOperation);
+	}
+	return *buffer;
+}
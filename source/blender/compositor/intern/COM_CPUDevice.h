@@ -25,6 +25,8 @@
 
 #include "COM_Device.h"
 
+class ReadBufferOperation;
+
 /**
  * @brief class representing a CPU device.
  * @note for every hardware thread in the system a CPUDevice instance will exist in the workscheduler
@@ -41,8 +43,20 @@ public:
 
 	int thread_id() { return m_thread_id; }
 
+	/**
+	 * @brief the input buffer of a streaming memory proxy for the chunk being executed
+	 * @note the area is read from the proxy the first time it is asked for,
+	 * readers that copy the whole proxy never read it
+	 * @return NULL when the chunk has no streaming inputs
+	 * @see ExecutionGroup.readInputBufferStreaming
+	 */
+	MemoryBuffer *getInputBuffer(ReadBufferOperation *readOperation);
+
 protected:
 	int m_thread_id;
+	MemoryBuffer **m_inputBuffers;
+	ExecutionGroup *m_executionGroup;
+	unsigned int m_chunkNumber;
 };
 
 #endif
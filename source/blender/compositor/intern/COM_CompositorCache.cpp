@@ -0,0 +1,362 @@
+/*
+ * Copyright 2011, Blender Foundation.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor:
+ *		Jeroen Bakker
+ *		Monique Dewanchand
+ */
+
+#include <list>
+#include <string.h>
+#include <typeinfo>
+
+#include "COM_CompositorCache.h"
+#include "COM_CompositorContext.h"
+#include "COM_MemoryBuffer.h"
+#include "COM_MemoryProxy.h"
+#include "COM_NodeOperation.h"
+#include "COM_ReadBufferOperation.h"
+#include "COM_WriteBufferOperation.h"
+
+#include "MEM_guardedalloc.h"
+#include "MEM_CacheLimiterC-Api.h"
+
+extern "C" {
+#  include "BLI_utildefines.h"
+#  include "BKE_camera.h"
+#  include "BKE_image.h"
+#  include "BKE_node.h"
+#  include "DNA_camera_types.h"
+#  include "DNA_image_types.h"
+#  include "DNA_node_types.h"
+#  include "DNA_object_types.h"
+#  include "DNA_scene_types.h"
+#  include "DNA_userdef_types.h"
+}
+
+typedef struct CacheEntry {
+	CompositorCache::Key key;
+	MemoryBuffer *buffer;
+	size_t size;
+} CacheEntry;
+
+/* most recently used entries first */
+static std::list<CacheEntry> s_entries;
+static size_t s_memoryUsed = 0;
+
+static size_t buffer_size(MemoryBuffer *buffer)
+{
+	return (size_t)buffer->getWidth() * (size_t)buffer->getHeight() * buffer->get_num_channels() * sizeof(float);
+}
+
+/* the user preference, COM_CACHE_MEMORY_LIMIT before preferences are read */
+static size_t cache_memory_limit()
+{
+	if (U.compositor_cache_limit > 0) {
+		return (size_t)U.compositor_cache_limit * 1024 * 1024;
+	}
+	return COM_CACHE_MEMORY_LIMIT;
+}
+
+/* same rule as MEM_CacheLimiter: caches give way when all memory in use exceeds the memory cache limit */
+static bool memory_pressure()
+{
+	const size_t maximum = MEM_CacheLimiter_get_maximum();
+	return !MEM_CacheLimiter_is_disabled() && maximum != 0 && MEM_get_memory_in_use() > maximum;
+}
+
+static void free_least_recently_used()
+{
+	CacheEntry &entry = s_entries.back();
+	s_memoryUsed -= entry.size;
+	delete entry.buffer;
+	s_entries.pop_back();
+}
+
+/* ******** Hashing ******** */
+
+static inline uint64_t rotate_left(uint64_t value, int bits)
+{
+	return (value << bits) | (value >> (64 - bits));
+}
+
+/* final mix so every input bit affects every output bit (MurmurHash3 fmix64) */
+static inline uint64_t hash_finalize(uint64_t hash)
+{
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdULL;
+	hash ^= hash >> 33;
+	hash *= 0xc4ceb9fe1a85ec53ULL;
+	hash ^= hash >> 33;
+	return hash;
+}
+
+CompositorCache::Key CompositorCache::hash_combine(Key hash, Key value)
+{
+	return hash ^ (hash_finalize(value) + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2));
+}
+
+CompositorCache::Key CompositorCache::hash_data(const void *data, size_t size)
+{
+	const uint64_t c1 = 0x87c37b91114253d5ULL;
+	const uint64_t c2 = 0x4cf5ad432745937fULL;
+	const unsigned char *bytes = (const unsigned char *)data;
+	const size_t num_words = size / sizeof(uint64_t);
+	uint64_t hash = size;
+	uint64_t word;
+	size_t i;
+
+	/* node storage is hashed for every node on every execution, so process whole words */
+	for (i = 0; i < num_words; i++) {
+		memcpy(&word, &bytes[i * sizeof(uint64_t)], sizeof(uint64_t));
+		hash ^= rotate_left(word * c1, 31) * c2;
+		hash = rotate_left(hash, 27) * 5 + 0x52dce729;
+	}
+
+	if (size > num_words * sizeof(uint64_t)) {
+		word = 0;
+		memcpy(&word, &bytes[num_words * sizeof(uint64_t)], size - num_words * sizeof(uint64_t));
+		hash ^= rotate_left(word * c1, 31) * c2;
+	}
+
+	return hash_finalize(hash);
+}
+
+CompositorCache::Key CompositorCache::hash_string(const char *str)
+{
+	return str ? hash_data(str, strlen(str)) : 0;
+}
+
+static CompositorCache::Key hash_sockets(CompositorCache::Key hash, ListBase *sockets)
+{
+	for (bNodeSocket *sock = (bNodeSocket *)sockets->first; sock; sock = sock->next) {
+		if (sock->default_value) {
+			hash = CompositorCache::hash_combine(
+			        hash, CompositorCache::hash_data(sock->default_value, MEM_allocN_len(sock->default_value)));
+		}
+	}
+	return hash;
+}
+
+CompositorCache::Key CompositorCache::hash_node(const CompositorContext &context, bNode *node, bool *r_cacheable)
+{
+	Key hash = hash_combine(0, node->type);
+
+	*r_cacheable = true;
+
+	hash = hash_combine(hash, node->custom1);
+	hash = hash_combine(hash, node->custom2);
+	hash = hash_combine(hash, hash_data(&node->custom3, sizeof(node->custom3)));
+	hash = hash_combine(hash, hash_data(&node->custom4, sizeof(node->custom4)));
+
+	/* curve mappings in the storage are covered by their changed_timestamp */
+	if (node->storage) {
+		hash = hash_combine(hash, hash_data(node->storage, MEM_allocN_len(node->storage)));
+	}
+
+	/* output sockets hold the values of the Value and RGB nodes */
+	hash = hash_sockets(hash, &node->inputs);
+	hash = hash_sockets(hash, &node->outputs);
+
+	switch (node->type) {
+		case CMP_NODE_R_LAYERS:
+			/* the operations hash the change stamp of the render result */
+			hash = hash_combine(hash, (Key)(intptr_t)node->id);
+			break;
+		case CMP_NODE_IMAGE:
+			/* the operations hash the change stamp of the image buffer,
+			 * render result and viewer images are rewritten without renewing it */
+			hash = hash_combine(hash, (Key)(intptr_t)node->id);
+			if (node->id && ELEM(((Image *)node->id)->type, IMA_TYPE_R_RESULT, IMA_TYPE_COMPOSITE)) {
+				*r_cacheable = false;
+			}
+			break;
+		case CMP_NODE_DEFOCUS:
+		{
+			Scene *scene = node->id ? (Scene *)node->id : context.getScene();
+			Object *camob = scene ? scene->camera : NULL;
+			hash = hash_combine(hash, (Key)(intptr_t)camob);
+			if (camob && camob->type == OB_CAMERA) {
+				float dof_distance = BKE_camera_object_dof_distance(camob);
+				hash = hash_combine(hash, hash_data(camob->data, sizeof(Camera)));
+				hash = hash_combine(hash, hash_data(&dof_distance, sizeof(dof_distance)));
+			}
+			break;
+		}
+		case CMP_NODE_TIME:
+			hash = hash_combine(hash, context.getFramenumber());
+			break;
+		default:
+			/* textures, masks, movie clips etc. can change without the node being changed */
+			if (node->id) {
+				*r_cacheable = false;
+			}
+			break;
+	}
+
+	return hash;
+}
+
+CompositorCache::Key CompositorCache::hash_context(const CompositorContext &context)
+{
+	const RenderData *rd = context.getRenderData();
+	Key hash = hash_combine(0, context.getQuality());
+
+	hash = hash_combine(hash, context.isRendering());
+	hash = hash_combine(hash, context.isFastCalculation());
+	hash = hash_combine(hash, context.isHalfFloatBuffersEnabled());
+	hash = hash_combine(hash, hash_string(context.getViewName()));
+	if (rd) {
+		hash = hash_combine(hash, rd->size);
+		hash = hash_combine(hash, rd->xsch);
+		hash = hash_combine(hash, rd->ysch);
+		hash = hash_combine(hash, rd->mode);
+		hash = hash_combine(hash, rd->scemode);
+		hash = hash_combine(hash, hash_data(&rd->border, sizeof(rd->border)));
+	}
+	return hash;
+}
+
+bool CompositorCache::hash_operation(NodeOperation *operation, OperationHashes &hashes, Key *r_key)
+{
+	OperationHashes::const_iterator found = hashes.find(operation);
+	if (found != hashes.end()) {
+		*r_key = found->second.first;
+		return found->second.second;
+	}
+
+	bool cacheable = operation->isCacheable();
+	Key hash = operation->getNodeHash();
+	hash = hash_combine(hash, hash_string(typeid(*operation).name()));
+	hash = hash_combine(hash, operation->getWidth());
+	hash = hash_combine(hash, operation->getHeight());
+	hash = hash_combine(hash, operation->getDataHash());
+
+	for (unsigned int index = 0; index < operation->getNumberOfInputSockets(); index++) {
+		NodeOperationOutput *link = operation->getInputSocket(index)->getLink();
+		Key input_hash = 0;
+
+		if (link) {
+			NodeOperation &input_operation = link->getOperation();
+			if (!hash_operation(&input_operation, hashes, &input_hash)) {
+				cacheable = false;
+			}
+			for (unsigned int output = 0; output < input_operation.getNumberOfOutputSockets(); output++) {
+				if (input_operation.getOutputSocket(output) == link) {
+					input_hash = hash_combine(input_hash, output);
+					break;
+				}
+			}
+		}
+		hash = hash_combine(hash, input_hash);
+	}
+
+	/* continue through the buffer into the ExecutionGroup writing it */
+	if (operation->isReadBufferOperation()) {
+		MemoryProxy *memoryProxy = ((ReadBufferOperation *)operation)->getMemoryProxy();
+		Key write_hash;
+		if (!hash_operation(memoryProxy->getWriteBufferOperation(), hashes, &write_hash)) {
+			cacheable = false;
+		}
+		hash = hash_combine(hash, write_hash);
+	}
+
+	hashes[operation] = std::make_pair(hash, cacheable);
+	*r_key = hash;
+	return cacheable;
+}
+
+/* ******** Storage ******** */
+
+MemoryBuffer *CompositorCache::acquire(Key key, DataType datatype, unsigned int width, unsigned int height)
+{
+	for (std::list<CacheEntry>::iterator it = s_entries.begin(); it != s_entries.end(); ++it) {
+		CacheEntry &entry = *it;
+		if (entry.key == key) {
+			MemoryBuffer *buffer = entry.buffer;
+			s_memoryUsed -= entry.size;
+			s_entries.erase(it);
+
+			/* hash collisions are unlikely, but never hand out a buffer of the wrong layout */
+			if (buffer->getDataType() != datatype ||
+			    buffer->getWidth() != (int)width ||
+			    buffer->getHeight() != (int)height)
+			{
+				delete buffer;
+				return NULL;
+			}
+			return buffer;
+		}
+	}
+	return NULL;
+}
+
+void CompositorCache::store(Key key, MemoryBuffer *buffer)
+{
+	const size_t size = buffer_size(buffer);
+	const size_t limit = cache_memory_limit();
+
+	if (size > limit) {
+		delete buffer;
+		return;
+	}
+
+	/* replace an older buffer of the same key */
+	for (std::list<CacheEntry>::iterator it = s_entries.begin(); it != s_entries.end(); ++it) {
+		if (it->key == key) {
+			s_memoryUsed -= it->size;
+			delete it->buffer;
+			s_entries.erase(it);
+			break;
+		}
+	}
+
+	while (!s_entries.empty() && (s_memoryUsed + size > limit || memory_pressure())) {
+		free_least_recently_used();
+	}
+
+	/* the buffer itself is counted, keeping it would only be freed again by the next execution */
+	if (memory_pressure()) {
+		delete buffer;
+		return;
+	}
+
+	CacheEntry entry;
+	entry.key = key;
+	entry.buffer = buffer;
+	entry.size = size;
+	s_entries.push_front(entry);
+	s_memoryUsed += size;
+}
+
+void CompositorCache::enforce_limits()
+{
+	const size_t limit = cache_memory_limit();
+
+	while (!s_entries.empty() && (s_memoryUsed > limit || memory_pressure())) {
+		free_least_recently_used();
+	}
+}
+
+void CompositorCache::free()
+{
+	for (std::list<CacheEntry>::iterator it = s_entries.begin(); it != s_entries.end(); ++it) {
+		delete it->buffer;
+	}
+	s_entries.clear();
+	s_memoryUsed = 0;
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright 2011, Blender Foundation.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor:
+ *		Jeroen Bakker
+ *		Monique Dewanchand
+ */
+
+#ifndef _COM_CompositorCache_h_
+#define _COM_CompositorCache_h_
+
+#include <map>
+
+extern "C" {
+#  include "BLI_sys_types.h"
+}
+
+#include "COM_defines.h"
+
+class CompositorContext;
+class MemoryBuffer;
+class NodeOperation;
+struct bNode;
+
+/**
+ * @brief keeps the output buffers of complex ExecutionGroups between executions
+ *
+ * Every buffer is identified by a hash of the operations that calculated it, their node
+ * parameters and their inputs up to the render layers and images. When a later execution
+ * (another edit of the tree or another frame) calculates the same hash the buffer is reused
+ * instead of executing the group again.
+ *
+ * The least recently used buffers are freed when the cache exceeds the Compositor Cache Limit user
+ * preference, and when all memory in use exceeds the Memory Cache Limit, like other caches
+ * managed by MEM_CacheLimiter. The cache is freed when a file is loaded.
+ *
+ * @note the cache is not thread safe, it is only accessed while holding the compositor mutex
+ * @see COM_execute
+ * @ingroup Execution
+ */
+class CompositorCache {
+public:
+	typedef uint64_t Key;
+
+	/**
+	 * @brief memoized operation hashes of a single execution
+	 * the bool is false when the operation or one of its inputs is not cacheable
+	 */
+	typedef std::map<NodeOperation *, std::pair<Key, bool> > OperationHashes;
+
+	static Key hash_combine(Key hash, Key value);
+	static Key hash_data(const void *data, size_t size);
+	static Key hash_string(const char *str);
+
+	/**
+	 * @brief hash the parameters of a node
+	 * @param r_cacheable set to false when the node depends on data that can't be hashed
+	 */
+	static Key hash_node(const CompositorContext &context, bNode *node, bool *r_cacheable);
+
+	/**
+	 * @brief hash the settings of the context that influence all operations
+	 */
+	static Key hash_context(const CompositorContext &context);
+
+	/**
+	 * @brief hash an operation including all operations it reads from
+	 * @return false when the result of the operation can't be cached
+	 */
+	static bool hash_operation(NodeOperation *operation, OperationHashes &hashes, Key *r_key);
+
+	/**
+	 * @brief take a buffer out of the cache
+	 * @return the buffer or NULL when there is no buffer with this key and size,
+	 * the caller becomes the owner of the buffer
+	 */
+	static MemoryBuffer *acquire(Key key, DataType datatype, unsigned int width, unsigned int height);
+
+	/**
+	 * @brief add a buffer to the cache, the cache becomes the owner of the buffer
+	 */
+	static void store(Key key, MemoryBuffer *buffer);
+
+	/**
+	 * @brief free the least recently used buffers until the cache is within its limits
+	 * called before every execution, so memory freed for other uses is not taken back
+	 */
+	static void enforce_limits();
+
+	/**
+	 * @brief free all buffers of the cache
+	 */
+	static void free();
+};
+
+#endif
@@ -82,6 +82,12 @@ private:
 	 */
 	bool m_fastCalculation;
 
+	/**
+	 * @brief number of pixels in x and y of a viewer that share a sample in its first pass
+	 * 1 when the viewer is calculated at full resolution only
+	 */
+	int m_viewerProxyStep;
+
 	/* @brief color management settings */
 	const ColorManagedViewSettings *m_viewSettings;
 	const ColorManagedDisplaySettings *m_displaySettings;
@@ -199,7 +205,18 @@ public:
 	
 	void setFastCalculation(bool fastCalculation) {this->m_fastCalculation = fastCalculation;}
 	bool isFastCalculation() const { return this->m_fastCalculation; }
+	void setViewerProxyStep(int viewerProxyStep) { this->m_viewerProxyStep = viewerProxyStep; }
+	int getViewerProxyStep() const { return this->m_viewerProxyStep; }
 	bool isGroupnodeBufferEnabled() const { return (this->getbNodeTree()->flag & NTREE_COM_GROUPNODE_BUFFER) != 0; }
+
+	/**
+	 * @brief store color and value buffers between execution groups as half floats
+	 * @note buffers that depend on depth and vector buffers keep full precision,
+	 * operations that blur the whole buffer in place work on a float copy of their own
+	 * @see ExecutionSystem.useHalfFloat
+	 * @see MemoryProxy.duplicateFullBuffer
+	 */
+	bool isHalfFloatBuffersEnabled() const { return (this->getbNodeTree()->flag & NTREE_COM_HALF_BUFFERS) != 0; }
 };
 
 
@@ -40,6 +40,7 @@ extern "C" {
 #include "COM_ExecutionSystem.h"
 #include "COM_ExecutionGroup.h"
 
+#include "COM_FusedOperation.h"
 #include "COM_ReadBufferOperation.h"
 #include "COM_ViewerOperation.h"
 #include "COM_WriteBufferOperation.h"
@@ -103,6 +104,11 @@ void DebugInfo::operation_read_write_buffer(const NodeOperation *operation)
 	m_current_op_name = m_op_names[operation];
 }
 
+void DebugInfo::operation_fused(const NodeOperation *fused, const NodeOperation *output)
+{
+	m_op_names[fused] = m_op_names[output];
+}
+
 void DebugInfo::execution_group_started(const ExecutionGroup *group)
 {
 	m_group_states[group] = EG_RUNNING;
@@ -139,6 +145,9 @@ int DebugInfo::graphviz_operation(const ExecutionSystem *system, const NodeOpera
 	else if (operation->isWriteBufferOperation()) {
 		fillcolor = "darkorange";
 	}
+	else if (operation->isFusedOperation()) {
+		fillcolor = "plum";
+	}
 	
 	len += snprintf(str + len, maxlen > len ? maxlen - len : 0, "// OPERATION: %p\r\n", operation);
 	if (group)
@@ -176,6 +185,15 @@ int DebugInfo::graphviz_operation(const ExecutionSystem *system, const NodeOpera
 	
 	len += snprintf(str + len, maxlen > len ? maxlen - len : 0, " (%d,%d)", operation->getWidth(), operation->getHeight());
 	
+	if (operation->isFusedOperation()) {
+		/* list the fused operations in evaluation order */
+		const FusedOperation *fused = (const FusedOperation *)operation;
+		for (unsigned int k = 0; k < fused->getNumberOfFusedOperations(); k++) {
+			const NodeOperation *fused_op = fused->getFusedOperation(k);
+			len += snprintf(str + len, maxlen > len ? maxlen - len : 0, "\\n%u: %s (%s)", k, m_op_names[fused_op].c_str(), typeid(*fused_op).name());
+		}
+	}
+	
 	int totoutputs = operation->getNumberOfOutputSockets();
 	if (totoutputs != 0) {
 		len += snprintf(str + len, maxlen > len ? maxlen - len : 0, "|");
@@ -246,6 +264,7 @@ int DebugInfo::graphviz_legend(char *str, int maxlen)
 	len += graphviz_legend_color("Write Buffer", "darkorange", str + len, maxlen > len ? maxlen - len : 0);
 	len += graphviz_legend_color("Read Buffer", "darkolivegreen3", str + len, maxlen > len ? maxlen - len : 0);
 	len += graphviz_legend_color("Input Value", "khaki1", str + len, maxlen > len ? maxlen - len : 0);
+	len += graphviz_legend_color("Fused Operations", "plum", str + len, maxlen > len ? maxlen - len : 0);
 
 	len += snprintf(str + len, maxlen > len ? maxlen - len : 0, "<TR><TD></TD></TR>\r\n");
 
@@ -418,6 +437,7 @@ void DebugInfo::node_added(const Node * /*node*/) {}
 void DebugInfo::node_to_operations(const Node * /*node*/) {}
 void DebugInfo::operation_added(const NodeOperation * /*operation*/) {}
 void DebugInfo::operation_read_write_buffer(const NodeOperation * /*operation*/) {}
+void DebugInfo::operation_fused(const NodeOperation * /*fused*/, const NodeOperation * /*output*/) {}
 void DebugInfo::execution_group_started(const ExecutionGroup * /*group*/) {}
 void DebugInfo::execution_group_finished(const ExecutionGroup * /*group*/) {}
 void DebugInfo::graphviz(const ExecutionSystem * /*system*/) {}
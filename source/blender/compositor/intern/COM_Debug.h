@@ -54,6 +54,7 @@ public:
 	static void node_to_operations(const Node *node);
 	static void operation_added(const NodeOperation *operation);
 	static void operation_read_write_buffer(const NodeOperation *operation);
+	static void operation_fused(const NodeOperation *fused, const NodeOperation *output);
 	
 	static void execution_group_started(const ExecutionGroup *group);
 	static void execution_group_finished(const ExecutionGroup *group);
@@ -50,6 +50,8 @@ ExecutionGroup::ExecutionGroup()
 	this->m_isOutput = false;
 	this->m_complex = false;
 	this->m_chunkExecutionStates = NULL;
+	this->m_chunkDependencies = NULL;
+	this->m_chunkDependents = NULL;
 	this->m_bTree = NULL;
 	this->m_height = 0;
 	this->m_width = 0;
@@ -63,6 +65,12 @@ ExecutionGroup::ExecutionGroup()
 	this->m_chunksFinished = 0;
 	BLI_rcti_init(&this->m_viewerBorder, 0, 0, 0, 0);
 	this->m_executionStartTime = 0;
+	BLI_mutex_init(&this->m_chunkMutex);
+}
+
+ExecutionGroup::~ExecutionGroup()
+{
+	BLI_mutex_end(&this->m_chunkMutex);
 }
 
 CompositorPriority ExecutionGroup::getRenderPriotrity()
@@ -113,15 +121,25 @@ void ExecutionGroup::initExecution()
 	if (this->m_chunkExecutionStates != NULL) {
 		MEM_freeN(this->m_chunkExecutionStates);
 	}
+	if (this->m_chunkDependencies != NULL) {
+		MEM_freeN(this->m_chunkDependencies);
+	}
+	if (this->m_chunkDependents != NULL) {
+		delete[] this->m_chunkDependents;
+	}
 	unsigned int index;
 	determineNumberOfChunks();
 
 	this->m_chunkExecutionStates = NULL;
+	this->m_chunkDependencies = NULL;
+	this->m_chunkDependents = NULL;
 	if (this->m_numberOfChunks != 0) {
 		this->m_chunkExecutionStates = (ChunkExecutionState *)MEM_mallocN(sizeof(ChunkExecutionState) * this->m_numberOfChunks, __func__);
 		for (index = 0; index < this->m_numberOfChunks; index++) {
 			this->m_chunkExecutionStates[index] = COM_ES_NOT_SCHEDULED;
 		}
+		this->m_chunkDependencies = (unsigned int *)MEM_callocN(sizeof(unsigned int) * this->m_numberOfChunks, __func__);
+		this->m_chunkDependents = new ChunkReferences[this->m_numberOfChunks];
 	}
 
 
@@ -146,12 +164,40 @@ void ExecutionGroup::deinitExecution()
 		MEM_freeN(this->m_chunkExecutionStates);
 		this->m_chunkExecutionStates = NULL;
 	}
+	if (this->m_chunkDependencies != NULL) {
+		MEM_freeN(this->m_chunkDependencies);
+		this->m_chunkDependencies = NULL;
+	}
+	if (this->m_chunkDependents != NULL) {
+		delete[] this->m_chunkDependents;
+		this->m_chunkDependents = NULL;
+	}
 	this->m_numberOfChunks = 0;
 	this->m_numberOfXChunks = 0;
 	this->m_numberOfYChunks = 0;
 	this->m_cachedReadOperations.clear();
 	this->m_bTree = NULL;
 }
+
+void ExecutionGroup::setChunksExecuted()
+{
+	for (unsigned int index = 0; index < this->m_numberOfChunks; index++) {
+		this->m_chunkExecutionStates[index] = COM_ES_EXECUTED;
+	}
+}
+
+bool ExecutionGroup::isExecuted() const
+{
+	if (this->m_chunkExecutionStates == NULL) {
+		return false;
+	}
+	for (unsigned int index = 0; index < this->m_numberOfChunks; index++) {
+		if (this->m_chunkExecutionStates[index] != COM_ES_EXECUTED) {
+			return false;
+		}
+	}
+	return true;
+}
 void ExecutionGroup::determineResolution(unsigned int resolution[2])
 {
 	NodeOperation *operation = this->getOutputOperation();
@@ -304,52 +350,48 @@ void ExecutionGroup::execute(ExecutionSystem *graph)
 	DebugInfo::execution_group_started(this);
 	DebugInfo::graphviz(graph);
 
-	bool breaked = false;
-	bool finished = false;
-	unsigned int startIndex = 0;
-	const int maxNumberEvaluated = BLI_system_thread_count() * 2;
-
-	while (!finished && !breaked) {
-		bool startEvaluated = false;
-		finished = true;
-		int numberEvaluated = 0;
-
-		for (index = startIndex; index < this->m_numberOfChunks && numberEvaluated < maxNumberEvaluated; index++) {
-			chunkNumber = chunkOrder[index];
-			int yChunk = chunkNumber / this->m_numberOfXChunks;
-			int xChunk = chunkNumber - (yChunk * this->m_numberOfXChunks);
-			const ChunkExecutionState state = this->m_chunkExecutionStates[chunkNumber];
-			if (state == COM_ES_NOT_SCHEDULED) {
-				scheduleChunkWhenPossible(graph, xChunk, yChunk);
-				finished = false;
-				startEvaluated = true;
-				numberEvaluated++;
-
-				if (bTree->update_draw)
-					bTree->update_draw(bTree->udh);
-			}
-			else if (state == COM_ES_SCHEDULED) {
-				finished = false;
-				startEvaluated = true;
-				numberEvaluated++;
-			}
-			else if (state == COM_ES_EXECUTED && !startEvaluated) {
-				startIndex = index + 1;
-			}
-		}
-
-		WorkScheduler::finish();
+	const int proxyStep = operation->isViewerOperation() ? context.getViewerProxyStep() : 1;
+	if (proxyStep > 1 && !this->m_singleThreaded) {
+		/* a zoomed out viewer is shown at the display resolution first, the chunks of the
+		 * input groups stay executed so the full resolution pass only executes the viewer again */
+		ViewerOperation *viewer = (ViewerOperation *)operation;
+		viewer->setProxyStep(proxyStep);
+		executeChunks(chunkOrder);
+		viewer->setProxyStep(1);
 
-		if (bTree->test_break && bTree->test_break(bTree->tbh)) {
-			breaked = true;
+		if (!(bTree->test_break && bTree->test_break(bTree->tbh))) {
+			for (index = 0; index < this->m_numberOfChunks; index++) {
+				this->m_chunkExecutionStates[index] = COM_ES_NOT_SCHEDULED;
+			}
+			this->m_chunksFinished = 0;
+			executeChunks(chunkOrder);
 		}
 	}
+	else {
+		executeChunks(chunkOrder);
+	}
+
 	DebugInfo::execution_group_finished(this);
 	DebugInfo::graphviz(graph);
 
 	MEM_freeN(chunkOrder);
 }
 
+void ExecutionGroup::executeChunks(const unsigned int *chunkOrder)
+{
+	/* request all chunks at once, every chunk starts as soon as its input chunks are executed,
+	 * the WorkScheduler never waits for a whole ExecutionGroup between the chunks */
+	for (unsigned int index = 0; index < this->m_numberOfChunks; index++) {
+		scheduleChunkWhenPossible(chunkOrder[index], NULL, 0);
+
+		if (this->m_bTree->test_break && this->m_bTree->test_break(this->m_bTree->tbh)) {
+			break;
+		}
+	}
+
+	WorkScheduler::finish();
+}
+
 MemoryBuffer **ExecutionGroup::getInputBuffersOpenCL(int chunkNumber)
 {
 	rcti rect;
@@ -370,19 +412,44 @@ MemoryBuffer **ExecutionGroup::getInputBuffersOpenCL(int chunkNumber)
 	return memoryBuffers;
 }
 
+MemoryBuffer **ExecutionGroup::getInputBuffersStreaming()
+{
+	/* the areas are read when the chunk first needs them, see readInputBufferStreaming */
+	for (unsigned int index = 0; index < this->m_cachedReadOperations.size(); index++) {
+		ReadBufferOperation *readOperation = (ReadBufferOperation *)this->m_cachedReadOperations[index];
+		if (readOperation->getMemoryProxy()->isStreaming()) {
+			return (MemoryBuffer **)MEM_callocN(sizeof(MemoryBuffer *) * this->m_cachedMaxReadBufferOffset, __func__);
+		}
+	}
+	return NULL;
+}
+
+MemoryBuffer *ExecutionGroup::readInputBufferStreaming(int chunkNumber, ReadBufferOperation *readOperation)
+{
+	rcti rect;
+	rcti output;
+	determineChunkRect(&rect, chunkNumber);
+
+	this->determineDependingAreaOfInterest(&rect, readOperation, &output);
+	/* bilinear sampling of the last row also reads the row below it */
+	output.ymax += COM_STREAMING_BAND_MARGIN;
+	return readOperation->getMemoryProxy()->readArea(&output);
+}
+
 MemoryBuffer *ExecutionGroup::constructConsolidatedMemoryBuffer(MemoryProxy *memoryProxy, rcti *rect)
 {
-	MemoryBuffer *imageBuffer = memoryProxy->getBuffer();
-	MemoryBuffer *result = new MemoryBuffer(memoryProxy, rect);
-	result->copyContentFrom(imageBuffer);
-	return result;
+	return memoryProxy->readArea(rect);
 }
 
 void ExecutionGroup::finalizeChunkExecution(int chunkNumber, MemoryBuffer **memoryBuffers)
 {
-	if (this->m_chunkExecutionStates[chunkNumber] == COM_ES_SCHEDULED)
-		this->m_chunkExecutionStates[chunkNumber] = COM_ES_EXECUTED;
-	
+	ChunkReferences dependents;
+
+	BLI_mutex_lock(&this->m_chunkMutex);
+	this->m_chunkExecutionStates[chunkNumber] = COM_ES_EXECUTED;
+	dependents.swap(this->m_chunkDependents[chunkNumber]);
+	BLI_mutex_unlock(&this->m_chunkMutex);
+
 	atomic_add_and_fetch_u(&this->m_chunksFinished, 1);
 	if (memoryBuffers) {
 		for (unsigned int index = 0; index < this->m_cachedMaxReadBufferOffset; index++) {
@@ -396,6 +463,12 @@ void ExecutionGroup::finalizeChunkExecution(int chunkNumber, MemoryBuffer **memo
 		}
 		MEM_freeN(memoryBuffers);
 	}
+
+	/* the output of the chunk is written, start the chunks that were waiting for it */
+	for (ChunkReferences::const_iterator it = dependents.begin(); it != dependents.end(); ++it) {
+		it->first->releaseChunkDependency(it->second);
+	}
+
 	if (this->m_bTree) {
 		// status report is only performed for top level Execution Groups.
 		float progress = this->m_chunksFinished;
@@ -407,6 +480,9 @@ void ExecutionGroup::finalizeChunkExecution(int chunkNumber, MemoryBuffer **memo
 		             this->m_chunksFinished,
 		             this->m_numberOfChunks);
 		this->m_bTree->stats_draw(this->m_bTree->sdh, buf);
+
+		if (this->m_bTree->update_draw)
+			this->m_bTree->update_draw(this->m_bTree->udh);
 	}
 }
 
@@ -448,10 +524,11 @@ MemoryBuffer *ExecutionGroup::allocateOutputBuffer(int /*chunkNumber*/,
 }
 
 
-bool ExecutionGroup::scheduleAreaWhenPossible(ExecutionSystem *graph, rcti *area)
+void ExecutionGroup::scheduleAreaWhenPossible(rcti *area, ExecutionGroup *dependent, unsigned int dependentChunk)
 {
 	if (this->m_singleThreaded) {
-		return scheduleChunkWhenPossible(graph, 0, 0);
+		scheduleChunkWhenPossible(0, dependent, dependentChunk);
+		return;
 	}
 	// find all chunks inside the rect
 	// determine minxchunk, minychunk, maxxchunk, maxychunk where x and y are chunknumbers
@@ -470,79 +547,74 @@ bool ExecutionGroup::scheduleAreaWhenPossible(ExecutionSystem *graph, rcti *area
 	maxxchunk = min_ii(maxxchunk, (int)m_numberOfXChunks);
 	maxychunk = min_ii(maxychunk, (int)m_numberOfYChunks);
 
-	bool result = true;
-	for (indexx = minxchunk; indexx < maxxchunk; indexx++) {
-		for (indexy = minychunk; indexy < maxychunk; indexy++) {
-			if (!scheduleChunkWhenPossible(graph, indexx, indexy)) {
-				result = false;
-			}
+	for (indexy = minychunk; indexy < maxychunk; indexy++) {
+		for (indexx = minxchunk; indexx < maxxchunk; indexx++) {
+			scheduleChunkWhenPossible(indexy * this->m_numberOfXChunks + indexx, dependent, dependentChunk);
 		}
 	}
+}
+
+void ExecutionGroup::scheduleChunk(unsigned int chunkNumber)
+{
+	BLI_mutex_lock(&this->m_chunkMutex);
+	this->m_chunkExecutionStates[chunkNumber] = COM_ES_SCHEDULED;
+	BLI_mutex_unlock(&this->m_chunkMutex);
 
-	return result;
+	WorkScheduler::schedule(this, chunkNumber);
 }
 
-bool ExecutionGroup::scheduleChunk(unsigned int chunkNumber)
+void ExecutionGroup::releaseChunkDependency(unsigned int chunkNumber)
 {
-	if (this->m_chunkExecutionStates[chunkNumber] == COM_ES_NOT_SCHEDULED) {
-		this->m_chunkExecutionStates[chunkNumber] = COM_ES_SCHEDULED;
-		WorkScheduler::schedule(this, chunkNumber);
-		return true;
+	if (atomic_sub_and_fetch_u(&this->m_chunkDependencies[chunkNumber], 1) == 0) {
+		scheduleChunk(chunkNumber);
 	}
-	return false;
 }
 
-bool ExecutionGroup::scheduleChunkWhenPossible(ExecutionSystem *graph, int xChunk, int yChunk)
+void ExecutionGroup::scheduleChunkWhenPossible(unsigned int chunkNumber, ExecutionGroup *dependent, unsigned int dependentChunk)
 {
-	if (xChunk < 0 || xChunk >= (int)this->m_numberOfXChunks) {
-		return true;
-	}
-	if (yChunk < 0 || yChunk >= (int)this->m_numberOfYChunks) {
-		return true;
-	}
-	int chunkNumber = yChunk * this->m_numberOfXChunks + xChunk;
-	// chunk is already executed
-	if (this->m_chunkExecutionStates[chunkNumber] == COM_ES_EXECUTED) {
-		return true;
+	bool requested = false;
+
+	BLI_mutex_lock(&this->m_chunkMutex);
+	const ChunkExecutionState state = this->m_chunkExecutionStates[chunkNumber];
+	if (state != COM_ES_EXECUTED) {
+		if (dependent) {
+			/* count the dependency before the chunk can finish and release it */
+			atomic_add_and_fetch_u(&dependent->m_chunkDependencies[dependentChunk], 1);
+			this->m_chunkDependents[chunkNumber].push_back(ChunkReference(dependent, dependentChunk));
+		}
+		if (state == COM_ES_NOT_SCHEDULED) {
+			this->m_chunkExecutionStates[chunkNumber] = COM_ES_WAITING;
+			/* held while the inputs are requested, so the chunk isn't scheduled halfway */
+			this->m_chunkDependencies[chunkNumber] = 1;
+			requested = true;
+		}
 	}
+	BLI_mutex_unlock(&this->m_chunkMutex);
 
-	// chunk is scheduled, but not executed
-	if (this->m_chunkExecutionStates[chunkNumber] == COM_ES_SCHEDULED) {
-		return false;
+	if (!requested) {
+		return;
 	}
 
-	// chunk is nor executed nor scheduled.
-	vector<MemoryProxy *> memoryProxies;
-	this->determineDependingMemoryProxies(&memoryProxies);
-
+	// chunk is requested for the first time, request the chunks of its input area
 	rcti rect;
-	determineChunkRect(&rect, xChunk, yChunk);
-	unsigned int index;
-	bool canBeExecuted = true;
 	rcti area;
+	determineChunkRect(&rect, chunkNumber);
 
-	for (index = 0; index < this->m_cachedReadOperations.size(); index++) {
+	for (unsigned int index = 0; index < this->m_cachedReadOperations.size(); index++) {
 		ReadBufferOperation *readOperation = (ReadBufferOperation *)this->m_cachedReadOperations[index];
 		BLI_rcti_init(&area, 0, 0, 0, 0);
-		MemoryProxy *memoryProxy = memoryProxies[index];
 		determineDependingAreaOfInterest(&rect, readOperation, &area);
-		ExecutionGroup *group = memoryProxy->getExecutor();
+		ExecutionGroup *group = readOperation->getMemoryProxy()->getExecutor();
 
 		if (group != NULL) {
-			if (!group->scheduleAreaWhenPossible(graph, &area)) {
-				canBeExecuted = false;
-			}
+			group->scheduleAreaWhenPossible(&area, this, chunkNumber);
 		}
 		else {
 			throw "ERROR";
 		}
 	}
 
-	if (canBeExecuted) {
-		scheduleChunk(chunkNumber);
-	}
-
-	return false;
+	releaseChunkDependency(chunkNumber);
 }
 
 void ExecutionGroup::determineDependingAreaOfInterest(rcti *input, ReadBufferOperation *readOperation, rcti *output)
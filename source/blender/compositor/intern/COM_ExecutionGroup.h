@@ -27,6 +27,9 @@
 #include "COM_NodeOperation.h"
 #include <vector>
 #include "BLI_rect.h"
+extern "C" {
+#  include "BLI_threads.h"
+}
 #include "COM_MemoryProxy.h"
 #include "COM_Device.h"
 #include "COM_CompositorContext.h"
@@ -47,14 +50,18 @@ typedef enum ChunkExecutionState {
 	 * @brief chunk is not yet scheduled
 	 */
 	COM_ES_NOT_SCHEDULED = 0,
+	/**
+	 * @brief chunk is requested, but waits for chunks of its input area
+	 */
+	COM_ES_WAITING = 1,
 	/**
 	 * @brief chunk is scheduled, but not yet executed
 	 */
-	COM_ES_SCHEDULED = 1,
+	COM_ES_SCHEDULED = 2,
 	/**
 	 * @brief chunk is executed.
 	 */
-	COM_ES_EXECUTED = 2
+	COM_ES_EXECUTED = 3
 } ChunkExecutionState;
 
 /**
@@ -65,6 +72,8 @@ typedef enum ChunkExecutionState {
 class ExecutionGroup {
 public:
 	 typedef std::vector<NodeOperation*> Operations;
+	 typedef std::pair<ExecutionGroup *, unsigned int> ChunkReference;
+	 typedef std::vector<ChunkReference> ChunkReferences;
 	
 private:
 	// fields
@@ -151,11 +160,29 @@ private:
 	/**
 	 * @brief the chunkExecutionStates holds per chunk the execution state. this state can be
 	 *   - COM_ES_NOT_SCHEDULED: not scheduled
+	 *   - COM_ES_WAITING: waiting for input chunks
 	 *   - COM_ES_SCHEDULED: scheduled
 	 *   - COM_ES_EXECUTED: executed
 	 */
 	ChunkExecutionState *m_chunkExecutionStates;
 	
+	/**
+	 * @brief per chunk the number of input chunks that have not been executed yet
+	 * the chunk is scheduled in the WorkScheduler when this reaches zero
+	 */
+	unsigned int *m_chunkDependencies;
+	
+	/**
+	 * @brief per chunk the chunks of other ExecutionGroups waiting for it
+	 */
+	ChunkReferences *m_chunkDependents;
+	
+	/**
+	 * @brief protects the execution states and dependents of the chunks,
+	 * chunks are requested and finished from all threads
+	 */
+	ThreadMutex m_chunkMutex;
+	
 	/**
 	 * @brief indicator when this ExecutionGroup has valid Operations in its vector for Execution
 	 * @note When building the ExecutionGroup Operations are added via recursion. First a WriteBufferOperations is added, then the
@@ -208,34 +235,41 @@ private:
 	void determineNumberOfChunks();
 	
 	/**
-	 * @brief try to schedule a specific chunk.
-	 * @note scheduling succeeds when all input requirements are met and the chunks hasn't been scheduled yet.
-	 * @param graph
-	 * @param xChunk
-	 * @param yChunk
-	 * @return [true:false]
-	 * true: package(s) are scheduled
-	 * false: scheduling is deferred (depending workpackages are scheduled)
+	 * @brief request a specific chunk.
+	 * @note the first request of a chunk requests the chunks of its input area in the ExecutionGroups it reads from,
+	 * @note the chunk is scheduled as soon as all of them are executed.
+	 * @param chunkNumber
+	 * @param dependent ExecutionGroup of the chunk that reads the requested chunk, NULL for the output chunks
+	 * @param dependentChunk the chunk of the dependent that waits until the requested chunk is executed
 	 */
-	bool scheduleChunkWhenPossible(ExecutionSystem *graph, int xChunk, int yChunk);
+	void scheduleChunkWhenPossible(unsigned int chunkNumber, ExecutionGroup *dependent, unsigned int dependentChunk);
 
 	/**
-	 * @brief try to schedule a specific area.
-	 * @note Check if a certain area is available, when not available this are will be checked.
+	 * @brief request all chunks of a specific area.
 	 * @note This method is called from other ExecutionGroup's.
-	 * @param graph
 	 * @param rect
-	 * @return [true:false]
-	 * true: package(s) are scheduled
-	 * false: scheduling is deferred (depending workpackages are scheduled)
+	 * @param dependent ExecutionGroup of the chunk that reads the area
+	 * @param dependentChunk the chunk of the dependent that waits until the area is executed
+	 */
+	void scheduleAreaWhenPossible(rcti *rect, ExecutionGroup *dependent, unsigned int dependentChunk);
+
+	/**
+	 * @brief an input chunk of a chunk has been executed, schedule the chunk when it was the last one
+	 * @param chunkNumber
 	 */
-	bool scheduleAreaWhenPossible(ExecutionSystem *graph, rcti *rect);
+	void releaseChunkDependency(unsigned int chunkNumber);
 
 	/**
 	 * @brief add a chunk to the WorkScheduler.
 	 * @param chunknumber
 	 */
-	bool scheduleChunk(unsigned int chunkNumber);
+	void scheduleChunk(unsigned int chunkNumber);
+
+	/**
+	 * @brief request all output chunks in the given order and wait until they are executed
+	 * @param chunkOrder chunk numbers in the order they are requested
+	 */
+	void executeChunks(const unsigned int *chunkOrder);
 	
 	/**
 	 * @brief determine the area of interest of a certain input area
@@ -250,6 +284,7 @@ private:
 public:
 	// constructors
 	ExecutionGroup();
+	~ExecutionGroup();
 	
 	// methods
 	/**
@@ -338,6 +373,23 @@ public:
 	 */
 	MemoryBuffer **getInputBuffersOpenCL(int chunkNumber);
 
+	/**
+	 * @brief allocate the table of the streaming input buffers of a chunk
+	 * @note buffers of MemoryProxies that are not streaming are read directly
+	 * @return (MemoryBuffer **) the inputbuffers indexed by ReadBufferOperation offset, all NULL
+	 * until read by readInputBufferStreaming, NULL when no input is streaming
+	 * @see MemoryProxy.isStreaming
+	 */
+	MemoryBuffer **getInputBuffersStreaming();
+
+	/**
+	 * @brief read the area of a streaming input buffer needed to calculate a chunk
+	 * @param chunkNumber the chunk to be calculated
+	 * @param readOperation the ReadBufferOperation of the streaming MemoryProxy
+	 * @return a band of whole rows, temporarily unless it covers the whole buffer
+	 */
+	MemoryBuffer *readInputBufferStreaming(int chunkNumber, ReadBufferOperation *readOperation);
+
 	/**
 	 * @brief allocate the outputbuffer of a chunk
 	 * @param chunkNumber the number of the chunk in the ExecutionGroup
@@ -348,6 +400,7 @@ public:
 
 	/**
 	 * @brief after a chunk is executed the needed resources can be freed or unlocked.
+	 * @note the chunks waiting for this chunk are released
 	 * @param chunknumber
 	 * @param memorybuffers
 	 */
@@ -358,6 +411,18 @@ public:
 	 * @note It will release all needed resources
 	 */
 	void deinitExecution();
+
+	/**
+	 * @brief mark all chunks of this ExecutionGroup as executed
+	 * @note used when the output buffer has been restored from the CompositorCache,
+	 * the group will not be scheduled anymore during this execution
+	 */
+	void setChunksExecuted();
+
+	/**
+	 * @brief have all chunks of this ExecutionGroup been executed
+	 */
+	bool isExecuted() const;
 	
 	
 	/**
@@ -369,7 +434,12 @@ public:
 	 *   - CenterX
 	 *   - CenterY
 	 *
-	 * After determining the order of the chunks the chunks will be scheduled
+	 * After determining the order of the chunks all chunks are requested. A requested chunk is scheduled
+	 * as soon as the chunks of its input area are executed, so chunks of different ExecutionGroups
+	 * run at the same time instead of waiting for each other group by group.
+	 *
+	 * When CompositorContext.getViewerProxyStep is larger than 1 a viewer is executed twice, first
+	 * as a preview at the display resolution and then at full resolution.
 	 *
 	 * @see ViewerOperation
 	 * @param system
@@ -413,8 +483,9 @@ public:
 
 	void setRenderBorder(float xmin, float xmax, float ymin, float ymax);
 
-	/* allow the DebugInfo class to look at internals */
+	/* allow the DebugInfo and Profiler classes to look at internals */
 	friend class DebugInfo;
+	friend class Profiler;
 
 #ifdef WITH_CXX_GUARDEDALLOC
 	MEM_CXX_CLASS_ALLOC_FUNCS("COM:ExecutionGroup")
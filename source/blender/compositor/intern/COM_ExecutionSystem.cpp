@@ -22,10 +22,13 @@
 
 #include "COM_ExecutionSystem.h"
 
+#include <set>
+
 #include "PIL_time.h"
 #include "BLI_utildefines.h"
 extern "C" {
 #include "BKE_node.h"
+#include "DNA_userdef_types.h"
 }
 
 #include "BLT_translation.h"
@@ -36,12 +39,45 @@ extern "C" {
 #include "COM_ExecutionGroup.h"
 #include "COM_WorkScheduler.h"
 #include "COM_ReadBufferOperation.h"
+#include "COM_WriteBufferOperation.h"
 #include "COM_Debug.h"
+#include "COM_Profiler.h"
 
 #ifdef WITH_CXX_GUARDEDALLOC
 #include "MEM_guardedalloc.h"
 #endif
 
+/* the user preference, COM_STREAMING_MEMORY_LIMIT before preferences are read */
+static size_t streaming_memory_limit()
+{
+	if (U.compositor_memory_limit > 0) {
+		return (size_t)U.compositor_memory_limit * 1024 * 1024;
+	}
+	return COM_STREAMING_MEMORY_LIMIT;
+}
+
+/* is depth one of the inputs the operation is calculated from, through the buffers it reads */
+static bool depends_on_depth(NodeOperation *operation, std::set<NodeOperation *> &visited)
+{
+	if (!visited.insert(operation).second) {
+		return false;
+	}
+	if (operation->isDepth()) {
+		return true;
+	}
+	if (operation->isReadBufferOperation()) {
+		MemoryProxy *memoryProxy = ((ReadBufferOperation *)operation)->getMemoryProxy();
+		return depends_on_depth(memoryProxy->getWriteBufferOperation(), visited);
+	}
+	for (unsigned int index = 0; index < operation->getNumberOfInputSockets(); index++) {
+		NodeOperationOutput *link = operation->getInputSocket(index)->getLink();
+		if (link && depends_on_depth(&link->getOperation(), visited)) {
+			return true;
+		}
+	}
+	return false;
+}
+
 ExecutionSystem::ExecutionSystem(RenderData *rd, Scene *scene, bNodeTree *editingtree, bool rendering, bool fastcalculation,
                                  const ColorManagedViewSettings *viewSettings, const ColorManagedDisplaySettings *displaySettings,
                                  const char *viewName)
@@ -78,6 +114,20 @@ ExecutionSystem::ExecutionSystem(RenderData *rd, Scene *scene, bNodeTree *editin
 	                         viewer_border->xmin < viewer_border->xmax &&
 	                         viewer_border->ymin < viewer_border->ymax;
 
+	/* while editing only the part of the viewer visible in the editors is calculated, the areas of
+	 * interest of the operations take care of the filter margins in the groups it reads from */
+	rctf viewer_region = editingtree->viewer_region;
+	bool use_viewer_region = !rendering && (editingtree->flag & NTREE_VIEWER_REGION);
+	if (use_viewer_region) {
+		if (use_viewer_border) {
+			BLI_rctf_isect(viewer_border, &editingtree->viewer_region, &viewer_region);
+		}
+		/* when zoomed out the viewer is shown at the display resolution before the full resolution */
+		if (editingtree->viewer_zoom > 0.0f && editingtree->viewer_zoom < 1.0f) {
+			this->m_context.setViewerProxyStep(min_ii((int)(1.0f / editingtree->viewer_zoom), COM_VIEWER_PROXY_MAX_STEP));
+		}
+	}
+
 	editingtree->stats_draw(editingtree->sdh, IFACE_("Compositing | Determining resolution"));
 
 	for (index = 0; index < this->m_groups.size(); index++) {
@@ -96,7 +146,11 @@ ExecutionSystem::ExecutionSystem(RenderData *rd, Scene *scene, bNodeTree *editin
 			}
 		}
 
-		if (use_viewer_border) {
+		if (use_viewer_region && executionGroup->getOutputOperation()->isViewerOperation()) {
+			executionGroup->setViewerBorder(viewer_region.xmin, viewer_region.xmax,
+			                                viewer_region.ymin, viewer_region.ymax);
+		}
+		else if (use_viewer_border) {
 			executionGroup->setViewerBorder(viewer_border->xmin, viewer_border->xmax,
 			                                viewer_border->ymin, viewer_border->ymax);
 		}
@@ -132,6 +186,7 @@ void ExecutionSystem::execute()
 	editingtree->stats_draw(editingtree->sdh, IFACE_("Compositing | Initializing execution"));
 
 	DebugInfo::execute_started(this);
+	Profiler::execute_started(this);
 	
 	unsigned int order = 0;
 	for (vector<NodeOperation *>::iterator iter = this->m_operations.begin(); iter != this->m_operations.end(); ++iter) {
@@ -144,11 +199,30 @@ void ExecutionSystem::execute()
 	}
 	unsigned int index;
 
+	/* make room before the buffers of this execution are allocated */
+	CompositorCache::enforce_limits();
+
+	/* keep the buffers in tiles when they won't fit in the memory budget,
+	 * half float buffers are always kept in tiles */
+	const bool streaming = useStreaming();
+	const bool halfFloat = this->m_context.isHalfFloatBuffersEnabled();
+	MemoryTileStore *tileStore = NULL;
+	if (streaming || halfFloat) {
+		tileStore = new MemoryTileStore(this->m_context.getChunksize(), streaming ? streaming_memory_limit() : (size_t)-1);
+	}
+
 	// First allocale all write buffer
 	for (index = 0; index < this->m_operations.size(); index++) {
 		NodeOperation *operation = this->m_operations[index];
 		if (operation->isWriteBufferOperation()) {
+			WriteBufferOperation *writeOperation = (WriteBufferOperation *)operation;
+			MemoryProxy *memoryProxy = writeOperation->getMemoryProxy();
+			memoryProxy->setHalfFloat(useHalfFloat(memoryProxy));
+			if (streaming || memoryProxy->isHalfFloat()) {
+				memoryProxy->setTileStore(tileStore);
+			}
 			operation->setbNodeTree(this->m_context.getbNodeTree());
+			ProfileScope scope(COM_PROFILE_INIT, operation, NULL, NULL);
 			operation->initExecution();
 		}
 	}
@@ -165,6 +239,7 @@ void ExecutionSystem::execute()
 		NodeOperation *operation = this->m_operations[index];
 		if (!operation->isWriteBufferOperation()) {
 			operation->setbNodeTree(this->m_context.getbNodeTree());
+			ProfileScope scope(COM_PROFILE_INIT, operation, NULL, NULL);
 			operation->initExecution();
 		}
 	}
@@ -174,6 +249,9 @@ void ExecutionSystem::execute()
 		executionGroup->initExecution();
 	}
 
+	CachedGroups cachedGroups;
+	restoreCachedGroups(&cachedGroups);
+
 	WorkScheduler::start(this->m_context);
 
 	executeGroups(COM_PRIORITY_HIGH);
@@ -185,6 +263,8 @@ void ExecutionSystem::execute()
 	WorkScheduler::finish();
 	WorkScheduler::stop();
 
+	storeCachedGroups(cachedGroups);
+
 	editingtree->stats_draw(editingtree->sdh, IFACE_("Compositing | De-initializing execution"));
 	for (index = 0; index < this->m_operations.size(); index++) {
 		NodeOperation *operation = this->m_operations[index];
@@ -194,6 +274,116 @@ void ExecutionSystem::execute()
 		ExecutionGroup *executionGroup = this->m_groups[index];
 		executionGroup->deinitExecution();
 	}
+	if (tileStore) {
+		delete tileStore;
+	}
+
+	Profiler::execute_finished(this);
+}
+
+bool ExecutionSystem::useStreaming() const
+{
+#ifdef COM_STREAMING
+	size_t memoryNeeded = 0;
+	for (unsigned int index = 0; index < this->m_operations.size(); index++) {
+		NodeOperation *operation = this->m_operations[index];
+		if (operation->isWriteBufferOperation()) {
+			MemoryProxy *memoryProxy = ((WriteBufferOperation *)operation)->getMemoryProxy();
+			const size_t elementSize = useHalfFloat(memoryProxy) ? sizeof(uint16_t) : sizeof(float);
+			memoryNeeded += elementSize * operation->getWidth() * operation->getHeight() *
+			                COM_data_type_num_channels(memoryProxy->getDataType());
+		}
+	}
+	return memoryNeeded > streaming_memory_limit();
+#else
+	return false;
+#endif
+}
+
+bool ExecutionSystem::useHalfFloat(MemoryProxy *memoryProxy) const
+{
+	std::set<NodeOperation *> visited;
+
+	if (!this->m_context.isHalfFloatBuffersEnabled()) {
+		return false;
+	}
+	switch (memoryProxy->getDataType()) {
+		case COM_DT_COLOR:
+			return true;
+		case COM_DT_VALUE:
+			/* mattes and masks are fine in half floats, depth isn't */
+			return !depends_on_depth(memoryProxy->getWriteBufferOperation(), visited);
+		default:
+			/* vectors hold positions, normals and motion that need the precision */
+			return false;
+	}
+}
+
+void ExecutionSystem::restoreCachedGroups(CachedGroups *cachedGroups)
+{
+	const CompositorCache::Key contextHash = CompositorCache::hash_context(this->m_context);
+	CompositorCache::OperationHashes hashes;
+	bool restored = false;
+	unsigned int index;
+
+	for (index = 0; index < this->m_groups.size(); index++) {
+		ExecutionGroup *group = this->m_groups[index];
+		NodeOperation *output = group->getOutputOperation();
+		CompositorCache::Key key;
+
+		/* only expensive groups are worth the memory */
+		if (!group->isComplex() || !output->isWriteBufferOperation()) {
+			continue;
+		}
+		if (!CompositorCache::hash_operation(output, hashes, &key)) {
+			continue;
+		}
+		key = CompositorCache::hash_combine(contextHash, key);
+
+		MemoryProxy *memoryProxy = ((WriteBufferOperation *)output)->getMemoryProxy();
+		MemoryBuffer *allocated = memoryProxy->getBuffer();
+		/* streaming buffers are too large to keep */
+		if (allocated == NULL) {
+			continue;
+		}
+		MemoryBuffer *buffer = CompositorCache::acquire(key, memoryProxy->getDataType(),
+		                                                allocated->getWidth(), allocated->getHeight());
+		if (buffer) {
+			memoryProxy->setBuffer(buffer);
+			group->setChunksExecuted();
+			restored = true;
+		}
+		cachedGroups->push_back(std::make_pair(group, key));
+	}
+
+	/* read buffers still point to the memory allocated for the restored groups */
+	if (restored) {
+		for (index = 0; index < this->m_operations.size(); index++) {
+			NodeOperation *operation = this->m_operations[index];
+			if (operation->isReadBufferOperation()) {
+				ReadBufferOperation *readOperation = (ReadBufferOperation *)operation;
+				readOperation->updateMemoryBuffer();
+			}
+		}
+	}
+}
+
+void ExecutionSystem::storeCachedGroups(const CachedGroups &cachedGroups)
+{
+	const bNodeTree *editingtree = this->m_context.getbNodeTree();
+
+	/* a cancelled execution leaves incomplete buffers behind */
+	if (editingtree->test_break(editingtree->tbh)) {
+		return;
+	}
+
+	for (CachedGroups::const_iterator it = cachedGroups.begin(); it != cachedGroups.end(); ++it) {
+		ExecutionGroup *group = it->first;
+		if (group->isExecuted()) {
+			MemoryProxy *memoryProxy = ((WriteBufferOperation *)group->getOutputOperation())->getMemoryProxy();
+			CompositorCache::store(it->second, memoryProxy->releaseBuffer());
+		}
+	}
 }
 
 void ExecutionSystem::executeGroups(CompositorPriority priority)
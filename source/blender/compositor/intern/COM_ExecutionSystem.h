@@ -31,6 +31,7 @@ class ExecutionGroup;
 #include "BKE_text.h"
 #include "COM_ExecutionGroup.h"
 #include "COM_NodeOperation.h"
+#include "COM_CompositorCache.h"
 
 /**
  * @page execution Execution model
@@ -114,6 +115,7 @@ class ExecutionSystem {
 public:
 	typedef std::vector<NodeOperation*> Operations;
 	typedef std::vector<ExecutionGroup*> Groups;
+	typedef std::vector<std::pair<ExecutionGroup*, CompositorCache::Key> > CachedGroups;
 	
 private:
 	/**
@@ -142,6 +144,31 @@ private: //methods
 	 */
 	void findOutputExecutionGroup(vector<ExecutionGroup *> *result) const;
 
+	/**
+	 * @brief restore the output buffers of complex execution groups from the CompositorCache
+	 * restored groups are marked executed and won't be scheduled.
+	 * @param cachedGroups all groups that can be cached, with their keys
+	 */
+	void restoreCachedGroups(CachedGroups *cachedGroups);
+
+	/**
+	 * @brief hand the output buffers of the executed groups over to the CompositorCache
+	 * @note must be called before the write buffer operations are deinitialized
+	 */
+	void storeCachedGroups(const CachedGroups &cachedGroups);
+
+	/**
+	 * @brief do the buffers of all write buffer operations exceed the memory limit of the user preferences
+	 * @see MemoryTileStore
+	 */
+	bool useStreaming() const;
+
+	/**
+	 * @brief is the memory of the MemoryProxy stored as half floats
+	 * @see CompositorContext.isHalfFloatBuffersEnabled
+	 */
+	bool useHalfFloat(MemoryProxy *memoryProxy) const;
+
 public:
 	/**
 	 * @brief Create a new ExecutionSystem and initialize it with the
@@ -177,8 +204,9 @@ public:
 private:
 	void executeGroups(CompositorPriority priority);
 
-	/* allow the DebugInfo class to look at internals */
+	/* allow the DebugInfo and Profiler classes to look at internals */
 	friend class DebugInfo;
+	friend class Profiler;
 
 #ifdef WITH_CXX_GUARDEDALLOC
 	MEM_CXX_CLASS_ALLOC_FUNCS("COM:ExecutionSystem")
@@ -21,13 +21,14 @@
  */
 
 #include "COM_MemoryBuffer.h"
+#include "COM_Profiler.h"
 
 #include "MEM_guardedalloc.h"
 
 using std::min;
 using std::max;
 
-static unsigned int determine_num_channels(DataType datatype)
+unsigned int COM_data_type_num_channels(DataType datatype)
 {
 	switch (datatype) {
 		case COM_DT_VALUE:
@@ -61,8 +62,9 @@ MemoryBuffer::MemoryBuffer(MemoryProxy *memoryProxy, unsigned int chunkNumber, r
 	this->m_height = BLI_rcti_size_y(&this->m_rect);
 	this->m_memoryProxy = memoryProxy;
 	this->m_chunkNumber = chunkNumber;
-	this->m_num_channels = determine_num_channels(memoryProxy->getDataType());
+	this->m_num_channels = COM_data_type_num_channels(memoryProxy->getDataType());
 	this->m_buffer = (float *)MEM_mallocN_aligned(sizeof(float) * determineBufferSize() * this->m_num_channels, 16, "COM_MemoryBuffer");
+	Profiler::buffer_allocated(sizeof(float) * determineBufferSize() * this->m_num_channels);
 	this->m_state = COM_MB_ALLOCATED;
 	this->m_datatype = memoryProxy->getDataType();
 }
@@ -74,8 +76,9 @@ MemoryBuffer::MemoryBuffer(MemoryProxy *memoryProxy, rcti *rect)
 	this->m_height = BLI_rcti_size_y(&this->m_rect);
 	this->m_memoryProxy = memoryProxy;
 	this->m_chunkNumber = -1;
-	this->m_num_channels = determine_num_channels(memoryProxy->getDataType());
+	this->m_num_channels = COM_data_type_num_channels(memoryProxy->getDataType());
 	this->m_buffer = (float *)MEM_mallocN_aligned(sizeof(float) * determineBufferSize() * this->m_num_channels, 16, "COM_MemoryBuffer");
+	Profiler::buffer_allocated(sizeof(float) * determineBufferSize() * this->m_num_channels);
 	this->m_state = COM_MB_TEMPORARILY;
 	this->m_datatype = memoryProxy->getDataType();
 }
@@ -87,8 +90,9 @@ MemoryBuffer::MemoryBuffer(DataType dataType, rcti *rect)
 	this->m_height = this->m_rect.ymax - this->m_rect.ymin;
 	this->m_memoryProxy = NULL;
 	this->m_chunkNumber = -1;
-	this->m_num_channels = determine_num_channels(dataType);
+	this->m_num_channels = COM_data_type_num_channels(dataType);
 	this->m_buffer = (float *)MEM_mallocN_aligned(sizeof(float) * determineBufferSize() * this->m_num_channels, 16, "COM_MemoryBuffer");
+	Profiler::buffer_allocated(sizeof(float) * determineBufferSize() * this->m_num_channels);
 	this->m_state = COM_MB_TEMPORARILY;
 	this->m_datatype = dataType;
 }
@@ -199,7 +203,8 @@ void MemoryBuffer::addPixel(int x, int y, const float color[4])
 static void read_ewa_pixel_sampled(void *userdata, int x, int y, float result[4])
 {
 	MemoryBuffer *buffer = (MemoryBuffer *) userdata;
-	buffer->read(result, x, y);
+	/* the filter works relative to the buffer rect */
+	buffer->read(result, x + buffer->getRect()->xmin, y + buffer->getRect()->ymin);
 }
 
 void MemoryBuffer::readEWA(float *result, const float uv[2], const float derivatives[2][2])
@@ -211,7 +216,7 @@ void MemoryBuffer::readEWA(float *result, const float uv[2], const float derivat
 	 * but compositor uses pixel space. For now let's just divide the values and
 	 * switch compositor to normalized space for EWA later.
 	 */
-	float uv_normal[2] = {uv[0] * inv_width, uv[1] * inv_height};
+	float uv_normal[2] = {(uv[0] - this->m_rect.xmin) * inv_width, (uv[1] - this->m_rect.ymin) * inv_height};
 	float du_normal[2] = {derivatives[0][0] * inv_width, derivatives[0][1] * inv_height};
 	float dv_normal[2] = {derivatives[1][0] * inv_width, derivatives[1][1] * inv_height};
 
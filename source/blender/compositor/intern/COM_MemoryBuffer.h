@@ -55,6 +55,11 @@ typedef enum MemoryBufferExtend {
 
 class MemoryProxy;
 
+/**
+ * @brief number of floats stored per pixel for a datatype
+ */
+unsigned int COM_data_type_num_channels(DataType datatype);
+
 /**
  * @brief a MemoryBuffer contains access to the data of a chunk
  */
@@ -129,6 +134,17 @@ public:
 
 	unsigned int get_num_channels() { return this->m_num_channels; }
 
+	/**
+	 * @brief get the datatype of this MemoryBuffer
+	 */
+	DataType getDataType() const { return this->m_datatype; }
+
+	/**
+	 * @brief reassign the buffer to another proxy
+	 * @note only used when a buffer moves between executions through the CompositorCache
+	 */
+	void setMemoryProxy(MemoryProxy *memoryProxy) { this->m_memoryProxy = memoryProxy; }
+
 	/**
 	 * @brief get the data of this MemoryBuffer
 	 * @note buffer should already be available in memory
@@ -155,7 +171,7 @@ public:
 				break;
 			case COM_MB_EXTEND:
 				if (x < 0) x = 0;
-				if (x >= w) x = w;
+				if (x >= w) x = w - 1;
 				break;
 			case COM_MB_REPEAT:
 				x = (x >= 0.0f ? (x % w) : (x % w) + w);
@@ -167,7 +183,7 @@ public:
 				break;
 			case COM_MB_EXTEND:
 				if (y < 0) y = 0;
-				if (y >= h) y = h;
+				if (y >= h) y = h - 1;
 				break;
 			case COM_MB_REPEAT:
 				y = (y >= 0.0f ? (y % h) : (y % h) + h);
@@ -221,12 +237,53 @@ public:
 			int u = x;
 			int v = y;
 			this->wrap_pixel(u, v, extend_x, extend_y);
-			const int offset = (this->m_width * y + x) * this->m_num_channels;
+			const int offset = (this->m_width * v + u) * this->m_num_channels;
 			float *buffer = &this->m_buffer[offset];
 			memcpy(result, buffer, sizeof(float) * this->m_num_channels);
 		}
 	}
 
+	/**
+	 * @brief read num pixels of row y starting at x, pixels outside of the buffer are zero
+	 * @note every pixel is stored as float[4] in result like readSampled does,
+	 * only the channels of this buffer are written
+	 */
+	inline void readRow(float *result, int x, int y, int num)
+	{
+		const int num_channels = this->m_num_channels;
+		int i = 0;
+
+		if (y >= m_rect.ymin && y < m_rect.ymax) {
+			const int x_start = min_ii(max_ii(x, m_rect.xmin), x + num);
+			const int x_end = min_ii(x + num, m_rect.xmax);
+
+			for (; i < x_start - x; i++) {
+				memset(&result[i * COM_NUM_CHANNELS_COLOR], 0, num_channels * sizeof(float));
+			}
+
+			if (x_start < x_end) {
+				const float *buffer = &this->m_buffer[(this->m_width * (y - m_rect.ymin) + (x_start - m_rect.xmin)) *
+				                                      num_channels];
+				const int len = x_end - x_start;
+
+				if (num_channels == COM_NUM_CHANNELS_COLOR) {
+					memcpy(&result[i * COM_NUM_CHANNELS_COLOR], buffer, len * COM_NUM_CHANNELS_COLOR * sizeof(float));
+				}
+				else {
+					for (int j = 0; j < len; j++) {
+						memcpy(&result[(i + j) * COM_NUM_CHANNELS_COLOR], &buffer[j * num_channels],
+						       num_channels * sizeof(float));
+					}
+				}
+				i += len;
+			}
+		}
+
+		for (; i < num; i++) {
+			memset(&result[i * COM_NUM_CHANNELS_COLOR], 0, num_channels * sizeof(float));
+		}
+	}
+
 	inline void readNoCheck(float *result, int x, int y,
 	                        MemoryBufferExtend extend_x = COM_MB_CLIP,
 	                        MemoryBufferExtend extend_y = COM_MB_CLIP)
@@ -21,13 +21,120 @@
  */
 
 #include "COM_MemoryProxy.h"
+#include "COM_Profiler.h"
+
+#ifdef __F16C__
+#  include <immintrin.h>
+#endif
+
+/* ******** Half float conversion ******** */
+
+/* IEEE 754 binary16 rounding to nearest even, values outside of the half range
+ * (65504) are clamped so bright pixels don't become infinite, NaN is kept */
+#define HALF_MAX 65504.0f
+
+static inline uint16_t float_to_half(float value)
+{
+	const uint32_t f32infty = 255u << 23;
+	const uint32_t f16max = (127u + 16u) << 23;
+	const uint32_t denorm_magic = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+	uint32_t bits;
+	uint16_t result;
+
+	memcpy(&bits, &value, sizeof(bits));
+	const uint32_t sign = bits & 0x80000000u;
+	bits ^= sign;
+
+	if (bits > f32infty) {
+		result = 0x7e00;
+	}
+	else if (bits >= f16max) {
+		result = 0x7bff;
+	}
+	else if (bits < (113u << 23)) {
+		/* denormal or zero, the addition does the rounding */
+		float magic, shifted;
+		memcpy(&magic, &denorm_magic, sizeof(magic));
+		memcpy(&shifted, &bits, sizeof(shifted));
+		shifted += magic;
+		memcpy(&bits, &shifted, sizeof(bits));
+		result = (uint16_t)(bits - denorm_magic);
+	}
+	else {
+		const uint32_t mantissa_odd = (bits >> 13) & 1u;
+		bits += ((uint32_t)(15 - 127) << 23) + 0xfffu;
+		bits += mantissa_odd;
+		result = (uint16_t)min(bits >> 13, 0x7bffu);
+	}
+	return result | (uint16_t)(sign >> 16);
+}
+
+static inline float half_to_float(uint16_t value)
+{
+	/* rebias the exponent by multiplying, this also normalizes denormals */
+	const uint32_t magic_bits = (254u - 15u) << 23;
+	const uint32_t was_infnan = (127u + 16u) << 23;
+	uint32_t bits = (uint32_t)(value & 0x7fff) << 13;
+	float magic, result;
+
+	memcpy(&magic, &magic_bits, sizeof(magic));
+	memcpy(&result, &bits, sizeof(result));
+	result *= magic;
+	memcpy(&bits, &result, sizeof(bits));
+	if (bits >= was_infnan) {
+		bits |= 255u << 23;
+	}
+	bits |= (uint32_t)(value & 0x8000) << 16;
+	memcpy(&result, &bits, sizeof(result));
+	return result;
+}
+
+static void convert_float_to_half(uint16_t *dst, const float *src, size_t num)
+{
+	size_t i = 0;
+#ifdef __F16C__
+	const __m256 half_max = _mm256_set1_ps(HALF_MAX);
+	const __m256 half_min = _mm256_set1_ps(-HALF_MAX);
+	for (; i + 8 <= num; i += 8) {
+		/* the operand order keeps NaN */
+		const __m256 value = _mm256_max_ps(half_min, _mm256_min_ps(half_max, _mm256_loadu_ps(&src[i])));
+		_mm_storeu_si128((__m128i *)&dst[i], _mm256_cvtps_ph(value, _MM_FROUND_TO_NEAREST_INT));
+	}
+#endif
+	for (; i < num; i++) {
+		dst[i] = float_to_half(src[i]);
+	}
+}
+
+static void convert_half_to_float(float *dst, const uint16_t *src, size_t num)
+{
+	size_t i = 0;
+#ifdef __F16C__
+	for (; i + 8 <= num; i += 8) {
+		_mm256_storeu_ps(&dst[i], _mm256_cvtph_ps(_mm_loadu_si128((const __m128i *)&src[i])));
+	}
+#endif
+	for (; i < num; i++) {
+		dst[i] = half_to_float(src[i]);
+	}
+}
+
+/* ******** MemoryProxy ******** */
 
 
 MemoryProxy::MemoryProxy(DataType datatype)
 {
 	this->m_writeBufferOperation = NULL;
 	this->m_executor = NULL;
+	this->m_buffer = NULL;
 	this->m_datatype = datatype;
+	this->m_tileStore = NULL;
+	this->m_halfFloat = false;
+	this->m_tiles = NULL;
+	this->m_numberOfTiles = 0;
+	this->m_width = 0;
+	this->m_height = 0;
+	this->m_fullBuffer = NULL;
 }
 
 void MemoryProxy::allocate(unsigned int width, unsigned int height)
@@ -38,6 +145,28 @@ void MemoryProxy::allocate(unsigned int width, unsigned int height)
 	result.ymin = 0;
 	result.ymax = height;
 
+	this->m_width = width;
+	this->m_height = height;
+
+	/* half floats are only read and written through the tiles */
+	if (this->m_tileStore == NULL) {
+		this->m_halfFloat = false;
+	}
+
+	if (this->m_tileStore && (this->m_halfFloat || height > this->m_tileStore->getTileRows())) {
+		const unsigned int tileRows = this->m_tileStore->getTileRows();
+		const size_t rowSize = this->getElementSize() * width * COM_data_type_num_channels(this->m_datatype);
+
+		this->m_numberOfTiles = (height + tileRows - 1) / tileRows;
+		this->m_tiles = new MemoryTile[this->m_numberOfTiles];
+		for (unsigned int index = 0; index < this->m_numberOfTiles; index++) {
+			const unsigned int rows = min(tileRows, height - index * tileRows);
+			this->m_tileStore->initTile(&this->m_tiles[index], rowSize * rows);
+		}
+		BLI_rw_mutex_init(&this->m_fullBufferMutex);
+		return;
+	}
+
 	this->m_buffer = new MemoryBuffer(this, 1, &result);
 }
 
@@ -47,5 +176,229 @@ void MemoryProxy::free()
 		delete this->m_buffer;
 		this->m_buffer = NULL;
 	}
+	if (this->m_tiles) {
+		for (unsigned int index = 0; index < this->m_numberOfTiles; index++) {
+			this->m_tileStore->freeTile(&this->m_tiles[index]);
+		}
+		delete[] this->m_tiles;
+		this->m_tiles = NULL;
+		this->m_numberOfTiles = 0;
+		if (this->m_fullBuffer) {
+			delete this->m_fullBuffer;
+			this->m_fullBuffer = NULL;
+		}
+		BLI_rw_mutex_end(&this->m_fullBufferMutex);
+	}
 }
 
+void MemoryProxy::copyFromTiles(MemoryBuffer *result)
+{
+	const unsigned int tileRows = this->m_tileStore->getTileRows();
+	const size_t rowLength = this->m_width * result->get_num_channels();
+	const size_t tileRowSize = this->getElementSize() * rowLength;
+	rcti *rect = result->getRect();
+	float *buffer = result->getBuffer();
+
+	BLI_assert(rect->xmin == 0 && rect->xmax == (int)this->m_width);
+
+	for (int y = rect->ymin; y < rect->ymax; ) {
+		MemoryTile *tile = &this->m_tiles[y / tileRows];
+		const int tileEnd = min((y / tileRows + 1) * tileRows, this->m_height);
+		const int rows = min(tileEnd, rect->ymax) - y;
+		float *dst = &buffer[rowLength * (y - rect->ymin)];
+		char *src = (char *)this->m_tileStore->acquireTile(tile, false);
+
+		if (src) {
+			src += tileRowSize * (y % tileRows);
+			if (this->m_halfFloat) {
+				convert_half_to_float(dst, (const uint16_t *)src, rowLength * rows);
+			}
+			else {
+				memcpy(dst, src, tileRowSize * rows);
+			}
+			this->m_tileStore->releaseTile(tile, false);
+		}
+		else {
+			/* never written */
+			memset(dst, 0, sizeof(float) * rowLength * rows);
+		}
+		y += rows;
+	}
+}
+
+MemoryBuffer *MemoryProxy::getFullBuffer()
+{
+	MemoryBuffer *fullBuffer;
+
+	if (!this->isStreaming()) {
+		return this->m_buffer;
+	}
+
+	BLI_rw_mutex_lock(&this->m_fullBufferMutex, THREAD_LOCK_READ);
+	fullBuffer = this->m_fullBuffer;
+	BLI_rw_mutex_unlock(&this->m_fullBufferMutex);
+	if (fullBuffer) {
+		return fullBuffer;
+	}
+
+	/* waits for the readers of the tiles, so no tile is freed while it's copied */
+	BLI_rw_mutex_lock(&this->m_fullBufferMutex, THREAD_LOCK_WRITE);
+	if (this->m_fullBuffer == NULL) {
+		rcti rect;
+		BLI_rcti_init(&rect, 0, this->m_width, 0, this->m_height);
+		this->m_fullBuffer = new MemoryBuffer(this, 1, &rect);
+		copyFromTiles(this->m_fullBuffer);
+		Profiler::full_buffer_built();
+
+		/* all readers use the full buffer from now on */
+		for (unsigned int index = 0; index < this->m_numberOfTiles; index++) {
+			this->m_tileStore->freeTile(&this->m_tiles[index]);
+		}
+	}
+	fullBuffer = this->m_fullBuffer;
+	BLI_rw_mutex_unlock(&this->m_fullBufferMutex);
+	return fullBuffer;
+}
+
+MemoryBuffer *MemoryProxy::duplicateFullBuffer()
+{
+	MemoryBuffer *result;
+	rcti rect;
+
+	if (!this->isStreaming()) {
+		return this->m_buffer->duplicate();
+	}
+
+	BLI_rcti_init(&rect, 0, this->m_width, 0, this->m_height);
+	BLI_rw_mutex_lock(&this->m_fullBufferMutex, THREAD_LOCK_READ);
+	if (this->m_fullBuffer) {
+		result = this->m_fullBuffer->duplicate();
+	}
+	else {
+		result = new MemoryBuffer(this, &rect);
+		copyFromTiles(result);
+	}
+	BLI_rw_mutex_unlock(&this->m_fullBufferMutex);
+	return result;
+}
+
+MemoryBuffer *MemoryProxy::readArea(rcti *rect)
+{
+	MemoryBuffer *result;
+
+	if (!this->isStreaming()) {
+		result = new MemoryBuffer(this, rect);
+		result->copyContentFrom(this->m_buffer);
+		return result;
+	}
+
+	/* streamed buffers are read in whole rows, like they are stored */
+	rcti band;
+	BLI_rcti_init(&band, 0, this->m_width, max(rect->ymin, 0), min(rect->ymax, (int)this->m_height));
+
+	if (band.ymin >= band.ymax) {
+		result = new MemoryBuffer(this, rect);
+		result->clear();
+		return result;
+	}
+
+	if (band.ymin > 0 || band.ymax < (int)this->m_height) {
+		/* the tiles are only read while the full buffer doesn't exist */
+		BLI_rw_mutex_lock(&this->m_fullBufferMutex, THREAD_LOCK_READ);
+		if (this->m_fullBuffer == NULL) {
+			result = new MemoryBuffer(this, &band);
+			copyFromTiles(result);
+			BLI_rw_mutex_unlock(&this->m_fullBufferMutex);
+			return result;
+		}
+		BLI_rw_mutex_unlock(&this->m_fullBufferMutex);
+	}
+
+	MemoryBuffer *fullBuffer = this->getFullBuffer();
+	if (band.ymin == 0 && band.ymax == (int)this->m_height) {
+		return fullBuffer;
+	}
+	result = new MemoryBuffer(this, &band);
+	result->copyContentFrom(fullBuffer);
+	return result;
+}
+
+void MemoryProxy::writeArea(MemoryBuffer *buffer)
+{
+	if (!this->isStreaming()) {
+		this->m_buffer->copyContentFrom(buffer);
+		return;
+	}
+
+	const unsigned int tileRows = this->m_tileStore->getTileRows();
+	const unsigned int num_channels = buffer->get_num_channels();
+	rcti *rect = buffer->getRect();
+	const int xmin = max(rect->xmin, 0);
+	const int xmax = min(rect->xmax, (int)this->m_width);
+	const int ymin = max(rect->ymin, 0);
+	const int ymax = min(rect->ymax, (int)this->m_height);
+
+	if (xmin >= xmax) {
+		return;
+	}
+
+	/* chunks of the writer can still be executing when a reader builds the full buffer,
+	 * from then on they write into the full buffer */
+	BLI_rw_mutex_lock(&this->m_fullBufferMutex, THREAD_LOCK_READ);
+	if (this->m_fullBuffer) {
+		if (this->m_halfFloat) {
+			/* same precision as the rows that were copied from the tiles */
+			MemoryBuffer *fullBuffer = this->m_fullBuffer;
+			for (int y = ymin; y < ymax; y++) {
+				float *dst = &fullBuffer->getBuffer()[(y * this->m_width + xmin) * num_channels];
+				const float *src = &buffer->getBuffer()[((y - rect->ymin) * buffer->getWidth() + (xmin - rect->xmin)) * num_channels];
+				for (size_t i = 0; i < (size_t)(xmax - xmin) * num_channels; i++) {
+					dst[i] = half_to_float(float_to_half(src[i]));
+				}
+			}
+		}
+		else {
+			this->m_fullBuffer->copyContentFrom(buffer);
+		}
+		BLI_rw_mutex_unlock(&this->m_fullBufferMutex);
+		return;
+	}
+
+	for (int y = ymin; y < ymax; ) {
+		MemoryTile *tile = &this->m_tiles[y / tileRows];
+		const int tileStart = (y / tileRows) * tileRows;
+		const int tileEnd = min(tileStart + (int)tileRows, (int)this->m_height);
+		void *dst = this->m_tileStore->acquireTile(tile, true);
+
+		for (; y < min(tileEnd, ymax); y++) {
+			const size_t dstOffset = ((y - tileStart) * this->m_width + xmin) * num_channels;
+			const float *src = &buffer->getBuffer()[((y - rect->ymin) * buffer->getWidth() + (xmin - rect->xmin)) * num_channels];
+			if (this->m_halfFloat) {
+				convert_float_to_half(&((uint16_t *)dst)[dstOffset], src, (xmax - xmin) * num_channels);
+			}
+			else {
+				memcpy(&((float *)dst)[dstOffset], src, sizeof(float) * (xmax - xmin) * num_channels);
+			}
+		}
+		this->m_tileStore->releaseTile(tile, true);
+	}
+	BLI_rw_mutex_unlock(&this->m_fullBufferMutex);
+}
+
+
+void MemoryProxy::setBuffer(MemoryBuffer *buffer)
+{
+	this->free();
+	buffer->setMemoryProxy(this);
+	this->m_buffer = buffer;
+}
+
+MemoryBuffer *MemoryProxy::releaseBuffer()
+{
+	MemoryBuffer *buffer = this->m_buffer;
+	if (buffer) {
+		buffer->setMemoryProxy(NULL);
+	}
+	this->m_buffer = NULL;
+	return buffer;
+}
@@ -26,6 +26,7 @@ class MemoryProxy;
 #ifndef _COM_MemoryProxy_h_
 #define _COM_MemoryProxy_h_
 #include "COM_ExecutionGroup.h"
+#include "COM_MemoryTileStore.h"
 
 class ExecutionGroup;
 class WriteBufferOperation;
@@ -68,6 +69,35 @@ private:
 	 */
 	DataType m_datatype;
 
+	/**
+	 * @brief store keeping the tiles when this MemoryProxy is streaming
+	 * @see setTileStore
+	 */
+	MemoryTileStore *m_tileStore;
+
+	/**
+	 * @brief the tiles store half floats, converted when they are read and written
+	 * @see setHalfFloat
+	 */
+	bool m_halfFloat;
+
+	/**
+	 * @brief bands of m_tileStore->getTileRows() rows, only used when streaming
+	 */
+	MemoryTile *m_tiles;
+	unsigned int m_numberOfTiles;
+	unsigned int m_width;
+	unsigned int m_height;
+
+	/**
+	 * @brief the complete buffer, built from the tiles the first time a reader needs all of it
+	 * readers and writers of the tiles hold the read lock, building the full buffer takes the write lock
+	 */
+	MemoryBuffer *m_fullBuffer;
+	ThreadRWMutex m_fullBufferMutex;
+
+	void copyFromTiles(MemoryBuffer *result);
+
 public:
 	MemoryProxy(DataType type);
 	
@@ -94,16 +124,79 @@ public:
 	 */
 	WriteBufferOperation *getWriteBufferOperation() { return this->m_writeBufferOperation; }
 
+	/**
+	 * @brief keep the memory in tiles of the store instead of a single buffer
+	 * @note only takes effect in allocate, when the buffer is larger than a single tile
+	 */
+	void setTileStore(MemoryTileStore *tileStore) { this->m_tileStore = tileStore; }
+
+	/**
+	 * @brief is the memory kept in tiles of a MemoryTileStore
+	 * when streaming getBuffer returns NULL and the memory is accessed through readArea and writeArea
+	 */
+	bool isStreaming() const { return this->m_tiles != NULL; }
+
+	/**
+	 * @brief store the memory as half floats, halving its size at the cost of precision
+	 * @note only takes effect in allocate together with a tile store, all access then goes through readArea and writeArea
+	 * @note MemoryBuffer only holds floats, readers of the whole area get a float buffer from getFullBuffer
+	 * or a copy of their own from duplicateFullBuffer
+	 */
+	void setHalfFloat(bool halfFloat) { this->m_halfFloat = halfFloat; }
+	bool isHalfFloat() const { return this->m_halfFloat; }
+
+	/**
+	 * @brief size in bytes of a single value in the memory of this proxy
+	 */
+	size_t getElementSize() const { return this->m_halfFloat ? sizeof(uint16_t) : sizeof(float); }
+
 	/**
 	 * @brief allocate memory of size width x height
 	 */
 	void allocate(unsigned int width, unsigned int height);
 
+	/**
+	 * @brief get a buffer containing at least the area of rect
+	 * @note when streaming the result covers whole rows and can be shared,
+	 * temporarily buffers must be deleted by the caller
+	 */
+	MemoryBuffer *readArea(rcti *rect);
+
+	/**
+	 * @brief get a buffer of the complete area, owned by this proxy
+	 * @note when streaming the tiles are converted to a float buffer the first time and freed,
+	 * the memory of the tile store budget and of half floats isn't saved from then on
+	 */
+	MemoryBuffer *getFullBuffer();
+
+	/**
+	 * @brief get a copy of the complete area, owned by the caller
+	 * @note when streaming the copy is converted from the tiles without building the full buffer
+	 */
+	MemoryBuffer *duplicateFullBuffer();
+
+	/**
+	 * @brief copy the content of buffer into the memory of this proxy
+	 * @note when streaming the full buffer is written instead of the tiles once it has been built
+	 */
+	void writeArea(MemoryBuffer *buffer);
+
 	/**
 	 * @brief free the allocated memory
 	 */
 	void free();
 
+	/**
+	 * @brief take over an existing buffer of the same size instead of the allocated memory
+	 * @note used to restore a buffer kept by the CompositorCache, the allocated memory is freed
+	 */
+	void setBuffer(MemoryBuffer *buffer);
+
+	/**
+	 * @brief release the buffer from this proxy, the caller becomes the owner of the buffer
+	 */
+	MemoryBuffer *releaseBuffer();
+
 	/**
 	 * @brief get the allocated memory
 	 */
@@ -0,0 +1,233 @@
+/*
+ * Copyright 2011, Blender Foundation.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor:
+ *		Jeroen Bakker
+ *		Monique Dewanchand
+ */
+
+#include "COM_MemoryTileStore.h"
+#include "COM_Profiler.h"
+
+extern "C" {
+#  include "BLI_utildefines.h"
+#  include "BLI_fileops.h"
+#  include "BLI_string.h"
+#  include "BKE_appdir.h"
+#  include "BKE_report.h"
+}
+
+MemoryTileStore::MemoryTileStore(unsigned int tileRows, size_t memoryLimit)
+{
+	BLI_mutex_init(&this->m_mutex);
+	this->m_tileRows = tileRows;
+	this->m_memoryLimit = memoryLimit;
+	this->m_memoryUsed = 0;
+	this->m_file = NULL;
+	this->m_filepath[0] = '\0';
+	this->m_fileSize = 0;
+	this->m_fileFailed = false;
+}
+
+MemoryTileStore::~MemoryTileStore()
+{
+	BLI_assert(this->m_unused.empty());
+	if (this->m_file) {
+		fclose(this->m_file);
+		BLI_delete(this->m_filepath, false, false);
+	}
+	BLI_mutex_end(&this->m_mutex);
+}
+
+void MemoryTileStore::initTile(MemoryTile *tile, size_t size)
+{
+	tile->buffer = NULL;
+	tile->size = size;
+	tile->fileOffset = -1;
+	tile->users = 0;
+	tile->modified = false;
+	tile->listed = false;
+	tile->discarded = false;
+}
+
+float *MemoryTileStore::acquireTile(MemoryTile *tile, bool create)
+{
+	BLI_mutex_lock(&this->m_mutex);
+
+	if (tile->buffer == NULL) {
+		if (tile->fileOffset < 0 && !create) {
+			BLI_mutex_unlock(&this->m_mutex);
+			return NULL;
+		}
+
+		makeRoom(tile->size);
+		tile->buffer = (float *)MEM_mallocN_aligned(tile->size, 16, "COM_MemoryTile");
+		this->m_memoryUsed += tile->size;
+		Profiler::buffer_allocated(tile->size);
+
+		if (tile->fileOffset >= 0) {
+			if (!loadTile(tile)) {
+				memset(tile->buffer, 0, tile->size);
+			}
+			tile->modified = false;
+		}
+		else {
+			tile->modified = true;
+		}
+	}
+	else if (tile->listed) {
+		this->m_unused.erase(tile->listIterator);
+		tile->listed = false;
+	}
+
+	tile->users++;
+	BLI_mutex_unlock(&this->m_mutex);
+	return tile->buffer;
+}
+
+void MemoryTileStore::releaseTile(MemoryTile *tile, bool modified)
+{
+	BLI_mutex_lock(&this->m_mutex);
+
+	BLI_assert(tile->users > 0);
+	if (modified) {
+		tile->modified = true;
+	}
+	tile->users--;
+	if (tile->users == 0) {
+		if (tile->discarded) {
+			freeTileBuffer(tile);
+		}
+		else if (tile->buffer) {
+			this->m_unused.push_front(tile);
+			tile->listIterator = this->m_unused.begin();
+			tile->listed = true;
+		}
+		/* the budget may have been exceeded while all tiles were in use */
+		makeRoom(0);
+	}
+
+	BLI_mutex_unlock(&this->m_mutex);
+}
+
+void MemoryTileStore::freeTile(MemoryTile *tile)
+{
+	BLI_mutex_lock(&this->m_mutex);
+
+	if (tile->users > 0) {
+		/* still being read or written by another thread */
+		tile->discarded = true;
+	}
+	else {
+		freeTileBuffer(tile);
+	}
+
+	BLI_mutex_unlock(&this->m_mutex);
+}
+
+/* call with the mutex locked, the tile must not be in use */
+void MemoryTileStore::freeTileBuffer(MemoryTile *tile)
+{
+	BLI_assert(tile->users == 0);
+	if (tile->listed) {
+		this->m_unused.erase(tile->listIterator);
+		tile->listed = false;
+	}
+	if (tile->buffer) {
+		MEM_freeN(tile->buffer);
+		tile->buffer = NULL;
+		this->m_memoryUsed -= tile->size;
+	}
+	tile->fileOffset = -1;
+	tile->discarded = false;
+}
+
+void MemoryTileStore::makeRoom(size_t size)
+{
+	while (this->m_memoryUsed + size > this->m_memoryLimit && !this->m_unused.empty()) {
+		MemoryTile *tile = this->m_unused.back();
+
+		/* only tiles in memory that nobody uses are listed */
+		BLI_assert(tile->users == 0 && tile->buffer != NULL);
+
+		if (tile->modified && !spillTile(tile)) {
+			/* keep the tile in memory when the scratch file can't be written */
+			break;
+		}
+
+		this->m_unused.pop_back();
+		tile->listed = false;
+		MEM_freeN(tile->buffer);
+		tile->buffer = NULL;
+		this->m_memoryUsed -= tile->size;
+	}
+}
+
+/* call with the mutex locked, only the first error is reported */
+void MemoryTileStore::fileError(const char *what)
+{
+	if (!this->m_fileFailed) {
+		BKE_reportf(NULL, RPT_WARNING, "Compositor: can't %s scratch file %s, buffers are kept in memory",
+		            what, this->m_filepath);
+		this->m_fileFailed = true;
+	}
+}
+
+bool MemoryTileStore::spillTile(MemoryTile *tile)
+{
+	if (this->m_fileFailed) {
+		return false;
+	}
+
+	if (this->m_file == NULL) {
+		char filename[64];
+		BLI_snprintf(filename, sizeof(filename), "compositor_tiles_%p.tmp", (void *)this);
+		BLI_join_dirfile(this->m_filepath, sizeof(this->m_filepath), BKE_tempdir_session(), filename);
+		this->m_file = BLI_fopen(this->m_filepath, "w+b");
+		if (this->m_file == NULL) {
+			fileError("create");
+			return false;
+		}
+	}
+
+	/* every tile keeps its place in the file once it has been spilled */
+	if (tile->fileOffset < 0) {
+		tile->fileOffset = this->m_fileSize;
+		this->m_fileSize += tile->size;
+	}
+
+	if (BLI_fseek(this->m_file, tile->fileOffset, SEEK_SET) != 0 ||
+	    fwrite(tile->buffer, 1, tile->size, this->m_file) != tile->size)
+	{
+		fileError("write to");
+		return false;
+	}
+
+	tile->modified = false;
+	return true;
+}
+
+bool MemoryTileStore::loadTile(MemoryTile *tile)
+{
+	if (BLI_fseek(this->m_file, tile->fileOffset, SEEK_SET) != 0 ||
+	    fread(tile->buffer, 1, tile->size, this->m_file) != tile->size)
+	{
+		fileError("read from");
+		return false;
+	}
+	return true;
+}
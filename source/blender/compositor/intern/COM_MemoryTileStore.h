@@ -0,0 +1,138 @@
+/*
+ * Copyright 2011, Blender Foundation.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor:
+ *		Jeroen Bakker
+ *		Monique Dewanchand
+ */
+
+#ifndef _COM_MemoryTileStore_h_
+#define _COM_MemoryTileStore_h_
+
+#include <list>
+#include <stdio.h>
+#include <string.h>
+
+#include "MEM_guardedalloc.h"
+
+extern "C" {
+#  include "BLI_path_util.h"
+#  include "BLI_sys_types.h"
+#  include "BLI_threads.h"
+}
+
+/**
+ * @brief a band of rows of a streaming MemoryProxy
+ * @see MemoryTileStore
+ * @ingroup Memory
+ */
+typedef struct MemoryTile {
+	/** @brief the pixels of the tile, NULL when the tile is not in memory */
+	float *buffer;
+	/** @brief size of the buffer in bytes */
+	size_t size;
+	/** @brief location of the tile in the scratch file, -1 when it has never been spilled */
+	int64_t fileOffset;
+	/** @brief number of threads currently reading or writing the buffer, a used tile is never spilled */
+	int users;
+	/** @brief the buffer has been written since it was last spilled */
+	bool modified;
+	/** @brief the tile is in the list of unused tiles of the store */
+	bool listed;
+	/** @brief freeTile was called while the tile was used, the last user frees it */
+	bool discarded;
+	std::list<MemoryTile *>::iterator listIterator;
+} MemoryTile;
+
+/**
+ * @brief keeps the tiles of all streaming MemoryProxies of an execution within a memory budget
+ *
+ * When the budget is exceeded the least recently used tiles are written to a scratch file
+ * in the temporary directory and read back when they are needed again.
+ * Tiles in use are never freed or spilled, not even by freeTile.
+ * @note the budget can be exceeded when all tiles in memory are in use,
+ * or when the scratch file can't be written.
+ * @see ExecutionSystem.execute
+ * @ingroup Memory
+ */
+class MemoryTileStore {
+private:
+	ThreadMutex m_mutex;
+
+	/**
+	 * @brief number of rows of every tile
+	 */
+	unsigned int m_tileRows;
+
+	size_t m_memoryLimit;
+	size_t m_memoryUsed;
+
+	/**
+	 * @brief tiles in memory that are not used, least recently used last
+	 */
+	std::list<MemoryTile *> m_unused;
+
+	FILE *m_file;
+	char m_filepath[FILE_MAX];
+	int64_t m_fileSize;
+
+	/**
+	 * @brief the scratch file failed, tiles stay in memory from then on
+	 */
+	bool m_fileFailed;
+
+	void makeRoom(size_t size);
+	void freeTileBuffer(MemoryTile *tile);
+	void fileError(const char *what);
+	bool spillTile(MemoryTile *tile);
+	bool loadTile(MemoryTile *tile);
+
+public:
+	MemoryTileStore(unsigned int tileRows, size_t memoryLimit);
+	~MemoryTileStore();
+
+	unsigned int getTileRows() const { return this->m_tileRows; }
+
+	/**
+	 * @brief initialize an empty tile of the given size in bytes
+	 */
+	void initTile(MemoryTile *tile, size_t size);
+
+	/**
+	 * @brief get the pixels of the tile and mark it used, loading it from the scratch file if needed
+	 * @param create allocate the tile when it has never been written
+	 * @return NULL when create is false and the tile has never been written
+	 */
+	float *acquireTile(MemoryTile *tile, bool create);
+
+	/**
+	 * @brief mark the tile unused after acquireTile
+	 * @param modified the pixels of the tile have been written
+	 */
+	void releaseTile(MemoryTile *tile, bool modified);
+
+	/**
+	 * @brief free the memory of a tile, a tile that is in use is freed by its last releaseTile
+	 */
+	void freeTile(MemoryTile *tile);
+
+#ifdef WITH_CXX_GUARDEDALLOC
+	MEM_CXX_CLASS_ALLOC_FUNCS("COM:MemoryTileStore")
+#endif
+};
+
+#endif
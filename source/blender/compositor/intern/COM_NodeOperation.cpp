@@ -40,6 +40,10 @@ NodeOperation::NodeOperation()
 	this->m_height = 0;
 	this->m_isResolutionSet = false;
 	this->m_openCL = false;
+	this->m_pointwise = false;
+	this->m_depth = false;
+	this->m_nodeHash = 0;
+	this->m_cacheable = true;
 	this->m_btree = NULL;
 }
 
@@ -31,6 +31,7 @@ extern "C" {
 #include "BLI_math_color.h"
 #include "BLI_math_vector.h"
 #include "BLI_threads.h"
+#include "BLI_sys_types.h"
 }
 
 #include "COM_Node.h"
@@ -105,6 +106,35 @@ private:
 	 */
 	bool m_openCL;
 
+	/**
+	 * @brief is this operation a pointwise one.
+	 *
+	 * Pointwise operations compute an output pixel only from the input pixels at the same location
+	 * and implement executeRowKernel, chains of them can be fused into a single FusedOperation.
+	 */
+	bool m_pointwise;
+
+	/**
+	 * @brief does the output of this operation hold depth.
+	 *
+	 * Depth isn't limited to 0..1 and loses too much in half floats,
+	 * buffers that depend on it are kept in full precision.
+	 */
+	bool m_depth;
+
+	/**
+	 * @brief hash of the parameters of the node this operation was created for
+	 * @see CompositorCache
+	 */
+	uint64_t m_nodeHash;
+
+	/**
+	 * @brief can the result of this operation be reused by a later execution
+	 * @note false when the parameters of the node could not be hashed completely
+	 * @see CompositorCache
+	 */
+	bool m_cacheable;
+
 	/**
 	 * @brief mutex reference for very special node initializations
 	 * @note only use when you really know what you are doing.
@@ -288,7 +318,49 @@ public:
 	 * @see ExecutionGroup.addOperation
 	 */
 	bool isOpenCL() const { return this->m_openCL; }
+
+	/**
+	 * @brief can this NodeOperation be fused with its pointwise neighbours
+	 * @see NodeOperationBuilder.fuse_pointwise_operations
+	 */
+	bool isPointwise() const { return this->m_pointwise; }
+
+	/**
+	 * @brief does the output of this NodeOperation hold depth
+	 * @see ExecutionSystem.useHalfFloat
+	 */
+	bool isDepth() const { return this->m_depth; }
+
+	/**
+	 * @brief set whether the output of this NodeOperation holds depth
+	 * @note public, nodes mark the operations that read a depth pass
+	 */
+	void setDepth(bool depth) { this->m_depth = depth; }
+
+	/**
+	 * @brief evaluate num pixels from already calculated input rows
+	 *
+	 * inputs contains one row of float[4] pixels per input socket, in socket order.
+	 * Only called on pointwise operations.
+	 * @see FusedOperation
+	 */
+	virtual void executeRowKernel(float * /*output*/, float ** /*inputs*/, int /*num*/) {}
 	
+	virtual bool isFusedOperation() const { return false; }
+
+	void setNodeHash(uint64_t nodeHash) { this->m_nodeHash = nodeHash; }
+	uint64_t getNodeHash() const { return this->m_nodeHash; }
+	void setCacheable(bool cacheable) { this->m_cacheable = cacheable; }
+	bool isCacheable() const { return this->m_cacheable; }
+
+	/**
+	 * @brief hash of the data this operation reads that is not part of its node parameters
+	 *
+	 * Operations with values set by the converter or that read external buffers
+	 * (render layers, images) must include them here.
+	 * @see CompositorCache.hash_operation
+	 */
+	virtual uint64_t getDataHash() { return 0; }
 	virtual bool isViewerOperation() const { return false; }
 	virtual bool isPreviewOperation() const { return false; }
 	virtual bool isFileOutputOperation() const { return false; }
@@ -333,6 +405,12 @@ protected:
 	 */
 	void setOpenCL(bool openCL) { this->m_openCL = openCL; }
 
+	/**
+	 * @brief set whether this operation is pointwise
+	 * @note pointwise operations must implement executeRowKernel
+	 */
+	void setPointwise(bool pointwise) { this->m_pointwise = pointwise; }
+
 	/* allow the DebugInfo class to look at internals */
 	friend class DebugInfo;
 
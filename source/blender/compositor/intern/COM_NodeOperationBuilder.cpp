@@ -21,16 +21,20 @@
 
 extern "C" {
 #include "BLI_utildefines.h"
+
+#include "BKE_global.h"
 }
 
 #include "COM_NodeConverter.h"
 #include "COM_Converter.h"
 #include "COM_Debug.h"
+#include "COM_Profiler.h"
 #include "COM_ExecutionSystem.h"
 #include "COM_Node.h"
 #include "COM_SocketProxyNode.h"
 
 #include "COM_NodeOperation.h"
+#include "COM_FusedOperation.h"
 #include "COM_PreviewOperation.h"
 #include "COM_SetValueOperation.h"
 #include "COM_SetVectorOperation.h"
@@ -45,6 +49,9 @@ extern "C" {
 NodeOperationBuilder::NodeOperationBuilder(const CompositorContext *context, bNodeTree *b_nodetree) :
     m_context(context),
     m_current_node(NULL),
+    m_current_node_hash(0),
+    m_current_node_cacheable(true),
+    m_current_node_num_operations(0),
     m_active_viewer(NULL)
 {
 	m_graph.from_bNodeTree(*context, b_nodetree);
@@ -59,10 +66,20 @@ void NodeOperationBuilder::convertToOperations(ExecutionSystem *system)
 	/* interface handle for nodes */
 	NodeConverter converter(this);
 	
+	Profiler::convert_started();
+	
 	for (int index = 0; index < m_graph.nodes().size(); index++) {
 		Node *node = (Node *)m_graph.nodes()[index];
 		
 		m_current_node = node;
+		m_current_node_num_operations = 0;
+		if (node->getbNode()) {
+			m_current_node_hash = CompositorCache::hash_node(*m_context, node->getbNode(), &m_current_node_cacheable);
+		}
+		else {
+			m_current_node_hash = 0;
+			m_current_node_cacheable = true;
+		}
 		
 		DebugInfo::node_to_operations(node);
 		node->convertToOperations(converter, *m_context);
@@ -112,6 +129,13 @@ void NodeOperationBuilder::convertToOperations(ExecutionSystem *system)
 	/* surround complex ops with read/write buffer */
 	add_complex_operation_buffers();
 	
+#ifdef COM_FUSE_OPERATIONS
+	/* evaluate chains of pointwise ops in a single operation */
+	if (G.debug_value != COM_DEBUG_VALUE_NO_FUSE) {
+		fuse_pointwise_operations();
+	}
+#endif
+	
 	/* links not available from here on */
 	/* XXX make m_links a local variable to avoid confusion! */
 	m_links.clear();
@@ -130,6 +154,11 @@ void NodeOperationBuilder::convertToOperations(ExecutionSystem *system)
 
 void NodeOperationBuilder::addOperation(NodeOperation *operation)
 {
+	if (m_current_node) {
+		operation->setNodeHash(CompositorCache::hash_combine(m_current_node_hash, m_current_node_num_operations++));
+		operation->setCacheable(m_current_node_cacheable);
+	}
+	Profiler::operation_added(operation, m_current_node);
 	m_operations.push_back(operation);
 }
 
@@ -643,6 +672,196 @@ void NodeOperationBuilder::sort_operations()
 	m_operations = sorted;
 }
 
+static bool is_fusable_operation(NodeOperation *op)
+{
+	if (!op->isPointwise() || op->isComplex() || op->isOpenCL())
+		return false;
+	if (op->getNumberOfOutputSockets() != 1 || op->getNumberOfInputSockets() > COM_FUSED_MAX_INPUTS)
+		return false;
+	
+	/* kernels need a row for every input */
+	for (unsigned int i = 0; i < op->getNumberOfInputSockets(); ++i) {
+		if (!op->getInputSocket(i)->isConnected())
+			return false;
+	}
+	return true;
+}
+
+/* rows needed by a fused operation: one per operation and one per distinct external input */
+static int count_fused_rows(const Tags &members, const NodeOperationBuilder::Operations &operations)
+{
+	std::set<NodeOperationOutput *> external;
+	for (NodeOperationBuilder::Operations::const_iterator it = operations.begin(); it != operations.end(); ++it) {
+		NodeOperation *op = *it;
+		for (unsigned int i = 0; i < op->getNumberOfInputSockets(); ++i) {
+			NodeOperationOutput *from = op->getInputSocket(i)->getLink();
+			if (members.find(&from->getOperation()) == members.end())
+				external.insert(from);
+		}
+	}
+	return operations.size() + external.size();
+}
+
+void NodeOperationBuilder::fuse_operations(const Operations &operations)
+{
+	NodeOperation *output_op = operations.back();
+	Tags members(operations.begin(), operations.end());
+	
+	FusedOperation *fused = new FusedOperation(output_op->getOutputSocket()->getDataType());
+	DebugInfo::operation_fused(fused, output_op);
+	Profiler::operation_fused(fused, output_op);
+	
+	/* inputs coming from outside the chain become inputs of the fused operation,
+	 * the fused operations themselves are no longer linked to the rest of the graph
+	 */
+	std::map<NodeOperationOutput *, int> external_rows;
+	std::map<NodeOperationInput *, NodeOperationOutput *> input_links;
+	for (Operations::const_iterator it = operations.begin(); it != operations.end(); ++it) {
+		NodeOperation *op = *it;
+		for (unsigned int i = 0; i < op->getNumberOfInputSockets(); ++i) {
+			NodeOperationInput *input = op->getInputSocket(i);
+			NodeOperationOutput *from = input->getLink();
+			input_links[input] = from;
+			
+			if (members.find(&from->getOperation()) != members.end())
+				continue;
+			
+			if (external_rows.find(from) == external_rows.end()) {
+				unsigned int row = fused->getNumberOfInputSockets();
+				fused->addFusedInput(from->getDataType());
+				addLink(from, fused->getInputSocket(row));
+				external_rows[from] = row;
+			}
+			removeInputLink(input);
+		}
+	}
+	
+	std::map<NodeOperation *, int> operation_rows;
+	for (size_t k = 0; k < operations.size(); ++k)
+		operation_rows[operations[k]] = external_rows.size() + k;
+	
+	for (Operations::const_iterator it = operations.begin(); it != operations.end(); ++it) {
+		NodeOperation *op = *it;
+		std::vector<int> rows;
+		for (unsigned int i = 0; i < op->getNumberOfInputSockets(); ++i) {
+			NodeOperationOutput *from = input_links[op->getInputSocket(i)];
+			if (members.find(&from->getOperation()) != members.end())
+				rows.push_back(operation_rows[&from->getOperation()]);
+			else
+				rows.push_back(external_rows[from]);
+		}
+		fused->addFusedOperation(op, rows);
+	}
+	
+	unsigned int resolution[2] = {output_op->getWidth(), output_op->getHeight()};
+	fused->setResolution(resolution);
+	
+	/* redirect users of the last operation to the fused operation */
+	OpInputs targets = cache_output_links(output_op->getOutputSocket());
+	for (OpInputs::const_iterator it = targets.begin(); it != targets.end(); ++it) {
+		NodeOperationInput *target = *it;
+		removeInputLink(target);
+		addLink(fused->getOutputSocket(), target);
+	}
+	
+	addOperation(fused);
+}
+
+void NodeOperationBuilder::fuse_pointwise_operations()
+{
+	/* users of every operation, an operation can only be fused
+	 * into a chain when all of its users are part of that chain
+	 */
+	std::map<NodeOperation *, OpInputs> users;
+	for (Links::const_iterator it = m_links.begin(); it != m_links.end(); ++it) {
+		const Link &link = *it;
+		users[&link.from()->getOperation()].push_back(link.to());
+	}
+	
+	Operations sorted;
+	sorted.reserve(m_operations.size());
+	Tags visited;
+	for (Operations::const_iterator it = m_operations.begin(); it != m_operations.end(); ++it)
+		sort_operations_recursive(sorted, visited, *it);
+	
+	/* start chains at their last operation, so users are visited before their inputs */
+	Tags fused_ops;
+	for (Operations::const_reverse_iterator it = sorted.rbegin(); it != sorted.rend(); ++it) {
+		NodeOperation *op = *it;
+		if (fused_ops.find(op) != fused_ops.end() || !is_fusable_operation(op))
+			continue;
+		
+		Tags members;
+		Operations chain;
+		members.insert(op);
+		chain.push_back(op);
+		
+		/* grow the chain upstream, until no more inputs can be added */
+		bool changed = true;
+		while (changed) {
+			changed = false;
+			for (size_t k = 0; k < chain.size(); ++k) {
+				NodeOperation *member = chain[k];
+				for (unsigned int i = 0; i < member->getNumberOfInputSockets(); ++i) {
+					NodeOperation *input_op = &member->getInputSocket(i)->getLink()->getOperation();
+					if (members.find(input_op) != members.end() ||
+					    fused_ops.find(input_op) != fused_ops.end() ||
+					    !is_fusable_operation(input_op))
+					{
+						continue;
+					}
+					
+					/* intermediate results are not available outside of the fused operation */
+					const OpInputs &input_users = users[input_op];
+					bool internal = true;
+					for (OpInputs::const_iterator it_user = input_users.begin(); it_user != input_users.end(); ++it_user) {
+						if (members.find(&(*it_user)->getOperation()) == members.end()) {
+							internal = false;
+							break;
+						}
+					}
+					if (!internal)
+						continue;
+					
+					members.insert(input_op);
+					chain.push_back(input_op);
+					if (count_fused_rows(members, chain) > COM_FUSED_MAX_ROWS) {
+						members.erase(input_op);
+						chain.pop_back();
+						continue;
+					}
+					changed = true;
+				}
+			}
+		}
+		
+		if (chain.size() < 2)
+			continue;
+		
+		/* evaluation order of the chain */
+		Operations operations;
+		for (Operations::const_iterator it_op = sorted.begin(); it_op != sorted.end(); ++it_op) {
+			if (members.find(*it_op) != members.end())
+				operations.push_back(*it_op);
+		}
+		
+		fuse_operations(operations);
+		fused_ops.insert(members.begin(), members.end());
+	}
+	
+	if (fused_ops.empty())
+		return;
+	
+	/* fused operations are owned by their FusedOperation now */
+	Operations remaining_ops;
+	for (Operations::const_iterator it = m_operations.begin(); it != m_operations.end(); ++it) {
+		NodeOperation *op = *it;
+		if (fused_ops.find(op) == fused_ops.end())
+			remaining_ops.push_back(op);
+	}
+	m_operations = remaining_ops;
+}
+
 static void add_group_operations_recursive(Tags &visited, NodeOperation *op, ExecutionGroup *group)
 {
 	if (visited.find(op) != visited.end())
@@ -26,6 +26,7 @@
 #include <set>
 #include <vector>
 
+#include "COM_CompositorCache.h"
 #include "COM_NodeGraph.h"
 
 using std::vector;
@@ -88,6 +89,13 @@ private:
 	
 	Node *m_current_node;
 	
+	/** Parameter hash of the current node, operations get it combined with their index in the node
+	 *  @see CompositorCache
+	 */
+	CompositorCache::Key m_current_node_hash;
+	bool m_current_node_cacheable;
+	unsigned int m_current_node_num_operations;
+	
 	/** Operation that will be writing to the viewer image
 	 *  Only one operation can occupy this place at a time,
 	 *  to avoid race conditions
@@ -149,6 +157,10 @@ protected:
 	void add_input_buffers(NodeOperation *operation, NodeOperationInput *input);
 	void add_output_buffers(NodeOperation *operation, NodeOperationOutput *output);
 	
+	/** Replace chains of pointwise operations by fused operations */
+	void fuse_pointwise_operations();
+	void fuse_operations(const Operations &operations);
+	
 	/** Remove unreachable operations */
 	void prune_operations();
 	
@@ -22,6 +22,7 @@
 
 #include "COM_OpenCLDevice.h"
 #include "COM_WorkScheduler.h"
+#include "COM_Profiler.h"
 
 typedef enum COM_VendorID  {NVIDIA = 0x10DE, AMD = 0x1002} COM_VendorID;
 const cl_image_format IMAGE_FORMAT_COLOR = {
@@ -67,6 +68,8 @@ void OpenCLDevice::execute(WorkPackage *work)
 	rcti rect;
 
 	executionGroup->determineChunkRect(&rect, chunkNumber);
+	ProfileScope scope(COM_PROFILE_CHUNK, NULL, executionGroup, &rect);
+
 	MemoryBuffer **inputBuffers = executionGroup->getInputBuffersOpenCL(chunkNumber);
 	MemoryBuffer *outputBuffer = executionGroup->allocateOutputBuffer(chunkNumber, &rect);
 
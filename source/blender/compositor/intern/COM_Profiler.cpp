@@ -0,0 +1,386 @@
+/*
+ * Copyright 2011, Blender Foundation.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor:
+ *		Jeroen Bakker
+ *		Monique Dewanchand
+ */
+
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+#include <typeinfo>
+
+#include "COM_Profiler.h"
+#include "COM_ExecutionSystem.h"
+#include "COM_ExecutionGroup.h"
+#include "COM_Node.h"
+#include "COM_NodeOperation.h"
+#include "COM_WorkScheduler.h"
+#include "COM_WriteBufferOperation.h"
+
+#include "PIL_time.h"
+
+#include "atomic_ops.h"
+
+extern "C" {
+#  include "BLI_fileops.h"
+#  include "BLI_path_util.h"
+#  include "BLI_rect.h"
+#  include "BLI_string.h"
+#  include "BLI_threads.h"
+#  include "BKE_appdir.h"
+#  include "BKE_global.h"
+#  include "DNA_node_types.h"
+}
+
+bool Profiler::m_active = false;
+int Profiler::m_file_index = 0;
+double Profiler::m_start_time = 0.0;
+size_t Profiler::m_total_bytes = 0;
+unsigned int Profiler::m_full_buffers = 0;
+Profiler::OpNameMap Profiler::m_op_names;
+Profiler::OpStatsMap Profiler::m_op_stats;
+Profiler::GroupStatsMap Profiler::m_group_stats;
+std::vector<Profiler::TraceEvent> Profiler::m_events;
+
+/* innermost scope of every thread, allocations are accounted to it */
+static ThreadLocal(ProfileScope *) g_current_scope;
+static ThreadMutex g_mutex = BLI_MUTEX_INITIALIZER;
+
+static const char *phase_names[] = {"init", "tile data", "chunk"};
+
+/* ******** Building ******** */
+
+void Profiler::convert_started()
+{
+	m_op_names.clear();
+}
+
+void Profiler::operation_added(const NodeOperation *operation, const Node *node)
+{
+	if ((G.debug & G_DEBUG_COMPOSITOR) && node && node->getbNode()) {
+		m_op_names[operation] = node->getbNode()->name;
+	}
+}
+
+void Profiler::operation_fused(const NodeOperation *fused, const NodeOperation *output)
+{
+	if (G.debug & G_DEBUG_COMPOSITOR) {
+		OpNameMap::const_iterator it = m_op_names.find(output);
+		if (it != m_op_names.end()) {
+			m_op_names[fused] = it->second;
+		}
+	}
+}
+
+/* ******** Execution ******** */
+
+void Profiler::execute_started(const ExecutionSystem *system)
+{
+	if ((G.debug & G_DEBUG_COMPOSITOR) == 0) {
+		return;
+	}
+
+	m_op_stats.clear();
+	m_group_stats.clear();
+	m_events.clear();
+	m_total_bytes = 0;
+	m_full_buffers = 0;
+
+	/* all entries exist before the threads start, they only update them */
+	OperationStats op_stats = {0};
+	for (ExecutionSystem::Operations::const_iterator it = system->m_operations.begin(); it != system->m_operations.end(); ++it) {
+		m_op_stats[*it] = op_stats;
+	}
+	GroupStats group_stats = {0};
+	for (ExecutionSystem::Groups::const_iterator it = system->m_groups.begin(); it != system->m_groups.end(); ++it) {
+		m_group_stats[*it] = group_stats;
+	}
+
+	BLI_thread_local_create(g_current_scope);
+	BLI_thread_local_set(g_current_scope, NULL);
+	m_start_time = PIL_check_seconds_timer();
+	m_active = true;
+}
+
+void Profiler::execute_finished(const ExecutionSystem *system)
+{
+	if (!m_active) {
+		return;
+	}
+	m_active = false;
+	BLI_thread_local_delete(g_current_scope);
+
+	/* pixels are read through all operations of a group */
+	for (ExecutionSystem::Groups::const_iterator it = system->m_groups.begin(); it != system->m_groups.end(); ++it) {
+		const ExecutionGroup *group = *it;
+		const GroupStats &group_stats = m_group_stats[group];
+		for (ExecutionGroup::Operations::const_iterator op = group->m_operations.begin(); op != group->m_operations.end(); ++op) {
+			m_op_stats[*op].pixels += group_stats.pixels;
+		}
+	}
+
+	char basename[FILE_MAX];
+	char filename[FILE_MAX];
+	++m_file_index;
+
+	BLI_snprintf(basename, sizeof(basename), "compositor_profile_%d.txt", m_file_index);
+	BLI_join_dirfile(filename, sizeof(filename), BKE_tempdir_base(), basename);
+	write_report(system, filename);
+
+	BLI_snprintf(basename, sizeof(basename), "compositor_trace_%d.json", m_file_index);
+	BLI_join_dirfile(filename, sizeof(filename), BKE_tempdir_base(), basename);
+	write_trace(system, filename);
+
+	m_op_stats.clear();
+	m_group_stats.clear();
+	m_events.clear();
+}
+
+void Profiler::buffer_allocated(size_t size)
+{
+	if (!m_active) {
+		return;
+	}
+	atomic_add_and_fetch_z(&m_total_bytes, size);
+
+	/* only the thread running the scope changes its counter */
+	ProfileScope *scope = (ProfileScope *)BLI_thread_local_get(g_current_scope);
+	if (scope) {
+		scope->m_bytes += size;
+	}
+}
+
+void Profiler::full_buffer_built()
+{
+	if (m_active) {
+		atomic_add_and_fetch_u(&m_full_buffers, 1);
+	}
+}
+
+void ProfileScope::begin(const rcti *rect)
+{
+	this->m_pixels = rect ? (unsigned int)(BLI_rcti_size_x(rect) * BLI_rcti_size_y(rect)) : 0;
+	this->m_bytes = 0;
+	this->m_parent = (ProfileScope *)BLI_thread_local_get(g_current_scope);
+	BLI_thread_local_set(g_current_scope, this);
+	this->m_start = PIL_check_seconds_timer();
+}
+
+void ProfileScope::end()
+{
+	const double end = PIL_check_seconds_timer();
+	Profiler::TraceEvent event;
+
+	BLI_thread_local_set(g_current_scope, this->m_parent);
+	if (this->m_parent) {
+		this->m_parent->m_bytes += this->m_bytes;
+	}
+
+	event.phase = this->m_phase;
+	event.subject = this->m_group ? (const void *)this->m_group : (const void *)this->m_operation;
+	event.thread = WorkScheduler::current_thread_id() + 1;
+	event.start = this->m_start;
+	event.duration = end - this->m_start;
+	event.pixels = this->m_pixels;
+	event.bytes = this->m_bytes;
+
+	BLI_mutex_lock(&g_mutex);
+	if (this->m_group) {
+		Profiler::GroupStatsMap::iterator it = Profiler::m_group_stats.find(this->m_group);
+		if (it != Profiler::m_group_stats.end()) {
+			Profiler::GroupStats &stats = it->second;
+			if (stats.chunks == 0 || this->m_start < stats.firstStart) {
+				stats.firstStart = this->m_start;
+			}
+			stats.lastEnd = std::max(stats.lastEnd, end);
+			stats.threadTime += event.duration;
+			stats.chunks++;
+			stats.pixels += this->m_pixels;
+			stats.bytes += this->m_bytes;
+		}
+	}
+	else if (this->m_operation) {
+		Profiler::OpStatsMap::iterator it = Profiler::m_op_stats.find(this->m_operation);
+		if (it != Profiler::m_op_stats.end()) {
+			Profiler::OperationStats &stats = it->second;
+			if (this->m_phase == COM_PROFILE_INIT) {
+				stats.initTime += event.duration;
+			}
+			else {
+				stats.tileDataTime += event.duration;
+				stats.tileDataCalls++;
+			}
+			stats.bytes += this->m_bytes;
+		}
+	}
+	Profiler::m_events.push_back(event);
+	BLI_mutex_unlock(&g_mutex);
+}
+
+/* ******** Output ******** */
+
+std::string Profiler::operation_name(const NodeOperation *operation)
+{
+	/* strip the length prefix of GCC and the class prefix of MSVC */
+	const char *type_name = typeid(*operation).name();
+	if (STREQLEN(type_name, "class ", 6)) {
+		type_name += 6;
+	}
+	while (*type_name >= '0' && *type_name <= '9') {
+		type_name++;
+	}
+
+	std::string name = type_name;
+	OpNameMap::const_iterator it = m_op_names.find(operation);
+	if (it != m_op_names.end()) {
+		name += " \"" + it->second + "\"";
+	}
+	return name;
+}
+
+std::string Profiler::group_name(const ExecutionSystem *system, const ExecutionGroup *group)
+{
+	/* groups are named after the operation writing their buffer */
+	NodeOperation *output = group->getOutputOperation();
+	if (output->isWriteBufferOperation()) {
+		output = ((WriteBufferOperation *)output)->getInput();
+	}
+
+	char prefix[32];
+	unsigned int index = std::find(system->m_groups.begin(), system->m_groups.end(), group) - system->m_groups.begin();
+	BLI_snprintf(prefix, sizeof(prefix), "#%u ", index);
+	return prefix + operation_name(output);
+}
+
+static bool group_time_greater(const std::pair<double, std::string> &a, const std::pair<double, std::string> &b)
+{
+	return a.first > b.first;
+}
+
+void Profiler::write_report(const ExecutionSystem *system, const char *filename)
+{
+	const bNodeTree *ntree = system->getContext().getbNodeTree();
+	const double total_time = PIL_check_seconds_timer() - m_start_time;
+	std::vector<std::pair<double, std::string> > lines;
+	char line[1024];
+
+	FILE *fp = BLI_fopen(filename, "wb");
+	if (fp == NULL) {
+		printf("Compositor: can't write profile %s\n", filename);
+		return;
+	}
+
+	fprintf(fp, "Compositor profile of %s\n", ntree ? ntree->id.name + 2 : "");
+	fprintf(fp, "Execution time: %.3f ms, buffers allocated: %.2f MB, threads: %d\n",
+	        total_time * 1000.0, m_total_bytes / (1024.0 * 1024.0), WorkScheduler::get_num_cpu_threads());
+	fprintf(fp, "Full buffers built from tiles: %u\n\n", m_full_buffers);
+
+	fprintf(fp, "Execution groups (wall time spans the chunks, thread time sums them)\n");
+	fprintf(fp, "%10s %10s %7s %9s %9s  %s\n", "wall ms", "thread ms", "chunks", "Mpixels", "MB", "group");
+	for (GroupStatsMap::const_iterator it = m_group_stats.begin(); it != m_group_stats.end(); ++it) {
+		const GroupStats &stats = it->second;
+		const double wall = stats.chunks ? stats.lastEnd - stats.firstStart : 0.0;
+		size_t bytes = stats.bytes;
+
+		/* the buffer of the group is allocated when its output is initialized */
+		OpStatsMap::const_iterator output = m_op_stats.find(it->first->getOutputOperation());
+		if (output != m_op_stats.end()) {
+			bytes += output->second.bytes;
+		}
+
+		BLI_snprintf(line, sizeof(line), "%10.3f %10.3f %7u %9.3f %9.2f  %s\n",
+		             wall * 1000.0, stats.threadTime * 1000.0, stats.chunks, stats.pixels / 1e6,
+		             bytes / (1024.0 * 1024.0), group_name(system, it->first).c_str());
+		lines.push_back(std::make_pair(wall, std::string(line)));
+	}
+	std::stable_sort(lines.begin(), lines.end(), group_time_greater);
+	for (unsigned int index = 0; index < lines.size(); index++) {
+		fputs(lines[index].second.c_str(), fp);
+	}
+	lines.clear();
+
+	fprintf(fp, "\nOperations (reading pixels is part of the chunks of their group)\n");
+	fprintf(fp, "%10s %12s %7s %9s %9s  %s\n", "init ms", "tile data ms", "calls", "Mpixels", "MB", "operation");
+	for (OpStatsMap::const_iterator it = m_op_stats.begin(); it != m_op_stats.end(); ++it) {
+		const OperationStats &stats = it->second;
+		BLI_snprintf(line, sizeof(line), "%10.3f %12.3f %7u %9.3f %9.2f  %s\n",
+		             stats.initTime * 1000.0, stats.tileDataTime * 1000.0, stats.tileDataCalls, stats.pixels / 1e6,
+		             stats.bytes / (1024.0 * 1024.0), operation_name(it->first).c_str());
+		lines.push_back(std::make_pair(stats.initTime + stats.tileDataTime, std::string(line)));
+	}
+	std::stable_sort(lines.begin(), lines.end(), group_time_greater);
+	for (unsigned int index = 0; index < lines.size(); index++) {
+		fputs(lines[index].second.c_str(), fp);
+	}
+
+	fclose(fp);
+	printf("Compositor: profile written to %s\n", filename);
+}
+
+static void write_json_string(FILE *fp, const std::string &str)
+{
+	fputc('"', fp);
+	for (unsigned int index = 0; index < str.size(); index++) {
+		const char c = str[index];
+		if (c == '"' || c == '\\') {
+			fprintf(fp, "\\%c", c);
+		}
+		else if ((unsigned char)c < 0x20) {
+			fprintf(fp, "\\u%04x", c);
+		}
+		else {
+			fputc(c, fp);
+		}
+	}
+	fputc('"', fp);
+}
+
+void Profiler::write_trace(const ExecutionSystem *system, const char *filename)
+{
+	FILE *fp = BLI_fopen(filename, "wb");
+	if (fp == NULL) {
+		printf("Compositor: can't write trace %s\n", filename);
+		return;
+	}
+
+	fprintf(fp, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+	fprintf(fp, "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": 0, \"args\": {\"name\": \"main\"}}");
+	for (int thread = 0; thread < WorkScheduler::get_num_cpu_threads(); thread++) {
+		fprintf(fp, ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": %d, \"args\": {\"name\": \"worker %d\"}}",
+		        thread + 1, thread);
+	}
+
+	for (unsigned int index = 0; index < m_events.size(); index++) {
+		const TraceEvent &event = m_events[index];
+		std::string name = event.phase == COM_PROFILE_CHUNK ?
+		                   group_name(system, (const ExecutionGroup *)event.subject) :
+		                   operation_name((const NodeOperation *)event.subject);
+
+		fprintf(fp, ",\n{\"name\": ");
+		write_json_string(fp, name);
+		fprintf(fp, ", \"cat\": \"%s\", \"ph\": \"X\", \"pid\": 0, \"tid\": %d, \"ts\": %.3f, \"dur\": %.3f, "
+		        "\"args\": {\"pixels\": %u, \"bytes\": %lu}}",
+		        phase_names[event.phase], event.thread, (event.start - m_start_time) * 1e6, event.duration * 1e6,
+		        event.pixels, (unsigned long)event.bytes);
+	}
+
+	fprintf(fp, "\n]}\n");
+	fclose(fp);
+	printf("Compositor: trace written to %s\n", filename);
+}
@@ -0,0 +1,182 @@
+/*
+ * Copyright 2011, Blender Foundation.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor:
+ *		Jeroen Bakker
+ *		Monique Dewanchand
+ */
+
+#ifndef _COM_Profiler_h_
+#define _COM_Profiler_h_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "BLI_sys_types.h"
+
+struct rcti;
+class Node;
+class NodeOperation;
+class ExecutionSystem;
+class ExecutionGroup;
+
+/**
+ * @brief phases of an execution that are timed by a ProfileScope
+ * @ingroup Execution
+ */
+typedef enum ProfilePhase {
+	/** @brief NodeOperation.initExecution */
+	COM_PROFILE_INIT = 0,
+	/** @brief NodeOperation.initializeTileData of a complex operation */
+	COM_PROFILE_TILE_DATA = 1,
+	/** @brief execution of a chunk of an ExecutionGroup */
+	COM_PROFILE_CHUNK = 2
+} ProfilePhase;
+
+/**
+ * @brief records wall time, pixels and allocated buffer memory of an execution
+ *
+ * Profiling is enabled with --debug-compositor (G_DEBUG_COMPOSITOR). When the execution is finished
+ * a report and a trace file (chrome://tracing format) are written to the temporary directory.
+ *
+ * Reading pixels through a chain of operations is not timed per operation, that time is part of the
+ * chunks of the ExecutionGroup. Per operation the initialization and the tile data of complex operations
+ * are timed.
+ * @ingroup Execution
+ */
+class Profiler {
+public:
+	typedef struct OperationStats {
+		double initTime;
+		double tileDataTime;
+		unsigned int tileDataCalls;
+		/** @brief pixels of the chunks of the groups the operation is part of */
+		uint64_t pixels;
+		size_t bytes;
+	} OperationStats;
+
+	typedef struct GroupStats {
+		/** @brief sum of the chunk times over all threads */
+		double threadTime;
+		/** @brief time between the start of the first and the end of the last chunk */
+		double firstStart;
+		double lastEnd;
+		unsigned int chunks;
+		uint64_t pixels;
+		size_t bytes;
+	} GroupStats;
+
+	typedef struct TraceEvent {
+		ProfilePhase phase;
+		const void *subject;
+		int thread;
+		double start;
+		double duration;
+		unsigned int pixels;
+		size_t bytes;
+	} TraceEvent;
+
+	typedef std::map<const NodeOperation *, std::string> OpNameMap;
+	typedef std::map<const NodeOperation *, OperationStats> OpStatsMap;
+	typedef std::map<const ExecutionGroup *, GroupStats> GroupStatsMap;
+
+	/**
+	 * @brief is an execution being profiled
+	 */
+	static bool is_active() { return m_active; }
+
+	static void convert_started();
+	static void operation_added(const NodeOperation *operation, const Node *node);
+	static void operation_fused(const NodeOperation *fused, const NodeOperation *output);
+
+	static void execute_started(const ExecutionSystem *system);
+	static void execute_finished(const ExecutionSystem *system);
+
+	/**
+	 * @brief account a MemoryBuffer or tile allocation to the scope running on this thread
+	 */
+	static void buffer_allocated(size_t size);
+
+	/**
+	 * @brief a streamed MemoryProxy built its full buffer from the tiles
+	 * @see MemoryProxy.getFullBuffer
+	 */
+	static void full_buffer_built();
+
+private:
+	static bool m_active;
+	static int m_file_index;
+	static double m_start_time;
+	static size_t m_total_bytes;
+	static unsigned int m_full_buffers;
+	static OpNameMap m_op_names;
+	static OpStatsMap m_op_stats;
+	static GroupStatsMap m_group_stats;
+	static std::vector<TraceEvent> m_events;
+
+	static std::string operation_name(const NodeOperation *operation);
+	static std::string group_name(const ExecutionSystem *system, const ExecutionGroup *group);
+	static void write_report(const ExecutionSystem *system, const char *filename);
+	static void write_trace(const ExecutionSystem *system, const char *filename);
+
+	friend class ProfileScope;
+};
+
+/**
+ * @brief times the lifetime of the scope when the execution is profiled
+ *
+ * Scopes nest per thread, the memory allocated in a scope is also accounted to its parent.
+ * @ingroup Execution
+ */
+class ProfileScope {
+private:
+	bool m_active;
+	ProfilePhase m_phase;
+	const NodeOperation *m_operation;
+	const ExecutionGroup *m_group;
+	unsigned int m_pixels;
+	double m_start;
+	size_t m_bytes;
+	ProfileScope *m_parent;
+
+	void begin(const rcti *rect);
+	void end();
+
+	friend class Profiler;
+
+public:
+	ProfileScope(ProfilePhase phase, const NodeOperation *operation, const ExecutionGroup *group, const rcti *rect)
+	    : m_active(Profiler::is_active()),
+	      m_phase(phase),
+	      m_operation(operation),
+	      m_group(group)
+	{
+		if (m_active) {
+			begin(rect);
+		}
+	}
+
+	~ProfileScope()
+	{
+		if (m_active) {
+			end();
+		}
+	}
+};
+
+#endif
@@ -21,5 +21,14 @@
  */
 
 #include "COM_SocketReader.h"
+#include "COM_MemoryBuffer.h"
+
+MemoryBuffer *SocketReader::duplicateTileData(rcti *rect)
+{
+	void *data = this->initializeTileData(rect);
+	MemoryBuffer *result = ((MemoryBuffer *)data)->duplicate();
+	this->deinitializeTileData(rect, data);
+	return result;
+}
 
 
@@ -68,6 +68,21 @@ protected:
 	                                 float /*y*/,
 	                                 PixelSampler /*sampler*/) { }
 
+	/**
+	 * @brief calculate a row of pixels
+	 * @note this method is called for non-complex, operations which have cheap per pixel
+	 * logic override it to avoid a virtual call for every pixel of every input
+	 * @param output array of num float[4] pixels to store the result
+	 * @param x the x-coordinate of the first pixel of the row in image space
+	 * @param y the y-coordinate of the row in image space
+	 * @param num number of pixels to calculate, at most COM_ROW_CHUNK_SIZE
+	 */
+	virtual void executeRowSampled(float *output, int x, int y, int num, PixelSampler sampler) {
+		for (int i = 0; i < num; i++) {
+			executePixelSampled(&output[i * COM_NUM_CHANNELS_COLOR], x + i, y, sampler);
+		}
+	}
+
 	/**
 	 * @brief calculate a single pixel
 	 * @note this method is called for complex
@@ -99,6 +114,9 @@ public:
 	inline void readSampled(float result[4], float x, float y, PixelSampler sampler) {
 		executePixelSampled(result, x, y, sampler);
 	}
+	inline void readRowSampled(float *result, int x, int y, int num, PixelSampler sampler) {
+		executeRowSampled(result, x, y, num, sampler);
+	}
 	inline void read(float result[4], int x, int y, void *chunkData) {
 		executePixel(result, x, y, chunkData);
 	}
@@ -109,6 +127,13 @@ public:
 	virtual void *initializeTileData(rcti * /*rect*/) { return 0; }
 	virtual void deinitializeTileData(rcti * /*rect*/, void * /*data*/) {}
 
+	/**
+	 * @brief get a copy of the tile data, owned by the caller
+	 * @note for readers whose tile data is a MemoryBuffer, used by operations that modify
+	 * the whole input in place, a streamed buffer is copied without building its full buffer
+	 */
+	virtual MemoryBuffer *duplicateTileData(rcti *rect);
+
 	virtual ~SocketReader() {}
 
 	virtual MemoryBuffer *getInputMemoryBuffer(MemoryBuffer ** /*memoryBuffers*/) { return 0; }
@@ -20,6 +20,7 @@
  *		Monique Dewanchand
  */
 
+#include <deque>
 #include <list>
 #include <stdio.h>
 
@@ -33,6 +34,8 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "atomic_ops.h"
+
 #include "PIL_time.h"
 #include "BLI_threads.h"
 
@@ -57,8 +60,33 @@ static ThreadLocal(CPUDevice *) g_thread_device;
 /// @brief list of all thread for every CPUDevice in cpudevices a thread exists
 static ListBase g_cputhreads;
 static bool g_cpuInitialized = false;
-/// @brief all scheduled work for the cpu
-static ThreadQueue *g_cpuqueue;
+
+/**
+ * @brief scheduled work for the cpu
+ *
+ * Every cpu thread has its own queue and takes the newest package of it first, that is usually
+ * a chunk that reads the chunk the thread just calculated. An idle thread takes the oldest package
+ * scheduled from outside the cpu threads and otherwise steals the oldest package of another thread.
+ */
+typedef struct CPUQueue {
+	SpinLock lock;
+	std::deque<WorkPackage *> packages;
+} CPUQueue;
+/// @brief queue of every CPUDevice, indexed by thread_id
+static vector<CPUQueue *> g_cpuqueues;
+/// @brief packages scheduled by the main thread and the gpu threads
+static CPUQueue g_cpusharedqueue;
+/// @brief number of packages in all cpu queues
+static unsigned int g_cpuqueued;
+static bool g_cpuStopping;
+static ThreadMutex g_cpumutex;
+/// @brief notified when a package is queued for the cpu or when the cpu threads need to stop
+static ThreadCondition g_cpucondition;
+/// @brief number of scheduled packages (cpu and gpu) that are not finished yet
+static unsigned int g_unfinished;
+/// @brief notified when all scheduled packages are finished
+static ThreadCondition g_finishcondition;
+
 static ThreadQueue *g_gpuqueue;
 #ifdef COM_OPENCL_ENABLED
 static cl_context g_context;
@@ -152,15 +180,96 @@ int COM_isHighlightedbNode(bNode *bnode)
 } // end extern "C"
 
 #if COM_CURRENT_THREADING_MODEL == COM_TM_QUEUE
+static WorkPackage *cpu_queue_take(CPUQueue *queue, bool newest)
+{
+	WorkPackage *package = NULL;
+
+	BLI_spin_lock(&queue->lock);
+	if (!queue->packages.empty()) {
+		if (newest) {
+			package = queue->packages.back();
+			queue->packages.pop_back();
+		}
+		else {
+			package = queue->packages.front();
+			queue->packages.pop_front();
+		}
+	}
+	BLI_spin_unlock(&queue->lock);
+
+	return package;
+}
+
+static void cpu_queue_push(WorkPackage *package)
+{
+	/* packages released by a cpu thread stay on that thread, their input is still in its cache */
+	CPUDevice *device = (CPUDevice *)BLI_thread_local_get(g_thread_device);
+	CPUQueue *queue = device ? g_cpuqueues[device->thread_id()] : &g_cpusharedqueue;
+
+	BLI_spin_lock(&queue->lock);
+	queue->packages.push_back(package);
+	BLI_spin_unlock(&queue->lock);
+
+	atomic_add_and_fetch_u(&g_cpuqueued, 1);
+	BLI_mutex_lock(&g_cpumutex);
+	BLI_condition_notify_one(&g_cpucondition);
+	BLI_mutex_unlock(&g_cpumutex);
+}
+
+/**
+ * @brief wait for a package for the cpu thread with the given index
+ * @return NULL when the cpu threads are stopped
+ */
+static WorkPackage *cpu_queue_pop(unsigned int index)
+{
+	const unsigned int numberOfQueues = g_cpuqueues.size();
+
+	while (true) {
+		WorkPackage *package = cpu_queue_take(g_cpuqueues[index], true);
+		if (package == NULL) {
+			package = cpu_queue_take(&g_cpusharedqueue, false);
+		}
+		for (unsigned int offset = 1; package == NULL && offset < numberOfQueues; offset++) {
+			package = cpu_queue_take(g_cpuqueues[(index + offset) % numberOfQueues], false);
+		}
+
+		if (package) {
+			atomic_sub_and_fetch_u(&g_cpuqueued, 1);
+			return package;
+		}
+
+		BLI_mutex_lock(&g_cpumutex);
+		while (g_cpuqueued == 0 && !g_cpuStopping) {
+			BLI_condition_wait(&g_cpucondition, &g_cpumutex);
+		}
+		const bool stop = (g_cpuqueued == 0);
+		BLI_mutex_unlock(&g_cpumutex);
+
+		if (stop) {
+			return NULL;
+		}
+	}
+}
+
+static void work_finished()
+{
+	if (atomic_sub_and_fetch_u(&g_unfinished, 1) == 0) {
+		BLI_mutex_lock(&g_cpumutex);
+		BLI_condition_notify_all(&g_finishcondition);
+		BLI_mutex_unlock(&g_cpumutex);
+	}
+}
+
 void *WorkScheduler::thread_execute_cpu(void *data)
 {
 	CPUDevice *device = (CPUDevice *)data;
 	WorkPackage *work;
 	BLI_thread_local_set(g_thread_device, device);
-	while ((work = (WorkPackage *)BLI_thread_queue_pop(g_cpuqueue))) {
+	while ((work = cpu_queue_pop(device->thread_id()))) {
 		HIGHLIGHT(work);
 		device->execute(work);
 		delete work;
+		work_finished();
 	}
 	
 	return NULL;
@@ -175,6 +284,7 @@ void *WorkScheduler::thread_execute_gpu(void *data)
 		HIGHLIGHT(work);
 		device->execute(work);
 		delete work;
+		work_finished();
 	}
 	
 	return NULL;
@@ -188,18 +298,22 @@ void WorkScheduler::schedule(ExecutionGroup *group, int chunkNumber)
 	WorkPackage *package = new WorkPackage(group, chunkNumber);
 #if COM_CURRENT_THREADING_MODEL == COM_TM_NOTHREAD
 	CPUDevice device(0);
+	CPUDevice *previous_device = (CPUDevice *)BLI_thread_local_get(g_thread_device);
+	BLI_thread_local_set(g_thread_device, &device);
 	device.execute(package);
+	BLI_thread_local_set(g_thread_device, previous_device);
 	delete package;
 #elif COM_CURRENT_THREADING_MODEL == COM_TM_QUEUE
+	atomic_add_and_fetch_u(&g_unfinished, 1);
 #ifdef COM_OPENCL_ENABLED
 	if (group->isOpenCL() && g_openclActive) {
 		BLI_thread_queue_push(g_gpuqueue, package);
 	}
 	else {
-		BLI_thread_queue_push(g_cpuqueue, package);
+		cpu_queue_push(package);
 	}
 #else
-	BLI_thread_queue_push(g_cpuqueue, package);
+	cpu_queue_push(package);
 #endif
 #endif
 }
@@ -208,7 +322,18 @@ void WorkScheduler::start(CompositorContext &context)
 {
 #if COM_CURRENT_THREADING_MODEL == COM_TM_QUEUE
 	unsigned int index;
-	g_cpuqueue = BLI_thread_queue_init();
+	g_cpuqueued = 0;
+	g_unfinished = 0;
+	g_cpuStopping = false;
+	BLI_mutex_init(&g_cpumutex);
+	BLI_condition_init(&g_cpucondition);
+	BLI_condition_init(&g_finishcondition);
+	BLI_spin_init(&g_cpusharedqueue.lock);
+	for (index = 0; index < g_cpudevices.size(); index++) {
+		CPUQueue *queue = new CPUQueue();
+		BLI_spin_init(&queue->lock);
+		g_cpuqueues.push_back(queue);
+	}
 	BLI_init_threads(&g_cputhreads, thread_execute_cpu, g_cpudevices.size());
 	for (index = 0; index < g_cpudevices.size(); index++) {
 		Device *device = g_cpudevices[index];
@@ -233,26 +358,35 @@ void WorkScheduler::start(CompositorContext &context)
 void WorkScheduler::finish()
 {
 #if COM_CURRENT_THREADING_MODEL == COM_TM_QUEUE
-#ifdef COM_OPENCL_ENABLED
-	if (g_openclActive) {
-		BLI_thread_queue_wait_finish(g_gpuqueue);
-		BLI_thread_queue_wait_finish(g_cpuqueue);
+	/* packages release the packages depending on them, so wait until all of them are finished
+	 * instead of until the queues are empty */
+	BLI_mutex_lock(&g_cpumutex);
+	while (g_unfinished != 0) {
+		BLI_condition_wait(&g_finishcondition, &g_cpumutex);
 	}
-	else {
-		BLI_thread_queue_wait_finish(g_cpuqueue);
-	}
-#else
-	BLI_thread_queue_wait_finish(cpuqueue);
-#endif
+	BLI_mutex_unlock(&g_cpumutex);
 #endif
 }
 void WorkScheduler::stop()
 {
 #if COM_CURRENT_THREADING_MODEL == COM_TM_QUEUE
-	BLI_thread_queue_nowait(g_cpuqueue);
+	BLI_mutex_lock(&g_cpumutex);
+	g_cpuStopping = true;
+	BLI_condition_notify_all(&g_cpucondition);
+	BLI_mutex_unlock(&g_cpumutex);
 	BLI_end_threads(&g_cputhreads);
-	BLI_thread_queue_free(g_cpuqueue);
-	g_cpuqueue = NULL;
+
+	while (g_cpuqueues.size() > 0) {
+		CPUQueue *queue = g_cpuqueues.back();
+		g_cpuqueues.pop_back();
+		BLI_assert(queue->packages.empty());
+		BLI_spin_end(&queue->lock);
+		delete queue;
+	}
+	BLI_spin_end(&g_cpusharedqueue.lock);
+	BLI_condition_end(&g_cpucondition);
+	BLI_condition_end(&g_finishcondition);
+	BLI_mutex_end(&g_cpumutex);
 #ifdef COM_OPENCL_ENABLED
 	if (g_openclActive) {
 		BLI_thread_queue_nowait(g_gpuqueue);
@@ -458,5 +592,16 @@ void WorkScheduler::deinitialize()
 int WorkScheduler::current_thread_id()
 {
 	CPUDevice *device = (CPUDevice *)BLI_thread_local_get(g_thread_device);
-	return device->thread_id();
+	return device ? device->thread_id() : -1;
+}
+
+int WorkScheduler::get_num_cpu_threads()
+{
+	return g_cpudevices.size();
+}
+
+MemoryBuffer *WorkScheduler::current_input_buffer(ReadBufferOperation *readOperation)
+{
+	CPUDevice *device = (CPUDevice *)BLI_thread_local_get(g_thread_device);
+	return device ? device->getInputBuffer(readOperation) : NULL;
 }
@@ -57,9 +57,10 @@ class WorkScheduler {
 public:
 	/**
 	 * @brief schedule a chunk of a group to be calculated.
-	 * An execution group schedules a chunk in the WorkScheduler
+	 * An execution group schedules a chunk in the WorkScheduler when all its input chunks are executed
 	 * when ExecutionGroup.isOpenCL is set the work will be handled by a OpenCLDevice
 	 * otherwise the work is scheduled for an CPUDevice
+	 * @note chunks scheduled from a cpu thread are executed by that thread unless an idle thread steals them
 	 * @see ExecutionGroup.execute
 	 * @param group the execution group
 	 * @param chunkNumber the number of the chunk in the group to be executed
@@ -102,6 +103,7 @@ public:
 
 	/**
 	 * @brief wait for all work to be completed.
+	 * @note this includes the work that is scheduled by finishing work
 	 */
 	static void finish();
 
@@ -113,8 +115,23 @@ public:
 	 */
 	static bool hasGPUDevices();
 
+	/**
+	 * @brief number of the CPUDevice of the current thread, -1 when the thread is not a CPUDevice thread
+	 */
 	static int current_thread_id();
 
+	/**
+	 * @brief number of CPUDevices and so CPU threads
+	 */
+	static int get_num_cpu_threads();
+
+	/**
+	 * @brief input buffer of a streaming MemoryProxy for the chunk the current thread is executing
+	 * @return NULL when the current thread isn't a CPU thread of the scheduler
+	 * @see CPUDevice.getInputBuffer
+	 */
+	static MemoryBuffer *current_input_buffer(ReadBufferOperation *readOperation);
+
 #ifdef WITH_CXX_GUARDEDALLOC
 	MEM_CXX_CLASS_ALLOC_FUNCS("COM:WorkScheduler")
 #endif
@@ -31,6 +31,7 @@ extern "C" {
 #include "BKE_scene.h"
 
 #include "COM_compositor.h"
+#include "COM_CompositorCache.h"
 #include "COM_ExecutionSystem.h"
 #include "COM_WorkScheduler.h"
 #include "clew.h"
@@ -99,11 +100,21 @@ void COM_execute(RenderData *rd, Scene *scene, bNodeTree *editingtree, int rende
 	BLI_mutex_unlock(&s_compositorMutex);
 }
 
+void COM_clearCaches()
+{
+	if (is_compositorMutex_init) {
+		BLI_mutex_lock(&s_compositorMutex);
+		CompositorCache::free();
+		BLI_mutex_unlock(&s_compositorMutex);
+	}
+}
+
 void COM_deinitialize()
 {
 	if (is_compositorMutex_init) {
 		BLI_mutex_lock(&s_compositorMutex);
 		WorkScheduler::deinitialize();
+		CompositorCache::free();
 		is_compositorMutex_init = false;
 		BLI_mutex_unlock(&s_compositorMutex);
 		BLI_mutex_end(&s_compositorMutex);
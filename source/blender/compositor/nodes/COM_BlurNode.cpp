@@ -47,6 +47,7 @@ void BlurNode::convertToOperations(NodeConverter &converter, const CompositorCon
 
 	const float size = this->getInputSocket(1)->getEditorValueFloat();
 	const bool extend_bounds = (editorNode->custom1 & CMP_NODEFLAG_BLUR_EXTEND_BOUNDS) != 0;
+	const bool recursive = (editorNode->custom1 & CMP_NODEFLAG_BLUR_RECURSIVE) != 0;
 
 	CompositorQuality quality = context.getQuality();
 	NodeOperation *input_operation = NULL, *output_operation = NULL;
@@ -110,6 +111,7 @@ void BlurNode::convertToOperations(NodeConverter &converter, const CompositorCon
 		GaussianXBlurOperation *operationx = new GaussianXBlurOperation();
 		operationx->setData(data);
 		operationx->setQuality(quality);
+		operationx->setIIRGauss(recursive);
 		operationx->checkOpenCL();
 		operationx->setExtendBounds(extend_bounds);
 
@@ -119,6 +121,7 @@ void BlurNode::convertToOperations(NodeConverter &converter, const CompositorCon
 		GaussianYBlurOperation *operationy = new GaussianYBlurOperation();
 		operationy->setData(data);
 		operationy->setQuality(quality);
+		operationy->setIIRGauss(recursive);
 		operationy->checkOpenCL();
 		operationy->setExtendBounds(extend_bounds);
 
@@ -138,6 +141,7 @@ void BlurNode::convertToOperations(NodeConverter &converter, const CompositorCon
 		GaussianBokehBlurOperation *operation = new GaussianBokehBlurOperation();
 		operation->setData(data);
 		operation->setQuality(quality);
+		operation->setIIRGauss(recursive);
 		operation->setExtendBounds(extend_bounds);
 
 		converter.addOperation(operation);
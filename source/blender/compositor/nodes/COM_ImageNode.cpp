@@ -129,6 +129,9 @@ void ImageNode::convertToOperations(NodeConverter &converter, const CompositorCo
 							case 1:
 								operation = doMultilayerCheck(converter, rl, image, imageuser, framenumber, index,
 								                              passindex, view, COM_DT_VALUE);
+								if (rpass->passtype == SCE_PASS_Z) {
+									operation->setDepth(true);
+								}
 								break;
 								/* using image operations for both 3 and 4 channels (RGB and RGBA respectively) */
 								/* XXX any way to detect actual vector images? */
@@ -41,7 +41,7 @@ public:
 	/**
 	 * the inner loop of this program
 	 */
-	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void mixRow(float *output, float *inputValue, float *inputColor1, float *inputColor2, int num);
 	
 	void setX(float x) { this->m_x = x; }
 };
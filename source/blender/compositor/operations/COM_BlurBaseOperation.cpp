@@ -40,6 +40,7 @@ BlurBaseOperation::BlurBaseOperation(DataType data_type) : NodeOperation()
 	this->m_size = 1.0f;
 	this->m_sizeavailable = false;
 	this->m_extend_bounds = false;
+	this->m_iirGauss = false;
 }
 void BlurBaseOperation::initExecution()
 {
@@ -176,6 +177,11 @@ void BlurBaseOperation::updateSize()
 	}
 }
 
+bool BlurBaseOperation::useIIRGauss(float rad) const
+{
+	return this->m_iirGauss && (this->m_data.filtertype == R_FILTER_GAUSS) && (rad >= IIR_GAUSS_MIN_RADIUS);
+}
+
 void BlurBaseOperation::determineResolution(unsigned int resolution[2],
                                             unsigned int preferredResolution[2])
 {
@@ -27,6 +27,10 @@
 
 #define MAX_GAUSSTAB_RADIUS 30000
 
+/* when enabled on the node, Gaussian filters of at least this radius are applied as a
+ * recursive (IIR) filter, which costs the same for every radius, instead of a kernel */
+#define IIR_GAUSS_MIN_RADIUS 32
+
 #ifdef __SSE2__
 #  include <emmintrin.h>
 #endif
@@ -45,6 +49,11 @@ protected:
 
 	void updateSize();
 
+	/**
+	 * @brief should a filter of this radius use FastGaussianBlurOperation::IIR_gauss_color
+	 */
+	bool useIIRGauss(float rad) const;
+
 	/**
 	 * Cached reference to the inputProgram
 	 */
@@ -56,6 +65,7 @@ protected:
 	bool m_sizeavailable;
 
 	bool m_extend_bounds;
+	bool m_iirGauss;
 
 public:
 	/**
@@ -74,6 +84,12 @@ public:
 
 	void setExtendBounds(bool extend_bounds) { this->m_extend_bounds = extend_bounds; }
 
+	/**
+	 * @brief allow the recursive filter for large Gaussian radii
+	 * @note must be set before checkOpenCL, the recursive filter only runs on the CPU
+	 */
+	void setIIRGauss(bool iirGauss) { this->m_iirGauss = iirGauss; }
+
 	void determineResolution(unsigned int resolution[2],
 	                         unsigned int preferredResolution[2]);
 };
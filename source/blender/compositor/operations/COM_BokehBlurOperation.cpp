@@ -22,7 +22,9 @@
 
 #include "COM_BokehBlurOperation.h"
 #include "BLI_math.h"
+#include "COM_FFTConvolution.h"
 #include "COM_OpenCLDevice.h"
+#include "MEM_guardedalloc.h"
 
 extern "C" {
 #  include "RE_pipeline.h"
@@ -45,6 +47,8 @@ BokehBlurOperation::BokehBlurOperation() : NodeOperation()
 	this->m_inputBoundingBoxReader = NULL;
 
 	this->m_extend_bounds = false;
+	this->m_usefft = false;
+	this->m_fftbuffer = NULL;
 }
 
 void *BokehBlurOperation::initializeTileData(rcti * /*rect*/)
@@ -54,6 +58,9 @@ void *BokehBlurOperation::initializeTileData(rcti * /*rect*/)
 		updateSize();
 	}
 	void *buffer = getInputOperation(0)->initializeTileData(NULL);
+	if (this->m_usefft && !this->m_fftbuffer) {
+		this->m_fftbuffer = convolveFFT((MemoryBuffer *)buffer);
+	}
 	unlockMutex();
 	return buffer;
 }
@@ -74,6 +81,82 @@ void BokehBlurOperation::initExecution()
 	this->m_bokehMidY = height / 2.0f;
 	this->m_bokehDimension = dimension / 2.0f;
 	QualityStepHelper::initExecution(COM_QH_INCREASE);
+
+	/* the whole input is needed, so the size must be known before the areas of interest are determined */
+	this->m_usefft = this->m_sizeavailable && FFTConvolution::useFFT(2 * getPixelSize(), 2 * getPixelSize());
+}
+
+int BokehBlurOperation::getPixelSize()
+{
+	const float max_dim = max(this->getWidth(), this->getHeight());
+	return this->m_size * max_dim / 100.0f;
+}
+
+MemoryBuffer *BokehBlurOperation::convolveFFT(MemoryBuffer *input)
+{
+	const int pixelSize = getPixelSize();
+	const int kernelSize = 2 * pixelSize;
+	/* executePixel reads the input at offsets from -pixelSize to pixelSize - 1, FFTConvolution reads
+	 * it at center - q, so kernel pixel q holds the bokeh of offset center - q */
+	const int center = pixelSize - 1;
+	const float m = this->m_bokehDimension / pixelSize;
+	const int sat_width = kernelSize + 1;
+	rcti kernelRect;
+	float bokeh[4];
+	double *sat;
+	int x, y, c;
+
+	BLI_rcti_init(&kernelRect, 0, kernelSize, 0, kernelSize);
+	MemoryBuffer *kernel = new MemoryBuffer(COM_DT_COLOR, &kernelRect);
+	for (y = 0; y < kernelSize; y++) {
+		for (x = 0; x < kernelSize; x++) {
+			float u = this->m_bokehMidX - (center - x) * m;
+			float v = this->m_bokehMidY - (center - y) * m;
+			this->m_inputBokehProgram->readSampled(bokeh, u, v, COM_PS_NEAREST);
+			kernel->writePixel(x, y, bokeh);
+		}
+	}
+
+	MemoryBuffer *result = new MemoryBuffer(COM_DT_COLOR, input->getRect());
+	FFTConvolution::convolve(result->getBuffer(), input, kernel, center, center, COM_NUM_CHANNELS_COLOR);
+
+	/* summed area table of the kernel, to normalize by the part of the bokeh inside the input like executePixel */
+	sat = (double *)MEM_callocN(sizeof(double) * sat_width * sat_width * COM_NUM_CHANNELS_COLOR, __func__);
+	for (y = 0; y < kernelSize; y++) {
+		const float *kernelRow = &kernel->getBuffer()[y * kernelSize * COM_NUM_CHANNELS_COLOR];
+		double *satRow = &sat[((y + 1) * sat_width + 1) * COM_NUM_CHANNELS_COLOR];
+		for (x = 0; x < kernelSize; x++) {
+			for (c = 0; c < COM_NUM_CHANNELS_COLOR; c++) {
+				satRow[x * COM_NUM_CHANNELS_COLOR + c] = kernelRow[x * COM_NUM_CHANNELS_COLOR + c] +
+				                                         satRow[(x - 1) * COM_NUM_CHANNELS_COLOR + c] +
+				                                         satRow[(x - sat_width) * COM_NUM_CHANNELS_COLOR + c] -
+				                                         satRow[(x - 1 - sat_width) * COM_NUM_CHANNELS_COLOR + c];
+			}
+		}
+	}
+
+	const rcti &rect = *input->getRect();
+	float *output = result->getBuffer();
+	for (y = rect.ymin; y < rect.ymax; y++) {
+		/* kernel rows of the offsets inside the input */
+		const int qymin = pixelSize - min(pixelSize, rect.ymax - y);
+		const int qymax = pixelSize - max(-pixelSize, rect.ymin - y);
+		for (x = rect.xmin; x < rect.xmax; x++, output += COM_NUM_CHANNELS_COLOR) {
+			const int qxmin = pixelSize - min(pixelSize, rect.xmax - x);
+			const int qxmax = pixelSize - max(-pixelSize, rect.xmin - x);
+			for (c = 0; c < COM_NUM_CHANNELS_COLOR; c++) {
+				const double multiplier_accum = sat[(qymax * sat_width + qxmax) * COM_NUM_CHANNELS_COLOR + c] -
+				                                sat[(qymin * sat_width + qxmax) * COM_NUM_CHANNELS_COLOR + c] -
+				                                sat[(qymax * sat_width + qxmin) * COM_NUM_CHANNELS_COLOR + c] +
+				                                sat[(qymin * sat_width + qxmin) * COM_NUM_CHANNELS_COLOR + c];
+				output[c] *= 1.0f / (float)multiplier_accum;
+			}
+		}
+	}
+
+	MEM_freeN(sat);
+	delete kernel;
+	return result;
 }
 
 void BokehBlurOperation::executePixel(float output[4], int x, int y, void *data)
@@ -83,7 +166,10 @@ void BokehBlurOperation::executePixel(float output[4], int x, int y, void *data)
 	float bokeh[4];
 
 	this->m_inputBoundingBoxReader->readSampled(tempBoundingBox, x, y, COM_PS_NEAREST);
-	if (tempBoundingBox[0] > 0.0f) {
+	if (tempBoundingBox[0] > 0.0f && this->m_fftbuffer) {
+		this->m_fftbuffer->read(output, x, y);
+	}
+	else if (tempBoundingBox[0] > 0.0f) {
 		float multiplier_accum[4] = {0.0f, 0.0f, 0.0f, 0.0f};
 		MemoryBuffer *inputBuffer = (MemoryBuffer *)data;
 		float *buffer = inputBuffer->getBuffer();
@@ -139,6 +225,10 @@ void BokehBlurOperation::executePixel(float output[4], int x, int y, void *data)
 void BokehBlurOperation::deinitExecution()
 {
 	deinitMutex();
+	if (this->m_fftbuffer) {
+		delete this->m_fftbuffer;
+		this->m_fftbuffer = NULL;
+	}
 	this->m_inputProgram = NULL;
 	this->m_inputBokehProgram = NULL;
 	this->m_inputBoundingBoxReader = NULL;
@@ -150,7 +240,13 @@ bool BokehBlurOperation::determineDependingAreaOfInterest(rcti *input, ReadBuffe
 	rcti bokehInput;
 	const float max_dim = max(this->getWidth(), this->getHeight());
 
-	if (this->m_sizeavailable) {
+	if (this->m_usefft) {
+		newInput.xmin = 0;
+		newInput.ymin = 0;
+		newInput.xmax = this->getWidth();
+		newInput.ymax = this->getHeight();
+	}
+	else if (this->m_sizeavailable) {
 		newInput.xmax = input->xmax + (this->m_size * max_dim / 100.0f);
 		newInput.xmin = input->xmin - (this->m_size * max_dim / 100.0f);
 		newInput.ymax = input->ymax + (this->m_size * max_dim / 100.0f);
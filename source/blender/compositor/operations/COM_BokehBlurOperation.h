@@ -38,6 +38,15 @@ private:
 	float m_bokehMidY;
 	float m_bokehDimension;
 	bool m_extend_bounds;
+
+	/**
+	 * @brief large bokehs are convolved with FFTConvolution, decided when the execution starts
+	 */
+	bool m_usefft;
+	/* blurred input when the FFT is used */
+	MemoryBuffer *m_fftbuffer;
+	int getPixelSize();
+	MemoryBuffer *convolveFFT(MemoryBuffer *input);
 public:
 	BokehBlurOperation();
 
@@ -28,6 +28,7 @@ BrightnessOperation::BrightnessOperation() : NodeOperation()
 	this->addInputSocket(COM_DT_VALUE);
 	this->addInputSocket(COM_DT_VALUE);
 	this->addOutputSocket(COM_DT_COLOR);
+	this->setPointwise(true);
 	this->m_inputProgram = NULL;
 }
 void BrightnessOperation::initExecution()
@@ -40,35 +41,62 @@ void BrightnessOperation::initExecution()
 void BrightnessOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
 {
 	float inputValue[4];
-	float a, b;
 	float inputBrightness[4];
 	float inputContrast[4];
+
 	this->m_inputProgram->readSampled(inputValue, x, y, sampler);
 	this->m_inputBrightnessProgram->readSampled(inputBrightness, x, y, sampler);
 	this->m_inputContrastProgram->readSampled(inputContrast, x, y, sampler);
-	float brightness = inputBrightness[0];
-	float contrast = inputContrast[0];
-	brightness /= 100.0f;
-	float delta = contrast / 200.0f;
-	a = 1.0f - delta * 2.0f;
-	/*
-	 * The algorithm is by Werner D. Streidt
-	 * (http://visca.com/ffactory/archives/5-99/msg00021.html)
-	 * Extracted of OpenCV demhist.c
-	 */
-	if (contrast > 0) {
-		a = 1.0f / a;
-		b = a * (brightness - delta);
-	}
-	else {
-		delta *= -1;
-		b = a * (brightness + delta);
+
+	processRow(output, inputValue, inputBrightness, inputContrast, 1);
+}
+
+void BrightnessOperation::executeRowSampled(float *output, int x, int y, int num, PixelSampler sampler)
+{
+	float inputValue[COM_ROW_CHUNK_SIZE * 4];
+	float inputBrightness[COM_ROW_CHUNK_SIZE * 4];
+	float inputContrast[COM_ROW_CHUNK_SIZE * 4];
+
+	this->m_inputProgram->readRowSampled(inputValue, x, y, num, sampler);
+	this->m_inputBrightnessProgram->readRowSampled(inputBrightness, x, y, num, sampler);
+	this->m_inputContrastProgram->readRowSampled(inputContrast, x, y, num, sampler);
+
+	processRow(output, inputValue, inputBrightness, inputContrast, num);
+}
+
+void BrightnessOperation::executeRowKernel(float *output, float **inputs, int num)
+{
+	processRow(output, inputs[0], inputs[1], inputs[2], num);
+}
+
+void BrightnessOperation::processRow(float *output, float *inputValue, float *inputBrightness, float *inputContrast, int num)
+{
+	for (int i = 0; i < num; i++, output += 4, inputValue += 4, inputBrightness += 4, inputContrast += 4) {
+		float a, b;
+		float brightness = inputBrightness[0];
+		float contrast = inputContrast[0];
+		brightness /= 100.0f;
+		float delta = contrast / 200.0f;
+		a = 1.0f - delta * 2.0f;
+		/*
+		 * The algorithm is by Werner D. Streidt
+		 * (http://visca.com/ffactory/archives/5-99/msg00021.html)
+		 * Extracted of OpenCV demhist.c
+		 */
+		if (contrast > 0) {
+			a = 1.0f / a;
+			b = a * (brightness - delta);
+		}
+		else {
+			delta *= -1;
+			b = a * (brightness + delta);
+		}
+
+		output[0] = a * inputValue[0] + b;
+		output[1] = a * inputValue[1] + b;
+		output[2] = a * inputValue[2] + b;
+		output[3] = inputValue[3];
 	}
-	
-	output[0] = a * inputValue[0] + b;
-	output[1] = a * inputValue[1] + b;
-	output[2] = a * inputValue[2] + b;
-	output[3] = inputValue[3];
 }
 
 void BrightnessOperation::deinitExecution()
@@ -38,6 +38,7 @@ ColorBalanceASCCDLOperation::ColorBalanceASCCDLOperation() : NodeOperation()
 	this->addInputSocket(COM_DT_VALUE);
 	this->addInputSocket(COM_DT_COLOR);
 	this->addOutputSocket(COM_DT_COLOR);
+	this->setPointwise(true);
 	this->m_inputValueOperation = NULL;
 	this->m_inputColorOperation = NULL;
 	this->setResolutionInputSocketIndex(1);
@@ -51,21 +52,43 @@ void ColorBalanceASCCDLOperation::initExecution()
 
 void ColorBalanceASCCDLOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
 {
-	float inputColor[4];
 	float value[4];
-	
+	float inputColor[4];
+
 	this->m_inputValueOperation->readSampled(value, x, y, sampler);
 	this->m_inputColorOperation->readSampled(inputColor, x, y, sampler);
-	
-	float fac = value[0];
-	fac = min(1.0f, fac);
-	const float mfac = 1.0f - fac;
-	
-	output[0] = mfac * inputColor[0] + fac * colorbalance_cdl(inputColor[0], this->m_offset[0], this->m_power[0], this->m_slope[0]);
-	output[1] = mfac * inputColor[1] + fac * colorbalance_cdl(inputColor[1], this->m_offset[1], this->m_power[1], this->m_slope[1]);
-	output[2] = mfac * inputColor[2] + fac * colorbalance_cdl(inputColor[2], this->m_offset[2], this->m_power[2], this->m_slope[2]);
-	output[3] = inputColor[3];
 
+	processRow(output, value, inputColor, 1);
+}
+
+void ColorBalanceASCCDLOperation::executeRowSampled(float *output, int x, int y, int num, PixelSampler sampler)
+{
+	float value[COM_ROW_CHUNK_SIZE * 4];
+	float inputColor[COM_ROW_CHUNK_SIZE * 4];
+
+	this->m_inputValueOperation->readRowSampled(value, x, y, num, sampler);
+	this->m_inputColorOperation->readRowSampled(inputColor, x, y, num, sampler);
+
+	processRow(output, value, inputColor, num);
+}
+
+void ColorBalanceASCCDLOperation::executeRowKernel(float *output, float **inputs, int num)
+{
+	processRow(output, inputs[0], inputs[1], num);
+}
+
+void ColorBalanceASCCDLOperation::processRow(float *output, float *value, float *inputColor, int num)
+{
+	for (int i = 0; i < num; i++, output += 4, value += 4, inputColor += 4) {
+		float fac = value[0];
+		fac = min(1.0f, fac);
+		const float mfac = 1.0f - fac;
+
+		output[0] = mfac * inputColor[0] + fac * colorbalance_cdl(inputColor[0], this->m_offset[0], this->m_power[0], this->m_slope[0]);
+		output[1] = mfac * inputColor[1] + fac * colorbalance_cdl(inputColor[1], this->m_offset[1], this->m_power[1], this->m_slope[1]);
+		output[2] = mfac * inputColor[2] + fac * colorbalance_cdl(inputColor[2], this->m_offset[2], this->m_power[2], this->m_slope[2]);
+		output[3] = inputColor[3];
+	}
 }
 
 void ColorBalanceASCCDLOperation::deinitExecution()
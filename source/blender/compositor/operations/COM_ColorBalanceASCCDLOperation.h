@@ -50,6 +50,13 @@ public:
 	 * the inner loop of this program
 	 */
 	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void executeRowSampled(float *output, int x, int y, int num, PixelSampler sampler);
+	void executeRowKernel(float *output, float **inputs, int num);
+
+	/**
+	 * correct num pixels, inputs and output are arrays of float[4] pixels
+	 */
+	void processRow(float *output, float *value, float *inputColor, int num);
 	
 	/**
 	 * Initialize the execution
@@ -43,6 +43,7 @@ ColorBalanceLGGOperation::ColorBalanceLGGOperation() : NodeOperation()
 	this->addInputSocket(COM_DT_VALUE);
 	this->addInputSocket(COM_DT_COLOR);
 	this->addOutputSocket(COM_DT_COLOR);
+	this->setPointwise(true);
 	this->m_inputValueOperation = NULL;
 	this->m_inputColorOperation = NULL;
 	this->setResolutionInputSocketIndex(1);
@@ -56,21 +57,43 @@ void ColorBalanceLGGOperation::initExecution()
 
 void ColorBalanceLGGOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
 {
-	float inputColor[4];
 	float value[4];
-	
+	float inputColor[4];
+
 	this->m_inputValueOperation->readSampled(value, x, y, sampler);
 	this->m_inputColorOperation->readSampled(inputColor, x, y, sampler);
-	
-	float fac = value[0];
-	fac = min(1.0f, fac);
-	const float mfac = 1.0f - fac;
-	
-	output[0] = mfac * inputColor[0] + fac * colorbalance_lgg(inputColor[0], this->m_lift[0], this->m_gamma_inv[0], this->m_gain[0]);
-	output[1] = mfac * inputColor[1] + fac * colorbalance_lgg(inputColor[1], this->m_lift[1], this->m_gamma_inv[1], this->m_gain[1]);
-	output[2] = mfac * inputColor[2] + fac * colorbalance_lgg(inputColor[2], this->m_lift[2], this->m_gamma_inv[2], this->m_gain[2]);
-	output[3] = inputColor[3];
 
+	processRow(output, value, inputColor, 1);
+}
+
+void ColorBalanceLGGOperation::executeRowSampled(float *output, int x, int y, int num, PixelSampler sampler)
+{
+	float value[COM_ROW_CHUNK_SIZE * 4];
+	float inputColor[COM_ROW_CHUNK_SIZE * 4];
+
+	this->m_inputValueOperation->readRowSampled(value, x, y, num, sampler);
+	this->m_inputColorOperation->readRowSampled(inputColor, x, y, num, sampler);
+
+	processRow(output, value, inputColor, num);
+}
+
+void ColorBalanceLGGOperation::executeRowKernel(float *output, float **inputs, int num)
+{
+	processRow(output, inputs[0], inputs[1], num);
+}
+
+void ColorBalanceLGGOperation::processRow(float *output, float *value, float *inputColor, int num)
+{
+	for (int i = 0; i < num; i++, output += 4, value += 4, inputColor += 4) {
+		float fac = value[0];
+		fac = min(1.0f, fac);
+		const float mfac = 1.0f - fac;
+
+		output[0] = mfac * inputColor[0] + fac * colorbalance_lgg(inputColor[0], this->m_lift[0], this->m_gamma_inv[0], this->m_gain[0]);
+		output[1] = mfac * inputColor[1] + fac * colorbalance_lgg(inputColor[1], this->m_lift[1], this->m_gamma_inv[1], this->m_gain[1]);
+		output[2] = mfac * inputColor[2] + fac * colorbalance_lgg(inputColor[2], this->m_lift[2], this->m_gamma_inv[2], this->m_gain[2]);
+		output[3] = inputColor[3];
+	}
 }
 
 void ColorBalanceLGGOperation::deinitExecution()
@@ -34,6 +34,7 @@ ColorRampOperation::ColorRampOperation() : NodeOperation()
 {
 	this->addInputSocket(COM_DT_VALUE);
 	this->addOutputSocket(COM_DT_COLOR);
+	this->setPointwise(true);
 
 	this->m_inputProgram = NULL;
 	this->m_colorBand = NULL;
@@ -51,6 +52,14 @@ void ColorRampOperation::executePixelSampled(float output[4], float x, float y,
 	do_colorband(this->m_colorBand, values[0], output);
 }
 
+void ColorRampOperation::executeRowKernel(float *output, float **inputs, int num)
+{
+	const float *values = inputs[0];
+	for (int i = 0; i < num; i++, output += 4, values += 4) {
+		do_colorband(this->m_colorBand, values[0], output);
+	}
+}
+
 void ColorRampOperation::deinitExecution()
 {
 	this->m_inputProgram = NULL;
@@ -39,6 +39,7 @@ public:
 	 * the inner loop of this program
 	 */
 	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void executeRowKernel(float *output, float **inputs, int num);
 	
 	/**
 	 * Initialize the execution
@@ -130,7 +130,7 @@ void CompositorOperation::deinitExecution()
 
 void CompositorOperation::executeRegion(rcti *rect, unsigned int /*tileNumber*/)
 {
-	float color[8]; // 7 is enough
+	float color[COM_ROW_CHUNK_SIZE * COM_NUM_CHANNELS_COLOR];
 	float *buffer = this->m_outputBuffer;
 	float *zbuffer = this->m_depthBuffer;
 
@@ -187,20 +187,25 @@ void CompositorOperation::executeRegion(rcti *rect, unsigned int /*tileNumber*/)
 #endif
 
 	for (y = y1; y < y2 && (!breaked); y++) {
-		for (x = x1; x < x2 && (!breaked); x++) {
+		for (x = x1; x < x2 && (!breaked); x += COM_ROW_CHUNK_SIZE) {
+			const int num = min_ii(COM_ROW_CHUNK_SIZE, x2 - x);
 			int input_x = x + dx, input_y = y + dy;
+			int i;
 
-			this->m_imageInput->readSampled(color, input_x, input_y, COM_PS_NEAREST);
+			this->m_imageInput->readRowSampled(buffer + offset4, input_x, input_y, num, COM_PS_NEAREST);
 			if (this->m_useAlphaInput) {
-				this->m_alphaInput->readSampled(&(color[3]), input_x, input_y, COM_PS_NEAREST);
+				this->m_alphaInput->readRowSampled(color, input_x, input_y, num, COM_PS_NEAREST);
+				for (i = 0; i < num; i++) {
+					buffer[offset4 + i * COM_NUM_CHANNELS_COLOR + 3] = color[i * COM_NUM_CHANNELS_COLOR];
+				}
 			}
 
-			copy_v4_v4(buffer + offset4, color);
-
-			this->m_depthInput->readSampled(color, input_x, input_y, COM_PS_NEAREST);
-			zbuffer[offset] = color[0];
-			offset4 += COM_NUM_CHANNELS_COLOR;
-			offset++;
+			this->m_depthInput->readRowSampled(color, input_x, input_y, num, COM_PS_NEAREST);
+			for (i = 0; i < num; i++) {
+				zbuffer[offset + i] = color[i * COM_NUM_CHANNELS_COLOR];
+			}
+			offset4 += num * COM_NUM_CHANNELS_COLOR;
+			offset += num;
 			if (isBreaked()) {
 				breaked = true;
 			}
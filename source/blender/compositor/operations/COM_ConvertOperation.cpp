@@ -29,6 +29,7 @@ extern "C" {
 ConvertBaseOperation::ConvertBaseOperation()
 {
 	this->m_inputOperation = NULL;
+	this->setPointwise(true);
 }
 
 void ConvertBaseOperation::initExecution()
@@ -41,6 +42,29 @@ void ConvertBaseOperation::deinitExecution()
 	this->m_inputOperation = NULL;
 }
 
+void ConvertBaseOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+{
+	float input[4];
+	this->m_inputOperation->readSampled(input, x, y, sampler);
+	convertPixel(output, input);
+}
+
+void ConvertBaseOperation::executeRowSampled(float *output, int x, int y, int num, PixelSampler sampler)
+{
+	float input[COM_ROW_CHUNK_SIZE * 4];
+	float *inputs[1] = {input};
+	this->m_inputOperation->readRowSampled(input, x, y, num, sampler);
+	executeRowKernel(output, inputs, num);
+}
+
+void ConvertBaseOperation::executeRowKernel(float *output, float **inputs, int num)
+{
+	const float *input = inputs[0];
+	for (int i = 0; i < num; i++, output += 4, input += 4) {
+		convertPixel(output, input);
+	}
+}
+
 
 /* ******** Value to Color ******** */
 
@@ -50,11 +74,9 @@ ConvertValueToColorOperation::ConvertValueToColorOperation() : ConvertBaseOperat
 	this->addOutputSocket(COM_DT_COLOR);
 }
 
-void ConvertValueToColorOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void ConvertValueToColorOperation::convertPixel(float output[4], const float input[4])
 {
-	float value;
-	this->m_inputOperation->readSampled(&value, x, y, sampler);
-	output[0] = output[1] = output[2] = value;
+	output[0] = output[1] = output[2] = input[0];
 	output[3] = 1.0f;
 }
 
@@ -67,11 +89,9 @@ ConvertColorToValueOperation::ConvertColorToValueOperation() : ConvertBaseOperat
 	this->addOutputSocket(COM_DT_VALUE);
 }
 
-void ConvertColorToValueOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void ConvertColorToValueOperation::convertPixel(float output[4], const float input[4])
 {
-	float inputColor[4];
-	this->m_inputOperation->readSampled(inputColor, x, y, sampler);
-	output[0] = (inputColor[0] + inputColor[1] + inputColor[2]) / 3.0f;
+	output[0] = (input[0] + input[1] + input[2]) / 3.0f;
 }
 
 
@@ -83,11 +103,9 @@ ConvertColorToBWOperation::ConvertColorToBWOperation() : ConvertBaseOperation()
 	this->addOutputSocket(COM_DT_VALUE);
 }
 
-void ConvertColorToBWOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void ConvertColorToBWOperation::convertPixel(float output[4], const float input[4])
 {
-	float inputColor[4];
-	this->m_inputOperation->readSampled(inputColor, x, y, sampler);
-	output[0] = IMB_colormanagement_get_luminance(inputColor);
+	output[0] = IMB_colormanagement_get_luminance(input);
 }
 
 
@@ -99,11 +117,10 @@ ConvertColorToVectorOperation::ConvertColorToVectorOperation() : ConvertBaseOper
 	this->addOutputSocket(COM_DT_VECTOR);
 }
 
-void ConvertColorToVectorOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void ConvertColorToVectorOperation::convertPixel(float output[4], const float input[4])
 {
-	float color[4];
-	this->m_inputOperation->readSampled(color, x, y, sampler);
-	copy_v3_v3(output, color);}
+	copy_v3_v3(output, input);
+}
 
 
 /* ******** Value to Vector ******** */
@@ -114,11 +131,9 @@ ConvertValueToVectorOperation::ConvertValueToVectorOperation() : ConvertBaseOper
 	this->addOutputSocket(COM_DT_VECTOR);
 }
 
-void ConvertValueToVectorOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void ConvertValueToVectorOperation::convertPixel(float output[4], const float input[4])
 {
-	float value;
-	this->m_inputOperation->readSampled(&value, x, y, sampler);
-	output[0] = output[1] = output[2] = value;
+	output[0] = output[1] = output[2] = input[0];
 }
 
 
@@ -130,9 +145,9 @@ ConvertVectorToColorOperation::ConvertVectorToColorOperation() : ConvertBaseOper
 	this->addOutputSocket(COM_DT_COLOR);
 }
 
-void ConvertVectorToColorOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void ConvertVectorToColorOperation::convertPixel(float output[4], const float input[4])
 {
-	this->m_inputOperation->readSampled(output, x, y, sampler);
+	copy_v3_v3(output, input);
 	output[3] = 1.0f;
 }
 
@@ -145,10 +160,8 @@ ConvertVectorToValueOperation::ConvertVectorToValueOperation() : ConvertBaseOper
 	this->addOutputSocket(COM_DT_VALUE);
 }
 
-void ConvertVectorToValueOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void ConvertVectorToValueOperation::convertPixel(float output[4], const float input[4])
 {
-	float input[4];
-	this->m_inputOperation->readSampled(input, x, y, sampler);
 	output[0] = (input[0] + input[1] + input[2]) / 3.0f;
 }
 
@@ -177,18 +190,16 @@ void ConvertRGBToYCCOperation::setMode(int mode)
 	}
 }
 
-void ConvertRGBToYCCOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void ConvertRGBToYCCOperation::convertPixel(float output[4], const float input[4])
 {
-	float inputColor[4];
 	float color[3];
 
-	this->m_inputOperation->readSampled(inputColor, x, y, sampler);
-	rgb_to_ycc(inputColor[0], inputColor[1], inputColor[2], &color[0], &color[1], &color[2], this->m_mode);
+	rgb_to_ycc(input[0], input[1], input[2], &color[0], &color[1], &color[2], this->m_mode);
 
 	/* divided by 255 to normalize for viewing in */
 	/* R,G,B --> Y,Cb,Cr */
 	mul_v3_v3fl(output, color, 1.0f / 255.0f);
-	output[3] = inputColor[3];
+	output[3] = input[3];
 }
 
 /* ******** YCC to RGB ******** */
@@ -215,17 +226,16 @@ void ConvertYCCToRGBOperation::setMode(int mode)
 	}
 }
 
-void ConvertYCCToRGBOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void ConvertYCCToRGBOperation::convertPixel(float output[4], const float input[4])
 {
-	float inputColor[4];
-	this->m_inputOperation->readSampled(inputColor, x, y, sampler);
+	float inputColor[3];
 
 	/* need to un-normalize the data */
 	/* R,G,B --> Y,Cb,Cr */
-	mul_v3_fl(inputColor, 255.0f);
+	mul_v3_v3fl(inputColor, input, 255.0f);
 
 	ycc_to_rgb(inputColor[0], inputColor[1], inputColor[2], &output[0], &output[1], &output[2], this->m_mode);
-	output[3] = inputColor[3];
+	output[3] = input[3];
 }
 
 
@@ -237,12 +247,10 @@ ConvertRGBToYUVOperation::ConvertRGBToYUVOperation() : ConvertBaseOperation()
 	this->addOutputSocket(COM_DT_COLOR);
 }
 
-void ConvertRGBToYUVOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void ConvertRGBToYUVOperation::convertPixel(float output[4], const float input[4])
 {
-	float inputColor[4];
-	this->m_inputOperation->readSampled(inputColor, x, y, sampler);
-	rgb_to_yuv(inputColor[0], inputColor[1], inputColor[2], &output[0], &output[1], &output[2]);
-	output[3] = inputColor[3];
+	rgb_to_yuv(input[0], input[1], input[2], &output[0], &output[1], &output[2]);
+	output[3] = input[3];
 }
 
 
@@ -254,12 +262,10 @@ ConvertYUVToRGBOperation::ConvertYUVToRGBOperation() : ConvertBaseOperation()
 	this->addOutputSocket(COM_DT_COLOR);
 }
 
-void ConvertYUVToRGBOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void ConvertYUVToRGBOperation::convertPixel(float output[4], const float input[4])
 {
-	float inputColor[4];
-	this->m_inputOperation->readSampled(inputColor, x, y, sampler);
-	yuv_to_rgb(inputColor[0], inputColor[1], inputColor[2], &output[0], &output[1], &output[2]);
-	output[3] = inputColor[3];
+	yuv_to_rgb(input[0], input[1], input[2], &output[0], &output[1], &output[2]);
+	output[3] = input[3];
 }
 
 
@@ -271,12 +277,10 @@ ConvertRGBToHSVOperation::ConvertRGBToHSVOperation() : ConvertBaseOperation()
 	this->addOutputSocket(COM_DT_COLOR);
 }
 
-void ConvertRGBToHSVOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void ConvertRGBToHSVOperation::convertPixel(float output[4], const float input[4])
 {
-	float inputColor[4];
-	this->m_inputOperation->readSampled(inputColor, x, y, sampler);
-	rgb_to_hsv_v(inputColor, output);
-	output[3] = inputColor[3];
+	rgb_to_hsv_v(input, output);
+	output[3] = input[3];
 }
 
 
@@ -288,15 +292,13 @@ ConvertHSVToRGBOperation::ConvertHSVToRGBOperation() : ConvertBaseOperation()
 	this->addOutputSocket(COM_DT_COLOR);
 }
 
-void ConvertHSVToRGBOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void ConvertHSVToRGBOperation::convertPixel(float output[4], const float input[4])
 {
-	float inputColor[4];
-	this->m_inputOperation->readSampled(inputColor, x, y, sampler);
-	hsv_to_rgb_v(inputColor, output);
+	hsv_to_rgb_v(input, output);
 	output[0] = max_ff(output[0], 0.0f);
 	output[1] = max_ff(output[1], 0.0f);
 	output[2] = max_ff(output[2], 0.0f);
-	output[3] = inputColor[3];
+	output[3] = input[3];
 }
 
 
@@ -308,19 +310,15 @@ ConvertPremulToStraightOperation::ConvertPremulToStraightOperation() : ConvertBa
 	this->addOutputSocket(COM_DT_COLOR);
 }
 
-void ConvertPremulToStraightOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void ConvertPremulToStraightOperation::convertPixel(float output[4], const float input[4])
 {
-	float inputValue[4];
-	float alpha;
-
-	this->m_inputOperation->readSampled(inputValue, x, y, sampler);
-	alpha = inputValue[3];
+	float alpha = input[3];
 
 	if (fabsf(alpha) < 1e-5f) {
 		zero_v3(output);
 	}
 	else {
-		mul_v3_v3fl(output, inputValue, 1.0f / alpha);
+		mul_v3_v3fl(output, input, 1.0f / alpha);
 	}
 
 	/* never touches the alpha */
@@ -336,15 +334,11 @@ ConvertStraightToPremulOperation::ConvertStraightToPremulOperation() : ConvertBa
 	this->addOutputSocket(COM_DT_COLOR);
 }
 
-void ConvertStraightToPremulOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void ConvertStraightToPremulOperation::convertPixel(float output[4], const float input[4])
 {
-	float inputValue[4];
-	float alpha;
+	float alpha = input[3];
 
-	this->m_inputOperation->readSampled(inputValue, x, y, sampler);
-	alpha = inputValue[3];
-
-	mul_v3_v3fl(output, inputValue, alpha);
+	mul_v3_v3fl(output, input, alpha);
 
 	/* never touches the alpha */
 	output[3] = alpha;
@@ -357,6 +351,7 @@ SeparateChannelOperation::SeparateChannelOperation() : NodeOperation()
 {
 	this->addInputSocket(COM_DT_COLOR);
 	this->addOutputSocket(COM_DT_VALUE);
+	this->setPointwise(true);
 	this->m_inputOperation = NULL;
 }
 void SeparateChannelOperation::initExecution()
@@ -377,6 +372,14 @@ void SeparateChannelOperation::executePixelSampled(float output[4], float x, flo
 	output[0] = input[this->m_channel];
 }
 
+void SeparateChannelOperation::executeRowKernel(float *output, float **inputs, int num)
+{
+	const float *input = inputs[0];
+	for (int i = 0; i < num; i++, output += 4, input += 4) {
+		output[0] = input[this->m_channel];
+	}
+}
+
 
 /* ******** Combine Channels ******** */
 
@@ -388,6 +391,7 @@ CombineChannelsOperation::CombineChannelsOperation() : NodeOperation()
 	this->addInputSocket(COM_DT_VALUE);
 	this->addOutputSocket(COM_DT_COLOR);
 	this->setResolutionInputSocketIndex(0);
+	this->setPointwise(true);
 	this->m_inputChannel1Operation = NULL;
 	this->m_inputChannel2Operation = NULL;
 	this->m_inputChannel3Operation = NULL;
@@ -431,3 +435,13 @@ void CombineChannelsOperation::executePixelSampled(float output[4], float x, flo
 		output[3] = input[0];
 	}
 }
+
+void CombineChannelsOperation::executeRowKernel(float *output, float **inputs, int num)
+{
+	for (int i = 0; i < num; i++, output += 4) {
+		output[0] = inputs[0][i * 4];
+		output[1] = inputs[1][i * 4];
+		output[2] = inputs[2][i * 4];
+		output[3] = inputs[3][i * 4];
+	}
+}
@@ -33,6 +33,15 @@ protected:
 public:
 	ConvertBaseOperation();
 	
+	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void executeRowSampled(float *output, int x, int y, int num, PixelSampler sampler);
+	void executeRowKernel(float *output, float **inputs, int num);
+
+	/**
+	 * convert a single pixel, subclasses implement their conversion here
+	 */
+	virtual void convertPixel(float output[4], const float input[4]) = 0;
+	
 	void initExecution();
 	void deinitExecution();
 };
@@ -42,7 +51,7 @@ class ConvertValueToColorOperation : public ConvertBaseOperation {
 public:
 	ConvertValueToColorOperation();
 	
-	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void convertPixel(float output[4], const float input[4]);
 };
 
 
@@ -50,7 +59,7 @@ class ConvertColorToValueOperation : public ConvertBaseOperation {
 public:
 	ConvertColorToValueOperation();
 	
-	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void convertPixel(float output[4], const float input[4]);
 };
 
 
@@ -58,7 +67,7 @@ class ConvertColorToBWOperation : public ConvertBaseOperation {
 public:
 	ConvertColorToBWOperation();
 	
-	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void convertPixel(float output[4], const float input[4]);
 };
 
 
@@ -66,7 +75,7 @@ class ConvertColorToVectorOperation : public ConvertBaseOperation {
 public:
 	ConvertColorToVectorOperation();
 	
-	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void convertPixel(float output[4], const float input[4]);
 };
 
 
@@ -74,7 +83,7 @@ class ConvertValueToVectorOperation : public ConvertBaseOperation {
 public:
 	ConvertValueToVectorOperation();
 	
-	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void convertPixel(float output[4], const float input[4]);
 };
 
 
@@ -82,7 +91,7 @@ class ConvertVectorToColorOperation : public ConvertBaseOperation {
 public:
 	ConvertVectorToColorOperation();
 	
-	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void convertPixel(float output[4], const float input[4]);
 };
 
 
@@ -90,7 +99,7 @@ class ConvertVectorToValueOperation : public ConvertBaseOperation {
 public:
 	ConvertVectorToValueOperation();
 	
-	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void convertPixel(float output[4], const float input[4]);
 };
 
 
@@ -101,7 +110,7 @@ private:
 public:
 	ConvertRGBToYCCOperation();
 
-	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void convertPixel(float output[4], const float input[4]);
 
 	/** Set the YCC mode */
 	void setMode(int mode);
@@ -115,7 +124,7 @@ private:
 public:
 	ConvertYCCToRGBOperation();
 	
-	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void convertPixel(float output[4], const float input[4]);
 	
 	/** Set the YCC mode */
 	void setMode(int mode);
@@ -126,7 +135,7 @@ class ConvertRGBToYUVOperation : public ConvertBaseOperation {
 public:
 	ConvertRGBToYUVOperation();
 	
-	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void convertPixel(float output[4], const float input[4]);
 };
 
 
@@ -134,7 +143,7 @@ class ConvertYUVToRGBOperation : public ConvertBaseOperation {
 public:
 	ConvertYUVToRGBOperation();
 	
-	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void convertPixel(float output[4], const float input[4]);
 };
 
 
@@ -142,7 +151,7 @@ class ConvertRGBToHSVOperation : public ConvertBaseOperation {
 public:
 	ConvertRGBToHSVOperation();
 	
-	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void convertPixel(float output[4], const float input[4]);
 };
 
 
@@ -150,7 +159,7 @@ class ConvertHSVToRGBOperation : public ConvertBaseOperation {
 public:
 	ConvertHSVToRGBOperation();
 	
-	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void convertPixel(float output[4], const float input[4]);
 };
 
 
@@ -158,7 +167,7 @@ class ConvertPremulToStraightOperation : public ConvertBaseOperation {
 public:
 	ConvertPremulToStraightOperation();
 
-	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void convertPixel(float output[4], const float input[4]);
 };
 
 
@@ -166,7 +175,7 @@ class ConvertStraightToPremulOperation : public ConvertBaseOperation {
 public:
 	ConvertStraightToPremulOperation();
 
-	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void convertPixel(float output[4], const float input[4]);
 };
 
 
@@ -177,6 +186,7 @@ private:
 public:
 	SeparateChannelOperation();
 	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void executeRowKernel(float *output, float **inputs, int num);
 	
 	void initExecution();
 	void deinitExecution();
@@ -194,6 +204,7 @@ private:
 public:
 	CombineChannelsOperation();
 	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void executeRowKernel(float *output, float **inputs, int num);
 	
 	void initExecution();
 	void deinitExecution();
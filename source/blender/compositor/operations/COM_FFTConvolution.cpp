@@ -0,0 +1,399 @@
+/*
+ * Copyright 2011, Blender Foundation.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor:
+ *		Jeroen Bakker
+ *		Monique Dewanchand
+ */
+
+#include "COM_FFTConvolution.h"
+#include "MEM_guardedalloc.h"
+
+extern "C" {
+#  include "BLI_task.h"
+}
+
+/* the blocks of the image are at least this large when the image is, to limit the overhead of the transforms */
+#define FFT_CONVOLUTION_MIN_BLOCK_SIZE 256
+
+/*
+ *  2D Fast Hartley Transform, used for convolution
+ */
+
+typedef float fREAL;
+
+// returns next highest power of 2 of x, as well it's log2 in L2
+static unsigned int nextPow2(unsigned int x, unsigned int *L2)
+{
+	unsigned int pw, x_notpow2 = x & (x - 1);
+	*L2 = 0;
+	while (x >>= 1) ++(*L2);
+	pw = 1 << (*L2);
+	if (x_notpow2) { (*L2)++;  pw <<= 1; }
+	return pw;
+}
+
+//------------------------------------------------------------------------------
+
+// from FXT library by Joerg Arndt, faster in order bitreversal
+// use: r = revbin_upd(r, h) where h = N>>1
+static unsigned int revbin_upd(unsigned int r, unsigned int h)
+{
+	while (!((r ^= h) & h)) h >>= 1;
+	return r;
+}
+//------------------------------------------------------------------------------
+static void FHT(fREAL *data, unsigned int M, unsigned int inverse)
+{
+	double tt, fc, dc, fs, ds, a = M_PI;
+	fREAL t1, t2;
+	int n2, bd, bl, istep, k, len = 1 << M, n = 1;
+
+	int i, j = 0;
+	unsigned int Nh = len >> 1;
+	for (i = 1; i < (len - 1); ++i) {
+		j = revbin_upd(j, Nh);
+		if (j > i) {
+			t1 = data[i];
+			data[i] = data[j];
+			data[j] = t1;
+		}
+	}
+
+	do {
+		fREAL *data_n = &data[n];
+
+		istep = n << 1;
+		for (k = 0; k < len; k += istep) {
+			t1 = data_n[k];
+			data_n[k] = data[k] - t1;
+			data[k] += t1;
+		}
+
+		n2 = n >> 1;
+		if (n > 2) {
+			fc = dc = cos(a);
+			fs = ds = sqrt(1.0 - fc * fc); //sin(a);
+			bd = n - 2;
+			for (bl = 1; bl < n2; bl++) {
+				fREAL *data_nbd = &data_n[bd];
+				fREAL *data_bd = &data[bd];
+				for (k = bl; k < len; k += istep) {
+					t1 = fc * (double)data_n[k] + fs * (double)data_nbd[k];
+					t2 = fs * (double)data_n[k] - fc * (double)data_nbd[k];
+					data_n[k] = data[k] - t1;
+					data_nbd[k] = data_bd[k] - t2;
+					data[k] += t1;
+					data_bd[k] += t2;
+				}
+				tt = fc * dc - fs * ds;
+				fs = fs * dc + fc * ds;
+				fc = tt;
+				bd -= 2;
+			}
+		}
+
+		if (n > 1) {
+			for (k = n2; k < len; k += istep) {
+				t1 = data_n[k];
+				data_n[k] = data[k] - t1;
+				data[k] += t1;
+			}
+		}
+
+		n = istep;
+		a *= 0.5;
+	} while (n < len);
+
+	if (inverse) {
+		fREAL sc = (fREAL)1 / (fREAL)len;
+		for (k = 0; k < len; ++k)
+			data[k] *= sc;
+	}
+}
+//------------------------------------------------------------------------------
+/* 2D Fast Hartley Transform, Mx/My -> log2 of width/height,
+ * nzp -> the row where zero pad data starts,
+ * inverse -> see above */
+static void FHT2D(fREAL *data, unsigned int Mx, unsigned int My,
+                  unsigned int nzp, unsigned int inverse)
+{
+	unsigned int i, j, Nx, Ny, maxy;
+
+	Nx = 1 << Mx;
+	Ny = 1 << My;
+
+	// rows (forward transform skips 0 pad data)
+	maxy = inverse ? Ny : nzp;
+	for (j = 0; j < maxy; ++j)
+		FHT(&data[Nx * j], Mx, inverse);
+
+	// transpose data
+	if (Nx == Ny) {  // square
+		for (j = 0; j < Ny; ++j)
+			for (i = j + 1; i < Nx; ++i) {
+				unsigned int op = i + (j << Mx), np = j + (i << My);
+				SWAP(fREAL, data[op], data[np]);
+			}
+	}
+	else {  // rectangular
+		unsigned int k, Nym = Ny - 1, stm = 1 << (Mx + My);
+		for (i = 0; stm > 0; i++) {
+#define PRED(k) (((k & Nym) << Mx) + (k >> My))
+			for (j = PRED(i); j > i; j = PRED(j)) ;
+			if (j < i) continue;
+			for (k = i, j = PRED(i); j != i; k = j, j = PRED(j), stm--) {
+				SWAP(fREAL, data[j], data[k]);
+			}
+#undef PRED
+			stm--;
+		}
+	}
+
+	SWAP(unsigned int, Nx, Ny);
+	SWAP(unsigned int, Mx, My);
+
+	// now columns == transposed rows
+	for (j = 0; j < Ny; ++j)
+		FHT(&data[Nx * j], Mx, inverse);
+
+	// finalize
+	for (j = 0; j <= (Ny >> 1); j++) {
+		unsigned int jm = (Ny - j) & (Ny - 1);
+		unsigned int ji = j << Mx;
+		unsigned int jmi = jm << Mx;
+		for (i = 0; i <= (Nx >> 1); i++) {
+			unsigned int im = (Nx - i) & (Nx - 1);
+			fREAL A = data[ji + i];
+			fREAL B = data[jmi + i];
+			fREAL C = data[ji + im];
+			fREAL D = data[jmi + im];
+			fREAL E = (fREAL)0.5 * ((A + D) - (B + C));
+			data[ji + i] = A - E;
+			data[jmi + i] = B + E;
+			data[ji + im] = C + E;
+			data[jmi + im] = D - E;
+		}
+	}
+
+}
+
+//------------------------------------------------------------------------------
+
+/* 2D convolution calc, d1 *= d2, M/N - > log2 of width/height */
+static void fht_convolve(fREAL *d1, fREAL *d2, unsigned int M, unsigned int N)
+{
+	fREAL a, b;
+	unsigned int i, j, k, L, mj, mL;
+	unsigned int m = 1 << M, n = 1 << N;
+	unsigned int m2 = 1 << (M - 1), n2 = 1 << (N - 1);
+	unsigned int mn2 = m << (N - 1);
+
+	d1[0] *= d2[0];
+	d1[mn2] *= d2[mn2];
+	d1[m2] *= d2[m2];
+	d1[m2 + mn2] *= d2[m2 + mn2];
+	for (i = 1; i < m2; i++) {
+		k = m - i;
+		a = d1[i] * d2[i] - d1[k] * d2[k];
+		b = d1[k] * d2[i] + d1[i] * d2[k];
+		d1[i] = (b + a) * (fREAL)0.5;
+		d1[k] = (b - a) * (fREAL)0.5;
+		a = d1[i + mn2] * d2[i + mn2] - d1[k + mn2] * d2[k + mn2];
+		b = d1[k + mn2] * d2[i + mn2] + d1[i + mn2] * d2[k + mn2];
+		d1[i + mn2] = (b + a) * (fREAL)0.5;
+		d1[k + mn2] = (b - a) * (fREAL)0.5;
+	}
+	for (j = 1; j < n2; j++) {
+		L = n - j;
+		mj = j << M;
+		mL = L << M;
+		a = d1[mj] * d2[mj] - d1[mL] * d2[mL];
+		b = d1[mL] * d2[mj] + d1[mj] * d2[mL];
+		d1[mj] = (b + a) * (fREAL)0.5;
+		d1[mL] = (b - a) * (fREAL)0.5;
+		a = d1[m2 + mj] * d2[m2 + mj] - d1[m2 + mL] * d2[m2 + mL];
+		b = d1[m2 + mL] * d2[m2 + mj] + d1[m2 + mj] * d2[m2 + mL];
+		d1[m2 + mj] = (b + a) * (fREAL)0.5;
+		d1[m2 + mL] = (b - a) * (fREAL)0.5;
+	}
+	for (i = 1; i < m2; i++) {
+		k = m - i;
+		for (j = 1; j < n2; j++) {
+			L = n - j;
+			mj = j << M;
+			mL = L << M;
+			a = d1[i + mj] * d2[i + mj] - d1[k + mL] * d2[k + mL];
+			b = d1[k + mL] * d2[i + mj] + d1[i + mj] * d2[k + mL];
+			d1[i + mj] = (b + a) * (fREAL)0.5;
+			d1[k + mL] = (b - a) * (fREAL)0.5;
+			a = d1[i + mL] * d2[i + mL] - d1[k + mj] * d2[k + mj];
+			b = d1[k + mj] * d2[i + mL] + d1[i + mL] * d2[k + mj];
+			d1[i + mL] = (b + a) * (fREAL)0.5;
+			d1[k + mj] = (b - a) * (fREAL)0.5;
+		}
+	}
+}
+//------------------------------------------------------------------------------
+
+/* ******** Convolution ******** */
+
+typedef struct FFTConvolveData {
+	float *dst;
+	const float *image;
+	const float *kernel;
+	int imageWidth, imageHeight;
+	int kernelWidth, kernelHeight;
+	int centerx, centery;
+	unsigned int num_channels;
+
+	/* FFT size and its log2 */
+	unsigned int w2, h2, log2_w, log2_h;
+	/* block size and number of blocks */
+	int xbsz, ybsz, nxb, nyb;
+
+	/* transformed kernel of every channel */
+	fREAL **kernelData;
+
+	/* the blocks with this parity of their x and y index don't overlap and are convolved in parallel */
+	int phase;
+	int nxb_phase;
+} FFTConvolveData;
+
+static void fft_convolve_kernel_task(void *userdata, const int ch)
+{
+	FFTConvolveData *data = (FFTConvolveData *)userdata;
+	fREAL *fp = (fREAL *)MEM_callocN(data->w2 * data->h2 * sizeof(fREAL), "convolve_fast FHT kernel");
+	int x, y;
+
+	for (y = 0; y < data->kernelHeight; y++) {
+		const float *colp = &data->kernel[y * data->kernelWidth * COM_NUM_CHANNELS_COLOR + ch];
+		for (x = 0; x < data->kernelWidth; x++) {
+			fp[y * data->w2 + x] = colp[x * COM_NUM_CHANNELS_COLOR];
+		}
+	}
+	FHT2D(fp, data->log2_w, data->log2_h, data->kernelHeight, 0);
+
+	data->kernelData[ch] = fp;
+}
+
+static void fft_convolve_block_task(void *userdata, const int iter)
+{
+	FFTConvolveData *data = (FFTConvolveData *)userdata;
+	const unsigned int w2 = data->w2, h2 = data->h2;
+	const int ch = iter % data->num_channels;
+	const int block = iter / data->num_channels;
+	const int xbl = (data->phase & 1) + 2 * (block % data->nxb_phase);
+	const int ybl = (data->phase >> 1) + 2 * (block / data->nxb_phase);
+	const int xstart = xbl * data->xbsz, ystart = ybl * data->ybsz;
+	const int xend = min(xstart + data->xbsz, data->imageWidth);
+	const int yend = min(ystart + data->ybsz, data->imageHeight);
+	fREAL *fp = (fREAL *)MEM_callocN(w2 * h2 * sizeof(fREAL), "convolve_fast FHT block");
+	int x, y;
+
+	// image block, channel ch -> fp
+	for (y = ystart; y < yend; y++) {
+		fREAL *row = &fp[(y - ystart) * w2];
+		const float *colp = &data->image[((size_t)y * data->imageWidth) * COM_NUM_CHANNELS_COLOR + ch];
+		for (x = xstart; x < xend; x++) {
+			row[x - xstart] = colp[x * COM_NUM_CHANNELS_COLOR];
+		}
+	}
+
+	// forward FHT, rows from yend on are zero
+	FHT2D(fp, data->log2_w, data->log2_h, yend - ystart, 0);
+
+	// FHT2D transposed data, row/col now swapped
+	// convolve & inverse FHT
+	fht_convolve(fp, data->kernelData[ch], data->log2_h, data->log2_w);
+	FHT2D(fp, data->log2_h, data->log2_w, 0, 1);
+	// data again transposed, so in order again
+
+	// overlap-add result, blocks that are convolved at the same time never overlap
+	for (y = 0; y < (int)h2; y++) {
+		const int yy = ystart + y - data->centery;
+		if ((yy < 0) || (yy >= data->imageHeight)) continue;
+		const fREAL *row = &fp[y * w2];
+		float *colp = &data->dst[((size_t)yy * data->imageWidth) * COM_NUM_CHANNELS_COLOR + ch];
+		for (x = 0; x < (int)w2; x++) {
+			const int xx = xstart + x - data->centerx;
+			if ((xx < 0) || (xx >= data->imageWidth)) continue;
+			colp[xx * COM_NUM_CHANNELS_COLOR] += row[x];
+		}
+	}
+
+	MEM_freeN(fp);
+}
+
+/* FFT size for one dimension, at least twice the kernel so the blocks of a phase don't overlap */
+static unsigned int fft_size(unsigned int kernelSize, unsigned int imageSize, unsigned int *L2)
+{
+	const unsigned int blockSize = max(kernelSize, min(imageSize, (unsigned int)FFT_CONVOLUTION_MIN_BLOCK_SIZE));
+	return nextPow2(kernelSize + blockSize - 1, L2);
+}
+
+void FFTConvolution::convolve(float *dst, MemoryBuffer *image, MemoryBuffer *kernel,
+                              int centerx, int centery, unsigned int num_channels)
+{
+	FFTConvolveData data;
+	unsigned int ch;
+
+	BLI_assert(image->get_num_channels() == COM_NUM_CHANNELS_COLOR);
+	BLI_assert(kernel->get_num_channels() == COM_NUM_CHANNELS_COLOR);
+	BLI_assert(num_channels <= COM_NUM_CHANNELS_COLOR);
+
+	data.dst = dst;
+	data.image = image->getBuffer();
+	data.kernel = kernel->getBuffer();
+	data.imageWidth = image->getWidth();
+	data.imageHeight = image->getHeight();
+	data.kernelWidth = kernel->getWidth();
+	data.kernelHeight = kernel->getHeight();
+	data.centerx = centerx;
+	data.centery = centery;
+	data.num_channels = num_channels;
+
+	memset(dst, 0, sizeof(float) * data.imageWidth * data.imageHeight * COM_NUM_CHANNELS_COLOR);
+
+	// FFT pow2 required size & log2
+	data.w2 = fft_size(data.kernelWidth, data.imageWidth, &data.log2_w);
+	data.h2 = fft_size(data.kernelHeight, data.imageHeight, &data.log2_h);
+
+	// block add-overlap
+	data.xbsz = (data.w2 + 1) - data.kernelWidth;
+	data.ybsz = (data.h2 + 1) - data.kernelHeight;
+	data.nxb = (data.imageWidth + data.xbsz - 1) / data.xbsz;
+	data.nyb = (data.imageHeight + data.ybsz - 1) / data.ybsz;
+
+	// only need to calc fht data of the kernel once, it is re-used for every block
+	data.kernelData = (fREAL **)MEM_callocN(num_channels * sizeof(fREAL *), "convolve_fast FHT kernels");
+	BLI_task_parallel_range(0, num_channels, &data, fft_convolve_kernel_task, true);
+
+	for (data.phase = 0; data.phase < 4; data.phase++) {
+		const int nxb_phase = (data.nxb - (data.phase & 1) + 1) / 2;
+		const int nyb_phase = (data.nyb - (data.phase >> 1) + 1) / 2;
+		data.nxb_phase = nxb_phase;
+		if (nxb_phase > 0 && nyb_phase > 0) {
+			BLI_task_parallel_range(0, nxb_phase * nyb_phase * num_channels, &data, fft_convolve_block_task, true);
+		}
+	}
+
+	for (ch = 0; ch < num_channels; ch++) {
+		MEM_freeN(data.kernelData[ch]);
+	}
+	MEM_freeN(data.kernelData);
+}
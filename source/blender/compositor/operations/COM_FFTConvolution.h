@@ -0,0 +1,58 @@
+/*
+ * Copyright 2011, Blender Foundation.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor:
+ *		Jeroen Bakker
+ *		Monique Dewanchand
+ */
+
+#ifndef _COM_FFTConvolution_h
+#define _COM_FFTConvolution_h
+
+#include "COM_MemoryBuffer.h"
+
+/* kernels of at least this width or height are faster to convolve with FFTConvolution than with a direct loop */
+#define FFT_CONVOLUTION_MIN_SIZE 16
+
+/**
+ * @brief convolution of color buffers with large kernels using the Fast Hartley Transform
+ *
+ * The image is split in blocks, every block is transformed, multiplied with the transformed kernel
+ * and added back to the result (overlap-add). The blocks and channels are convolved in parallel.
+ */
+class FFTConvolution {
+public:
+	/**
+	 * @brief convolve the first channels of a color image with a color kernel
+	 *
+	 * dst(p) = sum over q of kernel(q) * image(p + center - q), pixels outside the image are black.
+	 * @param dst color buffer of the size of the image, channels from num_channels on are set to zero
+	 * @param centerx, centery the kernel pixel that is aligned with the destination pixel
+	 */
+	static void convolve(float *dst, MemoryBuffer *image, MemoryBuffer *kernel,
+	                     int centerx, int centery, unsigned int num_channels);
+
+	/**
+	 * @brief is convolve faster than a direct loop for a kernel of this size
+	 */
+	static bool useFFT(unsigned int kernelWidth, unsigned int kernelHeight)
+	{
+		return max(kernelWidth, kernelHeight) >= FFT_CONVOLUTION_MIN_SIZE;
+	}
+};
+
+#endif
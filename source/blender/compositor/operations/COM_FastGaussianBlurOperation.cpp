@@ -26,6 +26,10 @@
 #include "MEM_guardedalloc.h"
 #include "BLI_utildefines.h"
 
+extern "C" {
+#  include "BLI_task.h"
+}
+
 FastGaussianBlurOperation::FastGaussianBlurOperation() : BlurBaseOperation(COM_DT_COLOR)
 {
 	this->m_iirgaus = NULL;
@@ -83,26 +87,22 @@ void *FastGaussianBlurOperation::initializeTileData(rcti *rect)
 {
 	lockMutex();
 	if (!this->m_iirgaus) {
-		MemoryBuffer *newBuf = (MemoryBuffer *)this->m_inputProgram->initializeTileData(rect);
-		MemoryBuffer *copy = newBuf->duplicate();
+		/* the blur works in place, a streamed input is copied without building its full buffer */
+		MemoryBuffer *copy = this->m_inputProgram->duplicateTileData(rect);
 		updateSize();
 
-		int c;
 		this->m_sx = this->m_data.sizex * this->m_size / 2.0f;
 		this->m_sy = this->m_data.sizey * this->m_size / 2.0f;
 		
 		if ((this->m_sx == this->m_sy) && (this->m_sx > 0.0f)) {
-			for (c = 0; c < COM_NUM_CHANNELS_COLOR; ++c)
-				IIR_gauss(copy, this->m_sx, c, 3);
+			IIR_gauss_color(copy, this->m_sx, 3, true);
 		}
 		else {
 			if (this->m_sx > 0.0f) {
-				for (c = 0; c < COM_NUM_CHANNELS_COLOR; ++c)
-					IIR_gauss(copy, this->m_sx, c, 1);
+				IIR_gauss_color(copy, this->m_sx, 1, true);
 			}
 			if (this->m_sy > 0.0f) {
-				for (c = 0; c < COM_NUM_CHANNELS_COLOR; ++c)
-					IIR_gauss(copy, this->m_sy, c, 2);
+				IIR_gauss_color(copy, this->m_sy, 2, true);
 			}
 		}
 		this->m_iirgaus = copy;
@@ -111,28 +111,13 @@ void *FastGaussianBlurOperation::initializeTileData(rcti *rect)
 	return this->m_iirgaus;
 }
 
-void FastGaussianBlurOperation::IIR_gauss(MemoryBuffer *src, float sigma, unsigned int chan, unsigned int xy)
+/**
+ * Young/van Vliet filter coefficients and the Triggs/Sdika border matrix for sigma >= 0.5
+ */
+static void IIR_gauss_coefficients(float sigma, double cf[4], double tsM[9])
 {
-	double q, q2, sc, cf[4], tsM[9], tsu[3], tsv[3];
-	double *X, *Y, *W;
-	const unsigned int src_width = src->getWidth();
-	const unsigned int src_height = src->getHeight();
-	unsigned int x, y, sz;
-	unsigned int i;
-	float *buffer = src->getBuffer();
-	const unsigned int num_channels = src->get_num_channels();
-	
-	// <0.5 not valid, though can have a possibly useful sort of sharpening effect
-	if (sigma < 0.5f) return;
-	
-	if ((xy < 1) || (xy > 3)) xy = 3;
-	
-	// XXX The YVV macro defined below explicitly expects sources of at least 3x3 pixels,
-	//     so just skiping blur along faulty direction if src's def is below that limit!
-	if (src_width < 3) xy &= ~1;
-	if (src_height < 3) xy &= ~2;
-	if (xy < 1) return;
-	
+	double q, q2, sc;
+
 	// see "Recursive Gabor Filtering" by Young/VanVliet
 	// all factors here in double.prec. Required, because for single.prec it seems to blow up if sigma > ~200
 	if (sigma >= 3.556f)
@@ -166,6 +151,31 @@ void FastGaussianBlurOperation::IIR_gauss(MemoryBuffer *src, float sigma, unsign
 	tsM[6] = sc * (cf[3] * cf[1] + cf[2] + cf[1] * cf[1] - cf[2] * cf[2]);
 	tsM[7] = sc * (cf[1] * cf[2] + cf[3] * cf[2] * cf[2] - cf[1] * cf[3] * cf[3] - cf[3] * cf[3] * cf[3] - cf[3] * cf[2] + cf[3]);
 	tsM[8] = sc * (cf[3] * (cf[1] + cf[3] * cf[2]));
+}
+
+void FastGaussianBlurOperation::IIR_gauss(MemoryBuffer *src, float sigma, unsigned int chan, unsigned int xy)
+{
+	double cf[4], tsM[9], tsu[3], tsv[3];
+	double *X, *Y, *W;
+	const unsigned int src_width = src->getWidth();
+	const unsigned int src_height = src->getHeight();
+	unsigned int x, y, sz;
+	unsigned int i;
+	float *buffer = src->getBuffer();
+	const unsigned int num_channels = src->get_num_channels();
+	
+	// <0.5 not valid, though can have a possibly useful sort of sharpening effect
+	if (sigma < 0.5f) return;
+	
+	if ((xy < 1) || (xy > 3)) xy = 3;
+	
+	// XXX The YVV macro defined below explicitly expects sources of at least 3x3 pixels,
+	//     so just skiping blur along faulty direction if src's def is below that limit!
+	if (src_width < 3) xy &= ~1;
+	if (src_height < 3) xy &= ~2;
+	if (xy < 1) return;
+	
+	IIR_gauss_coefficients(sigma, cf, tsM);
 	
 #define YVV(L)                                                                          \
 {                                                                                       \
@@ -239,6 +249,266 @@ void FastGaussianBlurOperation::IIR_gauss(MemoryBuffer *src, float sigma, unsign
 }
 
 
+/* ******** All color channels at once ******** */
+
+#define IIR_GAUSS_ROWS_PER_TASK 32
+#define IIR_GAUSS_COLUMNS_PER_TASK 8
+
+/* a color in double precision, see IIR_gauss for why doubles are needed */
+typedef struct IIRPixel {
+#ifdef __SSE2__
+	__m128d rg, ba;
+#else
+	double rgba[4];
+#endif
+} IIRPixel;
+
+static inline IIRPixel iir_pixel_load(const float color[4])
+{
+	IIRPixel r;
+#ifdef __SSE2__
+	__m128 c = _mm_loadu_ps(color);
+	r.rg = _mm_cvtps_pd(c);
+	r.ba = _mm_cvtps_pd(_mm_movehl_ps(c, c));
+#else
+	for (int i = 0; i < 4; i++) r.rgba[i] = color[i];
+#endif
+	return r;
+}
+
+static inline void iir_pixel_store(float color[4], const IIRPixel &p)
+{
+#ifdef __SSE2__
+	_mm_storeu_ps(color, _mm_movelh_ps(_mm_cvtpd_ps(p.rg), _mm_cvtpd_ps(p.ba)));
+#else
+	for (int i = 0; i < 4; i++) color[i] = (float)p.rgba[i];
+#endif
+}
+
+static inline IIRPixel iir_pixel_set(double value)
+{
+	IIRPixel r;
+#ifdef __SSE2__
+	r.rg = r.ba = _mm_set1_pd(value);
+#else
+	for (int i = 0; i < 4; i++) r.rgba[i] = value;
+#endif
+	return r;
+}
+
+static inline IIRPixel iir_pixel_sub(const IIRPixel &a, const IIRPixel &b)
+{
+	IIRPixel r;
+#ifdef __SSE2__
+	r.rg = _mm_sub_pd(a.rg, b.rg);
+	r.ba = _mm_sub_pd(a.ba, b.ba);
+#else
+	for (int i = 0; i < 4; i++) r.rgba[i] = a.rgba[i] - b.rgba[i];
+#endif
+	return r;
+}
+
+static inline IIRPixel iir_pixel_mul(const IIRPixel &a, double f)
+{
+	IIRPixel r;
+#ifdef __SSE2__
+	__m128d vf = _mm_set1_pd(f);
+	r.rg = _mm_mul_pd(a.rg, vf);
+	r.ba = _mm_mul_pd(a.ba, vf);
+#else
+	for (int i = 0; i < 4; i++) r.rgba[i] = a.rgba[i] * f;
+#endif
+	return r;
+}
+
+/* f0 * p0 + f1 * p1 + f2 * p2 + f3 * p3, added in the same order as the YVV macro */
+static inline IIRPixel iir_pixel_madd4(double f0, const IIRPixel &p0, double f1, const IIRPixel &p1,
+                                       double f2, const IIRPixel &p2, double f3, const IIRPixel &p3)
+{
+	IIRPixel r;
+#ifdef __SSE2__
+	__m128d v0 = _mm_set1_pd(f0), v1 = _mm_set1_pd(f1), v2 = _mm_set1_pd(f2), v3 = _mm_set1_pd(f3);
+	r.rg = _mm_add_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(v0, p0.rg), _mm_mul_pd(v1, p1.rg)),
+	                             _mm_mul_pd(v2, p2.rg)), _mm_mul_pd(v3, p3.rg));
+	r.ba = _mm_add_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(v0, p0.ba), _mm_mul_pd(v1, p1.ba)),
+	                             _mm_mul_pd(v2, p2.ba)), _mm_mul_pd(v3, p3.ba));
+#else
+	for (int i = 0; i < 4; i++) {
+		r.rgba[i] = f0 * p0.rgba[i] + f1 * p1.rgba[i] + f2 * p2.rgba[i] + f3 * p3.rgba[i];
+	}
+#endif
+	return r;
+}
+
+/**
+ * Young/van Vliet forward and backward pass over a line of at least 3 pixels, see YVV.
+ * The result replaces the input, W is scratch space of the same length.
+ * @param extend the line continues with its border pixels, otherwise with black
+ */
+static void iir_gauss_line(const double cf[4], const double tsM[9], IIRPixel *XY, IIRPixel *W,
+                           int L, bool extend)
+{
+	const IIRPixel xbegin = extend ? XY[0] : iir_pixel_set(0.0);
+	const IIRPixel xend = extend ? XY[L - 1] : iir_pixel_set(0.0);
+	IIRPixel tsu[3], tsv[3];
+	int i;
+
+	W[0] = iir_pixel_madd4(cf[0], XY[0], cf[1], xbegin, cf[2], xbegin, cf[3], xbegin);
+	W[1] = iir_pixel_madd4(cf[0], XY[1], cf[1], W[0], cf[2], xbegin, cf[3], xbegin);
+	W[2] = iir_pixel_madd4(cf[0], XY[2], cf[1], W[1], cf[2], W[0], cf[3], xbegin);
+	for (i = 3; i < L; i++) {
+		W[i] = iir_pixel_madd4(cf[0], XY[i], cf[1], W[i - 1], cf[2], W[i - 2], cf[3], W[i - 3]);
+	}
+	tsu[0] = iir_pixel_sub(W[L - 1], xend);
+	tsu[1] = iir_pixel_sub(W[L - 2], xend);
+	tsu[2] = iir_pixel_sub(W[L - 3], xend);
+	tsv[0] = iir_pixel_madd4(tsM[0], tsu[0], tsM[1], tsu[1], tsM[2], tsu[2], 1.0, xend);
+	tsv[1] = iir_pixel_madd4(tsM[3], tsu[0], tsM[4], tsu[1], tsM[5], tsu[2], 1.0, xend);
+	tsv[2] = iir_pixel_madd4(tsM[6], tsu[0], tsM[7], tsu[1], tsM[8], tsu[2], 1.0, xend);
+	XY[L - 1] = iir_pixel_madd4(cf[0], W[L - 1], cf[1], tsv[0], cf[2], tsv[1], cf[3], tsv[2]);
+	XY[L - 2] = iir_pixel_madd4(cf[0], W[L - 2], cf[1], XY[L - 1], cf[2], tsv[0], cf[3], tsv[1]);
+	XY[L - 3] = iir_pixel_madd4(cf[0], W[L - 3], cf[1], XY[L - 2], cf[2], XY[L - 1], cf[3], tsv[0]);
+	for (i = L - 4; i >= 0; i--) {
+		XY[i] = iir_pixel_madd4(cf[0], W[i], cf[1], XY[i + 1], cf[2], XY[i + 2], cf[3], XY[i + 3]);
+	}
+}
+
+/**
+ * Inverse of the response of a line of white pixels followed by black, so that the
+ * blur of a line without extended borders is normalized like a truncated Gaussian kernel.
+ */
+static double *iir_gauss_norm(const double cf[4], const double tsM[9], int L)
+{
+	IIRPixel *XY = (IIRPixel *)MEM_mallocN_aligned(sizeof(IIRPixel) * L, 16, "IIR_gauss_color norm XY");
+	IIRPixel *W = (IIRPixel *)MEM_mallocN_aligned(sizeof(IIRPixel) * L, 16, "IIR_gauss_color norm W");
+	double *norm = (double *)MEM_mallocN(sizeof(double) * L, "IIR_gauss_color norm");
+	float response[4];
+	int i;
+
+	for (i = 0; i < L; i++) {
+		XY[i] = iir_pixel_set(1.0);
+	}
+	iir_gauss_line(cf, tsM, XY, W, L, false);
+	for (i = 0; i < L; i++) {
+		iir_pixel_store(response, XY[i]);
+		norm[i] = 1.0 / max(response[0], 1e-6f);
+	}
+
+	MEM_freeN(XY);
+	MEM_freeN(W);
+	return norm;
+}
+
+typedef struct IIRGaussData {
+	float *buffer;
+	int width;
+	int height;
+	double cf[4];
+	double tsM[9];
+	/* NULL when the borders are extended */
+	const double *norm;
+} IIRGaussData;
+
+static void iir_gauss_rows_task(void *userdata, const int block)
+{
+	IIRGaussData *data = (IIRGaussData *)userdata;
+	const int width = data->width;
+	const int ystart = block * IIR_GAUSS_ROWS_PER_TASK;
+	const int yend = min(ystart + IIR_GAUSS_ROWS_PER_TASK, data->height);
+	IIRPixel *XY = (IIRPixel *)MEM_mallocN_aligned(sizeof(IIRPixel) * width, 16, "IIR_gauss_color XY");
+	IIRPixel *W = (IIRPixel *)MEM_mallocN_aligned(sizeof(IIRPixel) * width, 16, "IIR_gauss_color W");
+
+	for (int y = ystart; y < yend; y++) {
+		float *row = data->buffer + (size_t)y * width * COM_NUM_CHANNELS_COLOR;
+		int x;
+
+		for (x = 0; x < width; x++) {
+			XY[x] = iir_pixel_load(&row[x * COM_NUM_CHANNELS_COLOR]);
+		}
+		iir_gauss_line(data->cf, data->tsM, XY, W, width, data->norm == NULL);
+		for (x = 0; x < width; x++) {
+			iir_pixel_store(&row[x * COM_NUM_CHANNELS_COLOR], data->norm ? iir_pixel_mul(XY[x], data->norm[x]) : XY[x]);
+		}
+	}
+
+	MEM_freeN(XY);
+	MEM_freeN(W);
+}
+
+/* columns are blurred in blocks, so the buffer is walked a row at a time instead of a column at a time */
+static void iir_gauss_columns_task(void *userdata, const int block)
+{
+	IIRGaussData *data = (IIRGaussData *)userdata;
+	const int width = data->width;
+	const int height = data->height;
+	const int xstart = block * IIR_GAUSS_COLUMNS_PER_TASK;
+	const int num_columns = min(IIR_GAUSS_COLUMNS_PER_TASK, width - xstart);
+	IIRPixel *XY = (IIRPixel *)MEM_mallocN_aligned(sizeof(IIRPixel) * height * num_columns, 16, "IIR_gauss_color XY");
+	IIRPixel *W = (IIRPixel *)MEM_mallocN_aligned(sizeof(IIRPixel) * height, 16, "IIR_gauss_color W");
+	int x, y;
+
+	for (y = 0; y < height; y++) {
+		const float *pixel = data->buffer + ((size_t)y * width + xstart) * COM_NUM_CHANNELS_COLOR;
+		for (x = 0; x < num_columns; x++, pixel += COM_NUM_CHANNELS_COLOR) {
+			XY[x * height + y] = iir_pixel_load(pixel);
+		}
+	}
+	for (x = 0; x < num_columns; x++) {
+		iir_gauss_line(data->cf, data->tsM, &XY[x * height], W, height, data->norm == NULL);
+	}
+	for (y = 0; y < height; y++) {
+		float *pixel = data->buffer + ((size_t)y * width + xstart) * COM_NUM_CHANNELS_COLOR;
+		for (x = 0; x < num_columns; x++, pixel += COM_NUM_CHANNELS_COLOR) {
+			const IIRPixel &result = XY[x * height + y];
+			iir_pixel_store(pixel, data->norm ? iir_pixel_mul(result, data->norm[y]) : result);
+		}
+	}
+
+	MEM_freeN(XY);
+	MEM_freeN(W);
+}
+
+void FastGaussianBlurOperation::IIR_gauss_color(MemoryBuffer *src, float sigma, unsigned int xy, bool extend)
+{
+	IIRGaussData data;
+	bool use_threading;
+
+	BLI_assert(src->get_num_channels() == COM_NUM_CHANNELS_COLOR);
+
+	// <0.5 not valid, though can have a possibly useful sort of sharpening effect
+	if (sigma < 0.5f) return;
+
+	if ((xy < 1) || (xy > 3)) xy = 3;
+
+	data.buffer = src->getBuffer();
+	data.width = src->getWidth();
+	data.height = src->getHeight();
+
+	// see IIR_gauss, lines need at least 3 pixels
+	if (data.width < 3) xy &= ~1;
+	if (data.height < 3) xy &= ~2;
+	if (xy < 1) return;
+
+	IIR_gauss_coefficients(sigma, data.cf, data.tsM);
+	use_threading = (data.width * data.height) >= (64 * 64);
+
+	if (xy & 1) {   // H
+		double *norm = extend ? NULL : iir_gauss_norm(data.cf, data.tsM, data.width);
+		data.norm = norm;
+		BLI_task_parallel_range(0, (data.height + IIR_GAUSS_ROWS_PER_TASK - 1) / IIR_GAUSS_ROWS_PER_TASK,
+		                        &data, iir_gauss_rows_task, use_threading);
+		if (norm) MEM_freeN(norm);
+	}
+	if (xy & 2) {   // V
+		double *norm = extend ? NULL : iir_gauss_norm(data.cf, data.tsM, data.height);
+		data.norm = norm;
+		BLI_task_parallel_range(0, (data.width + IIR_GAUSS_COLUMNS_PER_TASK - 1) / IIR_GAUSS_COLUMNS_PER_TASK,
+		                        &data, iir_gauss_columns_task, use_threading);
+		if (norm) MEM_freeN(norm);
+	}
+}
+
+
 ///
 FastGaussianBlurValueOperation::FastGaussianBlurValueOperation() : NodeOperation()
 {
@@ -292,8 +562,8 @@ void *FastGaussianBlurValueOperation::initializeTileData(rcti *rect)
 {
 	lockMutex();
 	if (!this->m_iirgaus) {
-		MemoryBuffer *newBuf = (MemoryBuffer *)this->m_inputprogram->initializeTileData(rect);
-		MemoryBuffer *copy = newBuf->duplicate();
+		MemoryBuffer *copy = this->m_inputprogram->duplicateTileData(rect);
+		MemoryBuffer *newBuf = (this->m_overlay != FAST_GAUSS_OVERLAY_NONE) ? copy->duplicate() : NULL;
 		FastGaussianBlurOperation::IIR_gauss(copy, this->m_sigma, 0, 3);
 
 		if (this->m_overlay == FAST_GAUSS_OVERLAY_MIN) {
@@ -315,7 +585,9 @@ void *FastGaussianBlurValueOperation::initializeTileData(rcti *rect)
 			}
 		}
 
-//		newBuf->
+		if (newBuf) {
+			delete newBuf;
+		}
 
 		this->m_iirgaus = copy;
 	}
@@ -37,6 +37,13 @@ public:
 	void executePixel(float output[4], int x, int y, void *data);
 	
 	static void IIR_gauss(MemoryBuffer *src, float sigma, unsigned int channel, unsigned int xy);
+	/**
+	 * @brief blur all channels of a color buffer in place, rows and columns are blurred in parallel
+	 * @param xy 1 horizontal, 2 vertical, 3 both
+	 * @param extend repeat the border pixels outside the buffer, otherwise the result is normalized
+	 * by the part of the kernel inside the buffer, like the Gaussian kernels of the blur node
+	 */
+	static void IIR_gauss_color(MemoryBuffer *src, float sigma, unsigned int xy, bool extend);
 	void *initializeTileData(rcti *rect);
 	void deinitExecution();
 	void initExecution();
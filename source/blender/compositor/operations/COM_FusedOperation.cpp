@@ -0,0 +1,174 @@
+/*
+ * Copyright 2011, Blender Foundation.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor: 
+ *		Jeroen Bakker 
+ *		Monique Dewanchand
+ */
+
+#include "COM_FusedOperation.h"
+#include "COM_CompositorCache.h"
+#include "COM_WorkScheduler.h"
+
+#include <typeinfo>
+
+extern "C" {
+#include "BLI_utildefines.h"
+#include "MEM_guardedalloc.h"
+}
+
+FusedOperation::FusedOperation(DataType datatype) : NodeOperation()
+{
+	this->addOutputSocket(datatype);
+}
+
+FusedOperation::~FusedOperation()
+{
+	for (unsigned int index = 0; index < this->m_operations.size(); index++) {
+		delete this->m_operations[index];
+	}
+}
+
+void FusedOperation::addFusedInput(DataType datatype)
+{
+	/* resolutions are determined before fusing, inputs are read at the fused operation's coordinates */
+	this->addInputSocket(datatype, COM_SC_NO_RESIZE);
+}
+
+void FusedOperation::addFusedOperation(NodeOperation *operation, const std::vector<int> &inputRows)
+{
+	BLI_assert(operation->isPointwise());
+	BLI_assert(operation->getNumberOfInputSockets() == inputRows.size());
+	BLI_assert(inputRows.size() <= COM_FUSED_MAX_INPUTS);
+
+	this->m_operations.push_back(operation);
+	if (!operation->isCacheable()) {
+		this->setCacheable(false);
+	}
+	if (operation->isDepth()) {
+		this->setDepth(true);
+	}
+	this->m_inputRows.insert(this->m_inputRows.end(), inputRows.begin(), inputRows.end());
+	BLI_assert(this->getNumberOfInputSockets() + this->m_operations.size() <= COM_FUSED_MAX_ROWS);
+}
+
+void FusedOperation::initExecution()
+{
+	for (unsigned int index = 0; index < this->getNumberOfInputSockets(); index++) {
+		this->m_inputReaders.push_back(this->getInputSocketReader(index));
+	}
+	this->m_threadRows.assign(WorkScheduler::get_num_cpu_threads(), (float *)NULL);
+	for (unsigned int index = 0; index < this->m_operations.size(); index++) {
+		this->m_operations[index]->initExecution();
+	}
+}
+
+void FusedOperation::deinitExecution()
+{
+	for (unsigned int index = 0; index < this->m_operations.size(); index++) {
+		this->m_operations[index]->deinitExecution();
+	}
+	this->m_inputReaders.clear();
+	for (unsigned int index = 0; index < this->m_threadRows.size(); index++) {
+		if (this->m_threadRows[index]) {
+			MEM_freeN(this->m_threadRows[index]);
+		}
+	}
+	this->m_threadRows.clear();
+}
+
+void FusedOperation::executeKernels(float *output, float *rows, int rowStride, int num)
+{
+	const int totinputs = this->getNumberOfInputSockets();
+	const int totoperations = this->m_operations.size();
+	const int *inputRows = &this->m_inputRows[0];
+	float *inputs[COM_FUSED_MAX_INPUTS];
+
+	for (int index = 0; index < totoperations; index++) {
+		NodeOperation *operation = this->m_operations[index];
+		const int totoperationinputs = operation->getNumberOfInputSockets();
+		/* the last operation writes straight into the output */
+		float *result = (index == totoperations - 1) ? output : rows + (totinputs + index) * rowStride;
+
+		for (int i = 0; i < totoperationinputs; i++) {
+			inputs[i] = rows + inputRows[i] * rowStride;
+		}
+		inputRows += totoperationinputs;
+
+		operation->executeRowKernel(result, inputs, num);
+	}
+}
+
+void FusedOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+{
+	float rows[COM_FUSED_MAX_ROWS * 4];
+
+	for (unsigned int index = 0; index < this->m_inputReaders.size(); index++) {
+		this->m_inputReaders[index]->readSampled(&rows[index * 4], x, y, sampler);
+	}
+
+	executeKernels(output, rows, 4, 1);
+}
+
+void FusedOperation::executeRowSampled(float *output, int x, int y, int num, PixelSampler sampler)
+{
+	const int rowStride = COM_ROW_CHUNK_SIZE * 4;
+	const size_t rowsSize = sizeof(float) * rowStride * (this->getNumberOfInputSockets() + this->m_operations.size());
+	const int thread_id = WorkScheduler::current_thread_id();
+	const bool use_thread_rows = (thread_id >= 0 && thread_id < (int)this->m_threadRows.size());
+	float *rows;
+
+	BLI_assert(num <= COM_ROW_CHUNK_SIZE);
+
+	/* rows are too large for the stack of the worker threads,
+	 * threads that aren't cpu devices get their own temporary rows */
+	if (use_thread_rows) {
+		if (this->m_threadRows[thread_id] == NULL) {
+			this->m_threadRows[thread_id] = (float *)MEM_mallocN(rowsSize, "FusedOperation rows");
+		}
+		rows = this->m_threadRows[thread_id];
+	}
+	else {
+		rows = (float *)MEM_mallocN(rowsSize, "FusedOperation rows");
+	}
+
+	for (unsigned int index = 0; index < this->m_inputReaders.size(); index++) {
+		this->m_inputReaders[index]->readRowSampled(&rows[index * rowStride], x, y, num, sampler);
+	}
+
+	executeKernels(output, rows, rowStride, num);
+
+	if (!use_thread_rows) {
+		MEM_freeN(rows);
+	}
+}
+
+uint64_t FusedOperation::getDataHash()
+{
+	CompositorCache::Key hash = this->m_operations.size();
+	if (!this->m_inputRows.empty()) {
+		hash = CompositorCache::hash_combine(
+		        hash, CompositorCache::hash_data(&this->m_inputRows[0], this->m_inputRows.size() * sizeof(int)));
+	}
+	for (unsigned int index = 0; index < this->m_operations.size(); index++) {
+		NodeOperation *operation = this->m_operations[index];
+		hash = CompositorCache::hash_combine(hash, operation->getNodeHash());
+		hash = CompositorCache::hash_combine(hash, CompositorCache::hash_string(typeid(*operation).name()));
+		hash = CompositorCache::hash_combine(hash, operation->getDataHash());
+	}
+	return hash;
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2011, Blender Foundation.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor: 
+ *		Jeroen Bakker 
+ *		Monique Dewanchand
+ */
+
+#ifndef _COM_FusedOperation_h
+#define _COM_FusedOperation_h
+
+#include <vector>
+
+#include "COM_NodeOperation.h"
+
+/**
+ * @brief evaluates a chain of pointwise operations in a single loop
+ *
+ * The fused operations are evaluated one row at a time with executeRowKernel, in topological order.
+ * Intermediate results are kept in rows instead of being pulled pixel by pixel
+ * through the operations, so an operation used by several others in the chain is evaluated once.
+ * The input sockets of the FusedOperation are the inputs coming from outside the chain,
+ * the last fused operation provides the output.
+ *
+ * @see NodeOperationBuilder.fuse_pointwise_operations
+ */
+class FusedOperation : public NodeOperation {
+private:
+	/**
+	 * @brief fused operations in evaluation order, owned by this operation
+	 */
+	std::vector<NodeOperation *> m_operations;
+
+	/**
+	 * @brief for every input socket of every fused operation the row it reads from
+	 * rows [0, number of input sockets) hold the external inputs, followed by one row per fused operation
+	 */
+	std::vector<int> m_inputRows;
+
+	std::vector<SocketReader *> m_inputReaders;
+
+	/**
+	 * @brief scratch rows of every cpu thread, allocated on first use by that thread
+	 */
+	std::vector<float *> m_threadRows;
+
+	void executeKernels(float *output, float *rows, int rowStride, int num);
+public:
+	FusedOperation(DataType datatype);
+	~FusedOperation();
+
+	/**
+	 * @brief add an input socket for a value coming from outside the chain
+	 */
+	void addFusedInput(DataType datatype);
+
+	/**
+	 * @brief append an operation to the chain, the last one added provides the output
+	 * @param inputRows row index for every input socket of the operation
+	 * @note ownership of the operation is transferred to the FusedOperation
+	 */
+	void addFusedOperation(NodeOperation *operation, const std::vector<int> &inputRows);
+
+	unsigned int getNumberOfFusedOperations() const { return this->m_operations.size(); }
+	NodeOperation *getFusedOperation(unsigned int index) const { return this->m_operations[index]; }
+	NodeOperation *getFusedOutputOperation() const { return this->m_operations.back(); }
+
+	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void executeRowSampled(float *output, int x, int y, int num, PixelSampler sampler);
+
+	void initExecution();
+	void deinitExecution();
+
+	bool isFusedOperation() const { return true; }
+
+	/**
+	 * @brief the fused operations and their wiring are not visible in the graph, hash them here
+	 */
+	uint64_t getDataHash();
+};
+
+#endif
@@ -28,6 +28,7 @@ GammaOperation::GammaOperation() : NodeOperation()
 	this->addInputSocket(COM_DT_COLOR);
 	this->addInputSocket(COM_DT_VALUE);
 	this->addOutputSocket(COM_DT_COLOR);
+	this->setPointwise(true);
 	this->m_inputProgram = NULL;
 	this->m_inputGammaProgram = NULL;
 }
@@ -41,16 +42,40 @@ void GammaOperation::executePixelSampled(float output[4], float x, float y, Pixe
 {
 	float inputValue[4];
 	float inputGamma[4];
-	
+
 	this->m_inputProgram->readSampled(inputValue, x, y, sampler);
 	this->m_inputGammaProgram->readSampled(inputGamma, x, y, sampler);
-	const float gamma = inputGamma[0];
-	/* check for negative to avoid nan's */
-	output[0] = inputValue[0] > 0.0f ? powf(inputValue[0], gamma) : inputValue[0];
-	output[1] = inputValue[1] > 0.0f ? powf(inputValue[1], gamma) : inputValue[1];
-	output[2] = inputValue[2] > 0.0f ? powf(inputValue[2], gamma) : inputValue[2];
-	
-	output[3] = inputValue[3];
+
+	processRow(output, inputValue, inputGamma, 1);
+}
+
+void GammaOperation::executeRowSampled(float *output, int x, int y, int num, PixelSampler sampler)
+{
+	float inputValue[COM_ROW_CHUNK_SIZE * 4];
+	float inputGamma[COM_ROW_CHUNK_SIZE * 4];
+
+	this->m_inputProgram->readRowSampled(inputValue, x, y, num, sampler);
+	this->m_inputGammaProgram->readRowSampled(inputGamma, x, y, num, sampler);
+
+	processRow(output, inputValue, inputGamma, num);
+}
+
+void GammaOperation::executeRowKernel(float *output, float **inputs, int num)
+{
+	processRow(output, inputs[0], inputs[1], num);
+}
+
+void GammaOperation::processRow(float *output, float *inputValue, float *inputGamma, int num)
+{
+	for (int i = 0; i < num; i++, output += 4, inputValue += 4, inputGamma += 4) {
+		const float gamma = inputGamma[0];
+		/* check for negative to avoid nan's */
+		output[0] = inputValue[0] > 0.0f ? powf(inputValue[0], gamma) : inputValue[0];
+		output[1] = inputValue[1] > 0.0f ? powf(inputValue[1], gamma) : inputValue[1];
+		output[2] = inputValue[2] > 0.0f ? powf(inputValue[2], gamma) : inputValue[2];
+
+		output[3] = inputValue[3];
+	}
 }
 
 void GammaOperation::deinitExecution()
@@ -21,6 +21,7 @@
  */
 
 #include "COM_GaussianBokehBlurOperation.h"
+#include "COM_FastGaussianBlurOperation.h"
 #include "BLI_math.h"
 #include "MEM_guardedalloc.h"
 extern "C" {
@@ -30,6 +31,8 @@ extern "C" {
 GaussianBokehBlurOperation::GaussianBokehBlurOperation() : BlurBaseOperation(COM_DT_COLOR)
 {
 	this->m_gausstab = NULL;
+	this->m_radxf = this->m_radyf = 0.0f;
+	this->m_iirgaus = NULL;
 }
 
 void *GaussianBokehBlurOperation::initializeTileData(rcti * /*rect*/)
@@ -38,7 +41,24 @@ void *GaussianBokehBlurOperation::initializeTileData(rcti * /*rect*/)
 	if (!this->m_sizeavailable) {
 		updateGauss();
 	}
-	void *buffer = getInputOperation(0)->initializeTileData(NULL);
+	void *buffer;
+	if (useIIRGauss(max_ff(this->m_radxf, this->m_radyf))) {
+		if (!this->m_iirgaus) {
+			MemoryBuffer *copy = getInputOperation(0)->duplicateTileData(NULL);
+			/* the round Gaussian filter is separable, RE_filter_value reaches three times sigma at the radius */
+			if (this->m_radxf > 0.0f) {
+				FastGaussianBlurOperation::IIR_gauss_color(copy, this->m_radxf / 3.0f, 1, false);
+			}
+			if (this->m_radyf > 0.0f) {
+				FastGaussianBlurOperation::IIR_gauss_color(copy, this->m_radyf / 3.0f, 2, false);
+			}
+			this->m_iirgaus = copy;
+		}
+		buffer = this->m_iirgaus;
+	}
+	else {
+		buffer = getInputOperation(0)->initializeTileData(NULL);
+	}
 	unlockMutex();
 	return buffer;
 }
@@ -77,6 +97,13 @@ void GaussianBokehBlurOperation::updateGauss()
 	
 		this->m_radx = ceil(radxf);
 		this->m_rady = ceil(radyf);
+		this->m_radxf = radxf;
+		this->m_radyf = radyf;
+
+		/* the recursive filter doesn't need the kernel */
+		if (useIIRGauss(max_ff(radxf, radyf))) {
+			return;
+		}
 		
 		int ddwidth = 2 * this->m_radx + 1;
 		int ddheight = 2 * this->m_rady + 1;
@@ -116,6 +143,11 @@ void GaussianBokehBlurOperation::updateGauss()
 
 void GaussianBokehBlurOperation::executePixel(float output[4], int x, int y, void *data)
 {
+	if (this->m_iirgaus) {
+		this->m_iirgaus->read(output, x, y);
+		return;
+	}
+
 	float tempColor[4];
 	tempColor[0] = 0;
 	tempColor[1] = 0;
@@ -162,6 +194,10 @@ void GaussianBokehBlurOperation::deinitExecution()
 		MEM_freeN(this->m_gausstab);
 		this->m_gausstab = NULL;
 	}
+	if (this->m_iirgaus) {
+		delete this->m_iirgaus;
+		this->m_iirgaus = NULL;
+	}
 
 	deinitMutex();
 }
@@ -180,7 +216,8 @@ bool GaussianBokehBlurOperation::determineDependingAreaOfInterest(rcti *input, R
 		return true;
 	}
 	else {
-		if (this->m_sizeavailable && this->m_gausstab != NULL) {
+		/* the recursive filter reads the whole input, see updateGauss */
+		if ((this->m_sizeavailable && this->m_gausstab != NULL) || this->m_data.filtertype == R_FILTER_GAUSS) {
 			newInput.xmin = 0;
 			newInput.ymin = 0;
 			newInput.xmax = this->getWidth();
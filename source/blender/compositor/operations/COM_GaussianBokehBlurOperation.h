@@ -30,6 +30,9 @@ class GaussianBokehBlurOperation : public BlurBaseOperation {
 private:
 	float *m_gausstab;
 	int m_radx, m_rady;
+	float m_radxf, m_radyf;
+	/* blurred input when the recursive filter is used, see BlurBaseOperation.useIIRGauss */
+	MemoryBuffer *m_iirgaus;
 	void updateGauss();
 
 public:
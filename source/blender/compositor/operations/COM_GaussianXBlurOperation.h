@@ -32,6 +32,8 @@ private:
 	__m128 *m_gausstab_sse;
 #endif
 	int m_filtersize;
+	/* blurred input when the recursive filter is used, see BlurBaseOperation.useIIRGauss */
+	MemoryBuffer *m_iirgaus;
 	void updateGauss();
 public:
 	GaussianXBlurOperation();
@@ -60,7 +62,8 @@ public:
 	bool determineDependingAreaOfInterest(rcti *input, ReadBufferOperation *readOperation, rcti *output);
 
 	void checkOpenCL() {
-		this->setOpenCL(m_data.sizex >= 128);
+		/* large Gaussian filters are faster as recursive filter on the CPU */
+		this->setOpenCL(m_data.sizex >= 128 && !useIIRGauss(m_data.sizex));
 	}
 };
 #endif
@@ -21,6 +21,7 @@
  */
 
 #include "COM_GaussianYBlurOperation.h"
+#include "COM_FastGaussianBlurOperation.h"
 #include "COM_OpenCLDevice.h"
 #include "BLI_math.h"
 #include "MEM_guardedalloc.h"
@@ -36,6 +37,7 @@ GaussianYBlurOperation::GaussianYBlurOperation() : BlurBaseOperation(COM_DT_COLO
 	this->m_gausstab_sse = NULL;
 #endif
 	this->m_filtersize = 0;
+	this->m_iirgaus = NULL;
 }
 
 void *GaussianYBlurOperation::initializeTileData(rcti * /*rect*/)
@@ -44,7 +46,20 @@ void *GaussianYBlurOperation::initializeTileData(rcti * /*rect*/)
 	if (!this->m_sizeavailable) {
 		updateGauss();
 	}
-	void *buffer = getInputOperation(0)->initializeTileData(NULL);
+	void *buffer;
+	if (useIIRGauss(this->m_filtersize)) {
+		if (!this->m_iirgaus) {
+			float rad = max_ff(m_size * m_data.sizey, 0.0f);
+			MemoryBuffer *copy = getInputOperation(0)->duplicateTileData(NULL);
+			/* RE_filter_value reaches three times sigma at the radius */
+			FastGaussianBlurOperation::IIR_gauss_color(copy, rad / 3.0f, 2, false);
+			this->m_iirgaus = copy;
+		}
+		buffer = this->m_iirgaus;
+	}
+	else {
+		buffer = getInputOperation(0)->initializeTileData(NULL);
+	}
 	unlockMutex();
 	return buffer;
 }
@@ -84,6 +99,11 @@ void GaussianYBlurOperation::updateGauss()
 
 void GaussianYBlurOperation::executePixel(float output[4], int x, int y, void *data)
 {
+	if (this->m_iirgaus) {
+		this->m_iirgaus->read(output, x, y);
+		return;
+	}
+
 	float color_accum[4] = {0.0f, 0.0f, 0.0f, 0.0f};
 	float multiplier_accum = 0.0f;
 	MemoryBuffer *inputBuffer = (MemoryBuffer *)data;
@@ -165,6 +185,10 @@ void GaussianYBlurOperation::deinitExecution()
 		this->m_gausstab_sse = NULL;
 	}
 #endif
+	if (this->m_iirgaus) {
+		delete this->m_iirgaus;
+		this->m_iirgaus = NULL;
+	}
 
 	deinitMutex();
 }
@@ -185,7 +209,7 @@ bool GaussianYBlurOperation::determineDependingAreaOfInterest(rcti *input, ReadB
 		}
 	}
 	{
-		if (this->m_sizeavailable && this->m_gausstab != NULL) {
+		if (this->m_sizeavailable && this->m_gausstab != NULL && !useIIRGauss(this->m_filtersize)) {
 			newInput.xmax = input->xmax;
 			newInput.xmin = input->xmin;
 			newInput.ymax = input->ymax + this->m_filtersize + 1;
@@ -21,6 +21,7 @@
  */
 
 #include "COM_GlareBaseOperation.h"
+#include "COM_ReadBufferOperation.h"
 #include "BLI_math.h"
 
 GlareBaseOperation::GlareBaseOperation() : SingleThreadedOperation()
@@ -43,7 +44,10 @@ void GlareBaseOperation::deinitExecution()
 
 MemoryBuffer *GlareBaseOperation::createMemoryBuffer(rcti *rect2)
 {
-	MemoryBuffer *tile = (MemoryBuffer *)this->m_inputProgram->initializeTileData(rect2);
+	NodeOperation *input = getInputOperation(0);
+	/* a streamed input is copied from its tiles instead of building its full buffer */
+	const bool copy = input->isReadBufferOperation() && ((ReadBufferOperation *)input)->getMemoryProxy()->isStreaming();
+	MemoryBuffer *tile = copy ? input->duplicateTileData(rect2) : (MemoryBuffer *)input->initializeTileData(rect2);
 	rcti rect;
 	rect.xmin = 0;
 	rect.ymin = 0;
@@ -52,6 +56,9 @@ MemoryBuffer *GlareBaseOperation::createMemoryBuffer(rcti *rect2)
 	MemoryBuffer *result = new MemoryBuffer(COM_DT_COLOR, &rect);
 	float *data = result->getBuffer();
 	this->generateGlare(data, tile, this->m_settings);
+	if (copy) {
+		delete tile;
+	}
 	return result;
 }
 
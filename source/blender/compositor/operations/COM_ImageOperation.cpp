@@ -21,6 +21,7 @@
  */
 
 #include "COM_ImageOperation.h"
+#include "COM_CompositorCache.h"
 
 #include "BLI_listbase.h"
 #include "DNA_image_types.h"
@@ -63,6 +64,7 @@ ImageAlphaOperation::ImageAlphaOperation() : BaseImageOperation()
 ImageDepthOperation::ImageDepthOperation() : BaseImageOperation()
 {
 	this->addOutputSocket(COM_DT_VALUE);
+	this->setDepth(true);
 }
 
 ImBuf *BaseImageOperation::getImBuf()
@@ -107,6 +109,20 @@ void BaseImageOperation::deinitExecution()
 	BKE_image_release_ibuf(this->m_image, this->m_buffer, NULL);
 }
 
+uint64_t BaseImageOperation::getDataHash()
+{
+	ImBuf *ibuf = this->m_buffer;
+	if (ibuf == NULL) {
+		return 0;
+	}
+
+	/* the stamp is renewed for every new buffer and when its pixels are changed */
+	CompositorCache::Key hash = CompositorCache::hash_combine(ibuf->changestamp, ibuf->channels);
+	hash = CompositorCache::hash_combine(hash, (CompositorCache::Key)(intptr_t)ibuf->rect_colorspace);
+	hash = CompositorCache::hash_combine(hash, (CompositorCache::Key)(intptr_t)ibuf->float_colorspace);
+	return hash;
+}
+
 void BaseImageOperation::determineResolution(unsigned int resolution[2], unsigned int /*preferredResolution*/[2])
 {
 	ImBuf *stackbuf = getImBuf();
@@ -30,6 +30,7 @@ MathBaseOperation::MathBaseOperation() : NodeOperation()
 	this->addInputSocket(COM_DT_VALUE);
 	this->addInputSocket(COM_DT_VALUE);
 	this->addOutputSocket(COM_DT_VALUE);
+	this->setPointwise(true);
 	this->m_inputValue1Operation = NULL;
 	this->m_inputValue2Operation = NULL;
 	this->m_useClamp = false;
@@ -65,6 +66,33 @@ void MathBaseOperation::determineResolution(unsigned int resolution[2], unsigned
 	NodeOperation::determineResolution(resolution, preferredResolution);
 }
 
+void MathBaseOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+{
+	float inputValue1[4];
+	float inputValue2[4];
+
+	this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
+	this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
+
+	mathRow(output, inputValue1, inputValue2, 1);
+}
+
+void MathBaseOperation::executeRowSampled(float *output, int x, int y, int num, PixelSampler sampler)
+{
+	float inputValue1[COM_ROW_CHUNK_SIZE * 4];
+	float inputValue2[COM_ROW_CHUNK_SIZE * 4];
+
+	this->m_inputValue1Operation->readRowSampled(inputValue1, x, y, num, sampler);
+	this->m_inputValue2Operation->readRowSampled(inputValue2, x, y, num, sampler);
+
+	mathRow(output, inputValue1, inputValue2, num);
+}
+
+void MathBaseOperation::executeRowKernel(float *output, float **inputs, int num)
+{
+	mathRow(output, inputs[0], inputs[1], num);
+}
+
 void MathBaseOperation::clampIfNeeded(float *color)
 {
 	if (this->m_useClamp) {
@@ -72,274 +100,200 @@ void MathBaseOperation::clampIfNeeded(float *color)
 	}
 }
 
-void MathAddOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void MathAddOperation::mathRow(float *output, float *inputValue1, float *inputValue2, int num)
 {
-	float inputValue1[4];
-	float inputValue2[4];
-	
-	this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-	this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
-	
-	output[0] = inputValue1[0] + inputValue2[0];
+	for (int i = 0; i < num; i++, output += 4, inputValue1 += 4, inputValue2 += 4) {
+		output[0] = inputValue1[0] + inputValue2[0];
 
-	clampIfNeeded(output);
+		clampIfNeeded(output);
+	}
 }
 
-void MathSubtractOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void MathSubtractOperation::mathRow(float *output, float *inputValue1, float *inputValue2, int num)
 {
-	float inputValue1[4];
-	float inputValue2[4];
-	
-	this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-	this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
-	
-	output[0] = inputValue1[0] - inputValue2[0];
+	for (int i = 0; i < num; i++, output += 4, inputValue1 += 4, inputValue2 += 4) {
+		output[0] = inputValue1[0] - inputValue2[0];
 
-	clampIfNeeded(output);
+		clampIfNeeded(output);
+	}
 }
 
-void MathMultiplyOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void MathMultiplyOperation::mathRow(float *output, float *inputValue1, float *inputValue2, int num)
 {
-	float inputValue1[4];
-	float inputValue2[4];
-	
-	this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-	this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
-	
-	output[0] = inputValue1[0] * inputValue2[0];
+	for (int i = 0; i < num; i++, output += 4, inputValue1 += 4, inputValue2 += 4) {
+		output[0] = inputValue1[0] * inputValue2[0];
 
-	clampIfNeeded(output);
+		clampIfNeeded(output);
+	}
 }
 
-void MathDivideOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void MathDivideOperation::mathRow(float *output, float *inputValue1, float *inputValue2, int num)
 {
-	float inputValue1[4];
-	float inputValue2[4];
-	
-	this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-	this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
-	
-	if (inputValue2[0] == 0) /* We don't want to divide by zero. */
-		output[0] = 0.0;
-	else
-		output[0] = inputValue1[0] / inputValue2[0];
+	for (int i = 0; i < num; i++, output += 4, inputValue1 += 4, inputValue2 += 4) {
+		if (inputValue2[0] == 0) /* We don't want to divide by zero. */
+			output[0] = 0.0;
+		else
+			output[0] = inputValue1[0] / inputValue2[0];
 
-	clampIfNeeded(output);
+		clampIfNeeded(output);
+	}
 }
 
-void MathSineOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void MathSineOperation::mathRow(float *output, float *inputValue1, float *inputValue2, int num)
 {
-	float inputValue1[4];
-	float inputValue2[4];
-	
-	this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-	this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
-	
-	output[0] = sin(inputValue1[0]);
+	for (int i = 0; i < num; i++, output += 4, inputValue1 += 4, inputValue2 += 4) {
+		output[0] = sin(inputValue1[0]);
 
-	clampIfNeeded(output);
+		clampIfNeeded(output);
+	}
 }
 
-void MathCosineOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void MathCosineOperation::mathRow(float *output, float *inputValue1, float *inputValue2, int num)
 {
-	float inputValue1[4];
-	float inputValue2[4];
-	
-	this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-	this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
-	
-	output[0] = cos(inputValue1[0]);
+	for (int i = 0; i < num; i++, output += 4, inputValue1 += 4, inputValue2 += 4) {
+		output[0] = cos(inputValue1[0]);
 
-	clampIfNeeded(output);
+		clampIfNeeded(output);
+	}
 }
 
-void MathTangentOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void MathTangentOperation::mathRow(float *output, float *inputValue1, float *inputValue2, int num)
 {
-	float inputValue1[4];
-	float inputValue2[4];
-	
-	this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-	this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
-	
-	output[0] = tan(inputValue1[0]);
+	for (int i = 0; i < num; i++, output += 4, inputValue1 += 4, inputValue2 += 4) {
+		output[0] = tan(inputValue1[0]);
 
-	clampIfNeeded(output);
+		clampIfNeeded(output);
+	}
 }
 
-void MathArcSineOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void MathArcSineOperation::mathRow(float *output, float *inputValue1, float *inputValue2, int num)
 {
-	float inputValue1[4];
-	float inputValue2[4];
-	
-	this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-	this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
-	
-	if (inputValue1[0] <= 1 && inputValue1[0] >= -1)
-		output[0] = asin(inputValue1[0]);
-	else
-		output[0] = 0.0;
+	for (int i = 0; i < num; i++, output += 4, inputValue1 += 4, inputValue2 += 4) {
+		if (inputValue1[0] <= 1 && inputValue1[0] >= -1)
+			output[0] = asin(inputValue1[0]);
+		else
+			output[0] = 0.0;
 
-	clampIfNeeded(output);
+		clampIfNeeded(output);
+	}
 }
 
-void MathArcCosineOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void MathArcCosineOperation::mathRow(float *output, float *inputValue1, float *inputValue2, int num)
 {
-	float inputValue1[4];
-	float inputValue2[4];
-	
-	this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-	this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
-	
-	if (inputValue1[0] <= 1 && inputValue1[0] >= -1)
-		output[0] = acos(inputValue1[0]);
-	else
-		output[0] = 0.0;
+	for (int i = 0; i < num; i++, output += 4, inputValue1 += 4, inputValue2 += 4) {
+		if (inputValue1[0] <= 1 && inputValue1[0] >= -1)
+			output[0] = acos(inputValue1[0]);
+		else
+			output[0] = 0.0;
 
-	clampIfNeeded(output);
+		clampIfNeeded(output);
+	}
 }
 
-void MathArcTangentOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void MathArcTangentOperation::mathRow(float *output, float *inputValue1, float *inputValue2, int num)
 {
-	float inputValue1[4];
-	float inputValue2[4];
-	
-	this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-	this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
-	
-	output[0] = atan(inputValue1[0]);
+	for (int i = 0; i < num; i++, output += 4, inputValue1 += 4, inputValue2 += 4) {
+		output[0] = atan(inputValue1[0]);
 
-	clampIfNeeded(output);
+		clampIfNeeded(output);
+	}
 }
 
-void MathPowerOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void MathPowerOperation::mathRow(float *output, float *inputValue1, float *inputValue2, int num)
 {
-	float inputValue1[4];
-	float inputValue2[4];
-	
-	this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-	this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
-	
-	if (inputValue1[0] >= 0) {
-		output[0] = pow(inputValue1[0], inputValue2[0]);
-	}
-	else {
-		float y_mod_1 = fmod(inputValue2[0], 1);
-		/* if input value is not nearly an integer, fall back to zero, nicer than straight rounding */
-		if (y_mod_1 > 0.999f || y_mod_1 < 0.001f) {
-			output[0] = pow(inputValue1[0], floorf(inputValue2[0] + 0.5f));
+	for (int i = 0; i < num; i++, output += 4, inputValue1 += 4, inputValue2 += 4) {
+		if (inputValue1[0] >= 0) {
+			output[0] = pow(inputValue1[0], inputValue2[0]);
 		}
 		else {
-			output[0] = 0.0;
+			float y_mod_1 = fmod(inputValue2[0], 1);
+			/* if input value is not nearly an integer, fall back to zero, nicer than straight rounding */
+			if (y_mod_1 > 0.999f || y_mod_1 < 0.001f) {
+				output[0] = pow(inputValue1[0], floorf(inputValue2[0] + 0.5f));
+			}
+			else {
+				output[0] = 0.0;
+			}
 		}
-	}
 
-	clampIfNeeded(output);
+		clampIfNeeded(output);
+	}
 }
 
-void MathLogarithmOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void MathLogarithmOperation::mathRow(float *output, float *inputValue1, float *inputValue2, int num)
 {
-	float inputValue1[4];
-	float inputValue2[4];
-	
-	this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-	this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
-	
-	if (inputValue1[0] > 0  && inputValue2[0] > 0)
-		output[0] = log(inputValue1[0]) / log(inputValue2[0]);
-	else
-		output[0] = 0.0;
+	for (int i = 0; i < num; i++, output += 4, inputValue1 += 4, inputValue2 += 4) {
+		if (inputValue1[0] > 0  && inputValue2[0] > 0)
+			output[0] = log(inputValue1[0]) / log(inputValue2[0]);
+		else
+			output[0] = 0.0;
 
-	clampIfNeeded(output);
+		clampIfNeeded(output);
+	}
 }
 
-void MathMinimumOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void MathMinimumOperation::mathRow(float *output, float *inputValue1, float *inputValue2, int num)
 {
-	float inputValue1[4];
-	float inputValue2[4];
-	
-	this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-	this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
-	
-	output[0] = min(inputValue1[0], inputValue2[0]);
+	for (int i = 0; i < num; i++, output += 4, inputValue1 += 4, inputValue2 += 4) {
+		output[0] = min(inputValue1[0], inputValue2[0]);
 
-	clampIfNeeded(output);
+		clampIfNeeded(output);
+	}
 }
 
-void MathMaximumOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void MathMaximumOperation::mathRow(float *output, float *inputValue1, float *inputValue2, int num)
 {
-	float inputValue1[4];
-	float inputValue2[4];
-	
-	this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-	this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
-	
-	output[0] = max(inputValue1[0], inputValue2[0]);
+	for (int i = 0; i < num; i++, output += 4, inputValue1 += 4, inputValue2 += 4) {
+		output[0] = max(inputValue1[0], inputValue2[0]);
 
-	clampIfNeeded(output);
+		clampIfNeeded(output);
+	}
 }
 
-void MathRoundOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void MathRoundOperation::mathRow(float *output, float *inputValue1, float *inputValue2, int num)
 {
-	float inputValue1[4];
-	float inputValue2[4];
-	
-	this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-	this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
-	
-	output[0] = round(inputValue1[0]);
+	for (int i = 0; i < num; i++, output += 4, inputValue1 += 4, inputValue2 += 4) {
+		output[0] = round(inputValue1[0]);
 
-	clampIfNeeded(output);
+		clampIfNeeded(output);
+	}
 }
 
-void MathLessThanOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void MathLessThanOperation::mathRow(float *output, float *inputValue1, float *inputValue2, int num)
 {
-	float inputValue1[4];
-	float inputValue2[4];
-	
-	this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-	this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
-	
-	output[0] = inputValue1[0] < inputValue2[0] ? 1.0f : 0.0f;
+	for (int i = 0; i < num; i++, output += 4, inputValue1 += 4, inputValue2 += 4) {
+		output[0] = inputValue1[0] < inputValue2[0] ? 1.0f : 0.0f;
 
-	clampIfNeeded(output);
+		clampIfNeeded(output);
+	}
 }
 
-void MathGreaterThanOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void MathGreaterThanOperation::mathRow(float *output, float *inputValue1, float *inputValue2, int num)
 {
-	float inputValue1[4];
-	float inputValue2[4];
-	
-	this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-	this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
-	
-	output[0] = inputValue1[0] > inputValue2[0] ? 1.0f : 0.0f;
+	for (int i = 0; i < num; i++, output += 4, inputValue1 += 4, inputValue2 += 4) {
+		output[0] = inputValue1[0] > inputValue2[0] ? 1.0f : 0.0f;
 
-	clampIfNeeded(output);
+		clampIfNeeded(output);
+	}
 }
 
-void MathModuloOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void MathModuloOperation::mathRow(float *output, float *inputValue1, float *inputValue2, int num)
 {
-	float inputValue1[4];
-	float inputValue2[4];
-	
-	this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-	this->m_inputValue2Operation->readSampled(inputValue2, x, y, sampler);
-	
-	if (inputValue2[0] == 0)
-		output[0] = 0.0;
-	else
-		output[0] = fmod(inputValue1[0], inputValue2[0]);
+	for (int i = 0; i < num; i++, output += 4, inputValue1 += 4, inputValue2 += 4) {
+		if (inputValue2[0] == 0)
+			output[0] = 0.0;
+		else
+			output[0] = fmod(inputValue1[0], inputValue2[0]);
 
-	clampIfNeeded(output);
+		clampIfNeeded(output);
+	}
 }
 
-void MathAbsoluteOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void MathAbsoluteOperation::mathRow(float *output, float *inputValue1, float *inputValue2, int num)
 {
-	float inputValue1[4];
+	for (int i = 0; i < num; i++, output += 4, inputValue1 += 4, inputValue2 += 4) {
+		output[0] = fabs(inputValue1[0]);
 
-	this->m_inputValue1Operation->readSampled(inputValue1, x, y, sampler);
-
-	output[0] = fabs(inputValue1[0]);
-
-	clampIfNeeded(output);
+		clampIfNeeded(output);
+	}
 }
@@ -26,6 +26,81 @@ extern "C" {
 #  include "BLI_math.h"
 }
 
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+
+/* Kernels shared by the most used mix types, alpha is taken from the first color.
+ * Evaluated in the same order as the scalar code so both give the same results. */
+
+/* output = (1 - value) * color1 + value * color2 */
+BLI_INLINE void mix_blend_rgb(float output[4], const float color1[4], const float color2[4], float value)
+{
+#ifdef __SSE2__
+	const float alpha = color1[3];
+	__m128 r = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(1.0f - value), _mm_loadu_ps(color1)),
+	                      _mm_mul_ps(_mm_set1_ps(value), _mm_loadu_ps(color2)));
+	_mm_storeu_ps(output, r);
+	output[3] = alpha;
+#else
+	const float valuem = 1.0f - value;
+	output[0] = valuem * color1[0] + value * color2[0];
+	output[1] = valuem * color1[1] + value * color2[1];
+	output[2] = valuem * color1[2] + value * color2[2];
+	output[3] = color1[3];
+#endif
+}
+
+/* output = color1 + value * color2 */
+BLI_INLINE void mix_add_rgb(float output[4], const float color1[4], const float color2[4], float value)
+{
+#ifdef __SSE2__
+	const float alpha = color1[3];
+	__m128 r = _mm_add_ps(_mm_loadu_ps(color1), _mm_mul_ps(_mm_set1_ps(value), _mm_loadu_ps(color2)));
+	_mm_storeu_ps(output, r);
+	output[3] = alpha;
+#else
+	output[0] = color1[0] + value * color2[0];
+	output[1] = color1[1] + value * color2[1];
+	output[2] = color1[2] + value * color2[2];
+	output[3] = color1[3];
+#endif
+}
+
+/* output = color1 - value * color2 */
+BLI_INLINE void mix_subtract_rgb(float output[4], const float color1[4], const float color2[4], float value)
+{
+#ifdef __SSE2__
+	const float alpha = color1[3];
+	__m128 r = _mm_sub_ps(_mm_loadu_ps(color1), _mm_mul_ps(_mm_set1_ps(value), _mm_loadu_ps(color2)));
+	_mm_storeu_ps(output, r);
+	output[3] = alpha;
+#else
+	output[0] = color1[0] - value * color2[0];
+	output[1] = color1[1] - value * color2[1];
+	output[2] = color1[2] - value * color2[2];
+	output[3] = color1[3];
+#endif
+}
+
+/* output = color1 * ((1 - value) + value * color2) */
+BLI_INLINE void mix_multiply_rgb(float output[4], const float color1[4], const float color2[4], float value)
+{
+#ifdef __SSE2__
+	const float alpha = color1[3];
+	__m128 r = _mm_mul_ps(_mm_loadu_ps(color1),
+	                      _mm_add_ps(_mm_set1_ps(1.0f - value), _mm_mul_ps(_mm_set1_ps(value), _mm_loadu_ps(color2))));
+	_mm_storeu_ps(output, r);
+	output[3] = alpha;
+#else
+	const float valuem = 1.0f - value;
+	output[0] = color1[0] * (valuem + value * color2[0]);
+	output[1] = color1[1] * (valuem + value * color2[1]);
+	output[2] = color1[2] * (valuem + value * color2[2]);
+	output[3] = color1[3];
+#endif
+}
+
 /* ******** Mix Base Operation ******** */
 
 MixBaseOperation::MixBaseOperation() : NodeOperation()
@@ -34,6 +109,7 @@ MixBaseOperation::MixBaseOperation() : NodeOperation()
 	this->addInputSocket(COM_DT_COLOR);
 	this->addInputSocket(COM_DT_COLOR);
 	this->addOutputSocket(COM_DT_COLOR);
+	this->setPointwise(true);
 	this->m_inputValueOperation = NULL;
 	this->m_inputColor1Operation = NULL;
 	this->m_inputColor2Operation = NULL;
@@ -53,20 +129,41 @@ void MixBaseOperation::executePixelSampled(float output[4], float x, float y, Pi
 	float inputColor1[4];
 	float inputColor2[4];
 	float inputValue[4];
-	
+
 	this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
 	this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
 	this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
-	
-	float value = inputValue[0];
-	if (this->useValueAlphaMultiply()) {
-		value *= inputColor2[3];
+
+	mixRow(output, inputValue, inputColor1, inputColor2, 1);
+}
+
+void MixBaseOperation::executeRowSampled(float *output, int x, int y, int num, PixelSampler sampler)
+{
+	float inputColor1[COM_ROW_CHUNK_SIZE * 4];
+	float inputColor2[COM_ROW_CHUNK_SIZE * 4];
+	float inputValue[COM_ROW_CHUNK_SIZE * 4];
+
+	this->m_inputValueOperation->readRowSampled(inputValue, x, y, num, sampler);
+	this->m_inputColor1Operation->readRowSampled(inputColor1, x, y, num, sampler);
+	this->m_inputColor2Operation->readRowSampled(inputColor2, x, y, num, sampler);
+
+	mixRow(output, inputValue, inputColor1, inputColor2, num);
+}
+
+void MixBaseOperation::executeRowKernel(float *output, float **inputs, int num)
+{
+	mixRow(output, inputs[0], inputs[1], inputs[2], num);
+}
+
+void MixBaseOperation::mixRow(float *output, float *inputValue, float *inputColor1, float *inputColor2, int num)
+{
+	for (int i = 0; i < num; i++, output += 4, inputValue += 4, inputColor1 += 4, inputColor2 += 4) {
+		float value = inputValue[0];
+		if (this->useValueAlphaMultiply()) {
+			value *= inputColor2[3];
+		}
+		mix_blend_rgb(output, inputColor1, inputColor2, value);
 	}
-	float valuem = 1.0f - value;
-	output[0] = valuem * (inputColor1[0]) + value * (inputColor2[0]);
-	output[1] = valuem * (inputColor1[1]) + value * (inputColor2[1]);
-	output[2] = valuem * (inputColor1[2]) + value * (inputColor2[2]);
-	output[3] = inputColor1[3];
 }
 
 void MixBaseOperation::determineResolution(unsigned int resolution[2], unsigned int preferredResolution[2])
@@ -107,26 +204,17 @@ MixAddOperation::MixAddOperation() : MixBaseOperation()
 	/* pass */
 }
 
-void MixAddOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void MixAddOperation::mixRow(float *output, float *inputValue, float *inputColor1, float *inputColor2, int num)
 {
-	float inputColor1[4];
-	float inputColor2[4];
-	float inputValue[4];
-
-	this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-	this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-	this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
+	for (int i = 0; i < num; i++, output += 4, inputValue += 4, inputColor1 += 4, inputColor2 += 4) {
+		float value = inputValue[0];
+		if (this->useValueAlphaMultiply()) {
+			value *= inputColor2[3];
+		}
+		mix_add_rgb(output, inputColor1, inputColor2, value);
 
-	float value = inputValue[0];
-	if (this->useValueAlphaMultiply()) {
-		value *= inputColor2[3];
+		clampIfNeeded(output);
 	}
-	output[0] = inputColor1[0] + value * inputColor2[0];
-	output[1] = inputColor1[1] + value * inputColor2[1];
-	output[2] = inputColor1[2] + value * inputColor2[2];
-	output[3] = inputColor1[3];
-
-	clampIfNeeded(output);
 }
 
 /* ******** Mix Blend Operation ******** */
@@ -136,28 +224,20 @@ MixBlendOperation::MixBlendOperation() : MixBaseOperation()
 	/* pass */
 }
 
-void MixBlendOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void MixBlendOperation::mixRow(float *output, float *inputValue, float *inputColor1, float *inputColor2, int num)
 {
-	float inputColor1[4];
-	float inputColor2[4];
-	float inputValue[4];
-	float value;
+	for (int i = 0; i < num; i++, output += 4, inputValue += 4, inputColor1 += 4, inputColor2 += 4) {
+		float value;
 
-	this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-	this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-	this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
-	value = inputValue[0];
-	
-	if (this->useValueAlphaMultiply()) {
-		value *= inputColor2[3];
-	}
-	float valuem = 1.0f - value;
-	output[0] = valuem * (inputColor1[0]) + value * (inputColor2[0]);
-	output[1] = valuem * (inputColor1[1]) + value * (inputColor2[1]);
-	output[2] = valuem * (inputColor1[2]) + value * (inputColor2[2]);
-	output[3] = inputColor1[3];
+		value = inputValue[0];
+
+		if (this->useValueAlphaMultiply()) {
+			value *= inputColor2[3];
+		}
+		mix_blend_rgb(output, inputColor1, inputColor2, value);
 
-	clampIfNeeded(output);
+		clampIfNeeded(output);
+	}
 }
 
 /* ******** Mix Burn Operation ******** */
@@ -167,65 +247,60 @@ MixBurnOperation::MixBurnOperation() : MixBaseOperation()
 	/* pass */
 }
 
-void MixBurnOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void MixBurnOperation::mixRow(float *output, float *inputValue, float *inputColor1, float *inputColor2, int num)
 {
-	float inputColor1[4];
-	float inputColor2[4];
-	float inputValue[4];
-	float tmp;
+	for (int i = 0; i < num; i++, output += 4, inputValue += 4, inputColor1 += 4, inputColor2 += 4) {
+		float tmp;
 
-	this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-	this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-	this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
-
-	float value = inputValue[0];
-	if (this->useValueAlphaMultiply()) {
-		value *= inputColor2[3];
-	}
-	float valuem = 1.0f - value;
+		float value = inputValue[0];
+		if (this->useValueAlphaMultiply()) {
+			value *= inputColor2[3];
+		}
+		float valuem = 1.0f - value;
 
-	tmp = valuem + value * inputColor2[0];
-	if (tmp <= 0.0f)
-		output[0] = 0.0f;
-	else {
-		tmp = 1.0f - (1.0f - inputColor1[0]) / tmp;
-		if (tmp < 0.0f)
+		tmp = valuem + value * inputColor2[0];
+		if (tmp <= 0.0f)
 			output[0] = 0.0f;
-		else if (tmp > 1.0f)
-			output[0] = 1.0f;
-		else
-			output[0] = tmp;
-	}
+		else {
+			tmp = 1.0f - (1.0f - inputColor1[0]) / tmp;
+			if (tmp < 0.0f)
+				output[0] = 0.0f;
+			else if (tmp > 1.0f)
+				output[0] = 1.0f;
+			else
+				output[0] = tmp;
+		}
 
-	tmp = valuem + value * inputColor2[1];
-	if (tmp <= 0.0f)
-		output[1] = 0.0f;
-	else {
-		tmp = 1.0f - (1.0f - inputColor1[1]) / tmp;
-		if (tmp < 0.0f)
+		tmp = valuem + value * inputColor2[1];
+		if (tmp <= 0.0f)
 			output[1] = 0.0f;
-		else if (tmp > 1.0f)
-			output[1] = 1.0f;
-		else
-			output[1] = tmp;
-	}
+		else {
+			tmp = 1.0f - (1.0f - inputColor1[1]) / tmp;
+			if (tmp < 0.0f)
+				output[1] = 0.0f;
+			else if (tmp > 1.0f)
+				output[1] = 1.0f;
+			else
+				output[1] = tmp;
+		}
 
-	tmp = valuem + value * inputColor2[2];
-	if (tmp <= 0.0f)
-		output[2] = 0.0f;
-	else {
-		tmp = 1.0f - (1.0f - inputColor1[2]) / tmp;
-		if (tmp < 0.0f)
+		tmp = valuem + value * inputColor2[2];
+		if (tmp <= 0.0f)
 			output[2] = 0.0f;
-		else if (tmp > 1.0f)
-			output[2] = 1.0f;
-		else
-			output[2] = tmp;
-	}
+		else {
+			tmp = 1.0f - (1.0f - inputColor1[2]) / tmp;
+			if (tmp < 0.0f)
+				output[2] = 0.0f;
+			else if (tmp > 1.0f)
+				output[2] = 1.0f;
+			else
+				output[2] = tmp;
+		}
 
-	output[3] = inputColor1[3];
+		output[3] = inputColor1[3];
 
-	clampIfNeeded(output);
+		clampIfNeeded(output);
+	}
 }
 
 /* ******** Mix Color Operation ******** */
@@ -235,39 +310,33 @@ MixColorOperation::MixColorOperation() : MixBaseOperation()
 	/* pass */
 }
 
-void MixColorOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void MixColorOperation::mixRow(float *output, float *inputValue, float *inputColor1, float *inputColor2, int num)
 {
-	float inputColor1[4];
-	float inputColor2[4];
-	float inputValue[4];
-
-	this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-	this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-	this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
+	for (int i = 0; i < num; i++, output += 4, inputValue += 4, inputColor1 += 4, inputColor2 += 4) {
+		float value = inputValue[0];
+		if (this->useValueAlphaMultiply()) {
+			value *= inputColor2[3];
+		}
+		float valuem = 1.0f - value;
 
-	float value = inputValue[0];
-	if (this->useValueAlphaMultiply()) {
-		value *= inputColor2[3];
-	}
-	float valuem = 1.0f - value;
+		float colH, colS, colV;
+		rgb_to_hsv(inputColor2[0], inputColor2[1], inputColor2[2], &colH, &colS, &colV);
+		if (colS != 0.0f) {
+			float rH, rS, rV;
+			float tmpr, tmpg, tmpb;
+			rgb_to_hsv(inputColor1[0], inputColor1[1], inputColor1[2], &rH, &rS, &rV);
+			hsv_to_rgb(colH, colS, rV, &tmpr, &tmpg, &tmpb);
+			output[0] = (valuem * inputColor1[0]) + (value * tmpr);
+			output[1] = (valuem * inputColor1[1]) + (value * tmpg);
+			output[2] = (valuem * inputColor1[2]) + (value * tmpb);
+		}
+		else {
+			copy_v3_v3(output, inputColor1);
+		}
+		output[3] = inputColor1[3];
 
-	float colH, colS, colV;
-	rgb_to_hsv(inputColor2[0], inputColor2[1], inputColor2[2], &colH, &colS, &colV);
-	if (colS != 0.0f) {
-		float rH, rS, rV;
-		float tmpr, tmpg, tmpb;
-		rgb_to_hsv(inputColor1[0], inputColor1[1], inputColor1[2], &rH, &rS, &rV);
-		hsv_to_rgb(colH, colS, rV, &tmpr, &tmpg, &tmpb);
-		output[0] = (valuem * inputColor1[0]) + (value * tmpr);
-		output[1] = (valuem * inputColor1[1]) + (value * tmpg);
-		output[2] = (valuem * inputColor1[2]) + (value * tmpb);
-	}
-	else {
-		copy_v3_v3(output, inputColor1);
+		clampIfNeeded(output);
 	}
-	output[3] = inputColor1[3];
-
-	clampIfNeeded(output);
 }
 
 /* ******** Mix Darken Operation ******** */
@@ -277,27 +346,21 @@ MixDarkenOperation::MixDarkenOperation() : MixBaseOperation()
 	/* pass */
 }
 
-void MixDarkenOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void MixDarkenOperation::mixRow(float *output, float *inputValue, float *inputColor1, float *inputColor2, int num)
 {
-	float inputColor1[4];
-	float inputColor2[4];
-	float inputValue[4];
-
-	this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-	this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-	this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
+	for (int i = 0; i < num; i++, output += 4, inputValue += 4, inputColor1 += 4, inputColor2 += 4) {
+		float value = inputValue[0];
+		if (this->useValueAlphaMultiply()) {
+			value *= inputColor2[3];
+		}
+		float valuem = 1.0f - value;
+		output[0] = min_ff(inputColor1[0], inputColor2[0]) * value + inputColor1[0] * valuem;
+		output[1] = min_ff(inputColor1[1], inputColor2[1]) * value + inputColor1[1] * valuem;
+		output[2] = min_ff(inputColor1[2], inputColor2[2]) * value + inputColor1[2] * valuem;
+		output[3] = inputColor1[3];
 
-	float value = inputValue[0];
-	if (this->useValueAlphaMultiply()) {
-		value *= inputColor2[3];
+		clampIfNeeded(output);
 	}
-	float valuem = 1.0f - value;
-	output[0] = min_ff(inputColor1[0], inputColor2[0]) * value + inputColor1[0] * valuem;
-	output[1] = min_ff(inputColor1[1], inputColor2[1]) * value + inputColor1[1] * valuem;
-	output[2] = min_ff(inputColor1[2], inputColor2[2]) * value + inputColor1[2] * valuem;
-	output[3] = inputColor1[3];
-
-	clampIfNeeded(output);
 }
 
 /* ******** Mix Difference Operation ******** */
@@ -307,27 +370,21 @@ MixDifferenceOperation::MixDifferenceOperation() : MixBaseOperation()
 	/* pass */
 }
 
-void MixDifferenceOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void MixDifferenceOperation::mixRow(float *output, float *inputValue, float *inputColor1, float *inputColor2, int num)
 {
-	float inputColor1[4];
-	float inputColor2[4];
-	float inputValue[4];
-
-	this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-	this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-	this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
+	for (int i = 0; i < num; i++, output += 4, inputValue += 4, inputColor1 += 4, inputColor2 += 4) {
+		float value = inputValue[0];
+		if (this->useValueAlphaMultiply()) {
+			value *= inputColor2[3];
+		}
+		float valuem = 1.0f - value;
+		output[0] = valuem * inputColor1[0] + value * fabsf(inputColor1[0] - inputColor2[0]);
+		output[1] = valuem * inputColor1[1] + value * fabsf(inputColor1[1] - inputColor2[1]);
+		output[2] = valuem * inputColor1[2] + value * fabsf(inputColor1[2] - inputColor2[2]);
+		output[3] = inputColor1[3];
 
-	float value = inputValue[0];
-	if (this->useValueAlphaMultiply()) {
-		value *= inputColor2[3];
+		clampIfNeeded(output);
 	}
-	float valuem = 1.0f - value;
-	output[0] = valuem * inputColor1[0] + value * fabsf(inputColor1[0] - inputColor2[0]);
-	output[1] = valuem * inputColor1[1] + value * fabsf(inputColor1[1] - inputColor2[1]);
-	output[2] = valuem * inputColor1[2] + value * fabsf(inputColor1[2] - inputColor2[2]);
-	output[3] = inputColor1[3];
-
-	clampIfNeeded(output);
 }
 
 /* ******** Mix Difference Operation ******** */
@@ -337,38 +394,32 @@ MixDivideOperation::MixDivideOperation() : MixBaseOperation()
 	/* pass */
 }
 
-void MixDivideOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void MixDivideOperation::mixRow(float *output, float *inputValue, float *inputColor1, float *inputColor2, int num)
 {
-	float inputColor1[4];
-	float inputColor2[4];
-	float inputValue[4];
-
-	this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-	this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-	this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
-
-	float value = inputValue[0];
-	if (this->useValueAlphaMultiply()) {
-		value *= inputColor2[3];
-	}
-	float valuem = 1.0f - value;
+	for (int i = 0; i < num; i++, output += 4, inputValue += 4, inputColor1 += 4, inputColor2 += 4) {
+		float value = inputValue[0];
+		if (this->useValueAlphaMultiply()) {
+			value *= inputColor2[3];
+		}
+		float valuem = 1.0f - value;
 
-	if (inputColor2[0] != 0.0f)
-		output[0] = valuem * (inputColor1[0]) + value * (inputColor1[0]) / inputColor2[0];
-	else
-		output[0] = 0.0f;
-	if (inputColor2[1] != 0.0f)
-		output[1] = valuem * (inputColor1[1]) + value * (inputColor1[1]) / inputColor2[1];
-	else
-		output[1] = 0.0f;
-	if (inputColor2[2] != 0.0f)
-		output[2] = valuem * (inputColor1[2]) + value * (inputColor1[2]) / inputColor2[2];
-	else
-		output[2] = 0.0f;
+		if (inputColor2[0] != 0.0f)
+			output[0] = valuem * (inputColor1[0]) + value * (inputColor1[0]) / inputColor2[0];
+		else
+			output[0] = 0.0f;
+		if (inputColor2[1] != 0.0f)
+			output[1] = valuem * (inputColor1[1]) + value * (inputColor1[1]) / inputColor2[1];
+		else
+			output[1] = 0.0f;
+		if (inputColor2[2] != 0.0f)
+			output[2] = valuem * (inputColor1[2]) + value * (inputColor1[2]) / inputColor2[2];
+		else
+			output[2] = 0.0f;
 
-	output[3] = inputColor1[3];
+		output[3] = inputColor1[3];
 
-	clampIfNeeded(output);
+		clampIfNeeded(output);
+	}
 }
 
 /* ******** Mix Dodge Operation ******** */
@@ -378,70 +429,65 @@ MixDodgeOperation::MixDodgeOperation() : MixBaseOperation()
 	/* pass */
 }
 
-void MixDodgeOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void MixDodgeOperation::mixRow(float *output, float *inputValue, float *inputColor1, float *inputColor2, int num)
 {
-	float inputColor1[4];
-	float inputColor2[4];
-	float inputValue[4];
-	float tmp;
+	for (int i = 0; i < num; i++, output += 4, inputValue += 4, inputColor1 += 4, inputColor2 += 4) {
+		float tmp;
 
-	this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-	this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-	this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
-
-	float value = inputValue[0];
-	if (this->useValueAlphaMultiply()) {
-		value *= inputColor2[3];
-	}
+		float value = inputValue[0];
+		if (this->useValueAlphaMultiply()) {
+			value *= inputColor2[3];
+		}
 
-	if (inputColor1[0] != 0.0f) {
-		tmp = 1.0f - value * inputColor2[0];
-		if (tmp <= 0.0f)
-			output[0] = 1.0f;
-		else {
-			tmp = inputColor1[0] / tmp;
-			if (tmp > 1.0f)
+		if (inputColor1[0] != 0.0f) {
+			tmp = 1.0f - value * inputColor2[0];
+			if (tmp <= 0.0f)
 				output[0] = 1.0f;
-			else
-				output[0] = tmp;
+			else {
+				tmp = inputColor1[0] / tmp;
+				if (tmp > 1.0f)
+					output[0] = 1.0f;
+				else
+					output[0] = tmp;
+			}
 		}
-	}
-	else
-		output[0] = 0.0f;
+		else
+			output[0] = 0.0f;
 
-	if (inputColor1[1] != 0.0f) {
-		tmp = 1.0f - value * inputColor2[1];
-		if (tmp <= 0.0f)
-			output[1] = 1.0f;
-		else {
-			tmp = inputColor1[1] / tmp;
-			if (tmp > 1.0f)
+		if (inputColor1[1] != 0.0f) {
+			tmp = 1.0f - value * inputColor2[1];
+			if (tmp <= 0.0f)
 				output[1] = 1.0f;
-			else
-				output[1] = tmp;
+			else {
+				tmp = inputColor1[1] / tmp;
+				if (tmp > 1.0f)
+					output[1] = 1.0f;
+				else
+					output[1] = tmp;
+			}
 		}
-	}
-	else
-		output[1] = 0.0f;
+		else
+			output[1] = 0.0f;
 
-	if (inputColor1[2] != 0.0f) {
-		tmp = 1.0f - value * inputColor2[2];
-		if (tmp <= 0.0f)
-			output[2] = 1.0f;
-		else {
-			tmp = inputColor1[2] / tmp;
-			if (tmp > 1.0f)
+		if (inputColor1[2] != 0.0f) {
+			tmp = 1.0f - value * inputColor2[2];
+			if (tmp <= 0.0f)
 				output[2] = 1.0f;
-			else
-				output[2] = tmp;
+			else {
+				tmp = inputColor1[2] / tmp;
+				if (tmp > 1.0f)
+					output[2] = 1.0f;
+				else
+					output[2] = tmp;
+			}
 		}
-	}
-	else
-		output[2] = 0.0f;
+		else
+			output[2] = 0.0f;
 
-	output[3] = inputColor1[3];
+		output[3] = inputColor1[3];
 
-	clampIfNeeded(output);
+		clampIfNeeded(output);
+	}
 }
 
 /* ******** Mix Glare Operation ******** */
@@ -451,29 +497,25 @@ MixGlareOperation::MixGlareOperation() : MixBaseOperation()
 	/* pass */
 }
 
-void MixGlareOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void MixGlareOperation::mixRow(float *output, float *inputValue, float *inputColor1, float *inputColor2, int num)
 {
-	float inputColor1[4];
-	float inputColor2[4];
-	float inputValue[4];
-	float value;
+	for (int i = 0; i < num; i++, output += 4, inputValue += 4, inputColor1 += 4, inputColor2 += 4) {
+		float value;
 
-	this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-	this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-	this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
-	value = inputValue[0];
-	float mf = 2.0f - 2.0f * fabsf(value - 0.5f);
+		value = inputValue[0];
+		float mf = 2.0f - 2.0f * fabsf(value - 0.5f);
 
-	if (inputColor1[0] < 0.0f) inputColor1[0] = 0.0f;
-	if (inputColor1[1] < 0.0f) inputColor1[1] = 0.0f;
-	if (inputColor1[2] < 0.0f) inputColor1[2] = 0.0f;
+		if (inputColor1[0] < 0.0f) inputColor1[0] = 0.0f;
+		if (inputColor1[1] < 0.0f) inputColor1[1] = 0.0f;
+		if (inputColor1[2] < 0.0f) inputColor1[2] = 0.0f;
 
-	output[0] = mf * max(inputColor1[0] + value * (inputColor2[0] - inputColor1[0]), 0.0f);
-	output[1] = mf * max(inputColor1[1] + value * (inputColor2[1] - inputColor1[1]), 0.0f);
-	output[2] = mf * max(inputColor1[2] + value * (inputColor2[2] - inputColor1[2]), 0.0f);
-	output[3] = inputColor1[3];
+		output[0] = mf * max(inputColor1[0] + value * (inputColor2[0] - inputColor1[0]), 0.0f);
+		output[1] = mf * max(inputColor1[1] + value * (inputColor2[1] - inputColor1[1]), 0.0f);
+		output[2] = mf * max(inputColor1[2] + value * (inputColor2[2] - inputColor1[2]), 0.0f);
+		output[3] = inputColor1[3];
 
-	clampIfNeeded(output);
+		clampIfNeeded(output);
+	}
 }
 
 /* ******** Mix Hue Operation ******** */
@@ -483,39 +525,33 @@ MixHueOperation::MixHueOperation() : MixBaseOperation()
 	/* pass */
 }
 
-void MixHueOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void MixHueOperation::mixRow(float *output, float *inputValue, float *inputColor1, float *inputColor2, int num)
 {
-	float inputColor1[4];
-	float inputColor2[4];
-	float inputValue[4];
-
-	this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-	this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-	this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
+	for (int i = 0; i < num; i++, output += 4, inputValue += 4, inputColor1 += 4, inputColor2 += 4) {
+		float value = inputValue[0];
+		if (this->useValueAlphaMultiply()) {
+			value *= inputColor2[3];
+		}
+		float valuem = 1.0f - value;
 
-	float value = inputValue[0];
-	if (this->useValueAlphaMultiply()) {
-		value *= inputColor2[3];
-	}
-	float valuem = 1.0f - value;
+		float colH, colS, colV;
+		rgb_to_hsv(inputColor2[0], inputColor2[1], inputColor2[2], &colH, &colS, &colV);
+		if (colS != 0.0f) {
+			float rH, rS, rV;
+			float tmpr, tmpg, tmpb;
+			rgb_to_hsv(inputColor1[0], inputColor1[1], inputColor1[2], &rH, &rS, &rV);
+			hsv_to_rgb(colH, rS, rV, &tmpr, &tmpg, &tmpb);
+			output[0] = valuem * (inputColor1[0]) + value * tmpr;
+			output[1] = valuem * (inputColor1[1]) + value * tmpg;
+			output[2] = valuem * (inputColor1[2]) + value * tmpb;
+		}
+		else {
+			copy_v3_v3(output, inputColor1);
+		}
+		output[3] = inputColor1[3];
 
-	float colH, colS, colV;
-	rgb_to_hsv(inputColor2[0], inputColor2[1], inputColor2[2], &colH, &colS, &colV);
-	if (colS != 0.0f) {
-		float rH, rS, rV;
-		float tmpr, tmpg, tmpb;
-		rgb_to_hsv(inputColor1[0], inputColor1[1], inputColor1[2], &rH, &rS, &rV);
-		hsv_to_rgb(colH, rS, rV, &tmpr, &tmpg, &tmpb);
-		output[0] = valuem * (inputColor1[0]) + value * tmpr;
-		output[1] = valuem * (inputColor1[1]) + value * tmpg;
-		output[2] = valuem * (inputColor1[2]) + value * tmpb;
+		clampIfNeeded(output);
 	}
-	else {
-		copy_v3_v3(output, inputColor1);
-	}
-	output[3] = inputColor1[3];
-
-	clampIfNeeded(output);
 }
 
 /* ******** Mix Lighten Operation ******** */
@@ -525,33 +561,27 @@ MixLightenOperation::MixLightenOperation() : MixBaseOperation()
 	/* pass */
 }
 
-void MixLightenOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void MixLightenOperation::mixRow(float *output, float *inputValue, float *inputColor1, float *inputColor2, int num)
 {
-	float inputColor1[4];
-	float inputColor2[4];
-	float inputValue[4];
-
-	this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-	this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-	this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
+	for (int i = 0; i < num; i++, output += 4, inputValue += 4, inputColor1 += 4, inputColor2 += 4) {
+		float value = inputValue[0];
+		if (this->useValueAlphaMultiply()) {
+			value *= inputColor2[3];
+		}
+		float tmp;
+		tmp = value * inputColor2[0];
+		if (tmp > inputColor1[0]) output[0] = tmp;
+		else output[0] = inputColor1[0];
+		tmp = value * inputColor2[1];
+		if (tmp > inputColor1[1]) output[1] = tmp;
+		else output[1] = inputColor1[1];
+		tmp = value * inputColor2[2];
+		if (tmp > inputColor1[2]) output[2] = tmp;
+		else output[2] = inputColor1[2];
+		output[3] = inputColor1[3];
 
-	float value = inputValue[0];
-	if (this->useValueAlphaMultiply()) {
-		value *= inputColor2[3];
+		clampIfNeeded(output);
 	}
-	float tmp;
-	tmp = value * inputColor2[0];
-	if (tmp > inputColor1[0]) output[0] = tmp;
-	else output[0] = inputColor1[0];
-	tmp = value * inputColor2[1];
-	if (tmp > inputColor1[1]) output[1] = tmp;
-	else output[1] = inputColor1[1];
-	tmp = value * inputColor2[2];
-	if (tmp > inputColor1[2]) output[2] = tmp;
-	else output[2] = inputColor1[2];
-	output[3] = inputColor1[3];
-
-	clampIfNeeded(output);
 }
 
 /* ******** Mix Linear Light Operation ******** */
@@ -561,36 +591,30 @@ MixLinearLightOperation::MixLinearLightOperation() : MixBaseOperation()
 	/* pass */
 }
 
-void MixLinearLightOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void MixLinearLightOperation::mixRow(float *output, float *inputValue, float *inputColor1, float *inputColor2, int num)
 {
-	float inputColor1[4];
-	float inputColor2[4];
-	float inputValue[4];
+	for (int i = 0; i < num; i++, output += 4, inputValue += 4, inputColor1 += 4, inputColor2 += 4) {
+		float value = inputValue[0];
+		if (this->useValueAlphaMultiply()) {
+			value *= inputColor2[3];
+		}
+		if (inputColor2[0] > 0.5f)
+			output[0] = inputColor1[0] + value * (2.0f * (inputColor2[0] - 0.5f));
+		else
+			output[0] = inputColor1[0] + value * (2.0f * (inputColor2[0]) - 1.0f);
+		if (inputColor2[1] > 0.5f)
+			output[1] = inputColor1[1] + value * (2.0f * (inputColor2[1] - 0.5f));
+		else
+			output[1] = inputColor1[1] + value * (2.0f * (inputColor2[1]) - 1.0f);
+		if (inputColor2[2] > 0.5f)
+			output[2] = inputColor1[2] + value * (2.0f * (inputColor2[2] - 0.5f));
+		else
+			output[2] = inputColor1[2] + value * (2.0f * (inputColor2[2]) - 1.0f);
 
-	this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-	this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-	this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
+		output[3] = inputColor1[3];
 
-	float value = inputValue[0];
-	if (this->useValueAlphaMultiply()) {
-		value *= inputColor2[3];
+		clampIfNeeded(output);
 	}
-	if (inputColor2[0] > 0.5f)
-		output[0] = inputColor1[0] + value * (2.0f * (inputColor2[0] - 0.5f));
-	else
-		output[0] = inputColor1[0] + value * (2.0f * (inputColor2[0]) - 1.0f);
-	if (inputColor2[1] > 0.5f)
-		output[1] = inputColor1[1] + value * (2.0f * (inputColor2[1] - 0.5f));
-	else
-		output[1] = inputColor1[1] + value * (2.0f * (inputColor2[1]) - 1.0f);
-	if (inputColor2[2] > 0.5f)
-		output[2] = inputColor1[2] + value * (2.0f * (inputColor2[2] - 0.5f));
-	else
-		output[2] = inputColor1[2] + value * (2.0f * (inputColor2[2]) - 1.0f);
-
-	output[3] = inputColor1[3];
-
-	clampIfNeeded(output);
 }
 
 /* ******** Mix Multiply Operation ******** */
@@ -600,27 +624,17 @@ MixMultiplyOperation::MixMultiplyOperation() : MixBaseOperation()
 	/* pass */
 }
 
-void MixMultiplyOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void MixMultiplyOperation::mixRow(float *output, float *inputValue, float *inputColor1, float *inputColor2, int num)
 {
-	float inputColor1[4];
-	float inputColor2[4];
-	float inputValue[4];
-
-	this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-	this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-	this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
+	for (int i = 0; i < num; i++, output += 4, inputValue += 4, inputColor1 += 4, inputColor2 += 4) {
+		float value = inputValue[0];
+		if (this->useValueAlphaMultiply()) {
+			value *= inputColor2[3];
+		}
+		mix_multiply_rgb(output, inputColor1, inputColor2, value);
 
-	float value = inputValue[0];
-	if (this->useValueAlphaMultiply()) {
-		value *= inputColor2[3];
+		clampIfNeeded(output);
 	}
-	float valuem = 1.0f - value;
-	output[0] = inputColor1[0] * (valuem + value * inputColor2[0]);
-	output[1] = inputColor1[1] * (valuem + value * inputColor2[1]);
-	output[2] = inputColor1[2] * (valuem + value * inputColor2[2]);
-	output[3] = inputColor1[3];
-
-	clampIfNeeded(output);
 }
 
 /* ******** Mix Ovelray Operation ******** */
@@ -630,44 +644,38 @@ MixOverlayOperation::MixOverlayOperation() : MixBaseOperation()
 	/* pass */
 }
 
-void MixOverlayOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void MixOverlayOperation::mixRow(float *output, float *inputValue, float *inputColor1, float *inputColor2, int num)
 {
-	float inputColor1[4];
-	float inputColor2[4];
-	float inputValue[4];
-
-	this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-	this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-	this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
+	for (int i = 0; i < num; i++, output += 4, inputValue += 4, inputColor1 += 4, inputColor2 += 4) {
+		float value = inputValue[0];
+		if (this->useValueAlphaMultiply()) {
+			value *= inputColor2[3];
+		}
 
-	float value = inputValue[0];
-	if (this->useValueAlphaMultiply()) {
-		value *= inputColor2[3];
-	}
+		float valuem = 1.0f - value;
 
-	float valuem = 1.0f - value;
+		if (inputColor1[0] < 0.5f) {
+			output[0] = inputColor1[0] * (valuem + 2.0f * value * inputColor2[0]);
+		}
+		else {
+			output[0] = 1.0f - (valuem + 2.0f * value * (1.0f - inputColor2[0])) * (1.0f - inputColor1[0]);
+		}
+		if (inputColor1[1] < 0.5f) {
+			output[1] = inputColor1[1] * (valuem + 2.0f * value * inputColor2[1]);
+		}
+		else {
+			output[1] = 1.0f - (valuem + 2.0f * value * (1.0f - inputColor2[1])) * (1.0f - inputColor1[1]);
+		}
+		if (inputColor1[2] < 0.5f) {
+			output[2] = inputColor1[2] * (valuem + 2.0f * value * inputColor2[2]);
+		}
+		else {
+			output[2] = 1.0f - (valuem + 2.0f * value * (1.0f - inputColor2[2])) * (1.0f - inputColor1[2]);
+		}
+		output[3] = inputColor1[3];
 
-	if (inputColor1[0] < 0.5f) {
-		output[0] = inputColor1[0] * (valuem + 2.0f * value * inputColor2[0]);
-	}
-	else {
-		output[0] = 1.0f - (valuem + 2.0f * value * (1.0f - inputColor2[0])) * (1.0f - inputColor1[0]);
-	}
-	if (inputColor1[1] < 0.5f) {
-		output[1] = inputColor1[1] * (valuem + 2.0f * value * inputColor2[1]);
+		clampIfNeeded(output);
 	}
-	else {
-		output[1] = 1.0f - (valuem + 2.0f * value * (1.0f - inputColor2[1])) * (1.0f - inputColor1[1]);
-	}
-	if (inputColor1[2] < 0.5f) {
-		output[2] = inputColor1[2] * (valuem + 2.0f * value * inputColor2[2]);
-	}
-	else {
-		output[2] = 1.0f - (valuem + 2.0f * value * (1.0f - inputColor2[2])) * (1.0f - inputColor1[2]);
-	}
-	output[3] = inputColor1[3];
-
-	clampIfNeeded(output);
 }
 
 /* ******** Mix Saturation Operation ******** */
@@ -677,36 +685,30 @@ MixSaturationOperation::MixSaturationOperation() : MixBaseOperation()
 	/* pass */
 }
 
-void MixSaturationOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void MixSaturationOperation::mixRow(float *output, float *inputValue, float *inputColor1, float *inputColor2, int num)
 {
-	float inputColor1[4];
-	float inputColor2[4];
-	float inputValue[4];
+	for (int i = 0; i < num; i++, output += 4, inputValue += 4, inputColor1 += 4, inputColor2 += 4) {
+		float value = inputValue[0];
+		if (this->useValueAlphaMultiply()) {
+			value *= inputColor2[3];
+		}
+		float valuem = 1.0f - value;
 
-	this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-	this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-	this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
+		float rH, rS, rV;
+		rgb_to_hsv(inputColor1[0], inputColor1[1], inputColor1[2], &rH, &rS, &rV);
+		if (rS != 0.0f) {
+			float colH, colS, colV;
+			rgb_to_hsv(inputColor2[0], inputColor2[1], inputColor2[2], &colH, &colS, &colV);
+			hsv_to_rgb(rH, (valuem * rS + value * colS), rV, &output[0], &output[1], &output[2]);
+		}
+		else {
+			copy_v3_v3(output, inputColor1);
+		}
 
-	float value = inputValue[0];
-	if (this->useValueAlphaMultiply()) {
-		value *= inputColor2[3];
-	}
-	float valuem = 1.0f - value;
+		output[3] = inputColor1[3];
 
-	float rH, rS, rV;
-	rgb_to_hsv(inputColor1[0], inputColor1[1], inputColor1[2], &rH, &rS, &rV);
-	if (rS != 0.0f) {
-		float colH, colS, colV;
-		rgb_to_hsv(inputColor2[0], inputColor2[1], inputColor2[2], &colH, &colS, &colV);
-		hsv_to_rgb(rH, (valuem * rS + value * colS), rV, &output[0], &output[1], &output[2]);
-	}
-	else {
-		copy_v3_v3(output, inputColor1);
+		clampIfNeeded(output);
 	}
-
-	output[3] = inputColor1[3];
-
-	clampIfNeeded(output);
 }
 
 /* ******** Mix Screen Operation ******** */
@@ -716,28 +718,22 @@ MixScreenOperation::MixScreenOperation() : MixBaseOperation()
 	/* pass */
 }
 
-void MixScreenOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void MixScreenOperation::mixRow(float *output, float *inputValue, float *inputColor1, float *inputColor2, int num)
 {
-	float inputColor1[4];
-	float inputColor2[4];
-	float inputValue[4];
+	for (int i = 0; i < num; i++, output += 4, inputValue += 4, inputColor1 += 4, inputColor2 += 4) {
+		float value = inputValue[0];
+		if (this->useValueAlphaMultiply()) {
+			value *= inputColor2[3];
+		}
+		float valuem = 1.0f - value;
 
-	this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-	this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-	this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
+		output[0] = 1.0f - (valuem + value * (1.0f - inputColor2[0])) * (1.0f - inputColor1[0]);
+		output[1] = 1.0f - (valuem + value * (1.0f - inputColor2[1])) * (1.0f - inputColor1[1]);
+		output[2] = 1.0f - (valuem + value * (1.0f - inputColor2[2])) * (1.0f - inputColor1[2]);
+		output[3] = inputColor1[3];
 
-	float value = inputValue[0];
-	if (this->useValueAlphaMultiply()) {
-		value *= inputColor2[3];
+		clampIfNeeded(output);
 	}
-	float valuem = 1.0f - value;
-
-	output[0] = 1.0f - (valuem + value * (1.0f - inputColor2[0])) * (1.0f - inputColor1[0]);
-	output[1] = 1.0f - (valuem + value * (1.0f - inputColor2[1])) * (1.0f - inputColor1[1]);
-	output[2] = 1.0f - (valuem + value * (1.0f - inputColor2[2])) * (1.0f - inputColor1[2]);
-	output[3] = inputColor1[3];
-
-	clampIfNeeded(output);
 }
 
 /* ******** Mix Soft Light Operation ******** */
@@ -747,34 +743,28 @@ MixSoftLightOperation::MixSoftLightOperation() : MixBaseOperation()
 	/* pass */
 }
 
-void MixSoftLightOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler) \
+void MixSoftLightOperation::mixRow(float *output, float *inputValue, float *inputColor1, float *inputColor2, int num)
 {
-	float inputColor1[4];
-	float inputColor2[4];
-	float inputValue[4];
-
-	this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-	this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-	this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
-
-	float value = inputValue[0];
-	if (this->useValueAlphaMultiply()) {
-		value *= inputColor2[3];
-	}
-	float valuem = 1.0f - value;
-	float scr, scg, scb;
+	for (int i = 0; i < num; i++, output += 4, inputValue += 4, inputColor1 += 4, inputColor2 += 4) {
+		float value = inputValue[0];
+		if (this->useValueAlphaMultiply()) {
+			value *= inputColor2[3];
+		}
+		float valuem = 1.0f - value;
+		float scr, scg, scb;
 
-	/* first calculate non-fac based Screen mix */
-	scr = 1.0f - (1.0f - inputColor2[0]) * (1.0f - inputColor1[0]);
-	scg = 1.0f - (1.0f - inputColor2[1]) * (1.0f - inputColor1[1]);
-	scb = 1.0f - (1.0f - inputColor2[2]) * (1.0f - inputColor1[2]);
+		/* first calculate non-fac based Screen mix */
+		scr = 1.0f - (1.0f - inputColor2[0]) * (1.0f - inputColor1[0]);
+		scg = 1.0f - (1.0f - inputColor2[1]) * (1.0f - inputColor1[1]);
+		scb = 1.0f - (1.0f - inputColor2[2]) * (1.0f - inputColor1[2]);
 
-	output[0] = valuem * (inputColor1[0]) + value * (((1.0f - inputColor1[0]) * inputColor2[0] * (inputColor1[0])) + (inputColor1[0] * scr));
-	output[1] = valuem * (inputColor1[1]) + value * (((1.0f - inputColor1[1]) * inputColor2[1] * (inputColor1[1])) + (inputColor1[1] * scg));
-	output[2] = valuem * (inputColor1[2]) + value * (((1.0f - inputColor1[2]) * inputColor2[2] * (inputColor1[2])) + (inputColor1[2] * scb));
-	output[3] = inputColor1[3];
+		output[0] = valuem * (inputColor1[0]) + value * (((1.0f - inputColor1[0]) * inputColor2[0] * (inputColor1[0])) + (inputColor1[0] * scr));
+		output[1] = valuem * (inputColor1[1]) + value * (((1.0f - inputColor1[1]) * inputColor2[1] * (inputColor1[1])) + (inputColor1[1] * scg));
+		output[2] = valuem * (inputColor1[2]) + value * (((1.0f - inputColor1[2]) * inputColor2[2] * (inputColor1[2])) + (inputColor1[2] * scb));
+		output[3] = inputColor1[3];
 
-	clampIfNeeded(output);
+		clampIfNeeded(output);
+	}
 }
 
 /* ******** Mix Subtract Operation ******** */
@@ -784,26 +774,17 @@ MixSubtractOperation::MixSubtractOperation() : MixBaseOperation()
 	/* pass */
 }
 
-void MixSubtractOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void MixSubtractOperation::mixRow(float *output, float *inputValue, float *inputColor1, float *inputColor2, int num)
 {
-	float inputColor1[4];
-	float inputColor2[4];
-	float inputValue[4];
-
-	this->m_inputValueOperation->readSampled(inputValue,   x, y, sampler);
-	this->m_inputColor1Operation->readSampled(inputColor1,   x, y, sampler);
-	this->m_inputColor2Operation->readSampled(inputColor2,   x, y, sampler);
+	for (int i = 0; i < num; i++, output += 4, inputValue += 4, inputColor1 += 4, inputColor2 += 4) {
+		float value = inputValue[0];
+		if (this->useValueAlphaMultiply()) {
+			value *= inputColor2[3];
+		}
+		mix_subtract_rgb(output, inputColor1, inputColor2, value);
 
-	float value = inputValue[0];
-	if (this->useValueAlphaMultiply()) {
-		value *= inputColor2[3];
+		clampIfNeeded(output);
 	}
-	output[0] = inputColor1[0] - value * (inputColor2[0]);
-	output[1] = inputColor1[1] - value * (inputColor2[1]);
-	output[2] = inputColor1[2] - value * (inputColor2[2]);
-	output[3] = inputColor1[3];
-
-	clampIfNeeded(output);
 }
 
 /* ******** Mix Value Operation ******** */
@@ -813,28 +794,22 @@ MixValueOperation::MixValueOperation() : MixBaseOperation()
 	/* pass */
 }
 
-void MixValueOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void MixValueOperation::mixRow(float *output, float *inputValue, float *inputColor1, float *inputColor2, int num)
 {
-	float inputColor1[4];
-	float inputColor2[4];
-	float inputValue[4];
+	for (int i = 0; i < num; i++, output += 4, inputValue += 4, inputColor1 += 4, inputColor2 += 4) {
+		float value = inputValue[0];
+		if (this->useValueAlphaMultiply()) {
+			value *= inputColor2[3];
+		}
+		float valuem = 1.0f - value;
 
-	this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-	this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-	this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
+		float rH, rS, rV;
+		float colH, colS, colV;
+		rgb_to_hsv(inputColor1[0], inputColor1[1], inputColor1[2], &rH, &rS, &rV);
+		rgb_to_hsv(inputColor2[0], inputColor2[1], inputColor2[2], &colH, &colS, &colV);
+		hsv_to_rgb(rH, rS, (valuem * rV + value * colV), &output[0], &output[1], &output[2]);
+		output[3] = inputColor1[3];
 
-	float value = inputValue[0];
-	if (this->useValueAlphaMultiply()) {
-		value *= inputColor2[3];
+		clampIfNeeded(output);
 	}
-	float valuem = 1.0f - value;
-
-	float rH, rS, rV;
-	float colH, colS, colV;
-	rgb_to_hsv(inputColor1[0], inputColor1[1], inputColor1[2], &rH, &rS, &rV);
-	rgb_to_hsv(inputColor2[0], inputColor2[1], inputColor2[2], &colH, &colS, &colV);
-	hsv_to_rgb(rH, rS, (valuem * rV + value * colV), &output[0], &output[1], &output[2]);
-	output[3] = inputColor1[3];
-
-	clampIfNeeded(output);
 }
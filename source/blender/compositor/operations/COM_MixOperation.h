@@ -61,6 +61,14 @@ public:
 	 * the inner loop of this program
 	 */
 	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void executeRowSampled(float *output, int x, int y, int num, PixelSampler sampler);
+	void executeRowKernel(float *output, float **inputs, int num);
+
+	/**
+	 * mix num pixels, inputs and output are arrays of float[4] pixels,
+	 * subclasses implement their mix type here
+	 */
+	virtual void mixRow(float *output, float *inputValue, float *inputColor1, float *inputColor2, int num);
 	
 	/**
 	 * Initialize the execution
@@ -83,115 +91,115 @@ public:
 class MixAddOperation : public MixBaseOperation {
 public:
 	MixAddOperation();
-	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void mixRow(float *output, float *inputValue, float *inputColor1, float *inputColor2, int num);
 };
 
 class MixBlendOperation : public MixBaseOperation {
 public:
 	MixBlendOperation();
-	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void mixRow(float *output, float *inputValue, float *inputColor1, float *inputColor2, int num);
 };
 
 class MixBurnOperation : public MixBaseOperation {
 public:
 	MixBurnOperation();
-	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void mixRow(float *output, float *inputValue, float *inputColor1, float *inputColor2, int num);
 };
 
 class MixColorOperation : public MixBaseOperation {
 public:
 	MixColorOperation();
-	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void mixRow(float *output, float *inputValue, float *inputColor1, float *inputColor2, int num);
 };
 
 class MixDarkenOperation : public MixBaseOperation {
 public:
 	MixDarkenOperation();
-	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void mixRow(float *output, float *inputValue, float *inputColor1, float *inputColor2, int num);
 };
 
 class MixDifferenceOperation : public MixBaseOperation {
 public:
 	MixDifferenceOperation();
-	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void mixRow(float *output, float *inputValue, float *inputColor1, float *inputColor2, int num);
 };
 
 class MixDivideOperation : public MixBaseOperation {
 public:
 	MixDivideOperation();
-	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void mixRow(float *output, float *inputValue, float *inputColor1, float *inputColor2, int num);
 };
 
 class MixDodgeOperation : public MixBaseOperation {
 public:
 	MixDodgeOperation();
-	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void mixRow(float *output, float *inputValue, float *inputColor1, float *inputColor2, int num);
 };
 
 class MixGlareOperation : public MixBaseOperation {
 public:
 	MixGlareOperation();
-	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void mixRow(float *output, float *inputValue, float *inputColor1, float *inputColor2, int num);
 };
 
 class MixHueOperation : public MixBaseOperation {
 public:
 	MixHueOperation();
-	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void mixRow(float *output, float *inputValue, float *inputColor1, float *inputColor2, int num);
 };
 
 class MixLightenOperation : public MixBaseOperation {
 public:
 	MixLightenOperation();
-	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void mixRow(float *output, float *inputValue, float *inputColor1, float *inputColor2, int num);
 };
 
 class MixLinearLightOperation : public MixBaseOperation {
 public:
 	MixLinearLightOperation();
-	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void mixRow(float *output, float *inputValue, float *inputColor1, float *inputColor2, int num);
 };
 
 class MixMultiplyOperation : public MixBaseOperation {
 public:
 	MixMultiplyOperation();
-	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void mixRow(float *output, float *inputValue, float *inputColor1, float *inputColor2, int num);
 };
 
 class MixOverlayOperation : public MixBaseOperation {
 public:
 	MixOverlayOperation();
-	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void mixRow(float *output, float *inputValue, float *inputColor1, float *inputColor2, int num);
 };
 
 class MixSaturationOperation : public MixBaseOperation {
 public:
 	MixSaturationOperation();
-	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void mixRow(float *output, float *inputValue, float *inputColor1, float *inputColor2, int num);
 };
 
 class MixScreenOperation : public MixBaseOperation {
 public:
 	MixScreenOperation();
-	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void mixRow(float *output, float *inputValue, float *inputColor1, float *inputColor2, int num);
 };
 
 class MixSoftLightOperation : public MixBaseOperation {
 public:
 	MixSoftLightOperation();
-	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void mixRow(float *output, float *inputValue, float *inputColor1, float *inputColor2, int num);
 };
 
 class MixSubtractOperation : public MixBaseOperation {
 public:
 	MixSubtractOperation();
-	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void mixRow(float *output, float *inputValue, float *inputColor1, float *inputColor2, int num);
 };
 
 class MixValueOperation : public MixBaseOperation {
 public:
 	MixValueOperation();
-	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void mixRow(float *output, float *inputValue, float *inputColor1, float *inputColor2, int num);
 };
 
 #endif
@@ -22,6 +22,7 @@
 
 #include "COM_ReadBufferOperation.h"
 #include "COM_WriteBufferOperation.h"
+#include "COM_WorkScheduler.h"
 #include "COM_defines.h"
 
 ReadBufferOperation::ReadBufferOperation(DataType datatype) : NodeOperation()
@@ -32,9 +33,53 @@ ReadBufferOperation::ReadBufferOperation(DataType datatype) : NodeOperation()
 	this->m_buffer = NULL;
 }
 
+MemoryBuffer *ReadBufferOperation::getReadBuffer(int ymin, int ymax)
+{
+	MemoryBuffer *band;
+
+	if (this->m_buffer) {
+		return this->m_buffer;
+	}
+
+	/* streaming proxy, read the area of the chunk this thread is executing */
+	band = WorkScheduler::current_input_buffer(this);
+	if (band) {
+		rcti *rect = band->getRect();
+		ymin = max(ymin, 0);
+		ymax = min(ymax, (int)this->getHeight());
+		if (ymin >= ymax || (ymin >= rect->ymin && ymax <= rect->ymax)) {
+			return band;
+		}
+	}
+
+	/* outside of the area of interest, or not read by a chunk of the execution group */
+	return this->m_memoryProxy->getFullBuffer();
+}
+
 void *ReadBufferOperation::initializeTileData(rcti * /*rect*/)
 {
-	return m_buffer;
+	MemoryBuffer *band;
+
+	if (this->m_buffer) {
+		return this->m_buffer;
+	}
+
+	/* tile data is read within the area of interest of the chunk */
+	band = WorkScheduler::current_input_buffer(this);
+	if (band) {
+		return band;
+	}
+	return this->m_memoryProxy->getFullBuffer();
+}
+
+MemoryBuffer *ReadBufferOperation::duplicateTileData(rcti * /*rect*/)
+{
+	if (this->m_buffer) {
+		return this->m_buffer->duplicate();
+	}
+
+	/* copied from the tiles, the full buffer of a streaming proxy isn't built */
+	return this->m_memoryProxy->duplicateFullBuffer();
 }
 
 void ReadBufferOperation::determineResolution(unsigned int resolution[2], unsigned int preferredResolution[2])
@@ -54,51 +99,92 @@ void ReadBufferOperation::determineResolution(unsigned int resolution[2], unsign
 }
 void ReadBufferOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
 {
+	/* bilinear sampling reads the row of the pixel and the one below */
+	const int row = (int)floorf(y);
+	MemoryBuffer *buffer = m_single_value ? getReadBuffer(0, 1) : getReadBuffer(row, row + 2);
+
 	if (m_single_value) {
 		/* write buffer has a single value stored at (0,0) */
-		m_buffer->read(output, 0, 0);
+		buffer->read(output, 0, 0);
 	}
 	else {
 		switch (sampler) {
 			case COM_PS_NEAREST:
-				m_buffer->read(output, x, y);
+				buffer->read(output, x, y);
 				break;
 			case COM_PS_BILINEAR:
 			default:
-				m_buffer->readBilinear(output, x, y);
+				buffer->readBilinear(output, x, y);
 				break;
 			case COM_PS_BICUBIC:
-				m_buffer->readBilinear(output, x, y);
+				buffer->readBilinear(output, x, y);
 				break;
 		}
 	}
 }
 
+void ReadBufferOperation::executeRowSampled(float *output, int x, int y, int num, PixelSampler sampler)
+{
+	MemoryBuffer *buffer = m_single_value ? getReadBuffer(0, 1) : getReadBuffer(y, y + 1);
+
+	if (m_single_value) {
+		/* write buffer has a single value stored at (0,0) */
+		for (int i = 0; i < num; i++) {
+			buffer->read(&output[i * COM_NUM_CHANNELS_COLOR], 0, 0);
+		}
+	}
+	else if (sampler == COM_PS_NEAREST) {
+		buffer->readRow(output, x, y, num);
+	}
+	else {
+		NodeOperation::executeRowSampled(output, x, y, num, sampler);
+	}
+}
+
 void ReadBufferOperation::executePixelExtend(float output[4], float x, float y, PixelSampler sampler,
                                              MemoryBufferExtend extend_x, MemoryBufferExtend extend_y)
 {
+	MemoryBuffer *buffer;
+
+	if (m_single_value) {
+		buffer = getReadBuffer(0, 1);
+	}
+	else if (extend_y == COM_MB_REPEAT) {
+		buffer = getReadBuffer(0, this->getHeight());
+	}
+	else {
+		int row = (int)floorf(y);
+		if (extend_y == COM_MB_EXTEND) {
+			row = max(min(row, (int)this->getHeight() - 1), 0);
+		}
+		buffer = getReadBuffer(row, row + 2);
+	}
+
 	if (m_single_value) {
 		/* write buffer has a single value stored at (0,0) */
-		m_buffer->read(output, 0, 0);
+		buffer->read(output, 0, 0);
 	}
 	else if (sampler == COM_PS_NEAREST) {
-		m_buffer->read(output, x, y, extend_x, extend_y);
+		buffer->read(output, x, y, extend_x, extend_y);
 	}
 	else {
-		m_buffer->readBilinear(output, x, y, extend_x, extend_y);
+		buffer->readBilinear(output, x, y, extend_x, extend_y);
 	}
 }
 
 void ReadBufferOperation::executePixelFiltered(float output[4], float x, float y, float dx[2], float dy[2])
 {
+	/* the filter footprint isn't bounded */
+	MemoryBuffer *buffer = m_single_value ? getReadBuffer(0, 1) : getReadBuffer(0, this->getHeight());
+
 	if (m_single_value) {
 		/* write buffer has a single value stored at (0,0) */
-		m_buffer->read(output, 0, 0);
+		buffer->read(output, 0, 0);
 	}
 	else {
 		const float uv[2] = { x, y };
 		const float deriv[2][2] = { {dx[0], dx[1]}, {dy[0], dy[1]} };
-		m_buffer->readEWA(output, uv, deriv);
+		buffer->readEWA(output, uv, deriv);
 	}
 }
 
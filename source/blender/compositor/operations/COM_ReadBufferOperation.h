@@ -33,6 +33,12 @@ private:
 	bool m_single_value; /* single value stored in buffer, copied from associated write operation */
 	unsigned int m_offset;
 	MemoryBuffer *m_buffer;
+
+	/**
+	 * @brief the buffer to read rows ymin to ymax from, for a streaming MemoryProxy this is the area
+	 * of the chunk being executed by the current thread when it covers the rows, the full buffer otherwise
+	 */
+	MemoryBuffer *getReadBuffer(int ymin, int ymax);
 public:
 	ReadBufferOperation(DataType datetype);
 	void setMemoryProxy(MemoryProxy *memoryProxy) { this->m_memoryProxy = memoryProxy; }
@@ -40,7 +46,9 @@ public:
 	void determineResolution(unsigned int resolution[2], unsigned int preferredResolution[2]);
 	
 	void *initializeTileData(rcti *rect);
+	MemoryBuffer *duplicateTileData(rcti *rect);
 	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void executeRowSampled(float *output, int x, int y, int num, PixelSampler sampler);
 	void executePixelExtend(float output[4], float x, float y, PixelSampler sampler,
 	                        MemoryBufferExtend extend_x, MemoryBufferExtend extend_y);
 	void executePixelFiltered(float output[4], float x, float y, float dx[2], float dy[2]);
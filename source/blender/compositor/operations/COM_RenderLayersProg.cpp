@@ -21,6 +21,7 @@
  */
 
 #include "COM_RenderLayersProg.h"
+#include "COM_CompositorCache.h"
 
 #include "BLI_listbase.h"
 #include "BKE_scene.h"
@@ -39,6 +40,7 @@ RenderLayersBaseProg::RenderLayersBaseProg(int renderpass, int elementsize) : No
 	this->m_renderpass = renderpass;
 	this->setScene(NULL);
 	this->m_inputBuffer = NULL;
+	this->m_resultStamp = 0;
 	this->m_elementsize = elementsize;
 	this->m_rd = NULL;
 }
@@ -65,6 +67,11 @@ void RenderLayersBaseProg::initExecution()
 				}
 			}
 		}
+		this->m_resultStamp = rr->changestamp;
+	}
+	/* results without a stamp can change unnoticed */
+	if (this->m_inputBuffer && this->m_resultStamp == 0) {
+		this->setCacheable(false);
 	}
 	if (re) {
 		RE_ReleaseResult(re);
@@ -173,9 +180,19 @@ void RenderLayersBaseProg::executePixelSampled(float output[4], float x, float y
 	}
 }
 
+uint64_t RenderLayersBaseProg::getDataHash()
+{
+	if (this->m_inputBuffer == NULL) {
+		return 0;
+	}
+	/* layer, pass and view are part of the node and context hashes */
+	return CompositorCache::hash_combine(this->m_resultStamp, this->m_elementsize);
+}
+
 void RenderLayersBaseProg::deinitExecution()
 {
 	this->m_inputBuffer = NULL;
+	this->m_resultStamp = 0;
 }
 
 void RenderLayersBaseProg::determineResolution(unsigned int resolution[2], unsigned int /*preferredResolution*/[2])
@@ -266,6 +283,7 @@ RenderLayersCyclesOperation::RenderLayersCyclesOperation(int pass) : RenderLayer
 RenderLayersDepthProg::RenderLayersDepthProg() : RenderLayersBaseProg(SCE_PASS_Z, 1)
 {
 	this->addOutputSocket(COM_DT_VALUE);
+	this->setDepth(true);
 }
 
 void RenderLayersDepthProg::executePixelSampled(float output[4], float x, float y, PixelSampler /*sampler*/)
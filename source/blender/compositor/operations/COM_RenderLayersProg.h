@@ -61,6 +61,11 @@ protected:
 	 * cached instance to the float buffer inside the layer
 	 */
 	float *m_inputBuffer;
+
+	/**
+	 * change stamp of the render result the buffer belongs to
+	 */
+	unsigned int m_resultStamp;
 	
 	/**
 	 * renderpass where this operation needs to get its data from
@@ -106,6 +111,11 @@ public:
 	void initExecution();
 	void deinitExecution();
 	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+
+	/**
+	 * the change stamp of the render result, so cached results are reused only for identical renders
+	 */
+	uint64_t getDataHash();
 };
 
 class RenderLayersAOOperation : public RenderLayersBaseProg {
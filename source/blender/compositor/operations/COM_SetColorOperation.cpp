@@ -21,10 +21,12 @@
  */
 
 #include "COM_SetColorOperation.h"
+#include "COM_CompositorCache.h"
 
 SetColorOperation::SetColorOperation() : NodeOperation()
 {
 	this->addOutputSocket(COM_DT_COLOR);
+	this->setPointwise(true);
 }
 
 void SetColorOperation::executePixelSampled(float output[4],
@@ -34,8 +36,27 @@ void SetColorOperation::executePixelSampled(float output[4],
 	copy_v4_v4(output, this->m_color);
 }
 
+void SetColorOperation::executeRowSampled(float *output,
+                                          int /*x*/, int /*y*/, int num,
+                                          PixelSampler /*sampler*/)
+{
+	executeRowKernel(output, NULL, num);
+}
+
+void SetColorOperation::executeRowKernel(float *output, float ** /*inputs*/, int num)
+{
+	for (int i = 0; i < num; i++) {
+		copy_v4_v4(&output[i * 4], this->m_color);
+	}
+}
+
 void SetColorOperation::determineResolution(unsigned int resolution[2], unsigned int preferredResolution[2])
 {
 	resolution[0] = preferredResolution[0];
 	resolution[1] = preferredResolution[1];
 }
+
+uint64_t SetColorOperation::getDataHash()
+{
+	return CompositorCache::hash_data(this->m_color, sizeof(this->m_color));
+}
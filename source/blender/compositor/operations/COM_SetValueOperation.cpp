@@ -21,10 +21,12 @@
  */
 
 #include "COM_SetValueOperation.h"
+#include "COM_CompositorCache.h"
 
 SetValueOperation::SetValueOperation() : NodeOperation()
 {
 	this->addOutputSocket(COM_DT_VALUE);
+	this->setPointwise(true);
 }
 
 void SetValueOperation::executePixelSampled(float output[4],
@@ -34,8 +36,27 @@ void SetValueOperation::executePixelSampled(float output[4],
 	output[0] = this->m_value;
 }
 
+void SetValueOperation::executeRowSampled(float *output,
+                                          int /*x*/, int /*y*/, int num,
+                                          PixelSampler /*sampler*/)
+{
+	executeRowKernel(output, NULL, num);
+}
+
+void SetValueOperation::executeRowKernel(float *output, float ** /*inputs*/, int num)
+{
+	for (int i = 0; i < num; i++) {
+		output[i * 4] = this->m_value;
+	}
+}
+
 void SetValueOperation::determineResolution(unsigned int resolution[2], unsigned int preferredResolution[2])
 {
 	resolution[0] = preferredResolution[0];
 	resolution[1] = preferredResolution[1];
 }
+
+uint64_t SetValueOperation::getDataHash()
+{
+	return CompositorCache::hash_data(&this->m_value, sizeof(this->m_value));
+}
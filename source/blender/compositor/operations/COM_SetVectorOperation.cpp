@@ -21,11 +21,13 @@
  */
 
 #include "COM_SetVectorOperation.h"
+#include "COM_CompositorCache.h"
 #include "COM_defines.h"
 
 SetVectorOperation::SetVectorOperation() : NodeOperation()
 {
 	this->addOutputSocket(COM_DT_VECTOR);
+	this->setPointwise(true);
 }
 
 void SetVectorOperation::executePixelSampled(float output[4],
@@ -37,8 +39,30 @@ void SetVectorOperation::executePixelSampled(float output[4],
 	output[2] = this->m_z;
 }
 
+void SetVectorOperation::executeRowSampled(float *output,
+                                           int /*x*/, int /*y*/, int num,
+                                           PixelSampler /*sampler*/)
+{
+	executeRowKernel(output, NULL, num);
+}
+
+void SetVectorOperation::executeRowKernel(float *output, float ** /*inputs*/, int num)
+{
+	for (int i = 0; i < num; i++, output += 4) {
+		output[0] = this->m_x;
+		output[1] = this->m_y;
+		output[2] = this->m_z;
+	}
+}
+
 void SetVectorOperation::determineResolution(unsigned int resolution[2], unsigned int preferredResolution[2])
 {
 	resolution[0] = preferredResolution[0];
 	resolution[1] = preferredResolution[1];
 }
+
+uint64_t SetVectorOperation::getDataHash()
+{
+	const float vector[4] = {this->m_x, this->m_y, this->m_z, this->m_w};
+	return CompositorCache::hash_data(vector, sizeof(vector));
+}
@@ -60,6 +60,7 @@ ViewerOperation::ViewerOperation() : NodeOperation()
 	this->m_depthInput = NULL;
 	this->m_rd = NULL;
 	this->m_viewName = NULL;
+	this->m_proxyStep = 1;
 }
 
 void ViewerOperation::initExecution()
@@ -88,6 +89,11 @@ void ViewerOperation::executeRegion(rcti *rect, unsigned int /*tileNumber*/)
 	float *buffer = this->m_outputBuffer;
 	float *depthbuffer = this->m_depthBuffer;
 	if (!buffer) return;
+	if (this->m_proxyStep > 1) {
+		executeRegionProxy(rect);
+		updateImage(rect);
+		return;
+	}
 	const int x1 = rect->xmin;
 	const int y1 = rect->ymin;
 	const int x2 = rect->xmax;
@@ -96,23 +102,30 @@ void ViewerOperation::executeRegion(rcti *rect, unsigned int /*tileNumber*/)
 	const int offsetadd4 = offsetadd * 4;
 	int offset = (y1 * this->getWidth() + x1);
 	int offset4 = offset * 4;
-	float alpha[4], depth[4];
+	float alpha[COM_ROW_CHUNK_SIZE * 4], depth[COM_ROW_CHUNK_SIZE * 4];
 	int x;
 	int y;
 	bool breaked = false;
 
 	for (y = y1; y < y2 && (!breaked); y++) {
-		for (x = x1; x < x2; x++) {
-			this->m_imageInput->readSampled(&(buffer[offset4]), x, y, COM_PS_NEAREST);
+		for (x = x1; x < x2; x += COM_ROW_CHUNK_SIZE) {
+			const int num = min_ii(COM_ROW_CHUNK_SIZE, x2 - x);
+			int i;
+
+			this->m_imageInput->readRowSampled(&(buffer[offset4]), x, y, num, COM_PS_NEAREST);
 			if (this->m_useAlphaInput) {
-				this->m_alphaInput->readSampled(alpha, x, y, COM_PS_NEAREST);
-				buffer[offset4 + 3] = alpha[0];
+				this->m_alphaInput->readRowSampled(alpha, x, y, num, COM_PS_NEAREST);
+				for (i = 0; i < num; i++) {
+					buffer[offset4 + i * 4 + 3] = alpha[i * 4];
+				}
+			}
+			this->m_depthInput->readRowSampled(depth, x, y, num, COM_PS_NEAREST);
+			for (i = 0; i < num; i++) {
+				depthbuffer[offset + i] = depth[i * 4];
 			}
-			this->m_depthInput->readSampled(depth, x, y, COM_PS_NEAREST);
-			depthbuffer[offset] = depth[0];
 
-			offset ++;
-			offset4 += 4;
+			offset += num;
+			offset4 += num * 4;
 		}
 		if (isBreaked()) {
 			breaked = true;
@@ -123,6 +136,47 @@ void ViewerOperation::executeRegion(rcti *rect, unsigned int /*tileNumber*/)
 	updateImage(rect);
 }
 
+void ViewerOperation::executeRegionProxy(rcti *rect)
+{
+	float *buffer = this->m_outputBuffer;
+	float *depthbuffer = this->m_depthBuffer;
+	const int step = this->m_proxyStep;
+	const int width = this->getWidth();
+	float color[4], alpha[4], depth[4];
+	int x, y, bx, by;
+
+	for (y = rect->ymin; y < rect->ymax; y += step) {
+		const int y2 = min_ii(y + step, rect->ymax);
+		const int sy = (y + y2 - 1) / 2;
+
+		for (x = rect->xmin; x < rect->xmax; x += step) {
+			const int x2 = min_ii(x + step, rect->xmax);
+			const int sx = (x + x2 - 1) / 2;
+
+			/* the center pixel of the block fills the whole block */
+			this->m_imageInput->readSampled(color, sx, sy, COM_PS_NEAREST);
+			if (this->m_useAlphaInput) {
+				this->m_alphaInput->readSampled(alpha, sx, sy, COM_PS_NEAREST);
+				color[3] = alpha[0];
+			}
+			this->m_depthInput->readSampled(depth, sx, sy, COM_PS_NEAREST);
+
+			for (by = y; by < y2; by++) {
+				for (bx = x; bx < x2; bx++) {
+					const int offset = by * width + bx;
+					copy_v4_v4(&buffer[offset * 4], color);
+					if (depthbuffer) {
+						depthbuffer[offset] = depth[0];
+					}
+				}
+			}
+		}
+		if (isBreaked()) {
+			break;
+		}
+	}
+}
+
 void ViewerOperation::initImage()
 {
 	Image *ima = this->m_image;
@@ -42,6 +42,7 @@ private:
 	bool m_useAlphaInput;
 	const RenderData *m_rd;
 	const char *m_viewName;
+	int m_proxyStep;
 
 	const ColorManagedViewSettings *m_viewSettings;
 	const ColorManagedDisplaySettings *m_displaySettings;
@@ -72,10 +73,18 @@ public:
 	void setRenderData(const RenderData *rd) { this->m_rd = rd; }
 	void setViewName(const char *viewName) { this->m_viewName = viewName; }
 
+	/**
+	 * @brief sample one pixel of every step x step block, a preview at the display resolution
+	 * that is replaced by executing the chunks again with a step of 1
+	 */
+	void setProxyStep(int step) { this->m_proxyStep = step; }
+	int getProxyStep() const { return this->m_proxyStep; }
+
 	void setViewSettings(const ColorManagedViewSettings *viewSettings) { this->m_viewSettings = viewSettings; }
 	void setDisplaySettings(const ColorManagedDisplaySettings *displaySettings) { this->m_displaySettings = displaySettings; }
 
 private:
+	void executeRegionProxy(rcti *rect);
 	void updateImage(rcti *rect);
 	void initImage();
 };
@@ -32,6 +32,10 @@ public:
 	WrapOperation(DataType datetype);
 	bool determineDependingAreaOfInterest(rcti *input, ReadBufferOperation *readOperation, rcti *output);
 	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	/* wrapped coordinates are not contiguous, don't use the buffer row access of ReadBufferOperation */
+	void executeRowSampled(float *output, int x, int y, int num, PixelSampler sampler) {
+		NodeOperation::executeRowSampled(output, x, y, num, sampler);
+	}
 
 	void setWrapping(int wrapping_type);
 	float getWrappedOriginalXPos(float x);
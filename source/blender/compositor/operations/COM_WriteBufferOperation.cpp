@@ -24,6 +24,7 @@
 #include "COM_defines.h"
 #include <stdio.h>
 #include "COM_OpenCLDevice.h"
+#include "COM_Profiler.h"
 
 WriteBufferOperation::WriteBufferOperation(DataType datatype) : NodeOperation()
 {
@@ -59,11 +60,18 @@ void WriteBufferOperation::deinitExecution()
 
 void WriteBufferOperation::executeRegion(rcti *rect, unsigned int /*tileNumber*/)
 {
-	MemoryBuffer *memoryBuffer = this->m_memoryProxy->getBuffer();
+	/* a streaming proxy has no buffer, the region is written to its tiles afterwards */
+	const bool streaming = this->m_memoryProxy->isStreaming();
+	MemoryBuffer *memoryBuffer = streaming ? new MemoryBuffer(this->m_memoryProxy, rect) : this->m_memoryProxy->getBuffer();
+	const rcti *bufferRect = memoryBuffer->getRect();
 	float *buffer = memoryBuffer->getBuffer();
 	const int num_channels = memoryBuffer->get_num_channels();
 	if (this->m_input->isComplex()) {
-		void *data = this->m_input->initializeTileData(rect);
+		void *data;
+		{
+			ProfileScope scope(COM_PROFILE_TILE_DATA, this->m_input, NULL, NULL);
+			data = this->m_input->initializeTileData(rect);
+		}
 		int x1 = rect->xmin;
 		int y1 = rect->ymin;
 		int x2 = rect->xmax;
@@ -72,7 +80,7 @@ void WriteBufferOperation::executeRegion(rcti *rect, unsigned int /*tileNumber*/
 		int y;
 		bool breaked = false;
 		for (y = y1; y < y2 && (!breaked); y++) {
-			int offset4 = (y * memoryBuffer->getWidth() + x1) * num_channels;
+			int offset4 = ((y - bufferRect->ymin) * memoryBuffer->getWidth() + x1 - bufferRect->xmin) * num_channels;
 			for (x = x1; x < x2; x++) {
 				this->m_input->read(&(buffer[offset4]), x, y, data);
 				offset4 += num_channels;
@@ -96,18 +104,35 @@ void WriteBufferOperation::executeRegion(rcti *rect, unsigned int /*tileNumber*/
 		int x;
 		int y;
 		bool breaked = false;
+		float row[COM_ROW_CHUNK_SIZE * COM_NUM_CHANNELS_COLOR];
 		for (y = y1; y < y2 && (!breaked); y++) {
-			int offset4 = (y * memoryBuffer->getWidth() + x1) * num_channels;
-			for (x = x1; x < x2; x++) {
-				this->m_input->readSampled(&(buffer[offset4]), x, y, COM_PS_NEAREST);
-				offset4 += num_channels;
+			int offset4 = ((y - bufferRect->ymin) * memoryBuffer->getWidth() + x1 - bufferRect->xmin) * num_channels;
+			for (x = x1; x < x2; x += COM_ROW_CHUNK_SIZE) {
+				const int num = min_ii(COM_ROW_CHUNK_SIZE, x2 - x);
+				if (num_channels == COM_NUM_CHANNELS_COLOR) {
+					this->m_input->readRowSampled(&(buffer[offset4]), x, y, num, COM_PS_NEAREST);
+				}
+				else {
+					this->m_input->readRowSampled(row, x, y, num, COM_PS_NEAREST);
+					for (int i = 0; i < num; i++) {
+						memcpy(&(buffer[offset4 + i * num_channels]), &row[i * COM_NUM_CHANNELS_COLOR],
+						       num_channels * sizeof(float));
+					}
+				}
+				offset4 += num * num_channels;
 			}
 			if (isBreaked()) {
 				breaked = true;
 			}
 		}
 	}
-	memoryBuffer->setCreatedState();
+	if (streaming) {
+		this->m_memoryProxy->writeArea(memoryBuffer);
+		delete memoryBuffer;
+	}
+	else {
+		memoryBuffer->setCreatedState();
+	}
 }
 
 void WriteBufferOperation::executeOpenCLRegion(OpenCLDevice *device, rcti * /*rect*/, unsigned int /*chunkNumber*/,
@@ -152,7 +177,7 @@ void WriteBufferOperation::executeOpenCLRegion(OpenCLDevice *device, rcti * /*re
 	error = clEnqueueReadImage(device->getQueue(), clOutputBuffer, CL_TRUE, origin, region, 0, 0, outputFloatBuffer, 0, NULL, NULL);
 	if (error != CL_SUCCESS) { printf("CLERROR[%d]: %s\n", error, clewErrorString(error));  }
 	
-	this->getMemoryProxy()->getBuffer()->copyContentFrom(outputBuffer);
+	this->getMemoryProxy()->writeArea(outputBuffer);
 
 	// STEP 4
 	while (!clMemToCleanUp->empty()) {
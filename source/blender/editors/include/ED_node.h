@@ -102,6 +102,7 @@ void ED_node_post_apply_transform(struct bContext *C, struct bNodeTree *ntree);
 void ED_node_set_active(struct Main *bmain, struct bNodeTree *ntree, struct bNode *node);
 
 void ED_node_composite_job(const struct bContext *C, struct bNodeTree *nodetree, struct Scene *scene_owner);
+bool ED_node_composite_viewer_outdated(struct Scene *scene, struct ScrArea *sa);
 
 /* node_ops.c */
 void ED_operatormacros_node(void);
@@ -2767,6 +2767,22 @@ void init_userdef_do_versions(void)
 		
 	}
 
+	if (U.ptcache_prefetch_limit <= 0) {
+		U.ptcache_prefetch_limit = 256;
+	}
+
+	if (U.image_tile_cache_limit <= 0) {
+		U.image_tile_cache_limit = 1024;
+	}
+
+	if (U.compositor_cache_limit <= 0) {
+		U.compositor_cache_limit = 1024;
+	}
+
+	if (U.compositor_memory_limit <= 0) {
+		U.compositor_memory_limit = 2048;
+	}
+
 	if (U.pixelsize == 0.0f)
 		U.pixelsize = 1.0f;
 	
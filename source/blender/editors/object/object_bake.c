@@ -642,8 +642,10 @@ static void finish_bake_internal(BakeRender *bkr)
 					}
 
 					/* invalidate display buffers for changed images */
-					if (ibuf->userflags & IB_BITMAPDIRTY)
+					if (ibuf->userflags & IB_BITMAPDIRTY) {
+						IMB_tag_changed(ibuf);
 						ibuf->userflags |= IB_DISPLAY_BUFFER_INVALID;
+					}
 				}
 			}
 
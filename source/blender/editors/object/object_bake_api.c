@@ -244,6 +244,7 @@ static bool write_internal_bake_pixels(
 	if (margin > 0)
 		RE_bake_margin(ibuf, mask_buffer, margin);
 
+	IMB_tag_changed(ibuf);
 	ibuf->userflags |= IB_DISPLAY_BUFFER_INVALID | IB_BITMAPDIRTY;
 
 	if (ibuf->rect_float)
@@ -304,6 +304,7 @@ static void image_undo_restore_runtime(ListBase *lb)
 			ibuf->userflags |= IB_RECT_INVALID; /* force recreate of char rect */
 		if (ibuf->mipmap[0])
 			ibuf->userflags |= IB_MIPMAP_INVALID;  /* force mipmap recreatiom */
+		IMB_tag_changed(ibuf);
 		ibuf->userflags |= IB_DISPLAY_BUFFER_INVALID;
 
 		BKE_image_release_ibuf(ima, ibuf, NULL);
@@ -370,6 +371,7 @@ void ED_image_undo_restore(bContext *C, ListBase *lb)
 			ibuf->userflags |= IB_RECT_INVALID; /* force recreate of char rect */
 		if (ibuf->mipmap[0])
 			ibuf->userflags |= IB_MIPMAP_INVALID;  /* force mipmap recreatiom */
+		IMB_tag_changed(ibuf);
 		ibuf->userflags |= IB_DISPLAY_BUFFER_INVALID;
 
 		DAG_id_tag_update(&ima->id, 0);
@@ -492,6 +494,9 @@ void imapaint_image_update(SpaceImage *sima, Image *image, ImBuf *ibuf, short te
 	if (ibuf->mipmap[0])
 		ibuf->userflags |= IB_MIPMAP_INVALID;
 
+	/* the pixels of this step are written */
+	IMB_tag_changed(ibuf);
+
 	/* todo: should set_tpage create ->rect? */
 	if (texpaint || (sima && sima->lock)) {
 		int w = imapaintpartial.x2 - imapaintpartial.x1;
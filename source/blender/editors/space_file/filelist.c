@@ -2241,7 +2241,7 @@ static int filelist_readjob_list_lib(const char *root, ListBase *entries, const
 	char dir[FILE_MAX_LIBEXTRA], *group;
 	bool ok;
 
-	struct BlendHandle *libfiledata = NULL;
+	struct BlendFileIndex *libindex = NULL;
 
 	/* name test */
 	ok = BLO_library_path_explode(root, dir, &group, NULL);
@@ -2249,23 +2249,23 @@ static int filelist_readjob_list_lib(const char *root, ListBase *entries, const
 		return nbr_entries;
 	}
 
-	/* there we go */
-	libfiledata = BLO_blendhandle_from_file(dir, NULL);
-	if (libfiledata == NULL) {
+	/* there we go, the index avoids scanning big libraries again on each listing */
+	libindex = BLO_blendfile_index_get(dir, NULL);
+	if (libindex == NULL) {
 		return nbr_entries;
 	}
 
 	/* memory for strings is passed into filelist[i].entry->relpath and freed in filelist_entry_free. */
 	if (group) {
 		idcode = groupname_to_code(group);
-		names = BLO_blendhandle_get_datablock_names(libfiledata, idcode, &nnames);
+		names = BLO_blendfile_index_get_datablock_names(libindex, idcode, &nnames);
 	}
 	else {
-		names = BLO_blendhandle_get_linkable_groups(libfiledata);
+		names = BLO_blendfile_index_get_linkable_groups(libindex);
 		nnames = BLI_linklist_count(names);
 	}
 
-	BLO_blendhandle_close(libfiledata);
+	BLO_blendfile_index_release(libindex);
 
 	if (!skip_currpar) {
 		entry = MEM_callocN(sizeof(*entry), __func__);
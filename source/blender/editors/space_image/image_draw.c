@@ -573,6 +573,69 @@ static void draw_image_buffer(const bContext *C, SpaceImage *sima, ARegion *ar,
 	glPixelZoom(1.0f, 1.0f);
 }
 
+/* Images read from tiled files only have the visible tiles loaded, of the
+ * mipmap level matching the zoom. Every tile is drawn as its own buffer. */
+static void draw_image_buffer_cached_tiles(const bContext *C, SpaceImage *sima, ARegion *ar, Scene *scene, ImBuf *ibuf, float zoomx, float zoomy)
+{
+	ImBuf *mipbuf, *tilebuf;
+	float scalex, scaley;
+	int level = 0;
+	int xmin, ymin, xmax, ymax, tx, ty, y;
+
+	/* lowest resolution level that still has a pixel per screen pixel */
+	while (level + 1 < ibuf->miptot) {
+		mipbuf = IMB_getmipmap(ibuf, level + 1);
+		if (zoomx * ibuf->x > mipbuf->x || zoomy * ibuf->y > mipbuf->y)
+			break;
+		level++;
+	}
+
+	mipbuf = IMB_getmipmap(ibuf, level);
+	scalex = (float)ibuf->x / (float)mipbuf->x;
+	scaley = (float)ibuf->y / (float)mipbuf->y;
+
+	/* visible pixels of the level, the view is in image space */
+	xmin = max_ii((int)floorf(ar->v2d.cur.xmin * mipbuf->x), 0);
+	ymin = max_ii((int)floorf(ar->v2d.cur.ymin * mipbuf->y), 0);
+	xmax = min_ii((int)ceilf(ar->v2d.cur.xmax * mipbuf->x), mipbuf->x);
+	ymax = min_ii((int)ceilf(ar->v2d.cur.ymax * mipbuf->y), mipbuf->y);
+
+	if (xmin >= xmax || ymin >= ymax)
+		return;
+
+	for (ty = ymin / mipbuf->tiley; ty <= (ymax - 1) / mipbuf->tiley; ty++) {
+		for (tx = xmin / mipbuf->tilex; tx <= (xmax - 1) / mipbuf->tilex; tx++) {
+			const int w = min_ii(mipbuf->tilex, mipbuf->x - tx * mipbuf->tilex);
+			const int h = min_ii(mipbuf->tiley, mipbuf->y - ty * mipbuf->tiley);
+			float *rect_float = IMB_tile_cache_acquire_float(mipbuf, tx, ty);
+
+			if (w == mipbuf->tilex) {
+				/* use the tile memory directly */
+				tilebuf = IMB_allocImBuf(w, h, ibuf->planes, 0);
+				tilebuf->rect_float = rect_float;
+			}
+			else {
+				/* tiles at the right side are only partially used, copy the used part */
+				tilebuf = IMB_allocImBuf(w, h, ibuf->planes, IB_rectfloat);
+				for (y = 0; y < h; y++)
+					memcpy(tilebuf->rect_float + 4 * w * y, rect_float + 4 * mipbuf->tilex * y, sizeof(float) * 4 * w);
+			}
+
+			tilebuf->channels = 4;
+			tilebuf->flags |= IB_rectfloat;
+			tilebuf->float_colorspace = ibuf->float_colorspace;
+
+			draw_image_buffer(C, sima, ar, scene, tilebuf,
+			                  (float)(tx * mipbuf->tilex) / mipbuf->x, (float)(ty * mipbuf->tiley) / mipbuf->y,
+			                  zoomx * scalex, zoomy * scaley);
+
+			IMB_freeImBuf(tilebuf);
+
+			IMB_tile_cache_release(mipbuf, tx, ty);
+		}
+	}
+}
+
 static unsigned int *get_part_from_buffer(unsigned int *buffer, int width, short startx, short starty, short endx, short endy)
 {
 	unsigned int *rt, *rp, *rectmain;
@@ -892,7 +955,11 @@ void draw_image_main(const bContext *C, ARegion *ar)
 			BKE_image_multiview_index(ima, &sima->iuser);
 	}
 
-	ibuf = ED_space_image_acquire_buffer(sima, &lock);
+	/* repeated drawing needs all pixels */
+	if ((sima->flag & SI_DRAW_TILE) || (ima && (ima->tpageflag & IMA_TILES)))
+		ibuf = ED_space_image_acquire_buffer(sima, &lock);
+	else
+		ibuf = ED_space_image_acquire_buffer_tiled(sima, &lock);
 
 	/* draw the image or grid */
 	if (ibuf == NULL) {
@@ -900,7 +967,9 @@ void draw_image_main(const bContext *C, ARegion *ar)
 	}
 	else {
 
-		if (sima->flag & SI_DRAW_TILE)
+		if (ibuf->tiles_float && !ibuf->rect_float)
+			draw_image_buffer_cached_tiles(C, sima, ar, scene, ibuf, zoomx, zoomy);
+		else if (sima->flag & SI_DRAW_TILE)
 			draw_image_buffer_repeated(C, sima, ar, scene, ima, ibuf, zoomx, zoomy);
 		else if (ima && (ima->tpageflag & IMA_TILES))
 			draw_image_buffer_tiled(sima, ar, scene, ima, ibuf, 0.0f, 0.0, zoomx, zoomy);
@@ -129,6 +129,28 @@ ImBuf *ED_space_image_acquire_buffer(SpaceImage *sima, void **r_lock)
 	return NULL;
 }
 
+/* same as ED_space_image_acquire_buffer, but images read from tiled files
+ * may only have their tiles loaded, for drawing and querying the size */
+ImBuf *ED_space_image_acquire_buffer_tiled(SpaceImage *sima, void **r_lock)
+{
+	ImBuf *ibuf;
+
+	if (sima && sima->image) {
+		ibuf = BKE_image_acquire_ibuf_tiled(sima->image, &sima->iuser, r_lock);
+
+		if (ibuf) {
+			if (ibuf->rect || ibuf->rect_float || ibuf->tiles_float)
+				return ibuf;
+			BKE_image_release_ibuf(sima->image, ibuf, *r_lock);
+			*r_lock = NULL;
+		}
+	}
+	else
+		*r_lock = NULL;
+
+	return NULL;
+}
+
 void ED_space_image_release_buffer(SpaceImage *sima, ImBuf *ibuf, void *lock)
 {
 	if (sima && sima->image)
@@ -141,7 +163,7 @@ bool ED_space_image_has_buffer(SpaceImage *sima)
 	void *lock;
 	bool has_buffer;
 
-	ibuf = ED_space_image_acquire_buffer(sima, &lock);
+	ibuf = ED_space_image_acquire_buffer_tiled(sima, &lock);
 	has_buffer = (ibuf != NULL);
 	ED_space_image_release_buffer(sima, ibuf, lock);
 
@@ -154,7 +176,7 @@ void ED_space_image_get_size(SpaceImage *sima, int *width, int *height)
 	ImBuf *ibuf;
 	void *lock;
 
-	ibuf = ED_space_image_acquire_buffer(sima, &lock);
+	ibuf = ED_space_image_acquire_buffer_tiled(sima, &lock);
 
 	if (ibuf && ibuf->x > 0 && ibuf->y > 0) {
 		*width = ibuf->x;
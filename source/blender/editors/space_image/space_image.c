@@ -408,6 +408,12 @@ static void image_refresh(const bContext *C, ScrArea *sa)
 			}
 		}
 	}
+	else if (ima && ima->type == IMA_TYPE_COMPOSITE && scene->nodetree &&
+	         ED_node_composite_viewer_outdated(scene, sa))
+	{
+		/* a part of the viewer that wasn't calculated came into view */
+		ED_node_composite_job(C, scene->nodetree, scene);
+	}
 	else if (ima && (ima->source == IMA_SRC_VIEWER || sima->pin)) {
 		/* pass */
 	}
@@ -714,6 +720,11 @@ static void image_main_region_draw(const bContext *C, ARegion *ar)
 	/* we set view2d from own zoom and offset each time */
 	image_main_region_set_view2d(sima, ar);
 
+	/* panned or zoomed to a part of the viewer that isn't calculated, refresh runs the compositor */
+	if (ED_node_composite_viewer_outdated(scene, CTX_wm_area(C))) {
+		ED_area_tag_refresh(CTX_wm_area(C));
+	}
+
 	/* we draw image in pixelspace */
 	draw_image_main(C, ar);
 
@@ -897,12 +908,14 @@ static void image_tools_region_draw(const bContext *C, ARegion *ar)
 	SpaceImage *sima = CTX_wm_space_image(C);
 	Scene *scene = CTX_data_scene(C);
 	void *lock;
-	ImBuf *ibuf = ED_space_image_acquire_buffer(sima, &lock);
+	ImBuf *ibuf;
 	/* XXX performance regression if name of scopes category changes! */
 	PanelCategoryStack *category = UI_panel_category_active_find(ar, "Scopes");
 
-	/* only update scopes if scope category is active */
+	/* only update scopes if scope category is active, the buffer is
+	 * only acquired then, so tiled images don't load all pixels */
 	if (category) {
+		ibuf = ED_space_image_acquire_buffer(sima, &lock);
 		if (ibuf) {
 			if (!sima->scopes.ok) {
 				BKE_histogram_update_sample_line(&sima->sample_line_hist, ibuf, &scene->view_settings, &scene->display_settings);
@@ -912,9 +925,9 @@ static void image_tools_region_draw(const bContext *C, ARegion *ar)
 			else
 				ED_space_image_scopes_update(C, sima, ibuf, false);
 		}
+		ED_space_image_release_buffer(sima, ibuf, lock);
 	}
-	ED_space_image_release_buffer(sima, ibuf, lock);
-	
+
 	ED_region_panels(C, ar, NULL, -1, true);
 }
 
@@ -57,6 +57,7 @@
 #include "RNA_define.h"
 
 #include "ED_node.h"
+#include "ED_screen.h"
 
 #include "WM_api.h"
 #include "WM_types.h"
@@ -1362,6 +1363,9 @@ static void node_composit_buts_blur(uiLayout *layout, bContext *UNUSED(C), Point
 		uiItemR(col, ptr, "use_variable_size", 0, NULL, ICON_NONE);
 		if (!reference) {
 			uiItemR(col, ptr, "use_bokeh", 0, NULL, ICON_NONE);
+			if (filter == R_FILTER_GAUSS) {
+				uiItemR(col, ptr, "use_recursive", 0, NULL, ICON_NONE);
+			}
 		}
 		uiItemR(col, ptr, "use_gamma_correction", 0, NULL, ICON_NONE);
 	}
@@ -3336,6 +3340,11 @@ void draw_nodespace_back_pix(const bContext *C, ARegion *ar, SpaceNode *snode, b
 			}
 		}
 		
+		/* panned or zoomed to a part of the viewer that isn't calculated, refresh runs the compositor */
+		if (ED_node_composite_viewer_outdated(CTX_data_scene(C), CTX_wm_area(C))) {
+			ED_area_tag_refresh(CTX_wm_area(C));
+		}
+		
 		glMatrixMode(GL_PROJECTION);
 		glPopMatrix();
 		glMatrixMode(GL_MODELVIEW);
@@ -49,6 +49,7 @@
 #include "BKE_node.h"
 #include "BKE_report.h"
 #include "BKE_scene.h"
+#include "BKE_screen.h"
 
 #include "RE_engine.h"
 #include "RE_pipeline.h"
@@ -147,6 +148,132 @@ static int compo_get_recalc_flags(const bContext *C)
 	return recalc_flags;
 }
 
+/* part of the viewer image that stays calculated around the visible part, so small pans don't restart compositing */
+#define VIEWER_REGION_MARGIN 0.1f
+
+/* normalized part of the viewer image visible in an image editor or node editor backdrop,
+ * returns false when the area doesn't show the viewer */
+static bool compo_viewer_visible_rect(ScrArea *sa, ImBuf *ibuf, rctf *r_rect, float *r_zoom)
+{
+	ARegion *ar = BKE_area_find_region_type(sa, RGN_TYPE_WINDOW);
+	rctf rect, image;
+
+	if (ar == NULL) {
+		return false;
+	}
+
+	if (sa->spacetype == SPACE_IMAGE) {
+		SpaceImage *sima = sa->spacedata.first;
+		if (sima->image == NULL || sima->image->type != IMA_TYPE_COMPOSITE) {
+			return false;
+		}
+		/* the image editor keeps its view in normalized image coordinates */
+		rect = ar->v2d.cur;
+		*r_zoom = sima->zoom;
+	}
+	else if (sa->spacetype == SPACE_NODE) {
+		SpaceNode *snode = sa->spacedata.first;
+		if (!(snode->flag & SNODE_BACKDRAW) || !ED_node_is_compositor(snode)) {
+			return false;
+		}
+		if (ibuf && ibuf->x > 0 && ibuf->y > 0 && snode->zoom > 0.0f) {
+			/* inverse of the backdrop placement in draw_nodespace_back_pix */
+			const float bufx = ibuf->x * snode->zoom;
+			const float bufy = ibuf->y * snode->zoom;
+			rect.xmin = (-0.5f * ar->winx - snode->xof) / bufx + 0.5f;
+			rect.xmax = (0.5f * ar->winx - snode->xof) / bufx + 0.5f;
+			rect.ymin = (-0.5f * ar->winy - snode->yof) / bufy + 0.5f;
+			rect.ymax = (0.5f * ar->winy - snode->yof) / bufy + 0.5f;
+		}
+		else {
+			BLI_rctf_init(&rect, 0.0f, 1.0f, 0.0f, 1.0f);
+		}
+		*r_zoom = snode->zoom;
+	}
+	else {
+		return false;
+	}
+
+	/* not drawn yet, the whole image can become visible */
+	if (!(rect.xmin < rect.xmax && rect.ymin < rect.ymax)) {
+		BLI_rctf_init(&rect, 0.0f, 1.0f, 0.0f, 1.0f);
+	}
+
+	BLI_rctf_init(&image, 0.0f, 1.0f, 0.0f, 1.0f);
+	return BLI_rctf_isect(&image, &rect, r_rect);
+}
+
+/* union of the parts of the viewer visible in all editors, with a margin */
+static void compo_get_viewer_region(const bContext *C, rctf *r_region, float *r_zoom)
+{
+	wmWindowManager *wm = CTX_wm_manager(C);
+	wmWindow *win;
+	Image *ima = BKE_image_verify_viewer(IMA_TYPE_COMPOSITE, "Viewer Node");
+	void *lock;
+	ImBuf *ibuf = BKE_image_acquire_ibuf(ima, NULL, &lock);
+	bool found = false;
+
+	BLI_rctf_init(r_region, 0.0f, 0.0f, 0.0f, 0.0f);
+	*r_zoom = 0.0f;
+
+	for (win = wm->windows.first; win; win = win->next) {
+		ScrArea *sa;
+
+		for (sa = win->screen->areabase.first; sa; sa = sa->next) {
+			rctf rect;
+			float zoom;
+
+			if (compo_viewer_visible_rect(sa, ibuf, &rect, &zoom)) {
+				if (found) {
+					BLI_rctf_union(r_region, &rect);
+				}
+				else {
+					*r_region = rect;
+					found = true;
+				}
+				*r_zoom = max_ff(*r_zoom, zoom);
+			}
+		}
+	}
+
+	BKE_image_release_ibuf(ima, ibuf, lock);
+
+	if (found) {
+		rctf image;
+		BLI_rctf_init(&image, 0.0f, 1.0f, 0.0f, 1.0f);
+		BLI_rctf_scale(r_region, 1.0f + 2.0f * VIEWER_REGION_MARGIN);
+		BLI_rctf_isect(&image, r_region, r_region);
+	}
+}
+
+/**
+ * Check whether the area shows a part of the viewer that the last compositing job didn't calculate,
+ * only used when the tree calculates the visible region of the viewer (#NTREE_VIEWER_REGION).
+ */
+bool ED_node_composite_viewer_outdated(Scene *scene, ScrArea *sa)
+{
+	bNodeTree *ntree = scene->nodetree;
+	Image *ima;
+	void *lock;
+	ImBuf *ibuf;
+	rctf rect;
+	float zoom;
+	bool outdated = false;
+
+	if (ntree == NULL || !scene->use_nodes || !(ntree->flag & NTREE_VIEWER_REGION)) {
+		return false;
+	}
+
+	ima = BKE_image_verify_viewer(IMA_TYPE_COMPOSITE, "Viewer Node");
+	ibuf = BKE_image_acquire_ibuf(ima, NULL, &lock);
+	if (compo_viewer_visible_rect(sa, ibuf, &rect, &zoom)) {
+		outdated = !BLI_rctf_inside_rctf(&ntree->viewer_region, &rect);
+	}
+	BKE_image_release_ibuf(ima, ibuf, lock);
+
+	return outdated;
+}
+
 /* called by compo, only to check job 'stop' value */
 static int compo_breakjob(void *cjv)
 {
@@ -288,6 +415,11 @@ void ED_node_composite_job(const bContext *C, struct bNodeTree *nodetree, Scene
 	cj->ntree = nodetree;
 	cj->recalc_flags = compo_get_recalc_flags(C);
 
+	/* the localized tree copies the region for the compositor */
+	if (nodetree->flag & NTREE_VIEWER_REGION) {
+		compo_get_viewer_region(C, &nodetree->viewer_region, &nodetree->viewer_zoom);
+	}
+
 	/* setup job */
 	WM_jobs_customdata_set(wm_job, cj, compo_freejob);
 	WM_jobs_timer(wm_job, 0.1, NC_SCENE | ND_COMPO_RESULT, NC_SCENE | ND_COMPO_RESULT);
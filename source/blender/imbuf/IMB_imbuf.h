@@ -168,6 +168,14 @@ struct ImBuf *IMB_makeSingleUser(struct ImBuf *ibuf);
  */
 struct ImBuf *IMB_dupImBuf(struct ImBuf *ibuf1);
 
+/**
+ * Renew the change stamp of the buffer, call after modifying its pixels.
+ * Users that keep results derived from a buffer compare stamps instead of pixels.
+ *
+ * \attention Defined in allocimbuf.c
+ */
+void IMB_tag_changed(struct ImBuf *ibuf);
+
 /**
  *
  * \attention Defined in allocimbuf.c
@@ -360,8 +368,12 @@ struct ImBuf *IMB_getmipmap(struct ImBuf *ibuf, int level);
  */
 
 void IMB_tile_cache_params(int totthread, int maxmem);
+void IMB_tile_cache_set_limit(int maxmem);
 unsigned int *IMB_gettile(struct ImBuf *ibuf, int tx, int ty, int thread);
+float *IMB_tile_cache_acquire_float(struct ImBuf *ibuf, int tx, int ty);
+void IMB_tile_cache_release(struct ImBuf *ibuf, int tx, int ty);
 void IMB_tiles_to_rect(struct ImBuf *ibuf);
+struct ImBuf *IMB_tiles_load_full(struct ImBuf *ibuf);
 
 /**
  *
@@ -590,6 +602,7 @@ void imb_freerectfloatImBuf(struct ImBuf *ibuf);
 void imb_freemipmapImBuf(struct ImBuf *ibuf);
 
 bool imb_addtilesImBuf(struct ImBuf *ibuf);
+bool imb_addtilesfloatImBuf(struct ImBuf *ibuf);
 void imb_freetilesImBuf(struct ImBuf *ibuf);
 
 /* threaded processors */
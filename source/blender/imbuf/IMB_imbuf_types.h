@@ -177,6 +177,8 @@ typedef struct ImBuf {
 	int tilex, tiley;
 	int xtiles, ytiles;
 	unsigned int **tiles;
+	float **tiles_float;	/* RGBA float tiles, used instead of tiles for float images */
+	void *tile_file;		/* open file the float tiles are read from, shared by the mipmap levels */
 
 	/* zbuffer */
 	int	*zbuf;				/* z buffer data, original zbuffer */
@@ -192,6 +194,7 @@ typedef struct ImBuf {
 	/* externally used data */
 	int index;						/* reference index for ImBuf lists */
 	int	userflags;					/* used to set imbuf to dirty and other stuff */
+	unsigned int changestamp;		/* unique per allocation and pixel change, see IMB_tag_changed */
 	struct IDProperty *metadata;	/* image metadata */
 	void *userdata;					/* temporary storage */
 
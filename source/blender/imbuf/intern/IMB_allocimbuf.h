@@ -37,6 +37,7 @@ struct ImBuf;
 
 void imb_refcounter_lock_init(void);
 void imb_refcounter_lock_exit(void);
+bool imb_is_single_user(struct ImBuf *ibuf);
 
 #ifdef WIN32
 void imb_mmap_lock_init(void);
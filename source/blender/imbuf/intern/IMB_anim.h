@@ -100,8 +100,12 @@
 
 #define MAXNUMSTREAMS       50
 
+/* number of reusable frame buffers per ffmpeg anim: the frame last fetched and the one decoded ahead */
+#define FFMPEG_FRAME_RING_SIZE  2
+
 struct _AviMovie;
 struct anim_index;
+struct TaskPool;
 
 struct anim {
 	int ib_flags;
@@ -160,6 +164,14 @@ struct anim {
 	int64_t last_pts;
 	int64_t next_pts;
 	AVPacket next_packet;
+
+	/* Frames are converted into a ring of reusable buffers, the frame following
+	 * last_frame is decoded and converted ahead in decode_pool. */
+	struct ImBuf *frame_ring[FFMPEG_FRAME_RING_SIZE];
+	int frame_ring_next;
+	struct ImBuf *decode_ahead_frame;
+	struct TaskPool *decode_pool;
+	int decoder_threads;
 #endif
 
 	char index_dir[768];
@@ -49,6 +49,11 @@ typedef struct ImFileType {
 	int flag;
 	int filetype;
 	int default_save_role;
+
+	/* float tiles are read from a file kept open with the image */
+	void (*load_tile_float)(struct ImBuf *ibuf, int tx, int ty, float *rect);
+	bool (*open_tile_file)(struct ImBuf *ibuf);
+	void (*close_tile_file)(struct ImBuf *ibuf);
 } ImFileType;
 
 extern const ImFileType IMB_FILE_TYPES[];
@@ -61,7 +66,10 @@ void imb_tile_cache_init(void);
 void imb_tile_cache_exit(void);
 
 void imb_loadtile(struct ImBuf *ibuf, int tx, int ty, unsigned int *rect);
-void imb_tile_cache_tile_free(struct ImBuf *ibuf, int tx, int ty);
+void imb_loadtile_float(struct ImBuf *ibuf, int tx, int ty, float *rect);
+bool imb_tile_file_open(struct ImBuf *ibuf);
+void imb_tile_file_close(struct ImBuf *ibuf);
+void imb_tile_cache_ibuf_free(struct ImBuf *ibuf);
 
 /* Type Specific Functions */
 
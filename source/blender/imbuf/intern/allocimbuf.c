@@ -50,8 +50,13 @@
 #include "BLI_utildefines.h"
 #include "BLI_threads.h"
 
+#include "atomic_ops.h"
+
 static SpinLock refcounter_spin;
 
+/* last stamp handed out, 0 is never used */
+static unsigned int changestamp_last = 0;
+
 void imb_refcounter_lock_init(void)
 {
 	BLI_spin_init(&refcounter_spin);
@@ -134,24 +139,32 @@ void imb_freerectImBuf(ImBuf *ibuf)
 
 void imb_freetilesImBuf(ImBuf *ibuf)
 {
-	int tx, ty;
+	int a;
 
 	if (ibuf == NULL) return;
 
-	if (ibuf->tiles && (ibuf->mall & IB_tiles)) {
-		for (ty = 0; ty < ibuf->ytiles; ty++) {
-			for (tx = 0; tx < ibuf->xtiles; tx++) {
-				if (ibuf->tiles[ibuf->xtiles * ty + tx]) {
-					imb_tile_cache_tile_free(ibuf, tx, ty);
-					MEM_freeN(ibuf->tiles[ibuf->xtiles * ty + tx]);
-				}
-			}
+	if ((ibuf->tiles || ibuf->tiles_float) && (ibuf->mall & IB_tiles)) {
+		/* unloads the tiles the cache owns */
+		imb_tile_cache_ibuf_free(ibuf);
+
+		for (a = 0; a < ibuf->xtiles * ibuf->ytiles; a++) {
+			if (ibuf->tiles)
+				MEM_SAFE_FREE(ibuf->tiles[a]);
+			if (ibuf->tiles_float)
+				MEM_SAFE_FREE(ibuf->tiles_float[a]);
 		}
 
-		MEM_freeN(ibuf->tiles);
+		MEM_SAFE_FREE(ibuf->tiles);
+		MEM_SAFE_FREE(ibuf->tiles_float);
 	}
 
+	/* the file is shared with the mipmap levels, which are freed first */
+	if (ibuf->tile_file && ibuf->miplevel == 0)
+		imb_tile_file_close(ibuf);
+
 	ibuf->tiles = NULL;
+	ibuf->tiles_float = NULL;
+	ibuf->tile_file = NULL;
 	ibuf->mall &= ~IB_tiles;
 }
 
@@ -237,16 +250,24 @@ void IMB_refImBuf(ImBuf *ibuf)
 	BLI_spin_unlock(&refcounter_spin);
 }
 
+/* Reads the reference count under the lock, other threads may be releasing their references. */
+bool imb_is_single_user(ImBuf *ibuf)
+{
+	bool is_single;
+
+	BLI_spin_lock(&refcounter_spin);
+	is_single = (ibuf->refcounter == 0);
+	BLI_spin_unlock(&refcounter_spin);
+
+	return is_single;
+}
+
 ImBuf *IMB_makeSingleUser(ImBuf *ibuf)
 {
 	ImBuf *rval;
 
 	if (ibuf) {
-		bool is_single;
-		BLI_spin_lock(&refcounter_spin);
-		is_single = (ibuf->refcounter == 0);
-		BLI_spin_unlock(&refcounter_spin);
-		if (is_single) {
+		if (imb_is_single_user(ibuf)) {
 			return ibuf;
 		}
 	}
@@ -445,6 +466,18 @@ bool imb_addtilesImBuf(ImBuf *ibuf)
 	return (ibuf->tiles != NULL);
 }
 
+/* float tiles are RGBA, tilex * tiley * 4 floats each */
+bool imb_addtilesfloatImBuf(ImBuf *ibuf)
+{
+	if (ibuf == NULL) return false;
+
+	if (!ibuf->tiles_float)
+		if ((ibuf->tiles_float = MEM_callocN(sizeof(float *) * ibuf->xtiles * ibuf->ytiles, "imb_tiles_float")))
+			ibuf->mall |= IB_tiles;
+
+	return (ibuf->tiles_float != NULL);
+}
+
 ImBuf *IMB_allocImBuf(unsigned int x, unsigned int y, uchar planes, unsigned int flags)
 {
 	ImBuf *ibuf;
@@ -502,9 +535,16 @@ bool IMB_initImBuf(struct ImBuf *ibuf,
 	/* assign default spaces */
 	colormanage_imbuf_set_default_spaces(ibuf);
 
+	IMB_tag_changed(ibuf);
+
 	return true;
 }
 
+void IMB_tag_changed(ImBuf *ibuf)
+{
+	ibuf->changestamp = atomic_add_and_fetch_uint32(&changestamp_last, 1);
+}
+
 /* does no zbuffers? */
 ImBuf *IMB_dupImBuf(ImBuf *ibuf1)
 {
@@ -557,6 +597,9 @@ ImBuf *IMB_dupImBuf(ImBuf *ibuf1)
 	tbuf.encodedbuffer = ibuf2->encodedbuffer;
 	tbuf.zbuf          = ibuf2->zbuf;
 	tbuf.zbuf_float    = ibuf2->zbuf_float;
+	tbuf.tiles         = NULL;
+	tbuf.tiles_float   = NULL;
+	tbuf.tile_file     = NULL;
 	for (a = 0; a < IMB_MIPMAP_LEVELS; a++)
 		tbuf.mipmap[a] = NULL;
 	tbuf.dds_data.data = NULL;
@@ -565,6 +608,7 @@ ImBuf *IMB_dupImBuf(ImBuf *ibuf1)
 	tbuf.mall               = ibuf2->mall;
 	tbuf.c_handle           = NULL;
 	tbuf.refcounter         = 0;
+	tbuf.changestamp        = ibuf2->changestamp;
 
 	/* for now don't duplicate metadata */
 	tbuf.metadata = NULL;
@@ -67,6 +67,8 @@
 #include "BLI_utildefines.h"
 #include "BLI_string.h"
 #include "BLI_path_util.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
 
 #include "MEM_guardedalloc.h"
 
@@ -90,6 +92,7 @@
 
 #include "IMB_anim.h"
 #include "IMB_indexer.h"
+#include "IMB_allocimbuf.h"
 
 #ifdef WITH_FFMPEG
 #  include <libavformat/avformat.h>
@@ -448,6 +451,37 @@ BLI_INLINE bool need_aligned_ffmpeg_buffer(struct anim *anim)
 	return (anim->x & 31) != 0;
 }
 
+/* Decoder threads of all open movies. Every movie opened with frame threading
+ * would otherwise start a thread per core, the movies share the cores instead. */
+static ThreadMutex ffmpeg_decoder_threads_mutex = BLI_MUTEX_INITIALIZER;
+static int ffmpeg_decoder_threads_used = 0;
+
+static int ffmpeg_decoder_threads_acquire(void)
+{
+	const int threads_max = BLI_system_thread_count();
+	int threads;
+
+	BLI_mutex_lock(&ffmpeg_decoder_threads_mutex);
+	/* at most half of the cores, so a second movie (a cross fade) gets the other half,
+	 * decoding on the calling thread only once all are taken */
+	threads = MIN2(threads_max - ffmpeg_decoder_threads_used, MAX2(threads_max / 2, 1));
+	threads = MAX2(threads, 1);
+	ffmpeg_decoder_threads_used += threads;
+	BLI_mutex_unlock(&ffmpeg_decoder_threads_mutex);
+
+	return threads;
+}
+
+static void ffmpeg_decoder_threads_release(struct anim *anim)
+{
+	if (anim->decoder_threads) {
+		BLI_mutex_lock(&ffmpeg_decoder_threads_mutex);
+		ffmpeg_decoder_threads_used -= anim->decoder_threads;
+		BLI_mutex_unlock(&ffmpeg_decoder_threads_mutex);
+		anim->decoder_threads = 0;
+	}
+}
+
 static int startffmpeg(struct anim *anim)
 {
 	int i, videoStream;
@@ -512,7 +546,14 @@ static int startffmpeg(struct anim *anim)
 
 	pCodecCtx->workaround_bugs = 1;
 
+	/* Intra-only codecs (ProRes, DNxHD, MJPEG) decode much faster with frame threading,
+	 * codecs not supporting it fall back to slice threading. */
+	anim->decoder_threads = ffmpeg_decoder_threads_acquire();
+	pCodecCtx->thread_count = anim->decoder_threads;
+	pCodecCtx->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+
 	if (avcodec_open2(pCodecCtx, pCodec, NULL) < 0) {
+		ffmpeg_decoder_threads_release(anim);
 		avformat_close_input(&pFormatCtx);
 		return -1;
 	}
@@ -572,6 +613,7 @@ static int startffmpeg(struct anim *anim)
 
 		if (av_frame_get_buffer(anim->pFrameRGB, 32) < 0) {
 			fprintf(stderr, "Could not allocate frame data.\n");
+			ffmpeg_decoder_threads_release(anim);
 			avcodec_close(anim->pCodecCtx);
 			avformat_close_input(&anim->pFormatCtx);
 			av_frame_free(&anim->pFrameRGB);
@@ -587,6 +629,7 @@ static int startffmpeg(struct anim *anim)
 	{
 		fprintf(stderr,
 		        "ffmpeg has changed alloc scheme ... ARGHHH!\n");
+		ffmpeg_decoder_threads_release(anim);
 		avcodec_close(anim->pCodecCtx);
 		avformat_close_input(&anim->pFormatCtx);
 		av_frame_free(&anim->pFrameRGB);
@@ -628,6 +671,7 @@ static int startffmpeg(struct anim *anim)
 	if (!anim->img_convert_ctx) {
 		fprintf(stderr,
 		        "Can't transform color space??? Bailing out...\n");
+		ffmpeg_decoder_threads_release(anim);
 		avcodec_close(anim->pCodecCtx);
 		avformat_close_input(&anim->pFormatCtx);
 		av_frame_free(&anim->pFrameRGB);
@@ -662,17 +706,16 @@ static int startffmpeg(struct anim *anim)
 /* postprocess the image in anim->pFrame and do color conversion
  * and deinterlacing stuff.
  *
- * Output is anim->last_frame
+ * Output is ibuf, returns false if there was no frame to convert.
  */
 
-static void ffmpeg_postprocess(struct anim *anim)
+static bool ffmpeg_postprocess(struct anim *anim, ImBuf *ibuf)
 {
 	AVFrame *input = anim->pFrame;
-	ImBuf *ibuf = anim->last_frame;
 	int filter_y = 0;
 
 	if (!anim->pFrameComplete) {
-		return;
+		return false;
 	}
 
 	/* This means the data wasnt read properly, 
@@ -682,7 +725,7 @@ static void ffmpeg_postprocess(struct anim *anim)
 	{
 		fprintf(stderr, "ffmpeg_fetchibuf: "
 		        "data not read properly...\n");
-		return;
+		return false;
 	}
 
 	av_log(anim->pFormatCtx, AV_LOG_DEBUG, 
@@ -790,6 +833,8 @@ static void ffmpeg_postprocess(struct anim *anim)
 	if (filter_y) {
 		IMB_filtery(ibuf);
 	}
+
+	return true;
 }
 
 /* decode one video frame also considering the packet read into next_packet */
@@ -800,6 +845,9 @@ static int ffmpeg_decode_video_frame(struct anim *anim)
 
 	av_log(anim->pFormatCtx, AV_LOG_DEBUG, "  DECODE VIDEO FRAME\n");
 
+	/* pFrame is about to change, a frame converted ahead is no longer valid. */
+	anim->decode_ahead_frame = NULL;
+
 	if (anim->next_packet.stream_index == anim->videoStream) {
 		av_free_packet(&anim->next_packet);
 		anim->next_packet.stream_index = -1;
@@ -973,6 +1021,115 @@ static int ffmpeg_seek_by_byte(AVFormatContext *pFormatCtx)
 	return false;
 }
 
+/* A ring frame can be reused once nothing but the ring references it and its
+ * users did not attach any derived data to it. Other threads may be releasing
+ * their references, the count is read under the lock. Once it's zero no one
+ * else can change the buffer, only the ring hands it out. */
+static bool ffmpeg_frame_ring_can_reuse(struct anim *anim, ImBuf *ibuf)
+{
+	return (ibuf != anim->last_frame &&
+	        ibuf != anim->decode_ahead_frame &&
+	        imb_is_single_user(ibuf) &&
+	        ibuf->x == anim->x && ibuf->y == anim->y &&
+	        ibuf->rect != NULL && ibuf->rect_float == NULL &&
+	        ibuf->zbuf == NULL && ibuf->zbuf_float == NULL &&
+	        ibuf->mipmap[0] == NULL && ibuf->tiles == NULL &&
+	        ibuf->metadata == NULL && ibuf->userdata == NULL &&
+	        ibuf->c_handle == NULL && ibuf->encodedbuffer == NULL);
+}
+
+static ImBuf *ffmpeg_frame_ring_alloc(struct anim *anim)
+{
+	ImBuf *ibuf = IMB_allocImBuf(anim->x, anim->y, 32, IB_rect);
+	ibuf->rect_colorspace = colormanage_colorspace_get_named(anim->colorspace);
+	return ibuf;
+}
+
+/* Get a buffer to convert pFrame into, the ring keeps its own reference. */
+static ImBuf *ffmpeg_frame_ring_acquire(struct anim *anim)
+{
+	ImBuf *ibuf;
+	int i;
+
+	for (i = 0; i < FFMPEG_FRAME_RING_SIZE; i++) {
+		if (anim->frame_ring[i] == NULL) {
+			anim->frame_ring[i] = ffmpeg_frame_ring_alloc(anim);
+			return anim->frame_ring[i];
+		}
+	}
+
+	for (i = 0; i < FFMPEG_FRAME_RING_SIZE; i++) {
+		ibuf = anim->frame_ring[i];
+		if (ffmpeg_frame_ring_can_reuse(anim, ibuf)) {
+			/* Display buffers belong to the previous frame. */
+			colormanage_cache_free(ibuf);
+			ibuf->userflags = 0;
+			ibuf->colormanage_flag = 0;
+			ibuf->planes = 32;
+			ibuf->rect_colorspace = colormanage_colorspace_get_named(anim->colorspace);
+			return ibuf;
+		}
+	}
+
+	/* All frames are still in use elsewhere (in caches for example), hand the
+	 * oldest one over to its users and start a new buffer in its slot. */
+	do {
+		i = anim->frame_ring_next;
+		anim->frame_ring_next = (anim->frame_ring_next + 1) % FFMPEG_FRAME_RING_SIZE;
+	} while (ELEM(anim->frame_ring[i], anim->last_frame, anim->decode_ahead_frame));
+
+	IMB_freeImBuf(anim->frame_ring[i]);
+	anim->frame_ring[i] = ffmpeg_frame_ring_alloc(anim);
+	return anim->frame_ring[i];
+}
+
+static void ffmpeg_frame_ring_free(struct anim *anim)
+{
+	int i;
+
+	for (i = 0; i < FFMPEG_FRAME_RING_SIZE; i++) {
+		IMB_freeImBuf(anim->frame_ring[i]);
+		anim->frame_ring[i] = NULL;
+	}
+	anim->frame_ring_next = 0;
+	anim->last_frame = NULL;
+	anim->decode_ahead_frame = NULL;
+}
+
+/* Decode and convert the frame following last_frame, so sequential playback
+ * only has to wait for the decoder when it is slower than the caller. */
+static void ffmpeg_decode_ahead_task(TaskPool * __restrict pool, void *UNUSED(taskdata), int UNUSED(threadid))
+{
+	struct anim *anim = BLI_task_pool_userdata(pool);
+	ImBuf *ibuf;
+
+	ffmpeg_decode_video_frame(anim);
+
+	if (anim->pFrameComplete) {
+		ibuf = ffmpeg_frame_ring_acquire(anim);
+		if (ffmpeg_postprocess(anim, ibuf)) {
+			anim->decode_ahead_frame = ibuf;
+		}
+	}
+}
+
+static void ffmpeg_decode_ahead_start(struct anim *anim)
+{
+	if (anim->decode_pool == NULL) {
+		anim->decode_pool = BLI_task_pool_create(BLI_task_scheduler_get(), anim);
+	}
+
+	BLI_task_pool_push(anim->decode_pool, ffmpeg_decode_ahead_task, NULL, false, TASK_PRIORITY_HIGH);
+}
+
+/* Must be called before touching any decoder state. */
+static void ffmpeg_decode_ahead_wait(struct anim *anim)
+{
+	if (anim->decode_pool) {
+		BLI_task_pool_work_and_wait(anim->decode_pool);
+	}
+}
+
 static ImBuf *ffmpeg_fetchibuf(struct anim *anim, int position,
                                IMB_Timecode_Type tc)
 {
@@ -984,9 +1141,13 @@ static ImBuf *ffmpeg_fetchibuf(struct anim *anim, int position,
 	AVStream *v_st;
 	int new_frame_index = 0; /* To quiet gcc barking... */
 	int old_frame_index = 0; /* To quiet gcc barking... */
+	bool is_sequential;
 
 	if (anim == NULL) return (0);
 
+	ffmpeg_decode_ahead_wait(anim);
+	is_sequential = (position == anim->curposition + 1);
+
 	av_log(anim->pFormatCtx, AV_LOG_DEBUG, "FETCH: pos=%d\n", position);
 
 	if (tc != IMB_TC_NONE) {
@@ -1035,6 +1196,11 @@ static ImBuf *ffmpeg_fetchibuf(struct anim *anim, int position,
 		return anim->last_frame;
 	}
 	 
+	if (!is_sequential) {
+		/* the frame decoded ahead isn't the one asked for, its buffer stays in the ring */
+		anim->decode_ahead_frame = NULL;
+	}
+
 	if (position > anim->curposition + 1 &&
 	    anim->preseek &&
 	    !tc_index &&
@@ -1144,20 +1310,36 @@ static ImBuf *ffmpeg_fetchibuf(struct anim *anim, int position,
 		       "FETCH: no seek necessary, just continue...\n");
 	}
 
-	IMB_freeImBuf(anim->last_frame);
-	anim->last_frame = IMB_allocImBuf(anim->x, anim->y, 32, IB_rect);
-	anim->last_frame->rect_colorspace = colormanage_colorspace_get_named(anim->colorspace);
+	if (anim->decode_ahead_frame) {
+		av_log(anim->pFormatCtx, AV_LOG_DEBUG,
+		       "FETCH: using frame decoded ahead\n");
+		anim->last_frame = anim->decode_ahead_frame;
+		anim->decode_ahead_frame = NULL;
+	}
+	else {
+		/* Clear first so the previous frame can be reused if its users released it. */
+		anim->last_frame = NULL;
+		anim->last_frame = ffmpeg_frame_ring_acquire(anim);
 
-	ffmpeg_postprocess(anim);
+		if (!ffmpeg_postprocess(anim, anim->last_frame)) {
+			/* Don't show whatever a reused buffer contained before. */
+			memset(anim->last_frame->rect, 0, sizeof(*anim->last_frame->rect) * anim->x * anim->y);
+		}
+	}
 
 	anim->last_pts = anim->next_pts;
-	
-	ffmpeg_decode_video_frame(anim);
-	
 	anim->curposition = position;
-	
+
 	IMB_refImBuf(anim->last_frame);
 
+	if (is_sequential) {
+		/* Playback, get the next frame ready in the background. */
+		ffmpeg_decode_ahead_start(anim);
+	}
+	else {
+		ffmpeg_decode_video_frame(anim);
+	}
+
 	return anim->last_frame;
 }
 
@@ -1165,9 +1347,16 @@ static void free_anim_ffmpeg(struct anim *anim)
 {
 	if (anim == NULL) return;
 
+	if (anim->decode_pool) {
+		BLI_task_pool_work_and_wait(anim->decode_pool);
+		BLI_task_pool_free(anim->decode_pool);
+		anim->decode_pool = NULL;
+	}
+
 	if (anim->pCodecCtx) {
 		avcodec_close(anim->pCodecCtx);
 		avformat_close_input(&anim->pFormatCtx);
+		ffmpeg_decoder_threads_release(anim);
 
 		/* Special case here: pFrame could share pointers with codec,
 		 * so in order to avoid double-free we don't use av_frame_free()
@@ -1191,7 +1380,7 @@ static void free_anim_ffmpeg(struct anim *anim)
 		av_frame_free(&anim->pFrameDeinterlaced);
 
 		sws_freeContext(anim->img_convert_ctx);
-		IMB_freeImBuf(anim->last_frame);
+		ffmpeg_frame_ring_free(anim);
 		if (anim->next_packet.stream_index != -1) {
 			av_free_packet(&anim->next_packet);
 		}
@@ -22,14 +22,21 @@
  *  \ingroup imbuf
  */
 
+#include <stdio.h>
+
 #include "MEM_guardedalloc.h"
 
 #include "BLI_utildefines.h"
+#include "BLI_fileops.h"
 #include "BLI_ghash.h"
 #include "BLI_listbase.h"
 #include "BLI_memarena.h"
+#include "BLI_path_util.h"
+#include "BLI_string.h"
 #include "BLI_threads.h"
 
+#include "BKE_appdir.h"
+
 #include "IMB_imbuf.h"
 #include "IMB_imbuf_types.h"
 #include "IMB_filetype.h"
@@ -43,10 +50,24 @@
  *
  * The per-thread cache should be big enough that one might hope to not fall
  * back to the global cache every pixel, but not to big to keep too many tiles
- * locked and using memory. */
+ * locked and using memory.
+ *
+ * The global cache list is kept in least recently used order, with the most
+ * recently used tile at the head. When loading a tile would exceed the memory
+ * budget, unreferenced tiles are unloaded from the tail until it fits. The
+ * budget is separate from the memory cache limiter of the sequencer and movie
+ * clips, it's set with IMB_tile_cache_set_limit (user preference).
+ *
+ * Unloaded float tiles are written to a scratch file in the session temporary
+ * directory, reading them back is much cheaper than decoding them from the
+ * compressed image again. The scratch file is limited to a multiple of the
+ * budget, slots of tiles that got loaded again are reused. */
 
 #define IB_THREAD_CACHE_SIZE    100
 
+/* size of the scratch file, relative to the memory budget */
+#define IB_SCRATCH_BUDGET_FACTOR    4
+
 typedef struct ImGlobalTile {
 	struct ImGlobalTile *next, *prev;
 
@@ -71,6 +92,17 @@ typedef struct ImThreadTileCache {
 	GHash *tilehash;
 } ImThreadTileCache;
 
+/* tile stored in the scratch file, or a free slot in it */
+typedef struct ImScratchTile {
+	struct ImScratchTile *next, *prev;
+
+	ImBuf *ibuf;
+	int tx, ty;
+
+	int64_t offset;
+	size_t size;
+} ImScratchTile;
+
 typedef struct ImGlobalTileCache {
 	ListBase tiles;
 	ListBase unused;
@@ -79,6 +111,14 @@ typedef struct ImGlobalTileCache {
 	MemArena *memarena;
 	uintptr_t totmem, maxmem;
 
+	/* unloaded tiles */
+	FILE *scratch_file;
+	char scratch_filepath[FILE_MAX];
+	GHash *scratchhash;
+	ListBase scratch_free;
+	int64_t scratch_size;
+	bool scratch_failed;
+
 	ImThreadTileCache thread_cache[BLENDER_MAX_THREADS + 1];
 	int totthread;
 
@@ -89,6 +129,9 @@ typedef struct ImGlobalTileCache {
 
 static ImGlobalTileCache GLOBAL_CACHE;
 
+/* budget set with IMB_tile_cache_set_limit, kept when the cache is reset */
+static uintptr_t tile_cache_limit = 0;
+
 /***************************** Hash Functions ********************************/
 
 static unsigned int imb_global_tile_hash(const void *gtile_p)
@@ -125,17 +168,196 @@ static bool imb_thread_tile_cmp(const void *a_p, const void *b_p)
 	        (a->ty != b->ty));
 }
 
+static unsigned int imb_scratch_tile_hash(const void *stile_p)
+{
+	const ImScratchTile *stile = stile_p;
+
+	return ((unsigned int)(intptr_t)stile->ibuf) * 769 + stile->tx * 53 + stile->ty * 97;
+}
+
+static bool imb_scratch_tile_cmp(const void *a_p, const void *b_p)
+{
+	const ImScratchTile *a = a_p;
+	const ImScratchTile *b = b_p;
+
+	return ((a->ibuf != b->ibuf) ||
+	        (a->tx != b->tx) ||
+	        (a->ty != b->ty));
+}
+
+/******************************* Scratch File ********************************/
+
+static void imb_scratch_error(const char *what)
+{
+	/* report once, tiles are loaded from the image file again instead */
+	if (!GLOBAL_CACHE.scratch_failed)
+		fprintf(stderr, "Image tile cache: can't %s scratch file %s\n", what, GLOBAL_CACHE.scratch_filepath);
+
+	GLOBAL_CACHE.scratch_failed = true;
+}
+
+static bool imb_scratch_ensure(void)
+{
+	char filename[FILE_MAXFILE];
+
+	if (GLOBAL_CACHE.scratch_file)
+		return true;
+	if (GLOBAL_CACHE.scratch_failed)
+		return false;
+
+	BLI_snprintf(filename, sizeof(filename), "image_tiles_%p.tmp", (void *)&GLOBAL_CACHE);
+	BLI_join_dirfile(GLOBAL_CACHE.scratch_filepath, sizeof(GLOBAL_CACHE.scratch_filepath),
+	                 BKE_tempdir_session(), filename);
+
+	GLOBAL_CACHE.scratch_file = BLI_fopen(GLOBAL_CACHE.scratch_filepath, "w+b");
+	if (GLOBAL_CACHE.scratch_file == NULL) {
+		imb_scratch_error("create");
+		return false;
+	}
+
+	return true;
+}
+
+static void imb_scratch_slot_free(ImScratchTile *stile)
+{
+	stile->ibuf = NULL;
+	BLI_addtail(&GLOBAL_CACHE.scratch_free, stile);
+}
+
+/* writes an unloaded tile to the scratch file, called with the mutex locked */
+static void imb_scratch_tile_write(ImBuf *ibuf, int tx, int ty, const float *rect)
+{
+	ImScratchTile *stile;
+	const size_t size = sizeof(float) * 4 * ibuf->tilex * ibuf->tiley;
+
+	if (!imb_scratch_ensure())
+		return;
+
+	/* reuse a free slot of the same size, tiles of one image are all the same size */
+	for (stile = GLOBAL_CACHE.scratch_free.first; stile; stile = stile->next)
+		if (stile->size == size)
+			break;
+
+	if (stile) {
+		BLI_remlink(&GLOBAL_CACHE.scratch_free, stile);
+	}
+	else {
+		if (GLOBAL_CACHE.scratch_size + (int64_t)size > (int64_t)(IB_SCRATCH_BUDGET_FACTOR * GLOBAL_CACHE.maxmem))
+			return;
+
+		stile = MEM_callocN(sizeof(ImScratchTile), "ImScratchTile");
+		stile->offset = GLOBAL_CACHE.scratch_size;
+		stile->size = size;
+		GLOBAL_CACHE.scratch_size += size;
+	}
+
+	if (BLI_fseek(GLOBAL_CACHE.scratch_file, stile->offset, SEEK_SET) != 0 ||
+	    fwrite(rect, 1, size, GLOBAL_CACHE.scratch_file) != size)
+	{
+		imb_scratch_error("write to");
+		imb_scratch_slot_free(stile);
+		return;
+	}
+
+	stile->ibuf = ibuf;
+	stile->tx = tx;
+	stile->ty = ty;
+	BLI_ghash_insert(GLOBAL_CACHE.scratchhash, stile, stile);
+}
+
+/* reads a tile back from the scratch file and frees its slot, called with the mutex locked,
+ * returns NULL when the tile isn't in the scratch file */
+static float *imb_scratch_tile_read(ImBuf *ibuf, int tx, int ty)
+{
+	ImScratchTile *stile, lookuptile;
+	float *rect;
+
+	if (GLOBAL_CACHE.scratchhash == NULL)
+		return NULL;
+
+	lookuptile.ibuf = ibuf;
+	lookuptile.tx = tx;
+	lookuptile.ty = ty;
+	stile = BLI_ghash_popkey(GLOBAL_CACHE.scratchhash, &lookuptile, NULL);
+
+	if (stile == NULL)
+		return NULL;
+
+	rect = MEM_mallocN(stile->size, "imb_tile_float");
+
+	if (BLI_fseek(GLOBAL_CACHE.scratch_file, stile->offset, SEEK_SET) != 0 ||
+	    fread(rect, 1, stile->size, GLOBAL_CACHE.scratch_file) != stile->size)
+	{
+		imb_scratch_error("read from");
+		MEM_SAFE_FREE(rect);
+	}
+
+	imb_scratch_slot_free(stile);
+
+	return rect;
+}
+
+/* forget the unloaded tile of a freed image, called with the mutex locked */
+static void imb_scratch_tile_discard(ImBuf *ibuf, int tx, int ty)
+{
+	ImScratchTile *stile, lookuptile;
+
+	if (GLOBAL_CACHE.scratchhash == NULL)
+		return;
+
+	lookuptile.ibuf = ibuf;
+	lookuptile.tx = tx;
+	lookuptile.ty = ty;
+	stile = BLI_ghash_popkey(GLOBAL_CACHE.scratchhash, &lookuptile, NULL);
+
+	if (stile)
+		imb_scratch_slot_free(stile);
+}
+
+static void imb_scratch_exit(void)
+{
+	if (GLOBAL_CACHE.scratchhash)
+		BLI_ghash_free(GLOBAL_CACHE.scratchhash, NULL, MEM_freeN);
+	BLI_freelistN(&GLOBAL_CACHE.scratch_free);
+
+	if (GLOBAL_CACHE.scratch_file) {
+		fclose(GLOBAL_CACHE.scratch_file);
+		BLI_delete(GLOBAL_CACHE.scratch_filepath, false, false);
+	}
+}
+
 /******************************** Load/Unload ********************************/
 
-static void imb_global_cache_tile_load(ImGlobalTile *gtile)
+static size_t imb_tile_memsize(const ImBuf *ibuf)
+{
+	if (ibuf->tiles_float)
+		return sizeof(float) * 4 * ibuf->tilex * ibuf->tiley;
+	else
+		return sizeof(unsigned int) * ibuf->tilex * ibuf->tiley;
+}
+
+static void imb_global_cache_tile_load(ImGlobalTile *gtile, float *rect_scratch)
 {
 	ImBuf *ibuf = gtile->ibuf;
 	int toffs = ibuf->xtiles * gtile->ty + gtile->tx;
-	unsigned int *rect;
 
-	rect = MEM_callocN(sizeof(unsigned int) * ibuf->tilex * ibuf->tiley, "imb_tile");
-	imb_loadtile(ibuf, gtile->tx, gtile->ty, rect);
-	ibuf->tiles[toffs] = rect;
+	if (rect_scratch) {
+		ibuf->tiles_float[toffs] = rect_scratch;
+	}
+	else if (ibuf->tiles_float) {
+		float *rect_float;
+
+		rect_float = MEM_callocN(imb_tile_memsize(ibuf), "imb_tile_float");
+		imb_loadtile_float(ibuf, gtile->tx, gtile->ty, rect_float);
+		ibuf->tiles_float[toffs] = rect_float;
+	}
+	else {
+		unsigned int *rect;
+
+		rect = MEM_callocN(imb_tile_memsize(ibuf), "imb_tile");
+		imb_loadtile(ibuf, gtile->tx, gtile->ty, rect);
+		ibuf->tiles[toffs] = rect;
+	}
 }
 
 static void imb_global_cache_tile_unload(ImGlobalTile *gtile)
@@ -143,32 +365,74 @@ static void imb_global_cache_tile_unload(ImGlobalTile *gtile)
 	ImBuf *ibuf = gtile->ibuf;
 	int toffs = ibuf->xtiles * gtile->ty + gtile->tx;
 
-	MEM_freeN(ibuf->tiles[toffs]);
-	ibuf->tiles[toffs] = NULL;
+	if (ibuf->tiles_float)
+		MEM_SAFE_FREE(ibuf->tiles_float[toffs]);
+	else
+		MEM_SAFE_FREE(ibuf->tiles[toffs]);
 
-	GLOBAL_CACHE.totmem -= sizeof(unsigned int) * ibuf->tilex * ibuf->tiley;
+	GLOBAL_CACHE.totmem -= imb_tile_memsize(ibuf);
 }
 
-/* external free */
-void imb_tile_cache_tile_free(ImBuf *ibuf, int tx, int ty)
+/* unload least recently used tiles until a tile of the given size fits in the budget */
+static void imb_global_cache_evict(size_t tilemem)
+{
+	ImGlobalTile *gtile, *gtile_prev;
+	const uintptr_t maxmem = GLOBAL_CACHE.maxmem;
+
+	if (maxmem == 0)
+		return;
+
+	for (gtile = GLOBAL_CACHE.tiles.last; gtile; gtile = gtile_prev) {
+		if (GLOBAL_CACHE.totmem + tilemem <= maxmem)
+			break;
+
+		gtile_prev = gtile->prev;
+
+		if (gtile->refcount == 0 && gtile->loading == 0) {
+			ImBuf *ibuf = gtile->ibuf;
+
+			if (ibuf->tiles_float)
+				imb_scratch_tile_write(ibuf, gtile->tx, gtile->ty, ibuf->tiles_float[ibuf->xtiles * gtile->ty + gtile->tx]);
+
+			imb_global_cache_tile_unload(gtile);
+			BLI_ghash_remove(GLOBAL_CACHE.tilehash, gtile, NULL, NULL);
+			BLI_remlink(&GLOBAL_CACHE.tiles, gtile);
+			BLI_addtail(&GLOBAL_CACHE.unused, gtile);
+		}
+	}
+}
+
+/* external free, of all tiles of an image that is freed */
+void imb_tile_cache_ibuf_free(ImBuf *ibuf)
 {
 	ImGlobalTile *gtile, lookuptile;
+	int tx, ty;
 
-	BLI_mutex_lock(&GLOBAL_CACHE.mutex);
+	if (!GLOBAL_CACHE.initialized)
+		return;
 
-	lookuptile.ibuf = ibuf;
-	lookuptile.tx = tx;
-	lookuptile.ty = ty;
-	gtile = BLI_ghash_lookup(GLOBAL_CACHE.tilehash, &lookuptile);
+	BLI_mutex_lock(&GLOBAL_CACHE.mutex);
 
-	if (gtile) {
-		/* in case another thread is loading this */
-		while (gtile->loading)
-			;
+	for (ty = 0; ty < ibuf->ytiles; ty++) {
+		for (tx = 0; tx < ibuf->xtiles; tx++) {
+			lookuptile.ibuf = ibuf;
+			lookuptile.tx = tx;
+			lookuptile.ty = ty;
+			gtile = BLI_ghash_lookup(GLOBAL_CACHE.tilehash, &lookuptile);
+
+			if (gtile) {
+				/* in case another thread is loading this */
+				while (gtile->loading)
+					;
+
+				imb_global_cache_tile_unload(gtile);
+				BLI_ghash_remove(GLOBAL_CACHE.tilehash, gtile, NULL, NULL);
+				BLI_remlink(&GLOBAL_CACHE.tiles, gtile);
+				BLI_addtail(&GLOBAL_CACHE.unused, gtile);
+			}
 
-		BLI_ghash_remove(GLOBAL_CACHE.tilehash, gtile, NULL, NULL);
-		BLI_remlink(&GLOBAL_CACHE.tiles, gtile);
-		BLI_addtail(&GLOBAL_CACHE.unused, gtile);
+			imb_scratch_tile_discard(ibuf, tx, ty);
+		}
 	}
 
 	BLI_mutex_unlock(&GLOBAL_CACHE.mutex);
@@ -206,8 +470,6 @@ void imb_tile_cache_init(void)
 	/* initialize for one thread, for places that access textures
 	 * outside of rendering (displace modifier, painting, ..) */
 	IMB_tile_cache_params(0, 0);
-
-	GLOBAL_CACHE.initialized = 1;
 }
 
 void imb_tile_cache_exit(void)
@@ -228,22 +490,26 @@ void imb_tile_cache_exit(void)
 		if (GLOBAL_CACHE.tilehash)
 			BLI_ghash_free(GLOBAL_CACHE.tilehash, NULL, NULL);
 
+		imb_scratch_exit();
+
 		BLI_mutex_end(&GLOBAL_CACHE.mutex);
 
 		memset(&GLOBAL_CACHE, 0, sizeof(ImGlobalTileCache));
 	}
 }
 
-/* presumed to be called when no threads are running */
+/* presumed to be called when no threads are running, maxmem in megabytes,
+ * 0 keeps the limit set with IMB_tile_cache_set_limit */
 void IMB_tile_cache_params(int totthread, int maxmem)
 {
+	const uintptr_t maxmem_bytes = maxmem ? (uintptr_t)maxmem * 1024 * 1024 : tile_cache_limit;
 	int a;
 
 	/* always one cache for non-threaded access */
 	totthread++;
 
 	/* lazy initialize cache */
-	if (GLOBAL_CACHE.totthread == totthread && GLOBAL_CACHE.maxmem == maxmem)
+	if (GLOBAL_CACHE.totthread == totthread && GLOBAL_CACHE.maxmem == maxmem_bytes)
 		return;
 
 	imb_tile_cache_exit();
@@ -255,13 +521,31 @@ void IMB_tile_cache_params(int totthread, int maxmem)
 	GLOBAL_CACHE.memarena = BLI_memarena_new(BLI_MEMARENA_STD_BUFSIZE, "ImTileCache arena");
 	BLI_memarena_use_calloc(GLOBAL_CACHE.memarena);
 
-	GLOBAL_CACHE.maxmem = maxmem * 1024 * 1024;
+	GLOBAL_CACHE.scratchhash = BLI_ghash_new(imb_scratch_tile_hash, imb_scratch_tile_cmp, "tile_cache_params scratch gh");
+
+	GLOBAL_CACHE.maxmem = maxmem_bytes;
 
 	GLOBAL_CACHE.totthread = totthread;
 	for (a = 0; a < totthread; a++)
 		imb_thread_cache_init(&GLOBAL_CACHE.thread_cache[a]);
 
 	BLI_mutex_init(&GLOBAL_CACHE.mutex);
+
+	GLOBAL_CACHE.initialized = 1;
+}
+
+/* memory budget of the cache in megabytes, 0 for unlimited, can be called while tiles are in use */
+void IMB_tile_cache_set_limit(int maxmem)
+{
+	tile_cache_limit = (uintptr_t)maxmem * 1024 * 1024;
+
+	if (!GLOBAL_CACHE.initialized)
+		return;
+
+	BLI_mutex_lock(&GLOBAL_CACHE.mutex);
+	GLOBAL_CACHE.maxmem = tile_cache_limit;
+	imb_global_cache_evict(0);
+	BLI_mutex_unlock(&GLOBAL_CACHE.mutex);
 }
 
 /***************************** Global Cache **********************************/
@@ -287,37 +571,36 @@ static ImGlobalTile *imb_global_cache_get_tile(ImBuf *ibuf, int tx, int ty, ImGl
 		 * for the other thread to load the tile */
 		gtile->refcount++;
 
+		/* keep least recently used order */
+		if (GLOBAL_CACHE.tiles.first != gtile) {
+			BLI_remlink(&GLOBAL_CACHE.tiles, gtile);
+			BLI_addhead(&GLOBAL_CACHE.tiles, gtile);
+		}
+
 		BLI_mutex_unlock(&GLOBAL_CACHE.mutex);
 
 		while (gtile->loading)
 			;
 	}
 	else {
-		/* not found, let's load it from disk */
+		/* not found, let's load it from the scratch file or from disk */
 
-		/* first check if we hit the memory limit */
-		if (GLOBAL_CACHE.maxmem && GLOBAL_CACHE.totmem > GLOBAL_CACHE.maxmem) {
-			/* find an existing tile to unload */
-			for (gtile = GLOBAL_CACHE.tiles.last; gtile; gtile = gtile->prev)
-				if (gtile->refcount == 0 && gtile->loading == 0)
-					break;
-		}
+		const size_t tilemem = imb_tile_memsize(ibuf);
+		float *rect_scratch = NULL;
 
-		if (gtile) {
-			/* found a tile to unload */
-			imb_global_cache_tile_unload(gtile);
-			BLI_ghash_remove(GLOBAL_CACHE.tilehash, gtile, NULL, NULL);
-			BLI_remlink(&GLOBAL_CACHE.tiles, gtile);
-		}
-		else {
-			/* allocate a new tile or reuse unused */
-			if (GLOBAL_CACHE.unused.first) {
-				gtile = GLOBAL_CACHE.unused.first;
-				BLI_remlink(&GLOBAL_CACHE.unused, gtile);
-			}
-			else
-				gtile = BLI_memarena_alloc(GLOBAL_CACHE.memarena, sizeof(ImGlobalTile));
+		/* first make room if we would hit the memory limit */
+		imb_global_cache_evict(tilemem);
+
+		if (ibuf->tiles_float)
+			rect_scratch = imb_scratch_tile_read(ibuf, tx, ty);
+
+		/* allocate a new tile or reuse unused */
+		if (GLOBAL_CACHE.unused.first) {
+			gtile = GLOBAL_CACHE.unused.first;
+			BLI_remlink(&GLOBAL_CACHE.unused, gtile);
 		}
+		else
+			gtile = BLI_memarena_alloc(GLOBAL_CACHE.memarena, sizeof(ImGlobalTile));
 
 		/* setup new tile */
 		gtile->ibuf = ibuf;
@@ -330,12 +613,12 @@ static ImGlobalTile *imb_global_cache_get_tile(ImBuf *ibuf, int tx, int ty, ImGl
 		BLI_addhead(&GLOBAL_CACHE.tiles, gtile);
 
 		/* mark as being loaded and unlock to allow other threads to load too */
-		GLOBAL_CACHE.totmem += sizeof(unsigned int) * ibuf->tilex * ibuf->tiley;
+		GLOBAL_CACHE.totmem += tilemem;
 
 		BLI_mutex_unlock(&GLOBAL_CACHE.mutex);
 
 		/* load from disk */
-		imb_global_cache_tile_load(gtile);
+		imb_global_cache_tile_load(gtile, rect_scratch);
 
 		/* mark as done loading */
 		gtile->loading = 0;
@@ -346,17 +629,17 @@ static ImGlobalTile *imb_global_cache_get_tile(ImBuf *ibuf, int tx, int ty, ImGl
 
 /***************************** Per-Thread Cache ******************************/
 
-static unsigned int *imb_thread_cache_get_tile(ImThreadTileCache *cache, ImBuf *ibuf, int tx, int ty)
+/* ensures the tile is loaded, it stays loaded while in the thread cache */
+static void imb_thread_cache_acquire_tile(ImThreadTileCache *cache, ImBuf *ibuf, int tx, int ty)
 {
 	ImThreadTile *ttile, lookuptile;
 	ImGlobalTile *gtile, *replacetile;
-	int toffs = ibuf->xtiles * ty + tx;
 
 	/* test if it is already in our thread local cache */
 	if ((ttile = cache->tiles.first)) {
 		/* check last used tile before going to hash */
 		if (ttile->ibuf == ibuf && ttile->tx == tx && ttile->ty == ty)
-			return ibuf->tiles[toffs];
+			return;
 
 		/* find tile in hash */
 		lookuptile.ibuf = ibuf;
@@ -367,7 +650,7 @@ static unsigned int *imb_thread_cache_get_tile(ImThreadTileCache *cache, ImBuf *
 			BLI_remlink(&cache->tiles, ttile);
 			BLI_addhead(&cache->tiles, ttile);
 
-			return ibuf->tiles[toffs];
+			return;
 		}
 	}
 
@@ -393,28 +676,109 @@ static unsigned int *imb_thread_cache_get_tile(ImThreadTileCache *cache, ImBuf *
 	ttile->tx = gtile->tx;
 	ttile->ty = gtile->ty;
 	ttile->global = gtile;
-
-	return ibuf->tiles[toffs];
 }
 
 unsigned int *IMB_gettile(ImBuf *ibuf, int tx, int ty, int thread)
 {
-	return imb_thread_cache_get_tile(&GLOBAL_CACHE.thread_cache[thread + 1], ibuf, tx, ty);
+	imb_thread_cache_acquire_tile(&GLOBAL_CACHE.thread_cache[thread + 1], ibuf, tx, ty);
+
+	return ibuf->tiles[ibuf->xtiles * ty + tx];
+}
+
+/* references a tile for access outside of the per-thread caches, like drawing,
+ * the tile stays loaded until released with IMB_tile_cache_release */
+float *IMB_tile_cache_acquire_float(ImBuf *ibuf, int tx, int ty)
+{
+	imb_global_cache_get_tile(ibuf, tx, ty, NULL);
+
+	return ibuf->tiles_float[ibuf->xtiles * ty + tx];
+}
+
+void IMB_tile_cache_release(ImBuf *ibuf, int tx, int ty)
+{
+	ImGlobalTile *gtile, lookuptile;
+
+	BLI_mutex_lock(&GLOBAL_CACHE.mutex);
+
+	lookuptile.ibuf = ibuf;
+	lookuptile.tx = tx;
+	lookuptile.ty = ty;
+	gtile = BLI_ghash_lookup(GLOBAL_CACHE.tilehash, &lookuptile);
+
+	BLI_assert(gtile && gtile->refcount > 0);
+	if (gtile)
+		gtile->refcount--;
+
+	BLI_mutex_unlock(&GLOBAL_CACHE.mutex);
+}
+
+/* copy all tiles of one level into rect or rect_float, which must be allocated */
+static void imb_tiles_copy_to_rect(ImBuf *tilebuf, unsigned int *rect, float *rect_float)
+{
+	ImGlobalTile *gtile;
+	int tx, ty, y, w, h;
+
+	for (ty = 0; ty < tilebuf->ytiles; ty++) {
+		for (tx = 0; tx < tilebuf->xtiles; tx++) {
+			/* acquire tile through cache, this assumes cache is initialized,
+			 * which it is always now but it's a weak assumption ... */
+			gtile = imb_global_cache_get_tile(tilebuf, tx, ty, NULL);
+
+			/* exception in tile width/height for tiles at end of image */
+			w = (tx == tilebuf->xtiles - 1) ? tilebuf->x - tx * tilebuf->tilex : tilebuf->tilex;
+			h = (ty == tilebuf->ytiles - 1) ? tilebuf->y - ty * tilebuf->tiley : tilebuf->tiley;
+
+			if (tilebuf->tiles_float) {
+				const float *from = tilebuf->tiles_float[tilebuf->xtiles * ty + tx];
+				float *to = rect_float + 4 * ((size_t)tilebuf->x * ty * tilebuf->tiley + tx * tilebuf->tilex);
+
+				for (y = 0; y < h; y++) {
+					memcpy(to, from, sizeof(float) * 4 * w);
+					from += 4 * tilebuf->tilex;
+					to += 4 * tilebuf->x;
+				}
+			}
+			else {
+				const unsigned int *from = tilebuf->tiles[tilebuf->xtiles * ty + tx];
+				unsigned int *to = rect + (size_t)tilebuf->x * ty * tilebuf->tiley + tx * tilebuf->tilex;
+
+				for (y = 0; y < h; y++) {
+					memcpy(to, from, sizeof(unsigned int) * w);
+					from += tilebuf->tilex;
+					to += tilebuf->x;
+				}
+			}
+
+			/* decrease refcount for tile again */
+			BLI_mutex_lock(&GLOBAL_CACHE.mutex);
+			gtile->refcount--;
+			BLI_mutex_unlock(&GLOBAL_CACHE.mutex);
+		}
+	}
 }
 
 void IMB_tiles_to_rect(ImBuf *ibuf)
 {
 	ImBuf *mipbuf;
-	ImGlobalTile *gtile;
-	unsigned int *to, *from;
-	int a, tx, ty, y, w, h;
+	int a;
 
 	for (a = 0; a < ibuf->miptot; a++) {
 		mipbuf = IMB_getmipmap(ibuf, a);
 
 		/* don't call imb_addrectImBuf, it frees all mipmaps */
-		if (!mipbuf->rect) {
-			if ((mipbuf->rect = MEM_mapallocN(ibuf->x * ibuf->y * sizeof(unsigned int), "imb_addrectImBuf"))) {
+		if (mipbuf->tiles_float) {
+			if (!mipbuf->rect_float) {
+				if ((mipbuf->rect_float = MEM_mapallocN(sizeof(float) * 4 * mipbuf->x * mipbuf->y, "imb_addrectfloatImBuf"))) {
+					mipbuf->mall |= IB_rectfloat;
+					mipbuf->flags |= IB_rectfloat;
+					mipbuf->channels = 4;
+				}
+				else
+					break;
+			}
+		}
+		else if (!mipbuf->rect) {
+			if ((mipbuf->rect = MEM_mapallocN(sizeof(unsigned int) * mipbuf->x * mipbuf->y, "imb_addrectImBuf"))) {
 				mipbuf->mall |= IB_rect;
 				mipbuf->flags |= IB_rect;
 			}
@@ -422,32 +786,36 @@ void IMB_tiles_to_rect(ImBuf *ibuf)
 				break;
 		}
 
-		for (ty = 0; ty < mipbuf->ytiles; ty++) {
-			for (tx = 0; tx < mipbuf->xtiles; tx++) {
-				/* acquire tile through cache, this assumes cache is initialized,
-				 * which it is always now but it's a weak assumption ... */
-				gtile = imb_global_cache_get_tile(mipbuf, tx, ty, NULL);
-
-				/* setup pointers */
-				from = mipbuf->tiles[mipbuf->xtiles * ty + tx];
-				to = mipbuf->rect + mipbuf->x * ty * mipbuf->tiley + tx * mipbuf->tilex;
-
-				/* exception in tile width/height for tiles at end of image */
-				w = (tx == mipbuf->xtiles - 1) ? mipbuf->x - tx * mipbuf->tilex : mipbuf->tilex;
-				h = (ty == mipbuf->ytiles - 1) ? mipbuf->y - ty * mipbuf->tiley : mipbuf->tiley;
-
-				for (y = 0; y < h; y++) {
-					memcpy(to, from, sizeof(unsigned int) * w);
-					from += mipbuf->tilex;
-					to += mipbuf->x;
-				}
-
-				/* decrease refcount for tile again */
-				BLI_mutex_lock(&GLOBAL_CACHE.mutex);
-				gtile->refcount--;
-				BLI_mutex_unlock(&GLOBAL_CACHE.mutex);
-			}
-		}
+		imb_tiles_copy_to_rect(mipbuf, mipbuf->rect, mipbuf->rect_float);
 	}
 }
 
+/* new image with the full resolution pixels of a tile cached image, for code
+ * that needs all pixels at once (painting, baking, saving) */
+ImBuf *IMB_tiles_load_full(ImBuf *ibuf)
+{
+	ImBuf *ibuf_full;
+
+	if (!ibuf->tiles && !ibuf->tiles_float)
+		return NULL;
+
+	ibuf_full = IMB_allocImBuf(ibuf->x, ibuf->y, ibuf->planes, ibuf->tiles_float ? IB_rectfloat : IB_rect);
+	if (ibuf_full == NULL)
+		return NULL;
+
+	imb_tiles_copy_to_rect(ibuf, ibuf_full->rect, ibuf_full->rect_float);
+
+	ibuf_full->flags |= ibuf->flags & (IB_alphamode_premul | IB_ignore_alpha | IB_metadata);
+	ibuf_full->ftype = ibuf->ftype;
+	ibuf_full->foptions = ibuf->foptions;
+	ibuf_full->ppm[0] = ibuf->ppm[0];
+	ibuf_full->ppm[1] = ibuf->ppm[1];
+	ibuf_full->rect_colorspace = ibuf->rect_colorspace;
+	ibuf_full->float_colorspace = ibuf->float_colorspace;
+	ibuf_full->colormanage_flag = ibuf->colormanage_flag & IMB_COLORMANAGE_IS_DATA;
+	BLI_strncpy(ibuf_full->name, ibuf->name, sizeof(ibuf_full->name));
+	BLI_strncpy(ibuf_full->cachename, ibuf->cachename, sizeof(ibuf_full->cachename));
+	IMB_metadata_copy(ibuf_full, ibuf);
+
+	return ibuf_full;
+}
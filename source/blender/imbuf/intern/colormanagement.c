@@ -55,6 +55,7 @@
 #include "BLI_math.h"
 #include "BLI_math_color.h"
 #include "BLI_string.h"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 #include "BLI_rect.h"
 
@@ -106,6 +107,9 @@ typedef struct ColormanageProcessor {
 	OCIO_ConstProcessorRcPtr *processor;
 	CurveMapping *curve_mapping;
 	bool is_data_result;
+
+	/* processor cache entry owning the processor */
+	struct CachedProcessor *cached;
 } ColormanageProcessor;
 
 static struct global_glsl_state {
@@ -444,6 +448,159 @@ static void colormanage_cache_handle_release(void *cache_handle)
 	IMB_freeImBuf(cache_ibuf);
 }
 
+/*********************** Processor cache *************************/
+
+/* Creating an OCIO processor builds and optimizes the whole transform chain,
+ * which is far more expensive than applying it to a tile of pixels. Display
+ * buffer updates create processors for every redraw and byte buffers used to
+ * create one for every slice of a threaded conversion, so processors are kept
+ * in a small LRU cache keyed by their settings and shared between users.
+ *
+ * The same cache mechanism keeps baked display LUTs, see display_lut_acquire().
+ */
+
+#define PROCESSOR_CACHE_KEY_SIZE (6 * MAX_COLORSPACE_NAME + 64)
+#define PROCESSOR_CACHE_MAX_PROCESSORS 16
+#define PROCESSOR_CACHE_MAX_LUTS 4
+
+typedef struct CachedProcessor {
+	struct CachedProcessor *next, *prev;
+
+	char key[PROCESSOR_CACHE_KEY_SIZE];
+	int users;
+
+	OCIO_ConstProcessorRcPtr *processor;
+	float *lut;
+} CachedProcessor;
+
+typedef struct ProcessorCache {
+	ListBase entries;  /* most recently used first */
+	int tot_entries;
+	int max_entries;
+} ProcessorCache;
+
+/* protected by processor_lock */
+static ProcessorCache global_processor_cache = {{NULL, NULL}, 0, PROCESSOR_CACHE_MAX_PROCESSORS};
+static ProcessorCache global_display_lut_cache = {{NULL, NULL}, 0, PROCESSOR_CACHE_MAX_LUTS};
+
+static void processor_cache_entry_free(CachedProcessor *entry)
+{
+	if (entry->processor)
+		OCIO_processorRelease(entry->processor);
+	if (entry->lut)
+		MEM_freeN(entry->lut);
+
+	MEM_freeN(entry);
+}
+
+/* processor_lock is to be held by caller */
+static CachedProcessor *processor_cache_lookup(ProcessorCache *cache, const char *key)
+{
+	CachedProcessor *entry;
+
+	for (entry = cache->entries.first; entry; entry = entry->next) {
+		if (STREQ(entry->key, key)) {
+			if (entry != cache->entries.first) {
+				BLI_remlink(&cache->entries, entry);
+				BLI_addhead(&cache->entries, entry);
+			}
+
+			entry->users++;
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+/* Get cached entry for the given key, NULL if it's not cached yet.
+ * Returned entry is to be released with processor_cache_release().
+ */
+static CachedProcessor *processor_cache_acquire(ProcessorCache *cache, const char *key)
+{
+	CachedProcessor *entry;
+
+	BLI_mutex_lock(&processor_lock);
+	entry = processor_cache_lookup(cache, key);
+	BLI_mutex_unlock(&processor_lock);
+
+	return entry;
+}
+
+/* Add newly created processor and/or LUT to the cache, cache takes ownership of them.
+ * Creation happens without the lock held, so if another thread was faster the
+ * given data is freed and entry created by that thread is used instead.
+ */
+static CachedProcessor *processor_cache_add(ProcessorCache *cache, const char *key,
+                                            OCIO_ConstProcessorRcPtr *processor, float *lut)
+{
+	CachedProcessor *entry, *entry_evict;
+
+	BLI_mutex_lock(&processor_lock);
+
+	entry = processor_cache_lookup(cache, key);
+
+	if (entry) {
+		if (processor)
+			OCIO_processorRelease(processor);
+		if (lut)
+			MEM_freeN(lut);
+	}
+	else {
+		entry = MEM_callocN(sizeof(CachedProcessor), "cached colormanagement processor");
+		BLI_strncpy(entry->key, key, sizeof(entry->key));
+		entry->processor = processor;
+		entry->lut = lut;
+		entry->users = 1;
+
+		BLI_addhead(&cache->entries, entry);
+		cache->tot_entries++;
+
+		/* evict least recently used entries nobody is using at the moment */
+		entry_evict = cache->entries.last;
+		while (entry_evict && cache->tot_entries > cache->max_entries) {
+			CachedProcessor *entry_prev = entry_evict->prev;
+
+			if (entry_evict->users == 0) {
+				BLI_remlink(&cache->entries, entry_evict);
+				processor_cache_entry_free(entry_evict);
+				cache->tot_entries--;
+			}
+
+			entry_evict = entry_prev;
+		}
+	}
+
+	BLI_mutex_unlock(&processor_lock);
+
+	return entry;
+}
+
+static void processor_cache_release(CachedProcessor *entry)
+{
+	BLI_mutex_lock(&processor_lock);
+
+	BLI_assert(entry->users > 0);
+	entry->users--;
+
+	BLI_mutex_unlock(&processor_lock);
+}
+
+static void processor_cache_clear(ProcessorCache *cache)
+{
+	CachedProcessor *entry, *entry_next;
+
+	for (entry = cache->entries.first; entry; entry = entry_next) {
+		entry_next = entry->next;
+
+		BLI_assert(entry->users == 0);
+		processor_cache_entry_free(entry);
+	}
+
+	BLI_listbase_clear(&cache->entries);
+	cache->tot_entries = 0;
+}
+
 /*********************** Initialization / De-initialization *************************/
 
 static void colormanage_role_color_space_name_get(OCIO_ConstConfigRcPtr *config, char *colorspace_name, const char *role, const char *backup_role)
@@ -609,6 +766,10 @@ static void colormanage_free_config(void)
 	BLI_freelistN(&global_looks);
 	global_tot_looks = 0;
 
+	/* free cached processors */
+	processor_cache_clear(&global_processor_cache);
+	processor_cache_clear(&global_display_lut_cache);
+
 	OCIO_exit();
 }
 
@@ -1235,10 +1396,154 @@ const char *IMB_colormanagement_get_rect_colorspace(ImBuf *ibuf)
 	}
 }
 
+/*********************** Baked display transform *************************/
+
+/* Byte buffers only have 256^3 distinct colors, so instead of passing every pixel
+ * through the byte -> scene linear -> display chain of OCIO transforms the chain
+ * is evaluated once on a regular grid and then trilinearly interpolated.
+ *
+ * With 65^3 samples the interpolation error of the shipped view transforms stays
+ * well below the precision of the resulting 8 bit display buffer (about 0.15 of a
+ * level for tone mapping curves on top of sRGB). It is only used for on-screen
+ * display buffers, images which are saved or passed on to the render pipeline
+ * always go through the exact transform.
+ */
+
+#define DISPLAY_LUT_SIZE 65
+/* smaller buffers are cheaper to transform directly than to bake the LUT for */
+#define DISPLAY_LUT_MIN_PIXELS (DISPLAY_LUT_SIZE * DISPLAY_LUT_SIZE * DISPLAY_LUT_SIZE)
+
+typedef struct DisplayLUTBakeData {
+	ColormanageProcessor *cm_processor;
+	const char *from_colorspace;
+	float *lut;
+} DisplayLUTBakeData;
+
+static void display_lut_bake_slice(void *userdata, const int b)
+{
+	DisplayLUTBakeData *data = (DisplayLUTBakeData *) userdata;
+	const int size = DISPLAY_LUT_SIZE;
+	float *slice = data->lut + ((size_t)b) * size * size * 3;
+	float *fp = slice;
+	int r, g;
+
+	for (g = 0; g < size; g++) {
+		for (r = 0; r < size; r++, fp += 3) {
+			fp[0] = (float)r / (size - 1);
+			fp[1] = (float)g / (size - 1);
+			fp[2] = (float)b / (size - 1);
+		}
+	}
+
+	IMB_colormanagement_transform(slice, size * size, 1, 3,
+	                              data->from_colorspace, global_role_scene_linear, false);
+	IMB_colormanagement_processor_apply(data->cm_processor, slice, size * size, 1, 3, false);
+}
+
+/* Get LUT baked for display processor applied on top of byte buffer in from_colorspace,
+ * baking it if it's not in the cache yet.
+ */
+static CachedProcessor *display_lut_acquire(ColormanageProcessor *cm_processor, const char *from_colorspace)
+{
+	CachedProcessor *entry;
+	char key[PROCESSOR_CACHE_KEY_SIZE];
+
+	BLI_snprintf(key, sizeof(key), "%s|%s", cm_processor->cached->key, from_colorspace);
+
+	entry = processor_cache_acquire(&global_display_lut_cache, key);
+
+	if (entry == NULL) {
+		const size_t lut_size = ((size_t)DISPLAY_LUT_SIZE) * DISPLAY_LUT_SIZE * DISPLAY_LUT_SIZE * 3;
+		DisplayLUTBakeData data;
+
+		data.cm_processor = cm_processor;
+		data.from_colorspace = from_colorspace;
+		data.lut = MEM_mallocN(lut_size * sizeof(float), "display transform LUT");
+
+		BLI_task_parallel_range(0, DISPLAY_LUT_SIZE, &data, display_lut_bake_slice, true);
+
+		entry = processor_cache_add(&global_display_lut_cache, key, NULL, data.lut);
+	}
+
+	return entry;
+}
+
+static void display_lut_apply_byte(const float *lut, const unsigned char *byte_buffer, float *linear_buffer,
+                                   size_t totpixel, int channels)
+{
+	const int size = DISPLAY_LUT_SIZE;
+	const size_t offset_g = ((size_t)size) * 3;
+	const size_t offset_b = ((size_t)size) * size * 3;
+	const unsigned char *cp;
+	float *fp;
+	int index[256];
+	float weight[256];
+	size_t i;
+
+	/* grid cell and position inside of it for every byte value */
+	for (i = 0; i < 256; i++) {
+		const float f = (float)i * (size - 1) / 255.0f;
+		const int j = min_ii((int)f, size - 2);
+
+		index[i] = j;
+		weight[i] = f - j;
+	}
+
+	for (i = 0, fp = linear_buffer, cp = byte_buffer;
+	     i != totpixel;
+	     i++, fp += channels, cp += channels)
+	{
+		const float fr = weight[cp[0]], fg = weight[cp[1]], fb = weight[cp[2]];
+		const float *c000 = lut + 3 * ((((size_t)index[cp[2]]) * size + index[cp[1]]) * size + index[cp[0]]);
+		const float *c010 = c000 + offset_g;
+		const float *c001 = c000 + offset_b;
+		const float *c011 = c010 + offset_b;
+		int k;
+
+		for (k = 0; k < 3; k++) {
+			const float c00 = c000[k] + fr * (c000[k + 3] - c000[k]);
+			const float c10 = c010[k] + fr * (c010[k + 3] - c010[k]);
+			const float c01 = c001[k] + fr * (c001[k + 3] - c001[k]);
+			const float c11 = c011[k] + fr * (c011[k + 3] - c011[k]);
+			const float c0 = c00 + fg * (c10 - c00);
+			const float c1 = c01 + fg * (c11 - c01);
+
+			fp[k] = c0 + fb * (c1 - c0);
+		}
+
+		if (channels == 4)
+			fp[3] = ((float)cp[3]) * (1.0f / 255.0f);
+	}
+}
+
+/* check whether byte -> display conversion of the whole buffer could go via baked LUT */
+static bool display_buffer_use_lut(const ImBuf *ibuf, const float *buffer, const unsigned char *byte_buffer,
+                                   const ColormanageProcessor *cm_processor)
+{
+	if (cm_processor == NULL || cm_processor->cached == NULL)
+		return false;
+
+	/* curves are not part of the OCIO processor and not baked */
+	if (cm_processor->curve_mapping || cm_processor->is_data_result)
+		return false;
+
+	if (buffer != NULL || byte_buffer == NULL)
+		return false;
+
+	if (ibuf->colormanage_flag & IMB_COLORMANAGE_IS_DATA)
+		return false;
+
+	if (!ELEM(ibuf->channels, 3, 4))
+		return false;
+
+	return ((size_t)ibuf->x) * ibuf->y >= DISPLAY_LUT_MIN_PIXELS;
+}
+
 /*********************** Threaded display buffer transform routines *************************/
 
 typedef struct DisplayBufferThread {
 	ColormanageProcessor *cm_processor;
+	const float *display_lut;
 
 	const float *buffer;
 	unsigned char *byte_buffer;
@@ -1261,6 +1566,7 @@ typedef struct DisplayBufferThread {
 typedef struct DisplayBufferInitData {
 	ImBuf *ibuf;
 	ColormanageProcessor *cm_processor;
+	const float *display_lut;
 	const float *buffer;
 	unsigned char *byte_buffer;
 
@@ -1289,6 +1595,7 @@ static void display_buffer_init_handle(void *handle_v, int start_line, int tot_l
 	memset(handle, 0, sizeof(DisplayBufferThread));
 
 	handle->cm_processor = init_data->cm_processor;
+	handle->display_lut = init_data->display_lut;
 
 	if (init_data->buffer)
 		handle->buffer = init_data->buffer + offset;
@@ -1421,7 +1728,14 @@ static void *do_display_buffer_apply_thread(void *handle_v)
 		float *linear_buffer = MEM_mallocN(((size_t)channels) * width * height * sizeof(float),
 		                                   "color conversion linear buffer");
 
-		display_buffer_apply_get_linear_buffer(handle, height, linear_buffer, &is_straight_alpha);
+		if (handle->display_lut) {
+			display_lut_apply_byte(handle->display_lut, handle->byte_buffer, linear_buffer,
+			                       ((size_t)width) * height, channels);
+			is_straight_alpha = true;
+		}
+		else {
+			display_buffer_apply_get_linear_buffer(handle, height, linear_buffer, &is_straight_alpha);
+		}
 
 		predivide = is_straight_alpha == false;
 
@@ -1430,6 +1744,9 @@ static void *do_display_buffer_apply_thread(void *handle_v)
 			 * only generate byte buffers
 			 */
 		}
+		else if (handle->display_lut) {
+			/* baked LUT gives colors in display space already */
+		}
 		else {
 			/* apply processor */
 			IMB_colormanagement_processor_apply(cm_processor, linear_buffer, width, height, channels,
@@ -1468,9 +1785,11 @@ static void *do_display_buffer_apply_thread(void *handle_v)
 }
 
 static void display_buffer_apply_threaded(ImBuf *ibuf, float *buffer, unsigned char *byte_buffer, float *display_buffer,
-                                          unsigned char *display_buffer_byte, ColormanageProcessor *cm_processor)
+                                          unsigned char *display_buffer_byte, ColormanageProcessor *cm_processor,
+                                          bool use_display_lut)
 {
 	DisplayBufferInitData init_data;
+	CachedProcessor *display_lut_entry = NULL;
 
 	init_data.ibuf = ibuf;
 	init_data.cm_processor = cm_processor;
@@ -1497,8 +1816,17 @@ static void display_buffer_apply_threaded(ImBuf *ibuf, float *buffer, unsigned c
 		init_data.float_colorspace = NULL;
 	}
 
+	if (use_display_lut && display_buffer_use_lut(ibuf, buffer, byte_buffer, cm_processor)) {
+		display_lut_entry = display_lut_acquire(cm_processor, init_data.byte_colorspace);
+	}
+
+	init_data.display_lut = display_lut_entry ? display_lut_entry->lut : NULL;
+
 	IMB_processor_apply_threaded(ibuf->y, sizeof(DisplayBufferThread), &init_data,
 	                             display_buffer_init_handle, do_display_buffer_apply_thread);
+
+	if (display_lut_entry)
+		processor_cache_release(display_lut_entry);
 }
 
 static bool is_ibuf_rect_in_display_space(ImBuf *ibuf, const ColorManagedViewSettings *view_settings,
@@ -1520,7 +1848,8 @@ static bool is_ibuf_rect_in_display_space(ImBuf *ibuf, const ColorManagedViewSet
 
 static void colormanage_display_buffer_process_ex(ImBuf *ibuf, float *display_buffer, unsigned char *display_buffer_byte,
                                                   const ColorManagedViewSettings *view_settings,
-                                                  const ColorManagedDisplaySettings *display_settings)
+                                                  const ColorManagedDisplaySettings *display_settings,
+                                                  bool use_display_lut)
 {
 	ColormanageProcessor *cm_processor = NULL;
 	bool skip_transform = false;
@@ -1538,7 +1867,7 @@ static void colormanage_display_buffer_process_ex(ImBuf *ibuf, float *display_bu
 		cm_processor = IMB_colormanagement_display_processor_new(view_settings, display_settings);
 
 	display_buffer_apply_threaded(ibuf, ibuf->rect_float, (unsigned char *) ibuf->rect,
-	                              display_buffer, display_buffer_byte, cm_processor);
+	                              display_buffer, display_buffer_byte, cm_processor, use_display_lut);
 
 	if (cm_processor)
 		IMB_colormanagement_processor_free(cm_processor);
@@ -1548,7 +1877,11 @@ static void colormanage_display_buffer_process(ImBuf *ibuf, unsigned char *displ
                                                const ColorManagedViewSettings *view_settings,
                                                const ColorManagedDisplaySettings *display_settings)
 {
-	colormanage_display_buffer_process_ex(ibuf, NULL, display_buffer, view_settings, display_settings);
+	/* post-display gamma is too steep near black to be interpolated */
+	bool use_display_lut = view_settings->gamma == 1.0f;
+
+	colormanage_display_buffer_process_ex(ibuf, NULL, display_buffer, view_settings, display_settings,
+	                                      use_display_lut);
 }
 
 /*********************** Threaded processor transform routines *************************/
@@ -1838,7 +2171,7 @@ static void colormanagement_imbuf_make_display_space(ImBuf *ibuf, const ColorMan
 		imb_addrectImBuf(ibuf);
 
 	colormanage_display_buffer_process_ex(ibuf, ibuf->rect_float, (unsigned char *)ibuf->rect,
-	                                      view_settings, display_settings);
+	                                      view_settings, display_settings, false);
 }
 
 void IMB_colormanagement_imbuf_make_display_space(ImBuf *ibuf, const ColorManagedViewSettings *view_settings,
@@ -2976,6 +3309,7 @@ ColormanageProcessor *IMB_colormanagement_display_processor_new(const ColorManag
 	ColorManagedViewSettings default_view_settings;
 	const ColorManagedViewSettings *applied_view_settings;
 	ColorSpace *display_space;
+	char key[PROCESSOR_CACHE_KEY_SIZE];
 
 	cm_processor = MEM_callocN(sizeof(ColormanageProcessor), "colormanagement processor");
 
@@ -2991,12 +3325,32 @@ ColormanageProcessor *IMB_colormanagement_display_processor_new(const ColorManag
 	if (display_space)
 		cm_processor->is_data_result = display_space->is_data;
 
-	cm_processor->processor = create_display_buffer_processor(applied_view_settings->look,
-	                                                          applied_view_settings->view_transform,
-	                                                          display_settings->display_device,
-	                                                          applied_view_settings->exposure,
-	                                                          applied_view_settings->gamma,
-	                                                          global_role_scene_linear);
+	BLI_snprintf(key, sizeof(key), "display|%s|%s|%s|%.9g|%.9g|%s",
+	             applied_view_settings->look,
+	             applied_view_settings->view_transform,
+	             display_settings->display_device,
+	             applied_view_settings->exposure,
+	             applied_view_settings->gamma,
+	             global_role_scene_linear);
+
+	cm_processor->cached = processor_cache_acquire(&global_processor_cache, key);
+
+	if (cm_processor->cached == NULL) {
+		OCIO_ConstProcessorRcPtr *processor;
+
+		processor = create_display_buffer_processor(applied_view_settings->look,
+		                                            applied_view_settings->view_transform,
+		                                            display_settings->display_device,
+		                                            applied_view_settings->exposure,
+		                                            applied_view_settings->gamma,
+		                                            global_role_scene_linear);
+
+		if (processor)
+			cm_processor->cached = processor_cache_add(&global_processor_cache, key, processor, NULL);
+	}
+
+	if (cm_processor->cached)
+		cm_processor->processor = cm_processor->cached->processor;
 
 	if (applied_view_settings->flag & COLORMANAGE_VIEW_USE_CURVES) {
 		cm_processor->curve_mapping = curvemapping_copy(applied_view_settings->curve_mapping);
@@ -3010,13 +3364,28 @@ ColormanageProcessor *IMB_colormanagement_colorspace_processor_new(const char *f
 {
 	ColormanageProcessor *cm_processor;
 	ColorSpace *color_space;
+	char key[PROCESSOR_CACHE_KEY_SIZE];
 
 	cm_processor = MEM_callocN(sizeof(ColormanageProcessor), "colormanagement processor");
 
 	color_space = colormanage_colorspace_get_named(to_colorspace);
 	cm_processor->is_data_result = color_space->is_data;
 
-	cm_processor->processor = create_colorspace_transform_processor(from_colorspace, to_colorspace);
+	BLI_snprintf(key, sizeof(key), "colorspace|%s|%s", from_colorspace, to_colorspace);
+
+	cm_processor->cached = processor_cache_acquire(&global_processor_cache, key);
+
+	if (cm_processor->cached == NULL) {
+		OCIO_ConstProcessorRcPtr *processor;
+
+		processor = create_colorspace_transform_processor(from_colorspace, to_colorspace);
+
+		if (processor)
+			cm_processor->cached = processor_cache_add(&global_processor_cache, key, processor, NULL);
+	}
+
+	if (cm_processor->cached)
+		cm_processor->processor = cm_processor->cached->processor;
 
 	return cm_processor;
 }
@@ -3104,8 +3473,8 @@ void IMB_colormanagement_processor_free(ColormanageProcessor *cm_processor)
 {
 	if (cm_processor->curve_mapping)
 		curvemapping_free(cm_processor->curve_mapping);
-	if (cm_processor->processor)
-		OCIO_processorRelease(cm_processor->processor);
+	if (cm_processor->cached)
+		processor_cache_release(cm_processor->cached);
 
 	MEM_freeN(cm_processor);
 }
@@ -34,6 +34,8 @@
 #include "MEM_guardedalloc.h"
 
 #include "BLI_utildefines.h"
+#include "BLI_math_base.h"
+#include "BLI_task.h"
 
 #include "IMB_imbuf_types.h"
 #include "IMB_imbuf.h"
@@ -41,6 +43,15 @@
 
 #include "imbuf.h"
 
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+
+/* below this many pixels filtering is done on the calling thread */
+#define FILTER_THREADED_MIN_PIXELS (64 * 64)
+/* columns filtered by one task, neighboring columns share cache lines */
+#define FILTER_COLUMN_BLOCK 64
+
 /************************************************************************/
 /*				FILTERS					*/
 /************************************************************************/
@@ -128,21 +139,25 @@ static void filtcolumf(float *point, int y, int skip)
 	}
 }
 
-void IMB_filtery(struct ImBuf *ibuf)
-{
-	unsigned char *point;
-	float *pointf;
-	int x, y, skip;
-
-	point = (unsigned char *)ibuf->rect;
-	pointf = ibuf->rect_float;
+typedef struct FilterLinesData {
+	ImBuf *ibuf;
+	int totline;
+} FilterLinesData;
 
-	x = ibuf->x;
-	y = ibuf->y;
-	skip = x << 2;
+static void filtery_columns_cb(void *userdata, const int block)
+{
+	const FilterLinesData *data = userdata;
+	ImBuf *ibuf = data->ibuf;
+	const int start = block * FILTER_COLUMN_BLOCK;
+	const int stop = min_ii(start + FILTER_COLUMN_BLOCK, data->totline);
+	const int y = ibuf->y;
+	const int skip = ibuf->x << 2;
+	int x;
+
+	for (x = start; x < stop; x++) {
+		if (ibuf->rect) {
+			unsigned char *point = (unsigned char *)ibuf->rect + 4 * x;
 
-	for (; x > 0; x--) {
-		if (point) {
 			if (ibuf->planes > 24) filtcolum(point, y, skip);
 			point++;
 			filtcolum(point, y, skip);
@@ -150,9 +165,10 @@ void IMB_filtery(struct ImBuf *ibuf)
 			filtcolum(point, y, skip);
 			point++;
 			filtcolum(point, y, skip);
-			point++;
 		}
-		if (pointf) {
+		if (ibuf->rect_float) {
+			float *pointf = ibuf->rect_float + 4 * x;
+
 			if (ibuf->planes > 24) filtcolumf(pointf, y, skip);
 			pointf++;
 			filtcolumf(pointf, y, skip);
@@ -160,144 +176,217 @@ void IMB_filtery(struct ImBuf *ibuf)
 			filtcolumf(pointf, y, skip);
 			pointf++;
 			filtcolumf(pointf, y, skip);
-			pointf++;
 		}
 	}
 }
 
-
-void imb_filterx(struct ImBuf *ibuf)
+void IMB_filtery(struct ImBuf *ibuf)
 {
-	unsigned char *point;
-	float *pointf;
-	int x, y, skip;
+	FilterLinesData data;
 
-	point = (unsigned char *)ibuf->rect;
-	pointf = ibuf->rect_float;
+	data.ibuf = ibuf;
+	data.totline = ibuf->x;
 
-	x = ibuf->x;
-	y = ibuf->y;
-	skip = (x << 2) - 3;
+	BLI_task_parallel_range(0, (ibuf->x + FILTER_COLUMN_BLOCK - 1) / FILTER_COLUMN_BLOCK, &data, filtery_columns_cb,
+	                        (size_t)ibuf->x * ibuf->y >= FILTER_THREADED_MIN_PIXELS);
+}
 
-	for (; y > 0; y--) {
-		if (point) {
-			if (ibuf->planes > 24) filtrow(point, x);
-			point++;
-			filtrow(point, x);
-			point++;
-			filtrow(point, x);
-			point++;
-			filtrow(point, x);
-			point += skip;
-		}
-		if (pointf) {
-			if (ibuf->planes > 24) filtrowf(pointf, x);
-			pointf++;
-			filtrowf(pointf, x);
-			pointf++;
-			filtrowf(pointf, x);
-			pointf++;
-			filtrowf(pointf, x);
-			pointf += skip;
-		}
+static void filterx_row_cb(void *userdata, const int y)
+{
+	const FilterLinesData *data = userdata;
+	ImBuf *ibuf = data->ibuf;
+	const int x = ibuf->x;
+
+	if (ibuf->rect) {
+		unsigned char *point = (unsigned char *)ibuf->rect + 4 * (size_t)x * y;
+
+		if (ibuf->planes > 24) filtrow(point, x);
+		point++;
+		filtrow(point, x);
+		point++;
+		filtrow(point, x);
+		point++;
+		filtrow(point, x);
+	}
+	if (ibuf->rect_float) {
+		float *pointf = ibuf->rect_float + 4 * (size_t)x * y;
+
+		if (ibuf->planes > 24) filtrowf(pointf, x);
+		pointf++;
+		filtrowf(pointf, x);
+		pointf++;
+		filtrowf(pointf, x);
+		pointf++;
+		filtrowf(pointf, x);
 	}
 }
 
-static void imb_filterN(ImBuf *out, ImBuf *in)
+void imb_filterx(struct ImBuf *ibuf)
 {
-	BLI_assert(out->channels == in->channels);
-	BLI_assert(out->x == in->x && out->y == in->y);
+	FilterLinesData data;
+
+	data.ibuf = ibuf;
+	data.totline = ibuf->y;
+
+	BLI_task_parallel_range(0, ibuf->y, &data, filterx_row_cb,
+	                        (size_t)ibuf->x * ibuf->y >= FILTER_THREADED_MIN_PIXELS);
+}
+
+typedef struct FilterNData {
+	ImBuf *out, *in;
+} FilterNData;
 
+#ifdef __SSE2__
+BLI_INLINE __m128i filter_load_uchar4_epi16(const unsigned char *p)
+{
+	int v;
+
+	memcpy(&v, p, sizeof(v));
+	return _mm_unpacklo_epi8(_mm_cvtsi32_si128(v), _mm_setzero_si128());
+}
+#endif
+
+static void imb_filterN_row_cb(void *userdata, const int y)
+{
+	const FilterNData *data = userdata;
+	ImBuf *out = data->out, *in = data->in;
 	const int channels = in->channels;
 	const int rowlen = in->x;
-	
+
 	if (in->rect && out->rect) {
-		for (int y = 0; y < in->y; y++) {
-			/* setup rows */
-			const char *row2 = (const char *)in->rect + y * channels * rowlen;
-			const char *row1 = (y == 0) ? row2 : row2 - channels * rowlen;
-			const char *row3 = (y == in->y - 1) ? row2 : row2 + channels * rowlen;
+		/* setup rows */
+		const unsigned char *row2 = (const unsigned char *)in->rect + y * channels * rowlen;
+		const unsigned char *row1 = (y == 0) ? row2 : row2 - channels * rowlen;
+		const unsigned char *row3 = (y == in->y - 1) ? row2 : row2 + channels * rowlen;
 
-			char *cp = (char *)out->rect + y * channels * rowlen;
+		unsigned char *cp = (unsigned char *)out->rect + y * channels * rowlen;
 
-			for (int x = 0; x < rowlen; x++) {
-				const char *r11, *r13, *r21, *r23, *r31, *r33;
+		for (int x = 0; x < rowlen; x++) {
+			const unsigned char *r11, *r13, *r21, *r23, *r31, *r33;
 
-				if (x == 0) {
-					r11 = row1;
-					r21 = row2;
-					r31 = row3;
-				}
-				else {
-					r11 = row1 - channels;
-					r21 = row2 - channels;
-					r31 = row3 - channels;
-				}
+			if (x == 0) {
+				r11 = row1;
+				r21 = row2;
+				r31 = row3;
+			}
+			else {
+				r11 = row1 - channels;
+				r21 = row2 - channels;
+				r31 = row3 - channels;
+			}
 
-				if (x == rowlen - 1) {
-					r13 = row1;
-					r23 = row2;
-					r33 = row3;
-				}
-				else {
-					r13 = row1 + channels;
-					r23 = row2 + channels;
-					r33 = row3 + channels;
-				}
+			if (x == rowlen - 1) {
+				r13 = row1;
+				r23 = row2;
+				r33 = row3;
+			}
+			else {
+				r13 = row1 + channels;
+				r23 = row2 + channels;
+				r33 = row3 + channels;
+			}
 
+#ifdef __SSE2__
+			if (channels == 4) {
+				/* the weights add up to 16, so sums fit in 16 bit */
+				__m128i sum = filter_load_uchar4_epi16(r11);
+				sum = _mm_add_epi16(sum, _mm_slli_epi16(filter_load_uchar4_epi16(row1), 1));
+				sum = _mm_add_epi16(sum, filter_load_uchar4_epi16(r13));
+				sum = _mm_add_epi16(sum, _mm_slli_epi16(filter_load_uchar4_epi16(r21), 1));
+				sum = _mm_add_epi16(sum, _mm_slli_epi16(filter_load_uchar4_epi16(row2), 2));
+				sum = _mm_add_epi16(sum, _mm_slli_epi16(filter_load_uchar4_epi16(r23), 1));
+				sum = _mm_add_epi16(sum, filter_load_uchar4_epi16(r31));
+				sum = _mm_add_epi16(sum, _mm_slli_epi16(filter_load_uchar4_epi16(row3), 1));
+				sum = _mm_add_epi16(sum, filter_load_uchar4_epi16(r33));
+				sum = _mm_srli_epi16(sum, 4);
+
+				int v = _mm_cvtsi128_si32(_mm_packus_epi16(sum, sum));
+				memcpy(cp, &v, sizeof(v));
+			}
+			else
+#endif
+			{
 				cp[0] = (r11[0] + 2 * row1[0] + r13[0] + 2 * r21[0] + 4 * row2[0] + 2 * r23[0] + r31[0] + 2 * row3[0] + r33[0]) >> 4;
 				cp[1] = (r11[1] + 2 * row1[1] + r13[1] + 2 * r21[1] + 4 * row2[1] + 2 * r23[1] + r31[1] + 2 * row3[1] + r33[1]) >> 4;
 				cp[2] = (r11[2] + 2 * row1[2] + r13[2] + 2 * r21[2] + 4 * row2[2] + 2 * r23[2] + r31[2] + 2 * row3[2] + r33[2]) >> 4;
 				cp[3] = (r11[3] + 2 * row1[3] + r13[3] + 2 * r21[3] + 4 * row2[3] + 2 * r23[3] + r31[3] + 2 * row3[3] + r33[3]) >> 4;
-				cp += channels; row1 += channels; row2 += channels; row3 += channels;
 			}
+			cp += channels; row1 += channels; row2 += channels; row3 += channels;
 		}
 	}
 
 	if (in->rect_float && out->rect_float) {
-		for (int y = 0; y < in->y; y++) {
-			/* setup rows */
-			const float *row2 = (const float *)in->rect_float + y * channels * rowlen;
-			const float *row1 = (y == 0) ? row2 : row2 - channels * rowlen;
-			const float *row3 = (y == in->y - 1) ? row2 : row2 + channels * rowlen;
+		/* setup rows */
+		const float *row2 = (const float *)in->rect_float + y * channels * rowlen;
+		const float *row1 = (y == 0) ? row2 : row2 - channels * rowlen;
+		const float *row3 = (y == in->y - 1) ? row2 : row2 + channels * rowlen;
 
-			float *cp = (float *)out->rect_float + y * channels * rowlen;
+		float *cp = (float *)out->rect_float + y * channels * rowlen;
 
-			for (int x = 0; x < rowlen; x++) {
-				const float *r11, *r13, *r21, *r23, *r31, *r33;
+		for (int x = 0; x < rowlen; x++) {
+			const float *r11, *r13, *r21, *r23, *r31, *r33;
 
-				if (x == 0) {
-					r11 = row1;
-					r21 = row2;
-					r31 = row3;
-				}
-				else {
-					r11 = row1 - channels;
-					r21 = row2 - channels;
-					r31 = row3 - channels;
-				}
+			if (x == 0) {
+				r11 = row1;
+				r21 = row2;
+				r31 = row3;
+			}
+			else {
+				r11 = row1 - channels;
+				r21 = row2 - channels;
+				r31 = row3 - channels;
+			}
 
-				if (x == rowlen - 1) {
-					r13 = row1;
-					r23 = row2;
-					r33 = row3;
-				}
-				else {
-					r13 = row1 + channels;
-					r23 = row2 + channels;
-					r33 = row3 + channels;
-				}
+			if (x == rowlen - 1) {
+				r13 = row1;
+				r23 = row2;
+				r33 = row3;
+			}
+			else {
+				r13 = row1 + channels;
+				r23 = row2 + channels;
+				r33 = row3 + channels;
+			}
 
+#ifdef __SSE2__
+			if (channels == 4) {
+				/* same order of additions as the scalar code */
+				const __m128 two = _mm_set1_ps(2.0f);
+				__m128 sum = _mm_loadu_ps(r11);
+				sum = _mm_add_ps(sum, _mm_mul_ps(two, _mm_loadu_ps(row1)));
+				sum = _mm_add_ps(sum, _mm_loadu_ps(r13));
+				sum = _mm_add_ps(sum, _mm_mul_ps(two, _mm_loadu_ps(r21)));
+				sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(4.0f), _mm_loadu_ps(row2)));
+				sum = _mm_add_ps(sum, _mm_mul_ps(two, _mm_loadu_ps(r23)));
+				sum = _mm_add_ps(sum, _mm_loadu_ps(r31));
+				sum = _mm_add_ps(sum, _mm_mul_ps(two, _mm_loadu_ps(row3)));
+				sum = _mm_add_ps(sum, _mm_loadu_ps(r33));
+				_mm_storeu_ps(cp, _mm_mul_ps(sum, _mm_set1_ps(1.0f / 16.0f)));
+			}
+			else
+#endif
+			{
 				cp[0] = (r11[0] + 2 * row1[0] + r13[0] + 2 * r21[0] + 4 * row2[0] + 2 * r23[0] + r31[0] + 2 * row3[0] + r33[0]) * (1.0f / 16.0f);
 				cp[1] = (r11[1] + 2 * row1[1] + r13[1] + 2 * r21[1] + 4 * row2[1] + 2 * r23[1] + r31[1] + 2 * row3[1] + r33[1]) * (1.0f / 16.0f);
 				cp[2] = (r11[2] + 2 * row1[2] + r13[2] + 2 * r21[2] + 4 * row2[2] + 2 * r23[2] + r31[2] + 2 * row3[2] + r33[2]) * (1.0f / 16.0f);
 				cp[3] = (r11[3] + 2 * row1[3] + r13[3] + 2 * r21[3] + 4 * row2[3] + 2 * r23[3] + r31[3] + 2 * row3[3] + r33[3]) * (1.0f / 16.0f);
-				cp += channels; row1 += channels; row2 += channels; row3 += channels;
 			}
+			cp += channels; row1 += channels; row2 += channels; row3 += channels;
 		}
 	}
 }
 
+static void imb_filterN(ImBuf *out, ImBuf *in)
+{
+	BLI_assert(out->channels == in->channels);
+	BLI_assert(out->x == in->x && out->y == in->y);
+
+	FilterNData data = {out, in};
+
+	BLI_task_parallel_range(0, in->y, &data, imb_filterN_row_cb,
+	                        (size_t)in->x * in->y >= FILTER_THREADED_MIN_PIXELS);
+}
+
 void IMB_filter(struct ImBuf *ibuf)
 {
 	IMB_filtery(ibuf);
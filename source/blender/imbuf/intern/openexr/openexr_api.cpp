@@ -59,6 +59,7 @@
 #include <ImfMultiView.h>
 #include <ImfMultiPartInputFile.h>
 #include <ImfInputPart.h>
+#include <ImfTiledInputPart.h>
 #include <ImfOutputPart.h>
 #include <ImfMultiPartOutputFile.h>
 #include <ImfTiledOutputPart.h>
@@ -1927,6 +1928,53 @@ static bool imb_exr_is_multi(MultiPartInputFile& file)
 	return false;
 }
 
+/* detect if we are reading a tiled/mipmapped RGBA file, in that case
+ * we don't read pixels but leave it to the cache to load tiles */
+static bool imb_exr_setup_tilecache(MultiPartInputFile& file, ImBuf *ibuf)
+{
+	const Header& header = file.header(0);
+
+	if (!header.hasTileDescription() || !exr_has_rgb(file))
+		return false;
+
+	const TileDescription& td = header.tileDescription();
+
+	/* ripmaps have no equivalent in ImBuf mipmaps, only use the full resolution level */
+	TiledInputPart in(file, 0);
+	int numlevel = (td.mode == MIPMAP_LEVELS) ? in.numLevels() : 1;
+	int level;
+
+	numlevel = std::min(numlevel, IMB_MIPMAP_LEVELS + 1);
+
+	/* create empty mipmap levels in advance */
+	for (level = 0; level < numlevel; level++) {
+		ImBuf *hbuf;
+
+		if (level > 0) {
+			hbuf = IMB_allocImBuf(in.levelWidth(level), in.levelHeight(level), ibuf->planes, 0);
+			hbuf->miplevel = level;
+			hbuf->ftype = ibuf->ftype;
+			ibuf->mipmap[level - 1] = hbuf;
+		}
+		else
+			hbuf = ibuf;
+
+		hbuf->flags |= IB_tilecache;
+
+		hbuf->tilex = td.xSize;
+		hbuf->tiley = td.ySize;
+
+		hbuf->xtiles = (hbuf->x + hbuf->tilex - 1) / hbuf->tilex;
+		hbuf->ytiles = (hbuf->y + hbuf->tiley - 1) / hbuf->tiley;
+
+		imb_addtilesfloatImBuf(hbuf);
+
+		ibuf->miptot++;
+	}
+
+	return true;
+}
+
 struct ImBuf *imb_load_openexr(const unsigned char *mem, size_t size, int flags, char colorspace[IM_MAX_SPACE])
 {
 	struct ImBuf *ibuf = NULL;
@@ -1997,6 +2045,11 @@ struct ImBuf *imb_load_openexr(const unsigned char *mem, size_t size, int flags,
 						ibuf->userdata = handle;         /* potential danger, the caller has to check for this! */
 					}
 				}
+				else if (!is_multi && (flags & IB_tilecache) && imb_exr_setup_tilecache(*file, ibuf)) {
+					/* tiles are loaded on demand from the file */
+					delete membuf;
+					delete file;
+				}
 				else {
 					const bool has_rgb = exr_has_rgb(*file);
 					const bool has_luma = exr_has_luma(*file);
@@ -2101,6 +2154,132 @@ struct ImBuf *imb_load_openexr(const unsigned char *mem, size_t size, int flags,
 
 }
 
+/* Tiled file kept open with a tile cached ImBuf, so loading a tile doesn't
+ * open the file and parse its header again. One part can't read tiles from
+ * several threads at once, the frame buffer is set for every read. */
+struct ExrTileFile {
+	IFileStream *ifile;
+	MultiPartInputFile *file;
+	TiledInputPart *in;
+	ThreadMutex mutex;
+};
+
+bool imb_open_tile_file_openexr(ImBuf *ibuf)
+{
+	ExrTileFile *tile_file = new ExrTileFile();
+	int a;
+
+	try
+	{
+		tile_file->ifile = new IFileStream(ibuf->cachename);
+		tile_file->file = new MultiPartInputFile(*tile_file->ifile);
+		tile_file->in = new TiledInputPart(*tile_file->file, 0);
+	}
+	catch (const std::exception& exc)
+	{
+		std::cerr << exc.what() << std::endl;
+		delete tile_file->in;
+		delete tile_file->file;
+		delete tile_file->ifile;
+		delete tile_file;
+		return false;
+	}
+
+	BLI_mutex_init(&tile_file->mutex);
+
+	ibuf->tile_file = tile_file;
+	for (a = 1; a < ibuf->miptot; a++)
+		ibuf->mipmap[a - 1]->tile_file = tile_file;
+
+	return true;
+}
+
+void imb_close_tile_file_openexr(ImBuf *ibuf)
+{
+	ExrTileFile *tile_file = (ExrTileFile *)ibuf->tile_file;
+
+	BLI_mutex_end(&tile_file->mutex);
+	delete tile_file->in;
+	delete tile_file->file;
+	delete tile_file->ifile;
+	delete tile_file;
+
+	ibuf->tile_file = NULL;
+}
+
+/* Reads one cache tile, ImBuf tiles are bottom to top while EXR tiles are top
+ * to bottom, so a cache tile generally straddles two rows of file tiles. */
+void imb_loadtile_openexr(ImBuf *ibuf, int tx, int ty, float *rect)
+{
+	ExrTileFile *tile_file = (ExrTileFile *)ibuf->tile_file;
+	float *tilerows = NULL;
+
+	BLI_mutex_lock(&tile_file->mutex);
+
+	try
+	{
+		MultiPartInputFile& file = *tile_file->file;
+		TiledInputPart& in = *tile_file->in;
+		const int level = ibuf->miplevel;
+		const Box2i dw = in.dataWindowForLevel(level);
+		const int width  = dw.max.x - dw.min.x + 1;
+		const int height = dw.max.y - dw.min.y + 1;
+
+		/* the levels were created from this file */
+		BLI_assert(width == ibuf->x && height == ibuf->y);
+		UNUSED_VARS_NDEBUG(width, height);
+
+		const int x0 = tx * ibuf->tilex;
+		const int y0 = ty * ibuf->tiley;
+		const int w = std::min(ibuf->tilex, ibuf->x - x0);
+		const int h = std::min(ibuf->tiley, ibuf->y - y0);
+		/* file scanlines (relative to the data window) covering the cache tile */
+		const int line_min = ibuf->y - (y0 + h);
+		const int line_max = ibuf->y - 1 - y0;
+		const int dy_min = line_min / ibuf->tiley;
+		const int dy_max = line_max / ibuf->tiley;
+		const size_t rowlen = 4 * (size_t)ibuf->tilex;
+		FrameBuffer frameBuffer;
+		float *first;
+		int xstride = sizeof(float) * 4;
+		int ystride = xstride * ibuf->tilex;
+		int y;
+
+		tilerows = (float *)MEM_mallocN(sizeof(float) * rowlen * (dy_max - dy_min + 1) * ibuf->tiley, __func__);
+
+		/* inverse correct first pixel for datawindow coordinates */
+		first = tilerows - 4 * (dw.min.x + x0) - rowlen * (dw.min.y + dy_min * ibuf->tiley);
+
+		frameBuffer.insert(exr_rgba_channelname(file, "R"),
+		                   Slice(Imf::FLOAT,  (char *) first, xstride, ystride));
+		frameBuffer.insert(exr_rgba_channelname(file, "G"),
+		                   Slice(Imf::FLOAT,  (char *) (first + 1), xstride, ystride));
+		frameBuffer.insert(exr_rgba_channelname(file, "B"),
+		                   Slice(Imf::FLOAT,  (char *) (first + 2), xstride, ystride));
+		/* 1.0 is fill value, this still needs to be assigned even when there is no alpha */
+		frameBuffer.insert(exr_rgba_channelname(file, "A"),
+		                   Slice(Imf::FLOAT,  (char *) (first + 3), xstride, ystride, 1, 1, 1.0f));
+
+		in.setFrameBuffer(frameBuffer);
+		in.readTiles(tx, tx, dy_min, dy_max, level);
+
+		/* flip into the cache tile */
+		for (y = 0; y < h; y++) {
+			const int line = ibuf->y - 1 - (y0 + y);
+			memcpy(rect + rowlen * y, tilerows + rowlen * (line - dy_min * ibuf->tiley), sizeof(float) * 4 * w);
+		}
+	}
+	catch (const std::exception& exc)
+	{
+		std::cerr << exc.what() << std::endl;
+	}
+
+	BLI_mutex_unlock(&tile_file->mutex);
+
+	if (tilerows)
+		MEM_freeN(tilerows);
+}
+
 void imb_initopenexr(void)
 {
 	int num_threads = BLI_system_thread_count();
@@ -47,6 +47,10 @@ int		imb_save_openexr			(struct ImBuf *ibuf, const char *name, int flags);
 
 struct ImBuf *imb_load_openexr		(const unsigned char *mem, size_t size, int flags, char *colorspace);
 
+void		imb_loadtile_openexr		(struct ImBuf *ibuf, int tx, int ty, float *rect);
+bool		imb_open_tile_file_openexr	(struct ImBuf *ibuf);
+void		imb_close_tile_file_openexr	(struct ImBuf *ibuf);
+
 #ifdef __cplusplus
 }
 #endif
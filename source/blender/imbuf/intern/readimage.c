@@ -235,6 +235,12 @@ ImBuf *IMB_loadiffname(const char *filepath, int flags, char colorspace[IM_MAX_S
 
 	close(file);
 
+	if (ibuf && ibuf->tiles_float && !imb_tile_file_open(ibuf)) {
+		/* tiles can't be read on demand, read all pixels instead */
+		IMB_freeImBuf(ibuf);
+		ibuf = IMB_loadiffname(filepath, flags & ~IB_tilecache, colorspace);
+	}
+
 	return ibuf;
 }
 
@@ -306,3 +312,43 @@ void imb_loadtile(ImBuf *ibuf, int tx, int ty, unsigned int *rect)
 
 	close(file);
 }
+
+/* float tiles are read from the file opened by imb_tile_file_open */
+void imb_loadtile_float(ImBuf *ibuf, int tx, int ty, float *rect)
+{
+	const ImFileType *type;
+
+	if (ibuf->tile_file == NULL)
+		return;
+
+	for (type = IMB_FILE_TYPES; type < IMB_FILE_TYPES_LAST; type++) {
+		if (type->load_tile_float && type->ftype(type, ibuf)) {
+			type->load_tile_float(ibuf, tx, ty, rect);
+			break;
+		}
+	}
+}
+
+/* keep the file open for loading float tiles, for the image and all its mipmap levels */
+bool imb_tile_file_open(ImBuf *ibuf)
+{
+	const ImFileType *type;
+
+	for (type = IMB_FILE_TYPES; type < IMB_FILE_TYPES_LAST; type++)
+		if (type->open_tile_file && type->ftype(type, ibuf))
+			return type->open_tile_file(ibuf);
+
+	return false;
+}
+
+void imb_tile_file_close(ImBuf *ibuf)
+{
+	const ImFileType *type;
+
+	for (type = IMB_FILE_TYPES; type < IMB_FILE_TYPES_LAST; type++) {
+		if (type->close_tile_file && type->ftype(type, ibuf)) {
+			type->close_tile_file(ibuf);
+			break;
+		}
+	}
+}
@@ -33,8 +33,10 @@
 
 
 #include "BLI_utildefines.h"
+#include "BLI_math_base.h"
 #include "BLI_math_color.h"
 #include "BLI_math_interp.h"
+#include "BLI_task.h"
 #include "MEM_guardedalloc.h"
 
 #include "imbuf.h"
@@ -45,6 +47,13 @@
 
 #include "BLI_sys_types.h" // for intptr_t support
 
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+
+/* below this many destination pixels scaling is done on the calling thread */
+#define SCALE_THREADED_MIN_PIXELS (64 * 64)
+
 /************************************************************************/
 /*								SCALING									*/
 /************************************************************************/
@@ -339,10 +348,78 @@ MINLINE void premul_ushort_to_straight_uchar(unsigned char *result, const unsign
 	}
 }
 
+typedef struct OneHalfData {
+	ImBuf *ibuf1, *ibuf2;
+	bool do_rect, do_float;
+} OneHalfData;
+
+static void onehalf_row_cb(void *userdata, const int y)
+{
+	const OneHalfData *data = userdata;
+	const ImBuf *ibuf1 = data->ibuf1;
+	const ImBuf *ibuf2 = data->ibuf2;
+	int x;
+
+	/* every destination row averages two source rows */
+	if (data->do_rect) {
+		const unsigned char *cp1, *cp2;
+		unsigned char *dest;
+
+		cp1 = (unsigned char *)ibuf1->rect + 8 * (size_t)ibuf1->x * y;
+		cp2 = cp1 + (ibuf1->x << 2);
+		dest = (unsigned char *)ibuf2->rect + 4 * (size_t)ibuf2->x * y;
+
+		for (x = ibuf2->x; x > 0; x--) {
+			unsigned short p1i[8], p2i[8], desti[4];
+
+			straight_uchar_to_premul_ushort(p1i, cp1);
+			straight_uchar_to_premul_ushort(p2i, cp2);
+			straight_uchar_to_premul_ushort(p1i + 4, cp1 + 4);
+			straight_uchar_to_premul_ushort(p2i + 4, cp2 + 4);
+
+			desti[0] = ((unsigned int) p1i[0] + p2i[0] + p1i[4] + p2i[4]) >> 2;
+			desti[1] = ((unsigned int) p1i[1] + p2i[1] + p1i[5] + p2i[5]) >> 2;
+			desti[2] = ((unsigned int) p1i[2] + p2i[2] + p1i[6] + p2i[6]) >> 2;
+			desti[3] = ((unsigned int) p1i[3] + p2i[3] + p1i[7] + p2i[7]) >> 2;
+
+			premul_ushort_to_straight_uchar(dest, desti);
+
+			cp1 += 8;
+			cp2 += 8;
+			dest += 4;
+		}
+	}
+
+	if (data->do_float) {
+		const float *p1f, *p2f;
+		float *destf;
+
+		p1f = ibuf1->rect_float + 8 * (size_t)ibuf1->x * y;
+		p2f = p1f + (ibuf1->x << 2);
+		destf = ibuf2->rect_float + 4 * (size_t)ibuf2->x * y;
+
+		for (x = ibuf2->x; x > 0; x--) {
+#ifdef __SSE2__
+			__m128 sum = _mm_add_ps(_mm_add_ps(_mm_loadu_ps(p1f), _mm_loadu_ps(p2f)), _mm_loadu_ps(p1f + 4));
+			sum = _mm_add_ps(sum, _mm_loadu_ps(p2f + 4));
+			_mm_storeu_ps(destf, _mm_mul_ps(_mm_set1_ps(0.25f), sum));
+#else
+			destf[0] = 0.25f * (p1f[0] + p2f[0] + p1f[4] + p2f[4]);
+			destf[1] = 0.25f * (p1f[1] + p2f[1] + p1f[5] + p2f[5]);
+			destf[2] = 0.25f * (p1f[2] + p2f[2] + p1f[6] + p2f[6]);
+			destf[3] = 0.25f * (p1f[3] + p2f[3] + p1f[7] + p2f[7]);
+#endif
+			p1f += 8;
+			p2f += 8;
+			destf += 4;
+		}
+	}
+}
+
 /* result in ibuf2, scaling should be done correctly */
 void imb_onehalf_no_alloc(struct ImBuf *ibuf2, struct ImBuf *ibuf1)
 {
-	int x, y;
+	OneHalfData data;
 	const short do_rect = (ibuf1->rect != NULL);
 	const short do_float = (ibuf1->rect_float != NULL) && (ibuf2->rect_float != NULL);
 
@@ -358,59 +435,14 @@ void imb_onehalf_no_alloc(struct ImBuf *ibuf2, struct ImBuf *ibuf1)
 		imb_half_x_no_alloc(ibuf2, ibuf1);
 		return;
 	}
-	
-	if (do_rect) {
-		unsigned char *cp1, *cp2, *dest;
-		
-		cp1 = (unsigned char *) ibuf1->rect;
-		dest = (unsigned char *) ibuf2->rect;
-		
-		for (y = ibuf2->y; y > 0; y--) {
-			cp2 = cp1 + (ibuf1->x << 2);
-			for (x = ibuf2->x; x > 0; x--) {
-				unsigned short p1i[8], p2i[8], desti[4];
-				
-				straight_uchar_to_premul_ushort(p1i, cp1);
-				straight_uchar_to_premul_ushort(p2i, cp2);
-				straight_uchar_to_premul_ushort(p1i + 4, cp1 + 4);
-				straight_uchar_to_premul_ushort(p2i + 4, cp2 + 4);
-				
-				desti[0] = ((unsigned int) p1i[0] + p2i[0] + p1i[4] + p2i[4]) >> 2;
-				desti[1] = ((unsigned int) p1i[1] + p2i[1] + p1i[5] + p2i[5]) >> 2;
-				desti[2] = ((unsigned int) p1i[2] + p2i[2] + p1i[6] + p2i[6]) >> 2;
-				desti[3] = ((unsigned int) p1i[3] + p2i[3] + p1i[7] + p2i[7]) >> 2;
-				
-				premul_ushort_to_straight_uchar(dest, desti);
-				
-				cp1 += 8;
-				cp2 += 8;
-				dest += 4;
-			}
-			cp1 = cp2;
-			if (ibuf1->x & 1) cp1 += 4;
-		}
-	}
-	
-	if (do_float) {
-		float *p1f, *p2f, *destf;
-		
-		p1f = ibuf1->rect_float;
-		destf = ibuf2->rect_float;
-		for (y = ibuf2->y; y > 0; y--) {
-			p2f = p1f + (ibuf1->x << 2);
-			for (x = ibuf2->x; x > 0; x--) {
-				destf[0] = 0.25f * (p1f[0] + p2f[0] + p1f[4] + p2f[4]);
-				destf[1] = 0.25f * (p1f[1] + p2f[1] + p1f[5] + p2f[5]);
-				destf[2] = 0.25f * (p1f[2] + p2f[2] + p1f[6] + p2f[6]);
-				destf[3] = 0.25f * (p1f[3] + p2f[3] + p1f[7] + p2f[7]);
-				p1f += 8;
-				p2f += 8;
-				destf += 4;
-			}
-			p1f = p2f;
-			if (ibuf1->x & 1) p1f += 4;
-		}
-	}
+
+	data.ibuf1 = ibuf1;
+	data.ibuf2 = ibuf2;
+	data.do_rect = do_rect;
+	data.do_float = do_float;
+
+	BLI_task_parallel_range(0, ibuf2->y, &data, onehalf_row_cb,
+	                        (size_t)ibuf2->x * ibuf2->y >= SCALE_THREADED_MIN_PIXELS);
 }
 
 ImBuf *IMB_onehalf(struct ImBuf *ibuf1)
@@ -881,606 +913,569 @@ static bool q_scale_linear_interpolation(
 	return true;
 }
 
-static ImBuf *scaledownx(struct ImBuf *ibuf, int newx)
+/* ******** area and linear scaling ******** */
+
+/* Each line of the passes below only depends on one input line (a row for the
+ * x passes, a column for the y passes), so lines are scaled in parallel. The y
+ * passes scale blocks of adjacent columns together, stepping through the image
+ * row by row, since the sample positions are the same for every column. */
+
+#define SCALE_COLUMN_BLOCK 64
+
+typedef struct ScaleLinesData {
+	const uchar *rect;
+	const float *rectf;
+	uchar *newrect;
+	float *newrectf;
+
+	/* offsets in components, between lines and between pixels within a line,
+	 * lines in a block must be adjacent in memory */
+	size_t line_step, newline_step;
+	size_t step, newstep;
+
+	int len, newlen;
+	int totline, block_size;
+	float add;
+} ScaleLinesData;
+
+#ifdef __SSE2__
+BLI_INLINE __m128 scale_load_uchar4_ps(const uchar *p)
 {
-	const int do_rect = (ibuf->rect != NULL);
-	const int do_float = (ibuf->rect_float != NULL);
-	const size_t rect_size = ibuf->x * ibuf->y * 4;
+	const __m128i zero = _mm_setzero_si128();
+	__m128i i;
+	int v;
+
+	memcpy(&v, p, sizeof(v));
+	i = _mm_cvtsi32_si128(v);
+	i = _mm_unpacklo_epi8(i, zero);
+	i = _mm_unpacklo_epi16(i, zero);
+	return _mm_cvtepi32_ps(i);
+}
 
-	uchar *rect, *_newrect, *newrect;
-	float *rectf, *_newrectf, *newrectf;
-	float sample, add, val[4], nval[4], valf[4], nvalf[4];
-	int x, y;
+/* truncates like a float to uchar cast, out of range values saturate */
+BLI_INLINE void scale_store_ps_uchar4(uchar *p, const __m128 v)
+{
+	__m128i i = _mm_cvttps_epi32(v);
+	int r;
 
-	rectf = _newrectf = newrectf = NULL;
-	rect = _newrect = newrect = NULL;
-	nval[0] =  nval[1] = nval[2] = nval[3] = 0.0f;
-	nvalf[0] = nvalf[1] = nvalf[2] = nvalf[3] = 0.0f;
+	i = _mm_packs_epi32(i, i);
+	i = _mm_packus_epi16(i, i);
+	r = _mm_cvtsi128_si32(i);
+	memcpy(p, &r, sizeof(r));
+}
+#endif  /* __SSE2__ */
 
-	if (!do_rect && !do_float) return (ibuf);
+/* box filtered downscaling, the source lines must have len pixels */
+static void scaledown_lines_byte(
+        const uchar *rect, const size_t step, uchar *newrect, const size_t newstep,
+        const int width, const int len, const int newlen, const float add)
+{
+	const uchar *rect_start = rect;
+	float sample = 0.0f;
+	int x, k;
 
-	if (do_rect) {
-		_newrect = MEM_mallocN(newx * ibuf->y * sizeof(uchar) * 4, "scaledownx");
-		if (_newrect == NULL) return(ibuf);
-	}
-	if (do_float) {
-		_newrectf = MEM_mallocN(newx * ibuf->y * sizeof(float) * 4, "scaledownxf");
-		if (_newrectf == NULL) {
-			if (_newrect) MEM_freeN(_newrect);
-			return(ibuf);
+#ifdef __SSE2__
+	const __m128 sign = _mm_set1_ps(-0.0f);
+	const __m128 add_v = _mm_set1_ps(add);
+	const __m128 half = _mm_set1_ps(0.5f);
+	__m128 val[SCALE_COLUMN_BLOCK], nval[SCALE_COLUMN_BLOCK];
+
+	for (k = 0; k < width; k++)
+		val[k] = _mm_setzero_ps();
+
+	for (x = newlen; x > 0; x--) {
+		__m128 sample_v = _mm_set1_ps(sample);
+
+		for (k = 0; k < width; k++)
+			nval[k] = _mm_mul_ps(_mm_xor_ps(val[k], sign), sample_v);
+
+		sample += add;
+
+		while (sample >= 1.0f) {
+			sample -= 1.0f;
+			for (k = 0; k < width; k++)
+				nval[k] = _mm_add_ps(nval[k], scale_load_uchar4_ps(rect + 4 * k));
+			rect += step;
 		}
-	}
 
-	add = (ibuf->x - 0.01) / newx;
+		sample_v = _mm_set1_ps(sample);
 
-	if (do_rect) {
-		rect = (uchar *) ibuf->rect;
-		newrect = _newrect;
-	}
-	if (do_float) {
-		rectf = ibuf->rect_float;
-		newrectf = _newrectf;
+		for (k = 0; k < width; k++) {
+			val[k] = scale_load_uchar4_ps(rect + 4 * k);
+			scale_store_ps_uchar4(newrect + 4 * k,
+			                      _mm_add_ps(_mm_div_ps(_mm_add_ps(nval[k], _mm_mul_ps(sample_v, val[k])), add_v), half));
+		}
+		rect += step;
+		newrect += newstep;
+
+		sample -= 1.0f;
 	}
-		
-	for (y = ibuf->y; y > 0; y--) {
-		sample = 0.0f;
-		val[0] =  val[1] = val[2] = val[3] = 0.0f;
-		valf[0] = valf[1] = valf[2] = valf[3] = 0.0f;
+#else
+	float val[SCALE_COLUMN_BLOCK][4], nval[SCALE_COLUMN_BLOCK][4];
 
-		for (x = newx; x > 0; x--) {
-			if (do_rect) {
-				nval[0] = -val[0] * sample;
-				nval[1] = -val[1] * sample;
-				nval[2] = -val[2] * sample;
-				nval[3] = -val[3] * sample;
-			}
-			if (do_float) {
-				nvalf[0] = -valf[0] * sample;
-				nvalf[1] = -valf[1] * sample;
-				nvalf[2] = -valf[2] * sample;
-				nvalf[3] = -valf[3] * sample;
-			}
-			
-			sample += add;
-
-			while (sample >= 1.0f) {
-				sample -= 1.0f;
-				
-				if (do_rect) {
-					nval[0] += rect[0];
-					nval[1] += rect[1];
-					nval[2] += rect[2];
-					nval[3] += rect[3];
-					rect += 4;
-				}
-				if (do_float) {
-					nvalf[0] += rectf[0];
-					nvalf[1] += rectf[1];
-					nvalf[2] += rectf[2];
-					nvalf[3] += rectf[3];
-					rectf += 4;
-				}
-			}
-			
-			if (do_rect) {
-				val[0] = rect[0]; val[1] = rect[1]; val[2] = rect[2]; val[3] = rect[3];
-				rect += 4;
-				
-				newrect[0] = ((nval[0] + sample * val[0]) / add + 0.5f);
-				newrect[1] = ((nval[1] + sample * val[1]) / add + 0.5f);
-				newrect[2] = ((nval[2] + sample * val[2]) / add + 0.5f);
-				newrect[3] = ((nval[3] + sample * val[3]) / add + 0.5f);
-				
-				newrect += 4;
-			}
-			if (do_float) {
-				
-				valf[0] = rectf[0]; valf[1] = rectf[1]; valf[2] = rectf[2]; valf[3] = rectf[3];
-				rectf += 4;
-				
-				newrectf[0] = ((nvalf[0] + sample * valf[0]) / add);
-				newrectf[1] = ((nvalf[1] + sample * valf[1]) / add);
-				newrectf[2] = ((nvalf[2] + sample * valf[2]) / add);
-				newrectf[3] = ((nvalf[3] + sample * valf[3]) / add);
-				
-				newrectf += 4;
-			}
-			
+	memset(val, 0, sizeof(float[4]) * width);
+
+	for (x = newlen; x > 0; x--) {
+		for (k = 0; k < width; k++) {
+			nval[k][0] = -val[k][0] * sample;
+			nval[k][1] = -val[k][1] * sample;
+			nval[k][2] = -val[k][2] * sample;
+			nval[k][3] = -val[k][3] * sample;
+		}
+
+		sample += add;
+
+		while (sample >= 1.0f) {
 			sample -= 1.0f;
+
+			for (k = 0; k < width; k++) {
+				nval[k][0] += rect[4 * k + 0];
+				nval[k][1] += rect[4 * k + 1];
+				nval[k][2] += rect[4 * k + 2];
+				nval[k][3] += rect[4 * k + 3];
+			}
+			rect += step;
 		}
-	}
 
-	if (do_rect) {
-		// printf("%ld %ld\n", (uchar *)rect - ((uchar *)ibuf->rect), rect_size);
-		BLI_assert((uchar *)rect - ((uchar *)ibuf->rect) == rect_size); /* see bug [#26502] */
-		imb_freerectImBuf(ibuf);
-		ibuf->mall |= IB_rect;
-		ibuf->rect = (unsigned int *) _newrect;
-	}
-	if (do_float) {
-		// printf("%ld %ld\n", rectf - ibuf->rect_float, rect_size);
-		BLI_assert((rectf - ibuf->rect_float) == rect_size); /* see bug [#26502] */
-		imb_freerectfloatImBuf(ibuf);
-		ibuf->mall |= IB_rectfloat;
-		ibuf->rect_float = _newrectf;
+		for (k = 0; k < width; k++) {
+			const uchar *cp = rect + 4 * k;
+			uchar *newcp = newrect + 4 * k;
+
+			val[k][0] = cp[0]; val[k][1] = cp[1]; val[k][2] = cp[2]; val[k][3] = cp[3];
+
+			newcp[0] = ((nval[k][0] + sample * val[k][0]) / add + 0.5f);
+			newcp[1] = ((nval[k][1] + sample * val[k][1]) / add + 0.5f);
+			newcp[2] = ((nval[k][2] + sample * val[k][2]) / add + 0.5f);
+			newcp[3] = ((nval[k][3] + sample * val[k][3]) / add + 0.5f);
+		}
+		rect += step;
+		newrect += newstep;
+
+		sample -= 1.0f;
 	}
-	(void)rect_size; /* UNUSED in release builds */
-	
-	ibuf->x = newx;
-	return(ibuf);
-}
+#endif
 
+	BLI_assert(rect - rect_start == step * len); /* see bug [#26502] */
+	UNUSED_VARS_NDEBUG(rect_start, len);
+}
 
-static ImBuf *scaledowny(struct ImBuf *ibuf, int newy)
+static void scaledown_lines_float(
+        const float *rectf, const size_t step, float *newrectf, const size_t newstep,
+        const int width, const int len, const int newlen, const float add)
 {
-	const int do_rect = (ibuf->rect != NULL);
-	const int do_float = (ibuf->rect_float != NULL);
-	const size_t rect_size = ibuf->x * ibuf->y * 4;
+	const float *rectf_start = rectf;
+	float sample = 0.0f;
+	int x, k;
 
-	uchar *rect, *_newrect, *newrect;
-	float *rectf, *_newrectf, *newrectf;
-	float sample, add, val[4], nval[4], valf[4], nvalf[4];
-	int x, y, skipx;
+#ifdef __SSE2__
+	const __m128 sign = _mm_set1_ps(-0.0f);
+	const __m128 add_v = _mm_set1_ps(add);
+	__m128 valf[SCALE_COLUMN_BLOCK], nvalf[SCALE_COLUMN_BLOCK];
 
-	rectf = _newrectf = newrectf = NULL;
-	rect = _newrect = newrect = NULL;
-	nval[0] =  nval[1] = nval[2] = nval[3] = 0.0f;
-	nvalf[0] = nvalf[1] = nvalf[2] = nvalf[3] = 0.0f;
+	for (k = 0; k < width; k++)
+		valf[k] = _mm_setzero_ps();
 
-	if (!do_rect && !do_float) return (ibuf);
+	for (x = newlen; x > 0; x--) {
+		__m128 sample_v = _mm_set1_ps(sample);
 
-	if (do_rect) {
-		_newrect = MEM_mallocN(newy * ibuf->x * sizeof(uchar) * 4, "scaledowny");
-		if (_newrect == NULL) return(ibuf);
-	}
-	if (do_float) {
-		_newrectf = MEM_mallocN(newy * ibuf->x * sizeof(float) * 4, "scaledownyf");
-		if (_newrectf == NULL) {
-			if (_newrect) MEM_freeN(_newrect);
-			return(ibuf);
+		for (k = 0; k < width; k++)
+			nvalf[k] = _mm_mul_ps(_mm_xor_ps(valf[k], sign), sample_v);
+
+		sample += add;
+
+		while (sample >= 1.0f) {
+			sample -= 1.0f;
+			for (k = 0; k < width; k++)
+				nvalf[k] = _mm_add_ps(nvalf[k], _mm_loadu_ps(rectf + 4 * k));
+			rectf += step;
 		}
-	}
 
-	add = (ibuf->y - 0.01) / newy;
-	skipx = 4 * ibuf->x;
+		sample_v = _mm_set1_ps(sample);
 
-	for (x = skipx - 4; x >= 0; x -= 4) {
-		if (do_rect) {
-			rect = ((uchar *) ibuf->rect) + x;
-			newrect = _newrect + x;
+		for (k = 0; k < width; k++) {
+			valf[k] = _mm_loadu_ps(rectf + 4 * k);
+			_mm_storeu_ps(newrectf + 4 * k, _mm_div_ps(_mm_add_ps(nvalf[k], _mm_mul_ps(sample_v, valf[k])), add_v));
 		}
-		if (do_float) {
-			rectf = ibuf->rect_float + x;
-			newrectf = _newrectf + x;
+		rectf += step;
+		newrectf += newstep;
+
+		sample -= 1.0f;
+	}
+#else
+	float valf[SCALE_COLUMN_BLOCK][4], nvalf[SCALE_COLUMN_BLOCK][4];
+
+	memset(valf, 0, sizeof(float[4]) * width);
+
+	for (x = newlen; x > 0; x--) {
+		for (k = 0; k < width; k++) {
+			nvalf[k][0] = -valf[k][0] * sample;
+			nvalf[k][1] = -valf[k][1] * sample;
+			nvalf[k][2] = -valf[k][2] * sample;
+			nvalf[k][3] = -valf[k][3] * sample;
 		}
-		
-		sample = 0.0f;
-		val[0] =  val[1] = val[2] = val[3] = 0.0f;
-		valf[0] = valf[1] = valf[2] = valf[3] = 0.0f;
 
-		for (y = newy; y > 0; y--) {
-			if (do_rect) {
-				nval[0] = -val[0] * sample;
-				nval[1] = -val[1] * sample;
-				nval[2] = -val[2] * sample;
-				nval[3] = -val[3] * sample;
-			}
-			if (do_float) {
-				nvalf[0] = -valf[0] * sample;
-				nvalf[1] = -valf[1] * sample;
-				nvalf[2] = -valf[2] * sample;
-				nvalf[3] = -valf[3] * sample;
-			}
-			
-			sample += add;
-
-			while (sample >= 1.0f) {
-				sample -= 1.0f;
-				
-				if (do_rect) {
-					nval[0] += rect[0];
-					nval[1] += rect[1];
-					nval[2] += rect[2];
-					nval[3] += rect[3];
-					rect += skipx;
-				}
-				if (do_float) {
-					nvalf[0] += rectf[0];
-					nvalf[1] += rectf[1];
-					nvalf[2] += rectf[2];
-					nvalf[3] += rectf[3];
-					rectf += skipx;
-				}
-			}
+		sample += add;
 
-			if (do_rect) {
-				val[0] = rect[0]; val[1] = rect[1]; val[2] = rect[2]; val[3] = rect[3];
-				rect += skipx;
-				
-				newrect[0] = ((nval[0] + sample * val[0]) / add + 0.5f);
-				newrect[1] = ((nval[1] + sample * val[1]) / add + 0.5f);
-				newrect[2] = ((nval[2] + sample * val[2]) / add + 0.5f);
-				newrect[3] = ((nval[3] + sample * val[3]) / add + 0.5f);
-				
-				newrect += skipx;
-			}
-			if (do_float) {
-				
-				valf[0] = rectf[0]; valf[1] = rectf[1]; valf[2] = rectf[2]; valf[3] = rectf[3];
-				rectf += skipx;
-				
-				newrectf[0] = ((nvalf[0] + sample * valf[0]) / add);
-				newrectf[1] = ((nvalf[1] + sample * valf[1]) / add);
-				newrectf[2] = ((nvalf[2] + sample * valf[2]) / add);
-				newrectf[3] = ((nvalf[3] + sample * valf[3]) / add);
-				
-				newrectf += skipx;
-			}
-			
+		while (sample >= 1.0f) {
 			sample -= 1.0f;
+
+			for (k = 0; k < width; k++) {
+				nvalf[k][0] += rectf[4 * k + 0];
+				nvalf[k][1] += rectf[4 * k + 1];
+				nvalf[k][2] += rectf[4 * k + 2];
+				nvalf[k][3] += rectf[4 * k + 3];
+			}
+			rectf += step;
 		}
-	}
 
-	if (do_rect) {
-		// printf("%ld %ld\n", (uchar *)rect - ((uchar *)ibuf->rect), rect_size);
-		BLI_assert((uchar *)rect - ((uchar *)ibuf->rect) == rect_size); /* see bug [#26502] */
-		imb_freerectImBuf(ibuf);
-		ibuf->mall |= IB_rect;
-		ibuf->rect = (unsigned int *) _newrect;
-	}
-	if (do_float) {
-		// printf("%ld %ld\n", rectf - ibuf->rect_float, rect_size);
-		BLI_assert((rectf - ibuf->rect_float) == rect_size); /* see bug [#26502] */
-		imb_freerectfloatImBuf(ibuf);
-		ibuf->mall |= IB_rectfloat;
-		ibuf->rect_float = (float *) _newrectf;
+		for (k = 0; k < width; k++) {
+			const float *fp = rectf + 4 * k;
+			float *newfp = newrectf + 4 * k;
+
+			valf[k][0] = fp[0]; valf[k][1] = fp[1]; valf[k][2] = fp[2]; valf[k][3] = fp[3];
+
+			newfp[0] = ((nvalf[k][0] + sample * valf[k][0]) / add);
+			newfp[1] = ((nvalf[k][1] + sample * valf[k][1]) / add);
+			newfp[2] = ((nvalf[k][2] + sample * valf[k][2]) / add);
+			newfp[3] = ((nvalf[k][3] + sample * valf[k][3]) / add);
+		}
+		rectf += step;
+		newrectf += newstep;
+
+		sample -= 1.0f;
 	}
-	(void)rect_size; /* UNUSED in release builds */
-	
-	ibuf->y = newy;
-	return(ibuf);
-}
+#endif
 
+	BLI_assert(rectf - rectf_start == step * len); /* see bug [#26502] */
+	UNUSED_VARS_NDEBUG(rectf_start, len);
+}
 
-static ImBuf *scaleupx(struct ImBuf *ibuf, int newx)
+/* linear interpolated upscaling */
+static void scaleup_lines_byte(
+        const uchar *rect, const size_t step, uchar *newrect, const size_t newstep,
+        const int width, const int newlen, const float add)
 {
-	uchar *rect, *_newrect = NULL, *newrect;
-	float *rectf, *_newrectf = NULL, *newrectf;
-	float sample, add;
-	float val_a, nval_a, diff_a;
-	float val_b, nval_b, diff_b;
-	float val_g, nval_g, diff_g;
-	float val_r, nval_r, diff_r;
-	float val_af, nval_af, diff_af;
-	float val_bf, nval_bf, diff_bf;
-	float val_gf, nval_gf, diff_gf;
-	float val_rf, nval_rf, diff_rf;
-	int x, y;
-	bool do_rect = false, do_float = false;
+	float sample = 0.0f;
+	int x, k;
+
+#ifdef __SSE2__
+	const __m128 half = _mm_set1_ps(0.5f);
+	__m128 val[SCALE_COLUMN_BLOCK], nval[SCALE_COLUMN_BLOCK], diff[SCALE_COLUMN_BLOCK];
+
+	for (k = 0; k < width; k++) {
+		val[k] = scale_load_uchar4_ps(rect + 4 * k);
+		nval[k] = scale_load_uchar4_ps(rect + step + 4 * k);
+		diff[k] = _mm_sub_ps(nval[k], val[k]);
+		val[k] = _mm_add_ps(val[k], half);
+	}
+	rect += 2 * step;
 
-	val_a = nval_a = diff_a = val_b = nval_b = diff_b = 0;
-	val_g = nval_g = diff_g = val_r = nval_r = diff_r = 0;
-	val_af = nval_af = diff_af = val_bf = nval_bf = diff_bf = 0;
-	val_gf = nval_gf = diff_gf = val_rf = nval_rf = diff_rf = 0;
-	if (ibuf == NULL) return(NULL);
-	if (ibuf->rect == NULL && ibuf->rect_float == NULL) return (ibuf);
+	for (x = newlen; x > 0; x--) {
+		__m128 sample_v;
 
-	if (ibuf->rect) {
-		do_rect = true;
-		_newrect = MEM_mallocN(newx * ibuf->y * sizeof(int), "scaleupx");
-		if (_newrect == NULL) return(ibuf);
+		if (sample >= 1.0f) {
+			sample -= 1.0f;
+
+			for (k = 0; k < width; k++) {
+				val[k] = nval[k];
+				nval[k] = scale_load_uchar4_ps(rect + 4 * k);
+				diff[k] = _mm_sub_ps(nval[k], val[k]);
+				val[k] = _mm_add_ps(val[k], half);
+			}
+			rect += step;
+		}
+
+		sample_v = _mm_set1_ps(sample);
+
+		for (k = 0; k < width; k++)
+			scale_store_ps_uchar4(newrect + 4 * k, _mm_add_ps(val[k], _mm_mul_ps(sample_v, diff[k])));
+		newrect += newstep;
+
+		sample += add;
 	}
-	if (ibuf->rect_float) {
-		do_float = true;
-		_newrectf = MEM_mallocN(newx * ibuf->y * sizeof(float) * 4, "scaleupxf");
-		if (_newrectf == NULL) {
-			if (_newrect) MEM_freeN(_newrect);
-			return(ibuf);
+#else
+	float val[SCALE_COLUMN_BLOCK][4], nval[SCALE_COLUMN_BLOCK][4], diff[SCALE_COLUMN_BLOCK][4];
+	int c;
+
+	for (k = 0; k < width; k++) {
+		for (c = 0; c < 4; c++) {
+			val[k][c] = rect[4 * k + c];
+			nval[k][c] = rect[step + 4 * k + c];
+			diff[k][c] = nval[k][c] - val[k][c];
+			val[k][c] += 0.5f;
 		}
 	}
+	rect += 2 * step;
 
-	add = (ibuf->x - 1.001) / (newx - 1.0);
+	for (x = newlen; x > 0; x--) {
+		if (sample >= 1.0f) {
+			sample -= 1.0f;
 
-	rect = (uchar *) ibuf->rect;
-	rectf = (float *) ibuf->rect_float;
-	newrect = _newrect;
-	newrectf = _newrectf;
+			for (k = 0; k < width; k++) {
+				for (c = 0; c < 4; c++) {
+					val[k][c] = nval[k][c];
+					nval[k][c] = rect[4 * k + c];
+					diff[k][c] = nval[k][c] - val[k][c];
+					val[k][c] += 0.5f;
+				}
+			}
+			rect += step;
+		}
 
-	for (y = ibuf->y; y > 0; y--) {
+		for (k = 0; k < width; k++) {
+			uchar *newcp = newrect + 4 * k;
 
-		sample = 0;
-		
-		if (do_rect) {
-			val_a = rect[0];
-			nval_a = rect[4];
-			diff_a = nval_a - val_a;
-			val_a += 0.5f;
-
-			val_b = rect[1];
-			nval_b = rect[5];
-			diff_b = nval_b - val_b;
-			val_b += 0.5f;
-
-			val_g = rect[2];
-			nval_g = rect[6];
-			diff_g = nval_g - val_g;
-			val_g += 0.5f;
-
-			val_r = rect[3];
-			nval_r = rect[7];
-			diff_r = nval_r - val_r;
-			val_r += 0.5f;
-
-			rect += 8;
+			newcp[0] = val[k][0] + sample * diff[k][0];
+			newcp[1] = val[k][1] + sample * diff[k][1];
+			newcp[2] = val[k][2] + sample * diff[k][2];
+			newcp[3] = val[k][3] + sample * diff[k][3];
 		}
-		if (do_float) {
-			val_af = rectf[0];
-			nval_af = rectf[4];
-			diff_af = nval_af - val_af;
-	
-			val_bf = rectf[1];
-			nval_bf = rectf[5];
-			diff_bf = nval_bf - val_bf;
+		newrect += newstep;
+
+		sample += add;
+	}
+#endif
+}
 
-			val_gf = rectf[2];
-			nval_gf = rectf[6];
-			diff_gf = nval_gf - val_gf;
+static void scaleup_lines_float(
+        const float *rectf, const size_t step, float *newrectf, const size_t newstep,
+        const int width, const int newlen, const float add)
+{
+	float sample = 0.0f;
+	int x, k;
+
+#ifdef __SSE2__
+	__m128 valf[SCALE_COLUMN_BLOCK], nvalf[SCALE_COLUMN_BLOCK], difff[SCALE_COLUMN_BLOCK];
+
+	for (k = 0; k < width; k++) {
+		valf[k] = _mm_loadu_ps(rectf + 4 * k);
+		nvalf[k] = _mm_loadu_ps(rectf + step + 4 * k);
+		difff[k] = _mm_sub_ps(nvalf[k], valf[k]);
+	}
+	rectf += 2 * step;
 
-			val_rf = rectf[3];
-			nval_rf = rectf[7];
-			diff_rf = nval_rf - val_rf;
+	for (x = newlen; x > 0; x--) {
+		__m128 sample_v;
 
-			rectf += 8;
+		if (sample >= 1.0f) {
+			sample -= 1.0f;
+
+			for (k = 0; k < width; k++) {
+				valf[k] = nvalf[k];
+				nvalf[k] = _mm_loadu_ps(rectf + 4 * k);
+				difff[k] = _mm_sub_ps(nvalf[k], valf[k]);
+			}
+			rectf += step;
 		}
-		for (x = newx; x > 0; x--) {
-			if (sample >= 1.0f) {
-				sample -= 1.0f;
-
-				if (do_rect) {
-					val_a = nval_a;
-					nval_a = rect[0];
-					diff_a = nval_a - val_a;
-					val_a += 0.5f;
-
-					val_b = nval_b;
-					nval_b = rect[1];
-					diff_b = nval_b - val_b;
-					val_b += 0.5f;
-
-					val_g = nval_g;
-					nval_g = rect[2];
-					diff_g = nval_g - val_g;
-					val_g += 0.5f;
-
-					val_r = nval_r;
-					nval_r = rect[3];
-					diff_r = nval_r - val_r;
-					val_r += 0.5f;
-					rect += 4;
-				}
-				if (do_float) {
-					val_af = nval_af;
-					nval_af = rectf[0];
-					diff_af = nval_af - val_af;
-	
-					val_bf = nval_bf;
-					nval_bf = rectf[1];
-					diff_bf = nval_bf - val_bf;
-
-					val_gf = nval_gf;
-					nval_gf = rectf[2];
-					diff_gf = nval_gf - val_gf;
-
-					val_rf = nval_rf;
-					nval_rf = rectf[3];
-					diff_rf = nval_rf - val_rf;
-					rectf += 4;
+
+		sample_v = _mm_set1_ps(sample);
+
+		for (k = 0; k < width; k++)
+			_mm_storeu_ps(newrectf + 4 * k, _mm_add_ps(valf[k], _mm_mul_ps(sample_v, difff[k])));
+		newrectf += newstep;
+
+		sample += add;
+	}
+#else
+	float valf[SCALE_COLUMN_BLOCK][4], nvalf[SCALE_COLUMN_BLOCK][4], difff[SCALE_COLUMN_BLOCK][4];
+	int c;
+
+	for (k = 0; k < width; k++) {
+		for (c = 0; c < 4; c++) {
+			valf[k][c] = rectf[4 * k + c];
+			nvalf[k][c] = rectf[step + 4 * k + c];
+			difff[k][c] = nvalf[k][c] - valf[k][c];
+		}
+	}
+	rectf += 2 * step;
+
+	for (x = newlen; x > 0; x--) {
+		if (sample >= 1.0f) {
+			sample -= 1.0f;
+
+			for (k = 0; k < width; k++) {
+				for (c = 0; c < 4; c++) {
+					valf[k][c] = nvalf[k][c];
+					nvalf[k][c] = rectf[4 * k + c];
+					difff[k][c] = nvalf[k][c] - valf[k][c];
 				}
 			}
-			if (do_rect) {
-				newrect[0] = val_a + sample * diff_a;
-				newrect[1] = val_b + sample * diff_b;
-				newrect[2] = val_g + sample * diff_g;
-				newrect[3] = val_r + sample * diff_r;
-				newrect += 4;
-			}
-			if (do_float) {
-				newrectf[0] = val_af + sample * diff_af;
-				newrectf[1] = val_bf + sample * diff_bf;
-				newrectf[2] = val_gf + sample * diff_gf;
-				newrectf[3] = val_rf + sample * diff_rf;
-				newrectf += 4;
-			}
-			sample += add;
+			rectf += step;
 		}
+
+		for (k = 0; k < width; k++) {
+			float *newfp = newrectf + 4 * k;
+
+			newfp[0] = valf[k][0] + sample * difff[k][0];
+			newfp[1] = valf[k][1] + sample * difff[k][1];
+			newfp[2] = valf[k][2] + sample * difff[k][2];
+			newfp[3] = valf[k][3] + sample * difff[k][3];
+		}
+		newrectf += newstep;
+
+		sample += add;
 	}
+#endif
+}
 
-	if (do_rect) {
+static void scale_lines_cb(void *userdata, const int block)
+{
+	const ScaleLinesData *data = userdata;
+	const int start = block * data->block_size;
+	const int width = min_ii(data->block_size, data->totline - start);
+	const bool down = (data->newlen < data->len);
+
+	if (data->rect) {
+		const uchar *rect = data->rect + start * data->line_step;
+		uchar *newrect = data->newrect + start * data->newline_step;
+
+		if (down)
+			scaledown_lines_byte(rect, data->step, newrect, data->newstep, width, data->len, data->newlen, data->add);
+		else
+			scaleup_lines_byte(rect, data->step, newrect, data->newstep, width, data->newlen, data->add);
+	}
+	if (data->rectf) {
+		const float *rectf = data->rectf + start * data->line_step;
+		float *newrectf = data->newrectf + start * data->newline_step;
+
+		if (down)
+			scaledown_lines_float(rectf, data->step, newrectf, data->newstep, width, data->len, data->newlen, data->add);
+		else
+			scaleup_lines_float(rectf, data->step, newrectf, data->newstep, width, data->newlen, data->add);
+	}
+}
+
+/* allocates the new buffers, returns false when there is nothing to scale */
+static bool scale_lines_begin(ImBuf *ibuf, ScaleLinesData *data, size_t newpixels, const char *name)
+{
+	memset(data, 0, sizeof(*data));
+
+	if (ibuf->rect == NULL && ibuf->rect_float == NULL)
+		return false;
+
+	if (ibuf->rect) {
+		data->rect = (uchar *)ibuf->rect;
+		data->newrect = MEM_mallocN(newpixels * sizeof(uchar) * 4, name);
+		if (data->newrect == NULL)
+			return false;
+	}
+	if (ibuf->rect_float) {
+		data->rectf = ibuf->rect_float;
+		data->newrectf = MEM_mallocN(newpixels * sizeof(float) * 4, name);
+		if (data->newrectf == NULL) {
+			if (data->newrect) MEM_freeN(data->newrect);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static void scale_lines_end(ImBuf *ibuf, ScaleLinesData *data)
+{
+	const int totblock = (data->totline + data->block_size - 1) / data->block_size;
+
+	BLI_task_parallel_range(0, totblock, data, scale_lines_cb,
+	                        (size_t)data->newlen * data->totline >= SCALE_THREADED_MIN_PIXELS);
+
+	if (data->newrect) {
 		imb_freerectImBuf(ibuf);
 		ibuf->mall |= IB_rect;
-		ibuf->rect = (unsigned int *) _newrect;
+		ibuf->rect = (unsigned int *)data->newrect;
 	}
-	if (do_float) {
+	if (data->newrectf) {
 		imb_freerectfloatImBuf(ibuf);
 		ibuf->mall |= IB_rectfloat;
-		ibuf->rect_float = (float *) _newrectf;
+		ibuf->rect_float = data->newrectf;
 	}
-	
+}
+
+static ImBuf *scaledownx(struct ImBuf *ibuf, int newx)
+{
+	ScaleLinesData data;
+
+	if (!scale_lines_begin(ibuf, &data, (size_t)newx * ibuf->y, "scaledownx"))
+		return ibuf;
+
+	data.line_step = 4 * (size_t)ibuf->x;
+	data.newline_step = 4 * (size_t)newx;
+	data.step = data.newstep = 4;
+	data.len = ibuf->x;
+	data.newlen = newx;
+	data.totline = ibuf->y;
+	data.block_size = 1;
+	data.add = (ibuf->x - 0.01) / newx;
+
+	scale_lines_end(ibuf, &data);
+
 	ibuf->x = newx;
 	return(ibuf);
 }
 
-static ImBuf *scaleupy(struct ImBuf *ibuf, int newy)
+static ImBuf *scaledowny(struct ImBuf *ibuf, int newy)
 {
-	uchar *rect, *_newrect = NULL, *newrect;
-	float *rectf, *_newrectf = NULL, *newrectf;
-	float sample, add;
-	float val_a, nval_a, diff_a;
-	float val_b, nval_b, diff_b;
-	float val_g, nval_g, diff_g;
-	float val_r, nval_r, diff_r;
-	float val_af, nval_af, diff_af;
-	float val_bf, nval_bf, diff_bf;
-	float val_gf, nval_gf, diff_gf;
-	float val_rf, nval_rf, diff_rf;
-	int x, y, skipx;
-	bool do_rect = false, do_float = false;
-
-	val_a = nval_a = diff_a = val_b = nval_b = diff_b = 0;
-	val_g = nval_g = diff_g = val_r = nval_r = diff_r = 0;
-	val_af = nval_af = diff_af = val_bf = nval_bf = diff_bf = 0;
-	val_gf = nval_gf = diff_gf = val_rf = nval_rf = diff_rf = 0;
+	ScaleLinesData data;
+
+	if (!scale_lines_begin(ibuf, &data, (size_t)newy * ibuf->x, "scaledowny"))
+		return ibuf;
+
+	data.line_step = data.newline_step = 4;
+	data.step = data.newstep = 4 * (size_t)ibuf->x;
+	data.len = ibuf->y;
+	data.newlen = newy;
+	data.totline = ibuf->x;
+	data.block_size = SCALE_COLUMN_BLOCK;
+	data.add = (ibuf->y - 0.01) / newy;
+
+	scale_lines_end(ibuf, &data);
+
+	ibuf->y = newy;
+	return(ibuf);
+}
+
+static ImBuf *scaleupx(struct ImBuf *ibuf, int newx)
+{
+	ScaleLinesData data;
+
 	if (ibuf == NULL) return(NULL);
-	if (ibuf->rect == NULL && ibuf->rect_float == NULL) return (ibuf);
 
-	if (ibuf->rect) {
-		do_rect = true;
-		_newrect = MEM_mallocN(ibuf->x * newy * sizeof(int), "scaleupy");
-		if (_newrect == NULL) return(ibuf);
-	}
-	if (ibuf->rect_float) {
-		do_float = true;
-		_newrectf = MEM_mallocN(ibuf->x * newy * sizeof(float) * 4, "scaleupyf");
-		if (_newrectf == NULL) {
-			if (_newrect) MEM_freeN(_newrect);
-			return(ibuf);
-		}
-	}
+	if (!scale_lines_begin(ibuf, &data, (size_t)newx * ibuf->y, "scaleupx"))
+		return ibuf;
 
-	add = (ibuf->y - 1.001) / (newy - 1.0);
-	skipx = 4 * ibuf->x;
+	data.line_step = 4 * (size_t)ibuf->x;
+	data.newline_step = 4 * (size_t)newx;
+	data.step = data.newstep = 4;
+	data.len = ibuf->x;
+	data.newlen = newx;
+	data.totline = ibuf->y;
+	data.block_size = 1;
+	data.add = (ibuf->x - 1.001) / (newx - 1.0);
 
-	rect = (uchar *) ibuf->rect;
-	rectf = (float *) ibuf->rect_float;
-	newrect = _newrect;
-	newrectf = _newrectf;
+	scale_lines_end(ibuf, &data);
 
-	for (x = ibuf->x; x > 0; x--) {
+	ibuf->x = newx;
+	return(ibuf);
+}
 
-		sample = 0;
-		if (do_rect) {
-			rect = ((uchar *)ibuf->rect) + 4 * (x - 1);
-			newrect = _newrect + 4 * (x - 1);
-
-			val_a = rect[0];
-			nval_a = rect[skipx];
-			diff_a = nval_a - val_a;
-			val_a += 0.5f;
-
-			val_b = rect[1];
-			nval_b = rect[skipx + 1];
-			diff_b = nval_b - val_b;
-			val_b += 0.5f;
-
-			val_g = rect[2];
-			nval_g = rect[skipx + 2];
-			diff_g = nval_g - val_g;
-			val_g += 0.5f;
-
-			val_r = rect[3];
-			nval_r = rect[skipx + 3];
-			diff_r = nval_r - val_r;
-			val_r += 0.5f;
-
-			rect += 2 * skipx;
-		}
-		if (do_float) {
-			rectf = ibuf->rect_float + 4 * (x - 1);
-			newrectf = _newrectf + 4 * (x - 1);
+static ImBuf *scaleupy(struct ImBuf *ibuf, int newy)
+{
+	ScaleLinesData data;
 
-			val_af = rectf[0];
-			nval_af = rectf[skipx];
-			diff_af = nval_af - val_af;
-	
-			val_bf = rectf[1];
-			nval_bf = rectf[skipx + 1];
-			diff_bf = nval_bf - val_bf;
+	if (ibuf == NULL) return(NULL);
 
-			val_gf = rectf[2];
-			nval_gf = rectf[skipx + 2];
-			diff_gf = nval_gf - val_gf;
+	if (!scale_lines_begin(ibuf, &data, (size_t)newy * ibuf->x, "scaleupy"))
+		return ibuf;
 
-			val_rf = rectf[3];
-			nval_rf = rectf[skipx + 3];
-			diff_rf = nval_rf - val_rf;
+	data.line_step = data.newline_step = 4;
+	data.step = data.newstep = 4 * (size_t)ibuf->x;
+	data.len = ibuf->y;
+	data.newlen = newy;
+	data.totline = ibuf->x;
+	data.block_size = SCALE_COLUMN_BLOCK;
+	data.add = (ibuf->y - 1.001) / (newy - 1.0);
 
-			rectf += 2 * skipx;
-		}
-		
-		for (y = newy; y > 0; y--) {
-			if (sample >= 1.0f) {
-				sample -= 1.0f;
-
-				if (do_rect) {
-					val_a = nval_a;
-					nval_a = rect[0];
-					diff_a = nval_a - val_a;
-					val_a += 0.5f;
-
-					val_b = nval_b;
-					nval_b = rect[1];
-					diff_b = nval_b - val_b;
-					val_b += 0.5f;
-
-					val_g = nval_g;
-					nval_g = rect[2];
-					diff_g = nval_g - val_g;
-					val_g += 0.5f;
-
-					val_r = nval_r;
-					nval_r = rect[3];
-					diff_r = nval_r - val_r;
-					val_r += 0.5f;
-					rect += skipx;
-				}
-				if (do_float) {
-					val_af = nval_af;
-					nval_af = rectf[0];
-					diff_af = nval_af - val_af;
-	
-					val_bf = nval_bf;
-					nval_bf = rectf[1];
-					diff_bf = nval_bf - val_bf;
-
-					val_gf = nval_gf;
-					nval_gf = rectf[2];
-					diff_gf = nval_gf - val_gf;
-
-					val_rf = nval_rf;
-					nval_rf = rectf[3];
-					diff_rf = nval_rf - val_rf;
-					rectf += skipx;
-				}
-			}
-			if (do_rect) {
-				newrect[0] = val_a + sample * diff_a;
-				newrect[1] = val_b + sample * diff_b;
-				newrect[2] = val_g + sample * diff_g;
-				newrect[3] = val_r + sample * diff_r;
-				newrect += skipx;
-			}
-			if (do_float) {
-				newrectf[0] = val_af + sample * diff_af;
-				newrectf[1] = val_bf + sample * diff_bf;
-				newrectf[2] = val_gf + sample * diff_gf;
-				newrectf[3] = val_rf + sample * diff_rf;
-				newrectf += skipx;
-			}
-			sample += add;
-		}
-	}
+	scale_lines_end(ibuf, &data);
 
-	if (do_rect) {
-		imb_freerectImBuf(ibuf);
-		ibuf->mall |= IB_rect;
-		ibuf->rect = (unsigned int *) _newrect;
-	}
-	if (do_float) {
-		imb_freerectfloatImBuf(ibuf);
-		ibuf->mall |= IB_rectfloat;
-		ibuf->rect_float = (float *) _newrectf;
-	}
-	
 	ibuf->y = newy;
 	return(ibuf);
 }
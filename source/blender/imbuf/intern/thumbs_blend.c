@@ -56,20 +56,20 @@ ImBuf *IMB_thumb_load_blend(const char *blen_path, const char *blen_group, const
 
 	if (blen_group && blen_id) {
 		LinkNode *ln, *names, *lp, *previews = NULL;
-		struct BlendHandle *libfiledata = BLO_blendhandle_from_file(blen_path, NULL);
+		struct BlendFileIndex *libindex = BLO_blendfile_index_get(blen_path, NULL);
 		int idcode = BKE_idcode_from_name(blen_group);
 		int i, nprevs, nnames;
 
-		if (libfiledata == NULL) {
+		if (libindex == NULL) {
 			return ima;
 		}
 
-		/* Note: we should handle all previews for a same group at once, would avoid reopening .blend file
-		 *       for each and every ID. However, this adds some complexity, so keep it for later. */
-		names = BLO_blendhandle_get_datablock_names(libfiledata, idcode, &nnames);
-		previews = BLO_blendhandle_get_previews(libfiledata, idcode, &nprevs);
+		/* Note: the index of the last read libraries is kept in memory, so the .blend file is only
+		 *       scanned once for all the previews of a library, not for each and every ID. */
+		names = BLO_blendfile_index_get_datablock_names(libindex, idcode, &nnames);
+		previews = BLO_blendfile_index_get_previews(libindex, idcode, &nprevs);
 
-		BLO_blendhandle_close(libfiledata);
+		BLO_blendfile_index_release(libindex);
 
 		if (!previews || (nnames != nprevs)) {
 			if (previews != 0) {
@@ -1560,6 +1560,8 @@ typedef struct MeshSeqCacheModifierData {
 
 	char read_flag;
 	char pad[7];
+
+	struct MeshSeqCacheSamples *samples;  /* runtime only, recently decoded meshes */
 } MeshSeqCacheModifierData;
 
 /* MeshSeqCacheModifierData.read_flag */
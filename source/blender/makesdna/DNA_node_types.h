@@ -356,6 +356,7 @@ typedef struct bNodeTree {
 	int chunksize;					/* tile size for compositor engine */
 	
 	rctf viewer_border;
+	rctf viewer_region;				/* runtime, part of the viewer image visible in the editors */
 	
 	/* Lists of bNodeSocket to hold default values and own_index.
 	 * Warning! Don't make links to these sockets, input/output nodes are used for that.
@@ -371,7 +372,7 @@ typedef struct bNodeTree {
 	 * in case multiple different editors are used and make context ambiguous.
 	 */
 	bNodeInstanceKey active_viewer_key;
-	int pad;
+	float viewer_zoom;				/* runtime, largest zoom of the editors showing the viewer image */
 	
 	/* execution data */
 	/* XXX It would be preferable to completely move this data out of the underlying node tree,
@@ -410,6 +411,8 @@ typedef struct bNodeTree {
 #define NTREE_COM_GROUPNODE_BUFFER	8	/* use groupnode buffers */
 #define NTREE_VIEWER_BORDER			16	/* use a border for viewer nodes */
 #define NTREE_IS_LOCALIZED			32	/* tree is localized copy, free when deleting node groups */
+#define NTREE_COM_HALF_BUFFERS		64	/* store color buffers as half floats */
+#define NTREE_VIEWER_REGION			128	/* only calculate the visible region of viewer nodes */
 
 /* XXX not nice, but needed as a temporary flags
  * for group updates after library linking.
@@ -505,6 +508,7 @@ enum {
 enum {
 	CMP_NODEFLAG_BLUR_VARIABLE_SIZE = (1 << 0),
 	CMP_NODEFLAG_BLUR_EXTEND_BOUNDS = (1 << 1),
+	CMP_NODEFLAG_BLUR_RECURSIVE     = (1 << 2),
 };
 
 typedef struct NodeFrame {
@@ -206,6 +206,9 @@ typedef struct PointCache {
 
 	struct PTCacheEdit *edit;
 	void (*free_edit)(struct PTCacheEdit *edit);	/* free callback */
+
+	struct PTCachePrefetch *prefetch;	/* runtime only, frames read ahead from disk during playback */
+	struct PTCacheContainer *container;	/* runtime only, frame index of the single file disk cache */
 } PointCache;
 
 typedef struct SBVertex {
@@ -411,6 +414,8 @@ typedef struct SoftBody {
 /* high resolution cache is saved for smoke for backwards compatibility, so set this flag to know it's a "fake" cache */
 #define PTCACHE_FAKE_SMOKE			(1<<12)
 #define PTCACHE_IGNORE_CLEAR		(1<<13)
+/* disk cache frames are stored in one file with a frame index, see PTCACHE_CONTAINER_EXT */
+#define PTCACHE_DISK_SINGLE_FILE	(1<<14)
 
 /* PTCACHE_OUTDATED + PTCACHE_FRAMES_SKIPPED */
 #define PTCACHE_REDO_NEEDED			258
@@ -52,6 +52,7 @@ struct Image;
 struct PreviewImage;
 struct ImBuf;
 struct Ocean;
+struct OpenVDBSparseGrid;
 struct CurveMapping;
 
 typedef struct MTex {
@@ -187,11 +188,13 @@ typedef struct VoxelData {
 	float int_multiplier;
 	int still_frame;
 	char source_path[1024];  /* 1024 = FILE_MAX */
+	char grid_name[64];  /* grid read from OpenVDB files */
 
 	/* temporary data */
 	float *dataset;
 	int cachedframe;
 	int ok;
+	struct OpenVDBSparseGrid *grid;  /* instead of dataset for OpenVDB files */
 	
 } VoxelData;
 
@@ -632,8 +635,9 @@ enum {
 #define TEX_VD_IMAGE_SEQUENCE	3
 #define TEX_VD_SMOKE			4
 #define TEX_VD_HAIR				5
+#define TEX_VD_OPENVDB			6
 /* for voxels which use VoxelData->source_path */
-#define TEX_VD_IS_SOURCE_PATH(_format) (ELEM(_format, TEX_VD_BLENDERVOXEL, TEX_VD_RAW_8BIT, TEX_VD_RAW_16BIT))
+#define TEX_VD_IS_SOURCE_PATH(_format) (ELEM(_format, TEX_VD_BLENDERVOXEL, TEX_VD_RAW_8BIT, TEX_VD_RAW_16BIT, TEX_VD_OPENVDB))
 
 /* smoke data types */
 #define TEX_VD_SMOKEDENSITY		0
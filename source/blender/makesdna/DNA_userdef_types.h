@@ -569,7 +569,13 @@ typedef struct UserDef {
 	struct WalkNavigation walk_navigation;
 
 	short opensubdiv_compute_type;
-	char pad5[6];
+	char pad5[2];
+
+	int ptcache_prefetch_limit;	/* megabytes of point cache frames read ahead during playback */
+	int image_tile_cache_limit;	/* megabytes of tiles loaded from tiled image files */
+	int compositor_cache_limit;	/* megabytes of compositor results kept between executions */
+	int compositor_memory_limit;	/* megabytes of intermediate compositor buffers before they're streamed */
+	int pad7;
 } UserDef;
 
 extern UserDef U; /* from blenkernel blender.c */
@@ -616,6 +622,7 @@ typedef enum eUserPref_Flag {
 	USER_NONEGFRAMES		= (1 << 24),
 	USER_TXT_TABSTOSPACES_DISABLE	= (1 << 25),
 	USER_TOOLTIPS_PYTHON    = (1 << 26),
+	USER_BLENDFILE_INDEX    = (1 << 27),
 } eUserPref_Flag;
 
 /* flag */
@@ -209,6 +209,7 @@ static void rna_Image_update(Image *image, ReportList *reports)
 	if (ibuf->rect)
 		IMB_rect_from_float(ibuf);
 
+	IMB_tag_changed(ibuf);
 	ibuf->userflags |= IB_DISPLAY_BUFFER_INVALID;
 
 	BKE_image_release_ibuf(image, ibuf, NULL);
@@ -99,6 +99,13 @@ static EnumPropertyItem node_chunksize_items[] = {
 	{NTREE_CHUNCKSIZE_1024, "1024",   0,    "1024x1024", "Chunksize of 1024x1024"},
 	{0, NULL, 0, NULL, NULL}
 };
+
+static EnumPropertyItem node_buffer_precision_items[] = {
+	{0,                      "FULL", 0, "Full", "Store buffers as 32 bit floats"},
+	{NTREE_COM_HALF_BUFFERS, "HALF", 0, "Half", "Store color and matte buffers as 16 bit half floats, using half the memory. "
+	                          "Depth and vector buffers keep 32 bit floats"},
+	{0, NULL, 0, NULL, NULL}
+};
 #endif
 
 #define DEF_ICON_BLANK_SKIP
@@ -4500,6 +4507,12 @@ static void def_cmp_blur(StructRNA *srna)
 	RNA_def_property_ui_text(prop, "Variable Size", "Support variable blur per-pixel when using an image for size input");
 	RNA_def_property_update(prop, NC_NODE | NA_EDITED, "rna_Node_update");
 
+	prop = RNA_def_property(srna, "use_recursive", PROP_BOOLEAN, PROP_NONE);
+	RNA_def_property_boolean_sdna(prop, NULL, "custom1", CMP_NODEFLAG_BLUR_RECURSIVE);
+	RNA_def_property_ui_text(prop, "Recursive", "Use a recursive filter for large Gaussian radii, "
+	                         "faster but slightly less accurate");
+	RNA_def_property_update(prop, NC_NODE | NA_EDITED, "rna_Node_update");
+
 	prop = RNA_def_property(srna, "use_extended_bounds", PROP_BOOLEAN, PROP_NONE);
 	RNA_def_property_boolean_sdna(prop, NULL, "custom1", CMP_NODEFLAG_BLUR_EXTEND_BOUNDS);
 	RNA_def_property_ui_text(prop, "Extend Bounds", "Extend bounds of the input image to fully fit blurred image");
@@ -8258,6 +8271,11 @@ static void rna_def_composite_nodetree(BlenderRNA *brna)
 	RNA_def_property_ui_text(prop, "Chunksize", "Max size of a tile (smaller values gives better distribution "
 	                                            "of multiple threads, but more overhead)");
 
+	prop = RNA_def_property(srna, "buffer_precision", PROP_ENUM, PROP_NONE);
+	RNA_def_property_enum_bitflag_sdna(prop, NULL, "flag");
+	RNA_def_property_enum_items(prop, node_buffer_precision_items);
+	RNA_def_property_ui_text(prop, "Buffer Precision", "Precision of the buffers kept between operations");
+
 	prop = RNA_def_property(srna, "use_opencl", PROP_BOOLEAN, PROP_NONE);
 	RNA_def_property_boolean_sdna(prop, NULL, "flag", NTREE_COM_OPENCL);
 	RNA_def_property_ui_text(prop, "OpenCL", "Enable GPU calculations");
@@ -8275,6 +8293,13 @@ static void rna_def_composite_nodetree(BlenderRNA *brna)
 	RNA_def_property_boolean_sdna(prop, NULL, "flag", NTREE_VIEWER_BORDER);
 	RNA_def_property_ui_text(prop, "Viewer Border", "Use boundaries for viewer nodes and composite backdrop");
 	RNA_def_property_update(prop, NC_NODE | ND_DISPLAY, "rna_NodeTree_update");
+
+	prop = RNA_def_property(srna, "use_viewer_region", PROP_BOOLEAN, PROP_NONE);
+	RNA_def_property_boolean_sdna(prop, NULL, "flag", NTREE_VIEWER_REGION);
+	RNA_def_property_ui_text(prop, "Viewer Region", "Only calculate the part of viewer nodes that is visible in the "
+	                                               "image editor and composite backdrop, a preview at the display "
+	                                               "resolution is shown first when zoomed out");
+	RNA_def_property_update(prop, NC_NODE | ND_DISPLAY, "rna_NodeTree_update");
 }
 
 static void rna_def_shader_nodetree(BlenderRNA *brna)
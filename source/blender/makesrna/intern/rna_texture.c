@@ -469,6 +469,13 @@ static char *rna_VoxelData_path(PointerRNA *UNUSED(ptr))
 	return BLI_sprintfN("voxel_data");
 }
 
+static int rna_VoxelData_memory_get(PointerRNA *ptr)
+{
+	VoxelData *vd = ptr->data;
+
+	return (int)(BKE_texture_voxeldata_memory(vd) / 1024);
+}
+
 static char *rna_OceanTex_path(PointerRNA *UNUSED(ptr))
 {
 	return BLI_sprintfN("ocean");
@@ -1854,6 +1861,10 @@ static void rna_def_texture_voxeldata(BlenderRNA *brna)
 		                        "Generate voxels from a sequence of image slices"},
 		{TEX_VD_SMOKE, "SMOKE", 0, "Smoke", "Render voxels from a Blender smoke simulation"},
 		{TEX_VD_HAIR, "HAIR", 0, "Hair", "Render voxels from a Blender hair simulation"},
+#ifdef WITH_OPENVDB
+		{TEX_VD_OPENVDB, "OPENVDB", 0, "OpenVDB",
+		                 "Sample a grid of an OpenVDB file without converting it to a dense data set"},
+#endif
 		{0, NULL, 0, NULL, NULL}
 	};
 	
@@ -1926,6 +1937,11 @@ static void rna_def_texture_voxeldata(BlenderRNA *brna)
 	RNA_def_property_ui_text(prop, "Source Path", "The external source data file to use");
 	RNA_def_property_update(prop, 0, "rna_Texture_voxeldata_update");
 	
+	prop = RNA_def_property(srna, "grid_name", PROP_STRING, PROP_NONE);
+	RNA_def_property_string_sdna(prop, NULL, "grid_name");
+	RNA_def_property_ui_text(prop, "Grid", "Name of the grid to read from OpenVDB files");
+	RNA_def_property_update(prop, 0, "rna_Texture_voxeldata_update");
+
 	prop = RNA_def_property(srna, "resolution", PROP_INT, PROP_NONE);
 	RNA_def_property_int_sdna(prop, NULL, "resol");
 	RNA_def_property_range(prop, 1, 100000);
@@ -1949,6 +1965,12 @@ static void rna_def_texture_voxeldata(BlenderRNA *brna)
 	RNA_def_property_flag(prop, PROP_EDITABLE);
 	RNA_def_property_update(prop, 0, "rna_Texture_voxeldata_update");
 
+	prop = RNA_def_property(srna, "memory", PROP_INT, PROP_UNSIGNED);
+	RNA_def_property_int_funcs(prop, "rna_VoxelData_memory_get", NULL, NULL);
+	RNA_def_property_clear_flag(prop, PROP_EDITABLE);
+	RNA_def_property_ui_text(prop, "Memory",
+	                         "Memory used by the data set loaded for the last render, in kilobytes");
+
 	
 	srna = RNA_def_struct(brna, "VoxelDataTexture", "Texture");
 	RNA_def_struct_sdna(srna, "Tex");
@@ -113,6 +113,8 @@ static EnumPropertyItem rna_enum_language_default_items[] = {
 #include "MEM_guardedalloc.h"
 #include "MEM_CacheLimiterC-Api.h"
 
+#include "IMB_imbuf.h"
+
 #include "UI_interface.h"
 
 #ifdef WITH_OPENSUBDIV
@@ -366,6 +368,11 @@ static void rna_Userdef_memcache_update(Main *UNUSED(bmain), Scene *UNUSED(scene
 	MEM_CacheLimiter_set_maximum(((size_t) U.memcachelimit) * 1024 * 1024);
 }
 
+static void rna_Userdef_image_tile_cache_update(Main *UNUSED(bmain), Scene *UNUSED(scene), PointerRNA *UNUSED(ptr))
+{
+	IMB_tile_cache_set_limit(U.image_tile_cache_limit);
+}
+
 static void rna_UserDef_weight_color_update(Main *bmain, Scene *scene, PointerRNA *ptr)
 {
 	Object *ob;
@@ -4059,6 +4066,35 @@ static void rna_def_userdef_system(BlenderRNA *brna)
 	RNA_def_property_ui_text(prop, "Memory Cache Limit", "Memory cache limit (in megabytes)");
 	RNA_def_property_update(prop, 0, "rna_Userdef_memcache_update");
 
+	prop = RNA_def_property(srna, "point_cache_prefetch_limit", PROP_INT, PROP_NONE);
+	RNA_def_property_int_sdna(prop, NULL, "ptcache_prefetch_limit");
+	RNA_def_property_range(prop, 1, (sizeof(void *) == 8) ? 1024 * 32 : 1024);
+	RNA_def_property_ui_text(prop, "Point Cache Prefetch Limit",
+	                         "Memory limit for the disk cache frames read ahead during playback, "
+	                         "shared by all point caches (in megabytes)");
+
+	prop = RNA_def_property(srna, "image_tile_cache_limit", PROP_INT, PROP_NONE);
+	RNA_def_property_int_sdna(prop, NULL, "image_tile_cache_limit");
+	RNA_def_property_range(prop, 1, (sizeof(void *) == 8) ? 1024 * 32 : 1024);
+	RNA_def_property_ui_text(prop, "Image Tile Cache Limit",
+	                         "Memory limit for the tiles loaded from tiled image files, tiles over the limit "
+	                         "are moved to a temporary file (in megabytes)");
+	RNA_def_property_update(prop, 0, "rna_Userdef_image_tile_cache_update");
+
+	prop = RNA_def_property(srna, "compositor_cache_limit", PROP_INT, PROP_NONE);
+	RNA_def_property_int_sdna(prop, NULL, "compositor_cache_limit");
+	RNA_def_property_range(prop, 1, (sizeof(void *) == 8) ? 1024 * 32 : 1024);
+	RNA_def_property_ui_text(prop, "Compositor Cache Limit",
+	                         "Memory limit for the results of expensive compositor nodes kept between "
+	                         "executions (in megabytes)");
+
+	prop = RNA_def_property(srna, "compositor_memory_limit", PROP_INT, PROP_NONE);
+	RNA_def_property_int_sdna(prop, NULL, "compositor_memory_limit");
+	RNA_def_property_range(prop, 64, (sizeof(void *) == 8) ? 1024 * 32 : 1024);
+	RNA_def_property_ui_text(prop, "Compositor Memory Limit",
+	                         "Memory limit for the intermediate buffers of a compositor execution, larger "
+	                         "buffers are kept in tiles and written to a scratch file (in megabytes)");
+
 	prop = RNA_def_property(srna, "frame_server_port", PROP_INT, PROP_NONE);
 	RNA_def_property_int_sdna(prop, NULL, "frameserverport");
 	RNA_def_property_range(prop, 0, 32727);
@@ -4588,6 +4624,12 @@ static void rna_def_userdef_filepaths(BlenderRNA *brna)
 	RNA_def_property_boolean_sdna(prop, NULL, "flag", USER_SAVE_PREVIEWS);
 	RNA_def_property_ui_text(prop, "Save Preview Images",
 	                         "Enables automatic saving of preview images in the .blend file");
+
+	prop = RNA_def_property(srna, "use_blendfile_index", PROP_BOOLEAN, PROP_NONE);
+	RNA_def_property_boolean_sdna(prop, NULL, "flag", USER_BLENDFILE_INDEX);
+	RNA_def_property_ui_text(prop, "Library Index",
+	                         "Store the list of data-blocks and previews of browsed libraries in a hidden file "
+	                         "next to them, to speed up browsing them again");
 }
 
 static void rna_def_userdef_addon_collection(BlenderRNA *brna, PropertyRNA *cprop)
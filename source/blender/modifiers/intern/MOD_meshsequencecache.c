@@ -24,12 +24,24 @@
  *  \ingroup modifiers
  */
 
+#include <string.h>
+
+#include "MEM_guardedalloc.h"
+
 #include "DNA_cachefile_types.h"
+#include "DNA_meshdata_types.h"
 #include "DNA_modifier_types.h"
 #include "DNA_object_types.h"
 #include "DNA_scene_types.h"
 
+#include "BLI_hash_mm2a.h"
+#include "BLI_listbase.h"
+#include "BLI_string.h"
+#include "BLI_threads.h"
+#include "BLI_utildefines.h"
+
 #include "BKE_cachefile.h"
+#include "BKE_cdderivedmesh.h"
 #include "BKE_DerivedMesh.h"
 #include "BKE_global.h"
 #include "BKE_library.h"
@@ -45,6 +57,205 @@
 #	include "ABC_alembic.h"
 #endif
 
+/* -------------------------------------------------------------------- */
+/* Sample Cache
+ *
+ * Recently decoded meshes are kept, so scrubbing back and forth over the
+ * same frames doesn't read and decode the samples again.
+ *
+ * The decoded mesh depends on the input mesh (its topology is reused when it matches, and its
+ * other data is kept), so samples are keyed by time and a hash of the input mesh.
+ * All modifiers share one memory budget, least recently used samples are freed first. */
+
+#define SAMPLE_CACHE_ITEMS_MAX 32
+#define SAMPLE_CACHE_MEM_MAX ((size_t)512 * 1024 * 1024)
+
+typedef struct MeshSeqCacheInputKey {
+	int totvert, totedge, totloop, totpoly;
+	unsigned int hash;
+} MeshSeqCacheInputKey;
+
+typedef struct MeshSeqCacheSample {
+	struct MeshSeqCacheSample *next, *prev;
+	/* in 'sample_cache_lru', data is the sample */
+	LinkData lru_link;
+	struct MeshSeqCacheSamples *owner;
+
+	float time;
+	MeshSeqCacheInputKey input;
+	DerivedMesh *dm;
+	size_t mem_size;
+} MeshSeqCacheSample;
+
+typedef struct MeshSeqCacheSamples {
+	ListBase samples;  /* MeshSeqCacheSample, most recently used first */
+	int tot;
+
+	/* settings the samples were read with */
+	struct CacheReader *reader;
+	CacheFile *cache_file;
+	char object_path[1024];
+	char read_flag;
+} MeshSeqCacheSamples;
+
+/* samples of all modifiers, most recently used first,
+ * modifiers of different objects are evaluated from several threads */
+static ListBase sample_cache_lru = {NULL, NULL};
+static size_t sample_cache_mem_size = 0;
+static ThreadMutex sample_cache_mutex = BLI_MUTEX_INITIALIZER;
+
+/* call with the mutex locked */
+static void sample_free(MeshSeqCacheSample *sample)
+{
+	MeshSeqCacheSamples *cache = sample->owner;
+
+	BLI_remlink(&cache->samples, sample);
+	cache->tot--;
+	BLI_remlink(&sample_cache_lru, &sample->lru_link);
+	sample_cache_mem_size -= sample->mem_size;
+
+	sample->dm->release(sample->dm);
+	MEM_freeN(sample);
+}
+
+static void sample_cache_free(MeshSeqCacheModifierData *mcmd)
+{
+	MeshSeqCacheSamples *cache = mcmd->samples;
+
+	if (cache == NULL) {
+		return;
+	}
+
+	BLI_mutex_lock(&sample_cache_mutex);
+	while (cache->samples.first) {
+		sample_free(cache->samples.first);
+	}
+	BLI_mutex_unlock(&sample_cache_mutex);
+
+	MEM_freeN(cache);
+	mcmd->samples = NULL;
+}
+
+#ifdef WITH_ALEMBIC
+
+/* approximate, only counts the mesh elements */
+static size_t sample_mem_size(DerivedMesh *dm)
+{
+	return ((size_t)dm->getNumVerts(dm) * sizeof(MVert) +
+	        (size_t)dm->getNumEdges(dm) * sizeof(MEdge) +
+	        (size_t)dm->getNumLoops(dm) * (sizeof(MLoop) + sizeof(MLoopUV)) +
+	        (size_t)dm->getNumPolys(dm) * sizeof(MPoly));
+}
+
+static void sample_input_key(DerivedMesh *dm, MeshSeqCacheInputKey *r_key)
+{
+	unsigned int hash = 0;
+
+	r_key->totvert = dm->getNumVerts(dm);
+	r_key->totedge = dm->getNumEdges(dm);
+	r_key->totloop = dm->getNumLoops(dm);
+	r_key->totpoly = dm->getNumPolys(dm);
+
+	/* the data the decoded mesh keeps from the input, much cheaper to hash than reading a sample */
+	hash = BLI_hash_mm2((const unsigned char *)dm->getVertArray(dm), sizeof(MVert) * (size_t)r_key->totvert, hash);
+	hash = BLI_hash_mm2((const unsigned char *)dm->getEdgeArray(dm), sizeof(MEdge) * (size_t)r_key->totedge, hash);
+	hash = BLI_hash_mm2((const unsigned char *)dm->getLoopArray(dm), sizeof(MLoop) * (size_t)r_key->totloop, hash);
+	hash = BLI_hash_mm2((const unsigned char *)dm->getPolyArray(dm), sizeof(MPoly) * (size_t)r_key->totpoly, hash);
+	r_key->hash = hash;
+}
+
+/* get the cache, cleared when the samples were read with other settings */
+static MeshSeqCacheSamples *sample_cache_ensure(MeshSeqCacheModifierData *mcmd)
+{
+	MeshSeqCacheSamples *cache = mcmd->samples;
+
+	if (cache &&
+	    (cache->reader != mcmd->reader ||
+	     cache->cache_file != mcmd->cache_file ||
+	     cache->read_flag != mcmd->read_flag ||
+	     !STREQ(cache->object_path, mcmd->object_path)))
+	{
+		sample_cache_free(mcmd);
+		cache = NULL;
+	}
+
+	if (cache == NULL) {
+		cache = mcmd->samples = MEM_callocN(sizeof(MeshSeqCacheSamples), "MeshSeqCacheSamples");
+		cache->reader = mcmd->reader;
+		cache->cache_file = mcmd->cache_file;
+		cache->read_flag = mcmd->read_flag;
+		BLI_strncpy(cache->object_path, mcmd->object_path, sizeof(cache->object_path));
+	}
+
+	return cache;
+}
+
+/* returns a copy of the cached mesh */
+static DerivedMesh *sample_cache_lookup(MeshSeqCacheSamples *cache, const float time, const MeshSeqCacheInputKey *input)
+{
+	MeshSeqCacheSample *sample;
+	DerivedMesh *result = NULL;
+
+	BLI_mutex_lock(&sample_cache_mutex);
+
+	for (sample = cache->samples.first; sample; sample = sample->next) {
+		if (sample->time == time && memcmp(&sample->input, input, sizeof(*input)) == 0) {
+			BLI_remlink(&cache->samples, sample);
+			BLI_addhead(&cache->samples, sample);
+			BLI_remlink(&sample_cache_lru, &sample->lru_link);
+			BLI_addhead(&sample_cache_lru, &sample->lru_link);
+
+			result = CDDM_copy(sample->dm);
+			break;
+		}
+	}
+
+	BLI_mutex_unlock(&sample_cache_mutex);
+
+	return result;
+}
+
+static void sample_cache_add(MeshSeqCacheSamples *cache, const float time, const MeshSeqCacheInputKey *input,
+                             DerivedMesh *dm)
+{
+	MeshSeqCacheSample *sample = MEM_callocN(sizeof(MeshSeqCacheSample), "MeshSeqCacheSample");
+
+	sample->owner = cache;
+	sample->lru_link.data = sample;
+	sample->time = time;
+	sample->input = *input;
+	sample->dm = CDDM_copy(dm);
+	sample->mem_size = sample_mem_size(sample->dm);
+
+	BLI_mutex_lock(&sample_cache_mutex);
+
+	BLI_addhead(&cache->samples, sample);
+	cache->tot++;
+	BLI_addhead(&sample_cache_lru, &sample->lru_link);
+	sample_cache_mem_size += sample->mem_size;
+
+	/* free the least recently used samples of this modifier, always keeping the new one */
+	while (cache->tot > SAMPLE_CACHE_ITEMS_MAX) {
+		sample_free(cache->samples.last);
+	}
+
+	/* and of all modifiers over the budget */
+	while (sample_cache_mem_size > SAMPLE_CACHE_MEM_MAX) {
+		LinkData *link_last = sample_cache_lru.last;
+
+		if (link_last == &sample->lru_link) {
+			break;
+		}
+		sample_free(link_last->data);
+	}
+
+	BLI_mutex_unlock(&sample_cache_mutex);
+}
+
+#endif  /* WITH_ALEMBIC */
+
+/* -------------------------------------------------------------------- */
+
 static void initData(ModifierData *md)
 {
 	MeshSeqCacheModifierData *mcmd = (MeshSeqCacheModifierData *)md;
@@ -67,6 +278,7 @@ static void copyData(ModifierData *md, ModifierData *target)
 		id_us_plus(&tmcmd->cache_file->id);
 		tmcmd->reader = NULL;
 	}
+	tmcmd->samples = NULL;
 }
 
 static void freeData(ModifierData *md)
@@ -83,6 +295,7 @@ static void freeData(ModifierData *md)
 #endif
 		mcmd->reader = NULL;
 	}
+	sample_cache_free(mcmd);
 }
 
 static bool isDisabled(ModifierData *md, int UNUSED(useRenderParams))
@@ -111,6 +324,9 @@ static DerivedMesh *applyModifier(ModifierData *md, Object *ob,
 	BKE_cachefile_ensure_handle(G.main, cache_file);
 
 	if (!mcmd->reader) {
+		/* the reader was freed, e.g. when reloading the file */
+		sample_cache_free(mcmd);
+
 		mcmd->reader = CacheReader_open_alembic_object(cache_file->handle,
 		                                               mcmd->reader,
 		                                               ob,
@@ -121,6 +337,24 @@ static DerivedMesh *applyModifier(ModifierData *md, Object *ob,
 		}
 	}
 
+	/* Only cache when the result doesn't depend on preceding modifiers. */
+	MeshSeqCacheSamples *samples = NULL;
+	MeshSeqCacheInputKey input;
+
+	if (md == ob->modifiers.first) {
+		samples = sample_cache_ensure(mcmd);
+		sample_input_key(dm, &input);
+
+		DerivedMesh *result = sample_cache_lookup(samples, time, &input);
+
+		if (result) {
+			return result;
+		}
+	}
+	else {
+		sample_cache_free(mcmd);
+	}
+
 	DerivedMesh *result = ABC_read_mesh(mcmd->reader,
 	                                    ob,
 	                                    dm,
@@ -131,6 +365,9 @@ static DerivedMesh *applyModifier(ModifierData *md, Object *ob,
 	if (err_str) {
 		modifier_setError(md, "%s", err_str);
 	}
+	else if (samples && result) {
+		sample_cache_add(samples, time, &input, result);
+	}
 
 	return result ? result : dm;
 	UNUSED_VARS(flag);
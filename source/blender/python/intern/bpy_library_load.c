@@ -216,13 +216,13 @@ static PyObject *bpy_lib_load(PyObject *UNUSED(self), PyObject *args, PyObject *
 	return (PyObject *)ret;
 }
 
-static PyObject *_bpy_names(BPy_Library *self, int blocktype)
+static PyObject *_bpy_names(BlendFileIndex *libindex, int blocktype)
 {
 	PyObject *list;
 	LinkNode *l, *names;
 	int totnames;
 
-	names = BLO_blendhandle_get_datablock_names(self->blo_handle, blocktype, &totnames);
+	names = BLO_blendfile_index_get_datablock_names(libindex, blocktype, &totnames);
 	list = PyList_New(totnames);
 
 	if (names) {
@@ -242,13 +242,15 @@ static PyObject *bpy_lib_enter(BPy_Library *self, PyObject *UNUSED(args))
 	PyObject *ret;
 	BPy_Library *self_from;
 	PyObject *from_dict = _PyDict_NewPresized(MAX_LIBARRAY);
+	BlendFileIndex *libindex;
 	ReportList reports;
 
 	BKE_reports_init(&reports, RPT_STORE);
 
-	self->blo_handle = BLO_blendhandle_from_file(self->abspath, &reports);
+	/* the names are listed from the index, the file is only opened in __exit__ to link from it */
+	libindex = BLO_blendfile_index_get(self->abspath, &reports);
 
-	if (self->blo_handle == NULL) {
+	if (libindex == NULL) {
 		if (BPy_reports_to_error(&reports, PyExc_IOError, true) != -1) {
 			PyErr_Format(PyExc_IOError,
 			             "load: %s failed to open blend file",
@@ -266,12 +268,14 @@ static PyObject *bpy_lib_enter(BPy_Library *self, PyObject *UNUSED(args))
 
 				PyDict_SetItem(self->dict, str, item = PyList_New(0));
 				Py_DECREF(item);
-				PyDict_SetItem(from_dict, str, item = _bpy_names(self, code));
+				PyDict_SetItem(from_dict, str, item = _bpy_names(libindex, code));
 				Py_DECREF(item);
 
 				Py_DECREF(str);
 			}
 		}
+
+		BLO_blendfile_index_release(libindex);
 	}
 
 	/* create a dummy */
@@ -327,11 +331,47 @@ static void bpy_lib_exit_warn_type(BPy_Library *self, PyObject *item)
 	PyErr_Restore(exc, val, tb);
 }
 
+/* are any ID's requested in the lists of data_to */
+static bool bpy_lib_has_requests(BPy_Library *self)
+{
+	int idcode_step = 0, idcode;
+	while ((idcode = BKE_idcode_iter_step(&idcode_step))) {
+		if (BKE_idcode_is_linkable(idcode)) {
+			PyObject *ls = PyDict_GetItemString(self->dict, BKE_idcode_to_name_plural(idcode));
+			if (ls && PyList_Check(ls) && PyList_GET_SIZE(ls) != 0) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
 static PyObject *bpy_lib_exit(BPy_Library *self, PyObject *UNUSED(args))
 {
 	Main *bmain = CTX_data_main(BPy_GetContext());
 	Main *mainl = NULL;
 	int err = 0;
+	ReportList reports;
+
+	/* only listing the names, the file doesn't need to be opened */
+	if (!bpy_lib_has_requests(self)) {
+		Py_RETURN_NONE;
+	}
+
+	BKE_reports_init(&reports, RPT_STORE);
+
+	self->blo_handle = BLO_blendhandle_from_file(self->abspath, &reports);
+
+	if (self->blo_handle == NULL) {
+		if (BPy_reports_to_error(&reports, PyExc_IOError, true) != -1) {
+			PyErr_Format(PyExc_IOError,
+			             "load: %s failed to open blend file",
+			             self->abspath);
+		}
+		return NULL;
+	}
+
+	BKE_reports_clear(&reports);
 
 	BKE_main_id_tag_all(bmain, LIB_TAG_PRE_EXISTING, true);
 
@@ -179,6 +179,10 @@ typedef struct RenderResult {
 	char *error;
 
 	struct StampData *stamp_data;
+
+	/* renewed whenever passes are written, 0 when unknown,
+	 * so results derived from the passes can be reused without comparing pixels */
+	unsigned int changestamp;
 } RenderResult;
 
 
@@ -67,6 +67,10 @@ void render_result_views_new(struct RenderResult *rr, struct RenderData *rd);
 
 void render_result_merge(struct RenderResult *rr, struct RenderResult *rrpart);
 
+/* Change Stamp */
+
+void render_result_tag_changed(struct RenderResult *rr);
+
 /* Free */
 
 void render_result_free(struct RenderResult *rr);
@@ -716,6 +716,7 @@ static int get_next_bake_face(BakeShade *bs)
 					}
 
 					/* Tag image for redraw. */
+					IMB_tag_changed(ibuf);
 					ibuf->userflags |= IB_DISPLAY_BUFFER_INVALID;
 					BKE_image_release_ibuf(ima, ibuf, NULL);
 				}
@@ -1137,6 +1138,7 @@ int RE_bake_shade_all_selected(Render *re, int type, Object *actob, short *do_up
 					RE_bake_ibuf_filter(ibuf, userdata->mask_buffer, re->r.bake_filter);
 				}
 
+				IMB_tag_changed(ibuf);
 				ibuf->userflags |= IB_BITMAPDIRTY;
 				BKE_image_release_ibuf(ima, ibuf, NULL);
 			}
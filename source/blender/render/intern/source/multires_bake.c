@@ -390,6 +390,7 @@ static void *do_multires_bake_thread(void *data_v)
 		if (data->ibuf->rect_float)
 			data->ibuf->userflags |= IB_RECT_INVALID;
 
+		IMB_tag_changed(data->ibuf);
 		data->ibuf->userflags |= IB_DISPLAY_BUFFER_INVALID;
 
 		/* update progress */
@@ -1263,6 +1264,7 @@ static void finish_images(MultiresBakeRender *bkr, MultiresBakeResult *result)
 
 		RE_bake_ibuf_filter(ibuf, userdata->mask_buffer, bkr->bake_filter);
 
+		IMB_tag_changed(ibuf);
 		ibuf->userflags |= IB_BITMAPDIRTY | IB_DISPLAY_BUFFER_INVALID;
 
 		if (ibuf->rect_float)
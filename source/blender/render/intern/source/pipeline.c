@@ -2560,6 +2560,11 @@ static void do_render_composite_fields_blur_3d(Render *re)
 		render_result_single_layer_end(re);
 		BLI_rw_mutex_unlock(&re->resultmutex);
 	}
+
+	/* fields, motion blur and freestyle write the passes directly */
+	if (re->result) {
+		render_result_tag_changed(re->result);
+	}
 	
 	if (!re->test_break(re->tbh)) {
 		
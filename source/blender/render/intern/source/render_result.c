@@ -56,6 +56,8 @@
 #include "IMB_imbuf_types.h"
 #include "IMB_colormanagement.h"
 
+#include "atomic_ops.h"
+
 #include "intern/openexr/openexr_multi.h"
 
 #include "render_result.h"
@@ -616,6 +618,7 @@ RenderResult *render_result_new(Render *re, rcti *partrct, int crop, int savebuf
 	rr = MEM_callocN(sizeof(RenderResult), "new render result");
 	rr->rectx = rectx;
 	rr->recty = recty;
+	render_result_tag_changed(rr);
 	rr->renrect.xmin = 0; rr->renrect.xmax = rectx - 2 * crop;
 	/* crop is one or two extra pixels rendered for filtering, is used for merging and display too */
 	rr->crop = crop;
@@ -945,6 +948,7 @@ RenderResult *render_result_new_from_exr(void *exrhandle, const char *colorspace
 
 	rr->rectx = rectx;
 	rr->recty = recty;
+	render_result_tag_changed(rr);
 	
 	IMB_exr_multilayer_convert(exrhandle, rr, ml_addview_cb, ml_addlayer_cb, ml_addpass_cb);
 
@@ -1059,6 +1063,17 @@ void render_result_merge(RenderResult *rr, RenderResult *rrpart)
 			}
 		}
 	}
+
+	render_result_tag_changed(rr);
+}
+
+/* last stamp handed out, 0 is never used */
+static unsigned int changestamp_last = 0;
+
+/* call after writing passes, merging tiles runs in threads */
+void render_result_tag_changed(RenderResult *rr)
+{
+	rr->changestamp = atomic_add_and_fetch_uint32(&changestamp_last, 1);
 }
 
 /* for passes read from files, these have names stored */
@@ -1249,6 +1264,8 @@ void render_result_single_layer_end(Render *re)
 
 	RE_FreeRenderResult(re->pushedresult);
 	re->pushedresult = NULL;
+
+	render_result_tag_changed(re->result);
 }
 
 /************************* EXR Tile File Rendering ***************************/
@@ -1464,6 +1481,8 @@ int render_result_exr_file_read_path(RenderResult *rr, RenderLayer *rl_single, c
 	IMB_exr_read_channels(exrhandle);
 	IMB_exr_close(exrhandle);
 
+	render_result_tag_changed(rr);
+
 	return 1;
 }
 
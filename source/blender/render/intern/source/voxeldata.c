@@ -56,8 +56,13 @@
 #include "BKE_image.h"
 #include "BKE_main.h"
 #include "BKE_modifier.h"
+#include "BKE_texture.h"
 
 #include "smoke_API.h"
+
+#ifdef WITH_OPENVDB
+#  include "openvdb_capi.h"
+#endif
 #include "BPH_mass_spring.h"
 
 #include "DNA_texture_types.h"
@@ -208,6 +213,29 @@ static void load_frame_image_sequence(VoxelData *vd, Tex *tex)
 	return;
 }
 
+/* The grid stays sparse, voxeldatatex() samples it directly. Index space from 0 to the
+ * resolution of the texture is mapped to the texture, like the grids of smoke caches. */
+static void load_frame_openvdb(VoxelData *vd, const char *path)
+{
+#ifdef WITH_OPENVDB
+	struct OpenVDBReader *reader;
+	const char *grid_name = (vd->grid_name[0] != '\0') ? vd->grid_name : "density";
+
+	if (is_vd_res_ok(vd) == false)
+		return;
+
+	reader = OpenVDBReader_create();
+	OpenVDBReader_open(reader, path);
+	vd->grid = OpenVDB_import_sparse_grid_fl(reader, grid_name);
+	OpenVDBReader_free(reader);
+
+	vd->ok = (vd->grid != NULL);
+#else
+	(void)vd;
+	(void)path;
+#endif
+}
+
 static int read_voxeldata_header(FILE *fp, struct VoxelData *vd)
 {
 	VoxelDataHeader *h = (VoxelDataHeader *)MEM_mallocN(sizeof(VoxelDataHeader), "voxel data header");
@@ -397,10 +425,7 @@ void cache_voxeldata(Tex *tex, int scene_frame)
 		if (vd->ok) return;
 	
 	/* clear out old cache, ready for new */
-	if (vd->dataset) {
-		MEM_freeN(vd->dataset);
-		vd->dataset = NULL;
-	}
+	BKE_texture_voxeldata_free_data(vd);
 	/* reset data_type */
 	vd->data_type = TEX_VD_INTENSITY;
 
@@ -442,6 +467,14 @@ void cache_voxeldata(Tex *tex, int scene_frame)
 			load_frame_raw8(vd, fp, curframe);
 			fclose(fp);
 			return;
+		case TEX_VD_OPENVDB:
+			BLI_path_abs(path, G.main->name);
+			/* a sequence of files, like the frames of a smoke cache */
+			BLI_path_frame(path, curframe, 0);
+
+			load_frame_openvdb(vd, path);
+			vd->cachedframe = curframe;
+			return;
 	}
 }
 
@@ -472,7 +505,7 @@ int voxeldatatex(struct Tex *tex, const float texvec[3], struct TexResult *texre
 	int depth = (vd->data_type == TEX_VD_RGBA_PREMUL) ? 4 : 1;
 	int ch;
 
-	if (vd->dataset == NULL) {
+	if (vd->dataset == NULL && vd->grid == NULL) {
 		texres->tin = 0.0f;
 		return 0;
 	}
@@ -528,6 +561,21 @@ int voxeldatatex(struct Tex *tex, const float texvec[3], struct TexResult *texre
 			}
 		}
 
+#ifdef WITH_OPENVDB
+		if (vd->grid) {
+			/* the grid has voxel centers at integer coordinates, like BLI_voxel_sample_trilinear */
+			const float ijk[3] = {
+			    co[0] * vd->resol[0] - 0.5f,
+			    co[1] * vd->resol[1] - 0.5f,
+			    co[2] * vd->resol[2] - 0.5f};
+			/* OpenVDB has no cubic sampler, quadratic is the closest */
+			const int order = min_ii(vd->interp_type, 2);
+
+			*result = OpenVDB_sparse_grid_sample(vd->grid, ijk, order);
+			continue;
+		}
+#endif
+
 		switch (vd->interp_type) {
 			case TEX_VD_NEARESTNEIGHBOR:
 				*result = BLI_voxel_sample_nearest(dataset, vd->resol, co);
@@ -88,6 +88,7 @@
 #include "BKE_screen.h"
 
 #include "BLO_readfile.h"
+#include "BLO_undofile.h"  /* to save from an undo memfile */
 #include "BLO_writefile.h"
 
 #include "RNA_access.h"
@@ -112,6 +113,8 @@
 
 #include "GPU_draw.h"
 
+#include "COM_compositor.h"
+
 /* only to report a missing engine */
 #include "RE_engine.h"
 
@@ -324,6 +327,7 @@ static void wm_init_userdef(bContext *C, const bool from_memory)
 	UI_init_userdef();
 	
 	MEM_CacheLimiter_set_maximum(((size_t)U.memcachelimit) * 1024 * 1024);
+	IMB_tile_cache_set_limit(U.image_tile_cache_limit);
 	BKE_sound_init(bmain);
 
 	/* needed so loading a file from the command line respects user-pref [#26156] */
@@ -456,6 +460,11 @@ static void wm_file_read_post(bContext *C, bool is_startup_file)
 	bool addons_loaded = false;
 	wmWindowManager *wm = CTX_wm_manager(C);
 
+#ifdef WITH_COMPOSITOR
+	/* results of the node trees of the previous file are of no use */
+	COM_clearCaches();
+#endif
+
 	if (!G.background) {
 		/* remove windows which failed to be added via WM_check */
 		wm_window_ghostwindows_remove_invalid(C, wm);
@@ -1131,11 +1140,67 @@ void WM_autosave_init(wmWindowManager *wm)
 		wm->autosavetimer = WM_event_add_timer(wm, NULL, TIMERAUTOSAVE, U.savetime * 60.0);
 }
 
+/**
+ * Auto-save runs as a job: the file state is captured into a #MemFile on the main thread,
+ * which only costs a memory copy, compressing and writing it to disk happens in a thread
+ * so editing can continue meanwhile.
+ */
+typedef struct AutoSaveJob {
+	MemFile memfile;
+	char filepath[FILE_MAX];
+	bool use_compress;
+
+	/* result, set by the thread */
+	bool success, cancelled;
+	char error[FILE_MAX + 256];
+} AutoSaveJob;
+
+static void wm_autosave_startjob(void *customdata, short *stop, short *UNUSED(do_update), float *progress)
+{
+	AutoSaveJob *asj = customdata;
+
+	asj->success = BLO_memfile_write_file(
+	        &asj->memfile, asj->filepath, asj->use_compress,
+	        stop, progress, asj->error, sizeof(asj->error));
+	asj->cancelled = (*stop != 0);
+}
+
+static void wm_autosave_endjob(void *customdata)
+{
+	AutoSaveJob *asj = customdata;
+
+	if (asj->success) {
+		if (G.debug) {
+			printf("Auto-saved '%s'\n", asj->filepath);
+		}
+	}
+	else if (asj->cancelled) {
+		/* file loading, undo or quitting stopped the job, keep the previous auto-save */
+		if (G.debug) {
+			printf("Auto-save to '%s' cancelled\n", asj->filepath);
+		}
+	}
+	else {
+		fprintf(stderr, "Unable to auto-save '%s': %s\n", asj->filepath, asj->error);
+		WM_reportf(RPT_ERROR, "Unable to auto-save: %s", asj->error);
+	}
+}
+
+static void wm_autosave_free(void *customdata)
+{
+	AutoSaveJob *asj = customdata;
+
+	BLO_memfile_free(&asj->memfile);
+	MEM_freeN(asj);
+}
+
 void wm_autosave_timer(const bContext *C, wmWindowManager *wm, wmTimer *UNUSED(wt))
 {
 	wmWindow *win;
 	wmEventHandler *handler;
-	char filepath[FILE_MAX];
+	AutoSaveJob *asj;
+	wmJob *wm_job;
+	bool ok;
 	
 	WM_event_remove_timer(wm, NULL, wm->autosavetimer);
 
@@ -1152,22 +1217,47 @@ void wm_autosave_timer(const bContext *C, wmWindowManager *wm, wmTimer *UNUSED(w
 		}
 	}
 
-	wm_autosave_location(filepath);
+	/* previous auto-save is still being written (very slow disk), try again later too */
+	if (WM_jobs_test(wm, wm, WM_JOB_TYPE_AUTOSAVE)) {
+		wm->autosavetimer = WM_event_add_timer(wm, NULL, TIMERAUTOSAVE, 10.0);
+		if (G.debug) {
+			printf("Skipping auto-save, previous auto-save still running, retrying in ten seconds...\n");
+		}
+		return;
+	}
+
+	asj = MEM_callocN(sizeof(*asj), "AutoSaveJob");
+	wm_autosave_location(asj->filepath);
+	/* compression is done in the thread, so there is no reason to skip it anymore */
+	asj->use_compress = (G.fileflags & G_FILE_COMPRESS) != 0;
 
 	if (U.uiflag & USER_GLOBALUNDO) {
 		/* fast save of last undobuffer, now with UI */
-		BKE_undo_save_file(filepath);
+		ok = BKE_undo_copy_memfile(&asj->memfile);
 	}
 	else {
-		/*  save as regular blend file */
+		/* capture the file in memory, same as undo does, the job writes it to disk */
 		int fileflags = G.fileflags & ~(G_FILE_COMPRESS | G_FILE_AUTOPLAY | G_FILE_HISTORY);
 
 		ED_editors_flush_edits(C, false);
 
+		ok = BLO_write_file_mem(CTX_data_main(C), NULL, &asj->memfile, fileflags);
+	}
+
+	if (ok) {
+		wm_job = WM_jobs_get(wm, wm->windows.first, wm, "Auto-Saving...", WM_JOB_PROGRESS, WM_JOB_TYPE_AUTOSAVE);
+		WM_jobs_customdata_set(wm_job, asj, wm_autosave_free);
+		WM_jobs_timer(wm_job, 0.1, 0, 0);
+		WM_jobs_callbacks(wm_job, wm_autosave_startjob, NULL, NULL, wm_autosave_endjob);
+		WM_jobs_start(wm, wm_job);
+	}
+	else {
 		/* Error reporting into console */
-		BLO_write_file(CTX_data_main(C), filepath, fileflags, NULL, NULL);
+		fprintf(stderr, "Unable to auto-save '%s': no file state to save\n", asj->filepath);
+		wm_autosave_free(asj);
 	}
-	/* do timer after file write, just in case file write takes a long time */
+
+	/* timer counts from the start of the save, writing runs in the background */
 	wm->autosavetimer = WM_event_add_timer(wm, NULL, TIMERAUTOSAVE, U.savetime * 60.0);
 }
 
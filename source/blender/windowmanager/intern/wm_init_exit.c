@@ -52,6 +52,7 @@
 #include "BLI_threads.h"
 #include "BLI_utildefines.h"
 
+#include "BLO_readfile.h"
 #include "BLO_writefile.h"
 
 #include "BKE_blender.h"
@@ -498,6 +499,7 @@ void WM_exit_ext(bContext *C, const bool do_python)
 	BIF_freeTemplates(C);
 
 	free_openrecent();
+	BLO_blendfile_index_cache_free();
 	
 	BKE_mball_cubeTable_free();
 	
@@ -547,6 +547,7 @@ static int arg_handle_print_help(int UNUSED(argc), const char **UNUSED(argv), vo
 #endif
 	BLI_argsPrintArgDoc(ba, "--debug-memory");
 	BLI_argsPrintArgDoc(ba, "--debug-jobs");
+	BLI_argsPrintArgDoc(ba, "--debug-compositor");
 	BLI_argsPrintArgDoc(ba, "--debug-python");
 	BLI_argsPrintArgDoc(ba, "--debug-depsgraph");
 	BLI_argsPrintArgDoc(ba, "--debug-depsgraph-no-threads");
@@ -742,6 +743,8 @@ static const char arg_handle_debug_mode_generic_set_doc_wm[] =
 "\n\tEnable debug messages for the window manager, also prints every operator call";
 static const char arg_handle_debug_mode_generic_set_doc_jobs[] =
 "\n\tEnable time profiling for background jobs.";
+static const char arg_handle_debug_mode_generic_set_doc_compositor[] =
+"\n\tEnable time profiling for the compositor, a report and a trace file are written to the temp directory.";
 static const char arg_handle_debug_mode_generic_set_doc_gpu[] =
 "\n\tEnable gpu debug context and information for OpenGL 4.3+.";
 static const char arg_handle_debug_mode_generic_set_doc_depsgraph[] =
@@ -1831,6 +1834,8 @@ void main_args_setup(bContext *C, bArgs *ba, SYS_SystemHandle *syshandle)
 	            CB(arg_handle_debug_value_set), NULL);
 	BLI_argsAdd(ba, 1, NULL, "--debug-jobs",
 	            CB_EX(arg_handle_debug_mode_generic_set, jobs), (void *)G_DEBUG_JOBS);
+	BLI_argsAdd(ba, 1, NULL, "--debug-compositor",
+	            CB_EX(arg_handle_debug_mode_generic_set, compositor), (void *)G_DEBUG_COMPOSITOR);
 	BLI_argsAdd(ba, 1, NULL, "--debug-gpu",
 	            CB_EX(arg_handle_debug_mode_generic_set, gpu), (void *)G_DEBUG_GPU);
 	BLI_argsAdd(ba, 1, NULL, "--debug-depsgraph",
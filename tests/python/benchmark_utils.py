@@ -0,0 +1,68 @@
+# Apache License, Version 2.0
+
+# Shared by the *_benchmark.py scripts, which run as 'make <name>' (see add_blender_benchmark
+# in CMakeLists.txt): the command line, cases run in a new Blender process and the summary
+# written to the output directory.
+
+import argparse
+import os
+import subprocess
+import sys
+
+import bpy
+
+
+def output_root():
+    # the session directory in bpy.app.tempdir is removed when Blender exits, use its parent
+    return os.path.dirname(os.path.normpath(bpy.app.tempdir))
+
+
+def parse_args(name, description, repeat=3, add_arguments=None):
+    """
+    Parse the arguments after '--', every benchmark has --output-dir and --repeat.
+    add_arguments(parser) adds the arguments of the benchmark itself.
+    """
+    argv = sys.argv[sys.argv.index("--") + 1:] if "--" in sys.argv else []
+    parser = argparse.ArgumentParser(description=description)
+    parser.add_argument("--output-dir", default=os.path.join(output_root(), name))
+    parser.add_argument("--repeat", type=int, default=repeat,
+                        help="times every case is run, the fastest run is reported")
+    # set in the processes started by run_child
+    parser.add_argument("--child", action="store_true", help=argparse.SUPPRESS)
+    if add_arguments:
+        add_arguments(parser)
+    args = parser.parse_args(argv)
+
+    if not args.child:
+        os.makedirs(args.output_dir, exist_ok=True)
+    return args
+
+
+def report(*values):
+    """Report a result of a child process to run_child."""
+    print("BENCHMARK_RESULT " + " ".join(str(value) for value in values))
+
+
+def run_child(script, arguments, blender_arguments=()):
+    """
+    Run the script in a new Blender process with --child and the arguments,
+    return the values of every line it reported, as strings.
+    """
+    command = [bpy.app.binary_path, "--background", "-noaudio", "--factory-startup"]
+    command += list(blender_arguments)
+    command += ["--python", os.path.abspath(script), "--", "--child"] + list(arguments)
+    output = subprocess.check_output(command, universal_newlines=True)
+
+    results = [line.split()[1:] for line in output.splitlines() if line.startswith("BENCHMARK_RESULT")]
+    if not results:
+        raise Exception("%s: no results reported\n%s" % (" ".join(command), output))
+    return results
+
+
+def write_summary(args, title, heading, lines):
+    """Write the heading and the result lines to summary.txt in the output directory."""
+    with open(os.path.join(args.output_dir, "summary.txt"), "w") as fh:
+        fh.write(heading + "\n")
+        for line in lines:
+            fh.write(line + "\n")
+    print("%s written to %s" % (title, args.output_dir))
@@ -0,0 +1,122 @@
+# Apache License, Version 2.0
+
+# Time listing the ID's of a library with bpy.data.libraries.load, with and without the library index
+# stored next to it (User Preferences, File, "Library Index").
+#
+# ./blender.bin --background -noaudio --factory-startup \
+#     --python tests/python/blendfile_index_benchmark.py -- --output-dir=/tmp/blendfile_index_benchmark
+#
+# A library with many ID's is generated in the output directory. Every case runs in a new Blender
+# process, so indices kept in memory don't carry over, and on a new copy of the library:
+#
+# - scan: the index isn't stored, the library is scanned once per process.
+# - index_write: the library is scanned and the index is stored next to it.
+# - index_read: the stored index is read, the library isn't scanned.
+
+import argparse
+import os
+import shutil
+import sys
+import time
+
+import bpy
+
+sys.path.append(os.path.dirname(__file__))
+import benchmark_utils
+
+
+CASES = (
+    ("scan", False, False),
+    ("index_write", True, False),
+    ("index_read", True, True),
+)
+
+GROUPS = ("Object", "Mesh", "Material")
+
+
+def sidecar_path(filepath):
+    dirname, filename = os.path.split(filepath)
+    return os.path.join(dirname, ".%s.blidx" % filename)
+
+
+def generate_library(filepath, count):
+    bpy.ops.wm.read_homefile(use_empty=True)
+    for index in range(count):
+        mesh = bpy.data.meshes.new("Mesh.%05d" % index)
+        mesh.materials.append(bpy.data.materials.new("Material.%05d" % index))
+        obj = bpy.data.objects.new("Object.%05d" % index, mesh)
+        obj.use_fake_user = True
+    bpy.ops.wm.save_as_mainfile(filepath=filepath)
+
+
+def list_library(filepath):
+    # the names are listed from the index, nothing is linked so the file isn't opened
+    start = time.time()
+    with bpy.data.libraries.load(filepath) as (data_from, data_to):
+        names = {group: list(getattr(data_from, group.lower() + "s")) for group in GROUPS}
+    elapsed = (time.time() - start) * 1000.0
+    if not all(names.values()):
+        raise Exception("%s: missing ID's in the listing" % filepath)
+    return elapsed
+
+
+def run_child(args):
+    bpy.context.user_preferences.filepaths.use_blendfile_index = args.use_index
+    benchmark_utils.report(list_library(args.library))
+
+
+def run_case(args, library, name, use_index, reuse_index, repeat):
+    # a new name for every run, so nothing cached for the library is found
+    filepath = os.path.join(args.output_dir, "library_%s_%d.blend" % (name, repeat))
+    shutil.copy2(library, filepath)
+    if reuse_index:
+        shutil.copy2(sidecar_path(library), sidecar_path(filepath))
+
+    arguments = ["--library=" + filepath]
+    if use_index:
+        arguments.append("--use-index")
+    results = benchmark_utils.run_child(__file__, arguments)
+
+    os.remove(filepath)
+    if os.path.exists(sidecar_path(filepath)):
+        os.remove(sidecar_path(filepath))
+
+    return float(results[0][0])
+
+
+def add_arguments(parser):
+    parser.add_argument("--count", type=int, default=2000, help="number of objects in the library")
+    parser.add_argument("--library", help=argparse.SUPPRESS)
+    parser.add_argument("--use-index", action="store_true", help=argparse.SUPPRESS)
+
+
+def main():
+    args = benchmark_utils.parse_args("blendfile_index_benchmark",
+                                      "Time library listing with and without the library index",
+                                      add_arguments=add_arguments)
+
+    if args.child:
+        run_child(args)
+        return
+
+    library = os.path.join(args.output_dir, "library.blend")
+    generate_library(library, args.count)
+
+    # store the index once, for the 'index_read' case
+    bpy.context.user_preferences.filepaths.use_blendfile_index = True
+    list_library(library)
+
+    lines = []
+    for name, use_index, reuse_index in CASES:
+        best = min(run_case(args, library, name, use_index, reuse_index, repeat)
+                   for repeat in range(args.repeat))
+        lines.append("%-16s %10.3f ms" % (name, best))
+        print(lines[-1])
+
+    benchmark_utils.write_summary(
+        args, "Library index benchmark",
+        "%d objects, meshes and materials, fastest of %d runs" % (args.count, args.repeat), lines)
+
+
+if __name__ == "__main__":
+    main()
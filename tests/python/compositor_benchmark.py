@@ -0,0 +1,294 @@
+# Apache License, Version 2.0
+
+# Time compositor node trees with synthetic inputs, without rendering a scene.
+#
+# ./blender.bin --background -noaudio --factory-startup \
+#     --python tests/python/compositor_benchmark.py -- --output-dir=/tmp/compositor_benchmark [file.blend ...]
+#
+# Without .blend files a built-in set of trees is timed. Render Layers nodes of the given
+# .blend files are replaced by an image node with a synthetic image, so only the compositor runs.
+# The per-operation report and the trace (chrome://tracing) of every tree are copied to the output directory.
+#
+# With --blur-radii the blur node is timed at several radii instead, for every Gaussian filter.
+# The recursive columns enable the recursive Gaussian, which is used from radius 32 up.
+
+import glob
+import os
+import shutil
+import sys
+import time
+
+import bpy
+
+sys.path.append(os.path.dirname(__file__))
+import benchmark_utils
+
+
+# ------------------------------------------------------------------------------
+# Synthetic trees, each function links nodes between an image and the composite output
+
+def tree_color_chain(tree, image):
+    # pointwise operations that are fused into one
+    node = image
+    for index in range(4):
+        gamma = tree.nodes.new("CompositorNodeGamma")
+        gamma.inputs["Gamma"].default_value = 1.2
+        tree.links.new(node.outputs["Image"], gamma.inputs["Image"])
+        huesat = tree.nodes.new("CompositorNodeHueSat")
+        tree.links.new(gamma.outputs["Image"], huesat.inputs["Image"])
+        mix = tree.nodes.new("CompositorNodeMixRGB")
+        mix.blend_type = 'MULTIPLY'
+        mix.inputs["Fac"].default_value = 0.5
+        tree.links.new(huesat.outputs["Image"], mix.inputs[1])
+        tree.links.new(image.outputs["Image"], mix.inputs[2])
+        node = mix
+    return node
+
+
+def tree_gaussian_blur(tree, image):
+    blur = tree.nodes.new("CompositorNodeBlur")
+    blur.filter_type = 'GAUSS'
+    blur.size_x = blur.size_y = 50
+    tree.links.new(image.outputs["Image"], blur.inputs["Image"])
+    return blur
+
+
+def tree_fast_gaussian_blur(tree, image):
+    blur = tree.nodes.new("CompositorNodeBlur")
+    blur.filter_type = 'FAST_GAUSS'
+    blur.size_x = blur.size_y = 50
+    tree.links.new(image.outputs["Image"], blur.inputs["Image"])
+    return blur
+
+
+def tree_bokeh_blur(tree, image):
+    bokeh = tree.nodes.new("CompositorNodeBokehImage")
+    blur = tree.nodes.new("CompositorNodeBokehBlur")
+    blur.blur_max = 16.0
+    tree.links.new(image.outputs["Image"], blur.inputs["Image"])
+    tree.links.new(bokeh.outputs["Image"], blur.inputs["Bokeh"])
+    return blur
+
+
+def tree_glare_fog_glow(tree, image):
+    glare = tree.nodes.new("CompositorNodeGlare")
+    glare.glare_type = 'FOG_GLOW'
+    glare.quality = 'HIGH'
+    glare.size = 8
+    tree.links.new(image.outputs["Image"], glare.inputs["Image"])
+    return glare
+
+
+def tree_lens_distortion(tree, image):
+    lens = tree.nodes.new("CompositorNodeLensdist")
+    lens.inputs["Distort"].default_value = 0.2
+    lens.inputs["Dispersion"].default_value = 0.05
+    tree.links.new(image.outputs["Image"], lens.inputs["Image"])
+    return lens
+
+
+def tree_tonemap(tree, image):
+    tonemap = tree.nodes.new("CompositorNodeTonemap")
+    tonemap.tonemap_type = 'RH_SIMPLE'
+    tree.links.new(image.outputs["Image"], tonemap.inputs["Image"])
+    return tonemap
+
+
+def tree_blur(filter_type, radius, use_bokeh=False, use_recursive=False):
+    def build(tree, image):
+        blur = tree.nodes.new("CompositorNodeBlur")
+        blur.filter_type = filter_type
+        blur.use_bokeh = use_bokeh
+        blur.use_recursive = use_recursive
+        blur.size_x = blur.size_y = radius
+        tree.links.new(image.outputs["Image"], blur.inputs["Image"])
+        return blur
+    return build
+
+
+SYNTHETIC_TREES = (
+    ("color_chain", tree_color_chain),
+    ("gaussian_blur", tree_gaussian_blur),
+    ("fast_gaussian_blur", tree_fast_gaussian_blur),
+    ("bokeh_blur", tree_bokeh_blur),
+    ("glare_fog_glow", tree_glare_fog_glow),
+    ("lens_distortion", tree_lens_distortion),
+    ("tonemap", tree_tonemap),
+)
+
+BLUR_RADII = (4, 8, 12, 16, 24, 32, 64, 128, 256)
+
+# (name, filter type, use bokeh, use recursive)
+BLUR_FILTERS = (
+    ("gaussian", 'GAUSS', False, False),
+    ("gaussian_recursive", 'GAUSS', False, True),
+    ("gaussian_bokeh", 'GAUSS', True, False),
+    ("gaussian_bokeh_recursive", 'GAUSS', True, True),
+    ("fast_gaussian", 'FAST_GAUSS', False, False),
+)
+
+
+# ------------------------------------------------------------------------------
+# Scene setup
+
+def synthetic_image(width, height):
+    image = bpy.data.images.new("Synthetic", width, height, alpha=True, float_buffer=True)
+    image.generated_type = 'COLOR_GRID'
+    return image
+
+
+def setup_scene(scene, width, height):
+    scene.render.resolution_x = width
+    scene.render.resolution_y = height
+    scene.render.resolution_percentage = 100
+    scene.render.use_compositing = True
+    scene.render.use_sequencer = False
+    scene.use_nodes = True
+
+
+def setup_synthetic_tree(scene, build, width, height):
+    tree = scene.node_tree
+    tree.nodes.clear()
+
+    image = tree.nodes.new("CompositorNodeImage")
+    image.image = synthetic_image(width, height)
+    composite = tree.nodes.new("CompositorNodeComposite")
+    tree.links.new(build(tree, image).outputs["Image"], composite.inputs["Image"])
+
+
+def refresh_synthetic_images(scene, width, height):
+    # a new image changes the cache keys, so every execution computes the whole tree
+    for node in scene.node_tree.nodes:
+        if node.type == 'IMAGE' and node.image and node.image.name.startswith("Synthetic"):
+            old = node.image
+            node.image = synthetic_image(width, height)
+            bpy.data.images.remove(old)
+
+
+def replace_render_layers(scene, width, height):
+    # relink the combined pass to a synthetic image, the other passes keep their defaults
+    tree = scene.node_tree
+    image = None
+    for node in [node for node in tree.nodes if node.type == 'R_LAYERS']:
+        if image is None:
+            image = tree.nodes.new("CompositorNodeImage")
+            image.image = synthetic_image(width, height)
+        for output in ("Image", "Alpha"):
+            for link in list(node.outputs[output].links):
+                tree.links.new(image.outputs[output], link.to_socket)
+        tree.nodes.remove(node)
+
+
+# ------------------------------------------------------------------------------
+# Timing
+
+def profile_dir():
+    # the profiler writes to the temporary directory that contains the session directory
+    return os.path.dirname(os.path.normpath(bpy.app.tempdir))
+
+
+def latest_file(pattern):
+    files = glob.glob(os.path.join(profile_dir(), pattern))
+    return max(files, key=os.path.getmtime) if files else None
+
+
+def execution_time(report):
+    with open(report) as fh:
+        for line in fh:
+            if line.startswith("Execution time:"):
+                return float(line.split()[2])
+    return 0.0
+
+
+def run(name, scene, args):
+    times = []
+    for index in range(args.repeat):
+        refresh_synthetic_images(scene, args.width, args.height)
+        start = time.time()
+        bpy.ops.render.render(scene=scene.name)
+        wall = (time.time() - start) * 1000.0
+
+        compositor = 0.0
+        report = latest_file("compositor_profile_*.txt")
+        trace = latest_file("compositor_trace_*.json")
+        if report:
+            compositor = execution_time(report)
+            shutil.copy(report, os.path.join(args.output_dir, "%s_profile_%d.txt" % (name, index)))
+        if trace:
+            shutil.copy(trace, os.path.join(args.output_dir, "%s_trace_%d.json" % (name, index)))
+        times.append((wall, compositor))
+
+    best = min(times)
+    print("%-24s render %10.3f ms   compositor %10.3f ms" % (name, best[0], best[1]))
+    return best
+
+
+def run_blur_radii(scene, args):
+    setup_scene(scene, args.width, args.height)
+    results = {}
+    for radius in BLUR_RADII:
+        for filter_name, filter_type, use_bokeh, use_recursive in BLUR_FILTERS:
+            name = "blur_%s_%d" % (filter_name, radius)
+            setup_synthetic_tree(scene, tree_blur(filter_type, radius, use_bokeh, use_recursive),
+                                 args.width, args.height)
+            results[radius, filter_name] = run(name, scene, args)[1]
+
+    lines = ["%-6s" % "radius" + "".join(" %26s" % filter_name for filter_name, _, _, _ in BLUR_FILTERS)]
+    for radius in BLUR_RADII:
+        lines.append("%-6d" % radius + "".join(" %23.3f ms" % results[radius, filter_name]
+                                              for filter_name, _, _, _ in BLUR_FILTERS))
+    for line in lines:
+        print(line)
+
+    benchmark_utils.write_summary(
+        args, "Compositor blur benchmark",
+        "%dx%d, compositor time, fastest of %d executions" % (args.width, args.height, args.repeat), lines)
+
+
+def add_arguments(parser):
+    parser.add_argument("--width", type=int, default=1920)
+    parser.add_argument("--height", type=int, default=1080)
+    parser.add_argument("--blur-radii", action="store_true",
+                        help="time the Gaussian blur filters at increasing radii instead of the trees")
+    parser.add_argument("files", nargs="*", help=".blend files with compositor trees")
+
+
+def main():
+    args = benchmark_utils.parse_args("compositor_benchmark", "Time compositor node trees with synthetic inputs",
+                                      add_arguments=add_arguments)
+
+    # same as --debug-compositor
+    bpy.app.debug_compositor = True
+
+    if args.blur_radii:
+        run_blur_radii(bpy.context.scene, args)
+        return
+
+    results = []
+    if args.files:
+        for filepath in args.files:
+            bpy.ops.wm.open_mainfile(filepath=filepath)
+            scene = bpy.context.scene
+            if scene.node_tree is None:
+                print("%s has no compositor tree, skipping" % filepath)
+                continue
+            setup_scene(scene, args.width, args.height)
+            replace_render_layers(scene, args.width, args.height)
+            name = os.path.splitext(os.path.basename(filepath))[0]
+            results.append((name, run(name, scene, args)))
+    else:
+        scene = bpy.context.scene
+        setup_scene(scene, args.width, args.height)
+        for name, build in SYNTHETIC_TREES:
+            setup_synthetic_tree(scene, build, args.width, args.height)
+            results.append((name, run(name, scene, args)))
+
+    lines = ["%-24s render %10.3f ms   compositor %10.3f ms" % (name, wall, compositor)
+             for name, (wall, compositor) in results]
+    benchmark_utils.write_summary(
+        args, "Compositor benchmark",
+        "%dx%d, fastest of %d executions" % (args.width, args.height, args.repeat), lines)
+
+
+if __name__ == "__main__":
+    main()
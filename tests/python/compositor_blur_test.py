@@ -0,0 +1,72 @@
+# Apache License, Version 2.0
+
+# Compare the recursive Gaussian of the blur node against the Gaussian kernel.
+#
+# ./blender.bin --background -noaudio --factory-startup \
+#     --python tests/python/compositor_blur_test.py
+#
+# The recursive filter (use_recursive) is only used from IIR_GAUSS_MIN_RADIUS pixels, smaller
+# radii must give exactly the result of the kernel. Above it the recursive filter approximates
+# the kernel, for the separable and for the bokeh blur.
+
+import os
+import sys
+import unittest
+
+import bpy
+
+sys.path.append(os.path.dirname(__file__))
+import compositor_test_utils
+
+
+SIZE = 128
+
+# below IIR_GAUSS_MIN_RADIUS in COM_BlurBaseOperation.h
+SMALL_RADIUS = 16
+LARGE_RADIUS = 48
+
+# the recursive filter approximates the Gaussian with a third order filter
+TOLERANCE = 0.03
+
+
+class CompositorBlurTest(unittest.TestCase):
+    def setUp(self):
+        scene = bpy.context.scene
+        compositor_test_utils.setup_scene(scene, SIZE)
+        tree, image_node = compositor_test_utils.new_tree(scene, SIZE)
+
+        blur = tree.nodes.new("CompositorNodeBlur")
+        blur.filter_type = 'GAUSS'
+        tree.links.new(image_node.outputs["Image"], blur.inputs["Image"])
+        compositor_test_utils.link_composite(tree, blur.outputs["Image"])
+
+        self.scene = scene
+        self.blur = blur
+
+    def compare(self, radius, use_bokeh, tolerance):
+        self.blur.size_x = self.blur.size_y = radius
+        self.blur.use_bokeh = use_bokeh
+
+        self.blur.use_recursive = False
+        kernel = compositor_test_utils.render_pixels(self.scene)
+        self.blur.use_recursive = True
+        recursive = compositor_test_utils.render_pixels(self.scene)
+
+        compositor_test_utils.assert_pixels_close(self, recursive, kernel, tolerance)
+
+    def test_small_radius_unchanged(self):
+        self.compare(SMALL_RADIUS, False, 0.0)
+
+    def test_small_radius_bokeh_unchanged(self):
+        self.compare(SMALL_RADIUS, True, 0.0)
+
+    def test_large_radius(self):
+        self.compare(LARGE_RADIUS, False, TOLERANCE)
+
+    def test_large_radius_bokeh(self):
+        self.compare(LARGE_RADIUS, True, TOLERANCE)
+
+
+if __name__ == '__main__':
+    sys.argv = [__file__] + (sys.argv[sys.argv.index("--") + 1:] if "--" in sys.argv else [])
+    unittest.main()
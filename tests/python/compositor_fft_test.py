@@ -0,0 +1,67 @@
+# Apache License, Version 2.0
+
+# Compare the bokeh blur convolved with the FFT against the direct convolution.
+#
+# ./blender.bin --background -noaudio --factory-startup \
+#     --python tests/python/compositor_fft_test.py
+#
+# BokehBlurOperation uses FFTConvolution when the size is known before execution (the Size socket
+# isn't linked) and the kernel is at least FFT_CONVOLUTION_MIN_SIZE pixels. A size read from a
+# linked socket uses the direct loop, both must give the same result within float precision.
+
+import os
+import sys
+import unittest
+
+import bpy
+
+sys.path.append(os.path.dirname(__file__))
+import compositor_test_utils
+
+
+SIZE = 128
+
+# percentage of the image size, 12 pixels or a kernel of 24 pixels
+BLUR_SIZE = 10.0
+
+# the FFT sums in a different order than the direct loop
+TOLERANCE = 1e-4
+
+
+def setup_tree(scene, link_size):
+    tree, image_node = compositor_test_utils.new_tree(scene, SIZE)
+
+    bokeh_image = tree.nodes.new("CompositorNodeBokehImage")
+    bokeh_image.flaps = 6
+    bokeh_image.rotation = 0.3
+
+    blur = tree.nodes.new("CompositorNodeBokehBlur")
+    blur.inputs["Size"].default_value = BLUR_SIZE
+    tree.links.new(image_node.outputs["Image"], blur.inputs["Image"])
+    tree.links.new(bokeh_image.outputs["Image"], blur.inputs["Bokeh"])
+
+    if link_size:
+        value = tree.nodes.new("CompositorNodeValue")
+        value.outputs[0].default_value = BLUR_SIZE
+        tree.links.new(value.outputs[0], blur.inputs["Size"])
+
+    compositor_test_utils.link_composite(tree, blur.outputs["Image"])
+
+
+class CompositorFFTTest(unittest.TestCase):
+    def setUp(self):
+        self.scene = bpy.context.scene
+        compositor_test_utils.setup_scene(self.scene, SIZE)
+
+    def test_fft_matches_direct(self):
+        setup_tree(self.scene, False)
+        fft = compositor_test_utils.render_pixels(self.scene)
+        setup_tree(self.scene, True)
+        direct = compositor_test_utils.render_pixels(self.scene)
+
+        compositor_test_utils.assert_pixels_close(self, fft, direct, TOLERANCE)
+
+
+if __name__ == '__main__':
+    sys.argv = [__file__] + (sys.argv[sys.argv.index("--") + 1:] if "--" in sys.argv else [])
+    unittest.main()
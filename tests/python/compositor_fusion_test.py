@@ -0,0 +1,132 @@
+# Apache License, Version 2.0
+
+# Compare a compositor tree of pointwise nodes evaluated with and without fusing
+# (COM_FUSE_OPERATIONS), the results must be bit-for-bit identical.
+#
+# ./blender.bin --background -noaudio --factory-startup \
+#     --python tests/python/compositor_fusion_test.py
+#
+# Fusing is disabled by bpy.app.debug_value, see COM_DEBUG_VALUE_NO_FUSE in COM_defines.h.
+
+import os
+import tempfile
+import unittest
+
+import bpy
+
+
+# keep in sync with COM_DEBUG_VALUE_NO_FUSE
+DEBUG_VALUE_NO_FUSE = 4242
+
+SIZE = 64
+
+
+def setup_tree(scene):
+    scene.use_nodes = True
+    tree = scene.node_tree
+    tree.nodes.clear()
+
+    image = bpy.data.images.new("fusion_input", SIZE, SIZE, alpha=True, float_buffer=True)
+    image.generated_type = 'COLOR_GRID'
+    image_node = tree.nodes.new("CompositorNodeImage")
+    image_node.image = image
+
+    # every pointwise node type that is fused, with inputs of all data types
+    separate = tree.nodes.new("CompositorNodeSepRGBA")
+    tree.links.new(image_node.outputs["Image"], separate.inputs["Image"])
+
+    math = tree.nodes.new("CompositorNodeMath")
+    math.operation = 'POWER'
+    math.inputs[1].default_value = 0.7
+    tree.links.new(separate.outputs["R"], math.inputs[0])
+
+    ramp = tree.nodes.new("CompositorNodeValToRGB")
+    ramp.color_ramp.elements[0].color = (0.1, 0.3, 0.9, 1.0)
+    tree.links.new(separate.outputs["G"], ramp.inputs["Fac"])
+
+    mix = tree.nodes.new("CompositorNodeMixRGB")
+    mix.blend_type = 'OVERLAY'
+    tree.links.new(math.outputs["Value"], mix.inputs["Fac"])
+    tree.links.new(image_node.outputs["Image"], mix.inputs[1])
+    tree.links.new(ramp.outputs["Image"], mix.inputs[2])
+
+    bw = tree.nodes.new("CompositorNodeRGBToBW")
+    tree.links.new(mix.outputs["Image"], bw.inputs["Image"])
+
+    combine = tree.nodes.new("CompositorNodeCombRGBA")
+    tree.links.new(mix.outputs["Image"], combine.inputs["R"])
+    tree.links.new(bw.outputs["Val"], combine.inputs["G"])
+    tree.links.new(separate.outputs["B"], combine.inputs["B"])
+    tree.links.new(separate.outputs["A"], combine.inputs["A"])
+
+    gamma = tree.nodes.new("CompositorNodeGamma")
+    gamma.inputs["Gamma"].default_value = 1.3
+    tree.links.new(combine.outputs["Image"], gamma.inputs["Image"])
+
+    huesat = tree.nodes.new("CompositorNodeHueSat")
+    tree.links.new(gamma.outputs["Image"], huesat.inputs["Image"])
+
+    set_alpha = tree.nodes.new("CompositorNodeSetAlpha")
+    tree.links.new(huesat.outputs["Image"], set_alpha.inputs["Image"])
+    tree.links.new(bw.outputs["Val"], set_alpha.inputs["Alpha"])
+
+    invert = tree.nodes.new("CompositorNodeInvert")
+    invert.inputs["Fac"].default_value = 0.6
+    tree.links.new(set_alpha.outputs["Image"], invert.inputs["Color"])
+
+    composite = tree.nodes.new("CompositorNodeComposite")
+    composite.use_alpha = True
+    tree.links.new(invert.outputs["Color"], composite.inputs["Image"])
+
+
+def render_pixels(scene, debug_value, filepath):
+    bpy.app.debug_value = debug_value
+    bpy.ops.render.render()
+    bpy.app.debug_value = 0
+
+    # the render result can't be read directly, go through a lossless float file
+    bpy.data.images["Render Result"].save_render(filepath, scene)
+    image = bpy.data.images.load(filepath)
+    pixels = list(image.pixels)
+    bpy.data.images.remove(image)
+    os.remove(filepath)
+    return pixels
+
+
+class CompositorFusionTest(unittest.TestCase):
+    def setUp(self):
+        scene = bpy.context.scene
+        scene.render.resolution_x = SIZE
+        scene.render.resolution_y = SIZE
+        scene.render.resolution_percentage = 100
+        scene.render.use_compositing = True
+        scene.render.use_sequencer = False
+        settings = scene.render.image_settings
+        settings.file_format = 'OPEN_EXR'
+        settings.color_depth = '32'
+        settings.exr_codec = 'ZIP'
+        settings.color_mode = 'RGBA'
+        setup_tree(scene)
+        self.scene = scene
+
+    def test_fused_matches_unfused(self):
+        directory = tempfile.mkdtemp()
+        fused = render_pixels(self.scene, 0, os.path.join(directory, "fused.exr"))
+        unfused = render_pixels(self.scene, DEBUG_VALUE_NO_FUSE, os.path.join(directory, "unfused.exr"))
+        os.rmdir(directory)
+
+        self.assertEqual(len(fused), SIZE * SIZE * 4)
+        # guard against comparing two empty results
+        self.assertGreater(len(set(fused)), 16)
+
+        mismatches = [index for index in range(len(fused)) if fused[index] != unfused[index]]
+        if mismatches:
+            index = mismatches[0]
+            self.fail("%d of %d values differ, first at pixel %d channel %d: %r != %r" %
+                      (len(mismatches), len(fused), index // 4, index % 4, fused[index], unfused[index]))
+
+
+if __name__ == '__main__':
+    import sys
+    sys.argv = [__file__] + (sys.argv[sys.argv.index("--") + 1:] if "--" in sys.argv else [])
+    unittest.main()
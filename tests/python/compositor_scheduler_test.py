@@ -0,0 +1,78 @@
+# Apache License, Version 2.0
+
+# Compare a compositor tree executed on a single thread against the same tree on several threads.
+#
+# ./blender.bin --background -noaudio --factory-startup \
+#     --python tests/python/compositor_scheduler_test.py
+#
+# Chunks are scheduled as soon as the chunks they read are executed, the groups of the tree
+# overlap when there are several threads. Every pixel is still calculated from the same inputs,
+# so the results must be bit-for-bit identical.
+
+import os
+import sys
+import unittest
+
+import bpy
+
+sys.path.append(os.path.dirname(__file__))
+import compositor_test_utils
+
+
+SIZE = 128
+
+
+def setup_tree(scene):
+    # complex nodes read the chunks of the previous group around their own area
+    tree, image_node = compositor_test_utils.new_tree(scene, SIZE)
+
+    blur = tree.nodes.new("CompositorNodeBlur")
+    blur.filter_type = 'GAUSS'
+    blur.size_x = blur.size_y = 6
+    tree.links.new(image_node.outputs["Image"], blur.inputs["Image"])
+
+    bw = tree.nodes.new("CompositorNodeRGBToBW")
+    tree.links.new(blur.outputs["Image"], bw.inputs["Image"])
+
+    dilate = tree.nodes.new("CompositorNodeDilateErode")
+    dilate.mode = 'DISTANCE'
+    dilate.distance = 3
+    tree.links.new(bw.outputs["Val"], dilate.inputs["Mask"])
+
+    blur_mask = tree.nodes.new("CompositorNodeBlur")
+    blur_mask.filter_type = 'GAUSS'
+    blur_mask.size_x = blur_mask.size_y = 4
+    tree.links.new(blur.outputs["Image"], blur_mask.inputs["Image"])
+
+    mix = tree.nodes.new("CompositorNodeMixRGB")
+    tree.links.new(dilate.outputs["Mask"], mix.inputs["Fac"])
+    tree.links.new(image_node.outputs["Image"], mix.inputs[1])
+    tree.links.new(blur_mask.outputs["Image"], mix.inputs[2])
+
+    compositor_test_utils.link_composite(tree, mix.outputs["Image"])
+
+
+class CompositorSchedulerTest(unittest.TestCase):
+    def setUp(self):
+        scene = bpy.context.scene
+        compositor_test_utils.setup_scene(scene, SIZE)
+        setup_tree(scene)
+        self.scene = scene
+
+    def tearDown(self):
+        self.scene.render.threads_mode = 'AUTO'
+
+    def render_threads(self, threads):
+        self.scene.render.threads_mode = 'FIXED'
+        self.scene.render.threads = threads
+        return compositor_test_utils.render_pixels(self.scene)
+
+    def test_threads_match_single_thread(self):
+        single = self.render_threads(1)
+        for threads in (2, 8):
+            compositor_test_utils.assert_pixels_close(self, self.render_threads(threads), single, 0.0)
+
+
+if __name__ == '__main__':
+    sys.argv = [__file__] + (sys.argv[sys.argv.index("--") + 1:] if "--" in sys.argv else [])
+    unittest.main()
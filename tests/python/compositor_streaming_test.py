@@ -0,0 +1,204 @@
+# Apache License, Version 2.0
+
+# Compare a compositor tree with half float buffers against the same tree with full float buffers.
+#
+# ./blender.bin --background -noaudio --factory-startup \
+#     --python tests/python/compositor_streaming_test.py
+#
+# Half float buffers are always kept in tiles (MemoryTileStore) and read by the chunks in bands of
+# rows, like buffers that exceed the compositor memory limit. The results must match within half
+# float precision, and reading the bands must not build the full buffer of a proxy, that is counted
+# in the profile written with --debug-compositor.
+
+import glob
+import os
+import re
+import tempfile
+import unittest
+
+import bpy
+
+
+SIZE = 128
+
+# chunks of 32 rows, so every buffer is read by several chunks
+CHUNK_SIZE = '32'
+
+# half floats have a relative precision of 2^-11, the tree keeps values around 0..1
+TOLERANCE = 4e-3
+
+
+def new_tree(scene):
+    scene.use_nodes = True
+    tree = scene.node_tree
+    tree.nodes.clear()
+    tree.chunk_size = CHUNK_SIZE
+
+    image = bpy.data.images.new("streaming_input", SIZE, SIZE, alpha=True, float_buffer=True)
+    image.generated_type = 'COLOR_GRID'
+    image_node = tree.nodes.new("CompositorNodeImage")
+    image_node.image = image
+    return tree, image_node
+
+
+def link_composite(tree, socket):
+    composite = tree.nodes.new("CompositorNodeComposite")
+    composite.use_alpha = True
+    tree.links.new(socket, composite.inputs["Image"])
+
+
+def tree_pointwise_after_blur(scene):
+    # the blur is complex, so its output is a buffer that the pointwise nodes read in bands
+    tree, image_node = new_tree(scene)
+
+    blur = tree.nodes.new("CompositorNodeBlur")
+    blur.filter_type = 'GAUSS'
+    blur.size_x = blur.size_y = 3
+    tree.links.new(image_node.outputs["Image"], blur.inputs["Image"])
+
+    gamma = tree.nodes.new("CompositorNodeGamma")
+    gamma.inputs["Gamma"].default_value = 1.3
+    tree.links.new(blur.outputs["Image"], gamma.inputs["Image"])
+
+    huesat = tree.nodes.new("CompositorNodeHueSat")
+    tree.links.new(gamma.outputs["Image"], huesat.inputs["Image"])
+
+    mix = tree.nodes.new("CompositorNodeMixRGB")
+    mix.blend_type = 'MULTIPLY'
+    mix.inputs["Fac"].default_value = 0.5
+    tree.links.new(huesat.outputs["Image"], mix.inputs[1])
+    tree.links.new(image_node.outputs["Image"], mix.inputs[2])
+
+    link_composite(tree, mix.outputs["Image"])
+
+
+def tree_fast_gauss(scene):
+    # the fast gaussian blurs a copy of its whole input, copied from the tiles
+    tree, image_node = new_tree(scene)
+
+    blur = tree.nodes.new("CompositorNodeBlur")
+    blur.filter_type = 'FAST_GAUSS'
+    blur.size_x = blur.size_y = 8
+    tree.links.new(image_node.outputs["Image"], blur.inputs["Image"])
+
+    gamma = tree.nodes.new("CompositorNodeGamma")
+    gamma.inputs["Gamma"].default_value = 1.3
+    tree.links.new(blur.outputs["Image"], gamma.inputs["Image"])
+
+    link_composite(tree, gamma.outputs["Image"])
+
+
+def tree_matte(scene):
+    # the dilated matte is a value buffer, stored in half floats as well
+    tree, image_node = new_tree(scene)
+
+    bw = tree.nodes.new("CompositorNodeRGBToBW")
+    tree.links.new(image_node.outputs["Image"], bw.inputs["Image"])
+
+    dilate = tree.nodes.new("CompositorNodeDilateErode")
+    dilate.mode = 'DISTANCE'
+    dilate.distance = 2
+    tree.links.new(bw.outputs["Val"], dilate.inputs["Mask"])
+
+    math = tree.nodes.new("CompositorNodeMath")
+    math.operation = 'MULTIPLY'
+    math.inputs[1].default_value = 0.8
+    tree.links.new(dilate.outputs["Mask"], math.inputs[0])
+
+    set_alpha = tree.nodes.new("CompositorNodeSetAlpha")
+    tree.links.new(image_node.outputs["Image"], set_alpha.inputs["Image"])
+    tree.links.new(math.outputs["Value"], set_alpha.inputs["Alpha"])
+
+    link_composite(tree, set_alpha.outputs["Image"])
+
+
+def profile_reports():
+    # the profiler writes to the temporary directory that contains the session directory
+    directory = os.path.dirname(os.path.normpath(bpy.app.tempdir))
+    return set(glob.glob(os.path.join(directory, "compositor_profile_*.txt")))
+
+
+def full_buffers_built(report):
+    with open(report) as fh:
+        match = re.search(r"^Full buffers built from tiles: (\d+)$", fh.read(), re.MULTILINE)
+    if match is None:
+        raise Exception("no full buffer count in %s" % report)
+    return int(match.group(1))
+
+
+def render_pixels(scene, precision, filepath):
+    scene.node_tree.buffer_precision = precision
+
+    reports = profile_reports()
+    bpy.ops.render.render()
+    new_reports = profile_reports() - reports
+
+    # the render result can't be read directly, go through a lossless float file
+    bpy.data.images["Render Result"].save_render(filepath, scene)
+    image = bpy.data.images.load(filepath)
+    pixels = list(image.pixels)
+    bpy.data.images.remove(image)
+    os.remove(filepath)
+
+    full_buffers = sum(full_buffers_built(report) for report in new_reports)
+    for report in new_reports:
+        os.remove(report)
+        trace = report.replace("compositor_profile_", "compositor_trace_").replace(".txt", ".json")
+        if os.path.exists(trace):
+            os.remove(trace)
+    return pixels, full_buffers
+
+
+class CompositorStreamingTest(unittest.TestCase):
+    def setUp(self):
+        scene = bpy.context.scene
+        scene.render.resolution_x = SIZE
+        scene.render.resolution_y = SIZE
+        scene.render.resolution_percentage = 100
+        scene.render.use_compositing = True
+        scene.render.use_sequencer = False
+        settings = scene.render.image_settings
+        settings.file_format = 'OPEN_EXR'
+        settings.color_depth = '32'
+        settings.exr_codec = 'ZIP'
+        settings.color_mode = 'RGBA'
+        self.scene = scene
+        bpy.app.debug_compositor = True
+
+    def tearDown(self):
+        bpy.app.debug_compositor = False
+
+    def compare(self, build, max_full_buffers):
+        build(self.scene)
+        directory = tempfile.mkdtemp()
+        # half first, so its groups aren't restored from the compositor cache
+        half, full_buffers = render_pixels(self.scene, 'HALF', os.path.join(directory, "half.exr"))
+        full, _ = render_pixels(self.scene, 'FULL', os.path.join(directory, "full.exr"))
+        os.rmdir(directory)
+
+        self.assertEqual(len(half), SIZE * SIZE * 4)
+        # guard against comparing two empty results
+        self.assertGreater(len(set(full)), 16)
+
+        errors = [abs(half[index] - full[index]) for index in range(len(full))]
+        worst = max(range(len(errors)), key=errors.__getitem__)
+        if errors[worst] > TOLERANCE:
+            self.fail("pixel %d channel %d differs by %f: %r != %r" %
+                      (worst // 4, worst % 4, errors[worst], half[worst], full[worst]))
+
+        self.assertLessEqual(full_buffers, max_full_buffers)
+
+    def test_pointwise_after_blur(self):
+        self.compare(tree_pointwise_after_blur, 0)
+
+    def test_fast_gauss(self):
+        self.compare(tree_fast_gauss, 0)
+
+    def test_matte(self):
+        self.compare(tree_matte, 0)
+
+
+if __name__ == '__main__':
+    import sys
+    sys.argv = [__file__] + (sys.argv[sys.argv.index("--") + 1:] if "--" in sys.argv else [])
+    unittest.main()
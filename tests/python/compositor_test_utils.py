@@ -0,0 +1,70 @@
+# Apache License, Version 2.0
+
+# Shared by the compositor_*_test.py scripts: a scene that only runs the compositor,
+# trees that start from a generated image and the pixels of the rendered result.
+
+import os
+import tempfile
+
+import bpy
+
+
+def setup_scene(scene, size):
+    scene.render.resolution_x = size
+    scene.render.resolution_y = size
+    scene.render.resolution_percentage = 100
+    scene.render.use_compositing = True
+    scene.render.use_sequencer = False
+    settings = scene.render.image_settings
+    settings.file_format = 'OPEN_EXR'
+    settings.color_depth = '32'
+    settings.exr_codec = 'ZIP'
+    settings.color_mode = 'RGBA'
+
+
+def new_tree(scene, size, chunk_size='32'):
+    # small chunks, so every buffer is calculated by several chunks
+    scene.use_nodes = True
+    tree = scene.node_tree
+    tree.nodes.clear()
+    tree.chunk_size = chunk_size
+
+    image = bpy.data.images.new("test_input", size, size, alpha=True, float_buffer=True)
+    image.generated_type = 'COLOR_GRID'
+    image_node = tree.nodes.new("CompositorNodeImage")
+    image_node.image = image
+    return tree, image_node
+
+
+def link_composite(tree, socket):
+    composite = tree.nodes.new("CompositorNodeComposite")
+    composite.use_alpha = True
+    tree.links.new(socket, composite.inputs["Image"])
+
+
+def render_pixels(scene):
+    bpy.ops.render.render()
+
+    # the render result can't be read directly, go through a lossless float file
+    directory = tempfile.mkdtemp()
+    filepath = os.path.join(directory, "render.exr")
+    bpy.data.images["Render Result"].save_render(filepath, scene)
+    image = bpy.data.images.load(filepath)
+    pixels = list(image.pixels)
+    bpy.data.images.remove(image)
+    os.remove(filepath)
+    os.rmdir(directory)
+    return pixels
+
+
+def assert_pixels_close(test, result, expected, tolerance):
+    """Fail the test case at the first value that differs by more than the tolerance."""
+    test.assertEqual(len(result), len(expected))
+    # guard against comparing two empty results
+    test.assertGreater(len(set(expected)), 16)
+
+    errors = [abs(result[index] - expected[index]) for index in range(len(expected))]
+    worst = max(range(len(errors)), key=errors.__getitem__)
+    if errors[worst] > tolerance:
+        test.fail("pixel %d channel %d differs by %g: %r != %r" %
+                  (worst // 4, worst % 4, errors[worst], result[worst], expected[worst]))
@@ -0,0 +1,65 @@
+# Apache License, Version 2.0
+
+# Check that the viewer region option of the compositor leaves renders unchanged.
+#
+# ./blender.bin --background -noaudio --factory-startup \
+#     --python tests/python/compositor_viewer_region_test.py
+#
+# With use_viewer_region, the viewer nodes only calculate the part of the viewer image that is
+# visible in the editors, while editing. A render must still calculate the whole viewer image
+# and the whole composite result.
+
+import os
+import sys
+import unittest
+
+import bpy
+
+sys.path.append(os.path.dirname(__file__))
+import compositor_test_utils
+
+
+SIZE = 128
+
+
+def setup_tree(scene):
+    # the blur reads around the area of its chunks, so its input must be complete as well
+    tree, image_node = compositor_test_utils.new_tree(scene, SIZE)
+
+    blur = tree.nodes.new("CompositorNodeBlur")
+    blur.filter_type = 'GAUSS'
+    blur.size_x = blur.size_y = 5
+    tree.links.new(image_node.outputs["Image"], blur.inputs["Image"])
+
+    viewer = tree.nodes.new("CompositorNodeViewer")
+    viewer.use_alpha = True
+    tree.links.new(blur.outputs["Image"], viewer.inputs["Image"])
+    tree.nodes.active = viewer
+
+    compositor_test_utils.link_composite(tree, blur.outputs["Image"])
+    return tree
+
+
+class CompositorViewerRegionTest(unittest.TestCase):
+    def setUp(self):
+        self.scene = bpy.context.scene
+        compositor_test_utils.setup_scene(self.scene, SIZE)
+        self.tree = setup_tree(self.scene)
+
+    def render(self, use_viewer_region):
+        self.tree.use_viewer_region = use_viewer_region
+        composite = compositor_test_utils.render_pixels(self.scene)
+        viewer = list(bpy.data.images["Viewer Node"].pixels)
+        return composite, viewer
+
+    def test_render_ignores_viewer_region(self):
+        composite, viewer = self.render(False)
+        region_composite, region_viewer = self.render(True)
+
+        compositor_test_utils.assert_pixels_close(self, region_composite, composite, 0.0)
+        compositor_test_utils.assert_pixels_close(self, region_viewer, viewer, 0.0)
+
+
+if __name__ == '__main__':
+    sys.argv = [__file__] + (sys.argv[sys.argv.index("--") + 1:] if "--" in sys.argv else [])
+    unittest.main()
@@ -0,0 +1,102 @@
+# Apache License, Version 2.0
+
+# Time scaling image buffers (IMB_scaleImBuf) up and down, in megapixels per second.
+#
+# ./blender.bin --background -noaudio --factory-startup \
+#     --python tests/python/imbuf_scale_benchmark.py -- --output-dir=/tmp/imbuf_scale_benchmark
+#
+# Byte and float buffers of several sizes are scaled to half and to double their size,
+# through Image.scale(). Every case runs in a new Blender process, once on a single
+# thread and once on all threads, so the speedup of the threaded scaling is reported too.
+# The throughput is of the larger of the source and the result.
+
+import os
+import sys
+import time
+
+import bpy
+
+sys.path.append(os.path.dirname(__file__))
+import benchmark_utils
+
+
+SIZES = (256, 1024, 4096)
+
+# (name, factor)
+SCALES = (
+    ("down", 0.5),
+    ("up", 2.0),
+)
+
+# (name, command line threads, 0 is all)
+THREADS = (
+    ("1 thread", 1),
+    ("all threads", 0),
+)
+
+
+def time_scale(size, factor, use_float, repeat):
+    target = max(int(size * factor), 1)
+    best = float("inf")
+    for index in range(repeat):
+        # a new image for every run, scaling changes the image
+        image = bpy.data.images.new("scale_%d" % index, size, size, alpha=True, float_buffer=use_float)
+        image.generated_type = 'COLOR_GRID'
+        # ensure the buffer exists before timing
+        image.pixels[0]
+
+        start = time.time()
+        image.scale(target, target)
+        best = min(best, time.time() - start)
+
+        bpy.data.images.remove(image)
+
+    megapixels = max(size, target) ** 2 / 1e6
+    return megapixels / best if best > 0.0 else float("inf")
+
+
+def run_child(args):
+    for size in SIZES:
+        for scale_name, factor in SCALES:
+            for use_float in (False, True):
+                throughput = time_scale(size, factor, use_float, args.repeat)
+                benchmark_utils.report(size, scale_name, "float" if use_float else "byte", throughput)
+
+
+def run_case(args, threads):
+    blender_arguments = ["--threads", str(threads)] if threads else []
+    results = {}
+    for size, scale_name, buffer_type, throughput in benchmark_utils.run_child(
+            __file__, ["--repeat=%d" % args.repeat], blender_arguments):
+        results[int(size), scale_name, buffer_type] = float(throughput)
+    return results
+
+
+def main():
+    args = benchmark_utils.parse_args("imbuf_scale_benchmark", "Time scaling image buffers", repeat=5)
+
+    if args.child:
+        run_child(args)
+        return
+
+    results = [(thread_name, run_case(args, threads)) for thread_name, threads in THREADS]
+
+    lines = []
+    header = "%-6s %-5s %-6s" % ("size", "scale", "type")
+    header += "".join(" %14s" % thread_name for thread_name, _ in results) + " %8s" % "speedup"
+    lines.append(header)
+    for key in sorted(results[0][1]):
+        throughputs = [thread_results[key] for _, thread_results in results]
+        line = "%-6d %-5s %-6s" % key
+        line += "".join(" %9.1f MP/s" % throughput for throughput in throughputs)
+        line += " %7.2fx" % (throughputs[-1] / throughputs[0])
+        lines.append(line)
+
+    for line in lines:
+        print(line)
+
+    benchmark_utils.write_summary(args, "Image scaling benchmark", "fastest of %d runs" % args.repeat, lines)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,110 @@
+# Apache License, Version 2.0
+
+# Measure the memory of a smoke density grid rendered through the voxel data texture:
+# converted to a dense data set (the 'SMOKE' source) and sampled from the sparse grid of
+# the OpenVDB cache file (the 'OPENVDB' source).
+#
+# ./blender.bin --background -noaudio --factory-startup \
+#     --python tests/python/openvdb_voxeldata_benchmark.py -- --output-dir=/tmp/openvdb_voxeldata_benchmark
+#
+# A smoke simulation is cached as OpenVDB files, the last frame is rendered with both
+# textures and the memory they report (VoxelData.memory) is written to the summary.
+
+import glob
+import os
+import re
+import sys
+
+import bpy
+
+sys.path.append(os.path.dirname(__file__))
+import benchmark_utils
+
+
+def setup_simulation(args):
+    scene = bpy.context.scene
+    scene.frame_start = 1
+    scene.frame_end = args.frames
+    scene.render.resolution_x = scene.render.resolution_y = 64
+    scene.render.resolution_percentage = 100
+
+    # the smoke stays in a corner of the domain, most of the domain is empty
+    domain = bpy.data.objects["Cube"]
+    domain.scale = (4.0, 4.0, 4.0)
+    modifier = domain.modifiers.new("Smoke", 'SMOKE')
+    modifier.smoke_type = 'DOMAIN'
+    settings = modifier.domain_settings
+    settings.resolution_max = args.resolution
+    settings.cache_file_format = 'OPENVDB'
+    settings.point_cache.name = "smoke"
+    settings.point_cache.use_disk_cache = True
+    settings.point_cache.frame_end = args.frames
+
+    bpy.ops.mesh.primitive_uv_sphere_add(size=0.5, location=(-3.0, -3.0, -3.0))
+    flow = bpy.context.active_object
+    modifier = flow.modifiers.new("Smoke", 'SMOKE')
+    modifier.smoke_type = 'FLOW'
+    modifier.flow_settings.smoke_flow_type = 'SMOKE'
+
+    # disk caches are written next to the saved file
+    bpy.ops.wm.save_as_mainfile(filepath=os.path.join(args.output_dir, "smoke.blend"))
+    for frame in range(1, args.frames + 1):
+        scene.frame_set(frame)
+    return scene, domain
+
+
+def cache_sequence(args):
+    # the frame number in the file names is replaced by '#', like image sequences
+    files = sorted(glob.glob(os.path.join(args.output_dir, "blendcache_smoke", "smoke_*.vdb")))
+    if not files:
+        raise Exception("no OpenVDB cache written, is Blender built with OpenVDB?")
+    return re.sub(r"_(\d{6})_", "_######_", files[-1])
+
+
+def new_texture(name, file_format):
+    texture = bpy.data.textures.new(name, 'VOXEL_DATA')
+    # only textures with users are loaded by the render
+    texture.use_fake_user = True
+    texture.voxel_data.file_format = file_format
+    return texture
+
+
+def add_arguments(parser):
+    parser.add_argument("--resolution", type=int, default=128, help="resolution of the smoke domain")
+    parser.add_argument("--frames", type=int, default=30, help="frames simulated before measuring")
+
+
+def main():
+    args = benchmark_utils.parse_args("openvdb_voxeldata_benchmark", "Measure sparse and dense voxel data memory",
+                                      repeat=1, add_arguments=add_arguments)
+
+    scene, domain = setup_simulation(args)
+
+    dense = new_texture("dense", 'SMOKE')
+    dense.voxel_data.domain_object = domain
+    dense.voxel_data.smoke_data_type = 'SMOKEDENSITY'
+
+    resolution = tuple(domain.modifiers["Smoke"].domain_settings.domain_resolution)
+    sparse = new_texture("sparse", 'OPENVDB')
+    sparse.voxel_data.filepath = cache_sequence(args)
+    sparse.voxel_data.grid_name = "density"
+    sparse.voxel_data.resolution = resolution
+
+    bpy.ops.render.render()
+
+    voxels = resolution[0] * resolution[1] * resolution[2]
+    lines = [
+        "%-28s %10d KB" % ("smoke texture (dense RGBA)", dense.voxel_data.memory),
+        "%-28s %10d KB" % ("dense density grid", voxels * 4 // 1024),
+        "%-28s %10d KB" % ("openvdb texture (sparse)", sparse.voxel_data.memory),
+    ]
+    for line in lines:
+        print(line)
+
+    benchmark_utils.write_summary(
+        args, "OpenVDB voxel data benchmark",
+        "%dx%dx%d domain, frame %d" % (resolution + (args.frames,)), lines)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,139 @@
+# Apache License, Version 2.0
+
+# Time sequencer blend effects and strip modifiers, in megapixels per second.
+#
+# ./blender.bin --background -noaudio --factory-startup \
+#     --python tests/python/sequencer_effect_benchmark.py -- --output-dir=/tmp/sequencer_effect_benchmark
+#
+# Two generated images are combined by every effect, on byte and on float buffers
+# (the strips' "Convert Float" option). Every frame is rendered once, so the sequencer
+# cache is never hit. The time of rendering the input strips without an effect is
+# subtracted, the reported throughput is of the effect or modifier alone.
+
+import os
+import sys
+import time
+
+import bpy
+
+sys.path.append(os.path.dirname(__file__))
+import benchmark_utils
+
+
+EFFECTS = (
+    "ALPHA_OVER",
+    "ALPHA_UNDER",
+    "CROSS",
+    "GAMMA_CROSS",
+    "ADD",
+    "SUBTRACT",
+    "MULTIPLY",
+    "OVER_DROP",
+    "WIPE",
+    "GLOW",
+)
+
+MODIFIERS = (
+    "COLOR_BALANCE",
+    "CURVES",
+    "TONEMAP",
+)
+
+
+def generate_image(filepath, name, size, seed):
+    image = bpy.data.images.new(name, size, size, alpha=True)
+    pixels = [0.0] * (size * size * 4)
+    for index in range(size * size):
+        x = index % size
+        y = index // size
+        pixels[index * 4 + 0] = ((x * seed) % size) / size
+        pixels[index * 4 + 1] = ((y * seed) % size) / size
+        pixels[index * 4 + 2] = ((x + y) % size) / size
+        # partly transparent, so alpha blending doesn't take the opaque shortcuts only
+        pixels[index * 4 + 3] = 0.5 + 0.5 * ((x ^ y) & 1)
+    image.pixels[:] = pixels
+    image.filepath_raw = filepath
+    image.file_format = 'PNG'
+    image.save()
+    bpy.data.images.remove(image)
+
+
+def setup_scene(args, images, use_float):
+    scene = bpy.context.scene
+    scene.render.resolution_x = args.size
+    scene.render.resolution_y = args.size
+    scene.render.resolution_percentage = 100
+    scene.render.use_sequencer = True
+    scene.render.use_compositing = False
+    scene.frame_start = 1
+    scene.frame_end = args.frames
+
+    if scene.sequence_editor:
+        scene.sequence_editor_clear()
+    sequences = scene.sequence_editor_create().sequences
+
+    strips = []
+    for channel, filepath in enumerate(images, 1):
+        strip = sequences.new_image(os.path.basename(filepath), filepath, channel, 1)
+        strip.frame_final_duration = args.frames
+        strip.use_float = use_float
+        strips.append(strip)
+    return scene, sequences, strips
+
+
+def render_frames(scene):
+    start = time.time()
+    for frame in range(scene.frame_start, scene.frame_end + 1):
+        scene.frame_set(frame)
+        bpy.ops.render.render()
+    return time.time() - start
+
+
+def time_case(args, images, use_float, effect=None, modifier=None):
+    scene, sequences, strips = setup_scene(args, images, use_float)
+
+    if effect:
+        # the fader changes every frame, so no frame is looked up in the cache
+        sequences.new_effect(effect.lower(), effect, 3, 1,
+                             frame_end=args.frames + 1, seq1=strips[0], seq2=strips[1])
+    if modifier:
+        strips[-1].modifiers.new(modifier.lower(), modifier)
+
+    return min(render_frames(scene) for repeat in range(args.repeat))
+
+
+def add_arguments(parser):
+    parser.add_argument("--size", type=int, default=1024, help="width and height of the rendered frames")
+    parser.add_argument("--frames", type=int, default=20, help="frames rendered per case")
+
+
+def main():
+    args = benchmark_utils.parse_args("sequencer_effect_benchmark", "Time sequencer effects and strip modifiers",
+                                      add_arguments=add_arguments)
+
+    images = []
+    for index in range(2):
+        filepath = os.path.join(args.output_dir, "input_%d.png" % index)
+        generate_image(filepath, "input_%d" % index, args.size, index + 3)
+        images.append(filepath)
+
+    megapixels = args.size * args.size * args.frames / 1e6
+    lines = []
+    for use_float in (False, True):
+        buffer_type = "float" if use_float else "byte"
+        base = time_case(args, images, use_float)
+        cases = [(effect, effect, None) for effect in EFFECTS]
+        cases += [(modifier, None, modifier) for modifier in MODIFIERS]
+        for name, effect, modifier in cases:
+            elapsed = time_case(args, images, use_float, effect, modifier) - base
+            throughput = megapixels / elapsed if elapsed > 0.0 else float("inf")
+            lines.append("%-16s %-6s %10.1f MP/s" % (name, buffer_type, throughput))
+            print(lines[-1])
+
+    benchmark_utils.write_summary(
+        args, "Sequencer effect benchmark",
+        "%dx%d, %d frames, fastest of %d runs" % (args.size, args.size, args.frames, args.repeat), lines)
+
+
+if __name__ == "__main__":
+    main()